@@ -0,0 +1,343 @@
+﻿#include "stdafx.h"
+#include "AssetBuildCache.h"
+#include "BinaryBlob.h"
+#include "DXTestException.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "PackFile.h"
+#include "Stopwatch.h"
+#include "TextModelFile.h"
+#include "Utils.h"
+
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Bump when the .mesh files the build writes change, every model is reconverted on the next build.
+    const unsigned int MeshToolVersion = 1;
+
+    void PrintUsage()
+    {
+        std::printf(
+            "Usage:\n"
+            "  AssetBuilder pack <output.pack> <source directory> [--align bytes] [--compress]\n"
+            "      Pack every file under the source directory. Paths are stored relative to it, so packing the\n"
+            "      game's working directory lets .\\Models\\cube.model load from the pack unchanged.\n"
+            "      --compress stores files that compress well LZ compressed, they are decompressed on load.\n"
+            "  AssetBuilder list <input.pack>\n"
+            "      Print the contents of a pack.\n"
+            "  AssetBuilder build <output directory> <source directory> [--cache directory] [--threads count]\n"
+            "                     [--lods count]\n"
+            "      Convert text models (.model, Models\\*.txt) to .mesh files and copy everything else. Only outputs\n"
+            "      whose inputs, converter or options changed are rebuilt, the rest come from the cache directory\n"
+            "      (default <output directory>.cache). --lods adds that many simplified levels of detail.\n");
+    }
+
+    // Recursively find every file under directory, as paths relative to the root.
+    void FindFiles(
+        const std::wstring& root,
+        const std::wstring& relativeDirectory,
+        std::vector<std::wstring> *pFilesOut)
+    {
+        WIN32_FIND_DATAW findData;
+        std::wstring searchPath = root + L"\\" + relativeDirectory + L"*";
+        HANDLE find = FindFirstFileW(searchPath.c_str(), &findData);
+
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            throw WindowsApiException(GetLastError(), L"Failed to list " + root + L"\\" + relativeDirectory);
+        }
+
+        do
+        {
+            std::wstring name = findData.cFileName;
+
+            if (name == L"." || name == L"..")
+            {
+                continue;
+            }
+            else if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            {
+                FindFiles(root, relativeDirectory + name + L"\\", pFilesOut);
+            }
+            else
+            {
+                pFilesOut->push_back(relativeDirectory + name);
+            }
+        } while (FindNextFileW(find, &findData));
+
+        FindClose(find);
+    }
+
+    int Pack(
+        const std::wstring& outputFile,
+        const std::wstring& sourceDirectory,
+        unsigned int alignment,
+        bool compress)
+    {
+        Stopwatch stopwatch;
+        std::vector<std::wstring> files;
+
+        FindFiles(sourceDirectory, L"", &files);
+
+        PackWriter writer(alignment);
+
+        for (const std::wstring& file : files)
+        {
+            // Don't pack a previous build of the output into itself.
+            if (PackFile::NormalizePath(sourceDirectory + L"\\" + file) == PackFile::NormalizePath(outputFile))
+            {
+                continue;
+            }
+
+            writer.AddFile(file, sourceDirectory + L"\\" + file, compress);
+        }
+
+        writer.Save(outputFile);
+
+        PackFile pack(outputFile);
+        const double dataMegabytes = static_cast<double>(writer.DataSize()) / (1024.0 * 1024.0);
+        const double storedMegabytes = static_cast<double>(writer.StoredSize()) / (1024.0 * 1024.0);
+        const double packMegabytes = static_cast<double>(pack.FileSize()) / (1024.0 * 1024.0);
+
+        std::printf(
+            "Packed %u files, %.2f MB of data into %.2f MB (%.1f%% overhead) in %.2f s\n",
+            pack.EntryCount(),
+            dataMegabytes,
+            packMegabytes,
+            storedMegabytes > 0.0 ? (packMegabytes / storedMegabytes - 1.0) * 100.0 : 0.0,
+            stopwatch.ElapsedSeconds());
+
+        if (compress)
+        {
+            std::printf(
+                "Compressed %.2f MB to %.2f MB, ratio %.2f\n",
+                dataMegabytes,
+                storedMegabytes,
+                storedMegabytes > 0.0 ? dataMegabytes / storedMegabytes : 1.0);
+        }
+
+        return 0;
+    }
+
+    // Text models convert to .mesh, see TextModelFile.h.
+    bool IsTextModel(const std::wstring& file)
+    {
+        return Utils::EndsWith(file, L".model") ||
+               (Utils::EndsWith(file, L".txt") && PackFile::NormalizePath(file).compare(0, 7, "models/") == 0);
+    }
+
+    asset_build_step_t MeshStep(
+        const std::wstring& outputDirectory,
+        const std::wstring& sourceDirectory,
+        const std::wstring& file,
+        unsigned int lodCount)
+    {
+        asset_build_step_t step;
+        step.output = outputDirectory + L"\\" + file.substr(0, file.find_last_of(L'.')) + L".mesh";
+        step.inputs.push_back(sourceDirectory + L"\\" + file);
+        step.tool = "mesh";
+        step.toolVersion = MeshToolVersion;
+        step.options = "lods=" + std::to_string(lodCount);
+
+        const std::wstring sourceName = step.inputs[0];
+
+        step.convert = [sourceName, lodCount](const std::vector<BinaryBlob>& inputs, std::vector<char> *pOutput) {
+            s_mesh_data_t mesh;
+            TextModelFile::Read(
+                inputs[0].BufferPointer(),
+                static_cast<size_t>(inputs[0].BufferSize()),
+                sourceName,
+                &mesh);
+
+            // Each level has half the triangles of the one before.
+            std::vector<float> ratios;
+
+            for (unsigned int i = 1; i <= lodCount; ++i)
+            {
+                ratios.push_back(1.0f / static_cast<float>(1u << i));
+            }
+
+            if (!ratios.empty())
+            {
+                MeshSimplifier::GenerateLods(&mesh, ratios);
+            }
+
+            MeshletBuilder::Build(mesh, &mesh.meshlets);
+            MeshFile::Write(mesh, pOutput);
+        };
+
+        return step;
+    }
+
+    asset_build_step_t CopyStep(
+        const std::wstring& outputDirectory,
+        const std::wstring& sourceDirectory,
+        const std::wstring& file)
+    {
+        asset_build_step_t step;
+        step.output = outputDirectory + L"\\" + file;
+        step.inputs.push_back(sourceDirectory + L"\\" + file);
+        step.tool = "copy";
+        step.toolVersion = 1;
+
+        step.convert = [](const std::vector<BinaryBlob>& inputs, std::vector<char> *pOutput) {
+            pOutput->assign(inputs[0].BufferPointer(), inputs[0].BufferPointer() + inputs[0].BufferSize());
+        };
+
+        return step;
+    }
+
+    int Build(
+        const std::wstring& outputDirectory,
+        const std::wstring& sourceDirectory,
+        const std::wstring& cacheDirectory,
+        unsigned int threadCount,
+        unsigned int lodCount)
+    {
+        std::vector<std::wstring> files;
+        FindFiles(sourceDirectory, L"", &files);
+
+        // Don't build earlier outputs or the cache into themselves when they live under the source directory.
+        const std::string outputPrefix = PackFile::NormalizePath(outputDirectory) + "/";
+        const std::string cachePrefix = PackFile::NormalizePath(cacheDirectory) + "/";
+
+        std::vector<asset_build_step_t> steps;
+
+        for (const std::wstring& file : files)
+        {
+            const std::string source = PackFile::NormalizePath(sourceDirectory + L"\\" + file);
+
+            if (source.compare(0, outputPrefix.size(), outputPrefix) == 0 ||
+                source.compare(0, cachePrefix.size(), cachePrefix) == 0)
+            {
+                continue;
+            }
+            else if (IsTextModel(file))
+            {
+                steps.push_back(MeshStep(outputDirectory, sourceDirectory, file, lodCount));
+            }
+            else
+            {
+                steps.push_back(CopyStep(outputDirectory, sourceDirectory, file));
+            }
+        }
+
+        AssetBuildCache::CreateDirectories(outputDirectory);
+
+        AssetBuildCache cache(cacheDirectory);
+        asset_build_stats_t stats = cache.Build(steps, threadCount);
+
+        std::printf(
+            "Built %u assets: %u up to date, %u from cache, %u converted. Hit rate %.1f%% in %.2f s\n",
+            static_cast<unsigned int>(stats.stepCount),
+            static_cast<unsigned int>(stats.upToDateCount),
+            static_cast<unsigned int>(stats.cacheHitCount),
+            static_cast<unsigned int>(stats.builtCount),
+            stats.HitRate() * 100.0,
+            stats.seconds);
+
+        return 0;
+    }
+
+    int List(const std::wstring& inputFile)
+    {
+        PackFile pack(inputFile);
+
+        for (unsigned int i = 0; i < pack.EntryCount(); ++i)
+        {
+            pack_entry_t entry = pack.Entry(i);
+
+            std::printf(
+                "%12llu %12llu %s  %s\n",
+                static_cast<unsigned long long>(entry.uncompressedSize),
+                static_cast<unsigned long long>(entry.size),
+                (entry.flags & PackFile::FlagCompressed) != 0 ? "lz" : "  ",
+                pack.EntryName(i).c_str());
+        }
+
+        std::printf("%u files, %llu bytes\n", pack.EntryCount(), static_cast<unsigned long long>(pack.FileSize()));
+        return 0;
+    }
+}
+
+// Usage: see PrintUsage().
+//  Offline asset processing tool. Build it together with the game and run it from the game's working directory.
+int wmain(int argc, wchar_t ** argv)
+{
+    std::vector<std::wstring> args(argv + 1, argv + argc);
+
+    try
+    {
+        if (args.size() >= 3 && args[0] == L"pack")
+        {
+            unsigned int alignment = PackFile::DefaultAlignment;
+            bool compress = false;
+
+            for (size_t i = 3; i < args.size(); ++i)
+            {
+                if (args[i] == L"--align" && i + 1 < args.size())
+                {
+                    alignment = static_cast<unsigned int>(std::wcstoul(args[++i].c_str(), nullptr, 10));
+                }
+                else if (args[i] == L"--compress")
+                {
+                    compress = true;
+                }
+                else
+                {
+                    PrintUsage();
+                    return 1;
+                }
+            }
+
+            return Pack(args[1], args[2], alignment, compress);
+        }
+        else if (args.size() == 2 && args[0] == L"list")
+        {
+            return List(args[1]);
+        }
+        else if (args.size() >= 3 && args[0] == L"build")
+        {
+            std::wstring cacheDirectory = args[1] + L".cache";
+            unsigned int threadCount = 0;
+            unsigned int lodCount = 0;
+
+            for (size_t i = 3; i < args.size(); ++i)
+            {
+                if (args[i] == L"--cache" && i + 1 < args.size())
+                {
+                    cacheDirectory = args[++i];
+                }
+                else if (args[i] == L"--threads" && i + 1 < args.size())
+                {
+                    threadCount = static_cast<unsigned int>(std::wcstoul(args[++i].c_str(), nullptr, 10));
+                }
+                else if (args[i] == L"--lods" && i + 1 < args.size())
+                {
+                    lodCount = static_cast<unsigned int>(std::wcstoul(args[++i].c_str(), nullptr, 10));
+                }
+                else
+                {
+                    PrintUsage();
+                    return 1;
+                }
+            }
+
+            return Build(args[1], args[2], cacheDirectory, threadCount, lodCount);
+        }
+    }
+    catch (const SandboxException& e)
+    {
+        std::printf("AssetBuilder failed: %s\n", Utils::ConvertUtf16ToUtf8(e.Message()).c_str());
+        return 2;
+    }
+
+    PrintUsage();
+    return 1;
+}
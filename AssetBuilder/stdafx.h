@@ -0,0 +1,16 @@
+// stdafx.h : include file for standard system include files,
+// or project specific include files that are used frequently, but
+// are changed infrequently
+//
+
+#pragma once
+
+#include "targetver.h"
+
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+#define NOMINMAX                        // std::min, std::max and numeric_limits<T>::max() instead of macros
+
+#include <Windows.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
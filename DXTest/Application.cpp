@@ -3,10 +3,38 @@
 #include "Graphics.h"
 #include "DXSandbox.h"
 #include "DXTestException.h"
+#include "PackFile.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "FrameReplay.h"
+#include "RenderStats.h"
 #include "size.h"
 
 #include <cstdlib>      //  srand
 #include <ctime>        // time
+#include <fstream>
+#include <memory>
+
+// Optional asset pack built by AssetBuilder. When present, assets are loaded from it instead of the loose files.
+static const wchar_t AssetPackFilePath[] = L".\\Assets.pack";
+
+// Allocation snapshot written at exit, see MemoryTracker.
+static const wchar_t MemorySnapshotFilePath[] = L".\\MemorySnapshot.json";
+
+// Profiler capture of the last few thousand frames, written at exit. Open it in chrome://tracing or Perfetto.
+static const wchar_t ProfileTraceFilePath[] = L".\\ProfileTrace.json";
+
+// Renderer counters over the last few seconds, written at exit.
+static const wchar_t RenderStatsFilePath[] = L".\\RenderStats.txt";
+
+// Timings and counters of a headless run, see Application::RunHeadless().
+static const wchar_t HeadlessReportFilePath[] = L".\\HeadlessReplay.txt";
+
+// Heap budgets per subsystem. Going over one is reported to the debugger output.
+static const unsigned long long MeshMemoryBudget = 64ull * 1024 * 1024;
+static const unsigned long long TextureMemoryBudget = 128ull * 1024 * 1024;
+static const unsigned long long TextMemoryBudget = 4ull * 1024 * 1024;
+static const unsigned long long UiMemoryBudget = 4ull * 1024 * 1024;
 
 Application::Application()
 : mApplicationName(nullptr),
@@ -33,6 +61,21 @@ void Application::Initialize()
 	GApplication = this; // I hate tutorial code.
     srand((unsigned int) time(NULL));
 
+    // Cheap enough to leave on in every build, see MemoryTrackerOverhead in SandboxBench.
+    MemoryTracker::SetBudget(MemoryTag::Meshes, MeshMemoryBudget);
+    MemoryTracker::SetBudget(MemoryTag::Textures, TextureMemoryBudget);
+    MemoryTracker::SetBudget(MemoryTag::Text, TextMemoryBudget);
+    MemoryTracker::SetBudget(MemoryTag::UI, UiMemoryBudget);
+    MemoryTracker::SetEnabled(true);
+
+    Profiler::SetThreadName("Main");
+    Profiler::SetEnabled(true);
+
+    if (GetFileAttributesW(AssetPackFilePath) != INVALID_FILE_ATTRIBUTES)
+    {
+        PackFile::Mount(std::make_shared<PackFile>(AssetPackFilePath));
+    }
+
 	// Initialize app with windows.
     Size screenSize = InitializeWindows();
 	
@@ -71,12 +114,17 @@ void Application::Run()
 		else
 		{
 			Frame();
+
+            Profiler::EndFrame();
+            MemoryTracker::EndFrame();
 		}
 	}
 }
 
 void Application::Frame()
 {
+    PROFILE_SCOPE("Application::Frame");
+
     // Input processing.
     mpInput->Frame();
 
@@ -93,14 +141,49 @@ void Application::Frame()
 
 void Application::Shutdown()
 {
+    // Saved before anything is released, so it shows what each subsystem held while running.
+    if (mInitialized)
+    {
+        std::ofstream snapshot(MemorySnapshotFilePath);
+        snapshot << MemoryTracker::ToJson(MemoryTracker::Snapshot());
+
+        Profiler::SetEnabled(false);
+        std::ofstream trace(ProfileTraceFilePath);
+        trace << Profiler::ToChromeTrace();
+
+        std::ofstream renderStats(RenderStatsFilePath);
+        renderStats << mpGraphics->GetRenderStats().Dump();
+    }
+
 	SafeDelete(mpGraphics);
 	SafeDelete(mpInput);
 
+    PackFile::UnmountAll();
 	ShutdownWindows();
 
 	mInitialized = false;
 }
 
+void Application::RunHeadless(const frame_replay_settings_t& settings)
+{
+    FrameReplay replay(settings);
+    const std::string report = replay.Report(replay.Run());
+
+    std::ofstream file(HeadlessReportFilePath);
+    file << report;
+
+    // A WinMain program has no console of its own, so print to the debugger and to the console it was started from.
+    OutputDebugStringA(report.c_str());
+
+    if (AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        DWORD written = 0;
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        WriteConsoleA(console, report.c_str(), static_cast<DWORD>(report.size()), &written, NULL);
+        FreeConsole();
+    }
+}
+
 LRESULT CALLBACK Application::MessageHandler(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 {
 	return DefWindowProc(hwnd, msg, wparam, lparam);
@@ -5,6 +5,8 @@
 #include "Graphics.h"
 #include "Size.h"
 
+struct frame_replay_settings_t;
+
 class Application
 {
 public:
@@ -15,6 +17,9 @@ public:
 	void Run();
 	void Shutdown();
 
+    // Replay the scripted FrameReplay scene with no window, input or device, and print the frame timings.
+    void RunHeadless(const frame_replay_settings_t& settings);
+
 	LRESULT CALLBACK MessageHandler(HWND, UINT, WPARAM, LPARAM);
 
 private:
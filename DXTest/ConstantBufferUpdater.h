@@ -1,6 +1,7 @@
 #pragma once
 #include "typedefs.h"
 #include "DXSandbox.h"
+#include "RenderStats.h"
 
 #include <dxgi.h>
 #include <d3dcommon.h>
@@ -9,13 +10,18 @@
 /**
  * \brief Assists in mapping, unmapping and updating a DirectX constant buffer.
  *
+ * When given a RenderStats the map, the bytes written and the buffer bind are counted against it.
+ *
  * TODO: Specialize the class to remove unneeded switch statement.
  */
 template<typename T, ShaderType shaderType, int slotIndex>
 class ConstantBufferUpdater
 {
 public:
-    ConstantBufferUpdater(ID3D11DeviceContext * pDeviceContext, ID3D11Buffer *pBufferToUpdate);
+    ConstantBufferUpdater(
+        ID3D11DeviceContext * pDeviceContext,
+        ID3D11Buffer *pBufferToUpdate,
+        RenderStats * pStats = nullptr);
     ConstantBufferUpdater(const ConstantBufferUpdater&) = delete;
     ~ConstantBufferUpdater();
 
@@ -27,6 +33,7 @@ public:
 private:
     ID3D11DeviceContext * mpDeviceContext;
     ID3D11Buffer * mpBufferToUpdate;
+    RenderStats * mpStats;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -36,9 +43,10 @@ template<typename T, ShaderType shaderType, int slotIndex>
 HRESULT UpdateConstantsBuffer(
     ID3D11DeviceContext * pDeviceContext,
     ID3D11Buffer * pBufferToUpdate,
-    std::function<void(T& buffer)> updateFunction)
+    std::function<void(T& buffer)> updateFunction,
+    RenderStats * pStats = nullptr)
 {
-    ConstantBufferUpdater<T, shaderType, slotIndex> updater(pDeviceContext, pBufferToUpdate);
+    ConstantBufferUpdater<T, shaderType, slotIndex> updater(pDeviceContext, pBufferToUpdate, pStats);
     return updater.Update(updateFunction);
 }
 
@@ -48,9 +56,11 @@ HRESULT UpdateConstantsBuffer(
 template<typename T, ShaderType shaderType, int slotIndex>
 ConstantBufferUpdater<T, shaderType, slotIndex>::ConstantBufferUpdater(
     ID3D11DeviceContext *pDeviceContext,
-    ID3D11Buffer *pBufferToUpdate)
+    ID3D11Buffer *pBufferToUpdate,
+    RenderStats * pStats)
     : mpDeviceContext(pDeviceContext),
-      mpBufferToUpdate(pBufferToUpdate)
+      mpBufferToUpdate(pBufferToUpdate),
+      mpStats(pStats)
 {
     VerifyNotNull(mpDeviceContext);
     VerifyNotNull(mpBufferToUpdate);
@@ -78,6 +88,11 @@ ConstantBufferUpdater<T, shaderType, slotIndex>::~ConstantBufferUpdater()
         default:
             throw SandboxException(L"Unknown shader type specified when updating constant buffer");
     }
+
+    if (mpStats != nullptr)
+    {
+        mpStats->Add(RenderCounter::BufferBinds);
+    }
 }
 
 template<typename T, ShaderType shaderType, int slotIndex>
@@ -93,6 +108,12 @@ HRESULT ConstantBufferUpdater<T, shaderType, slotIndex>::Update(std::function<vo
         // Let user callback update the buffer.
         T * pTypedPointer = reinterpret_cast<T*>(mappedChunk.pData);
         updateFunction(*pTypedPointer);
+
+        if (mpStats != nullptr)
+        {
+            mpStats->Add(RenderCounter::MapCalls);
+            mpStats->Add(RenderCounter::BytesUploaded, sizeof(T));
+        }
     }
 
     return hr;
@@ -6,6 +6,8 @@
 #include "DrawableText.h"
 #include "Size.h"
 #include "Camera.h"
+#include "ScratchArena.h"
+#include "MemoryTracker.h"
 
 #include "SimpleMath.h"
 #include <d3d11.h>
@@ -33,14 +35,17 @@ DrawableText::~DrawableText()
 
 void DrawableText::Initialize(Dx3d& dx, int maxLength)
 {
+    MemoryTagScope tag(MemoryTag::Text);
+
     // Initialize values in text object.
     mMaxLength = maxLength;
     mVertexCount = 6 * maxLength;       // TODO: Magic number.
     mIndexCount = mVertexCount;
 
-    // Allocate temporary software vertex and index arrays.
-    vertex_t * pVertices = new vertex_t[mVertexCount];
-    unsigned long * pIndices = new unsigned long[mIndexCount];
+    // Temporary software vertex and index arrays, released when scratch goes out of scope.
+    ScratchScope scratch;
+    vertex_t * pVertices = scratch.AllocateArray<vertex_t>(mVertexCount);
+    unsigned long * pIndices = scratch.AllocateArray<unsigned long>(mIndexCount);
 
     // Initialize vertex array to zero, and the index array to point to each vertex in order.
     memset(pVertices, 0, sizeof(vertex_t)* mVertexCount);
@@ -89,10 +94,6 @@ void DrawableText::Initialize(Dx3d& dx, int maxLength)
     result = dx.GetDevice()->CreateBuffer(&ibd, &indexData, &mIndexBuffer);
     VerifyDXResult(result);
 
-    // Release temporary arrays now that we have created the hardware buffers.
-    SafeDeleteArray(pVertices);
-    SafeDeleteArray(pIndices);
-
     SetInitialized();
 }
 
@@ -116,9 +117,10 @@ void DrawableText::Update(
     mGreen = g;
     mBlue = b;
 
-    // Create a temporary vertex array.
-    //  TODO: Just use the mapped hardware array.
-    vertex_t * pVertices = new vertex_t[mVertexCount];
+    // Build the vertices in this thread's scratch arena rather than a heap array per call. The mapped buffer is
+    // write combined, so it is filled with one sequential copy instead of being built in place.
+    ScratchScope scratch;
+    vertex_t * pVertices = scratch.AllocateArray<vertex_t>(mVertexCount);
     memset(pVertices, 0, sizeof(vertex_t) * mVertexCount);
 
     // Calculate the x and y pixel position on screen to draw at.
@@ -140,8 +142,8 @@ void DrawableText::Update(
 
     dx.GetDeviceContext()->Unmap(mVertexBuffer.Get(), 0);
 
-    // Clean up no longer needed vertex array.
-    SafeDeleteArray(pVertices);
+    dx.Stats().Add(RenderCounter::MapCalls);
+    dx.Stats().Add(RenderCounter::BytesUploaded, sizeof(vertex_t) * mVertexCount);
 }
 
 void DrawableText::Render(Dx3d& dx,
@@ -159,6 +161,7 @@ void DrawableText::Render(Dx3d& dx,
     dx.GetDeviceContext()->IASetVertexBuffers(0, 1, vertexBuffers, &stride, &offset);
     dx.GetDeviceContext()->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
     dx.GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    dx.Stats().Add(RenderCounter::BufferBinds, 2);
 
     // Render the text by way of shader. TODO: Don't do it like this.
     Vector4 pixelColor(mRed, mGreen, mBlue, 1.0f);
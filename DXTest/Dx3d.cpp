@@ -28,7 +28,8 @@ Dx3d::Dx3d()
   mRasterState(),
   mDepthDisabledStencilState(),
   mAlphaEnabledBlendingState(),
-  mAlphaDisabledBlendingState()
+  mAlphaDisabledBlendingState(),
+  mStats()
 {
 }
 
@@ -561,6 +562,7 @@ void Dx3d::EndScene()
 {
     if (!IsInitialized()) { return; }       // TODO: Verify BeginScene() was called.
 	mSwapChain->Present((mVysncEnabled ? 1 : 0), 0);
+    mStats.EndFrame();
 }
 
 // TODO: Get rid of all these accessor... bad.
@@ -577,6 +579,7 @@ ID3D11DeviceContext * Dx3d::GetDeviceContext()
 void Dx3d::SetZBufferEnabled(bool zEnabled)
 {
     if (!IsInitialized()) { return; }
+    mStats.Add(RenderCounter::StateChanges);
 
     if (zEnabled)
     {
@@ -593,6 +596,8 @@ void Dx3d::SetAlphaBlendingEnabled(bool alphaBlendEnabled)
     if (!IsInitialized()) { return; }
     float blendFactor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
+    mStats.Add(RenderCounter::StateChanges);
+
     if (alphaBlendEnabled)
     {
         mDeviceContext->OMSetBlendState(mAlphaEnabledBlendingState.Get(), blendFactor, 0xFFFFFFFF);
@@ -730,5 +735,55 @@ HRESULT Dx3d::CreateConstantBuffer(
         *ppConstantBufferOut = constantBuffer.Detach();
     }
 
+    return hr;
+}
+
+HRESULT Dx3d::CreateDynamicShaderBuffer(
+    size_t elementSize,
+    size_t elementCount,
+    DXGI_FORMAT format,
+    ID3D11Buffer **ppBufferOut,
+    ID3D11ShaderResourceView **ppViewOut) const
+{
+    VerifyNotNull(ppBufferOut);
+    VerifyNotNull(ppViewOut);
+    Verify(elementSize > 0 && elementCount > 0);
+    *ppBufferOut = nullptr;
+    *ppViewOut = nullptr;
+
+    const bool isStructured = (format == DXGI_FORMAT_UNKNOWN);
+    D3D11_BUFFER_DESC bufferDesc;
+
+    bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+    bufferDesc.ByteWidth = static_cast<UINT>(elementSize * elementCount);
+    bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    bufferDesc.MiscFlags = isStructured ? D3D11_RESOURCE_MISC_BUFFER_STRUCTURED : 0;
+    bufferDesc.StructureByteStride = isStructured ? static_cast<UINT>(elementSize) : 0;
+
+    Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+    HRESULT hr = mDevice->CreateBuffer(&bufferDesc, nullptr, &buffer);
+
+    // The view covers every element of the buffer.
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> view;
+
+    if (SUCCEEDED(hr))
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+
+        viewDesc.Format = format;
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        viewDesc.Buffer.FirstElement = 0;
+        viewDesc.Buffer.NumElements = static_cast<UINT>(elementCount);
+
+        hr = mDevice->CreateShaderResourceView(buffer.Get(), &viewDesc, &view);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        *ppBufferOut = buffer.Detach();
+        *ppViewOut = view.Detach();
+    }
+
     return hr;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <string>
 #include <functional>
 #include "IInitializable.h"
+#include "RenderStats.h"
 #include "typedefs.h"
 
 #include <wrl\wrappers\corewrappers.h>      // ComPtr
@@ -61,6 +62,10 @@ public:
 	ID3D11DeviceContext* GetDeviceContext();
     vram_info_t GetVRamInfo() const;
 
+    // Work counters for the frame being drawn. EndScene() closes the frame.
+    RenderStats& Stats() { return mStats; }
+    const RenderStats& Stats() const { return mStats; }
+
     void SetBackgroundColor(const DirectX::SimpleMath::Color& backgroundColor);
     void SetZBufferEnabled(bool zEnabled);
     void SetAlphaBlendingEnabled(bool alphaBlendEnabled);
@@ -80,6 +85,15 @@ public:
         size_t elementSize,
         ID3D11Buffer **ppConstantBufferOut) const;
 
+    // Create a CPU writable buffer the pixel shader reads through a view. Pass DXGI_FORMAT_UNKNOWN for a structured
+    // buffer of elementSize byte elements, or the element format for a typed buffer.
+    HRESULT CreateDynamicShaderBuffer(
+        size_t elementSize,
+        size_t elementCount,
+        DXGI_FORMAT format,
+        ID3D11Buffer **ppBufferOut,
+        ID3D11ShaderResourceView **ppViewOut) const;
+
 protected:
     virtual void OnShutdown() override;
 
@@ -157,5 +171,6 @@ private:
     Microsoft::WRL::ComPtr<ID3D11DepthStencilState> mDepthDisabledStencilState;
     Microsoft::WRL::ComPtr<ID3D11BlendState> mAlphaEnabledBlendingState;
     Microsoft::WRL::ComPtr<ID3D11BlendState> mAlphaDisabledBlendingState;
+    RenderStats mStats;
 };
 
@@ -1,13 +1,15 @@
 #include "Font.h"
 #include "Texture.h"
+#include "BinaryBlob.h"
 #include "DXSandbox.h"
 #include "DXTestException.h"
 #include "Utils.h"
+#include "TextUtils.h"
+#include "MemoryTracker.h"
 #include "SimpleMath.h"
 
 #include <d3d11.h>
 
-#include <fstream>
 #include <vector>
 #include <memory>
 
@@ -37,6 +39,7 @@ void Font::Initialize(ID3D11Device *pDevice, const std::wstring& layoutFile, con
     if (IsInitialized()) { return; }
     VerifyNotNull(pDevice);
 
+    MemoryTagScope tag(MemoryTag::Text);
     mCharInfo = LoadFontLayout(layoutFile);
     
     mTexture.reset(new Texture());
@@ -49,31 +52,34 @@ std::vector<Font::font_char_t> Font::LoadFontLayout(const std::wstring& layoutFi
     // [Character ascii value] [Character] [Left tu coord] [Right tu cord] [Pixel width]
     std::vector<Font::font_char_t> fontInfo(FONT_CHAR_COUNT);
 
-    // Read the font layout values from the text file.
-    std::fstream layoutStream(layoutFile.c_str());
-    char temp;
-
-    if (layoutStream.fail())
-    {
-        throw FileLoadException(layoutFile);
-    }
+    // Read the font layout values from the text file, in place. LoadFromFile throws if the file can not be opened.
+    BinaryBlob layoutBlob = BinaryBlob::LoadFromFile(layoutFile);
+    TextUtils::Tokenizer lines(
+        StringView(layoutBlob.BufferPointer(), static_cast<size_t>(layoutBlob.BufferSize())),
+        "\r\n");
 
     for (int i = 0; i < FONT_CHAR_COUNT; ++i)
     {
-        // Read through data in file we do not need.
-        layoutStream.get(temp);
-        while (temp != ' ') { layoutStream.get(temp); }
+        StringView line;
+
+        if (!lines.Next(&line))
+        {
+            throw FileFormatException(L"Font layout is missing characters", layoutFile);
+        }
 
-        layoutStream.get(temp);
-        while (temp != ' ') { layoutStream.get(temp); }
+        // Skip the ascii value and the character after it, which may itself be a space.
+        const size_t valueEnd = line.Find(' ');
+        TextUtils::Tokenizer fields(line.Substring(valueEnd == StringView::NotFound ? line.Size() : valueEnd + 2));
 
         // Now read values.
-        layoutStream >> fontInfo[i].left;
-        layoutStream >> fontInfo[i].right;
-        layoutStream >> fontInfo[i].size;
+        if (!fields.NextFloat(&fontInfo[i].left) ||
+            !fields.NextFloat(&fontInfo[i].right) ||
+            !fields.NextInt(&fontInfo[i].size))
+        {
+            throw FileFormatException(L"Malformed font layout", layoutFile);
+        }
     }
 
-    layoutStream.close();
     return fontInfo;
 }
 
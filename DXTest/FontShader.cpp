@@ -184,7 +184,7 @@ void FontShader::SetShaderParameters(
             m.world = inWorldMatrix.Transpose();
             m.view = inViewMatrix.Transpose();
             m.projection = inProjectionMatrix.Transpose();
-    });
+    }, &dx.Stats());
 
     VerifyDXResult(hr);
 
@@ -195,10 +195,11 @@ void FontShader::SetShaderParameters(
         [&](pixel_buffer_t& p)
         {
             p.pixelColor = pixelColor;
-    });
+    }, &dx.Stats());
 
     // Set up shader texture resource in the pixel shader.
     dx.GetDeviceContext()->PSSetShaderResources(0, 1, &pTexture);
+    dx.Stats().Add(RenderCounter::ResourceBinds);
 }
 
 void FontShader::RenderShader(Dx3d& dx, int indexCount)
@@ -216,6 +217,12 @@ void FontShader::RenderShader(Dx3d& dx, int indexCount)
 
 	// Render the object.
     dx.GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
+
+    // Input layout and two shaders, one sampler, one draw.
+    dx.Stats().Add(RenderCounter::ShaderBinds, 3);
+    dx.Stats().Add(RenderCounter::ResourceBinds);
+    dx.Stats().Add(RenderCounter::DrawCalls);
+    dx.Stats().Add(RenderCounter::Indices, indexCount);
 }
 
 void FontShader::OnShutdown()
@@ -9,20 +9,53 @@
 #include "LightShader.h"
 #include "Light.h"
 #include "UiTextRenderer.h"
+#include "Texture.h"
+#include "BoundingVolumes.h"
+#include "DdsFile.h"
+#include "MeshData.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "RenderStats.h"
 #include "SimpleMath.h"
 #include "size.h"
 
 using namespace DirectX::SimpleMath;
 
+namespace
+{
+    // A DDS file parsed on a loader thread, waiting to be created on the device.
+    struct decoded_texture_t
+    {
+        AssetLoader::file_t file;
+        dds_image_t image;
+    };
+
+    // A model that passed culling, drawn once the whole scene has been culled.
+    struct draw_t
+    {
+        Model * pModel;
+        unsigned int lod;
+        Matrix worldMatrix;
+    };
+}
+
 Graphics::Graphics()
-: mFrustum(),
+: mFrameArena(FRAME_ARENA_BYTES),
+  mFrustum(),
+  mLodSelector(),
   mD3d(),
   mCamera(),
   mUiCamera(),
   mUiTextRenderer(),
+  mAssetLoader(),
+  mModelTexture(),
+  mPendingModels(),
   mModels(),
   mLightShader(),
-  mLight()
+  mLight(),
+  mLocalLights(),
+  mLightClusters(),
+  mFramesSinceStatsOverlay(RENDER_STATS_REFRESH_FRAMES)
 {
 }
 
@@ -61,28 +94,55 @@ void Graphics::Initialize(const Size& screenSize, HWND hwnd)
     mUiCamera->Render();
 
 	// Create the text manager class.
-	mUiTextRenderer.reset(new UiTextRenderer());
-    mUiTextRenderer->Initialize(*mD3d.get(), screenSize);
-
-    // Initialize and load models.
-    for (auto i : MakeRange(0, 25))
     {
-        Model *pModel = new Model();
-        pModel->Initialize(mD3d->GetDevice(), L".\\Models\\cube.model", L".\\Textures\\seafloor.dds");
-
-        // Assign random position and color.
-        Vector4 color(Utils::RandFloat(), Utils::RandFloat(), Utils::RandFloat(), 1.0f);
-        Vector3 position(Utils::RandFloat(0.0f, 6.0f), Utils::RandFloat(2.0f, 8.0f), Utils::RandFloat(-3.0f, -1.0f));
-//        Vector3 position(Utils::RandFloat(-10.0f, 0.0f), Utils::RandFloat(-10.0f, 0.0f), Utils::RandFloat(-6.0f, -1.0f));
-//        Vector3 position(0.0f, 0.0f, -1);
+        MemoryTagScope tag(MemoryTag::UI);
 
-  //      position = Vector3(0.0f, -3.0f, 0.0f);
+        mUiTextRenderer.reset(new UiTextRenderer());
+        mUiTextRenderer->Initialize(*mD3d.get(), screenSize);
+    }
 
-        pModel->SetColor(color);
-        pModel->SetPosition(position);
+    // Start loading the models and their texture in the background. They are added to the scene as they finish,
+    // see AddLoadedModels().
+    ID3D11Device *pDevice = mD3d->GetDevice();
+    mAssetLoader.reset(new AssetLoader());
+
+    mModelTexture = mAssetLoader->Load<decoded_texture_t, Texture>(
+        L".\\Textures\\seafloor.dds",
+        [](const AssetLoader::file_t& file, const std::wstring& filepath) {
+            MemoryTagScope tag(MemoryTag::Textures);
+            std::unique_ptr<decoded_texture_t> decoded(new decoded_texture_t());
+            decoded->file = file;
+
+            DdsFile::Parse(file->BufferPointer(), static_cast<size_t>(file->BufferSize()), filepath, &decoded->image);
+            return decoded;
+        },
+        [pDevice](decoded_texture_t& decoded) {
+            MemoryTagScope tag(MemoryTag::Textures);
+            std::shared_ptr<Texture> texture(new Texture());
+            texture->InitializeFromDds(pDevice, decoded.image, decoded.file->BufferPointer(), L"seafloor.dds");
+            return texture;
+        });
 
-        // Store for later rendering.
-        mModels.push_back(pModel);
+    for (auto i : MakeRange(0, 25))
+    {
+        mPendingModels.push_back(mAssetLoader->Load<s_mesh_data_t, Model>(
+            L".\\Models\\cube.model",
+            [](const AssetLoader::file_t& file, const std::wstring& filepath) {
+                MemoryTagScope tag(MemoryTag::Meshes);
+                std::unique_ptr<s_mesh_data_t> mesh(new s_mesh_data_t());
+                Model::ParseModel(
+                    file->BufferPointer(),
+                    static_cast<size_t>(file->BufferSize()),
+                    filepath,
+                    mesh.get());
+                return mesh;
+            },
+            [pDevice](s_mesh_data_t& mesh) {
+                MemoryTagScope tag(MemoryTag::Meshes);
+                std::shared_ptr<Model> model(new Model());
+                model->Initialize(pDevice, mesh, VertexFormat::Compact);
+                return model;
+            }));
     }
 
     // Create a light and a light shader for the model.
@@ -98,6 +158,9 @@ void Graphics::Initialize(const Size& screenSize, HWND hwnd)
 
     mLight->SetDirection(Vector3(0.0f, 0.0f, 1.0f));
 
+    // Point and spot lights around the models, assigned to light clusters each frame.
+    CreateLocalLights();
+
     SetInitialized();
 }
 
@@ -106,7 +169,17 @@ void Graphics::Initialize(const Size& screenSize, HWND hwnd)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Graphics::OnShutdown()
 {
-    SafeDeleteContainer(mModels);
+    // Stop the loader threads before the device their uploads would use goes away.
+    mAssetLoader.reset();
+    mPendingModels.clear();
+    mModelTexture = AssetHandle<Texture>();
+    mModels.clear();
+}
+
+const RenderStats& Graphics::GetRenderStats() const
+{
+    AssertNotNull(mD3d.get());
+    return mD3d->Stats();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -115,6 +188,7 @@ void Graphics::OnShutdown()
 void Graphics::Frame()
 {
     if (!IsInitialized()) { return; }
+    PROFILE_SCOPE("Graphics::Frame");
 
     const float pi = 3.14159f;
     const float halfPi = 3.14159f / 2.0f;
@@ -126,8 +200,86 @@ void Graphics::Frame()
     if (rotation > pi) { rotation = pi; isForward = false; }
     else if (rotation < 0) { rotation = 0.0f; isForward = true; }
 
+    // Create device resources for assets that finished loading, then add any completed models to the scene.
+    mAssetLoader->ProcessUploads(ASSET_UPLOAD_BUDGET_SECONDS);
+    AddLoadedModels();
+
 	Render(rotation);
     RenderUi();
+
+    // Everything allocated for this frame is released at once.
+    mFrameArena.Reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Move models that finished loading into the scene. Get() rethrows load errors.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Graphics::AddLoadedModels()
+{
+    PROFILE_SCOPE("Graphics::AddLoadedModels");
+
+    // Models are only shown once their texture is available.
+    std::shared_ptr<Texture> texture = mModelTexture.Get();
+
+    if (texture == nullptr || mPendingModels.empty())
+    {
+        return;
+    }
+
+    auto pending = mPendingModels.begin();
+
+    while (pending != mPendingModels.end())
+    {
+        std::shared_ptr<Model> model = pending->Get();
+
+        if (model == nullptr)
+        {
+            ++pending;
+            continue;
+        }
+
+        // Assign random position and color.
+        Vector4 color(Utils::RandFloat(), Utils::RandFloat(), Utils::RandFloat(), 1.0f);
+        Vector3 position(Utils::RandFloat(0.0f, 6.0f), Utils::RandFloat(2.0f, 8.0f), Utils::RandFloat(-3.0f, -1.0f));
+
+        model->SetTexture(texture);
+        model->SetColor(color);
+        model->SetPosition(position);
+
+        // Store for later rendering.
+        mModels.push_back(model);
+        pending = mPendingModels.erase(pending);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Scatter small colored point lights through the volume the models are placed in, with every fourth light a spot
+// shining down on them.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Graphics::CreateLocalLights()
+{
+    mLocalLights.resize(LOCAL_LIGHT_COUNT);
+
+    for (size_t i = 0; i < mLocalLights.size(); ++i)
+    {
+        local_light_t& light = mLocalLights[i];
+
+        light.position = Vector3(Utils::RandFloat(-4.0f, 10.0f), Utils::RandFloat(0.0f, 10.0f),
+                                 Utils::RandFloat(-6.0f, 2.0f));
+        light.range = Utils::RandFloat(1.5f, 4.0f);
+        light.color = Vector3(Utils::RandFloat(), Utils::RandFloat(), Utils::RandFloat());
+        light.intensity = 0.5f;
+        light.direction = Vector3(0.0f, -1.0f, 0.0f);
+        light.spotCosAngle = 0.0f;
+        light.type = LocalLightType::Point;
+
+        if (i % 4 == 0)
+        {
+            light.range *= 2.0f;
+            light.spotCosAngle = Utils::RandFloat(0.8f, 0.95f);
+            light.type = LocalLightType::Spot;
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -136,28 +288,38 @@ void Graphics::Frame()
 void Graphics::Render(float rotation)
 {
     if (!IsInitialized()) { return; }
+    PROFILE_SCOPE("Graphics::Render");
 
 	// Clear graphics buffers before beginning scene rendering.
 	mD3d->BeginScene();
 
-	// Generate the view matrix based on the camera's position. Grab the world, view and projection matrices from the
-	// camera and d3d objects.
-	mCamera->Render();
-
-	Matrix viewMatrix = mCamera->ViewMatrix();
+	// Grab the world, view and projection matrices from the camera and d3d objects. The camera only rebuilds its
+	// matrices when it has moved since the last frame.
+	const Matrix& viewMatrix = mCamera->ViewMatrix();
     Matrix worldMatrix = DirectX::XMMatrixIdentity();
-	Matrix projectionMatrix = mCamera->ProjectionMatrix();
+	const Matrix& projectionMatrix = mCamera->ProjectionMatrix();
 
     // Rotate the world a little bit to show off.
     worldMatrix = Matrix::CreateRotationY(rotation) * worldMatrix;
 
-    // Update camera view frustum before proceeding with rendering.
-    mFrustum.Update(SCREEN_DEPTH, projectionMatrix, viewMatrix);
+    // Update camera view frustum before proceeding with rendering, skipped when the camera has not changed.
+    mFrustum.Update(*mCamera);
+    mLodSelector.BeginFrame(mCamera->FieldOfView(), mCamera->ScreenHeight());
+
+    // Sort the point and spot lights into the camera's light clusters and hand the lists to the light shader.
+    {
+        PROFILE_SCOPE("Graphics::AssignLights");
+        mLightClusters.Assign(*mCamera, mLocalLights.data(), mLocalLights.size());
+        mLightShader->SetLocalLights(*mD3d, *mCamera, mLightClusters, mLocalLights.data(), mLocalLights.size());
+    }
+
+    // Cull first and collect what is visible in the frame arena, then draw.
+    std::vector<draw_t, ArenaAllocator<draw_t>> draws((ArenaAllocator<draw_t>(mFrameArena)));
+    draws.reserve(mModels.size());
 
-	//// Put the model's vertex and index buffers on the graphics pipeline to prepare them for drawing.
-    for (Model *pModel : mModels)
+    for (const std::shared_ptr<Model>& pModel : mModels)
     {
-        AssertNotNull(pModel);
+        AssertNotNull(pModel.get());
         Model& model = *pModel;
 
         // Don't render the model if it is disabled.
@@ -166,28 +328,76 @@ void Graphics::Render(float rotation)
             continue;
         }
 
-        // Don't render the model if it is not visible to the camera frustum.
- /*       if (!mFrustum.CheckSphere(model.BoundingSphereCenter(), model.BoundingSphereRadius()))
-        {
-            continue;
-        }*/
-
         // Move the object to the correct location for rendering.
         //  TODO: Does this belong somewhere else? Honestly all this terrible rendering code from rasterk needs to
         //        be burned in a fire and refactored.
-        Matrix objectWorldMatrix = Matrix::CreateTranslation(pModel->Position()) * worldMatrix;
+        Matrix modelToWorldMatrix = Matrix::CreateTranslation(pModel->Position()) * worldMatrix;
+        Matrix objectWorldMatrix = pModel->DequantizationMatrix() * modelToWorldMatrix;
+
+        // Don't render the model if it is not visible to the camera frustum. The sphere test is cheap, the box is
+        // tighter for long thin objects.
+        bounding_sphere_t sphere = model.WorldBoundingSphere(modelToWorldMatrix);
+        Vector3 sphereCenter(sphere.center[0], sphere.center[1], sphere.center[2]);
+
+        mD3d->Stats().Add(RenderCounter::ObjectsTested);
+
+        if (!mFrustum.CheckSphere(sphereCenter, sphere.radius))
+        {
+            mD3d->Stats().Add(RenderCounter::ObjectsCulled);
+            continue;
+        }
+
+        aabb_t box = model.WorldBoundingBox(modelToWorldMatrix);
+        Vector3 boxMin(box.min[0], box.min[1], box.min[2]);
+        Vector3 boxMax(box.max[0], box.max[1], box.max[2]);
+
+        if (!mFrustum.CheckRectangle((boxMin + boxMax) * 0.5f, (boxMax - boxMin) * 0.5f))
+        {
+            mD3d->Stats().Add(RenderCounter::ObjectsCulled);
+            continue;
+        }
+
+        // Pick the coarsest level of detail whose error is invisible from here. LOD errors are in model units, so
+        // scale them by the model's world scale.
+        unsigned int lod = 0;
+
+        if (model.LodCount() > 1)
+        {
+            lod = mLodSelector.SelectLevel(
+                &model.LodErrors()[0],
+                model.LodCount(),
+                Vector3::Distance(sphereCenter, mCamera->Position()),
+                sphere.radius,
+                BoundingVolumes::MaxScale(&modelToWorldMatrix._11),
+                model.CurrentLod());
+
+            model.SetCurrentLod(lod);
+        }
+
+        mLodSelector.RecordDraw(model.LodIndexCount(lod) / 3, model.IndexCount() / 3);
+
+        draw_t draw = { &model, lod, objectWorldMatrix };
+        draws.push_back(draw);
+    }
+
+	// Put each model's vertex and index buffers on the graphics pipeline and draw it.
+    for (const draw_t& draw : draws)
+    {
+        Model& model = *draw.pModel;
 
         // This is really a "bind buffers for rendering" method call.
-        pModel->BindModelBuffersForRendering(mD3d->GetDeviceContext());
+        model.BindModelBuffersForRendering(mD3d->GetDeviceContext(), &mD3d->Stats());
 
         // Render the model using the color shader.
         mLightShader->Render(
             *mD3d.get(),
-            pModel->IndexCount(),
-            objectWorldMatrix,
+            model.LodIndexCount(draw.lod),
+            model.LodStartIndex(draw.lod),
+            model.GetVertexFormat(),
+            draw.worldMatrix,
             viewMatrix,
             projectionMatrix,
-            pModel->GetTexture(),
+            model.GetTexture(),
             *mCamera,
             *mLight);
     }
@@ -198,6 +408,15 @@ void Graphics::Render(float rotation)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Graphics::RenderUi()
 {
+    PROFILE_SCOPE("Graphics::RenderUi");
+
+    // Refreshing the overlay maps every line's vertex buffer, so it is only done a few times a second.
+    if (SHOW_RENDER_STATS && ++mFramesSinceStatsOverlay >= RENDER_STATS_REFRESH_FRAMES)
+    {
+        mUiTextRenderer->SetOverlayText(*mD3d.get(), mD3d->Stats().OverlayLines());
+        mFramesSinceStatsOverlay = 0;
+    }
+
     mD3d->SetZBufferEnabled(false);
     mD3d->SetAlphaBlendingEnabled(true);
 
@@ -3,13 +3,22 @@
 #include <vector>
 #include <memory>
 
+#include "AssetLoader.h"
+#include "FrameArena.h"
 #include "Frustum.h"
+#include "LightClusters.h"
+#include "LodSelector.h"
 #include "IInitializable.h"
 
 const bool FULL_SCREEN = false;
 const bool VSYNC_ENABLED = true;
 const float SCREEN_DEPTH = 1000.0f;
 const float SCREEN_NEAR = 0.1f;
+const double ASSET_UPLOAD_BUDGET_SECONDS = 0.002;     // Render thread time per frame spent creating loaded assets.
+const size_t FRAME_ARENA_BYTES = 256 * 1024;          // Starting size of the per frame arena, it grows if needed.
+const bool SHOW_RENDER_STATS = true;                  // Draw the renderer statistics overlay.
+const unsigned int RENDER_STATS_REFRESH_FRAMES = 30;  // Frames between overlay refreshes.
+const size_t LOCAL_LIGHT_COUNT = 256;                 // Point and spot lights scattered around the models.
 
 class Dx3d;
 class Camera;
@@ -18,6 +27,8 @@ class UiTextRenderer;
 class Light;
 class LightShader;
 class Size;
+class Texture;
+class RenderStats;
 
 class Graphics : public IInitializable
 {
@@ -31,21 +42,44 @@ public:
     void Initialize(const Size& screenSize, HWND hwnd);
 	void Frame();		// terrible name
 
+    // Level of detail thresholds, bias and the triangle counts of the last rendered frame.
+    LodSelector& GetLodSelector() { return mLodSelector; }
+    const LodSelector& GetLodSelector() const { return mLodSelector; }
+
+    // Background loader for models and textures. Loaded assets are uploaded at the start of each frame.
+    AssetLoader& GetAssetLoader() { return *mAssetLoader.get(); }
+
+    // Memory for data that only lives until the end of the current frame.
+    FrameArena& GetFrameArena() { return mFrameArena; }
+
+    // Draw, bind, upload and culling counters over the last few seconds of frames.
+    const RenderStats& GetRenderStats() const;
+
 protected:
     virtual void OnShutdown() override;
 
 private:
 	void Render(float rotation);
     void RenderUi();
+    void AddLoadedModels();
+    void CreateLocalLights();
 
 private:
+    FrameArena mFrameArena;
     Frustum mFrustum;
+    LodSelector mLodSelector;
 	std::unique_ptr<Dx3d> mD3d;
 	std::unique_ptr<Camera> mCamera;
     std::unique_ptr<Camera> mUiCamera;
     std::unique_ptr<UiTextRenderer> mUiTextRenderer;
-    std::vector<Model *> mModels;       // TODO: Make use unique_ptr or something.
+    std::unique_ptr<AssetLoader> mAssetLoader;
+    AssetHandle<Texture> mModelTexture;
+    std::vector<AssetHandle<Model>> mPendingModels;
+    std::vector<std::shared_ptr<Model>> mModels;
     std::unique_ptr<LightShader> mLightShader;
     std::unique_ptr<Light> mLight;
+    std::vector<local_light_t> mLocalLights;
+    LightClusters mLightClusters;
+    unsigned int mFramesSinceStatsOverlay;
 };
 
@@ -7,10 +7,12 @@
 #include "Camera.h"
 #include "ConstantBufferUpdater.h"
 #include "Dx3d.h"
+#include "LightClusters.h"
 
 #include <wrl\wrappers\corewrappers.h>      // ComPtr
 #include <wrl\client.h>
 #include <memory>
+#include <algorithm>
 
 #include <d3d11.h>
 
@@ -21,6 +23,7 @@ using namespace DirectX::SimpleMath;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 static const wchar_t LightVertexShaderFilePath[] = L".\\Shaders\\SimpleLightVertexShader.cso";
 static const wchar_t LightPixelShaderFilePath[] = L".\\Shaders\\SimpleLightPixelShader.cso";
+static const wchar_t CompactLightVertexShaderFilePath[] = L".\\Shaders\\CompactLightVertexShader.cso";
 
 struct matrix_buffer_t
 {
@@ -44,6 +47,76 @@ struct light_buffer_t
     Vector4 specularColor;
 };
 
+// Matches local_light_t in SimpleLightPixelShader.hlsl.
+struct gpu_local_light_t
+{
+    Vector3 position;
+    float range;
+    Vector3 color;
+    float spotCosAngle;
+    Vector3 direction;
+    float padding;
+};
+
+const float PointLightCosAngle = -2.0f;     // Every direction is inside the cone.
+
+struct cluster_buffer_t
+{
+    unsigned int clusterCounts[3];
+    float depthSliceScale;
+    float screenSize[2];
+    float depthSliceBias;
+    float padding;
+};
+
+namespace
+{
+    // Grow the buffer if it cannot hold count elements, then let write fill the first count of them.
+    template<typename ShaderBuffer, typename Writer>
+    void UploadShaderBuffer(
+        Dx3d& dx,
+        ShaderBuffer * pBuffer,
+        size_t elementSize,
+        size_t count,
+        DXGI_FORMAT format,
+        Writer write)
+    {
+        if (pBuffer->buffer == nullptr || count > pBuffer->capacity)
+        {
+            // Leave room to grow so a slowly rising light count does not recreate the buffer every frame.
+            const size_t capacity = std::max(std::max(count, pBuffer->capacity * 2), static_cast<size_t>(64));
+
+            pBuffer->view.Reset();
+            pBuffer->buffer.Reset();
+
+            HRESULT hr = dx.CreateDynamicShaderBuffer(
+                elementSize,
+                capacity,
+                format,
+                &pBuffer->buffer,
+                &pBuffer->view);
+
+            VerifyDXResult(hr);
+            pBuffer->capacity = capacity;
+        }
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = dx.GetDeviceContext()->Map(pBuffer->buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+        VerifyDXResult(hr);
+
+        write(mapped.pData);
+        dx.GetDeviceContext()->Unmap(pBuffer->buffer.Get(), 0);
+
+        dx.Stats().Add(RenderCounter::MapCalls);
+        dx.Stats().Add(RenderCounter::BytesUploaded, elementSize * count);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Light shader implementation
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -52,10 +125,16 @@ LightShader::LightShader()
       mVertexShader(),
       mPixelShader(),
       mLayout(),
+      mCompactVertexShader(),
+      mCompactLayout(),
       mMatrixBuffer(),
       mCameraBuffer(),
       mSamplerState(),
-      mLightBuffer()
+      mLightBuffer(),
+      mClusterBuffer(),
+      mLocalLights(),
+      mClusterLists(),
+      mLightIndices()
 {
 }
 
@@ -95,7 +174,19 @@ HRESULT LightShader::InitializeShader(Dx3d& dx)
         // Now that we vertex shader is created, we can create the vertex input layout.
         if (SUCCEEDED(hr))
         {
-            hr = CreateInputLayout(dx, vertexShaderBlob, &mLayout);
+            hr = CreateInputLayout(dx, VertexFormat::Full, vertexShaderBlob, &mLayout);
+        }
+    }
+
+    // Load the vertex shader variant that decodes compact vertices. It shares the pixel shader.
+    if (SUCCEEDED(hr))
+    {
+        BinaryBlob compactVertexShaderBlob = BinaryBlob::LoadFromFile(CompactLightVertexShaderFilePath);
+        hr = dx.CreateVertexShader(compactVertexShaderBlob, &mCompactVertexShader);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = CreateInputLayout(dx, VertexFormat::Compact, compactVertexShaderBlob, &mCompactLayout);
         }
     }
 
@@ -115,6 +206,11 @@ HRESULT LightShader::InitializeShader(Dx3d& dx)
         hr = dx.CreateConstantBuffer(sizeof(light_buffer_t), &mLightBuffer);
     }
 
+    if (SUCCEEDED(hr))
+    {
+        hr = dx.CreateConstantBuffer(sizeof(cluster_buffer_t), &mClusterBuffer);
+    }
+
     // Create a texture sampler state description.
     if (SUCCEEDED(hr))
     {
@@ -126,6 +222,7 @@ HRESULT LightShader::InitializeShader(Dx3d& dx)
 
 HRESULT LightShader::CreateInputLayout(
     Dx3d& dx,
+    VertexFormat vertexFormat,
     const BinaryBlob& vertexShaderBlob,
     ID3D11InputLayout **ppLayoutOut) const
 {
@@ -133,13 +230,15 @@ HRESULT LightShader::CreateInputLayout(
     *ppLayoutOut = nullptr;
 
     // Describe the layout of data that will be fed to this shader.
-    // This layout needs to match the vertex type structure defined in the model class and shader.
+    // This layout needs to match the vertex type structure defined in the model class and shader. Compact vertices
+    // use the compact_vertex_t layout from VertexCompression.h.
+    const bool isCompact = (vertexFormat == VertexFormat::Compact);
     const size_t INPUT_ELEMENT_COUNT = 3;
     D3D11_INPUT_ELEMENT_DESC polygonLayout[INPUT_ELEMENT_COUNT];
 
     polygonLayout[0].SemanticName = "POSITION";
     polygonLayout[0].SemanticIndex = 0;
-    polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    polygonLayout[0].Format = isCompact ? DXGI_FORMAT_R16G16B16A16_UNORM : DXGI_FORMAT_R32G32B32_FLOAT;
     polygonLayout[0].InputSlot = 0;
     polygonLayout[0].AlignedByteOffset = 0;
     polygonLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -147,7 +246,7 @@ HRESULT LightShader::CreateInputLayout(
 
     polygonLayout[1].SemanticName = "TEXCOORD";
     polygonLayout[1].SemanticIndex = 0;
-    polygonLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+    polygonLayout[1].Format = isCompact ? DXGI_FORMAT_R16G16_FLOAT : DXGI_FORMAT_R32G32_FLOAT;
     polygonLayout[1].InputSlot = 0;
     polygonLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
     polygonLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -155,7 +254,7 @@ HRESULT LightShader::CreateInputLayout(
 
     polygonLayout[2].SemanticName = "NORMAL";
     polygonLayout[2].SemanticIndex = 0;
-    polygonLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    polygonLayout[2].Format = isCompact ? DXGI_FORMAT_R16G16_SNORM : DXGI_FORMAT_R32G32B32_FLOAT;
     polygonLayout[2].InputSlot = 0;
     polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
     polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -182,6 +281,8 @@ HRESULT LightShader::CreateInputLayout(
 void LightShader::Render(
     Dx3d& dx,
     int indexCount,
+    unsigned int startIndex,
+    VertexFormat vertexFormat,
     const Matrix& worldMatrix,
     const Matrix& viewMatrix,
     const Matrix& projectionMatrix,
@@ -201,7 +302,73 @@ void LightShader::Render(
         camera,
         light);
 
-    RenderShader(dx, indexCount);
+    RenderShader(dx, indexCount, startIndex, vertexFormat);
+}
+
+void LightShader::SetLocalLights(
+    Dx3d& dx,
+    const Camera& camera,
+    const LightClusters& clusters,
+    const local_light_t * pLights,
+    size_t lightCount)
+{
+    if (!IsInitialized()) { throw NotInitializedException(L"LightShader"); }
+    Verify(lightCount == 0 || pLights != nullptr);
+
+    const std::vector<cluster_light_list_t>& lists = clusters.ClusterLists();
+    const std::vector<unsigned short>& indices = clusters.LightIndices();
+
+    // Spot angle and intensity are folded in here, so the pixel shader treats every light the same way.
+    const size_t lightSize = sizeof(gpu_local_light_t);
+
+    UploadShaderBuffer(dx, &mLocalLights, lightSize, lightCount, DXGI_FORMAT_UNKNOWN, [&](void * pData) {
+        gpu_local_light_t * pOut = reinterpret_cast<gpu_local_light_t*>(pData);
+
+        for (size_t i = 0; i < lightCount; ++i)
+        {
+            const local_light_t& light = pLights[i];
+            const bool isSpot = (light.type == LocalLightType::Spot);
+
+            pOut[i].position = light.position;
+            pOut[i].range = light.range;
+            pOut[i].color = light.color * light.intensity;
+            pOut[i].spotCosAngle = isSpot ? light.spotCosAngle : PointLightCosAngle;
+            pOut[i].direction = light.direction;
+            pOut[i].padding = 0.0f;
+        }
+    });
+
+    UploadShaderBuffer(dx, &mClusterLists, sizeof(cluster_light_list_t), lists.size(), DXGI_FORMAT_R32G32_UINT,
+        [&](void * pData) { memcpy(pData, lists.data(), lists.size() * sizeof(cluster_light_list_t)); });
+
+    UploadShaderBuffer(dx, &mLightIndices, sizeof(unsigned short), indices.size(), DXGI_FORMAT_R16_UINT,
+        [&](void * pData) { memcpy(pData, indices.data(), indices.size() * sizeof(unsigned short)); });
+
+    // Cluster grid layout, so the pixel shader can find its cluster.
+    HRESULT hr = UpdateConstantsBuffer<cluster_buffer_t, ShaderType::Pixel, 1>(
+        dx.GetDeviceContext(),
+        mClusterBuffer.Get(),
+        [&](cluster_buffer_t& c) {
+            c.clusterCounts[0] = clusters.ClustersX();
+            c.clusterCounts[1] = clusters.ClustersY();
+            c.clusterCounts[2] = clusters.ClustersZ();
+            c.depthSliceScale = clusters.DepthSliceScale();
+            c.screenSize[0] = camera.ScreenWidth();
+            c.screenSize[1] = camera.ScreenHeight();
+            c.depthSliceBias = clusters.DepthSliceBias();
+            c.padding = 0.0f;
+    }, &dx.Stats());
+
+    VerifyDXResult(hr);
+
+    // No other shader uses these slots, so they stay bound for the rest of the frame.
+    ID3D11ShaderResourceView * views[3] =
+    {
+        mLocalLights.view.Get(), mClusterLists.view.Get(), mLightIndices.view.Get()
+    };
+
+    dx.GetDeviceContext()->PSSetShaderResources(1, 3, views);
+    dx.Stats().Add(RenderCounter::ResourceBinds, 3);
 }
 
 void LightShader::SetShaderParameters(
@@ -225,7 +392,7 @@ void LightShader::SetShaderParameters(
             m.world = inWorldMatrix.Transpose();
             m.view = inViewMatrix.Transpose();
             m.projection = inProjectionMatrix.Transpose();
-    });
+    }, &dx.Stats());
 
     VerifyDXResult(hr);
 
@@ -236,7 +403,7 @@ void LightShader::SetShaderParameters(
         [&](camera_buffer_t& c) {
             c.cameraPosition = camera.Position();
             c.padding = 0.0f;
-    });
+    }, &dx.Stats());
 
     VerifyDXResult(hr);
 
@@ -250,21 +417,24 @@ void LightShader::SetShaderParameters(
             l.lightDirection = light.Direction();
             l.specularPower = light.SpecularPower();
             l.specularColor = light.SpecularColor();
-    });
+    }, &dx.Stats());
 
     VerifyDXResult(hr);
 
     // Set up shader texture resource in the pixel shader.
     dx.GetDeviceContext()->PSSetShaderResources(0, 1, &pTexture);
+    dx.Stats().Add(RenderCounter::ResourceBinds);
 }
 
-void LightShader::RenderShader(Dx3d& dx, int indexCount)
+void LightShader::RenderShader(Dx3d& dx, int indexCount, unsigned int startIndex, VertexFormat vertexFormat)
 {
+    const bool isCompact = (vertexFormat == VertexFormat::Compact);
+
     // Set the vertex input layout.
-    dx.GetDeviceContext()->IASetInputLayout(mLayout.Get());
+    dx.GetDeviceContext()->IASetInputLayout(isCompact ? mCompactLayout.Get() : mLayout.Get());
 
     // Set the color vertex and pixel shader.
-    dx.GetDeviceContext()->VSSetShader(mVertexShader.Get(), NULL, 0);
+    dx.GetDeviceContext()->VSSetShader(isCompact ? mCompactVertexShader.Get() : mVertexShader.Get(), NULL, 0);
     dx.GetDeviceContext()->PSSetShader(mPixelShader.Get(), NULL, 0);
 
     // Set the texture sampler state in the pixel shader.
@@ -273,7 +443,13 @@ void LightShader::RenderShader(Dx3d& dx, int indexCount)
     dx.GetDeviceContext()->PSSetSamplers(0, 1, samplerStates);
 
     // Render the object.
-    dx.GetDeviceContext()->DrawIndexed(indexCount, 0, 0);
+    dx.GetDeviceContext()->DrawIndexed(indexCount, startIndex, 0);
+
+    // Input layout and two shaders, one sampler, one draw.
+    dx.Stats().Add(RenderCounter::ShaderBinds, 3);
+    dx.Stats().Add(RenderCounter::ResourceBinds);
+    dx.Stats().Add(RenderCounter::DrawCalls);
+    dx.Stats().Add(RenderCounter::Indices, indexCount);
 }
 
 void LightShader::OnShutdown()
@@ -1,6 +1,7 @@
 #pragma once
 #include "SimpleMath.h"
 #include "IInitializable.h"
+#include "VertexCompression.h"
 
 #include <wrl\wrappers\corewrappers.h>      // ComPtr
 #include <wrl\client.h>
@@ -18,6 +19,8 @@ class Light;
 class Camera;
 class BinaryBlob;
 class Dx3d;
+class LightClusters;
+struct local_light_t;
 
 class LightShader : public IInitializable
 {
@@ -33,6 +36,8 @@ public:
     void Render(
         Dx3d& dx,
         int indexCount,
+        unsigned int startIndex,
+        VertexFormat vertexFormat,
         const DirectX::SimpleMath::Matrix&,
         const DirectX::SimpleMath::Matrix&,
         const DirectX::SimpleMath::Matrix&,
@@ -40,6 +45,15 @@ public:
         const Camera& camera,
         const Light& light);
 
+    // Upload this frame's point and spot lights and their cluster lists. Call once per frame after
+    // LightClusters::Assign() and before the first Render(). Buffers grow as needed and are reused.
+    void SetLocalLights(
+        Dx3d& dx,
+        const Camera& camera,
+        const LightClusters& clusters,
+        const local_light_t * pLights,
+        size_t lightCount);
+
 protected:
     virtual void OnShutdown() override;
 
@@ -48,6 +62,7 @@ private:
 
     HRESULT CreateInputLayout(
         Dx3d& dx,
+        VertexFormat vertexFormat,
         const BinaryBlob& vertexShaderBlob,
         ID3D11InputLayout **ppLayoutOut) const;
     
@@ -60,15 +75,32 @@ private:
         const Camera& camera,
         const Light& light);
 
-    void RenderShader(Dx3d& dx, int);
+    void RenderShader(Dx3d& dx, int, unsigned int, VertexFormat vertexFormat);
+
+private:
+    // A dynamic buffer read by the pixel shader, recreated larger when it runs out of room.
+    struct shader_buffer_t
+    {
+        Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> view;
+        size_t capacity;
+
+        shader_buffer_t() : buffer(), view(), capacity(0) { }
+    };
 
 private:
     Microsoft::WRL::ComPtr<ID3D11VertexShader> mVertexShader;
     Microsoft::WRL::ComPtr<ID3D11PixelShader> mPixelShader;
     Microsoft::WRL::ComPtr<ID3D11InputLayout> mLayout;
+    Microsoft::WRL::ComPtr<ID3D11VertexShader> mCompactVertexShader;
+    Microsoft::WRL::ComPtr<ID3D11InputLayout> mCompactLayout;
     Microsoft::WRL::ComPtr<ID3D11Buffer> mMatrixBuffer;
     Microsoft::WRL::ComPtr<ID3D11Buffer> mCameraBuffer;
     Microsoft::WRL::ComPtr<ID3D11SamplerState> mSamplerState;
     Microsoft::WRL::ComPtr<ID3D11Buffer> mLightBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer> mClusterBuffer;
+    shader_buffer_t mLocalLights;
+    shader_buffer_t mClusterLists;
+    shader_buffer_t mLightIndices;
 };
 
@@ -4,18 +4,22 @@
 #include "texture.h"
 #include "SimpleMath.h"
 #include "DXTestException.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "TextModelFile.h"
+#include "BinaryBlob.h"
+#include "BoundingVolumes.h"
+#include "VertexCompression.h"
+#include "ScratchArena.h"
+#include "RenderStats.h"
 
 #include <vector>
 #include <d3d11.h>
 #include <string>
-#include <fstream>
 
 using namespace DirectX::SimpleMath;
 
-// TODO: Split the s_mesh* and LoadModel code into a new class called SoftwareMesh (or something).
-//  - It holds mesh data loaded from disk.
-//  - Can load / save mesh data.
-//  - Contains type info to assist in coverted from it to DX hardware mesh for uploading
+// TODO: Move LoadModel into the SoftwareMesh class (see MeshData.h).
 
 struct vertex_type_t
 {
@@ -24,16 +28,47 @@ struct vertex_type_t
     Vector3 normal;
 };
 
+namespace
+{
+    // Every level of detail's indices back to back, converted to the index buffer's type.
+    template<typename IndexType>
+    IndexType * CopyLodIndices(const s_mesh_data_t& meshData, size_t indexCount, ScratchScope& scratch)
+    {
+        IndexType * pIndices = scratch.AllocateArray<IndexType>(indexCount);
+        IndexType * pNext = pIndices;
+
+        for (int index : meshData.indices)
+        {
+            *pNext++ = static_cast<IndexType>(index);
+        }
+
+        for (const s_mesh_lod_t& lod : meshData.lods)
+        {
+            for (int index : lod.indices)
+            {
+                *pNext++ = static_cast<IndexType>(index);
+            }
+        }
+
+        return pIndices;
+    }
+}
+
 Model::Model()
 : mEnabled(true),
   mVertexCount(0u),
   mIndexCount(0u),
+  mVertexFormat(VertexFormat::Full),
+  mVertexStride(sizeof(vertex_type_t)),
+  mUse16BitIndices(false),
+  mPositionQuantization(),
   mVertexBuffer(),
   mIndexBuffer(),
   mTexture(),
   mPosition(0, 0, 0),
   mColor(1, 1, 1, 1),
-  mBoundingSphereRadius(2.0f)
+  mBounds(),
+  mCurrentLod(0u)
 {
 }
 
@@ -44,7 +79,8 @@ Model::~Model()
 void Model::Initialize(
     ID3D11Device *pDevice,
     const std::wstring& modelFile,
-    const std::wstring& textureFile)
+    const std::wstring& textureFile,
+    VertexFormat vertexFormat)
 {
 	if (IsInitialized()) { return; }
 	VerifyNotNull(pDevice);
@@ -52,13 +88,25 @@ void Model::Initialize(
     s_mesh_data_t meshData;
     LoadModel(modelFile, &meshData);
 
+    // Load requested texture.
+    std::shared_ptr<Texture> texture(new Texture());
+    texture->InitializeFromFile(pDevice, textureFile);
+
+    SetTexture(texture);
+    Initialize(pDevice, meshData, vertexFormat);
+}
+
+void Model::Initialize(ID3D11Device *pDevice, const s_mesh_data_t& meshData, VertexFormat vertexFormat)
+{
+	if (IsInitialized()) { return; }
+	VerifyNotNull(pDevice);
+
+    mVertexFormat = vertexFormat;
+    mBounds = meshData.bounds;
+
     // TODO: Remember to set vertex/index count somewhere now that we put it into smesh_data_T.
     InitializeBuffers(pDevice, meshData);
 
-    // Load requested texture.
-    mTexture.reset(new Texture());
-    mTexture->InitializeFromFile(pDevice, textureFile);
-
     SetInitialized();
 }
 
@@ -68,34 +116,82 @@ void Model::InitializeBuffers(
 {
 	AssertNotNull(pDevice);
 
-	// Create two arrays to temporarily hold vertex and index data.
-    //  TODO: Explain conversion, uploading, etc.
-    std::vector<vertex_type_t> vertices(meshData.vertices.size());
-    std::vector<unsigned long> indices(meshData.indices.size());
+    mVertexCount = meshData.vertices.size();
+    mIndexCount = meshData.indices.size();
 
-	// Fill the temporary arrays with our vertex and index data.
-	//  - NOTE: Vertices need to be in clock wise order.
-    for (unsigned int i = 0; i < meshData.vertices.size(); ++i)
+    // Every level of detail shares the vertex buffer, and their index lists are stored back to back in one index
+    // buffer starting with the full detail level. Rendering a level only changes the index range.
+    mLodStartIndices.assign(1, 0u);
+    mLodIndexCounts.assign(1, mIndexCount);
+    mLodErrors.assign(1, 0.0f);
+    mCurrentLod = 0;
+
+    size_t totalIndexCount = meshData.indices.size();
+
+    for (const s_mesh_lod_t& lod : meshData.lods)
     {
-        vertices[i].position = Vector3(meshData.vertices[i].x, meshData.vertices[i].y, meshData.vertices[i].z);
-        vertices[i].texture = Vector2(meshData.vertices[i].tu, meshData.vertices[i].tv);
-        vertices[i].normal = Vector3(meshData.vertices[i].nx, meshData.vertices[i].ny, meshData.vertices[i].nz);
+        mLodStartIndices.push_back(totalIndexCount);
+        mLodIndexCounts.push_back(lod.indices.size());
+        mLodErrors.push_back(lod.error);
+
+        totalIndexCount += lod.indices.size();
     }
 
-    for (unsigned int i = 0; i < meshData.indices.size(); ++i)
+    // The hardware formats are built in this thread's scratch arena and released once the buffers are created.
+    ScratchScope scratch;
+
+	// Convert the software mesh into the hardware vertex format. Compact vertices are half the size of full ones,
+	// see VertexCompression.h for the layout.
+	//  - NOTE: Vertices need to be in clock wise order.
+    std::vector<compact_vertex_t> compactVertices;
+    const void * pVertexData = nullptr;
+
+    if (mVertexFormat == VertexFormat::Compact)
     {
-        indices[i] = static_cast<unsigned long>(meshData.indices[i]);
+        mPositionQuantization = VertexCompression::ComputePositionQuantization(meshData);
+        VertexCompression::CompressVertices(meshData, mPositionQuantization, &compactVertices);
+
+        mVertexStride = sizeof(compact_vertex_t);
+        pVertexData = &compactVertices[0];
     }
+    else
+    {
+        vertex_type_t * pVertices = scratch.AllocateArray<vertex_type_t>(meshData.vertices.size());
 
-    mVertexCount = meshData.vertices.size();
-    mIndexCount = meshData.indices.size();
+        for (unsigned int i = 0; i < meshData.vertices.size(); ++i)
+        {
+            pVertices[i].position = Vector3(meshData.vertices[i].x, meshData.vertices[i].y, meshData.vertices[i].z);
+            pVertices[i].texture = Vector2(meshData.vertices[i].tu, meshData.vertices[i].tv);
+            pVertices[i].normal = Vector3(meshData.vertices[i].nx, meshData.vertices[i].ny, meshData.vertices[i].nz);
+        }
+
+        mVertexStride = sizeof(vertex_type_t);
+        pVertexData = pVertices;
+    }
+
+    // Narrow the index buffer to 16 bits whenever every vertex can be addressed with it.
+    const void * pIndexData = nullptr;
+    unsigned int indexSize = 0;
+
+    mUse16BitIndices = VertexCompression::CanUse16BitIndices(mVertexCount);
+
+    if (mUse16BitIndices)
+    {
+        pIndexData = CopyLodIndices<unsigned short>(meshData, totalIndexCount, scratch);
+        indexSize = sizeof(unsigned short);
+    }
+    else
+    {
+        pIndexData = CopyLodIndices<unsigned long>(meshData, totalIndexCount, scratch);
+        indexSize = sizeof(unsigned long);
+    }
 
 	// Set up static vertex buffer description.
 	D3D11_BUFFER_DESC vertexBufferDesc;
 	ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
 
 	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(vertex_type_t)* mVertexCount;
+	vertexBufferDesc.ByteWidth = mVertexStride * mVertexCount;
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	vertexBufferDesc.CPUAccessFlags = 0;
 	vertexBufferDesc.MiscFlags = 0;
@@ -105,7 +201,7 @@ void Model::InitializeBuffers(
 	D3D11_SUBRESOURCE_DATA vertexData;
 	ZeroMemory(&vertexData, sizeof(vertexData));
 
-	vertexData.pSysMem = &vertices[0];
+	vertexData.pSysMem = pVertexData;
 	vertexData.SysMemPitch = 0;
 	vertexData.SysMemSlicePitch = 0;
 
@@ -119,7 +215,7 @@ void Model::InitializeBuffers(
 	ZeroMemory(&indexBufferDesc, sizeof(indexBufferDesc));
 
 	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(unsigned long)* mIndexCount;
+	indexBufferDesc.ByteWidth = indexSize * static_cast<unsigned int>(totalIndexCount);
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	indexBufferDesc.CPUAccessFlags = 0;
 	indexBufferDesc.MiscFlags = 0;
@@ -129,7 +225,7 @@ void Model::InitializeBuffers(
 	D3D11_SUBRESOURCE_DATA indexData;
 	ZeroMemory(&indexData, sizeof(indexData));
 
-	indexData.pSysMem = &indices[0];
+	indexData.pSysMem = pIndexData;
 	indexData.SysMemPitch = 0;
 	indexData.SysMemSlicePitch = 0;
 
@@ -138,99 +234,31 @@ void Model::InitializeBuffers(
 	VerifyDXResult(result);
 }
 
-// TODO: Vastly improve this code loading.
 void Model::LoadModel(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const
 {
-    AssertNotNull(pMeshDataOut);
-
-    if (Utils::EndsWith(filepath, L".txt"))
-    {
-        LoadTxtModelv1(filepath, pMeshDataOut);
-    }
-    else
+    // Binary meshes are streamed, only text models need the whole file at once.
+    if (Utils::EndsWith(filepath, L".mesh"))
     {
-        LoadTxtModelv2(filepath, pMeshDataOut);
+        MeshFile::Load(filepath, pMeshDataOut);
+        return;
     }
-}
-
-// TODO: Vastly improve this code loading.
-void Model::LoadTxtModelv1(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const
-{
-    AssertNotNull(pMeshDataOut);
-
-    // Load the text file containing mesh data.
-    std::ifstream meshStream(filepath.c_str());
-
-    if (meshStream.fail())
-    {
-        throw FileLoadException(filepath);
-    }
-
-    // Get the vertex count. (Index count is the same since one to one mapping).
-    unsigned int vertexCount;
-    meshStream >> vertexCount;
-
-    // Read the vertex buffer into memory.
-    pMeshDataOut->vertices.resize(vertexCount);
-    pMeshDataOut->indices.resize(vertexCount);
-
-    std::vector<s_mesh_vertex_t>& verts = pMeshDataOut->vertices;   // alias to reduce typing.
-    std::vector<int>& indices = pMeshDataOut->indices;              // alias to reduce typing.
 
-    for (unsigned int i = 0; i < vertexCount; ++i)
-    {
-        meshStream >> verts[i].x >> verts[i].y >> verts[i].z;
-        meshStream >> verts[i].tu >> verts[i].tv;
-        meshStream >> verts[i].nx >> verts[i].ny >> verts[i].nz;
-
-        indices[i] = i;
-    }
-
-    meshStream.close();
+    BinaryBlob file = BinaryBlob::LoadFromFile(filepath);
+    ParseModel(file.BufferPointer(), static_cast<size_t>(file.BufferSize()), filepath, pMeshDataOut);
 }
 
-// TODO: Vastly improve this code loading.
-void Model::LoadTxtModelv2(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const
+void Model::ParseModel(const char * pData, size_t size, const std::wstring& filepath, s_mesh_data_t *pMeshDataOut)
 {
     AssertNotNull(pMeshDataOut);
 
-    // Load the text file containing mesh data.
-    // Utils::ConvertUtf8ToWString(
-    std::ifstream meshStream(filepath.c_str());
-
-    if (meshStream.fail())
+    if (Utils::EndsWith(filepath, L".mesh"))
     {
-        throw FileLoadException(filepath);
+        MeshFile::Read(pData, size, filepath, pMeshDataOut);
     }
-    
-    // Get mesh header.
-    std::string fileType;
-    unsigned int vertexCount = 0u, indexCount = 0u;
-
-    meshStream >> fileType >> vertexCount >> indexCount;
-
-    // Read the vertex buffer into memory.
-    std::vector<s_mesh_vertex_t>& verts = pMeshDataOut->vertices;   // alias to reduce typing.
-    verts.resize(vertexCount);
-
-    for (unsigned int i = 0; i < vertexCount; ++i)      // TODO: for each
-    {
-        meshStream >> verts[i].x >> verts[i].y >> verts[i].z;
-        meshStream >> verts[i].tu >> verts[i].tv;
-        meshStream >> verts[i].nx >> verts[i].ny >> verts[i].nz;
-    }
-
-    // Read the index buffer into memory.
-    std::vector<int>& indices = pMeshDataOut->indices;              // alias to reduce typing.
-    indices.resize(indexCount);
-
-    for (unsigned int i = 0; i < indexCount; ++i)      // TODO: for each
+    else
     {
-        meshStream >> indices[i];
+        TextModelFile::Read(pData, size, filepath, pMeshDataOut);
     }
-
-    // All done.
-    meshStream.close();
 }
 
 void Model::OnShutdown()
@@ -240,25 +268,63 @@ void Model::OnShutdown()
 
 // TODO: This needs to be combined with the shader render logic.
 //  - Right now this method is better called "BindModelBuffersForRendering".
-void Model::BindModelBuffersForRendering(ID3D11DeviceContext *pDeviceContext)
+void Model::BindModelBuffersForRendering(ID3D11DeviceContext *pDeviceContext, RenderStats * pStats)
 {
     if (!IsInitialized()) { throw NotInitializedException(L"Model"); }
 	VerifyNotNull(pDeviceContext);
 
-    unsigned int stride = sizeof(vertex_type_t);
+    unsigned int stride = mVertexStride;
     unsigned int offset = 0;
 
     // Activate vertex and index buffers object for rendering.
     ID3D11Buffer* vertexBuffers[1] = { mVertexBuffer.Get() };
 
     pDeviceContext->IASetVertexBuffers(0, 1, vertexBuffers, &stride, &offset);
-    pDeviceContext->IASetIndexBuffer(mIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+    pDeviceContext->IASetIndexBuffer(
+        mIndexBuffer.Get(),
+        mUse16BitIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,
+        0);
 
     // Render the model using triangle primitives.
     pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    if (pStats != nullptr)
+    {
+        pStats->Add(RenderCounter::BufferBinds, 2);
+    }
+}
+
+void Model::SetTexture(const std::shared_ptr<Texture>& texture)
+{
+    mTexture = texture;
 }
 
 ID3D11ShaderResourceView * Model::GetTexture()
 {
 	return mTexture->GetTexture();
-}
\ No newline at end of file
+}
+
+Matrix Model::DequantizationMatrix() const
+{
+    if (mVertexFormat != VertexFormat::Compact)
+    {
+        return Matrix::Identity;
+    }
+
+    // Quantized positions are in [0, 1] along each axis, scale back up to the mesh bounds and move into place.
+    return Matrix::CreateScale(mPositionQuantization.scale) *
+           Matrix::CreateTranslation(
+               mPositionQuantization.offset[0],
+               mPositionQuantization.offset[1],
+               mPositionQuantization.offset[2]);
+}
+
+bounding_sphere_t Model::WorldBoundingSphere(const Matrix& worldMatrix) const
+{
+    return BoundingVolumes::TransformSphere(mBounds.sphere, &worldMatrix._11);
+}
+
+aabb_t Model::WorldBoundingBox(const Matrix& worldMatrix) const
+{
+    return BoundingVolumes::TransformAabb(mBounds.box, &worldMatrix._11);
+}
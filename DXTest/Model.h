@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include "IInitializable.h"
+#include "MeshData.h"
+#include "VertexCompression.h"
 
 #include <wrl\wrappers\corewrappers.h>      // ComPtr
 #include <wrl\client.h>
@@ -14,6 +16,7 @@ struct ID3D11DeviceContext;
 struct ID3D11Buffer;
 struct ID3D11ShaderResourceView;
 class Texture;
+class RenderStats;
 
 // TODO: TERRIBLE TERRIBLE
 // TODO: Remove loading of texture in this class, pass in Texture object.
@@ -28,12 +31,35 @@ public:
 
 	void Initialize(ID3D11Device* pDevice,
                     const std::wstring& modelFile,
-                    const std::wstring& textureFile);
-    void BindModelBuffersForRendering(ID3D11DeviceContext* pContext);
+                    const std::wstring& textureFile,
+                    VertexFormat vertexFormat = VertexFormat::Full);
+
+    // Create the model's buffers from already loaded mesh data. Must be called on the render thread. The texture
+    // is set separately with SetTexture().
+    void Initialize(ID3D11Device* pDevice,
+                    const s_mesh_data_t& meshData,
+                    VertexFormat vertexFormat = VertexFormat::Full);
+
+    // Parse a model file that is already in memory. Does not touch the device, so it is safe to call from asset
+    // loading threads. Binary .mesh files are told apart by their extension, anything else is a text model.
+    static void ParseModel(
+        const char * pData,
+        size_t size,
+        const std::wstring& filepath,
+        s_mesh_data_t *pMeshDataOut);
+
+    void BindModelBuffersForRendering(ID3D11DeviceContext* pContext, RenderStats * pStats = nullptr);
 
     const int IndexCount() const { return mIndexCount; }
     const int VertexCount() const { return mVertexCount; }
     ID3D11ShaderResourceView * GetTexture();
+    void SetTexture(const std::shared_ptr<Texture>& texture);
+
+    VertexFormat GetVertexFormat() const { return mVertexFormat; }
+
+    // Maps the model's vertex positions into model space. Identity for full vertices, undoes position quantization
+    // for compact vertices. Apply before the world matrix.
+    DirectX::SimpleMath::Matrix DequantizationMatrix() const;
 
     DirectX::SimpleMath::Vector3 Position() const { return mPosition; }
     void SetPosition(const DirectX::SimpleMath::Vector3& position) { mPosition = position; }
@@ -44,23 +70,21 @@ public:
     bool Enabled() const { return mEnabled; }
     void SetEnabled(bool isEnabled) { mEnabled = isEnabled; }
 
-    DirectX::SimpleMath::Vector3 BoundingSphereCenter() const { return mPosition; }
-    float BoundingSphereRadius() const { return mBoundingSphereRadius; }
+    // Model space bounds of the mesh, and the same bounds moved into world space by the model's world matrix (the
+    // matrix applied after DequantizationMatrix()).
+    const mesh_bounds_t& Bounds() const { return mBounds; }
+    bounding_sphere_t WorldBoundingSphere(const DirectX::SimpleMath::Matrix& worldMatrix) const;
+    aabb_t WorldBoundingBox(const DirectX::SimpleMath::Matrix& worldMatrix) const;
 
-private:
-    // in-memory software mesh format.
-    struct s_mesh_vertex_t
-    {
-        float x, y, z;
-        float tu, tv;
-        float nx, ny, nz;
-    };
-
-    struct s_mesh_data_t
-    {
-        std::vector<s_mesh_vertex_t> vertices;      // TODO: If changing these, need to update aliases in .cpp
-        std::vector<int> indices;
-    };
+    // Level of detail ranges in the index buffer. Level zero is the full detail mesh, coarser levels come from the
+    // mesh file's LOD chain. Errors are in model units and are zero for level zero.
+    unsigned int LodCount() const { return static_cast<unsigned int>(mLodIndexCounts.size()); }
+    unsigned int LodStartIndex(unsigned int level) const { return mLodStartIndices[level]; }
+    unsigned int LodIndexCount(unsigned int level) const { return mLodIndexCounts[level]; }
+    const std::vector<float>& LodErrors() const { return mLodErrors; }
+
+    unsigned int CurrentLod() const { return mCurrentLod; }
+    void SetCurrentLod(unsigned int level) { mCurrentLod = level; }
 
 protected:
     virtual void OnShutdown() override;
@@ -71,25 +95,28 @@ private:
     // Load model from a file on disk.
     void LoadModel(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const;
 
-    // Load model using v1 file format.
-    void LoadTxtModelv1(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const;
-
-    // Load model using v2 file format.
-    void LoadTxtModelv2(const std::wstring& filepath, s_mesh_data_t *pMeshDataOut) const;
-
 private:
     bool mEnabled;
 
     unsigned int mVertexCount;
     unsigned int mIndexCount;
+    VertexFormat mVertexFormat;
+    unsigned int mVertexStride;
+    bool mUse16BitIndices;
+    position_quantization_t mPositionQuantization;
 
 	Microsoft::WRL::ComPtr<ID3D11Buffer> mVertexBuffer;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> mIndexBuffer;
 
-	std::unique_ptr<Texture> mTexture;
+	std::shared_ptr<Texture> mTexture;      // Shared between every model using the same texture.
     
     DirectX::SimpleMath::Vector3 mPosition;
     DirectX::SimpleMath::Vector4 mColor;
-    float mBoundingSphereRadius;
+    mesh_bounds_t mBounds;
+
+    std::vector<unsigned int> mLodStartIndices;
+    std::vector<unsigned int> mLodIndexCounts;
+    std::vector<float> mLodErrors;
+    unsigned int mCurrentLod;
 };
 
@@ -0,0 +1,88 @@
+// Simple light shader for compact vertices (see VertexCompression.h).
+//  - Positions arrive as [0, 1] unorm values, the model's dequantization matrix is folded into worldMatrix.
+//  - Texture coordinates arrive as half floats and need no decoding.
+//  - Normals arrive as snorm octahedral coordinates and are decoded here.
+
+///////////////////////////////////////////////////////////////////////////////
+// Globals
+///////////////////////////////////////////////////////////////////////////////
+cbuffer MatrixBuffer
+{
+    matrix worldMatrix;
+    matrix viewMatrix;
+    matrix projectionMatrix;
+};
+
+cbuffer CameraBuffer
+{
+    float3 cameraPosition;
+    float padding;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Typedefs
+///////////////////////////////////////////////////////////////////////////////
+struct VIn
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+    float2 normal : NORMAL;
+};
+
+struct VOut
+{
+    float4 position : SV_POSITION;
+    float2 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+    float3 viewDirection : TEXCOORD1;
+    float3 worldPosition : TEXCOORD2;
+    float viewDepth : TEXCOORD3;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+float3 DecodeOctahedralNormal(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+
+    n.xy += (n.xy >= 0.0f) ? -t : t;
+    return normalize(n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Vertex shader.
+///////////////////////////////////////////////////////////////////////////////
+VOut main(VIn input)
+{
+    VOut output;
+
+    // Widen position vector to 4 units.
+    input.position.w = 1.0f;
+
+    // Calculate vertex position.
+    output.position = mul(input.position, worldMatrix);
+    output.position = mul(output.position, viewMatrix);
+    output.position = mul(output.position, projectionMatrix);
+
+    // Save the texture coordinate for pixel shader.
+    output.tex = input.tex;
+
+    // Transform normal vector (from model space?) to world space, and then renormalize
+    // the matrix.
+    output.normal = mul(DecodeOctahedralNormal(input.normal), (float3x3) worldMatrix);
+    output.normal = normalize(output.normal);
+
+    // Calculate the viewing angle, which is a vector from this vertex to the camera's
+    // position. This is done by obtaining the vertex's world position and subtracting
+    // it from the camera position.
+    float4 worldPosition = mul(input.position, worldMatrix);
+    output.viewDirection = normalize(cameraPosition.xyz - worldPosition.xyz);
+
+    // The pixel shader looks up its light cluster from the view depth and lights with the world position.
+    output.worldPosition = worldPosition.xyz;
+    output.viewDepth = mul(worldPosition, viewMatrix).z;
+
+    return output;
+}
\ No newline at end of file
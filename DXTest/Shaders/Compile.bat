@@ -7,6 +7,7 @@ fxc.exe /E main /T ps_5_0 /Fo SimpleTexturePixelShader.cso SimpleTexturePixelSha
 REM Light shader.
 fxc.exe /Od /Zi /E main /T vs_5_0 /Fo SimpleLightVertexShader.cso SimpleLightVertexShader.hlsl
 fxc.exe /Od /Zi /E main /T ps_5_0 /Fo SimpleLightPixelShader.cso SimpleLightPixelShader.hlsl
+fxc.exe /Od /Zi /E main /T vs_5_0 /Fo CompactLightVertexShader.cso CompactLightVertexShader.hlsl
 
 REM Font shader.
 fxc.exe /Od /Zi /E main /T vs_5_0 /Fo FontVertexShader.cso FontVertexShader.hlsl
@@ -3,10 +3,10 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Globals
 ///////////////////////////////////////////////////////////////////////////////
-Texture2D shaderTexture;
-SamplerState samplerType;
+Texture2D shaderTexture : register(t0);
+SamplerState samplerType : register(s0);
 
-cbuffer Lights     // TODO: Name this something better, Lights?
+cbuffer Lights : register(b0)     // TODO: Name this something better, Lights?
 {
     float4 ambientColor;
     float4 diffuseColor;
@@ -15,6 +15,31 @@ cbuffer Lights     // TODO: Name this something better, Lights?
     float4 specularColor;
 };
 
+// Point and spot lights sorted into view space clusters on the CPU, see LightClusters.h. Each cluster's list is an
+// (offset, count) run of lightIndices, and each index picks one of localLights.
+struct local_light_t
+{
+    float3 position;
+    float range;
+    float3 color;           // Premultiplied by intensity.
+    float spotCosAngle;     // Below -1 for point lights, so every direction is inside the cone.
+    float3 direction;
+    float padding;
+};
+
+StructuredBuffer<local_light_t> localLights : register(t1);
+Buffer<uint2> clusterLists : register(t2);
+Buffer<uint> lightIndices : register(t3);
+
+cbuffer Clusters : register(b1)
+{
+    uint3 clusterCounts;
+    float depthSliceScale;
+    float2 screenSize;
+    float depthSliceBias;
+    float clusterPadding;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Typedefs
 ///////////////////////////////////////////////////////////////////////////////
@@ -24,8 +49,42 @@ struct pixel_t
     float2 tex : TEXCOORD0;
     float3 normal : NORMAL;
     float3 viewDirection : TEXCOORD1;
+    float3 worldPosition : TEXCOORD2;
+    float viewDepth : TEXCOORD3;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+float3 LocalLighting(pixel_t input)
+{
+    // Screen tile from the pixel position, depth slice from the log of the view depth.
+    uint2 tile = min(uint2(input.position.xy / screenSize * clusterCounts.xy), clusterCounts.xy - 1);
+    float slice = floor(log(max(input.viewDepth, 1e-4f)) * depthSliceScale - depthSliceBias);
+    uint z = (uint) clamp(slice, 0.0f, (float) clusterCounts.z - 1.0f);
+
+    uint2 list = clusterLists[(z * clusterCounts.y + tile.y) * clusterCounts.x + tile.x];
+    float3 color = float3(0.0f, 0.0f, 0.0f);
+
+    for (uint i = 0; i < list.y; ++i)
+    {
+        local_light_t light = localLights[lightIndices[list.x + i]];
+
+        float3 toLight = light.position - input.worldPosition;
+        float distance = length(toLight);
+        float3 direction = toLight / max(distance, 1e-4f);
+
+        // Smooth falloff to zero at the light's range, and a soft edge just inside the spot cone.
+        float falloff = saturate(1.0f - distance / light.range);
+        float cone = smoothstep(light.spotCosAngle, min(light.spotCosAngle + 0.05f, 1.0f),
+                                dot(-direction, light.direction));
+
+        color += light.color * saturate(dot(input.normal, direction)) * falloff * falloff * cone;
+    }
+
+    return color;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Vertex shader
 ///////////////////////////////////////////////////////////////////////////////
@@ -48,7 +107,7 @@ float4 main(pixel_t input) : SV_TARGET
     // of diffuse color.
     //  TODO: We don't need this branch. Just sanity check lightIntensity when it
     //        gets passed in.
-    float4 specular;
+    float4 specular = float4(0.0f, 0.0f, 0.0f, 0.0f);
     float lightIntensity = saturate(dot(input.normal, -lightDirection));
 
     if (lightIntensity > 0.0f)
@@ -65,6 +124,9 @@ float4 main(pixel_t input) : SV_TARGET
         specular = pow(saturate(dot(reflection, input.viewDirection)), specularPower);
     }
 
+    // Add the point and spot lights reaching this pixel.
+    color.rgb += LocalLighting(input);
+
     // Multiple texture pixel color and final diffuse color to get final pixel color.
     color = color * textureColor;
     color = saturate(color + specular);
@@ -32,6 +32,8 @@ struct VOut
     float2 tex : TEXCOORD0;
     float3 normal : NORMAL;
     float3 viewDirection : TEXCOORD1;
+    float3 worldPosition : TEXCOORD2;
+    float viewDepth : TEXCOORD3;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -63,5 +65,9 @@ VOut main(VIn input)
     float4 worldPosition = mul(input.position, worldMatrix);
     output.viewDirection = normalize(cameraPosition.xyz - worldPosition.xyz);
 
+    // The pixel shader looks up its light cluster from the view depth and lights with the world position.
+    output.worldPosition = worldPosition.xyz;
+    output.viewDepth = mul(worldPosition, viewMatrix).z;
+
     return output;
 }
\ No newline at end of file
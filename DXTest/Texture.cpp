@@ -2,8 +2,10 @@
 #include "BinaryBlob.h"
 #include "DXSandbox.h"
 #include "DXTestException.h"
+#include "DdsFile.h"
 
 #include <d3d11.h>
+#include <vector>
 #include "DDSTextureLoader.h"
 
 using namespace DirectX;
@@ -27,20 +29,22 @@ void Texture::InitializeFromFile(ID3D11Device *pDevice, const std::wstring& file
     Microsoft::WRL::ComPtr<ID3D11Resource> textureResource;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
 
-    HRESULT hr = CreateDDSTextureFromFile(pDevice, filepath.c_str(), &textureResource, &shaderResourceView);
+    // Read through BinaryBlob so textures can come from a mounted pack file.
+    BinaryBlob file = BinaryBlob::LoadFromFile(filepath);
+
+    HRESULT hr = CreateDDSTextureFromMemory(
+        pDevice,
+        reinterpret_cast<const uint8_t *>(file.BufferPointer()),
+        static_cast<size_t>(file.BufferSize()),
+        &textureResource,
+        &shaderResourceView);
 
     if (SUCCEEDED(hr))
     {
-        mName = filepath;
         mResource.Swap(textureResource);
         mTexture.Swap(shaderResourceView);
 
-        // Set an identifier on this texture file for easier debug tracking.
-        //  TODO: Confirm this works.
-        mTexture->SetPrivateData(WKPDID_D3DDebugObjectName,
-                                 sizeof(std::wstring::value_type) * mName.size(),
-                                 mName.c_str());
-
+        SetDebugName(filepath);
         SetInitialized();
     }
     else
@@ -49,6 +53,102 @@ void Texture::InitializeFromFile(ID3D11Device *pDevice, const std::wstring& file
     }
 }
 
+void Texture::InitializeFromDds(
+    ID3D11Device *pDevice,
+    const dds_image_t& image,
+    const char * pFileData,
+    const std::wstring& name)
+{
+    if (IsInitialized()) { return; }
+	VerifyNotNull(pDevice);
+    Verify(pFileData != nullptr);
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    ZeroMemory(&textureDesc, sizeof(textureDesc));
+
+    textureDesc.Width = image.width;
+    textureDesc.Height = image.height;
+    textureDesc.MipLevels = image.mipCount;
+    textureDesc.ArraySize = image.arraySize;
+    textureDesc.Format = static_cast<DXGI_FORMAT>(image.format);
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.MiscFlags = image.isCubeMap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+    // Point every subresource straight at its pixels in the file, no copies are needed.
+    std::vector<D3D11_SUBRESOURCE_DATA> initialData(image.subresources.size());
+
+    for (size_t i = 0; i < image.subresources.size(); ++i)
+    {
+        initialData[i].pSysMem = pFileData + image.subresources[i].offset;
+        initialData[i].SysMemPitch = image.subresources[i].rowPitch;
+        initialData[i].SysMemSlicePitch = image.subresources[i].slicePitch;
+    }
+
+    Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+    HRESULT hr = pDevice->CreateTexture2D(&textureDesc, &initialData[0], &texture);
+
+    if (FAILED(hr))
+    {
+        throw DirectXException(hr, name);
+    }
+
+    // View the whole texture.
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+    ZeroMemory(&viewDesc, sizeof(viewDesc));
+
+    viewDesc.Format = textureDesc.Format;
+
+    if (image.isCubeMap && image.arraySize > 6)
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+        viewDesc.TextureCubeArray.MipLevels = image.mipCount;
+        viewDesc.TextureCubeArray.NumCubes = image.arraySize / 6;
+    }
+    else if (image.isCubeMap)
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+        viewDesc.TextureCube.MipLevels = image.mipCount;
+    }
+    else if (image.arraySize > 1)
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        viewDesc.Texture2DArray.MipLevels = image.mipCount;
+        viewDesc.Texture2DArray.ArraySize = image.arraySize;
+    }
+    else
+    {
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        viewDesc.Texture2D.MipLevels = image.mipCount;
+    }
+
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> shaderResourceView;
+    hr = pDevice->CreateShaderResourceView(texture.Get(), &viewDesc, &shaderResourceView);
+
+    if (FAILED(hr))
+    {
+        throw DirectXException(hr, name);
+    }
+
+    mResource = texture;
+    mTexture.Swap(shaderResourceView);
+
+    SetDebugName(name);
+    SetInitialized();
+}
+
+void Texture::SetDebugName(const std::wstring& name)
+{
+    mName = name;
+
+    // Set an identifier on this texture file for easier debug tracking.
+    //  TODO: Confirm this works.
+    mTexture->SetPrivateData(WKPDID_D3DDebugObjectName,
+                             sizeof(std::wstring::value_type) * mName.size(),
+                             mName.c_str());
+}
+
 void Texture::OnShutdown()
 {
 }
@@ -11,6 +11,7 @@ struct ID3D11Device;
 struct ID3D11Resource;
 struct ID3D11ShaderResourceView;
 class BinaryBlob;
+struct dds_image_t;
 
 class Texture : public IInitializable
 {
@@ -22,14 +23,22 @@ public:
     Texture& operator =(const Texture& rhs) = delete;
 
 	// texture must be dds
-	// TODO: convert to use BinaryBlob* rather than manually loading
     void InitializeFromFile(ID3D11Device *pDevice, const std::wstring& filepath);
 
+    // Create the texture from a DDS file that was already read and parsed, see DdsFile.h. pFileData points at the
+    // start of the file the image was parsed from. Only the device upload happens here.
+    void InitializeFromDds(
+        ID3D11Device *pDevice,
+        const dds_image_t& image,
+        const char * pFileData,
+        const std::wstring& name);
+
 	// TODO: bad name
 	ID3D11ShaderResourceView * GetTexture();
 
 private:
 	virtual void OnShutdown() override;
+    void SetDebugName(const std::wstring& name);
 
 private:
     std::wstring mName;
@@ -0,0 +1,23 @@
+#include "MemoryTracker.h"
+
+#include <new>
+
+// Route every heap allocation in the program through MemoryTracker so it can be charged to a subsystem. The array
+// and nothrow forms call these, so replacing the two plain forms covers every allocation. Counting only happens once
+// Application turns tracking on.
+void * operator new(size_t size)
+{
+    void * pMemory = MemoryTracker::Allocate(size > 0 ? size : 1);
+
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pMemory;
+}
+
+void operator delete(void * pMemory)
+{
+    MemoryTracker::Free(pMemory);
+}
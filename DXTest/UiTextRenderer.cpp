@@ -0,0 +1,123 @@
+#include "UiTextRenderer.h"
+#include "DXSandbox.h"
+#include "Dx3d.h"
+#include "Font.h"
+#include "FontShader.h"
+#include "DrawableText.h"
+#include "Camera.h"
+#include "MemoryTracker.h"
+#include "size.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int SentenceMaxLength = 16;
+
+    // Overlay lines start in the top left corner and go down the screen. The font is 16 pixels tall.
+    const int OverlayMaxLength = 64;
+    const int OverlayLeft = 10;
+    const int OverlayTop = 10;
+    const int OverlayLineHeight = 18;
+}
+
+UiTextRenderer::UiTextRenderer()
+    : mFont(),
+      mFontShader(),
+      mSentence1(),
+      mSentence2(),
+      mOverlayLines(),
+      mOverlayLineCount(0),
+      mScreenWidth(0),
+      mScreenHeight(0)
+{
+}
+
+UiTextRenderer::~UiTextRenderer()
+{
+}
+
+void UiTextRenderer::Initialize(Dx3d& dx, const Size& screenSize)
+{
+    if (IsInitialized()) { return; }
+    MemoryTagScope tag(MemoryTag::UI);
+
+    mScreenWidth = screenSize.width;
+    mScreenHeight = screenSize.height;
+
+    // Load the font and the shader that draws it.
+    mFont.reset(new Font());
+    mFont->Initialize(dx.GetDevice(), L".\\Fonts\\rastertek.txt", L".\\Fonts\\rastertek.dds");
+
+    mFontShader.reset(new FontShader());
+    mFontShader->Initialize(dx);
+
+    // Create the two sample sentences.
+    mSentence1.reset(new DrawableText());
+    mSentence1->Initialize(dx, SentenceMaxLength);
+    mSentence1->Update(dx, *mFont, "Hello", screenSize, 100, 100, 1.0f, 1.0f, 1.0f);
+
+    mSentence2.reset(new DrawableText());
+    mSentence2->Initialize(dx, SentenceMaxLength);
+    mSentence2->Update(dx, *mFont, "Goodbye", screenSize, 100, 200, 1.0f, 1.0f, 0.0f);
+
+    SetInitialized();
+}
+
+void UiTextRenderer::OnShutdown()
+{
+    mOverlayLines.clear();
+    mOverlayLineCount = 0;
+
+    mSentence2.reset();
+    mSentence1.reset();
+    mFontShader.reset();
+    mFont.reset();
+}
+
+void UiTextRenderer::SetOverlayText(Dx3d& dx, const std::vector<std::string>& lines)
+{
+    if (!IsInitialized()) { return; }
+    MemoryTagScope tag(MemoryTag::UI);
+
+    const Size screenSize(mScreenWidth, mScreenHeight);
+
+    // Lines are kept once created, so an overlay that keeps the same number of lines only maps buffers.
+    while (mOverlayLines.size() < lines.size())
+    {
+        std::unique_ptr<DrawableText> line(new DrawableText());
+        line->Initialize(dx, OverlayMaxLength);
+
+        mOverlayLines.push_back(std::move(line));
+    }
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        const int y = OverlayTop + static_cast<int>(i) * OverlayLineHeight;
+
+        mOverlayLines[i]->Update(
+            dx,
+            *mFont,
+            lines[i].substr(0, OverlayMaxLength - 1),
+            screenSize,
+            OverlayLeft,
+            y,
+            0.6f, 1.0f, 0.6f);
+    }
+
+    mOverlayLineCount = lines.size();
+}
+
+void UiTextRenderer::Render(Dx3d& dx, const Camera& camera, const DirectX::SimpleMath::Matrix& worldMatrix)
+{
+    if (!IsInitialized()) { return; }
+
+    mSentence1->Render(dx, *mFont, *mFontShader, camera, worldMatrix);
+    mSentence2->Render(dx, *mFont, *mFontShader, camera, worldMatrix);
+
+    for (size_t i = 0; i < mOverlayLineCount; ++i)
+    {
+        mOverlayLines[i]->Render(dx, *mFont, *mFontShader, camera, worldMatrix);
+    }
+}
@@ -4,6 +4,7 @@
 #include "SimpleMath.h"
 #include "Size.h"
 #include <string>
+#include <vector>
 #include <memory>
 
 class Font;
@@ -32,6 +33,10 @@ public:
                 const Camera& camera,
                 const DirectX::SimpleMath::Matrix& worldMatrix);    // TODO: Const
 
+    // Lines drawn down the top left corner of the screen, such as RenderStats::OverlayLines(). Each call rewrites
+    // every line's vertex buffer, so callers should not update it every frame. Long lines are cut short.
+    void SetOverlayText(Dx3d& dx, const std::vector<std::string>& lines);
+
 private:
     virtual void OnShutdown() override;
 
@@ -41,4 +46,9 @@ private:
 
     std::unique_ptr<DrawableText> mSentence1;
     std::unique_ptr<DrawableText> mSentence2;
+
+    std::vector<std::unique_ptr<DrawableText>> mOverlayLines;
+    size_t mOverlayLineCount;
+    unsigned int mScreenWidth;
+    unsigned int mScreenHeight;
 };
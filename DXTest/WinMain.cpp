@@ -1,11 +1,18 @@
 #define WIN32_LEAN_AND_MEAN
 #include "Application.h"
 #include "DXTestException.h"
+#include "TextFormat.h"
+#include "FrameReplay.h"
 #include <Windows.h>
-#include <sstream>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>      // for time
 
+// "DXTest.exe -headless [frames]" replays the scripted benchmark scene without a window, see FrameReplay.h.
+static const char HeadlessSwitch[] = "-headless";
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline, int iCmdshow)
 {
 	Application app;
@@ -14,25 +21,43 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 	
 	try
 	{
-		app.Initialize();
-		app.Run();
-		app.Shutdown();
+        const char * pHeadless = (pScmdline != nullptr) ? strstr(pScmdline, HeadlessSwitch) : nullptr;
+
+        if (pHeadless != nullptr)
+        {
+            frame_replay_settings_t settings = FrameReplay::DefaultSettings();
+            const int frameCount = atoi(pHeadless + strlen(HeadlessSwitch));
+
+            if (frameCount > 0)
+            {
+                settings.frameCount = static_cast<unsigned int>(frameCount);
+                settings.warmupFrames = std::min(settings.warmupFrames, settings.frameCount / 10);
+            }
+
+            app.RunHeadless(settings);
+        }
+        else
+        {
+            app.Initialize();
+            app.Run();
+            app.Shutdown();
+        }
 	}
 	catch (SandboxException& exception)
 	{
         // Format the message that we want to display to the user.
-        std::wostringstream ss;
+        WideFormatBuffer message;
 
-        ss 
-            << L"MESSAGE: " << exception.Message() << std::endl
-            << L"CONTEXT: " << exception.ActionContext() << std::endl
-            << L"FILE: " << exception.FileName() << std::endl
+        message
+            << L"MESSAGE: " << exception.Message() << L'\n'
+            << L"CONTEXT: " << exception.ActionContext() << L'\n'
+            << L"FILE: " << exception.FileName() << L'\n'
             << L"LINE: " << exception.LineNumber();
 
         // Show the error message.
 		MessageBoxW(
             NULL,
-            ss.str().c_str(),
+            message.CString(),
             L"Fatal Exception",
             MB_OK | MB_ICONSTOP | MB_SYSTEMMODAL | MB_SETFOREGROUND);
 	}
@@ -0,0 +1,163 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "FrameArena.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
+
+#include <cstring>
+#include <list>
+#include <vector>
+
+namespace
+{
+    // Same layout as DrawableText's vertices, sized for the two debug text lines the demo updates every frame.
+    struct text_vertex_t
+    {
+        float position[3];
+        float texture[2];
+    };
+
+    struct draw_entry_t
+    {
+        void * pModel;
+        unsigned int lod;
+        float worldMatrix[16];
+    };
+
+    const size_t FrameCount = 1000;
+    const unsigned int FrameRuns = 20;
+    const size_t TextUpdatesPerFrame = 2;
+    const size_t TextVertexCount = 6 * 32;
+    const size_t VisibleModelCount = 200;
+    const size_t PooledNodeCount = 256;
+
+    void FillText(text_vertex_t * pVertices, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            pVertices[i].position[0] = static_cast<float>(i);
+            pVertices[i].texture[0] = 0.5f;
+        }
+    }
+
+    // Returns how many times the list had to grow.
+    template<typename Allocator>
+    unsigned int FillDraws(std::vector<draw_entry_t, Allocator> * pDraws, size_t frame)
+    {
+        unsigned int growCount = 0;
+
+        for (size_t i = 0; i < VisibleModelCount; ++i)
+        {
+            const size_t capacity = pDraws->capacity();
+            draw_entry_t draw = { nullptr, static_cast<unsigned int>((i + frame) % 4), { 1.0f } };
+
+            pDraws->push_back(draw);
+            growCount += (pDraws->capacity() != capacity) ? 1 : 0;
+        }
+
+        return growCount;
+    }
+}
+
+// Per frame temporaries of the render path: text vertex updates and the list of visible models. The heap version
+// is what DrawableText::Update and an unreserved draw list did before the frame and scratch arenas.
+BENCHMARK(FrameAllocators)
+{
+    unsigned long long heapFrameAllocations = 0;
+
+    reporter.Time("heap temporaries", FrameRuns, static_cast<double>(FrameCount), "frames", [&]() {
+        heapFrameAllocations = 0;
+
+        for (size_t frame = 0; frame < FrameCount; ++frame)
+        {
+            for (size_t text = 0; text < TextUpdatesPerFrame; ++text)
+            {
+                text_vertex_t * pVertices = new text_vertex_t[TextVertexCount];
+                std::memset(pVertices, 0, sizeof(text_vertex_t) * TextVertexCount);
+                FillText(pVertices, TextVertexCount);
+                Benchmark::DoNotOptimize(pVertices);
+                delete[] pVertices;
+
+                heapFrameAllocations++;
+            }
+
+            std::vector<draw_entry_t> draws;
+            heapFrameAllocations += FillDraws(&draws, frame);
+            Benchmark::DoNotOptimize(draws.data());
+        }
+    });
+
+    FrameArena frameArena(64 * 1024);
+    const unsigned long long arenaBlocksBefore =
+        frameArena.HeapAllocationCount() + ScratchArena::HeapAllocationCount();
+
+    reporter.Time("frame and scratch arenas", FrameRuns, static_cast<double>(FrameCount), "frames", [&]() {
+        for (size_t frame = 0; frame < FrameCount; ++frame)
+        {
+            for (size_t text = 0; text < TextUpdatesPerFrame; ++text)
+            {
+                ScratchScope scratch;
+                text_vertex_t * pVertices = scratch.AllocateArray<text_vertex_t>(TextVertexCount);
+                std::memset(pVertices, 0, sizeof(text_vertex_t) * TextVertexCount);
+                FillText(pVertices, TextVertexCount);
+                Benchmark::DoNotOptimize(pVertices);
+            }
+
+            {
+                std::vector<draw_entry_t, ArenaAllocator<draw_entry_t>> draws(
+                    (ArenaAllocator<draw_entry_t>(frameArena)));
+                FillDraws(&draws, frame);
+                Benchmark::DoNotOptimize(draws.data());
+            }
+
+            frameArena.Reset();
+        }
+    });
+
+    const unsigned long long arenaBlocks =
+        frameArena.HeapAllocationCount() + ScratchArena::HeapAllocationCount() - arenaBlocksBefore;
+
+    reporter.Report("heap allocations/frame, heap", static_cast<double>(heapFrameAllocations) / FrameCount, "allocs");
+    // Time() runs the work once more to warm up.
+    const double arenaFrames = static_cast<double>((FrameRuns + 1) * FrameCount);
+    reporter.Report("heap allocations/frame, arenas", static_cast<double>(arenaBlocks) / arenaFrames, "allocs");
+    reporter.Report("frame arena high water mark", static_cast<double>(frameArena.HighWaterMark()), "bytes");
+    reporter.Report("scratch arena high water mark", static_cast<double>(ScratchArena::HighWaterMark()), "bytes");
+}
+
+// Short lived list nodes from the global heap against a FixedPool that stays at its working size.
+BENCHMARK(PooledNodes)
+{
+    reporter.Time("std::list, heap nodes", 50, static_cast<double>(PooledNodeCount * 100), "nodes", [&]() {
+        for (int round = 0; round < 100; ++round)
+        {
+            std::list<int> values;
+
+            for (size_t i = 0; i < PooledNodeCount; ++i)
+            {
+                values.push_back(static_cast<int>(i));
+            }
+
+            Benchmark::DoNotOptimize(&values.back());
+        }
+    });
+
+    FixedPool nodes(32);
+
+    reporter.Time("std::list, pooled nodes", 50, static_cast<double>(PooledNodeCount * 100), "nodes", [&]() {
+        for (int round = 0; round < 100; ++round)
+        {
+            std::list<int, PoolAllocator<int>> values((PoolAllocator<int>(nodes)));
+
+            for (size_t i = 0; i < PooledNodeCount; ++i)
+            {
+                values.push_back(static_cast<int>(i));
+            }
+
+            Benchmark::DoNotOptimize(&values.back());
+        }
+    });
+
+    reporter.Report("pool pages allocated", static_cast<double>(nodes.HeapAllocationCount()), "pages");
+    reporter.Report("pool high water mark", static_cast<double>(nodes.HighWaterMark()), "blocks");
+}
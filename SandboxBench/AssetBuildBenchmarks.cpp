@@ -0,0 +1,184 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "AssetBuildCache.h"
+#include "BinaryBlob.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+#include "TextModelFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const unsigned int TextModelCount = 48;
+    const unsigned int OtherFileCount = 80;
+    const size_t OtherFileSize = 256 * 1024;
+    const unsigned int ChangedPercent = 5;
+    const wchar_t * CacheDirectory = L"AssetBuildBenchmark_cache";
+
+    // Source files and the steps that build them, removed again when the benchmark finishes.
+    struct build_corpus_t
+    {
+        std::vector<asset_build_step_t> steps;
+        std::vector<std::wstring> files;
+        double sourceBytes;
+
+        build_corpus_t() : steps(), files(), sourceBytes(0.0) { }
+
+        ~build_corpus_t()
+        {
+            AssetBuildCache(CacheDirectory).Clear();
+
+            for (const std::wstring& filepath : files)
+            {
+                std::remove(std::string(filepath.begin(), filepath.end()).c_str());
+            }
+        }
+    };
+
+    void WriteFile(const std::wstring& filepath, const std::vector<char>& contents)
+    {
+        std::ofstream stream(std::string(filepath.begin(), filepath.end()).c_str(), std::ios::binary);
+        stream.write(&contents[0], static_cast<std::streamsize>(contents.size()));
+    }
+
+    // Text model to .mesh, the same conversion as AssetBuilder's build command.
+    void ConvertMesh(const std::vector<BinaryBlob>& inputs, std::vector<char> *pOutput)
+    {
+        s_mesh_data_t mesh;
+        TextModelFile::Read(
+            inputs[0].BufferPointer(),
+            static_cast<size_t>(inputs[0].BufferSize()),
+            L"benchmark model",
+            &mesh);
+
+        MeshletBuilder::Build(mesh, &mesh.meshlets);
+        MeshFile::Write(mesh, pOutput);
+    }
+
+    void Copy(const std::vector<BinaryBlob>& inputs, std::vector<char> *pOutput)
+    {
+        pOutput->assign(inputs[0].BufferPointer(), inputs[0].BufferPointer() + inputs[0].BufferSize());
+    }
+
+    asset_build_step_t AddStep(
+        build_corpus_t *pCorpus,
+        const std::wstring& input,
+        const std::wstring& output,
+        const std::vector<char>& contents,
+        const char * pTool)
+    {
+        WriteFile(input, contents);
+        pCorpus->files.push_back(input);
+        pCorpus->files.push_back(output);
+        pCorpus->sourceBytes += static_cast<double>(contents.size());
+
+        asset_build_step_t step;
+        step.output = output;
+        step.inputs.push_back(input);
+        step.tool = pTool;
+        step.toolVersion = 1;
+
+        return step;
+    }
+
+    // Models and opaque data files (textures, sounds, fonts) in roughly a level's proportions.
+    void BuildCorpus(build_corpus_t *pCorpus)
+    {
+        for (unsigned int i = 0; i < TextModelCount; ++i)
+        {
+            s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(24 + i % 4 * 8, 40 + static_cast<int>(i));
+            std::vector<char> text = BenchmarkMeshes::MakeTextModel(mesh);
+            std::wstring name = L"AssetBuildBenchmark_model" + std::to_wstring(i);
+
+            asset_build_step_t step = AddStep(pCorpus, name + L".model", name + L".mesh", text, "mesh");
+            step.convert = ConvertMesh;
+
+            pCorpus->steps.push_back(step);
+        }
+
+        for (unsigned int i = 0; i < OtherFileCount; ++i)
+        {
+            std::vector<char> data(OtherFileSize);
+            unsigned int state = i * 7919 + 1;
+
+            for (char& c : data)
+            {
+                state = state * 1664525u + 1013904223u;
+                c = static_cast<char>(state >> 24);
+            }
+
+            std::wstring name = L"AssetBuildBenchmark_data" + std::to_wstring(i);
+
+            asset_build_step_t step = AddStep(pCorpus, name + L".dds", name + L".out", data, "copy");
+            step.convert = Copy;
+
+            pCorpus->steps.push_back(step);
+        }
+    }
+
+    void ReportBuild(BenchmarkReporter& reporter, const std::string& label, const asset_build_stats_t& stats)
+    {
+        reporter.Report((label + " seconds").c_str(), stats.seconds, "s");
+        reporter.Report((label + " hit rate").c_str(), stats.HitRate() * 100.0, "%");
+        reporter.Report((label + " converted").c_str(), static_cast<double>(stats.builtCount), "steps");
+    }
+}
+
+// A clean build runs every converter. The no-op rebuild is the common case after a tool change that did not touch
+// most assets: every input is still read and hashed, nothing is converted or written.
+BENCHMARK(IncrementalAssetBuild)
+{
+    build_corpus_t corpus;
+    BuildCorpus(&corpus);
+
+    AssetBuildCache::CreateDirectories(CacheDirectory);
+    AssetBuildCache(CacheDirectory).Clear();
+
+    reporter.Report("steps", static_cast<double>(corpus.steps.size()), "steps");
+    reporter.Report("source bytes", corpus.sourceBytes / 1.0e6, "MB");
+
+    AssetBuildCache cache(CacheDirectory);
+    ReportBuild(reporter, "clean build", cache.Build(corpus.steps));
+
+    // A fresh cache object reloads the manifest the way a new AssetBuilder run would.
+    ReportBuild(reporter, "no-op rebuild", AssetBuildCache(CacheDirectory).Build(corpus.steps));
+
+    reporter.Time("no-op rebuild", 5, corpus.sourceBytes, "B", [&]() {
+        AssetBuildCache(CacheDirectory).Build(corpus.steps);
+    });
+
+    // Edit a few models spread through the corpus.
+    const size_t changedCount = corpus.steps.size() * ChangedPercent / 100;
+
+    for (size_t i = 0; i < changedCount; ++i)
+    {
+        const asset_build_step_t& step = corpus.steps[i * 7 % TextModelCount];
+        s_mesh_data_t edited = BenchmarkMeshes::MakeSphere(20, 40 + static_cast<int>(i));
+
+        WriteFile(step.inputs[0], BenchmarkMeshes::MakeTextModel(edited));
+    }
+
+    ReportBuild(reporter, "5% changed", cache.Build(corpus.steps));
+
+    // Deleted outputs come back from the cache without converting.
+    for (const asset_build_step_t& step : corpus.steps)
+    {
+        std::remove(std::string(step.output.begin(), step.output.end()).c_str());
+    }
+
+    ReportBuild(reporter, "outputs deleted", cache.Build(corpus.steps));
+
+    // A new mesh converter version rebuilds every model and nothing else.
+    for (asset_build_step_t& step : corpus.steps)
+    {
+        step.toolVersion += step.tool == "mesh" ? 1 : 0;
+    }
+
+    ReportBuild(reporter, "mesh tool bumped", cache.Build(corpus.steps));
+}
@@ -0,0 +1,276 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "AssetLoader.h"
+#include "BinaryBlob.h"
+#include "DdsFile.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+#include "VertexCompression.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const unsigned int MeshFileCount = 48;
+    const unsigned int TextureFileCount = 8;
+    const unsigned int TextureSize = 1024;
+    const double FrameSeconds = 1.0 / 60.0;
+    const double UploadBudgetSeconds = 0.002;
+
+    // Stand in for a device upload: the CPU side work a model upload does before creating buffers.
+    struct uploaded_mesh_t
+    {
+        std::vector<compact_vertex_t> vertices;
+        std::vector<int> indices;
+    };
+
+    // Stand in for a texture upload: the driver copies every subresource out of the file.
+    struct uploaded_texture_t
+    {
+        std::vector<char> pixels;
+    };
+
+    struct decoded_texture_t
+    {
+        AssetLoader::file_t file;
+        dds_image_t image;
+    };
+
+    struct asset_files_t
+    {
+        std::vector<std::wstring> meshes;
+        std::vector<std::wstring> textures;
+        unsigned long long totalBytes;
+
+        asset_files_t() : meshes(), textures(), totalBytes(0) { }
+
+        ~asset_files_t()
+        {
+            for (const std::wstring& filepath : meshes) { Remove(filepath); }
+            for (const std::wstring& filepath : textures) { Remove(filepath); }
+        }
+
+        static void Remove(const std::wstring& filepath)
+        {
+            std::remove(std::string(filepath.begin(), filepath.end()).c_str());
+        }
+    };
+
+    void WriteFile(const std::wstring& filepath, const std::vector<char>& contents)
+    {
+        std::ofstream stream(std::string(filepath.begin(), filepath.end()).c_str(), std::ios::binary);
+        stream.write(&contents[0], static_cast<std::streamsize>(contents.size()));
+    }
+
+    // Legacy header DXT1 (BC1) texture with a full mip chain, the most common texture on disk.
+    std::vector<char> MakeBc1Dds(unsigned int size, unsigned int seed)
+    {
+        unsigned int mipCount = 1;
+        size_t pixelBytes = 0;
+
+        for (unsigned int level = size; level > 1; level /= 2) { mipCount++; }
+        for (unsigned int level = size; level > 0; level /= 2)
+        {
+            pixelBytes += ((level + 3) / 4) * ((level + 3) / 4) * 8;
+        }
+
+        unsigned int header[32] = { 0 };
+        std::memcpy(&header[0], "DDS ", 4);
+        header[1] = 124;                        // Header size.
+        header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000;
+        header[3] = size;
+        header[4] = size;
+        header[7] = mipCount;
+        header[19] = 32;                        // Pixel format size.
+        header[20] = 0x4;                       // Four CC.
+        std::memcpy(&header[21], "DXT1", 4);
+        header[27] = 0x1000 | 0x400000 | 0x8;   // Texture, mip map, complex.
+
+        std::vector<char> file(sizeof(header) + pixelBytes);
+        std::memcpy(&file[0], header, sizeof(header));
+
+        for (size_t i = sizeof(header); i < file.size(); ++i)
+        {
+            file[i] = static_cast<char>((i * 2654435761u + seed) >> 13);
+        }
+
+        return file;
+    }
+
+    void WriteAssetFiles(asset_files_t *pFiles)
+    {
+        for (unsigned int i = 0; i < MeshFileCount; ++i)
+        {
+            s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(48 + i % 4 * 8, 96 + i % 4 * 16);
+            MeshletBuilder::Build(mesh, &mesh.meshlets);
+
+            std::vector<char> contents;
+            MeshFile::Write(mesh, &contents);
+
+            pFiles->meshes.push_back(L"AssetLoadingBenchmark_" + std::to_wstring(i) + L".mesh");
+            pFiles->totalBytes += contents.size();
+            WriteFile(pFiles->meshes.back(), contents);
+        }
+
+        for (unsigned int i = 0; i < TextureFileCount; ++i)
+        {
+            std::vector<char> contents = MakeBc1Dds(TextureSize, i);
+
+            pFiles->textures.push_back(L"AssetLoadingBenchmark_" + std::to_wstring(i) + L".dds");
+            pFiles->totalBytes += contents.size();
+            WriteFile(pFiles->textures.back(), contents);
+        }
+    }
+
+    std::unique_ptr<s_mesh_data_t> DecodeMesh(const AssetLoader::file_t& file, const std::wstring& filepath)
+    {
+        std::unique_ptr<s_mesh_data_t> mesh(new s_mesh_data_t());
+        MeshFile::Read(file->BufferPointer(), static_cast<size_t>(file->BufferSize()), filepath, mesh.get());
+
+        return mesh;
+    }
+
+    std::shared_ptr<uploaded_mesh_t> UploadMesh(s_mesh_data_t& mesh)
+    {
+        std::shared_ptr<uploaded_mesh_t> uploaded(new uploaded_mesh_t());
+
+        VertexCompression::CompressVertices(
+            mesh,
+            VertexCompression::ComputePositionQuantization(mesh),
+            &uploaded->vertices);
+        uploaded->indices = mesh.indices;
+
+        return uploaded;
+    }
+
+    std::unique_ptr<decoded_texture_t> DecodeTexture(const AssetLoader::file_t& file, const std::wstring& filepath)
+    {
+        std::unique_ptr<decoded_texture_t> decoded(new decoded_texture_t());
+        decoded->file = file;
+
+        DdsFile::Parse(file->BufferPointer(), static_cast<size_t>(file->BufferSize()), filepath, &decoded->image);
+        return decoded;
+    }
+
+    std::shared_ptr<uploaded_texture_t> UploadTexture(decoded_texture_t& decoded)
+    {
+        std::shared_ptr<uploaded_texture_t> uploaded(new uploaded_texture_t());
+
+        for (const dds_subresource_t& subresource : decoded.image.subresources)
+        {
+            const char * pPixels = decoded.file->BufferPointer() + subresource.offset;
+            uploaded->pixels.insert(uploaded->pixels.end(), pPixels, pPixels + subresource.slicePitch);
+        }
+
+        return uploaded;
+    }
+}
+
+BENCHMARK(AssetLoading)
+{
+    asset_files_t files;
+    WriteAssetFiles(&files);
+
+    const double megabytes = static_cast<double>(files.totalBytes) / (1024.0 * 1024.0);
+    const double assetCount = static_cast<double>(files.meshes.size() + files.textures.size());
+
+    reporter.Report("assets", assetCount, "files");
+    reporter.Report("asset bytes", megabytes, "MB");
+
+    // Baseline: everything on the calling thread, the way Graphics::Initialize used to load.
+    reporter.TimeOnce("synchronous load", megabytes, "MB", [&]() {
+        for (const std::wstring& filepath : files.meshes)
+        {
+            AssetLoader::file_t file(new BinaryBlob(BinaryBlob::LoadFromFile(filepath)));
+
+            Benchmark::DoNotOptimize(UploadMesh(*DecodeMesh(file, filepath)).get());
+        }
+
+        for (const std::wstring& filepath : files.textures)
+        {
+            AssetLoader::file_t file(new BinaryBlob(BinaryBlob::LoadFromFile(filepath)));
+
+            Benchmark::DoNotOptimize(UploadTexture(*DecodeTexture(file, filepath)).get());
+        }
+    });
+
+    // Background loading pumped by a simulated 60Hz frame loop that spends at most the upload budget per frame.
+    AssetLoader loader;
+    std::vector<AssetHandle<uploaded_mesh_t>> meshes;
+    std::vector<AssetHandle<uploaded_texture_t>> textures;
+
+    BenchmarkReporter::Stopwatch stopwatch;
+
+    for (const std::wstring& filepath : files.textures)
+    {
+        textures.push_back(loader.Load<decoded_texture_t, uploaded_texture_t>(filepath, DecodeTexture, UploadTexture));
+    }
+
+    for (const std::wstring& filepath : files.meshes)
+    {
+        meshes.push_back(loader.Load<s_mesh_data_t, uploaded_mesh_t>(filepath, DecodeMesh, UploadMesh));
+    }
+
+    double requestSeconds = stopwatch.ElapsedSeconds();
+    double firstAssetSeconds = 0.0;
+    double longestUploadFrameSeconds = 0.0;
+    unsigned int frameCount = 0;
+
+    while (loader.PendingCount() > 0)
+    {
+        BenchmarkReporter::Stopwatch frame;
+
+        loader.ProcessUploads(UploadBudgetSeconds);
+        frameCount++;
+
+        double uploadSeconds = frame.ElapsedSeconds();
+
+        if (uploadSeconds > longestUploadFrameSeconds)
+        {
+            longestUploadFrameSeconds = uploadSeconds;
+        }
+
+        if (firstAssetSeconds == 0.0 && loader.Stats().completed > 0)
+        {
+            firstAssetSeconds = stopwatch.ElapsedSeconds();
+        }
+
+        // Sleep out the rest of the frame, as the render thread would be busy drawing.
+        double remaining = FrameSeconds - frame.ElapsedSeconds();
+
+        if (remaining > 0.0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(remaining * 1e6)));
+        }
+    }
+
+    double allAssetsSeconds = stopwatch.ElapsedSeconds();
+    asset_loader_stats_t stats = loader.Stats();
+
+    for (const AssetHandle<uploaded_mesh_t>& mesh : meshes) { mesh.Get(); }
+    for (const AssetHandle<uploaded_texture_t>& texture : textures) { texture.Get(); }
+
+    reporter.Report("requesting every asset", requestSeconds * 1000.0, "ms");
+    reporter.Report("time to first asset", firstAssetSeconds * 1000.0, "ms");
+    reporter.Report("time to all assets", allAssetsSeconds * 1000.0, "ms");
+    reporter.Report("frames to load", frameCount, "frames");
+    reporter.Report("longest upload frame", longestUploadFrameSeconds * 1000.0, "ms");
+    reporter.Report("throughput", megabytes / allAssetsSeconds, "MB/s");
+
+    // Stage totals are summed over assets, reads and decodes overlap so they can exceed the wall time.
+    reporter.Report("read (summed)", stats.readSeconds * 1000.0, "ms");
+    reporter.Report("decode (summed)", stats.decodeSeconds * 1000.0, "ms");
+    reporter.Report("upload (summed)", stats.uploadSeconds * 1000.0, "ms");
+    reporter.Report("queued (summed)", stats.queuedSeconds * 1000.0, "ms");
+    reporter.Report("read throughput", megabytes / stats.readSeconds, "MB/s");
+    reporter.Report("failed", stats.failed, "assets");
+}
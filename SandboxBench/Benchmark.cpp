@@ -0,0 +1,112 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    struct registered_benchmark_t
+    {
+        const char * pName;
+        Benchmark::benchmark_function_t function;
+    };
+
+    // Function local so registration works regardless of static initialization order.
+    std::vector<registered_benchmark_t>& Registry()
+    {
+        static std::vector<registered_benchmark_t> registry;
+        return registry;
+    }
+
+    // Print a duration with a readable unit.
+    void PrintDuration(double seconds)
+    {
+        if (seconds < 1.0e-6)       { std::printf("%9.2f ns", seconds * 1.0e9); }
+        else if (seconds < 1.0e-3)  { std::printf("%9.2f us", seconds * 1.0e6); }
+        else if (seconds < 1.0)     { std::printf("%9.2f ms", seconds * 1.0e3); }
+        else                        { std::printf("%9.2f s ", seconds); }
+    }
+}
+
+BenchmarkReporter::BenchmarkReporter(const std::string& benchmarkName)
+    : mBenchmarkName(benchmarkName)
+{
+}
+
+void BenchmarkReporter::Report(const char * pLabel, double value, const char * pUnits)
+{
+    std::printf("  %-28s %-36s %12.4f %s\n", mBenchmarkName.c_str(), pLabel, value, pUnits);
+}
+
+void BenchmarkReporter::ReportTimings(
+    const char * pLabel,
+    std::vector<double> *pSeconds,
+    double itemsPerIteration,
+    const char * pItemUnits)
+{
+    if (pSeconds->empty())
+    {
+        return;
+    }
+
+    std::sort(pSeconds->begin(), pSeconds->end());
+
+    double fastest = pSeconds->front();
+    double median = (*pSeconds)[pSeconds->size() / 2];
+
+    std::printf("  %-28s %-36s median ", mBenchmarkName.c_str(), pLabel);
+    PrintDuration(median);
+    std::printf("  min ");
+    PrintDuration(fastest);
+
+    if (itemsPerIteration > 0.0 && median > 0.0)
+    {
+        std::printf("  %10.2f M%s/s", itemsPerIteration / median / 1.0e6, pItemUnits);
+    }
+
+    std::printf("\n");
+}
+
+bool Benchmark::Register(const char * pName, benchmark_function_t function)
+{
+    registered_benchmark_t benchmark = { pName, function };
+    Registry().push_back(benchmark);
+
+    return true;
+}
+
+unsigned int Benchmark::RunAll(const std::string& filter)
+{
+    std::vector<registered_benchmark_t> benchmarks = Registry();
+    std::sort(
+        benchmarks.begin(),
+        benchmarks.end(),
+        [](const registered_benchmark_t& a, const registered_benchmark_t& b) { return std::string(a.pName) < b.pName; });
+
+    unsigned int runCount = 0;
+
+    for (const registered_benchmark_t& benchmark : benchmarks)
+    {
+        if (!filter.empty() && std::string(benchmark.pName).find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        BenchmarkReporter reporter(benchmark.pName);
+        benchmark.function(reporter);
+        std::fflush(stdout);
+
+        runCount++;
+    }
+
+    return runCount;
+}
+
+void Benchmark::DoNotOptimize(const void * pValue)
+{
+    // A volatile store through an opaque pointer is enough to keep the value alive.
+    static const void * volatile pSink = nullptr;
+    pSink = pValue;
+}
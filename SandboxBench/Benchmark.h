@@ -0,0 +1,86 @@
+#pragma once
+#include "Stopwatch.h"
+#include <string>
+#include <vector>
+
+/**
+ * \brief Minimal micro benchmark harness.
+ *
+ * Benchmarks are free functions registered with the BENCHMARK macro. Each one receives a BenchmarkReporter, times
+ * whatever it wants with Time() and reports any extra measurements (rejection rates, compression ratios, ...) with
+ * Report(). SandboxBench runs every registered benchmark whose name contains the filter passed on the command line.
+ *
+ *   BENCHMARK(SortIntegers)
+ *   {
+ *       std::vector<int> values = MakeValues();
+ *       reporter.Time("std::sort", 20, values.size(), "items", [&]() { Sort(values); });
+ *   }
+ */
+class BenchmarkReporter
+{
+public:
+    explicit BenchmarkReporter(const std::string& benchmarkName);
+
+    // Call work() once to warm up, then iterations more times. Reports the fastest and median run, and the
+    // throughput in units per second when itemsPerIteration is not zero.
+    template<typename Function>
+    void Time(const char * pLabel, unsigned int iterations, double itemsPerIteration, const char * pItemUnits, Function work)
+    {
+        std::vector<double> seconds;
+        seconds.reserve(iterations);
+
+        work();
+
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+            Stopwatch stopwatch;
+            work();
+            seconds.push_back(stopwatch.ElapsedSeconds());
+        }
+
+        ReportTimings(pLabel, &seconds, itemsPerIteration, pItemUnits);
+    }
+
+    // Time a single call of work(), for benchmarks too slow to repeat.
+    template<typename Function>
+    void TimeOnce(const char * pLabel, double items, const char * pItemUnits, Function work)
+    {
+        Stopwatch stopwatch;
+        work();
+
+        std::vector<double> seconds(1, stopwatch.ElapsedSeconds());
+        ReportTimings(pLabel, &seconds, items, pItemUnits);
+    }
+
+    // Report a measurement that is not a timing.
+    void Report(const char * pLabel, double value, const char * pUnits);
+
+    // Timer used for all measurements. See Stopwatch.h.
+    typedef ::Stopwatch Stopwatch;
+
+private:
+    void ReportTimings(const char * pLabel, std::vector<double> *pSeconds, double itemsPerIteration, const char * pItemUnits);
+
+private:
+    std::string mBenchmarkName;
+};
+
+namespace Benchmark
+{
+    typedef void (*benchmark_function_t)(BenchmarkReporter& reporter);
+
+    // Register a benchmark. Called by the BENCHMARK macro during static initialization.
+    bool Register(const char * pName, benchmark_function_t function);
+
+    // Run every benchmark whose name contains the filter, or all of them if the filter is empty. Returns the
+    // number of benchmarks that were run.
+    unsigned int RunAll(const std::string& filter);
+
+    // Keep the optimizer from discarding a computed value.
+    void DoNotOptimize(const void * pValue);
+}
+
+#define BENCHMARK(name) \
+    static void name(BenchmarkReporter& reporter); \
+    static const bool name##Registered = Benchmark::Register(#name, &name); \
+    static void name(BenchmarkReporter& reporter)
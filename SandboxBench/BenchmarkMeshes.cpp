@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "BenchmarkMeshes.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+s_mesh_data_t BenchmarkMeshes::MakeSphere(int rings, int segments)
+{
+    const float pi = 3.14159265358979f;
+    s_mesh_data_t mesh;
+
+    mesh.vertices.reserve((rings + 1) * (segments + 1));
+    mesh.indices.reserve(rings * segments * 6);
+
+    for (int i = 0; i <= rings; ++i)
+    {
+        for (int j = 0; j <= segments; ++j)
+        {
+            float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+            float phi = 2.0f * pi * static_cast<float>(j % segments) / static_cast<float>(segments);
+            float bump = 1.0f + 0.02f * std::sin(theta * 40.0f) * std::cos(phi * 40.0f);
+
+            s_mesh_vertex_t v;
+            v.nx = std::sin(theta) * std::cos(phi);
+            v.ny = std::cos(theta);
+            v.nz = std::sin(theta) * std::sin(phi);
+            v.x = v.nx * bump;
+            v.y = v.ny * bump;
+            v.z = v.nz * bump;
+            v.tu = static_cast<float>(j) / static_cast<float>(segments);
+            v.tv = static_cast<float>(i) / static_cast<float>(rings);
+
+            mesh.vertices.push_back(v);
+        }
+    }
+
+    for (int i = 0; i < rings; ++i)
+    {
+        for (int j = 0; j < segments; ++j)
+        {
+            int a = i * (segments + 1) + j;
+            int b = a + 1;
+            int c = a + segments + 1;
+            int d = c + 1;
+
+            int quad[6] = { a, b, c, b, d, c };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+
+    return mesh;
+}
+
+std::vector<char> BenchmarkMeshes::MakeTextModel(const s_mesh_data_t& mesh)
+{
+    std::string text = "#SimpleModelv1\n" +
+                       std::to_string(mesh.indices.size()) + " " + std::to_string(mesh.indices.size()) + "\n";
+    char line[256];
+
+    for (int index : mesh.indices)
+    {
+        const s_mesh_vertex_t& v = mesh.vertices[index];
+
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%g %g %g %g %g %g %g %g\n",
+            v.x, v.y, v.z,
+            v.tu, v.tv,
+            v.nx, v.ny, v.nz);
+
+        text += line;
+    }
+
+    for (size_t i = 0; i < mesh.indices.size(); ++i)
+    {
+        text += std::to_string(i) + "\n";
+    }
+
+    return std::vector<char>(text.begin(), text.end());
+}
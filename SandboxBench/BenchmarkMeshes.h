@@ -0,0 +1,16 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+
+/**
+ * \brief Procedural meshes shared by the benchmarks.
+ */
+namespace BenchmarkMeshes
+{
+    // Lumpy unit sphere built from a latitude / longitude grid with rings * segments * 2 triangles, wound clockwise
+    // when seen from outside. Has a texture seam along one meridian like an exported model would.
+    s_mesh_data_t MakeSphere(int rings, int segments);
+
+    // The mesh as a version 2 text model (see TextModelFile.h), one vertex per index like ObjConverter writes them.
+    std::vector<char> MakeTextModel(const s_mesh_data_t& mesh);
+}
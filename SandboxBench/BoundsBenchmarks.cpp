@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "BoundingVolumes.h"
+#include "Camera.h"
+#include "Frustum.h"
+#include "MeshData.h"
+#include "size.h"
+
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    const float ScreenNear = 0.1f;
+    const float ScreenDepth = 1000.0f;
+    const float FixedRadius = 2.0f;         // What Model used for every mesh before bounds were computed.
+}
+
+BENCHMARK(MeshBounds)
+{
+    s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(700, 1400);
+    const double vertexCount = static_cast<double>(mesh.vertices.size());
+    const float * pPositions = &mesh.vertices[0].x;
+
+    reporter.Report("vertices", vertexCount, "verts");
+
+    reporter.Time("bounding box", 10, vertexCount, "verts", [&]() {
+        aabb_t box = BoundingVolumes::ComputeAabb(pPositions, mesh.vertices.size(), sizeof(s_mesh_vertex_t));
+        Benchmark::DoNotOptimize(&box);
+    });
+
+    reporter.Time("bounding sphere", 10, vertexCount, "verts", [&]() {
+        bounding_sphere_t sphere =
+            BoundingVolumes::ComputeBoundingSphere(pPositions, mesh.vertices.size(), sizeof(s_mesh_vertex_t));
+        Benchmark::DoNotOptimize(&sphere);
+    });
+
+    // The sphere mesh is lumpy with a 5% bump, so the minimal radius is at most 1.05.
+    mesh_bounds_t bounds = BoundingVolumes::ComputeMeshBounds(mesh);
+    reporter.Report("sphere radius", bounds.sphere.radius, "units");
+}
+
+BENCHMARK(BoundsCulling)
+{
+    // A field of long, flat objects (a squashed sphere) at random orientations, the case where a generic radius is
+    // both too small along the long axis and far too big everywhere else.
+    s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(16, 32);
+
+    for (s_mesh_vertex_t& vertex : mesh.vertices)
+    {
+        vertex.x *= 3.0f;
+        vertex.y *= 0.2f;
+        vertex.z *= 0.5f;
+    }
+
+    mesh_bounds_t bounds = BoundingVolumes::ComputeMeshBounds(mesh);
+    std::vector<Matrix> worlds;
+
+    for (int x = 0; x < 40; ++x)
+    {
+        for (int z = 0; z < 40; ++z)
+        {
+            float yaw = static_cast<float>((x * 7 + z * 13) % 16) * 0.3927f;
+            worlds.push_back(
+                Matrix::CreateRotationY(yaw) *
+                Matrix::CreateTranslation(static_cast<float>(x - 20) * 5.0f, 0.0f, static_cast<float>(z) * 5.0f));
+        }
+    }
+
+    Camera camera(Size(1280, 720), ScreenNear, ScreenDepth);
+    camera.SetPosition(Vector3(0.0f, 3.0f, -10.0f));
+    camera.SetRotation(Vector3(10.0f, 25.0f, 0.0f));
+
+    Frustum frustum;
+    frustum.Update(camera);
+
+    unsigned int fixedCulled = 0, sphereCulled = 0, boxCulled = 0;
+
+    for (const Matrix& world : worlds)
+    {
+        if (!frustum.CheckSphere(world.Translation(), FixedRadius)) { fixedCulled++; }
+
+        bounding_sphere_t sphere = BoundingVolumes::TransformSphere(bounds.sphere, &world._11);
+        Vector3 center(sphere.center[0], sphere.center[1], sphere.center[2]);
+
+        if (!frustum.CheckSphere(center, sphere.radius))
+        {
+            sphereCulled++;
+            boxCulled++;
+            continue;
+        }
+
+        aabb_t box = BoundingVolumes::TransformAabb(bounds.box, &world._11);
+        Vector3 boxMin(box.min[0], box.min[1], box.min[2]);
+        Vector3 boxMax(box.max[0], box.max[1], box.max[2]);
+
+        if (!frustum.CheckRectangle((boxMin + boxMax) * 0.5f, (boxMax - boxMin) * 0.5f)) { boxCulled++; }
+    }
+
+    const double objectCount = static_cast<double>(worlds.size());
+
+    reporter.Report("objects", objectCount, "objects");
+    reporter.Report("culled with fixed radius (unsafe)", fixedCulled / objectCount * 100.0, "% objects");
+    reporter.Report("culled with tight sphere", sphereCulled / objectCount * 100.0, "% objects");
+    reporter.Report("culled with sphere and box", boxCulled / objectCount * 100.0, "% objects");
+}
@@ -0,0 +1,284 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "BinaryBlob.h"
+#include "BlockCompression.h"
+#include "DXTestException.h"
+#include "MeshData.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const unsigned int MeshCount = 16;
+    const unsigned int TextureCount = 4;
+    const unsigned int TextureSize = 1024;
+    const unsigned int TextModelCount = 4;
+    const unsigned int Iterations = 5;
+
+    // Files as they are written by the content pipeline, in the same proportions as a level's worth of assets.
+    struct corpus_file_t
+    {
+        const char * pCategory;
+        std::vector<char> data;
+        std::vector<char> compressed;
+    };
+
+    // BC1 texture with a full mip chain. Endpoints follow a smooth image the way a real encoder's would, the
+    // selector bits are close to random, as they are in real textures.
+    std::vector<char> MakeBc1Dds(unsigned int size, unsigned int seed)
+    {
+        unsigned int mipCount = 0;
+        size_t pixelBytes = 0;
+
+        for (unsigned int level = size; level > 0; level /= 2)
+        {
+            pixelBytes += ((level + 3) / 4) * ((level + 3) / 4) * 8;
+            mipCount++;
+        }
+
+        unsigned int header[32] = { 0 };
+        std::memcpy(&header[0], "DDS ", 4);
+        header[1] = 124;                        // Header size.
+        header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000;
+        header[3] = size;
+        header[4] = size;
+        header[7] = mipCount;
+        header[19] = 32;                        // Pixel format size.
+        header[20] = 0x4;                       // Four CC.
+        std::memcpy(&header[21], "DXT1", 4);
+        header[27] = 0x1000 | 0x400000 | 0x8;   // Texture, mip map, complex.
+
+        std::vector<char> file(sizeof(header) + pixelBytes);
+        std::memcpy(&file[0], header, sizeof(header));
+
+        char * pBlock = &file[sizeof(header)];
+        unsigned int state = seed * 7919 + 1;
+
+        for (unsigned int level = size; level > 0; level /= 2)
+        {
+            const unsigned int blocksWide = (level + 3) / 4;
+
+            for (unsigned int y = 0; y < blocksWide; ++y)
+            {
+                for (unsigned int x = 0; x < blocksWide; ++x)
+                {
+                    state = state * 1664525u + 1013904223u;
+
+                    // Two RGB565 endpoints from a gradient, and 16 two bit selectors.
+                    unsigned short color0 = static_cast<unsigned short>(((x * 31 / blocksWide) << 11) |
+                                                                        ((y * 63 / blocksWide) << 5) |
+                                                                        (seed * 5 % 32));
+                    unsigned short color1 = static_cast<unsigned short>(color0 - ((state >> 30) << 5));
+                    unsigned int selectors = (state & 0xFFFF0000u) | ((state >> 7) & 0xFFFFu);
+
+                    std::memcpy(pBlock + 0, &color0, 2);
+                    std::memcpy(pBlock + 2, &color1, 2);
+                    std::memcpy(pBlock + 4, &selectors, 4);
+                    pBlock += 8;
+                }
+            }
+        }
+
+        return file;
+    }
+
+    void BuildCorpus(std::vector<corpus_file_t> *pCorpus)
+    {
+        for (unsigned int i = 0; i < MeshCount; ++i)
+        {
+            s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(48 + i % 4 * 8, 96 + i % 4 * 16);
+            MeshletBuilder::Build(mesh, &mesh.meshlets);
+
+            corpus_file_t file;
+            file.pCategory = "mesh";
+            MeshFile::Write(mesh, &file.data);
+
+            pCorpus->push_back(file);
+        }
+
+        for (unsigned int i = 0; i < TextureCount; ++i)
+        {
+            corpus_file_t file;
+            file.pCategory = "bc1 texture";
+            file.data = MakeBc1Dds(TextureSize, i);
+
+            pCorpus->push_back(file);
+        }
+
+        for (unsigned int i = 0; i < TextModelCount; ++i)
+        {
+            corpus_file_t file;
+            file.pCategory = "text model";
+            file.data = BenchmarkMeshes::MakeTextModel(BenchmarkMeshes::MakeSphere(24 + i * 8, 48 + i * 16));
+
+            pCorpus->push_back(file);
+        }
+
+        // The game's own assets, when the benchmark runs from a directory next to DXTest.
+        const wchar_t * gameAssets[] =
+        {
+            L"..\\DXTest\\Models\\cube.model",
+            L"..\\DXTest\\Textures\\seafloor.dds",
+            L"..\\DXTest\\Fonts\\rastertek.dds",
+            L"..\\DXTest\\Fonts\\rastertek.txt"
+        };
+
+        for (const wchar_t * pFilepath : gameAssets)
+        {
+            try
+            {
+                BinaryBlob blob = BinaryBlob::LoadFromFile(std::wstring(pFilepath));
+
+                corpus_file_t file;
+                file.pCategory = "game asset";
+                file.data.assign(blob.BufferPointer(), blob.BufferPointer() + blob.BufferSize());
+
+                pCorpus->push_back(file);
+            }
+            catch (const FileLoadException&)
+            {
+            }
+        }
+    }
+
+    void ReportRatio(BenchmarkReporter& reporter, const std::vector<corpus_file_t>& corpus, const char * pCategory)
+    {
+        double original = 0.0;
+        double compressed = 0.0;
+
+        for (const corpus_file_t& file : corpus)
+        {
+            if (std::strcmp(file.pCategory, pCategory) == 0)
+            {
+                original += static_cast<double>(file.data.size());
+                compressed += static_cast<double>(file.compressed.size());
+            }
+        }
+
+        if (compressed > 0.0)
+        {
+            reporter.Report((std::string(pCategory) + " ratio").c_str(), original / compressed, "x");
+        }
+    }
+
+    // Time work() like BenchmarkReporter::Time() and report the fastest run in decimal GB per second.
+    template<typename Function>
+    void ReportGigabytesPerSecond(BenchmarkReporter& reporter, const char * pLabel, double bytes, Function work)
+    {
+        reporter.Time(pLabel, Iterations, bytes, "B", work);
+
+        double fastest = 0.0;
+
+        for (unsigned int i = 0; i < Iterations; ++i)
+        {
+            BenchmarkReporter::Stopwatch stopwatch;
+            work();
+
+            double seconds = stopwatch.ElapsedSeconds();
+            fastest = (i == 0 || seconds < fastest) ? seconds : fastest;
+        }
+
+        reporter.Report(pLabel, bytes / fastest / 1.0e9, "GB/s");
+    }
+}
+
+// Ratios are uncompressed / compressed size, higher is better. Decode rates are in uncompressed bytes: at a given
+// disk bandwidth, compressed loads are ratio times faster as long as decoding keeps up with the disk.
+BENCHMARK(AssetCompression)
+{
+    std::vector<corpus_file_t> corpus;
+    BuildCorpus(&corpus);
+
+    double totalBytes = 0.0;
+    double compressedBytes = 0.0;
+
+    for (const corpus_file_t& file : corpus)
+    {
+        totalBytes += static_cast<double>(file.data.size());
+    }
+
+    reporter.Report("corpus files", static_cast<double>(corpus.size()), "files");
+    reporter.Report("corpus bytes", totalBytes / 1.0e6, "MB");
+
+    reporter.TimeOnce("compress, all threads", totalBytes, "B", [&]() {
+        for (corpus_file_t& file : corpus)
+        {
+            BlockCompression::Compress(&file.data[0], file.data.size(), &file.compressed);
+        }
+    });
+
+    for (const corpus_file_t& file : corpus)
+    {
+        compressedBytes += static_cast<double>(file.compressed.size());
+    }
+
+    ReportRatio(reporter, corpus, "mesh");
+    ReportRatio(reporter, corpus, "bc1 texture");
+    ReportRatio(reporter, corpus, "text model");
+    ReportRatio(reporter, corpus, "game asset");
+    reporter.Report("corpus ratio", totalBytes / compressedBytes, "x");
+
+    // Decoding into a buffer per file, the way BinaryBlob::LoadFromFile does for packed files.
+    std::vector<std::vector<char>> output(corpus.size());
+
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        output[i].resize(corpus[i].data.size());
+    }
+
+    auto decodeAll = [&](unsigned int threadCount) {
+        for (size_t i = 0; i < corpus.size(); ++i)
+        {
+            BlockCompression::Decompress(
+                &corpus[i].compressed[0],
+                corpus[i].compressed.size(),
+                &output[i][0],
+                output[i].size(),
+                L"corpus",
+                threadCount);
+        }
+    };
+
+    ReportGigabytesPerSecond(reporter, "decode, 1 thread", totalBytes, [&]() { decodeAll(1); });
+    ReportGigabytesPerSecond(reporter, "decode, all threads", totalBytes, [&]() { decodeAll(0); });
+
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        if (output[i] != corpus[i].data)
+        {
+            throw SandboxException(L"Compression benchmark decoded the wrong data");
+        }
+    }
+
+    // Streaming through one block sized buffer that stays in cache, as a reader feeding a parser would.
+    std::vector<char> block(BlockCompression::MaxBlockSize);
+
+    ReportGigabytesPerSecond(reporter, "decode, streaming", totalBytes, [&]() {
+        for (const corpus_file_t& file : corpus)
+        {
+            BlockDecoder decoder(&file.compressed[0], file.compressed.size(), L"corpus");
+
+            while (decoder.DecodeNext(&block[0], block.size()) > 0)
+            {
+                Benchmark::DoNotOptimize(&block[0]);
+            }
+        }
+    });
+
+    // Upper bound, copying the same bytes.
+    ReportGigabytesPerSecond(reporter, "memcpy", totalBytes, [&]() {
+        for (size_t i = 0; i < corpus.size(); ++i)
+        {
+            std::memcpy(&output[i][0], &corpus[i].data[0], corpus[i].data.size());
+        }
+    });
+
+    reporter.Report("hardware threads", static_cast<double>(std::thread::hardware_concurrency()), "threads");
+}
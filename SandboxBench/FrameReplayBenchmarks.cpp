@@ -0,0 +1,25 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "FrameReplay.h"
+
+#include <iostream>
+
+// CPU cost of a frame with no window or GPU: the scripted FrameReplay scene with the default settings. The draw list
+// checksum must stay the same from build to build unless culling or LOD selection was meant to change, so timings
+// from two builds are only compared when their checksums match.
+BENCHMARK(HeadlessFrames)
+{
+    FrameReplay replay(FrameReplay::DefaultSettings());
+    frame_replay_result_t result;
+
+    reporter.TimeOnce("replay", 0.0, "", [&]() {
+        result = replay.Run();
+    });
+
+    reporter.Report("frame p50", result.timing.p50, "ms");
+    reporter.Report("frame p95", result.timing.p95, "ms");
+    reporter.Report("frame p99", result.timing.p99, "ms");
+    reporter.Report("frame max", result.timing.max, "ms");
+
+    std::cout << replay.Report(result) << std::endl;
+}
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "Camera.h"
+#include "LightClusters.h"
+#include "MathTypes.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "size.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    const size_t LightCount = 1000;
+
+    // Lights scattered over the first 200 units in front of the camera, a quarter of them spots.
+    std::vector<local_light_t> BenchmarkLights()
+    {
+        Random random(0x11647);
+        std::vector<local_light_t> lights(LightCount);
+
+        for (local_light_t& light : lights)
+        {
+            light.position = Vector3(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-5.0f, 25.0f),
+                                     random.NextFloat(0.0f, 200.0f));
+            light.range = random.NextFloat(2.0f, 10.0f);
+            light.color = Vector3(random.NextFloat(0.2f, 1.0f), random.NextFloat(0.2f, 1.0f), 1.0f);
+            light.intensity = 1.0f;
+            light.direction = Vector3(0.0f, -1.0f, 0.0f);
+            light.spotCosAngle = 0.0f;
+            light.type = LocalLightType::Point;
+
+            if (random.NextUInt(4) == 0)
+            {
+                light.direction = Vector3(random.NextFloat(-0.5f, 0.5f), -1.0f, random.NextFloat(-0.5f, 0.5f));
+                light.direction.Normalize();
+                light.spotCosAngle = random.NextFloat(0.6f, 0.95f);
+                light.type = LocalLightType::Spot;
+            }
+        }
+
+        return lights;
+    }
+}
+
+// Assigning 1k point and spot lights to a 16x9x24 cluster grid, as the renderer does once per frame. The brute force
+// version is the baseline: every light against every cluster box one at a time, without the slice and row passes.
+BENCHMARK(ClusteredLightAssignment)
+{
+    Camera camera(Size(1920, 1080), 0.1f, 1000.0f);
+    camera.SetPosition(Vector3(0.0f, 10.0f, -10.0f));
+    camera.SetRotation(Vector3(15.0f, 0.0f, 0.0f));
+
+    const std::vector<local_light_t> lights = BenchmarkLights();
+    LightClusters clusters;
+
+    // Bounds are built on the first call, so the brute force loop below can use them.
+    clusters.Assign(camera, lights.data(), lights.size());
+
+    const double clusterCount = static_cast<double>(clusters.ClusterCount());
+    std::vector<bounding_sphere_t> viewSpheres(LightCount);
+    std::vector<cluster_light_list_t> bruteLists(clusters.ClusterCount());
+    std::vector<unsigned short> bruteIndices;
+
+    reporter.Time("brute force, scalar", 5, clusterCount, "clusters", [&]() {
+        for (size_t light = 0; light < LightCount; ++light)
+        {
+            const bounding_sphere_t sphere = LightClusters::LightBounds(lights[light]);
+            const Vector3 center = Vector3::Transform(
+                Vector3(sphere.center[0], sphere.center[1], sphere.center[2]),
+                camera.ViewMatrix());
+
+            viewSpheres[light] = { { center.x, center.y, center.z }, sphere.radius };
+        }
+
+        bruteIndices.clear();
+
+        for (unsigned int cluster = 0; cluster < clusters.ClusterCount(); ++cluster)
+        {
+            const aabb_t& box = clusters.ClusterBounds(cluster);
+            bruteLists[cluster].offset = static_cast<unsigned int>(bruteIndices.size());
+
+            for (size_t light = 0; light < LightCount; ++light)
+            {
+                float distanceSquared = 0.0f;
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const float c = viewSpheres[light].center[axis];
+                    const float d = std::max(std::max(box.min[axis] - c, c - box.max[axis]), 0.0f);
+                    distanceSquared += d * d;
+                }
+
+                if (distanceSquared <= viewSpheres[light].radius * viewSpheres[light].radius)
+                {
+                    bruteIndices.push_back(static_cast<unsigned short>(light));
+                }
+            }
+
+            bruteLists[cluster].count = static_cast<unsigned int>(bruteIndices.size()) - bruteLists[cluster].offset;
+        }
+
+        Benchmark::DoNotOptimize(bruteIndices.data());
+    });
+
+    ThreadPool serialPool(1);
+
+    reporter.Time("LightClusters, one thread", 50, clusterCount, "clusters", [&]() {
+        clusters.Assign(camera, lights.data(), lights.size(), serialPool);
+        Benchmark::DoNotOptimize(clusters.LightIndices().data());
+    });
+
+    ThreadPool& pool = ThreadPool::Shared();
+
+    reporter.Time("LightClusters, shared pool", 50, clusterCount, "clusters", [&]() {
+        clusters.Assign(camera, lights.data(), lights.size(), pool);
+        Benchmark::DoNotOptimize(clusters.LightIndices().data());
+    });
+
+    unsigned int busiest = 0;
+    unsigned int occupied = 0;
+
+    for (const cluster_light_list_t& list : clusters.ClusterLists())
+    {
+        busiest = std::max(busiest, list.count);
+        occupied += list.count > 0 ? 1 : 0;
+    }
+
+    const double indexCount = static_cast<double>(clusters.LightIndices().size());
+
+    reporter.Report("pool threads", static_cast<double>(pool.ThreadCount()), "threads");
+    reporter.Report("light indices", indexCount, "indices");
+    reporter.Report("brute force indices", static_cast<double>(bruteIndices.size()), "indices");
+    reporter.Report("clusters with lights", static_cast<double>(occupied), "clusters");
+    reporter.Report("lights per lit cluster", occupied > 0 ? indexCount / occupied : 0.0, "lights");
+    reporter.Report("most lights in a cluster", static_cast<double>(busiest), "lights");
+}
@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "PortableMath.h"
+
+#include <vector>
+
+namespace
+{
+    const size_t MatrixCount = 16 * 1024;
+    const size_t PointCount = 64 * 1024;
+
+    template<typename Backend>
+    void MultiplyAll(const std::vector<float>& matrices, const float matrix[16], std::vector<float> * pOut)
+    {
+        for (size_t i = 0; i < MatrixCount; ++i)
+        {
+            PortableMath::MultiplyMatrix<Backend>(&matrices[i * 16], matrix, &(*pOut)[i * 16]);
+        }
+    }
+
+    template<typename Backend>
+    void TransformAll(const std::vector<float>& points, const float matrix[16], std::vector<float> * pOut)
+    {
+        for (size_t i = 0; i < PointCount; ++i)
+        {
+            PortableMath::TransformRow<Backend>(&points[i * 4], matrix, &(*pOut)[i * 4]);
+        }
+    }
+}
+
+// The PortableMath backends behind SimpleMath's types off Windows, one matrix or point at a time.
+BENCHMARK(PortableMathBackends)
+{
+    const PortableMath::Matrix viewProjection =
+        PortableMath::XMMatrixLookAtLH(
+            PortableMath::Vector3(0.0f, 2.0f, -10.0f),
+            PortableMath::Vector3(0.0f, 0.0f, 0.0f),
+            PortableMath::Vector3(0.0f, 1.0f, 0.0f)) *
+        PortableMath::XMMatrixPerspectiveFovLH(0.785f, 1.333f, 0.1f, 1000.0f);
+
+    const float * m = &viewProjection._11;
+
+    std::vector<float> matrices(MatrixCount * 16), combined(MatrixCount * 16);
+    std::vector<float> points(PointCount * 4), transformed(PointCount * 4);
+
+    for (size_t k = 0; k < matrices.size(); ++k)
+    {
+        matrices[k] = static_cast<float>(k % 13) * 0.25f - 1.0f;
+    }
+
+    for (size_t k = 0; k < points.size(); ++k)
+    {
+        points[k] = (k % 4 == 3) ? 1.0f : static_cast<float>(k % 100) * 0.1f;
+    }
+
+    reporter.Time("matrices, ScalarBackend", 100, static_cast<double>(MatrixCount), "matrices", [&]() {
+        MultiplyAll<PortableMath::ScalarBackend>(matrices, m, &combined);
+        Benchmark::DoNotOptimize(combined.data());
+    });
+
+    reporter.Time("matrices, DefaultBackend", 100, static_cast<double>(MatrixCount), "matrices", [&]() {
+        MultiplyAll<PortableMath::DefaultBackend>(matrices, m, &combined);
+        Benchmark::DoNotOptimize(combined.data());
+    });
+
+    reporter.Time("points, ScalarBackend", 100, static_cast<double>(PointCount), "points", [&]() {
+        TransformAll<PortableMath::ScalarBackend>(points, m, &transformed);
+        Benchmark::DoNotOptimize(transformed.data());
+    });
+
+    reporter.Time("points, DefaultBackend", 100, static_cast<double>(PointCount), "points", [&]() {
+        TransformAll<PortableMath::DefaultBackend>(points, m, &transformed);
+        Benchmark::DoNotOptimize(transformed.data());
+    });
+}
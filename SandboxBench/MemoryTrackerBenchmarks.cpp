@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "MemoryTracker.h"
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const size_t LiveBlockCount = 256;
+    const size_t AllocationsPerRound = 64 * 1024;
+    const unsigned int ThreadCount = 4;
+
+    struct system_heap_t
+    {
+        static void * Allocate(size_t size) { return std::malloc(size); }
+        static void Free(void * pMemory) { std::free(pMemory); }
+    };
+
+    struct tracked_heap_t
+    {
+        static void * Allocate(size_t size) { return MemoryTracker::Allocate(size, MemoryTag::General); }
+        static void Free(void * pMemory) { MemoryTracker::Free(pMemory); }
+    };
+
+    // Small mixed sizes, freed in a different order than they were made, like short lived strings and vectors.
+    template<typename Heap>
+    void Churn(size_t allocationCount)
+    {
+        std::vector<void *> live(LiveBlockCount, nullptr);
+
+        for (size_t i = 0; i < allocationCount; ++i)
+        {
+            const size_t slot = (i * 7919) % LiveBlockCount;
+
+            Heap::Free(live[slot]);
+            live[slot] = Heap::Allocate(16 + (i * 37) % 240);
+        }
+
+        for (void * pMemory : live)
+        {
+            Heap::Free(pMemory);
+        }
+    }
+
+    template<typename Heap>
+    void ChurnOnThreads()
+    {
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < ThreadCount; ++i)
+        {
+            threads.push_back(std::thread([]() { Churn<Heap>(AllocationsPerRound / ThreadCount); }));
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+// What routing every allocation through MemoryTracker costs over plain malloc and free, with tracking off and on.
+// With tracking on every allocation does a few relaxed atomic adds, which is what decides whether it can stay on.
+BENCHMARK(MemoryTrackerOverhead)
+{
+    const bool wasEnabled = MemoryTracker::IsEnabled();
+    const double items = static_cast<double>(AllocationsPerRound);
+
+    reporter.Time("malloc/free", 50, items, "allocs", [&]() { Churn<system_heap_t>(AllocationsPerRound); });
+
+    MemoryTracker::SetEnabled(false);
+    reporter.Time("tracker, disabled", 50, items, "allocs", [&]() { Churn<tracked_heap_t>(AllocationsPerRound); });
+
+    MemoryTracker::SetEnabled(true);
+    reporter.Time("tracker, enabled", 50, items, "allocs", [&]() { Churn<tracked_heap_t>(AllocationsPerRound); });
+
+    reporter.Time("malloc/free, 4 threads", 20, items, "allocs", [&]() { ChurnOnThreads<system_heap_t>(); });
+    reporter.Time("tracker enabled, 4 threads", 20, items, "allocs", [&]() { ChurnOnThreads<tracked_heap_t>(); });
+
+    reporter.Report("peak tracked bytes", static_cast<double>(MemoryTracker::Stats(MemoryTag::General).peakBytes),
+        "bytes");
+
+    MemoryTracker::SetEnabled(wasEnabled);
+}
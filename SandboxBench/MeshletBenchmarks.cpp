@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "Camera.h"
+#include "Frustum.h"
+#include "MeshData.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "size.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    const float ScreenNear = 0.1f;
+    const float ScreenDepth = 1000.0f;
+
+    // Point the camera at a target. Camera rotations are yaw / pitch in degrees.
+    void LookAt(Camera *pCamera, const Vector3& position, const Vector3& target)
+    {
+        const float RadiansToDegrees = 57.2957795f;
+        Vector3 direction = target - position;
+        direction.Normalize();
+
+        pCamera->SetPosition(position);
+        pCamera->SetRotation(Vector3(
+            -std::asin(direction.y) * RadiansToDegrees,
+            std::atan2(direction.x, direction.z) * RadiansToDegrees,
+            0.0f));
+    }
+
+    struct camera_view_t
+    {
+        const char * pName;
+        Vector3 position;
+        Vector3 target;
+    };
+}
+
+BENCHMARK(MeshletCulling)
+{
+    const int Rings = 700;
+    const int Segments = 1400;
+
+    s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(Rings, Segments);
+    const double triangleCount = static_cast<double>(mesh.indices.size() / 3);
+
+    reporter.Report("triangles", triangleCount, "tris");
+
+    reporter.Time("build meshlets", 3, triangleCount, "tris", [&]() {
+        MeshletBuilder::Build(mesh, &mesh.meshlets);
+    });
+
+    reporter.Report("meshlets", static_cast<double>(mesh.meshlets.meshlets.size()), "meshlets");
+    reporter.Report(
+        "average triangles per meshlet",
+        triangleCount / static_cast<double>(mesh.meshlets.meshlets.size()),
+        "tris");
+
+    // A spread of typical views: whole object in view, close up of the surface, object partly off screen.
+    const camera_view_t views[] =
+    {
+        { "whole object", Vector3(0.0f, 0.5f, -4.0f), Vector3(0.0f, 0.0f, 0.0f) },
+        { "close up", Vector3(0.0f, 0.0f, -1.3f), Vector3(0.0f, 0.0f, 0.0f) },
+        { "grazing", Vector3(-1.2f, 0.2f, -1.2f), Vector3(1.0f, 0.0f, 0.0f) },
+        { "off to the side", Vector3(0.0f, 0.0f, -3.0f), Vector3(1.5f, 0.0f, 0.0f) },
+    };
+
+    Camera camera(Size(1280, 720), ScreenNear, ScreenDepth);
+    Frustum frustum;
+    Matrix world = Matrix::Identity;
+    std::vector<unsigned int> visible;
+    meshlet_cull_stats_t totals = { 0, 0, 0, 0, 0, 0 };
+
+    for (const camera_view_t& view : views)
+    {
+        LookAt(&camera, view.position, view.target);
+        frustum.Update(ScreenDepth, camera.ProjectionMatrix(), camera.ViewMatrix());
+
+        meshlet_cull_stats_t stats = { 0, 0, 0, 0, 0, 0 };
+        visible.clear();
+        MeshletCuller::Cull(mesh.meshlets, world, frustum, camera.Position(), &visible, &stats);
+
+        totals.meshletsTested += stats.meshletsTested;
+        totals.trianglesTested += stats.trianglesTested;
+        totals.trianglesFrustumCulled += stats.trianglesFrustumCulled;
+        totals.trianglesBackfaceCulled += stats.trianglesBackfaceCulled;
+
+        std::string label = std::string(view.pName) + " rejected";
+        reporter.Report(label.c_str(), stats.TriangleRejectionRate() * 100.0, "% tris");
+
+        label = std::string(view.pName) + " cull";
+        reporter.Time(label.c_str(), 50, static_cast<double>(stats.meshletsTested), "meshlets", [&]() {
+            visible.clear();
+            MeshletCuller::Cull(mesh.meshlets, world, frustum, camera.Position(), &visible, nullptr);
+            Benchmark::DoNotOptimize(visible.data());
+        });
+    }
+
+    double tested = static_cast<double>(totals.trianglesTested);
+
+    reporter.Report("all views frustum rejected", totals.trianglesFrustumCulled / tested * 100.0, "% tris");
+    reporter.Report("all views backface rejected", totals.trianglesBackfaceCulled / tested * 100.0, "% tris");
+    reporter.Report("all views total rejected", totals.TriangleRejectionRate() * 100.0, "% tris");
+}
@@ -0,0 +1,142 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BinaryBlob.h"
+#include "PackFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const unsigned int FileCount = 2000;
+
+    // Loose files written next to the benchmark and removed again when done.
+    struct loose_files_t
+    {
+        std::vector<std::wstring> paths;
+        std::wstring packPath;
+        unsigned long long totalBytes;
+
+        loose_files_t() : paths(), packPath(), totalBytes(0) { }
+
+        ~loose_files_t()
+        {
+            for (const std::wstring& path : paths) { Remove(path); }
+            Remove(packPath);
+        }
+
+        static void Remove(const std::wstring& filepath)
+        {
+            std::remove(std::string(filepath.begin(), filepath.end()).c_str());
+        }
+    };
+
+    // Mostly small files with the odd large one, roughly the mix of models, fonts, shaders and textures.
+    size_t FileSize(unsigned int index)
+    {
+        return (index % 50 == 0) ? 256 * 1024 + index : 512 + (index * 7919) % (48 * 1024);
+    }
+
+    void WriteLooseFiles(loose_files_t *pFiles)
+    {
+        std::vector<char> contents;
+
+        for (unsigned int i = 0; i < FileCount; ++i)
+        {
+            contents.assign(FileSize(i), static_cast<char>(i));
+
+            std::string filename = "PackFileBenchmark_" + std::to_string(i) + ".bin";
+            std::ofstream stream(filename.c_str(), std::ios::binary);
+            stream.write(&contents[0], static_cast<std::streamsize>(contents.size()));
+
+            pFiles->paths.push_back(std::wstring(filename.begin(), filename.end()));
+            pFiles->totalBytes += contents.size();
+        }
+    }
+
+    // Load every file and touch each of its pages, blobs are mapped and would otherwise never be read.
+    void LoadAll(const std::vector<std::wstring>& paths)
+    {
+        for (const std::wstring& path : paths)
+        {
+            BinaryBlob blob = BinaryBlob::LoadFromFile(path);
+            char sum = 0;
+
+            for (std::streamsize i = 0; i < blob.BufferSize(); i += 4096)
+            {
+                sum ^= blob.BufferPointer()[i];
+            }
+
+            Benchmark::DoNotOptimize(&sum);
+        }
+    }
+}
+
+// The OS file cache is not flushed, the files were just written so both the loose files and the pack start out cached.
+// "First" loads still pay for opening every file, or for mapping the pack and faulting its pages in. A truly cold
+// start also pays for the disk reads, which favours the pack even more since it is one contiguous file.
+BENCHMARK(PackedAssets)
+{
+    loose_files_t files;
+    WriteLooseFiles(&files);
+
+    const double fileCount = static_cast<double>(files.paths.size());
+    reporter.Report("files", fileCount, "files");
+    reporter.Report("file bytes", static_cast<double>(files.totalBytes) / (1024.0 * 1024.0), "MB");
+
+    // Loose files, one open / map / close each.
+    reporter.TimeOnce("loose files, first load", fileCount, "files", [&]() { LoadAll(files.paths); });
+    reporter.Time("loose files, warm", 5, fileCount, "files", [&]() { LoadAll(files.paths); });
+
+    // Same files through a pack.
+    PackWriter writer;
+
+    for (const std::wstring& path : files.paths)
+    {
+        writer.AddFile(path, path);
+    }
+
+    files.packPath = L"PackFileBenchmark.pack";
+    writer.Save(files.packPath);
+
+    std::shared_ptr<const PackFile> pack;
+
+    reporter.TimeOnce("pack, open and first load", fileCount, "files", [&]() {
+        pack = std::make_shared<PackFile>(files.packPath);
+        PackFile::Mount(pack);
+
+        LoadAll(files.paths);
+    });
+
+    reporter.Time("pack, warm", 5, fileCount, "files", [&]() { LoadAll(files.paths); });
+
+    // Blobs of uncompressed entries point into the pack's mapping, loading allocates no buffers at all.
+    const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
+    LoadAll(files.paths);
+
+    reporter.Report(
+        "pack, buffers allocated per load",
+        static_cast<double>(BinaryBlob::BufferAllocationCount() - allocations) / fileCount,
+        "buffers");
+
+    // Lookup alone, without creating blobs or touching the data.
+    reporter.Time("pack, zero copy lookup", 5, fileCount, "files", [&]() {
+        pack_entry_t entry;
+
+        for (const std::wstring& path : files.paths)
+        {
+            pack->Find(path, &entry);
+            Benchmark::DoNotOptimize(entry.pData);
+        }
+    });
+
+    PackFile::UnmountAll();
+
+    reporter.Report(
+        "pack overhead",
+        (static_cast<double>(pack->FileSize()) / static_cast<double>(files.totalBytes) - 1.0) * 100.0,
+        "% bytes");
+}
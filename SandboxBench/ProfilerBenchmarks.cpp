@@ -0,0 +1,69 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "Stopwatch.h"
+
+namespace
+{
+    const size_t ScopeCount = 1000 * 1000;
+
+    // Stands in for the work inside a profiled scope, so the loop is not optimized away.
+    unsigned int GWork = 0;
+
+    void Unprofiled()
+    {
+        for (size_t i = 0; i < ScopeCount; ++i)
+        {
+            GWork += static_cast<unsigned int>(i);
+            Benchmark::DoNotOptimize(&GWork);
+        }
+    }
+
+    void Profiled()
+    {
+        for (size_t i = 0; i < ScopeCount; ++i)
+        {
+            PROFILE_SCOPE("BenchmarkScope");
+            GWork += static_cast<unsigned int>(i);
+            Benchmark::DoNotOptimize(&GWork);
+        }
+    }
+}
+
+// Cost of a PROFILE_SCOPE: with SANDBOX_NO_PROFILER it is the unprofiled loop, with recording off it is one flag
+// check, and with recording on it is two timestamps and two ring buffer writes.
+BENCHMARK(ProfilerOverhead)
+{
+    const bool wasEnabled = Profiler::IsEnabled();
+    const double items = static_cast<double>(ScopeCount);
+
+    reporter.Time("no scope", 20, items, "scopes", []() { Unprofiled(); });
+
+    Profiler::SetEnabled(false);
+    reporter.Time("PROFILE_SCOPE, disabled", 20, items, "scopes", []() { Profiled(); });
+
+    Profiler::SetEnabled(true);
+    reporter.Time("PROFILE_SCOPE, enabled", 20, items, "scopes", []() { Profiled(); });
+
+    Profiler::SetEnabled(wasEnabled);
+
+    unsigned long long ticks = 0;
+    double seconds = 0.0;
+
+    reporter.Time("Profiler::Ticks", 20, items, "reads", [&]() {
+        for (size_t i = 0; i < ScopeCount; ++i)
+        {
+            ticks += Profiler::Ticks();
+        }
+    });
+
+    reporter.Time("Stopwatch::Now", 20, items, "reads", [&]() {
+        for (size_t i = 0; i < ScopeCount; ++i)
+        {
+            seconds += Stopwatch::Now();
+        }
+    });
+
+    Benchmark::DoNotOptimize(&ticks);
+    Benchmark::DoNotOptimize(&seconds);
+}
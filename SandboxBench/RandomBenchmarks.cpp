@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "Random.h"
+#include "Utils.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t SampleCount = 4 * 1024 * 1024;
+}
+
+BENCHMARK(RandomNumbers)
+{
+    const double count = static_cast<double>(SampleCount);
+    std::vector<float> floats(SampleCount);
+    std::vector<int> ints(SampleCount);
+
+    reporter.Time("floats, Utils::RandFloat", 3, count, "samples", [&]() {
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            floats[i] = Utils::RandFloat(-1.0f, 1.0f);
+        }
+
+        Benchmark::DoNotOptimize(floats.data());
+    });
+
+    reporter.Time("floats, mt19937", 3, count, "samples", [&]() {
+        std::mt19937 engine(42);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            floats[i] = distribution(engine);
+        }
+
+        Benchmark::DoNotOptimize(floats.data());
+    });
+
+    reporter.Time("floats, NextFloat", 5, count, "samples", [&]() {
+        Random random(42);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            floats[i] = random.NextFloat(-1.0f, 1.0f);
+        }
+
+        Benchmark::DoNotOptimize(floats.data());
+    });
+
+    reporter.Time("floats, FillFloats", 10, count, "samples", [&]() {
+        Random random(42);
+        random.FillFloats(floats.data(), SampleCount, -1.0f, 1.0f);
+        Benchmark::DoNotOptimize(floats.data());
+    });
+
+    reporter.Time("ints, mt19937", 3, count, "samples", [&]() {
+        std::mt19937 engine(42);
+        std::uniform_int_distribution<int> distribution(0, 999);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            ints[i] = distribution(engine);
+        }
+
+        Benchmark::DoNotOptimize(ints.data());
+    });
+
+    reporter.Time("ints, NextInt", 5, count, "samples", [&]() {
+        Random random(42);
+
+        for (size_t i = 0; i < SampleCount; ++i)
+        {
+            ints[i] = random.NextInt(0, 999);
+        }
+
+        Benchmark::DoNotOptimize(ints.data());
+    });
+
+    reporter.Time("ints, FillInts", 10, count, "samples", [&]() {
+        Random random(42);
+        random.FillInts(ints.data(), SampleCount, 0, 999);
+        Benchmark::DoNotOptimize(ints.data());
+    });
+}
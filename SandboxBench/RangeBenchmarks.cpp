@@ -0,0 +1,126 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "Range.h"
+#include "ThreadPool.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const unsigned int ElementCount = 4 * 1024 * 1024;
+
+    // Enough work per element that threads have something to split.
+    inline float Shade(float value)
+    {
+        return std::sqrt(value * value + 1.0f) * 0.5f + value * 0.25f;
+    }
+}
+
+BENCHMARK(RangeLoops)
+{
+    const double count = static_cast<double>(ElementCount);
+    std::vector<float> input(ElementCount);
+    std::vector<float> output(ElementCount);
+
+    for (unsigned int i = 0; i < ElementCount; ++i)
+    {
+        input[i] = static_cast<float>(i % 1000) * 0.01f;
+    }
+
+    // Serial loops should all run at the speed of the hand written one.
+    reporter.Time("serial, hand written loop", 10, count, "elements", [&]() {
+        for (unsigned int i = 0; i < ElementCount; ++i)
+        {
+            output[i] = Shade(input[i]);
+        }
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("serial, MakeRange for loop", 10, count, "elements", [&]() {
+        for (auto i : MakeRange(0, ElementCount))
+        {
+            output[i] = Shade(input[i]);
+        }
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("serial, MakeRange ForEach", 10, count, "elements", [&]() {
+        MakeRange(0, ElementCount).ForEach([&](unsigned int i) { output[i] = Shade(input[i]); });
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("serial, chunks of 4096", 10, count, "elements", [&]() {
+        for (auto chunk : MakeChunks(MakeRange(0, ElementCount), 4096u))
+        {
+            for (auto i : chunk)
+            {
+                output[i] = Shade(input[i]);
+            }
+        }
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("serial, one thread ParallelFor", 10, count, "elements", [&]() {
+        ThreadPool serialPool(1);
+        ParallelFor(serialPool, MakeRange(0, ElementCount), [&](unsigned int i) { output[i] = Shade(input[i]); });
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    // Unrolled fixed size loops, 4x4 blocks of a larger array.
+    reporter.Time("4x4 blocks, hand written loop", 10, count, "elements", [&]() {
+        for (unsigned int block = 0; block < ElementCount; block += 16)
+        {
+            for (unsigned int i = 0; i < 16; ++i)
+            {
+                output[block + i] = input[block + i] * 2.0f + 1.0f;
+            }
+        }
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("4x4 blocks, constant ForEach", 10, count, "elements", [&]() {
+        for (unsigned int block = 0; block < ElementCount; block += 16)
+        {
+            MakeRange<0, 16>().ForEach([&](unsigned int i) { output[block + i] = input[block + i] * 2.0f + 1.0f; });
+        }
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    ThreadPool& pool = ThreadPool::Shared();
+
+    reporter.Time("parallel, ParallelFor auto grain", 20, count, "elements", [&]() {
+        ParallelFor(pool, MakeRange(0, ElementCount), [&](unsigned int i) { output[i] = Shade(input[i]); });
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("parallel, ParallelFor over chunks", 20, count, "elements", [&]() {
+        ParallelFor(pool, MakeChunks(MakeRange(0, ElementCount), 16384u), [&](const RuntimeRange<unsigned int>& chunk) {
+            for (auto i : chunk)
+            {
+                output[i] = Shade(input[i]);
+            }
+        });
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+
+    reporter.Time("parallel, 2048x2048 in 64x64 tiles", 20, count, "elements", [&]() {
+        ParallelFor(pool, MakeTiles2D(2048, 2048, 64, 64), [&](const tile_2d_t& tile) {
+            for (auto y : tile.y)
+            {
+                for (auto x : tile.x)
+                {
+                    output[y * 2048 + x] = Shade(input[y * 2048 + x]);
+                }
+            }
+        });
+
+        Benchmark::DoNotOptimize(output.data());
+    });
+}
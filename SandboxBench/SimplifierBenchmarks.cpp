@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "MeshData.h"
+#include "MeshSimplifier.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::vector<float> LodRatios()
+    {
+        std::vector<float> ratios;
+        ratios.push_back(0.5f);
+        ratios.push_back(0.25f);
+        ratios.push_back(0.125f);
+        ratios.push_back(0.0625f);
+        ratios.push_back(0.01f);
+
+        return ratios;
+    }
+}
+
+BENCHMARK(SimplifyLargeMesh)
+{
+    // About four million triangles.
+    s_mesh_data_t mesh = BenchmarkMeshes::MakeSphere(1000, 2000);
+    const double triangleCount = static_cast<double>(mesh.indices.size() / 3);
+
+    reporter.Report("triangles", triangleCount, "tris");
+
+    reporter.TimeOnce("LOD chain", triangleCount, "tris", [&]() {
+        MeshSimplifier::GenerateLods(&mesh, LodRatios());
+    });
+
+    for (const s_mesh_lod_t& lod : mesh.lods)
+    {
+        std::string label = "LOD " + std::to_string(static_cast<unsigned long long>(lod.indices.size() / 3)) + " tris error";
+        reporter.Report(label.c_str(), lod.error, "units");
+    }
+}
+
+BENCHMARK(SimplifyMeshBatch)
+{
+    // A batch of half million triangle meshes, the kind of work a content import produces.
+    const int MeshCount = 16;
+    std::vector<s_mesh_data_t> source;
+
+    for (int i = 0; i < MeshCount; ++i)
+    {
+        source.push_back(BenchmarkMeshes::MakeSphere(400 + i * 4, 600));
+    }
+
+    double triangleCount = 0.0;
+
+    for (const s_mesh_data_t& mesh : source)
+    {
+        triangleCount += static_cast<double>(mesh.indices.size() / 3);
+    }
+
+    reporter.Report("triangles", triangleCount, "tris");
+
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    double seconds[2] = { 0.0, 0.0 };
+    const unsigned int threadCounts[2] = { 1, hardwareThreads };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        std::vector<s_mesh_data_t> meshes = source;
+        std::vector<s_mesh_data_t *> batch;
+
+        for (s_mesh_data_t& mesh : meshes)
+        {
+            batch.push_back(&mesh);
+        }
+
+        std::string label = "LOD chains, " + std::to_string(static_cast<unsigned long long>(threadCounts[i])) + " threads";
+        BenchmarkReporter::Stopwatch stopwatch;
+
+        reporter.TimeOnce(label.c_str(), triangleCount, "tris", [&]() {
+            MeshSimplifier::GenerateLods(batch, LodRatios(), threadCounts[i]);
+        });
+
+        seconds[i] = stopwatch.ElapsedSeconds();
+    }
+
+    reporter.Report("parallel speedup", seconds[0] / seconds[1], "x");
+}
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BinaryBlob.h"
+#include "StreamReader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t FileMegabytes = 64;
+    const size_t ValueCount = FileMegabytes * 1024 * 1024 / sizeof(float);
+    const char * StreamFile = "StreamReaderBenchmark.bin";
+
+    struct stream_file_t
+    {
+        stream_file_t()
+        {
+            std::vector<float> values(ValueCount);
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                values[i] = static_cast<float>(i % 1000) * 0.25f;
+            }
+
+            std::ofstream stream(StreamFile, std::ios::binary);
+            stream.write(reinterpret_cast<const char *>(&values[0]), values.size() * sizeof(float));
+        }
+
+        ~stream_file_t()
+        {
+            std::remove(StreamFile);
+        }
+    };
+
+    // Stand in for a parser: read the file as floats, a small value at a time.
+    double ParseStream(StreamReader& reader)
+    {
+        double sum = 0.0;
+
+        for (size_t i = 0; i < ValueCount; ++i)
+        {
+            sum += reader.Read<float>();
+        }
+
+        return sum;
+    }
+
+    double ParseBlob(const BinaryBlob& blob)
+    {
+        const char * pData = blob.BufferPointer();
+        double sum = 0.0;
+
+        for (size_t i = 0; i < ValueCount; ++i)
+        {
+            float value;
+            std::memcpy(&value, pData + i * sizeof(float), sizeof(float));
+            sum += value;
+        }
+
+        return sum;
+    }
+}
+
+// The file was just written so it is in the OS file cache, which hides the disk latency read ahead exists to overlap.
+// What remains is the cost of chunked reads against a whole file mapping, and how much memory each approach holds.
+BENCHMARK(StreamedReads)
+{
+    stream_file_t file;
+    const std::wstring filepath(StreamFile, StreamFile + std::strlen(StreamFile));
+    const double bytes = static_cast<double>(ValueCount * sizeof(float));
+
+    reporter.Time("whole file blob", 5, bytes, "B", [&]() {
+        BinaryBlob blob = BinaryBlob::LoadFromFile(filepath);
+        double sum = ParseBlob(blob);
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    size_t syncBuffered = 0;
+    size_t readAheadBuffered = 0;
+
+    reporter.Time("stream, no read ahead", 5, bytes, "B", [&]() {
+        StreamReader reader(filepath, StreamReader::DefaultChunkSize, false);
+        double sum = ParseStream(reader);
+
+        syncBuffered = reader.BufferedBytes();
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    reporter.Time("stream, read ahead", 5, bytes, "B", [&]() {
+        StreamReader reader(filepath);
+        double sum = ParseStream(reader);
+
+        readAheadBuffered = reader.BufferedBytes();
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    // Tiny windows make nearly every read cross a boundary, the worst case for the slow path.
+    reporter.Time("stream, 64 byte windows", 3, bytes, "B", [&]() {
+        StreamReader reader(filepath, 64, false);
+        double sum = ParseStream(reader);
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    reporter.Report("blob memory", bytes / 1024.0, "KB");
+    reporter.Report("stream memory, no read ahead", static_cast<double>(syncBuffered) / 1024.0, "KB");
+    reporter.Report("stream memory, read ahead", static_cast<double>(readAheadBuffered) / 1024.0, "KB");
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "TextEncoding.h"
+
+#include <codecvt>
+#include <locale>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    const size_t TextBytes = 4 * 1024 * 1024;
+    const size_t PathCount = 20000;
+
+    // Standard library conversion for comparison, matching the platform's wide encoding.
+    typedef std::conditional<
+        sizeof(wchar_t) == 2,
+        std::codecvt_utf8_utf16<wchar_t>,
+        std::codecvt_utf8<wchar_t>>::type standard_codecvt_t;
+
+    std::string RepeatToSize(const std::string& text)
+    {
+        std::string result;
+        result.reserve(TextBytes + text.size());
+
+        while (result.size() < TextBytes)
+        {
+            result += text;
+        }
+
+        return result;
+    }
+
+    // Asset paths, the common case in the engine.
+    std::vector<std::string> MakePaths()
+    {
+        std::vector<std::string> paths;
+
+        for (size_t i = 0; i < PathCount; ++i)
+        {
+            paths.push_back("Assets/Models/Environment/Props/crate_" + std::to_string(i) + "_lod0.mesh");
+        }
+
+        return paths;
+    }
+
+    void TimeText(BenchmarkReporter& reporter, const char * pName, const std::string& narrow)
+    {
+        const std::wstring wide = TextEncoding::Utf8ToWide(narrow);
+        const double bytes = static_cast<double>(narrow.size());
+        const std::string prefix(pName);
+        std::wstring_convert<standard_codecvt_t> standard;
+
+        reporter.Time((prefix + ", utf8 to wide").c_str(), 10, bytes, "B", [&]() {
+            std::wstring result = TextEncoding::Utf8ToWide(narrow);
+            Benchmark::DoNotOptimize(result.data());
+        });
+
+        reporter.Time((prefix + ", utf8 to wide, codecvt").c_str(), 3, bytes, "B", [&]() {
+            std::wstring result = standard.from_bytes(narrow);
+            Benchmark::DoNotOptimize(result.data());
+        });
+
+        reporter.Time((prefix + ", wide to utf8").c_str(), 10, bytes, "B", [&]() {
+            std::string result = TextEncoding::WideToUtf8(wide);
+            Benchmark::DoNotOptimize(result.data());
+        });
+
+        reporter.Time((prefix + ", wide to utf8, codecvt").c_str(), 3, bytes, "B", [&]() {
+            std::string result = standard.to_bytes(wide);
+            Benchmark::DoNotOptimize(result.data());
+        });
+    }
+}
+
+BENCHMARK(TextEncodingThroughput)
+{
+    // Mostly ASCII with the odd accented character, like log output or a localized English string table.
+    TimeText(reporter, "ascii heavy", RepeatToSize(
+        "The quick brown fox jumps over the lazy dog, then takes a caf\xC3\xA9 break near the river bank. "));
+
+    // Japanese text, three bytes per character with ASCII punctuation only every so often.
+    TimeText(reporter, "cjk heavy", RepeatToSize(
+        "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x81\xAE\xE6\x96\x87\xE7\xAB\xA0\xE3\x81\xA7\xE3\x81\x99"
+        "\xE3\x80\x82\xE6\x9D\xB1\xE4\xBA\xAC\xE3\x81\xA8\xE5\xA4\xA7\xE9\x98\xAA. "));
+
+    // Lots of short conversions, where the per call overhead matters more than the per byte cost.
+    const std::vector<std::string> paths = MakePaths();
+
+    reporter.Time("asset paths, utf8 to wide", 10, static_cast<double>(paths.size()), "paths", [&]() {
+        for (const std::string& path : paths)
+        {
+            std::wstring result = TextEncoding::Utf8ToWide(path);
+            Benchmark::DoNotOptimize(result.data());
+        }
+    });
+}
@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "TextFormat.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    const unsigned int MessageCount = 100000;
+
+    // Utils::MakeString as it was before it moved onto BasicFormatBuffer.
+    template<typename C>
+    class StreamMakeString
+    {
+    public:
+        template <typename T>
+        StreamMakeString& operator<<(const T& value)
+        {
+            mBuffer << value;
+            return *this;
+        }
+
+        operator std::basic_string<C>() const
+        {
+            return mBuffer.str();
+        }
+
+    private:
+        std::basic_ostringstream<C> mBuffer;
+    };
+
+    // The kind of message an exception or log line is built from.
+    template<typename Buffer>
+    std::wstring FormatWideMessage(unsigned int i)
+    {
+        return Buffer() << L"Expected " << i << L" vertices in model_" << i % 97 << L".mesh, found " << i / 3;
+    }
+
+    template<typename Buffer>
+    std::string FormatFloatMessage(unsigned int i)
+    {
+        const float x = static_cast<float>(i) * 0.125f - 3.7f;
+        return Buffer() << "position " << x << ", " << x * 0.5f << ", " << x / 3.0f << " scale " << i * 1e-6;
+    }
+}
+
+BENCHMARK(StringFormatting)
+{
+    const double count = static_cast<double>(MessageCount);
+
+    reporter.Time("wide message, format buffer", 5, count, "strings", [&]() {
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            std::wstring message = FormatWideMessage<WideFormatBuffer>(i);
+            Benchmark::DoNotOptimize(message.data());
+        }
+    });
+
+    reporter.Time("wide message, wostringstream", 5, count, "strings", [&]() {
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            std::wstring message = FormatWideMessage<StreamMakeString<wchar_t>>(i);
+            Benchmark::DoNotOptimize(message.data());
+        }
+    });
+
+    reporter.Time("float message, format buffer", 5, count, "strings", [&]() {
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            std::string message = FormatFloatMessage<FormatBuffer>(i);
+            Benchmark::DoNotOptimize(message.data());
+        }
+    });
+
+    reporter.Time("float message, ostringstream", 5, count, "strings", [&]() {
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            std::string message = FormatFloatMessage<StreamMakeString<char>>(i);
+            Benchmark::DoNotOptimize(message.data());
+        }
+    });
+
+    // Formatting alone, without building a std::string at the end.
+    reporter.Time("doubles, FormatDouble", 5, count, "numbers", [&]() {
+        char text[TextFormat::MaxNumberChars];
+
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            size_t length = TextFormat::FormatDouble(static_cast<double>(i) * 1.0001 + 0.3, text);
+            Benchmark::DoNotOptimize(&length);
+        }
+    });
+
+    reporter.Time("doubles, snprintf %.17g", 5, count, "numbers", [&]() {
+        char text[32];
+
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            int length = std::snprintf(text, sizeof(text), "%.17g", static_cast<double>(i) * 1.0001 + 0.3);
+            Benchmark::DoNotOptimize(&length);
+        }
+    });
+
+    reporter.Time("integers, FormatInt", 5, count, "numbers", [&]() {
+        char text[TextFormat::MaxNumberChars];
+
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            size_t length = TextFormat::FormatInt(static_cast<long long>(i) * 7919 - 400000000, text);
+            Benchmark::DoNotOptimize(&length);
+        }
+    });
+
+    reporter.Time("integers, snprintf %lld", 5, count, "numbers", [&]() {
+        char text[32];
+
+        for (unsigned int i = 0; i < MessageCount; ++i)
+        {
+            int length = std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(i) * 7919 - 400000000);
+            Benchmark::DoNotOptimize(&length);
+        }
+    });
+}
@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BenchmarkMeshes.h"
+#include "MeshData.h"
+#include "TextModelFile.h"
+#include "TextUtils.h"
+#include "Utils.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t NumberCount = 200000;
+
+    // The text model parse as it was written before the tokenizer, copying the text into a string stream and
+    // extracting every field with operator >>.
+    void StreamParseTextModel(const std::vector<char>& text, s_mesh_data_t *pMeshOut)
+    {
+        std::istringstream stream(std::string(text.data(), text.size()));
+        std::string tag;
+        size_t vertexCount = 0, indexCount = 0;
+
+        stream >> tag >> vertexCount >> indexCount;
+        pMeshOut->vertices.resize(vertexCount);
+        pMeshOut->indices.resize(indexCount);
+
+        for (s_mesh_vertex_t& v : pMeshOut->vertices)
+        {
+            stream >> v.x >> v.y >> v.z >> v.tu >> v.tv >> v.nx >> v.ny >> v.nz;
+        }
+
+        for (int& index : pMeshOut->indices)
+        {
+            stream >> index;
+        }
+    }
+
+    std::string MakeNumbers()
+    {
+        std::string text;
+
+        for (size_t i = 0; i < NumberCount; ++i)
+        {
+            text += std::to_string(static_cast<double>(i) * 0.731 - 5000.0) + " ";
+        }
+
+        return text;
+    }
+}
+
+BENCHMARK(TextParsing)
+{
+    // A text model the size of a detailed prop, parsed the new way and the old way.
+    const std::vector<char> model = BenchmarkMeshes::MakeTextModel(BenchmarkMeshes::MakeSphere(96, 160));
+    const double modelBytes = static_cast<double>(model.size());
+
+    reporter.Time("text model, tokenizer", 5, modelBytes, "B", [&]() {
+        s_mesh_data_t mesh;
+        TextModelFile::Read(model.data(), model.size(), L"bench.model", &mesh);
+        Benchmark::DoNotOptimize(mesh.vertices.data());
+    });
+
+    reporter.Time("text model, istringstream", 5, modelBytes, "B", [&]() {
+        s_mesh_data_t mesh;
+        StreamParseTextModel(model, &mesh);
+        Benchmark::DoNotOptimize(mesh.vertices.data());
+    });
+
+    // Float fields on their own.
+    const std::string numbers = MakeNumbers();
+    const double count = static_cast<double>(NumberCount);
+
+    reporter.Time("floats, ParseFloat", 10, count, "numbers", [&]() {
+        float sum = 0.0f, value = 0.0f;
+        TextUtils::Tokenizer tokens(numbers);
+
+        while (tokens.NextFloat(&value)) { sum += value; }
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    reporter.Time("floats, strtod", 10, count, "numbers", [&]() {
+        float sum = 0.0f;
+        const char * pText = numbers.c_str();
+        char * pEnd = nullptr;
+
+        for (double value = std::strtod(pText, &pEnd); pEnd != pText; value = std::strtod(pText, &pEnd))
+        {
+            sum += static_cast<float>(value);
+            pText = pEnd;
+        }
+
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    reporter.Time("floats, istringstream", 10, count, "numbers", [&]() {
+        float sum = 0.0f, value = 0.0f;
+        std::istringstream stream(numbers);
+
+        while (stream >> value) { sum += value; }
+        Benchmark::DoNotOptimize(&sum);
+    });
+
+    // Trimming every line of the model, in place versus into a new string.
+    reporter.Time("trim lines, view", 10, modelBytes, "B", [&]() {
+        size_t total = 0;
+        StringView line;
+        TextUtils::Tokenizer lines(StringView(model.data(), model.size()), "\n");
+
+        while (lines.Next(&line)) { total += TextUtils::Trim(line).Size(); }
+        Benchmark::DoNotOptimize(&total);
+    });
+
+    reporter.Time("trim lines, string copy", 10, modelBytes, "B", [&]() {
+        size_t total = 0;
+        StringView line;
+        TextUtils::Tokenizer lines(StringView(model.data(), model.size()), "\n");
+
+        while (lines.Next(&line)) { total += Utils::Trim(line.ToString()).size(); }
+        Benchmark::DoNotOptimize(&total);
+    });
+}
@@ -0,0 +1,167 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "BoundingVolumes.h"
+#include "TransformKernels.h"
+
+#include <vector>
+
+namespace
+{
+    const size_t ElementCount = 64 * 1024;
+    const size_t MatrixCount = 16 * 1024;
+
+    const float TestMatrix[16] =
+    {
+        1.7320508f, 0.0f, -1.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.25f, 0.0f, 0.4330127f, 0.0f,
+        10.0f, -5.0f, 2.5f, 1.0f
+    };
+
+    struct point_t
+    {
+        float x, y, z;
+    };
+
+    struct soa_buffer_t
+    {
+        explicit soa_buffer_t(size_t count)
+            : x(count), y(count), z(count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                x[i] = static_cast<float>(i % 100) * 0.1f;
+                y[i] = static_cast<float>(i % 37) - 18.0f;
+                z[i] = static_cast<float>(i % 11) * 2.0f;
+            }
+        }
+
+        soa_vectors_t View() { soa_vectors_t view = { x.data(), y.data(), z.data() }; return view; }
+
+        std::vector<float> x, y, z;
+    };
+}
+
+BENCHMARK(BatchTransforms)
+{
+    const double count = static_cast<double>(ElementCount);
+    const float * m = TestMatrix;
+
+    soa_buffer_t points(ElementCount), transformed(ElementCount);
+    std::vector<point_t> aosPoints(ElementCount), aosTransformed(ElementCount);
+
+    for (size_t i = 0; i < ElementCount; ++i)
+    {
+        point_t point = { points.x[i], points.y[i], points.z[i] };
+        aosPoints[i] = point;
+    }
+
+    // One point at a time, the way Vector3::Transform is used today.
+    reporter.Time("points, one at a time", 200, count, "points", [&]() {
+        for (size_t i = 0; i < ElementCount; ++i)
+        {
+            const point_t& p = aosPoints[i];
+
+            aosTransformed[i].x = p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12];
+            aosTransformed[i].y = p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13];
+            aosTransformed[i].z = p.x * m[2] + p.y * m[6] + p.z * m[10] + m[14];
+        }
+
+        Benchmark::DoNotOptimize(aosTransformed.data());
+    });
+
+    reporter.Time("points, TransformPoints", 200, count, "points", [&]() {
+        TransformKernels::TransformPoints(m, points.View(), transformed.View(), ElementCount);
+        Benchmark::DoNotOptimize(transformed.x.data());
+    });
+
+    reporter.Time("normals, TransformNormals", 200, count, "normals", [&]() {
+        TransformKernels::TransformNormals(m, points.View(), transformed.View(), ElementCount);
+        Benchmark::DoNotOptimize(transformed.x.data());
+    });
+
+    // Bounds, as BoundingVolumes does them one at a time and as a batch.
+    soa_buffer_t boxMax(ElementCount), outMin(ElementCount), outMax(ElementCount);
+    std::vector<aabb_t> boxes(ElementCount), outBoxes(ElementCount);
+    std::vector<bounding_sphere_t> spheres(ElementCount), outSpheres(ElementCount);
+    std::vector<float> radii(ElementCount, 1.5f), outRadii(ElementCount);
+
+    for (size_t i = 0; i < ElementCount; ++i)
+    {
+        boxMax.x[i] = points.x[i] + 1.0f;
+        boxMax.y[i] = points.y[i] + 2.0f;
+        boxMax.z[i] = points.z[i] + 0.5f;
+
+        const aabb_t box = { { points.x[i], points.y[i], points.z[i] }, { boxMax.x[i], boxMax.y[i], boxMax.z[i] } };
+        const bounding_sphere_t sphere = { { points.x[i], points.y[i], points.z[i] }, radii[i] };
+
+        boxes[i] = box;
+        spheres[i] = sphere;
+    }
+
+    reporter.Time("boxes, BoundingVolumes::TransformAabb", 100, count, "boxes", [&]() {
+        for (size_t i = 0; i < ElementCount; ++i)
+        {
+            outBoxes[i] = BoundingVolumes::TransformAabb(boxes[i], m);
+        }
+
+        Benchmark::DoNotOptimize(outBoxes.data());
+    });
+
+    reporter.Time("boxes, TransformAabbs", 100, count, "boxes", [&]() {
+        const soa_aabbs_t in = { points.View(), boxMax.View() };
+        const soa_aabbs_t out = { outMin.View(), outMax.View() };
+
+        TransformKernels::TransformAabbs(m, in, out, ElementCount);
+        Benchmark::DoNotOptimize(outMin.x.data());
+    });
+
+    reporter.Time("spheres, BoundingVolumes::TransformSphere", 100, count, "spheres", [&]() {
+        for (size_t i = 0; i < ElementCount; ++i)
+        {
+            outSpheres[i] = BoundingVolumes::TransformSphere(spheres[i], m);
+        }
+
+        Benchmark::DoNotOptimize(outSpheres.data());
+    });
+
+    reporter.Time("spheres, TransformSpheres", 100, count, "spheres", [&]() {
+        const soa_spheres_t in = { points.View(), radii.data() };
+        const soa_spheres_t out = { outMin.View(), outRadii.data() };
+
+        TransformKernels::TransformSpheres(m, in, out, ElementCount);
+        Benchmark::DoNotOptimize(outRadii.data());
+    });
+
+    // World times view-projection for every object.
+    std::vector<float> worlds(MatrixCount * 16), combined(MatrixCount * 16);
+
+    for (size_t k = 0; k < worlds.size(); ++k)
+    {
+        worlds[k] = static_cast<float>(k % 13) * 0.25f - 1.0f;
+    }
+
+    reporter.Time("matrices, scalar loop", 100, static_cast<double>(MatrixCount), "matrices", [&]() {
+        for (size_t i = 0; i < MatrixCount; ++i)
+        {
+            const float * a = &worlds[i * 16];
+            float * r = &combined[i * 16];
+
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    r[row * 4 + column] = a[row * 4] * m[column] + a[row * 4 + 1] * m[4 + column] +
+                                          a[row * 4 + 2] * m[8 + column] + a[row * 4 + 3] * m[12 + column];
+                }
+            }
+        }
+
+        Benchmark::DoNotOptimize(combined.data());
+    });
+
+    reporter.Time("matrices, MultiplyMatrices", 100, static_cast<double>(MatrixCount), "matrices", [&]() {
+        TransformKernels::MultiplyMatrices(worlds.data(), m, combined.data(), MatrixCount);
+        Benchmark::DoNotOptimize(combined.data());
+    });
+}
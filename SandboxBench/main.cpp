@@ -0,0 +1,36 @@
+#include "stdafx.h"
+#include "Benchmark.h"
+#include "DXTestException.h"
+#include "Utils.h"
+
+#include <cstdio>
+#include <string>
+
+// Usage: SandboxBench [filter]
+//  Runs every benchmark whose name contains filter. Build and run in Release, the numbers are meaningless otherwise.
+int main(int argc, char ** argv)
+{
+    std::string filter = (argc > 1 ? argv[1] : "");
+
+#ifdef _DEBUG
+    std::printf("WARNING: Debug build, timings are not representative.\n");
+#endif
+
+    try
+    {
+        unsigned int runCount = Benchmark::RunAll(filter);
+
+        if (runCount == 0)
+        {
+            std::printf("No benchmarks matched '%s'\n", filter.c_str());
+            return 1;
+        }
+    }
+    catch (const SandboxException& e)
+    {
+        std::printf("Benchmark failed: %s\n", Utils::ConvertUtf16ToUtf8(e.Message()).c_str());
+        return 2;
+    }
+
+    return 0;
+}
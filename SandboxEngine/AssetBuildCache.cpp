@@ -0,0 +1,652 @@
+#include "stdafx.h"
+#include "AssetBuildCache.h"
+#include "BinaryBlob.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "Stopwatch.h"
+#include "TextEncoding.h"
+#include "TextFormat.h"
+#include "TextUtils.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <set>
+#include <thread>
+
+#ifndef _WIN32
+#   include <dirent.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace
+{
+    const char ManifestTag[] = "SandboxAssetCache";
+    const unsigned int ManifestVersion = 1;
+    const wchar_t ArtifactExtension[] = L".artifact";
+    const wchar_t TempExtension[] = L".tmp";
+
+    std::atomic<unsigned int> GTempFileCounter(0);
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // File system helpers
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+    // Size of a file in bytes, or -1 if it does not exist.
+    long long FileSize(const std::wstring& filepath)
+    {
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+        if (!GetFileAttributesExW(filepath.c_str(), GetFileExInfoStandard, &attributes) ||
+            (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        {
+            return -1;
+        }
+
+        return (static_cast<long long>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    }
+
+    bool MakeDirectory(const std::wstring& directory)
+    {
+        return CreateDirectoryW(directory.c_str(), nullptr) != 0 || GetLastError() == ERROR_ALREADY_EXISTS;
+    }
+
+    bool DeleteDirectory(const std::wstring& directory)
+    {
+        return RemoveDirectoryW(directory.c_str()) != 0;
+    }
+
+    bool RemoveFile(const std::wstring& filepath)
+    {
+        return DeleteFileW(filepath.c_str()) != 0;
+    }
+
+    bool RenameFile(const std::wstring& from, const std::wstring& to)
+    {
+        return MoveFileW(from.c_str(), to.c_str()) != 0;
+    }
+
+    // Names of the files (not directories) in a directory.
+    void ListFiles(const std::wstring& directory, std::vector<std::wstring> *pNamesOut)
+    {
+        WIN32_FIND_DATAW findData;
+        HANDLE find = FindFirstFileW((directory + L"\\*").c_str(), &findData);
+
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        do
+        {
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            {
+                pNamesOut->push_back(findData.cFileName);
+            }
+        } while (FindNextFileW(find, &findData));
+
+        FindClose(find);
+    }
+#else
+    std::string NativePath(const std::wstring& path)
+    {
+        std::string nativePath = Utils::ConvertUtf16ToUtf8(path);
+        std::replace(nativePath.begin(), nativePath.end(), '\\', '/');
+
+        return nativePath;
+    }
+
+    long long FileSize(const std::wstring& filepath)
+    {
+        struct stat status;
+
+        if (stat(NativePath(filepath).c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            return -1;
+        }
+
+        return static_cast<long long>(status.st_size);
+    }
+
+    bool MakeDirectory(const std::wstring& directory)
+    {
+        struct stat status;
+        std::string nativePath = NativePath(directory);
+
+        return mkdir(nativePath.c_str(), 0755) == 0 ||
+               (stat(nativePath.c_str(), &status) == 0 && S_ISDIR(status.st_mode));
+    }
+
+    bool DeleteDirectory(const std::wstring& directory)
+    {
+        return rmdir(NativePath(directory).c_str()) == 0;
+    }
+
+    bool RemoveFile(const std::wstring& filepath)
+    {
+        return unlink(NativePath(filepath).c_str()) == 0;
+    }
+
+    bool RenameFile(const std::wstring& from, const std::wstring& to)
+    {
+        // Match Windows, which refuses to replace an existing file.
+        return FileSize(to) < 0 && std::rename(NativePath(from).c_str(), NativePath(to).c_str()) == 0;
+    }
+
+    void ListFiles(const std::wstring& directory, std::vector<std::wstring> *pNamesOut)
+    {
+        DIR * pDirectory = opendir(NativePath(directory).c_str());
+
+        if (pDirectory == nullptr)
+        {
+            return;
+        }
+
+        while (const dirent * pEntry = readdir(pDirectory))
+        {
+            std::wstring name = Utils::ConvertUtf8ToWString(pEntry->d_name);
+
+            if (FileSize(directory + L"/" + name) >= 0)
+            {
+                pNamesOut->push_back(name);
+            }
+        }
+
+        closedir(pDirectory);
+    }
+#endif
+
+    void SaveFile(const std::wstring& filepath, const char * pData, size_t size)
+    {
+        std::ofstream outputStream(filepath.c_str(), std::ios::binary);
+
+        if (!outputStream.is_open())
+        {
+            throw FileSaveException(filepath);
+        }
+
+        outputStream.write(pData, static_cast<std::streamsize>(size));
+
+        if (!outputStream)
+        {
+            throw FileSaveException(filepath);
+        }
+    }
+
+    std::wstring ParentDirectory(const std::wstring& filepath)
+    {
+        size_t separator = filepath.find_last_of(L"\\/");
+        return separator == std::wstring::npos ? std::wstring() : filepath.substr(0, separator);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // xxHash64
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    const unsigned long long Prime1 = 11400714785074694791ull;
+    const unsigned long long Prime2 = 14029467366897019727ull;
+    const unsigned long long Prime3 = 1609587929392839161ull;
+    const unsigned long long Prime4 = 9650029242287828579ull;
+    const unsigned long long Prime5 = 2870177450012600261ull;
+
+    unsigned long long RotateLeft(unsigned long long value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    unsigned long long Read64(const char * p)
+    {
+        unsigned long long value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    unsigned int Read32(const char * p)
+    {
+        unsigned int value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    unsigned long long Round(unsigned long long accumulator, unsigned long long input)
+    {
+        accumulator += input * Prime2;
+        return RotateLeft(accumulator, 31) * Prime1;
+    }
+
+    unsigned long long MergeRound(unsigned long long accumulator, unsigned long long value)
+    {
+        accumulator ^= Round(0, value);
+        return accumulator * Prime1 + Prime4;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// asset_build_stats_t
+///////////////////////////////////////////////////////////////////////////////////////////////////
+asset_build_stats_t::asset_build_stats_t()
+    : stepCount(0),
+      upToDateCount(0),
+      cacheHitCount(0),
+      builtCount(0),
+      seconds(0.0)
+{
+}
+
+double asset_build_stats_t::HitRate() const
+{
+    if (stepCount == 0)
+    {
+        return 1.0;
+    }
+
+    return static_cast<double>(upToDateCount + cacheHitCount) / static_cast<double>(stepCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AssetBuildCache
+///////////////////////////////////////////////////////////////////////////////////////////////////
+AssetBuildCache::AssetBuildCache(const std::wstring& cacheDirectory)
+    : mCacheDirectory(cacheDirectory),
+      mOutputs(),
+      mMutex()
+{
+    Verify(!cacheDirectory.empty());
+
+    CreateDirectories(mCacheDirectory);
+    LoadManifest();
+}
+
+AssetBuildCache::~AssetBuildCache()
+{
+}
+
+asset_build_stats_t AssetBuildCache::Build(const std::vector<asset_build_step_t>& steps, unsigned int threadCount)
+{
+    Stopwatch stopwatch;
+    CreateDirectories(mCacheDirectory);
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, steps.size()));
+
+    // Workers pull the next step off a shared counter. Exceptions are carried back to the calling thread, after
+    // the manifest has been saved so the steps that did build are not built again.
+    std::vector<StepResult> results(steps.size(), StepResult::UpToDate);
+    std::vector<char> finished(steps.size(), 0);
+    std::atomic<size_t> nextStep(0);
+    std::vector<std::exception_ptr> errors(std::max(threadCount, 1u));
+
+    auto work = [&](unsigned int t) {
+        try
+        {
+            for (size_t i = nextStep++; i < steps.size(); i = nextStep++)
+            {
+                results[i] = BuildStep(steps[i]);
+                finished[i] = 1;
+            }
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+            nextStep = steps.size();
+        }
+    };
+
+    if (threadCount <= 1)
+    {
+        work(0);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+
+        for (unsigned int t = 0; t < threadCount; ++t)
+        {
+            workers.push_back(std::thread(work, t));
+        }
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    SaveManifest();
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    asset_build_stats_t stats;
+    stats.stepCount = steps.size();
+
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        switch (results[i])
+        {
+        case StepResult::UpToDate: stats.upToDateCount++; break;
+        case StepResult::CacheHit: stats.cacheHitCount++; break;
+        case StepResult::Built: stats.builtCount++; break;
+        }
+    }
+
+    stats.seconds = stopwatch.ElapsedSeconds();
+    return stats;
+}
+
+AssetBuildCache::StepResult AssetBuildCache::BuildStep(const asset_build_step_t& step)
+{
+    Verify(!step.output.empty());
+
+    // Hash the inputs.
+    std::vector<BinaryBlob> inputs;
+    std::vector<unsigned long long> inputHashes;
+
+    inputs.reserve(step.inputs.size());
+    inputHashes.reserve(step.inputs.size());
+
+    for (const std::wstring& input : step.inputs)
+    {
+        inputs.push_back(BinaryBlob::LoadFromFile(input));
+
+        const BinaryBlob& blob = inputs.back();
+        inputHashes.push_back(HashBytes(blob.BufferPointer(), static_cast<size_t>(blob.BufferSize())));
+    }
+
+    const unsigned long long key = StepKey(step, inputHashes);
+
+    // Nothing to do if the output was last written from the same key and is still there.
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto record = mOutputs.find(step.output);
+
+        if (record != mOutputs.end() &&
+            record->second.key == key &&
+            FileSize(step.output) == static_cast<long long>(record->second.size))
+        {
+            return StepResult::UpToDate;
+        }
+    }
+
+    std::wstring outputDirectory = ParentDirectory(step.output);
+
+    if (!outputDirectory.empty())
+    {
+        CreateDirectories(outputDirectory);
+    }
+
+    // Restore the output from the cache, or convert it and add it to the cache.
+    const std::wstring artifactPath = ArtifactPath(key);
+    StepResult result = StepResult::Built;
+    std::vector<char> output;
+
+    if (FileSize(artifactPath) >= 0)
+    {
+        BinaryBlob artifact = BinaryBlob::LoadFromFile(artifactPath);
+
+        output.assign(artifact.BufferPointer(), artifact.BufferPointer() + artifact.BufferSize());
+        result = StepResult::CacheHit;
+    }
+    else
+    {
+        Verify(static_cast<bool>(step.convert));
+        step.convert(inputs, &output);
+
+        // Write under a temporary name first so an interrupted build never leaves a partial artifact behind. If
+        // another step with the same key got there first the artifacts are identical, keep either.
+        std::wstring tempPath = artifactPath + L"." + std::to_wstring(GTempFileCounter++) + TempExtension;
+        SaveFile(tempPath, output.empty() ? nullptr : &output[0], output.size());
+
+        if (!RenameFile(tempPath, artifactPath))
+        {
+            RemoveFile(tempPath);
+        }
+    }
+
+    SaveFile(step.output, output.empty() ? nullptr : &output[0], output.size());
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    output_record_t& record = mOutputs[step.output];
+    record.key = key;
+    record.size = output.size();
+
+    return result;
+}
+
+size_t AssetBuildCache::Prune()
+{
+    std::set<std::wstring> referenced;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (const auto& output : mOutputs)
+        {
+            referenced.insert(ArtifactPath(output.second.key));
+        }
+    }
+
+    std::vector<std::wstring> names;
+    ListFiles(mCacheDirectory, &names);
+
+    size_t removed = 0;
+
+    for (const std::wstring& name : names)
+    {
+        std::wstring filepath = mCacheDirectory + L"/" + name;
+        bool isArtifact = Utils::EndsWith(name, ArtifactExtension);
+
+        if ((isArtifact && referenced.count(filepath) == 0) || Utils::EndsWith(name, TempExtension))
+        {
+            removed += RemoveFile(filepath) ? 1 : 0;
+        }
+    }
+
+    return removed;
+}
+
+void AssetBuildCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::wstring> names;
+
+    ListFiles(mCacheDirectory, &names);
+
+    for (const std::wstring& name : names)
+    {
+        RemoveFile(mCacheDirectory + L"/" + name);
+    }
+
+    DeleteDirectory(mCacheDirectory);
+    mOutputs.clear();
+}
+
+unsigned long long AssetBuildCache::HashBytes(const char * pData, size_t size, unsigned long long seed)
+{
+    Verify(pData != nullptr || size == 0);
+
+    const char * p = pData;
+    const char * pEnd = pData + size;
+    unsigned long long hash;
+
+    if (size >= 32)
+    {
+        unsigned long long v1 = seed + Prime1 + Prime2;
+        unsigned long long v2 = seed + Prime2;
+        unsigned long long v3 = seed;
+        unsigned long long v4 = seed - Prime1;
+
+        for (; p + 32 <= pEnd; p += 32)
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+        }
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += size;
+
+    for (; p + 8 <= pEnd; p += 8)
+    {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+
+    if (p + 4 <= pEnd)
+    {
+        hash ^= static_cast<unsigned long long>(Read32(p)) * Prime1;
+        hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+        p += 4;
+    }
+
+    for (; p < pEnd; ++p)
+    {
+        hash ^= static_cast<unsigned char>(*p) * Prime5;
+        hash = RotateLeft(hash, 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+unsigned long long AssetBuildCache::StepKey(
+    const asset_build_step_t& step,
+    const std::vector<unsigned long long>& inputHashes)
+{
+    // Strings are zero terminated so "ab" + "c" and "a" + "bc" hash differently.
+    std::string description = step.tool;
+    description.push_back('\0');
+    description.append(reinterpret_cast<const char *>(&step.toolVersion), sizeof(step.toolVersion));
+    description.append(step.options);
+    description.push_back('\0');
+
+    for (unsigned long long hash : inputHashes)
+    {
+        description.append(reinterpret_cast<const char *>(&hash), sizeof(hash));
+    }
+
+    return HashBytes(description.data(), description.size());
+}
+
+void AssetBuildCache::CreateDirectories(const std::wstring& directory)
+{
+    // Create each parent in turn, skipping a leading drive letter or root.
+    for (size_t separator = directory.find_first_of(L"\\/", 1);
+         separator != std::wstring::npos;
+         separator = directory.find_first_of(L"\\/", separator + 1))
+    {
+        std::wstring parent = directory.substr(0, separator);
+
+        if (!parent.empty() && parent.back() != L':' && parent != L"." && parent != L"..")
+        {
+            MakeDirectory(parent);
+        }
+    }
+
+    if (!MakeDirectory(directory))
+    {
+        throw FileSaveException(directory);
+    }
+}
+
+std::wstring AssetBuildCache::ArtifactPath(unsigned long long key) const
+{
+    return WideFormatBuffer() << mCacheDirectory << L'/' << TextFormat::Hex(key, 16) << ArtifactExtension;
+}
+
+std::wstring AssetBuildCache::ManifestPath() const
+{
+    return mCacheDirectory + L"/manifest.txt";
+}
+
+void AssetBuildCache::LoadManifest()
+{
+    mOutputs.clear();
+
+    const std::wstring filepath = ManifestPath();
+
+    if (FileSize(filepath) <= 0)
+    {
+        return;
+    }
+
+    // "<tag> <version>", then "<key> <size> <output path>" per line. A manifest that does not parse is dropped,
+    // which costs one copy of every output out of the cache and nothing more. Lines are parsed in place, only the
+    // output paths are copied.
+    const BinaryBlob file = BinaryBlob::LoadFromFile(filepath);
+    TextUtils::Tokenizer lines(StringView(file.BufferPointer(), static_cast<size_t>(file.BufferSize())), "\r\n");
+    StringView line;
+    StringView header[2];
+    unsigned int version = 0;
+
+    if (!lines.Next(&line) ||
+        TextUtils::Split(line, ' ', header, 2) != 2 ||
+        header[0] != ManifestTag ||
+        !TextUtils::ParseUnsignedInt(header[1], &version) ||
+        version != ManifestVersion)
+    {
+        return;
+    }
+
+    while (lines.Next(&line))
+    {
+        StringView fields[3];
+        output_record_t record;
+        std::wstring output;
+
+        if (TextUtils::Split(line, ' ', fields, 3) == 3 &&
+            TextUtils::ParseHex(fields[0], &record.key) &&
+            TextUtils::ParseUnsignedInt(fields[1], &record.size) &&
+            !fields[2].IsEmpty() &&
+            TextEncoding::TryUtf8ToWide(fields[2].Data(), fields[2].Size(), &output, nullptr))
+        {
+            mOutputs[output] = record;
+        }
+    }
+}
+
+void AssetBuildCache::SaveManifest() const
+{
+    FormatBuffer manifest;
+    manifest << ManifestTag << ' ' << ManifestVersion << '\n';
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (const auto& output : mOutputs)
+        {
+            manifest << TextFormat::Hex(output.second.key) << ' ' << output.second.size << ' '
+                     << Utils::ConvertUtf16ToUtf8(output.first) << '\n';
+        }
+    }
+
+    SaveFile(ManifestPath(), manifest.Data(), manifest.Size());
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class BinaryBlob;
+
+/**
+ * \brief One output of an asset build and everything it depends on.
+ *
+ * The output is a pure function of the input file contents, the converter and its options. Bump toolVersion
+ * whenever a converter's output changes, so everything it built before is rebuilt.
+ */
+struct asset_build_step_t
+{
+    std::wstring output;
+    std::vector<std::wstring> inputs;
+    std::string tool;
+    unsigned int toolVersion;
+    std::string options;
+
+    // Produce the output from the contents of the inputs, in the same order as the inputs list.
+    std::function<void(const std::vector<BinaryBlob>& inputs, std::vector<char> *pOutput)> convert;
+};
+
+/**
+ * \brief What an AssetBuildCache::Build() call did.
+ */
+struct asset_build_stats_t
+{
+    size_t stepCount;
+    size_t upToDateCount;       // Output was already built from the same inputs, nothing written.
+    size_t cacheHitCount;       // Output copied from the cache without running the converter.
+    size_t builtCount;          // Converter ran.
+    double seconds;
+
+    asset_build_stats_t();
+
+    // Fraction of steps that did not have to run their converter.
+    double HitRate() const;
+};
+
+/**
+ * \brief Incremental asset builds keyed on the content of each output's inputs.
+ *
+ * Every step gets a 64 bit key hashed from its converter name, version and options and the contents of its inputs.
+ * Converted outputs are stored in the cache directory under their key, and the cache keeps a manifest of the key and
+ * size each output was last written with. Building a step then either:
+ *  - does nothing, if the output was last written from the same key and still has the same size,
+ *  - copies the cached artifact to the output, if any earlier build produced the same key (another branch, a
+ *    deleted output directory, an input changed and changed back),
+ *  - or runs the converter and adds the result to the cache.
+ *
+ * Inputs are always read and hashed, file times are never trusted, so a no-op build costs one read of every input.
+ * Independent steps run in parallel.
+ */
+class AssetBuildCache
+{
+public:
+    // Open or create a cache directory. Its parent directory must exist.
+    explicit AssetBuildCache(const std::wstring& cacheDirectory);
+    AssetBuildCache(const AssetBuildCache&) = delete;
+    ~AssetBuildCache();
+
+    AssetBuildCache& operator =(const AssetBuildCache&) = delete;
+
+    // Bring every step's output up to date on up to threadCount threads, zero for all hardware threads. Output
+    // directories are created as needed. If a step throws, the remaining steps are skipped, the manifest is saved
+    // with everything that did build and the first exception is rethrown.
+    asset_build_stats_t Build(const std::vector<asset_build_step_t>& steps, unsigned int threadCount = 0);
+
+    // Delete cached artifacts that no output in the manifest was built from. Returns the number deleted.
+    size_t Prune();
+
+    // Delete the cache directory and everything in it. The cache is empty but usable afterwards.
+    void Clear();
+
+    const std::wstring& CacheDirectory() const { return mCacheDirectory; }
+
+    // 64 bit content hash of a block of memory (xxHash64).
+    static unsigned long long HashBytes(const char * pData, size_t size, unsigned long long seed = 0);
+
+    // Key for a step given the content hashes of its inputs.
+    static unsigned long long StepKey(
+        const asset_build_step_t& step,
+        const std::vector<unsigned long long>& inputHashes);
+
+    // Create a directory and any missing parents. Both '\\' and '/' are separators.
+    static void CreateDirectories(const std::wstring& directory);
+
+private:
+    enum class StepResult { UpToDate, CacheHit, Built };
+
+    struct output_record_t
+    {
+        unsigned long long key;
+        unsigned long long size;
+    };
+
+    StepResult BuildStep(const asset_build_step_t& step);
+
+    std::wstring ArtifactPath(unsigned long long key) const;
+    std::wstring ManifestPath() const;
+
+    void LoadManifest();
+    void SaveManifest() const;
+
+private:
+    std::wstring mCacheDirectory;
+    std::map<std::wstring, output_record_t> mOutputs;
+    mutable std::mutex mMutex;
+};
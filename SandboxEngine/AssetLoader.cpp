@@ -0,0 +1,338 @@
+#include "stdafx.h"
+#include "AssetLoader.h"
+#include "DXSandbox.h"
+#include "Stopwatch.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace
+{
+    const size_t PageSize = 4096;
+
+    // Loose files are memory mapped and only read when their pages are first touched. Touch them all here so the
+    // read happens on the IO thread instead of stalling a decode thread.
+    void PageIn(const BinaryBlob& file)
+    {
+        const volatile char * pData = file.BufferPointer();
+        const size_t size = static_cast<size_t>(file.BufferSize());
+        char sum = 0;
+
+        for (size_t offset = 0; offset < size; offset += PageSize)
+        {
+            sum ^= pData[offset];
+        }
+
+        if (size > 0)
+        {
+            sum ^= pData[size - 1];
+        }
+
+        (void) sum;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Timings and requests.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+double asset_load_timings_t::QueuedSeconds() const
+{
+    double seconds = 0.0;
+
+    if (readStart > 0.0) { seconds += readStart - requested; }
+    if (decodeStart > 0.0) { seconds += decodeStart - readEnd; }
+    if (uploadStart > 0.0) { seconds += uploadStart - decodeEnd; }
+
+    return seconds;
+}
+
+AssetRequest::AssetRequest(const std::wstring& filepath)
+    : mFilepath(filepath),
+      mState(static_cast<int>(AssetState::Queued)),
+      mError(),
+      mTimings(),
+      mFile()
+{
+    mTimings.requested = Stopwatch::Now();
+}
+
+AssetRequest::~AssetRequest()
+{
+}
+
+void AssetRequest::RethrowIfFailed() const
+{
+    if (State() == AssetState::Failed && mError)
+    {
+        std::rethrow_exception(mError);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Loader.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+AssetLoader::AssetLoader(unsigned int decodeThreadCount)
+    : mMutex(),
+      mReadAvailable(),
+      mDecodeAvailable(),
+      mProgress(),
+      mReadQueue(),
+      mDecodeQueue(),
+      mUploadQueue(),
+      mPendingCount(0),
+      mStopping(false),
+      mStats(),
+      mIoThread(),
+      mDecodeThreads()
+{
+    if (decodeThreadCount == 0)
+    {
+        decodeThreadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    mIoThread = std::thread([this]() { RunIoThread(); });
+
+    for (unsigned int i = 0; i < decodeThreadCount; ++i)
+    {
+        mDecodeThreads.push_back(std::thread([this]() { RunDecodeThread(); }));
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+
+    mReadAvailable.notify_all();
+    mDecodeAvailable.notify_all();
+
+    mIoThread.join();
+
+    for (std::thread& thread : mDecodeThreads)
+    {
+        thread.join();
+    }
+}
+
+void AssetLoader::Enqueue(const std::shared_ptr<AssetRequest>& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mReadQueue.push_back(request);
+        mPendingCount++;
+        mStats.requested++;
+    }
+
+    mReadAvailable.notify_one();
+}
+
+void AssetLoader::RunIoThread()
+{
+    Profiler::SetThreadName("Asset IO");
+
+    for (;;)
+    {
+        std::shared_ptr<AssetRequest> request;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mReadAvailable.wait(lock, [this]() { return mStopping || !mReadQueue.empty(); });
+
+            if (mStopping) { return; }
+
+            request = mReadQueue.front();
+            mReadQueue.pop_front();
+        }
+
+        PROFILE_SCOPE("AssetLoader::Read");
+        request->SetState(AssetState::Reading);
+        request->mTimings.readStart = Stopwatch::Now();
+
+        try
+        {
+            std::shared_ptr<BinaryBlob> file =
+                std::make_shared<BinaryBlob>(BinaryBlob::LoadFromFile(request->Filepath()));
+            PageIn(*file);
+
+            request->mFile = file;
+        }
+        catch (...)
+        {
+            request->mTimings.readEnd = Stopwatch::Now();
+            Finish(request, std::current_exception());
+            continue;
+        }
+
+        request->mTimings.readEnd = Stopwatch::Now();
+        request->mTimings.bytesRead = static_cast<unsigned long long>(request->mFile->BufferSize());
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDecodeQueue.push_back(request);
+        }
+
+        mDecodeAvailable.notify_one();
+    }
+}
+
+void AssetLoader::RunDecodeThread()
+{
+    Profiler::SetThreadName("Asset decode");
+
+    for (;;)
+    {
+        std::shared_ptr<AssetRequest> request;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDecodeAvailable.wait(lock, [this]() { return mStopping || !mDecodeQueue.empty(); });
+
+            if (mStopping) { return; }
+
+            request = mDecodeQueue.front();
+            mDecodeQueue.pop_front();
+        }
+
+        PROFILE_SCOPE("AssetLoader::Decode");
+        request->SetState(AssetState::Decoding);
+        request->mTimings.decodeStart = Stopwatch::Now();
+
+        std::exception_ptr error;
+
+        try
+        {
+            request->Decode(request->mFile);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        // The file is not needed past decoding unless the decoded data kept its own reference to it.
+        request->mFile.reset();
+        request->mTimings.decodeEnd = Stopwatch::Now();
+
+        if (error || !request->NeedsUpload())
+        {
+            Finish(request, error);
+            continue;
+        }
+
+        request->SetState(AssetState::WaitingForUpload);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mUploadQueue.push_back(request);
+        }
+
+        mProgress.notify_all();
+    }
+}
+
+unsigned int AssetLoader::ProcessUploads(double budgetSeconds)
+{
+    PROFILE_SCOPE("AssetLoader::ProcessUploads");
+
+    Stopwatch stopwatch;
+    unsigned int uploadCount = 0;
+
+    do
+    {
+        std::shared_ptr<AssetRequest> request;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            if (mUploadQueue.empty()) { break; }
+
+            request = mUploadQueue.front();
+            mUploadQueue.pop_front();
+        }
+
+        PROFILE_SCOPE("AssetLoader::Upload");
+        request->SetState(AssetState::Uploading);
+        request->mTimings.uploadStart = Stopwatch::Now();
+
+        std::exception_ptr error;
+
+        try
+        {
+            request->Upload();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        request->mTimings.uploadEnd = Stopwatch::Now();
+        Finish(request, error);
+
+        uploadCount++;
+    }
+    while (stopwatch.ElapsedSeconds() < budgetSeconds);
+
+    return uploadCount;
+}
+
+void AssetLoader::Flush()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mProgress.wait(lock, [this]() { return mPendingCount == 0 || !mUploadQueue.empty(); });
+
+            if (mPendingCount == 0) { return; }
+        }
+
+        ProcessUploads(0.0);
+    }
+}
+
+void AssetLoader::Finish(const std::shared_ptr<AssetRequest>& request, std::exception_ptr error)
+{
+    const asset_load_timings_t& timings = request->mTimings;
+
+    // Store the error before publishing the state so handles that see Failed also see the error.
+    request->mError = error;
+    request->SetState(error ? AssetState::Failed : AssetState::Ready);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        Assert(mPendingCount > 0);
+        mPendingCount--;
+
+        if (error)
+        {
+            mStats.failed++;
+        }
+        else
+        {
+            mStats.completed++;
+        }
+
+        mStats.bytesRead += timings.bytesRead;
+        mStats.readSeconds += timings.ReadSeconds();
+        mStats.decodeSeconds += timings.DecodeSeconds();
+        mStats.uploadSeconds += timings.UploadSeconds();
+        mStats.queuedSeconds += timings.QueuedSeconds();
+    }
+
+    mProgress.notify_all();
+}
+
+unsigned int AssetLoader::PendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPendingCount;
+}
+
+asset_loader_stats_t AssetLoader::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
@@ -0,0 +1,312 @@
+#pragma once
+#include "BinaryBlob.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AssetLoader;
+
+/**
+ * \brief Where an asset request is in the loading pipeline.
+ */
+enum class AssetState
+{
+    Queued,
+    Reading,
+    Decoding,
+    WaitingForUpload,
+    Uploading,
+    Ready,
+    Failed
+};
+
+/**
+ * \brief When an asset passed through each loading stage, as Stopwatch::Now() timestamps. Stages that were never
+ * reached (no upload, or the load failed) are zero.
+ */
+struct asset_load_timings_t
+{
+    double requested;
+    double readStart;
+    double readEnd;
+    double decodeStart;
+    double decodeEnd;
+    double uploadStart;
+    double uploadEnd;
+    unsigned long long bytesRead;
+
+    double ReadSeconds() const { return readEnd - readStart; }
+    double DecodeSeconds() const { return decodeEnd - decodeStart; }
+    double UploadSeconds() const { return uploadEnd - uploadStart; }
+
+    // Time spent waiting in a queue for a thread to become free.
+    double QueuedSeconds() const;
+};
+
+/**
+ * \brief Totals over every asset an AssetLoader has finished.
+ */
+struct asset_loader_stats_t
+{
+    unsigned int requested;
+    unsigned int completed;
+    unsigned int failed;
+    unsigned long long bytesRead;
+    double readSeconds;             // Summed over assets, stages run in parallel so these can exceed wall time.
+    double decodeSeconds;
+    double uploadSeconds;
+    double queuedSeconds;
+};
+
+/**
+ * \brief State shared between the loader and every handle to one asset. Use AssetHandle rather than this directly.
+ */
+class AssetRequest
+{
+public:
+    explicit AssetRequest(const std::wstring& filepath);
+    AssetRequest(const AssetRequest&) = delete;
+    virtual ~AssetRequest();
+
+    AssetRequest& operator =(const AssetRequest&) = delete;
+
+    const std::wstring& Filepath() const { return mFilepath; }
+    AssetState State() const { return static_cast<AssetState>(mState.load()); }
+
+    // Only meaningful once the request is Ready or Failed.
+    const asset_load_timings_t& Timings() const { return mTimings; }
+
+    // Throw the error that made the load fail, does nothing unless the request failed.
+    void RethrowIfFailed() const;
+
+protected:
+    friend class AssetLoader;
+
+    virtual void Decode(const std::shared_ptr<const BinaryBlob>& file) = 0;
+    virtual bool NeedsUpload() const = 0;
+    virtual void Upload() = 0;
+
+    void SetState(AssetState state) { mState.store(static_cast<int>(state)); }
+
+private:
+    std::wstring mFilepath;
+    std::atomic<int> mState;
+    std::exception_ptr mError;
+    asset_load_timings_t mTimings;
+    std::shared_ptr<const BinaryBlob> mFile;
+};
+
+/**
+ * \brief Request that produces an asset of type T.
+ */
+template<typename T>
+class TypedAssetRequest : public AssetRequest
+{
+public:
+    explicit TypedAssetRequest(const std::wstring& filepath) : AssetRequest(filepath), mAsset() { }
+
+    // The finished asset. Only safe to call once the request is Ready.
+    const std::shared_ptr<T>& Asset() const { return mAsset; }
+
+protected:
+    std::shared_ptr<T> mAsset;
+};
+
+/**
+ * \brief Handle to an asset that is loading in the background.
+ *
+ * Handles are returned immediately and are cheap to copy. Poll IsReady(), or call AssetLoader::Flush() to wait for
+ * everything requested so far.
+ */
+template<typename T>
+class AssetHandle
+{
+public:
+    AssetHandle() : mRequest() { }
+    explicit AssetHandle(const std::shared_ptr<TypedAssetRequest<T>>& request) : mRequest(request) { }
+
+    bool IsValid() const { return mRequest != nullptr; }
+    AssetState State() const { return mRequest->State(); }
+    bool IsReady() const { return IsValid() && State() == AssetState::Ready; }
+    bool IsFailed() const { return IsValid() && State() == AssetState::Failed; }
+
+    // The loaded asset, or null while it is still loading. Throws the load error if loading failed.
+    std::shared_ptr<T> Get() const
+    {
+        if (!IsValid()) { return std::shared_ptr<T>(); }
+
+        mRequest->RethrowIfFailed();
+        return IsReady() ? mRequest->Asset() : std::shared_ptr<T>();
+    }
+
+    const std::wstring& Filepath() const { return mRequest->Filepath(); }
+    const asset_load_timings_t& Timings() const { return mRequest->Timings(); }
+
+private:
+    std::shared_ptr<TypedAssetRequest<T>> mRequest;
+};
+
+/**
+ * \brief Background asset loading pipeline.
+ *
+ * Every request goes through up to three stages:
+ *  1. Read: one I/O thread reads the whole file into memory. A single reader keeps the disk access sequential.
+ *  2. Decode: a pool of worker threads turns the file into CPU side data (parsing meshes, laying out texture mips).
+ *  3. Upload: the render thread creates the device resources from the decoded data in ProcessUploads(), which stops
+ *     starting new uploads once the frame's time budget is used up.
+ *
+ * Assets that need no device resources skip the upload stage and are ready as soon as they are decoded. Every
+ * stage is timed, see asset_load_timings_t, so the pipeline can be measured without a device by supplying upload
+ * functions that do not touch one.
+ *
+ * Decode functions run on worker threads and must not use the device context. Upload functions run on whichever
+ * thread calls ProcessUploads() or Flush(). An exception thrown by any stage fails that one asset; it is rethrown
+ * from AssetHandle::Get(). Destroying the loader abandons unfinished requests, their handles stay pending.
+ */
+class AssetLoader
+{
+public:
+    typedef std::shared_ptr<const BinaryBlob> file_t;
+
+    // A decode thread count of zero uses one less than the number of hardware threads, leaving one for the render
+    // thread, but at least one.
+    explicit AssetLoader(unsigned int decodeThreadCount = 0);
+    AssetLoader(const AssetLoader&) = delete;
+    ~AssetLoader();
+
+    AssetLoader& operator =(const AssetLoader&) = delete;
+
+    // Load an asset that is finished once decoded.
+    template<typename T>
+    AssetHandle<T> Load(
+        const std::wstring& filepath,
+        std::function<std::shared_ptr<T>(const file_t& file, const std::wstring& filepath)> decode);
+
+    // Load an asset that is decoded to an intermediate type on a worker thread and then uploaded on the render thread.
+    template<typename Decoded, typename T>
+    AssetHandle<T> Load(
+        const std::wstring& filepath,
+        std::function<std::unique_ptr<Decoded>(const file_t& file, const std::wstring& filepath)> decode,
+        std::function<std::shared_ptr<T>(Decoded& decoded)> upload);
+
+    // Run waiting uploads on the calling thread until budgetSeconds have passed. At least one upload runs when any
+    // are waiting so loading always makes progress. Returns the number of uploads run.
+    unsigned int ProcessUploads(double budgetSeconds);
+
+    // Block until every request made so far has finished, running uploads on the calling thread.
+    void Flush();
+
+    // Number of requests that are not yet ready or failed.
+    unsigned int PendingCount() const;
+
+    asset_loader_stats_t Stats() const;
+
+private:
+    void Enqueue(const std::shared_ptr<AssetRequest>& request);
+    void RunIoThread();
+    void RunDecodeThread();
+    void Finish(const std::shared_ptr<AssetRequest>& request, std::exception_ptr error);
+
+private:
+    template<typename T>
+    class DecodeOnlyRequest;
+
+    template<typename Decoded, typename T>
+    class UploadRequest;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mReadAvailable;
+    std::condition_variable mDecodeAvailable;
+    std::condition_variable mProgress;          // Signalled when an upload is queued or a request finishes.
+    std::deque<std::shared_ptr<AssetRequest>> mReadQueue;
+    std::deque<std::shared_ptr<AssetRequest>> mDecodeQueue;
+    std::deque<std::shared_ptr<AssetRequest>> mUploadQueue;
+    unsigned int mPendingCount;
+    bool mStopping;
+    asset_loader_stats_t mStats;
+    std::thread mIoThread;
+    std::vector<std::thread> mDecodeThreads;
+};
+
+template<typename T>
+class AssetLoader::DecodeOnlyRequest : public TypedAssetRequest<T>
+{
+public:
+    typedef std::function<std::shared_ptr<T>(const file_t&, const std::wstring&)> decode_function_t;
+
+    DecodeOnlyRequest(const std::wstring& filepath, const decode_function_t& decode)
+        : TypedAssetRequest<T>(filepath),
+          mDecode(decode)
+    {
+    }
+
+protected:
+    virtual void Decode(const file_t& file) override { this->mAsset = mDecode(file, this->Filepath()); }
+    virtual bool NeedsUpload() const override { return false; }
+    virtual void Upload() override { }
+
+private:
+    decode_function_t mDecode;
+};
+
+template<typename Decoded, typename T>
+class AssetLoader::UploadRequest : public TypedAssetRequest<T>
+{
+public:
+    typedef std::function<std::unique_ptr<Decoded>(const file_t&, const std::wstring&)> decode_function_t;
+    typedef std::function<std::shared_ptr<T>(Decoded&)> upload_function_t;
+
+    UploadRequest(const std::wstring& filepath, const decode_function_t& decode, const upload_function_t& upload)
+        : TypedAssetRequest<T>(filepath),
+          mDecode(decode),
+          mUpload(upload),
+          mDecoded()
+    {
+    }
+
+protected:
+    virtual void Decode(const file_t& file) override { mDecoded = mDecode(file, this->Filepath()); }
+    virtual bool NeedsUpload() const override { return true; }
+
+    virtual void Upload() override
+    {
+        this->mAsset = mUpload(*mDecoded);
+        mDecoded.reset();
+    }
+
+private:
+    decode_function_t mDecode;
+    upload_function_t mUpload;
+    std::unique_ptr<Decoded> mDecoded;
+};
+
+template<typename T>
+AssetHandle<T> AssetLoader::Load(
+    const std::wstring& filepath,
+    std::function<std::shared_ptr<T>(const file_t& file, const std::wstring& filepath)> decode)
+{
+    std::shared_ptr<TypedAssetRequest<T>> request(new DecodeOnlyRequest<T>(filepath, decode));
+    Enqueue(request);
+
+    return AssetHandle<T>(request);
+}
+
+template<typename Decoded, typename T>
+AssetHandle<T> AssetLoader::Load(
+    const std::wstring& filepath,
+    std::function<std::unique_ptr<Decoded>(const file_t& file, const std::wstring& filepath)> decode,
+    std::function<std::shared_ptr<T>(Decoded& decoded)> upload)
+{
+    std::shared_ptr<TypedAssetRequest<T>> request(new UploadRequest<Decoded, T>(filepath, decode, upload));
+    Enqueue(request);
+
+    return AssetHandle<T>(request);
+}
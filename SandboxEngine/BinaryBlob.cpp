@@ -2,49 +2,82 @@
 #include "BinaryBlob.h"
 #include "DXSandbox.h"
 #include "DXTestException.h"
+#include "MappedFile.h"
+#include "PackFile.h"
 #include "Utils.h"
 
+#include <atomic>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <algorithm>
 #include <memory>
 
+namespace
+{
+    std::atomic<unsigned long long> GBufferAllocationCount(0);
+}
+
 BinaryBlob::BinaryBlob()
-: mpBuffer(nullptr),
-  mSize(0)
+    : mpBuffer(),
+      mSize(0),
+      mIsWritable(false)
 {
 }
 
 BinaryBlob::BinaryBlob(const char * pBuffer, std::streamsize size)
     : mpBuffer(),
-      mSize(0)
+      mSize(0),
+      mIsWritable(false)
 {
     if (pBuffer != nullptr && size > 0)
 	{
+        mpBuffer = AllocateBuffer(size);
         mSize = size;
-        mpBuffer.reset(new char[static_cast<unsigned int>(mSize)]);
 
-        std::copy(
-            &pBuffer[0],
-            &pBuffer[0] + size,
-            stdext::checked_array_iterator<char *>(mpBuffer.get(), size));
+        std::memcpy(const_cast<char *>(mpBuffer.get()), pBuffer, static_cast<size_t>(size));
 	}
 }
 
-BinaryBlob::BinaryBlob(const BinaryBlob& blob)
+BinaryBlob::BinaryBlob(std::streamsize size)
     : mpBuffer(),
-      mSize(0)
+      mSize(0),
+      mIsWritable(true)
 {
-	if (!blob.IsNull())
-	{
-        mSize = blob.mSize;
-        mpBuffer.reset(new char[static_cast<unsigned int>(mSize)]);
+    if (size > 0)
+    {
+        mpBuffer = AllocateBuffer(size);
+        mSize = size;
+    }
+}
 
-		std::copy(
-            blob.mpBuffer.get(), 
-            blob.mpBuffer.get() + blob.mSize,
-            stdext::checked_array_iterator<char *>(mpBuffer.get(), mSize));
-	}
+BinaryBlob::BinaryBlob(const std::shared_ptr<const void>& owner, const char * pData, std::streamsize size)
+    : mpBuffer(),
+      mSize(0),
+      mIsWritable(false)
+{
+    if (pData != nullptr && size > 0)
+    {
+        Assert(owner != nullptr);
+
+        // Aliasing constructor: points at pData, keeps owner alive.
+        mpBuffer = std::shared_ptr<const char>(owner, pData);
+        mSize = size;
+    }
+}
+
+BinaryBlob::BinaryBlob(const BinaryBlob& blob)
+    : mpBuffer(blob.mpBuffer),
+      mSize(blob.mSize),
+      mIsWritable(false)
+{
+}
+
+BinaryBlob::BinaryBlob(BinaryBlob&& blob)
+    : mpBuffer(std::move(blob.mpBuffer)),
+      mSize(blob.mSize),
+      mIsWritable(blob.mIsWritable)
+{
+    blob.mSize = 0;
+    blob.mIsWritable = false;
 }
 
 BinaryBlob::~BinaryBlob()
@@ -55,26 +88,29 @@ BinaryBlob& BinaryBlob::operator =(const BinaryBlob& rhs)
 {
 	if (this != &rhs)
 	{
-        if (rhs.IsNull())
-        {
-            mpBuffer.reset();
-            mSize = 0;
-        }
-        else
-        {
-            mSize = rhs.mSize;
-			mpBuffer.reset(new char[static_cast<unsigned int>(mSize)]);
-
-			std::copy(
-                rhs.mpBuffer.get(),
-                rhs.mpBuffer.get() + rhs.mSize,
-                stdext::checked_array_iterator<char *>(mpBuffer.get(), rhs.mSize));
-		}
+        mpBuffer = rhs.mpBuffer;
+        mSize = rhs.mSize;
+        mIsWritable = false;
 	}
 
 	return *this;
 }
 
+BinaryBlob& BinaryBlob::operator =(BinaryBlob&& rhs)
+{
+    if (this != &rhs)
+    {
+        mpBuffer = std::move(rhs.mpBuffer);
+        mSize = rhs.mSize;
+        mIsWritable = rhs.mIsWritable;
+
+        rhs.mSize = 0;
+        rhs.mIsWritable = false;
+    }
+
+    return *this;
+}
+
 bool BinaryBlob::IsNull() const
 {
     return mSize == 0;
@@ -85,11 +121,42 @@ const char* BinaryBlob::BufferPointer() const
 	return mpBuffer.get();
 }
 
+char* BinaryBlob::WritableBufferPointer()
+{
+    if (!mIsWritable)
+    {
+        throw SandboxException(L"Binary blob is read only");
+    }
+
+    return const_cast<char *>(mpBuffer.get());
+}
+
 std::streamsize BinaryBlob::BufferSize() const
 {
 	return mSize;
 }
 
+BinaryBlob BinaryBlob::Slice(std::streamsize offset, std::streamsize size) const
+{
+    Verify(offset >= 0 && size >= 0 && offset <= mSize && size <= mSize - offset);
+
+    BinaryBlob slice;
+
+    if (size > 0)
+    {
+        slice.mpBuffer = std::shared_ptr<const char>(mpBuffer, mpBuffer.get() + offset);
+        slice.mSize = size;
+    }
+
+    return slice;
+}
+
+bool BinaryBlob::SharesBufferWith(const BinaryBlob& other) const
+{
+    // Ownership order is equal exactly when both share a control block.
+    return mpBuffer != nullptr && !mpBuffer.owner_before(other.mpBuffer) && !other.mpBuffer.owner_before(mpBuffer);
+}
+
 BinaryBlob BinaryBlob::LoadFromFile(const std::string& filepath)
 {
     return LoadFromFile(Utils::ConvertUtf8ToWString(filepath));
@@ -97,28 +164,39 @@ BinaryBlob BinaryBlob::LoadFromFile(const std::string& filepath)
 
 BinaryBlob BinaryBlob::LoadFromFile(const std::wstring& filepath)
 {
-	// Open the shader file.
-	std::ifstream inputStream(filepath.c_str(), std::ios::binary);
+    // Uncompressed files in a mounted pack are used in place, the blob keeps the pack mapped. Compressed ones are
+    // decoded straight into the new blob.
+    pack_entry_t packEntry;
+    std::shared_ptr<const PackFile> pack = PackFile::FindMounted(filepath, &packEntry);
+
+    if (pack != nullptr)
+    {
+        if ((packEntry.flags & PackFile::FlagCompressed) == 0)
+        {
+            return BinaryBlob(pack, packEntry.pData, static_cast<std::streamsize>(packEntry.size));
+        }
 
-	if (!inputStream.is_open())
-	{
-        throw FileLoadException(filepath);
-	}
+        BinaryBlob blob(static_cast<std::streamsize>(packEntry.uncompressedSize));
+        pack->ReadEntry(packEntry, blob.WritableBufferPointer(), packEntry.uncompressedSize);
 
-	// Get number of bytes in binary file.
-	inputStream.seekg(0, std::ios_base::end);
-	std::streampos size = inputStream.tellg();
-	inputStream.seekg(0, std::ios_base::beg);
+        blob.mIsWritable = false;
+        return blob;
+    }
 
-	// Read the file contents into a memory buffer.
-	char * pBufferContents = new char[static_cast<unsigned int>(size)];
-	inputStream.read(pBufferContents, size);
+    // Loose files are mapped, MappedFile throws FileLoadException if the file can not be opened.
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    file->Open(filepath);
 
-	// Create a new binary blob.
-	BinaryBlob blob = BinaryBlob(pBufferContents, size);
+    return BinaryBlob(file, file->Data(), static_cast<std::streamsize>(file->Size()));
+}
 
-	// Release temporaries and return the binary blob.
-	SafeDeleteArray(pBufferContents);
+unsigned long long BinaryBlob::BufferAllocationCount()
+{
+    return GBufferAllocationCount;
+}
 
-	return blob;
-}
\ No newline at end of file
+std::shared_ptr<const char> BinaryBlob::AllocateBuffer(std::streamsize size)
+{
+    GBufferAllocationCount++;
+    return std::shared_ptr<const char>(new char[static_cast<size_t>(size)], std::default_delete<char[]>());
+}
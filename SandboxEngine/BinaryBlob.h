@@ -1,15 +1,18 @@
 #pragma once
 
 #include <string>
-#include <memory>   // unique_ptr
+#include <memory>   // shared_ptr
 #include <ios>
 
-// Represents a binary chunk of bytes.
-//  TODO: Maybe call it BinaryBuffer? maybe not.
-//  TODO: Improve mechanics, use shared_ptr or unique_ptr
-
 /**
- * \brief Represents a binary chunk of bytes.
+ * \brief Read only chunk of bytes with shared ownership.
+ *
+ * Copies, moves and slices never copy the bytes. Every blob holds a reference to whatever owns the memory: a heap
+ * buffer, a memory mapped file or a mounted pack, and the memory is released when the last blob referring to it goes
+ * away. LoadFromFile() maps loose files and points straight into the mapping of mounted packs, so the only copy
+ * between the disk and the consumer is the one the OS makes paging the file in.
+ *
+ * Mapped files can not be written to or deleted on Windows while any blob still refers to them.
  *
  * TODO: Rename this to BinaryBuffer.
  */
@@ -17,24 +20,51 @@ class BinaryBlob
 {
 public:
 	BinaryBlob();
-	BinaryBlob(const char* pBuffer, std::streamsize size);
+	BinaryBlob(const char* pBuffer, std::streamsize size);      // Copies the data into a new heap buffer.
+    explicit BinaryBlob(std::streamsize size);      // Uninitialized, fill it through WritableBufferPointer().
+
+    // View memory owned by something else, which the blob keeps alive for as long as it refers to it.
+    BinaryBlob(const std::shared_ptr<const void>& owner, const char * pData, std::streamsize size);
+
 	BinaryBlob(const BinaryBlob& blob);
+    BinaryBlob(BinaryBlob&& blob);
 	virtual ~BinaryBlob();
 
 	BinaryBlob& operator =(const BinaryBlob& rhs);
+    BinaryBlob& operator =(BinaryBlob&& rhs);
 
     bool IsNull() const;
 
-	// Get a temporary readonly pointer to the buffer. DO NOT STORE THIS POINTER.
+	// Get a readonly pointer to the buffer, valid as long as this blob or any blob sharing its buffer is alive.
 	const char* BufferPointer() const;
 
+    // Only blobs created with the size constructor are writable, anything else throws. Copies share the buffer and
+    // see every write, so fill the blob before handing it out.
+    char* WritableBufferPointer();
+
 	std::streamsize BufferSize() const;
 
+    // Sub range of this blob sharing the same buffer. Throws if the range does not fit.
+    BinaryBlob Slice(std::streamsize offset, std::streamsize size) const;
+
+    // Check if two blobs refer to the same underlying buffer, including slices of it.
+    bool SharesBufferWith(const BinaryBlob& other) const;
+
+    // Load a whole file, from a mounted pack if one contains it and otherwise from disk. See PackFile::Mount().
+    // Loose files are memory mapped and uncompressed pack entries point into the pack's mapping. Compressed pack
+    // entries are decompressed straight into a new heap buffer.
 	static BinaryBlob LoadFromFile(const std::string& filepath);    // TODO: Remove this.
     static BinaryBlob LoadFromFile(const std::wstring& filepath);
-	
+
+    // Number of heap buffers blobs have allocated since startup. Lets tests and benchmarks check that loads and
+    // copies do not allocate.
+    static unsigned long long BufferAllocationCount();
+
 private:
-	std::unique_ptr<char> mpBuffer;
+    static std::shared_ptr<const char> AllocateBuffer(std::streamsize size);
+
+private:
+    std::shared_ptr<const char> mpBuffer;       // Points at the first byte, shares ownership with the whole buffer.
 	std::streamsize mSize;
+    bool mIsWritable;
 };
-
@@ -0,0 +1,286 @@
+#include "stdafx.h"
+#include "BlockCompression.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "LzCodec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+namespace
+{
+    const char Magic[4] = { 'S', 'B', 'L', 'Z' };
+    const unsigned int StoredBlockFlag = 0x80000000u;
+
+    struct block_header_t
+    {
+        char magic[4];
+        unsigned int blockSize;
+        unsigned long long uncompressedSize;
+        unsigned int blockCount;
+        unsigned int reserved;
+    };
+
+    // Run work(index) for every index below count on up to threadCount threads. Workers pull the next index off a
+    // shared counter and exceptions are carried back to the calling thread.
+    template<typename Work>
+    void ForEachBlock(unsigned int count, unsigned int threadCount, Work work)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        threadCount = std::min(threadCount, count);
+
+        if (threadCount <= 1)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                work(i);
+            }
+
+            return;
+        }
+
+        std::atomic<unsigned int> nextBlock(0);
+        std::vector<std::exception_ptr> errors(threadCount);
+        std::vector<std::thread> workers;
+
+        for (unsigned int t = 0; t < threadCount; ++t)
+        {
+            workers.push_back(std::thread([&, t]() {
+                try
+                {
+                    for (unsigned int i = nextBlock++; i < count; i = nextBlock++)
+                    {
+                        work(i);
+                    }
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                    nextBlock = count;
+                }
+            }));
+        }
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        for (const std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compression
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void BlockCompression::Compress(
+    const char * pData,
+    size_t size,
+    std::vector<char> *pOut,
+    unsigned int blockSize,
+    unsigned int threadCount)
+{
+    AssertNotNull(pOut);
+    Verify(pData != nullptr || size == 0);
+    Verify(blockSize >= MinBlockSize && blockSize <= MaxBlockSize);
+
+    const unsigned int blockCount = static_cast<unsigned int>((size + blockSize - 1) / blockSize);
+
+    // Compress every block into its own buffer, then stitch them together behind the header and block table.
+    std::vector<std::vector<char>> blocks(blockCount);
+    std::vector<unsigned int> blockTable(blockCount);
+
+    ForEachBlock(blockCount, threadCount, [&](unsigned int i) {
+        const size_t offset = static_cast<size_t>(i) * blockSize;
+        const size_t length = std::min<size_t>(blockSize, size - offset);
+
+        std::vector<char>& block = blocks[i];
+        block.resize(LzCodec::MaxCompressedSize(length));
+
+        size_t compressedSize = LzCodec::Compress(pData + offset, length, &block[0], block.size());
+
+        // Store blocks that did not get smaller, they are quicker to copy than to decompress.
+        if (compressedSize == 0 || compressedSize >= length)
+        {
+            block.assign(pData + offset, pData + offset + length);
+            blockTable[i] = static_cast<unsigned int>(length) | StoredBlockFlag;
+        }
+        else
+        {
+            block.resize(compressedSize);
+            blockTable[i] = static_cast<unsigned int>(compressedSize);
+        }
+    });
+
+    block_header_t header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.blockSize = blockSize;
+    header.uncompressedSize = size;
+    header.blockCount = blockCount;
+    header.reserved = 0;
+
+    size_t totalSize = sizeof(header) + blockCount * sizeof(unsigned int);
+
+    for (const std::vector<char>& block : blocks)
+    {
+        totalSize += block.size();
+    }
+
+    pOut->resize(totalSize);
+    char * pWrite = &(*pOut)[0];
+
+    std::memcpy(pWrite, &header, sizeof(header));
+    pWrite += sizeof(header);
+
+    if (blockCount > 0)
+    {
+        std::memcpy(pWrite, &blockTable[0], blockCount * sizeof(unsigned int));
+        pWrite += blockCount * sizeof(unsigned int);
+    }
+
+    for (const std::vector<char>& block : blocks)
+    {
+        if (!block.empty())
+        {
+            std::memcpy(pWrite, &block[0], block.size());
+            pWrite += block.size();
+        }
+    }
+}
+
+bool BlockCompression::IsCompressed(const char * pData, size_t size)
+{
+    return pData != nullptr && size >= sizeof(block_header_t) && std::memcmp(pData, Magic, sizeof(Magic)) == 0;
+}
+
+void BlockCompression::Decompress(
+    const char * pData,
+    size_t size,
+    char * pDst,
+    size_t dstSize,
+    const std::wstring& sourceName,
+    unsigned int threadCount)
+{
+    BlockDecoder decoder(pData, size, sourceName);
+    decoder.DecodeAll(pDst, dstSize, threadCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Decoding
+///////////////////////////////////////////////////////////////////////////////////////////////////
+BlockDecoder::BlockDecoder(const char * pData, size_t size, const std::wstring& sourceName)
+    : mSourceName(sourceName),
+      mBlocks(),
+      mUncompressedSize(0),
+      mBlockSize(0),
+      mNextBlock(0)
+{
+    block_header_t header;
+
+    if (!BlockCompression::IsCompressed(pData, size))
+    {
+        throw FileFormatException(L"Not block compressed data", sourceName);
+    }
+
+    std::memcpy(&header, pData, sizeof(header));
+
+    if (header.blockSize == 0 ||
+        header.blockSize > BlockCompression::MaxBlockSize ||
+        header.blockCount != (header.uncompressedSize + header.blockSize - 1) / header.blockSize ||
+        header.blockCount > (size - sizeof(header)) / sizeof(unsigned int))
+    {
+        throw FileFormatException(L"Compressed data header is corrupt", sourceName);
+    }
+
+    mUncompressedSize = static_cast<size_t>(header.uncompressedSize);
+    mBlockSize = header.blockSize;
+    mBlocks.resize(header.blockCount);
+
+    // Find where every block starts up front, so blocks can be decoded in any order.
+    const char * pTable = pData + sizeof(header);
+    const char * pBlockData = pTable + header.blockCount * sizeof(unsigned int);
+    size_t remaining = size - static_cast<size_t>(pBlockData - pData);
+
+    for (unsigned int i = 0; i < header.blockCount; ++i)
+    {
+        unsigned int entry;
+        std::memcpy(&entry, pTable + i * sizeof(unsigned int), sizeof(entry));
+
+        block_t& block = mBlocks[i];
+        block.pData = pBlockData;
+        block.size = entry & ~StoredBlockFlag;
+        block.isStored = (entry & StoredBlockFlag) != 0;
+
+        if (block.size > remaining || (block.isStored && block.size != BlockUncompressedSize(i)))
+        {
+            throw FileFormatException(L"Compressed data is truncated", sourceName);
+        }
+
+        pBlockData += block.size;
+        remaining -= block.size;
+    }
+}
+
+size_t BlockDecoder::BlockUncompressedSize(unsigned int index) const
+{
+    Assert(index < mBlocks.size());
+
+    const size_t offset = static_cast<size_t>(index) * mBlockSize;
+    return std::min<size_t>(mBlockSize, mUncompressedSize - offset);
+}
+
+void BlockDecoder::DecodeBlock(unsigned int index, char * pDst) const
+{
+    Assert(index < mBlocks.size());
+    AssertNotNull(pDst);
+
+    const block_t& block = mBlocks[index];
+
+    if (block.isStored)
+    {
+        std::memcpy(pDst, block.pData, block.size);
+    }
+    else if (!LzCodec::Decompress(block.pData, block.size, pDst, BlockUncompressedSize(index)))
+    {
+        throw FileFormatException(L"Compressed data is corrupt", mSourceName);
+    }
+}
+
+void BlockDecoder::DecodeAll(char * pDst, size_t dstSize, unsigned int threadCount) const
+{
+    Verify(dstSize == mUncompressedSize);
+
+    ForEachBlock(BlockCount(), threadCount, [&](unsigned int i) {
+        DecodeBlock(i, pDst + static_cast<size_t>(i) * mBlockSize);
+    });
+}
+
+size_t BlockDecoder::DecodeNext(char * pDst, size_t capacity)
+{
+    if (IsFinished())
+    {
+        return 0;
+    }
+
+    const unsigned int index = static_cast<unsigned int>(mNextBlock);
+    const size_t blockSize = BlockUncompressedSize(index);
+
+    Verify(capacity >= blockSize);
+    DecodeBlock(index, pDst);
+
+    mNextBlock++;
+    return blockSize;
+}
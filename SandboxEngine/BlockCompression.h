@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>     // size_t
+#include <string>
+#include <vector>
+
+/**
+ * \brief LzCodec compressed data split into independently compressed blocks.
+ *
+ * Each block only refers back to data within itself, so blocks can be decompressed in any order and on as many
+ * threads as there are blocks, and a streaming reader only ever needs one block of output space at a time.
+ *
+ * Layout, all values native (little endian) byte order:
+ *  - Header: magic, block size, uncompressed size and block count.
+ *  - Block table: the compressed size of every block. The top bit marks a block that did not compress and is stored
+ *    as is.
+ *  - Block data, back to back.
+ */
+namespace BlockCompression
+{
+    // Smaller blocks compress worse, larger ones leave fewer blocks to spread across threads.
+    const unsigned int MinBlockSize = 64 * 1024;
+    const unsigned int MaxBlockSize = 256 * 1024;
+    const unsigned int DefaultBlockSize = 128 * 1024;
+
+    // Compress size bytes into pOut, replacing its contents. A threadCount of zero uses every hardware thread.
+    void Compress(
+        const char * pData,
+        size_t size,
+        std::vector<char> *pOut,
+        unsigned int blockSize = DefaultBlockSize,
+        unsigned int threadCount = 0);
+
+    // True if the data starts with a block compression header.
+    bool IsCompressed(const char * pData, size_t size);
+
+    // Decompress into pDst, which must be exactly UncompressedSize() bytes, decoding blocks on up to threadCount
+    // threads. Throws FileFormatException naming sourceName if the data is corrupt.
+    void Decompress(
+        const char * pData,
+        size_t size,
+        char * pDst,
+        size_t dstSize,
+        const std::wstring& sourceName,
+        unsigned int threadCount = 0);
+}
+
+/**
+ * \brief Reads block compressed data, either all at once across threads or one block at a time.
+ *
+ * The header and block table are validated when the decoder is created, each block's contents when it is decoded.
+ * Corrupt data throws FileFormatException. The compressed data must outlive the decoder.
+ */
+class BlockDecoder
+{
+public:
+    BlockDecoder(const char * pData, size_t size, const std::wstring& sourceName);
+
+    size_t UncompressedSize() const { return mUncompressedSize; }
+    unsigned int BlockSize() const { return mBlockSize; }
+    unsigned int BlockCount() const { return static_cast<unsigned int>(mBlocks.size()); }
+
+    // Decompressed size of one block. Every block is BlockSize() bytes except possibly the last.
+    size_t BlockUncompressedSize(unsigned int index) const;
+
+    // Decode one block into pDst, which must hold BlockUncompressedSize(index) bytes. Different blocks can be
+    // decoded on different threads at the same time.
+    void DecodeBlock(unsigned int index, char * pDst) const;
+
+    // Decode every block into pDst, which must be exactly UncompressedSize() bytes, on up to threadCount threads.
+    void DecodeAll(char * pDst, size_t dstSize, unsigned int threadCount = 0) const;
+
+    // Streaming: decode the next block into pDst and return the number of bytes written, or zero once every block
+    // has been read. Capacity must be at least the next block's size, BlockSize() is always enough.
+    size_t DecodeNext(char * pDst, size_t capacity);
+    bool IsFinished() const { return mNextBlock == mBlocks.size(); }
+
+private:
+    struct block_t
+    {
+        const char * pData;
+        size_t size;
+        bool isStored;
+    };
+
+    std::wstring mSourceName;
+    std::vector<block_t> mBlocks;
+    size_t mUncompressedSize;
+    unsigned int mBlockSize;
+    size_t mNextBlock;
+};
@@ -0,0 +1,346 @@
+#include "stdafx.h"
+#include "BoundingVolumes.h"
+#include "MeshData.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BOUNDING_VOLUMES_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Number of directions searched for extreme points: the three axes and the four cube diagonals.
+    const int ExtremeDirectionCount = 7;
+
+    const float * PointAt(const float * pPoints, size_t stride, size_t index)
+    {
+        return reinterpret_cast<const float *>(reinterpret_cast<const char *>(pPoints) + index * stride);
+    }
+
+    float DistanceSquared(const float a[3], const float b[3])
+    {
+        float d[3] = { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+        return d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+    }
+
+#ifdef BOUNDING_VOLUMES_SSE2
+    // Load x, y, z into the first three lanes. Only reads three floats, so the last point of a tightly packed array
+    // is safe to load.
+    __m128 LoadPoint(const float * pPoint)
+    {
+        __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(pPoint)));
+        return _mm_movelh_ps(xy, _mm_load_ss(pPoint + 2));
+    }
+
+    __m128i Select(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    float HorizontalSum3(__m128 v)
+    {
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(v, y), z));
+    }
+#endif
+
+    // Find the indices of the points with the smallest and largest projection on each extreme direction.
+    void FindExtremePoints(
+        const float * pPoints,
+        size_t count,
+        size_t stride,
+        size_t minIndicesOut[ExtremeDirectionCount],
+        size_t maxIndicesOut[ExtremeDirectionCount])
+    {
+#ifdef BOUNDING_VOLUMES_SSE2
+        // Projections are split over two vectors: (x, y, z, x+y+z) and (x+y-z, x-y+z, x-y-z, 0).
+        const __m128 xA = _mm_setr_ps(1.0f, 0.0f, 0.0f, 1.0f);
+        const __m128 yA = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+        const __m128 zA = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+        const __m128 xB = _mm_setr_ps(1.0f, 1.0f, 1.0f, 0.0f);
+        const __m128 yB = _mm_setr_ps(1.0f, -1.0f, -1.0f, 0.0f);
+        const __m128 zB = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 0.0f);
+
+        const float largest = std::numeric_limits<float>::max();
+
+        __m128 minA = _mm_set1_ps(largest), maxA = _mm_set1_ps(-largest);
+        __m128 minB = minA, maxB = maxA;
+        __m128i minIndexA = _mm_setzero_si128(), maxIndexA = _mm_setzero_si128();
+        __m128i minIndexB = minIndexA, maxIndexB = maxIndexA;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            __m128 p = LoadPoint(PointAt(pPoints, stride, i));
+            __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+
+            __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, xA), _mm_mul_ps(y, yA)), _mm_mul_ps(z, zA));
+            __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, xB), _mm_mul_ps(y, yB)), _mm_mul_ps(z, zB));
+            __m128i index = _mm_set1_epi32(static_cast<int>(i));
+
+            minIndexA = Select(_mm_castps_si128(_mm_cmplt_ps(a, minA)), index, minIndexA);
+            maxIndexA = Select(_mm_castps_si128(_mm_cmpgt_ps(a, maxA)), index, maxIndexA);
+            minIndexB = Select(_mm_castps_si128(_mm_cmplt_ps(b, minB)), index, minIndexB);
+            maxIndexB = Select(_mm_castps_si128(_mm_cmpgt_ps(b, maxB)), index, maxIndexB);
+
+            minA = _mm_min_ps(a, minA);
+            maxA = _mm_max_ps(a, maxA);
+            minB = _mm_min_ps(b, minB);
+            maxB = _mm_max_ps(b, maxB);
+        }
+
+        int indices[4][4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(indices[0]), minIndexA);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(indices[1]), maxIndexA);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(indices[2]), minIndexB);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(indices[3]), maxIndexB);
+
+        for (int d = 0; d < ExtremeDirectionCount; ++d)
+        {
+            minIndicesOut[d] = static_cast<size_t>(d < 4 ? indices[0][d] : indices[2][d - 4]);
+            maxIndicesOut[d] = static_cast<size_t>(d < 4 ? indices[1][d] : indices[3][d - 4]);
+        }
+#else
+        float minValues[ExtremeDirectionCount], maxValues[ExtremeDirectionCount];
+
+        std::fill(minValues, minValues + ExtremeDirectionCount, std::numeric_limits<float>::max());
+        std::fill(maxValues, maxValues + ExtremeDirectionCount, -std::numeric_limits<float>::max());
+        std::fill(minIndicesOut, minIndicesOut + ExtremeDirectionCount, 0u);
+        std::fill(maxIndicesOut, maxIndicesOut + ExtremeDirectionCount, 0u);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float * p = PointAt(pPoints, stride, i);
+            const float projections[ExtremeDirectionCount] =
+            {
+                p[0], p[1], p[2], p[0] + p[1] + p[2], p[0] + p[1] - p[2], p[0] - p[1] + p[2], p[0] - p[1] - p[2]
+            };
+
+            for (int d = 0; d < ExtremeDirectionCount; ++d)
+            {
+                if (projections[d] < minValues[d]) { minValues[d] = projections[d]; minIndicesOut[d] = i; }
+                if (projections[d] > maxValues[d]) { maxValues[d] = projections[d]; maxIndicesOut[d] = i; }
+            }
+        }
+#endif
+    }
+
+    // Grow the sphere until it contains every point (Ritter's second pass).
+    void GrowSphere(const float * pPoints, size_t count, size_t stride, bounding_sphere_t *pSphere)
+    {
+        float radius = pSphere->radius;
+        float radiusSquared = radius * radius;
+
+#ifdef BOUNDING_VOLUMES_SSE2
+        __m128 center = LoadPoint(pSphere->center);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            __m128 offset = _mm_sub_ps(LoadPoint(PointAt(pPoints, stride, i)), center);
+            float distanceSquared = HorizontalSum3(_mm_mul_ps(offset, offset));
+
+            if (distanceSquared > radiusSquared)
+            {
+                // Move the center towards the point just enough for the new sphere to touch both the point and the
+                // far side of the old sphere.
+                float distance = std::sqrt(distanceSquared);
+                float newRadius = (radius + distance) * 0.5f;
+
+                center = _mm_add_ps(center, _mm_mul_ps(offset, _mm_set1_ps((newRadius - radius) / distance)));
+                radius = newRadius;
+                radiusSquared = radius * radius;
+            }
+        }
+
+        float result[4];
+        _mm_storeu_ps(result, center);
+        std::copy(result, result + 3, pSphere->center);
+#else
+        float * center = pSphere->center;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float * p = PointAt(pPoints, stride, i);
+            float distanceSquared = DistanceSquared(p, center);
+
+            if (distanceSquared > radiusSquared)
+            {
+                float distance = std::sqrt(distanceSquared);
+                float newRadius = (radius + distance) * 0.5f;
+                float shift = (newRadius - radius) / distance;
+
+                center[0] += (p[0] - center[0]) * shift;
+                center[1] += (p[1] - center[1]) * shift;
+                center[2] += (p[2] - center[2]) * shift;
+
+                radius = newRadius;
+                radiusSquared = radius * radius;
+            }
+        }
+#endif
+
+        pSphere->radius = radius;
+    }
+}
+
+aabb_t BoundingVolumes::ComputeAabb(const float * pPoints, size_t count, size_t stride)
+{
+    aabb_t box = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+
+    if (count == 0)
+    {
+        return box;
+    }
+
+    Assert(pPoints != nullptr);
+    Assert(stride >= 3 * sizeof(float));
+
+#ifdef BOUNDING_VOLUMES_SSE2
+    __m128 minimum = LoadPoint(pPoints);
+    __m128 maximum = minimum;
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        __m128 p = LoadPoint(PointAt(pPoints, stride, i));
+
+        minimum = _mm_min_ps(minimum, p);
+        maximum = _mm_max_ps(maximum, p);
+    }
+
+    float values[2][4];
+    _mm_storeu_ps(values[0], minimum);
+    _mm_storeu_ps(values[1], maximum);
+
+    std::copy(values[0], values[0] + 3, box.min);
+    std::copy(values[1], values[1] + 3, box.max);
+#else
+    std::copy(pPoints, pPoints + 3, box.min);
+    std::copy(pPoints, pPoints + 3, box.max);
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        const float * p = PointAt(pPoints, stride, i);
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            box.min[axis] = std::min(box.min[axis], p[axis]);
+            box.max[axis] = std::max(box.max[axis], p[axis]);
+        }
+    }
+#endif
+
+    return box;
+}
+
+bounding_sphere_t BoundingVolumes::ComputeBoundingSphere(const float * pPoints, size_t count, size_t stride)
+{
+    bounding_sphere_t sphere = { { 0.0f, 0.0f, 0.0f }, 0.0f };
+
+    if (count == 0)
+    {
+        return sphere;
+    }
+
+    Assert(pPoints != nullptr);
+    Assert(stride >= 3 * sizeof(float));
+
+    // Start with the sphere spanning the farthest apart pair of extreme points.
+    size_t minIndices[ExtremeDirectionCount], maxIndices[ExtremeDirectionCount];
+    FindExtremePoints(pPoints, count, stride, minIndices, maxIndices);
+
+    const float * pA = PointAt(pPoints, stride, minIndices[0]);
+    const float * pB = PointAt(pPoints, stride, maxIndices[0]);
+    float largestDistanceSquared = DistanceSquared(pA, pB);
+
+    for (int d = 1; d < ExtremeDirectionCount; ++d)
+    {
+        const float * pMin = PointAt(pPoints, stride, minIndices[d]);
+        const float * pMax = PointAt(pPoints, stride, maxIndices[d]);
+        float distanceSquared = DistanceSquared(pMin, pMax);
+
+        if (distanceSquared > largestDistanceSquared)
+        {
+            pA = pMin;
+            pB = pMax;
+            largestDistanceSquared = distanceSquared;
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        sphere.center[axis] = (pA[axis] + pB[axis]) * 0.5f;
+    }
+
+    sphere.radius = std::sqrt(largestDistanceSquared) * 0.5f;
+
+    GrowSphere(pPoints, count, stride, &sphere);
+    return sphere;
+}
+
+mesh_bounds_t BoundingVolumes::ComputeMeshBounds(const s_mesh_data_t& mesh)
+{
+    mesh_bounds_t bounds;
+    const float * pPositions = mesh.vertices.empty() ? nullptr : &mesh.vertices[0].x;
+
+    bounds.box = ComputeAabb(pPositions, mesh.vertices.size(), sizeof(s_mesh_vertex_t));
+    bounds.sphere = ComputeBoundingSphere(pPositions, mesh.vertices.size(), sizeof(s_mesh_vertex_t));
+
+    return bounds;
+}
+
+aabb_t BoundingVolumes::TransformAabb(const aabb_t& box, const float matrix[16])
+{
+    aabb_t result;
+
+    for (int column = 0; column < 3; ++column)
+    {
+        result.min[column] = result.max[column] = matrix[12 + column];
+
+        for (int row = 0; row < 3; ++row)
+        {
+            float a = matrix[row * 4 + column] * box.min[row];
+            float b = matrix[row * 4 + column] * box.max[row];
+
+            result.min[column] += std::min(a, b);
+            result.max[column] += std::max(a, b);
+        }
+    }
+
+    return result;
+}
+
+bounding_sphere_t BoundingVolumes::TransformSphere(const bounding_sphere_t& sphere, const float matrix[16])
+{
+    bounding_sphere_t result;
+
+    for (int column = 0; column < 3; ++column)
+    {
+        result.center[column] = matrix[12 + column] +
+                                sphere.center[0] * matrix[column] +
+                                sphere.center[1] * matrix[4 + column] +
+                                sphere.center[2] * matrix[8 + column];
+    }
+
+    result.radius = sphere.radius * MaxScale(matrix);
+    return result;
+}
+
+float BoundingVolumes::MaxScale(const float matrix[16])
+{
+    float largest = 0.0f;
+
+    for (int row = 0; row < 3; ++row)
+    {
+        const float * r = matrix + row * 4;
+        largest = std::max(largest, r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    }
+
+    return std::sqrt(largest);
+}
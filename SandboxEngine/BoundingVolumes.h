@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>     // size_t
+
+struct s_mesh_data_t;
+
+/**
+ * \brief Axis aligned bounding box.
+ */
+struct aabb_t
+{
+    float min[3];
+    float max[3];
+};
+
+/**
+ * \brief Bounding sphere.
+ */
+struct bounding_sphere_t
+{
+    float center[3];
+    float radius;
+};
+
+/**
+ * \brief Model space bounds of a mesh. Stored in .mesh files, see MeshFile.h.
+ */
+struct mesh_bounds_t
+{
+    aabb_t box;
+    bounding_sphere_t sphere;
+};
+
+/**
+ * \brief Bounding box and bounding sphere computation.
+ *
+ * Spheres use the EPOS (extremal points optimal sphere) variant of Ritter's algorithm from Larsson, "Fast and Tight
+ * Fitting Bounding Spheres", 2008. The initial sphere spans the farthest pair among the extreme points along seven
+ * directions (the axes and the cube diagonals) instead of Ritter's single approximate diameter, and is then grown
+ * to include any point left outside. Results are typically within a few percent of the minimal sphere.
+ *
+ * Points are read as three consecutive floats every stride bytes, so vertex arrays can be passed without copying
+ * out the positions. The extreme point search and the growing pass use SSE2 when available.
+ *
+ * Matrices are 4x4 row major with row vectors, the same layout as DirectX::SimpleMath::Matrix (pass &matrix._11).
+ */
+namespace BoundingVolumes
+{
+    aabb_t ComputeAabb(const float * pPoints, size_t count, size_t stride);
+    bounding_sphere_t ComputeBoundingSphere(const float * pPoints, size_t count, size_t stride);
+
+    // Box and sphere of every vertex position in the mesh.
+    mesh_bounds_t ComputeMeshBounds(const s_mesh_data_t& mesh);
+
+    // Bounding box of a transformed box (Arvo, "Transforming Axis-Aligned Bounding Boxes", 1990).
+    aabb_t TransformAabb(const aabb_t& box, const float matrix[16]);
+
+    // Transform a sphere center and scale its radius by the largest scale in the matrix, so the result still
+    // contains the transformed points under non uniform scaling.
+    bounding_sphere_t TransformSphere(const bounding_sphere_t& sphere, const float matrix[16]);
+
+    // Largest factor the matrix scales any length by, assuming no shear.
+    float MaxScale(const float matrix[16]);
+}
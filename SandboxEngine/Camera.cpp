@@ -5,6 +5,7 @@ using namespace DirectX::SimpleMath;
 
 Camera::Camera(const Size& screenSize, float screenNear, float screenDepth)
     : mRegenerateViewMatrix(false),
+      mRevision(1),
       mScreenWidth(static_cast<float>(screenSize.width)),
       mScreenHeight(static_cast<float>(screenSize.height)),
       mFieldOfView(3.141592653589793f / 4.0f),
@@ -14,22 +15,34 @@ Camera::Camera(const Size& screenSize, float screenNear, float screenDepth)
       mPosition(0.0f, 0.0f, 0.0f),
       mRotation(0.0f, 0.0f, 0.0f),
       mViewMatrix(),
-      mProjectionMatrix()
+      mInverseViewMatrix(),
+      mViewProjectionMatrix(),
+      mInverseViewProjectionMatrix(),
+      mProjectionMatrix(),
+      mInverseProjectionMatrix(),
+      mOrthoMatrix()
 {
     RegenerateProjectionMatrix();
     RegenerateOrthoMatrix();
+    RegenerateViewMatrices();
 }
 
 void Camera::SetPosition(const Vector3& position)
 {
-    mPosition = position;
-    mRegenerateViewMatrix = true;
+    if (position != mPosition)
+    {
+        mPosition = position;
+        MarkChanged();
+    }
 }
 
 void Camera::SetRotation(const Vector3& rotation)
 {
-    mRotation = rotation;
-    mRegenerateViewMatrix = true;
+    if (rotation != mRotation)
+    {
+        mRotation = rotation;
+        MarkChanged();
+    }
 }
 
 Vector3 Camera::Position() const
@@ -42,14 +55,28 @@ Vector3 Camera::Rotation() const
     return mRotation;
 }
 
-Matrix Camera::ViewMatrix() const
+const Matrix& Camera::ViewMatrix() const
 {
-    if (IsViewMatrixDirty())
-    {
-        Render();
-    }
+    Render();
+    return mViewMatrix;
+}
+
+const Matrix& Camera::InverseViewMatrix() const
+{
+    Render();
+    return mInverseViewMatrix;
+}
 
-	return mViewMatrix;
+const Matrix& Camera::ViewProjectionMatrix() const
+{
+    Render();
+    return mViewProjectionMatrix;
+}
+
+const Matrix& Camera::InverseViewProjectionMatrix() const
+{
+    Render();
+    return mInverseViewProjectionMatrix;
 }
 
 bool Camera::IsViewMatrixDirty() const
@@ -57,32 +84,54 @@ bool Camera::IsViewMatrixDirty() const
     return mRegenerateViewMatrix;
 }
 
-// TODO: This name is TERRIBLE.
-//  -> Camera::RegenerateValues or something.
 void Camera::Render() const
 {
-	// Initialize camera values.
-	Vector3 up = Vector3(0.0f, 1.0f, 0.0f);		// up is +y
+    if (mRegenerateViewMatrix)
+    {
+        RegenerateViewMatrices();
+    }
+}
+
+void Camera::MarkChanged()
+{
+    mRegenerateViewMatrix = true;
+
+    // Skip zero when wrapping so caches can use it to mean "never built".
+    mRevision = (mRevision == 0xFFFFFFFFu) ? 1 : mRevision + 1;
+}
+
+void Camera::RegenerateViewMatrices() const
+{
+    // Initialize camera values.
+    Vector3 up = Vector3(0.0f, 1.0f, 0.0f);       // up is +y
     Vector3 position = mPosition;
-	Vector3 lookAt = Vector3(0.0f, 0.0f, 1.0f);	// look down +z axis
+    Vector3 lookAt = Vector3(0.0f, 0.0f, 1.0f);   // look down +z axis
 
-	// Convert yaw (y axis), pitch (x axis) and roll (a axis) to radian value.
-	float pitch = mRotation.x * 0.0174532925f;
-	float yaw = mRotation.y * 0.0174532925f;
-	float roll = mRotation.z * 0.0174532925f;
+    // Convert yaw (y axis), pitch (x axis) and roll (a axis) to radian value.
+    float pitch = mRotation.x * 0.0174532925f;
+    float yaw = mRotation.y * 0.0174532925f;
+    float roll = mRotation.z * 0.0174532925f;
 
-	// Generate rotation amtrix from the camera' yaw, pitch and roll.
-	Matrix rotationMatrix = Matrix::CreateFromYawPitchRoll(yaw, pitch, roll);
+    // Generate rotation amtrix from the camera' yaw, pitch and roll.
+    Matrix rotationMatrix = Matrix::CreateFromYawPitchRoll(yaw, pitch, roll);
 
-	// Transform the lookAt and up vector by the rotation matrix so the view is correctly rotated at the origin.
-	lookAt = Vector3::Transform(lookAt, rotationMatrix);
+    // Transform the lookAt and up vector by the rotation matrix so the view is correctly rotated at the origin.
+    lookAt = Vector3::Transform(lookAt, rotationMatrix);
     up = Vector3::Transform(up, rotationMatrix);
 
-	// Translate the rotated camera position to the location of the viewer.
-	lookAt = position + lookAt;
+    // Translate the rotated camera position to the location of the viewer.
+    lookAt = position + lookAt;
 
-	// Generate the view matrix from the three updated vectors.
+    // Generate the view matrix from the three updated vectors.
     mViewMatrix = DirectX::XMMatrixLookAtLH(position, lookAt, up);
+
+    // The view matrix is a rotation and a translation, so its inverse is the camera's world transform.
+    mInverseViewMatrix = rotationMatrix * Matrix::CreateTranslation(position);
+
+    mViewProjectionMatrix = mViewMatrix * mProjectionMatrix;
+    mInverseViewProjectionMatrix = mInverseProjectionMatrix * mInverseViewMatrix;
+
+    mRegenerateViewMatrix = false;
 }
 
 void Camera::RegenerateProjectionMatrix()
@@ -90,6 +139,10 @@ void Camera::RegenerateProjectionMatrix()
     // Create the projection matrix. The projection matrix will be used to translate the 3d scene into a 2d viewport
     // space that was created above. We need to keep a copy of this matrix so we can pass it to our shaders.
     mProjectionMatrix = DirectX::XMMatrixPerspectiveFovLH(mFieldOfView, mAspectRatio, mScreenNear, mScreenDepth);
+    mInverseProjectionMatrix = mProjectionMatrix.Invert();
+
+    // The combined matrices use the projection too.
+    MarkChanged();
 }
 
 void Camera::RegenerateOrthoMatrix()
@@ -97,4 +150,4 @@ void Camera::RegenerateOrthoMatrix()
     // Create an orthographic projection matrix for 2d rendering. This matrix will be used to render 2d elements like the
     // user inteface.
     mOrthoMatrix = DirectX::XMMatrixOrthographicLH(mScreenWidth, mScreenHeight, mScreenNear, mScreenDepth);
-}
\ No newline at end of file
+}
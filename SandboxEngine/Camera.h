@@ -1,34 +1,62 @@
 #pragma once
 
-#include <SimpleMath.h>
+#include "MathTypes.h"
 #include "size.h"
 
+/**
+ * \brief Perspective camera with cached view, projection and view-projection matrices.
+ *
+ * Matrices are only rebuilt when the camera has moved since they were last read. Revision() changes whenever any of
+ * them would change, so anything derived from the camera (frustum planes, visibility, constant buffers) can remember
+ * the revision it was built for and skip work on frames where the camera stood still.
+ */
 class Camera
 {
 public:
-	Camera(const Size& screenSize, float screenNear, float screenDepth);
+    Camera(const Size& screenSize, float screenNear, float screenDepth);
 
     void SetPosition(const DirectX::SimpleMath::Vector3& position);
-	void SetRotation(const DirectX::SimpleMath::Vector3& rotation);
+    void SetRotation(const DirectX::SimpleMath::Vector3& rotation);
 
-	DirectX::SimpleMath::Vector3 Position() const;
-	DirectX::SimpleMath::Vector3 Rotation() const;
-	DirectX::SimpleMath::Matrix ViewMatrix() const;
-    DirectX::SimpleMath::Matrix ProjectionMatrix() const { return mProjectionMatrix; }
-    DirectX::SimpleMath::Matrix OrthoMatrix() const { return mOrthoMatrix; }
+    DirectX::SimpleMath::Vector3 Position() const;
+    DirectX::SimpleMath::Vector3 Rotation() const;
+
+    const DirectX::SimpleMath::Matrix& ViewMatrix() const;
+    const DirectX::SimpleMath::Matrix& InverseViewMatrix() const;
+    const DirectX::SimpleMath::Matrix& ProjectionMatrix() const { return mProjectionMatrix; }
+    const DirectX::SimpleMath::Matrix& InverseProjectionMatrix() const { return mInverseProjectionMatrix; }
+    const DirectX::SimpleMath::Matrix& OrthoMatrix() const { return mOrthoMatrix; }
+
+    // View matrix followed by the projection matrix, and its inverse for unprojecting screen points.
+    const DirectX::SimpleMath::Matrix& ViewProjectionMatrix() const;
+    const DirectX::SimpleMath::Matrix& InverseViewProjectionMatrix() const;
+
+    // Changes every time the camera moves, rotates or changes projection. Never zero.
+    unsigned int Revision() const { return mRevision; }
 
     bool IsViewMatrixDirty() const;
 
-	void Render() const;
+    // Bring the cached matrices up to date. Only does work if the camera changed since the last call.
+    void Render() const;
+
     float FieldOfView() const { return mFieldOfView; }
     float AspectRatio() const { return mAspectRatio; }
+    float ScreenWidth() const { return mScreenWidth; }
+    float ScreenHeight() const { return mScreenHeight; }
+    float ScreenNear() const { return mScreenNear; }
+    float ScreenDepth() const { return mScreenDepth; }
 
 protected:
     void RegenerateProjectionMatrix();
     void RegenerateOrthoMatrix();
 
 private:
-    bool mRegenerateViewMatrix;
+    void MarkChanged();
+    void RegenerateViewMatrices() const;
+
+private:
+    mutable bool mRegenerateViewMatrix;
+    unsigned int mRevision;
     float mScreenWidth;
     float mScreenHeight;
     float mFieldOfView;
@@ -37,7 +65,11 @@ private:
     float mScreenDepth;
     DirectX::SimpleMath::Vector3 mPosition;
     DirectX::SimpleMath::Vector3 mRotation;
-	mutable DirectX::SimpleMath::Matrix mViewMatrix;
+    mutable DirectX::SimpleMath::Matrix mViewMatrix;
+    mutable DirectX::SimpleMath::Matrix mInverseViewMatrix;
+    mutable DirectX::SimpleMath::Matrix mViewProjectionMatrix;
+    mutable DirectX::SimpleMath::Matrix mInverseViewProjectionMatrix;
     DirectX::SimpleMath::Matrix mProjectionMatrix;
+    DirectX::SimpleMath::Matrix mInverseProjectionMatrix;
     DirectX::SimpleMath::Matrix mOrthoMatrix;
-};
\ No newline at end of file
+};
@@ -0,0 +1,38 @@
+#include "stdafx.h"
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && defined(SANDBOX_AVX2)
+#include <intrin.h>
+#endif
+
+bool CpuFeatures::DetectAvx2()
+{
+#if !defined(SANDBOX_AVX2)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    // The OS has to save the YMM registers too, not just the CPU support them.
+    __cpuid(info, 1);
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+    if (!hasOsxsave || !hasAvx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // Needed when this runs from a static initializer, which may be before libgcc has set up its own copy.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// SSE2 is always there on x64 and on the x86 targets the engine builds for.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SANDBOX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 code is compiled in on x64 but only run when CpuFeatures::DetectAvx2() says so, so the default build still
+// runs on CPUs without it. Functions using AVX2 intrinsics are marked SANDBOX_TARGET_AVX2, which GCC and Clang need
+// to compile them without -mavx2 for the whole file.
+#if defined(_M_X64) || defined(__x86_64__)
+#define SANDBOX_AVX2 1
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#define SANDBOX_TARGET_AVX2
+#else
+#define SANDBOX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/**
+ * \brief Run time checks for instruction set extensions.
+ *
+ * These query the CPU on every call. Modules cache the answer in a namespace scope constant, which is initialized
+ * before main since function local statics are not thread safe on every compiler this builds with.
+ */
+namespace CpuFeatures
+{
+    // True if the CPU has AVX2 and the OS saves the YMM registers on a context switch.
+    bool DetectAvx2();
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include <errno.h>
+#include "Platform.h"     // errno_t
 
 // TODO: Rename this file to SandboxEngine.h
 
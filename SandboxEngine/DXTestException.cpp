@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include <string>
 #include "DXTestException.h"
+#include "TextFormat.h"
 #include "Utils.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -122,4 +123,29 @@ AssertionFailedException::AssertionFailedException(const std::wstring& expressio
 FileLoadException::FileLoadException(const std::wstring& filepath)
     : SandboxException(L"File could not be loaded", filepath)
 {
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File save exception.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FileSaveException::FileSaveException(const std::wstring& filepath)
+    : SandboxException(L"File could not be saved", filepath)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File format exception.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FileFormatException::FileFormatException(const std::wstring& message, const std::wstring& filepath)
+    : SandboxException(message, filepath)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Text encoding exception.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TextEncodingException::TextEncodingException(const std::wstring& message, size_t offset)
+    : SandboxException(message, WideFormatBuffer() << L"At offset " << offset),
+      mOffset(offset)
+{
+}
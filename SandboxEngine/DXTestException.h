@@ -1,8 +1,9 @@
 #pragma once
 // TODO: Rename file to SandboxEngineExceptions.h
 #include <exception>
+#include <stdexcept>      // std::runtime_error
 #include <string>
-#include <errno.h>
+#include "Platform.h"     // errno_t
 
 // TODO: Create an exception type macro.
 // TODO: Make it so exceptions can store where the exception was originally thrown.
@@ -111,6 +112,39 @@ public:
     FileLoadException(const std::wstring& filepath);
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File save exception.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class FileSaveException : public SandboxException
+{
+public:
+    FileSaveException(const std::wstring& filepath);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File format exception, thrown when a file was read but its contents are not valid.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class FileFormatException : public SandboxException
+{
+public:
+    FileFormatException(const std::wstring& message, const std::wstring& filepath);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Text encoding exception, thrown when text is not valid UTF-8 or UTF-16.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class TextEncodingException : public SandboxException
+{
+public:
+    TextEncodingException(const std::wstring& message, size_t offset);
+
+    // Offset of the bad character in the input, in bytes for UTF-8 and characters for wide strings.
+    size_t Offset() const { return mOffset; }
+
+private:
+    size_t mOffset;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Not initialized exception.
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
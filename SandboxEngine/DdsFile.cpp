@@ -0,0 +1,378 @@
+#include "stdafx.h"
+#include "DdsFile.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "StreamReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const unsigned int DdsMagic = 0x20534444;       // "DDS "
+
+    // Pixel format flags.
+    const unsigned int DdpfAlphaPixels = 0x1;
+    const unsigned int DdpfFourCC = 0x4;
+    const unsigned int DdpfRgb = 0x40;
+    const unsigned int DdpfLuminance = 0x20000;
+
+    // Caps2 flags.
+    const unsigned int DdsCaps2CubeMap = 0x200;
+    const unsigned int DdsCaps2AllFaces = 0xFC00;
+    const unsigned int DdsCaps2Volume = 0x200000;
+
+    // DX10 header values.
+    const unsigned int ResourceDimensionTexture2D = 3;
+    const unsigned int ResourceMiscTextureCube = 0x4;
+
+    // DXGI_FORMAT values, see dxgiformat.h.
+    const unsigned int FormatR32G32B32A32Float = 2;
+    const unsigned int FormatR16G16B16A16Float = 10;
+    const unsigned int FormatR8G8B8A8Unorm = 28;
+    const unsigned int FormatR8G8B8A8UnormSrgb = 29;
+    const unsigned int FormatR8G8Unorm = 49;
+    const unsigned int FormatR8Unorm = 61;
+    const unsigned int FormatBc1Unorm = 71;
+    const unsigned int FormatBc1UnormSrgb = 72;
+    const unsigned int FormatBc2Unorm = 74;
+    const unsigned int FormatBc2UnormSrgb = 75;
+    const unsigned int FormatBc3Unorm = 77;
+    const unsigned int FormatBc3UnormSrgb = 78;
+    const unsigned int FormatBc4Unorm = 80;
+    const unsigned int FormatBc4Snorm = 81;
+    const unsigned int FormatBc5Unorm = 83;
+    const unsigned int FormatBc5Snorm = 84;
+    const unsigned int FormatB5G6R5Unorm = 85;
+    const unsigned int FormatB8G8R8A8Unorm = 87;
+    const unsigned int FormatB8G8R8X8Unorm = 88;
+    const unsigned int FormatB8G8R8A8UnormSrgb = 91;
+    const unsigned int FormatBc6hUf16 = 95;
+    const unsigned int FormatBc6hSf16 = 96;
+    const unsigned int FormatBc7Unorm = 98;
+    const unsigned int FormatBc7UnormSrgb = 99;
+
+    struct dds_pixel_format_t
+    {
+        unsigned int size;
+        unsigned int flags;
+        unsigned int fourCC;
+        unsigned int rgbBitCount;
+        unsigned int rBitMask;
+        unsigned int gBitMask;
+        unsigned int bBitMask;
+        unsigned int aBitMask;
+    };
+
+    struct dds_header_t
+    {
+        unsigned int size;
+        unsigned int flags;
+        unsigned int height;
+        unsigned int width;
+        unsigned int pitchOrLinearSize;
+        unsigned int depth;
+        unsigned int mipMapCount;
+        unsigned int reserved1[11];
+        dds_pixel_format_t pixelFormat;
+        unsigned int caps;
+        unsigned int caps2;
+        unsigned int caps3;
+        unsigned int caps4;
+        unsigned int reserved2;
+    };
+
+    struct dds_header_dx10_t
+    {
+        unsigned int dxgiFormat;
+        unsigned int resourceDimension;
+        unsigned int miscFlag;
+        unsigned int arraySize;
+        unsigned int miscFlags2;
+    };
+
+    unsigned int MakeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<unsigned int>(static_cast<unsigned char>(a)) |
+               (static_cast<unsigned int>(static_cast<unsigned char>(b)) << 8) |
+               (static_cast<unsigned int>(static_cast<unsigned char>(c)) << 16) |
+               (static_cast<unsigned int>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    bool HasMasks(const dds_pixel_format_t& format, unsigned int r, unsigned int g, unsigned int b, unsigned int a)
+    {
+        return format.rBitMask == r && format.gBitMask == g && format.bBitMask == b && format.aBitMask == a;
+    }
+
+    // Map a legacy (pre DX10 header) pixel format to its DXGI format, zero when there is none.
+    unsigned int LegacyFormat(const dds_pixel_format_t& format)
+    {
+        if (format.flags & DdpfFourCC)
+        {
+            const unsigned int fourCC = format.fourCC;
+
+            if (fourCC == MakeFourCC('D', 'X', 'T', '1')) { return FormatBc1Unorm; }
+            if (fourCC == MakeFourCC('D', 'X', 'T', '2')) { return FormatBc2Unorm; }
+            if (fourCC == MakeFourCC('D', 'X', 'T', '3')) { return FormatBc2Unorm; }
+            if (fourCC == MakeFourCC('D', 'X', 'T', '4')) { return FormatBc3Unorm; }
+            if (fourCC == MakeFourCC('D', 'X', 'T', '5')) { return FormatBc3Unorm; }
+            if (fourCC == MakeFourCC('A', 'T', 'I', '1')) { return FormatBc4Unorm; }
+            if (fourCC == MakeFourCC('B', 'C', '4', 'U')) { return FormatBc4Unorm; }
+            if (fourCC == MakeFourCC('B', 'C', '4', 'S')) { return FormatBc4Snorm; }
+            if (fourCC == MakeFourCC('A', 'T', 'I', '2')) { return FormatBc5Unorm; }
+            if (fourCC == MakeFourCC('B', 'C', '5', 'U')) { return FormatBc5Unorm; }
+            if (fourCC == MakeFourCC('B', 'C', '5', 'S')) { return FormatBc5Snorm; }
+
+            // Some writers store a D3DFORMAT value instead of a four character code.
+            if (fourCC == 113) { return FormatR16G16B16A16Float; }
+            if (fourCC == 116) { return FormatR32G32B32A32Float; }
+
+            return 0;
+        }
+
+        if ((format.flags & DdpfRgb) && format.rgbBitCount == 32)
+        {
+            if (HasMasks(format, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000)) { return FormatR8G8B8A8Unorm; }
+            if (HasMasks(format, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000)) { return FormatB8G8R8A8Unorm; }
+            if (HasMasks(format, 0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000)) { return FormatB8G8R8X8Unorm; }
+        }
+        else if ((format.flags & DdpfRgb) && format.rgbBitCount == 16)
+        {
+            if (HasMasks(format, 0xf800, 0x07e0, 0x001f, 0x0000)) { return FormatB5G6R5Unorm; }
+        }
+        else if ((format.flags & DdpfLuminance) && format.rgbBitCount == 8 && !(format.flags & DdpfAlphaPixels))
+        {
+            return FormatR8Unorm;
+        }
+
+        return 0;
+    }
+
+    // Bytes in one 4x4 block of a block compressed format.
+    unsigned int BlockBytes(unsigned int format)
+    {
+        switch (format)
+        {
+        case FormatBc1Unorm:
+        case FormatBc1UnormSrgb:
+        case FormatBc4Unorm:
+        case FormatBc4Snorm:
+            return 8;
+
+        default:
+            return 16;
+        }
+    }
+}
+
+unsigned int DdsFile::BitsPerPixel(unsigned int format)
+{
+    switch (format)
+    {
+    case FormatR32G32B32A32Float:
+        return 128;
+
+    case FormatR16G16B16A16Float:
+        return 64;
+
+    case FormatR8G8B8A8Unorm:
+    case FormatR8G8B8A8UnormSrgb:
+    case FormatB8G8R8A8Unorm:
+    case FormatB8G8R8X8Unorm:
+    case FormatB8G8R8A8UnormSrgb:
+        return 32;
+
+    case FormatR8G8Unorm:
+    case FormatB5G6R5Unorm:
+        return 16;
+
+    case FormatR8Unorm:
+    case FormatBc2Unorm:
+    case FormatBc2UnormSrgb:
+    case FormatBc3Unorm:
+    case FormatBc3UnormSrgb:
+    case FormatBc5Unorm:
+    case FormatBc5Snorm:
+    case FormatBc6hUf16:
+    case FormatBc6hSf16:
+    case FormatBc7Unorm:
+    case FormatBc7UnormSrgb:
+        return 8;
+
+    case FormatBc1Unorm:
+    case FormatBc1UnormSrgb:
+    case FormatBc4Unorm:
+    case FormatBc4Snorm:
+        return 4;
+
+    default:
+        return 0;
+    }
+}
+
+bool DdsFile::IsBlockCompressed(unsigned int format)
+{
+    return (format >= FormatBc1Unorm && format <= FormatBc5Snorm) ||
+           (format >= FormatBc6hUf16 && format <= FormatBc7UnormSrgb);
+}
+
+void DdsFile::Parse(const char * pBuffer, size_t size, const std::wstring& sourceName, dds_image_t *pImageOut)
+{
+    StreamReader reader(pBuffer, size, sourceName);
+    Parse(reader, pImageOut);
+}
+
+void DdsFile::Parse(StreamReader& reader, dds_image_t *pImageOut)
+{
+    AssertNotNull(pImageOut);
+
+    const std::wstring& sourceName = reader.SourceName();
+    const unsigned long long size = reader.Size();
+    unsigned int magic = 0;
+    dds_header_t header;
+
+    if (reader.Remaining() < sizeof(magic) + sizeof(header))
+    {
+        throw FileFormatException(L"DDS file is truncated", sourceName);
+    }
+
+    magic = reader.Read<unsigned int>();
+    header = reader.Read<dds_header_t>();
+
+    if (magic != DdsMagic || header.size != sizeof(dds_header_t) || header.pixelFormat.size != sizeof(dds_pixel_format_t))
+    {
+        throw FileFormatException(L"Not a DDS file", sourceName);
+    }
+
+    dds_image_t image;
+
+    image.width = header.width;
+    image.height = header.height;
+    image.mipCount = std::max(header.mipMapCount, 1u);
+    image.arraySize = 1;
+    image.isCubeMap = false;
+
+    if ((header.pixelFormat.flags & DdpfFourCC) && header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0'))
+    {
+        if (reader.Remaining() < sizeof(dds_header_dx10_t))
+        {
+            throw FileFormatException(L"DDS file is truncated", sourceName);
+        }
+
+        dds_header_dx10_t extendedHeader = reader.Read<dds_header_dx10_t>();
+
+        if (extendedHeader.resourceDimension != ResourceDimensionTexture2D)
+        {
+            throw FileFormatException(L"Only 2D DDS textures are supported", sourceName);
+        }
+
+        image.format = extendedHeader.dxgiFormat;
+        image.arraySize = extendedHeader.arraySize;
+        image.isCubeMap = (extendedHeader.miscFlag & ResourceMiscTextureCube) != 0;
+
+        if (image.isCubeMap)
+        {
+            image.arraySize *= 6;
+        }
+    }
+    else
+    {
+        if (header.caps2 & DdsCaps2Volume)
+        {
+            throw FileFormatException(L"Only 2D DDS textures are supported", sourceName);
+        }
+
+        if (header.caps2 & DdsCaps2CubeMap)
+        {
+            // Partial cube maps are not supported by D3D11.
+            if ((header.caps2 & DdsCaps2AllFaces) != DdsCaps2AllFaces)
+            {
+                throw FileFormatException(L"DDS cube map is missing faces", sourceName);
+            }
+
+            image.arraySize = 6;
+            image.isCubeMap = true;
+        }
+
+        image.format = LegacyFormat(header.pixelFormat);
+    }
+
+    const unsigned int bitsPerPixel = BitsPerPixel(image.format);
+
+    if (bitsPerPixel == 0)
+    {
+        throw FileFormatException(L"Unsupported DDS pixel format", sourceName);
+    }
+
+    if (image.width == 0 || image.height == 0 || image.arraySize == 0 || image.mipCount > 32)
+    {
+        throw FileFormatException(L"Invalid DDS dimensions", sourceName);
+    }
+
+    // Every subresource takes at least one byte, reject huge counts before allocating for them.
+    if (static_cast<unsigned long long>(image.arraySize) * image.mipCount > size)
+    {
+        throw FileFormatException(L"DDS file is truncated", sourceName);
+    }
+
+    // Lay out every mip level of every slice back to back, validating that the file is big enough as we go.
+    unsigned long long offset = reader.Position();
+    const bool isBlockCompressed = IsBlockCompressed(image.format);
+    image.subresources.reserve(image.arraySize * image.mipCount);
+
+    for (unsigned int slice = 0; slice < image.arraySize; ++slice)
+    {
+        unsigned int width = image.width;
+        unsigned int height = image.height;
+
+        for (unsigned int mip = 0; mip < image.mipCount; ++mip)
+        {
+            dds_subresource_t subresource;
+            unsigned long long rowCount = 0;
+            unsigned long long rowPitch = 0;
+
+            if (isBlockCompressed)
+            {
+                rowPitch = std::max(1ull, (width + 3ull) / 4ull) * BlockBytes(image.format);
+                rowCount = std::max(1ull, (height + 3ull) / 4ull);
+            }
+            else
+            {
+                rowPitch = (static_cast<unsigned long long>(width) * bitsPerPixel + 7ull) / 8ull;
+                rowCount = height;
+            }
+
+            unsigned long long slicePitch = rowPitch * rowCount;
+
+            if (slicePitch > size || offset > size - slicePitch)
+            {
+                throw FileFormatException(L"DDS file is truncated", sourceName);
+            }
+
+            subresource.offset = static_cast<size_t>(offset);
+            subresource.width = width;
+            subresource.height = height;
+            subresource.rowPitch = static_cast<unsigned int>(rowPitch);
+            subresource.slicePitch = static_cast<unsigned int>(slicePitch);
+
+            image.subresources.push_back(subresource);
+            offset += slicePitch;
+
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+    }
+
+    *pImageOut = image;
+}
+
+void DdsFile::ReadSubresource(StreamReader& reader, const dds_subresource_t& subresource, char * pDst)
+{
+    if (subresource.offset < reader.Position())
+    {
+        throw SandboxException(L"DDS subresources must be read in order", reader.SourceName());
+    }
+
+    reader.Skip(subresource.offset - reader.Position());
+    reader.Read(pDst, subresource.slicePitch);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>     // size_t
+
+class StreamReader;
+
+/**
+ * \brief Location of one mip level of one array slice inside a DDS file.
+ */
+struct dds_subresource_t
+{
+    size_t offset;                  // From the start of the file.
+    unsigned int width;
+    unsigned int height;
+    unsigned int rowPitch;          // Bytes per row, or per row of 4x4 blocks for block compressed formats.
+    unsigned int slicePitch;        // Bytes in the whole level.
+};
+
+/**
+ * \brief Parsed DDS file header and the layout of its pixel data.
+ *
+ * Subresources are ordered the way D3D11 numbers them: every mip level of the first array slice, then every mip level
+ * of the second and so on. Cube maps are stored as six array slices per cube.
+ */
+struct dds_image_t
+{
+    unsigned int width;
+    unsigned int height;
+    unsigned int mipCount;
+    unsigned int arraySize;         // Number of 2D slices, six per cube for cube maps.
+    unsigned int format;            // DXGI_FORMAT value.
+    bool isCubeMap;
+    std::vector<dds_subresource_t> subresources;
+};
+
+/**
+ * \brief DirectDraw Surface (.dds) parsing.
+ *
+ * Parsing only reads the header and computes where every mip level lives in the file, so it is cheap, touches no
+ * pixel data and needs no device. That lets texture loading do everything except the final upload off the render
+ * thread. Supports 2D textures, texture arrays and cube maps in the common uncompressed and BC1-BC7 formats, from
+ * either legacy headers or the DX10 extended header.
+ */
+namespace DdsFile
+{
+    // Parse a .dds image, throwing FileFormatException for anything malformed or unsupported. The source name is
+    // only used for error reporting.
+    void Parse(const char * pBuffer, size_t size, const std::wstring& sourceName, dds_image_t *pImageOut);
+
+    // Parse only the header out of a stream, leaving the reader at the first subresource. Read the pixels with
+    // ReadSubresource() one level at a time, so the whole file never has to be in memory at once.
+    void Parse(StreamReader& reader, dds_image_t *pImageOut);
+
+    // Read one subresource's slicePitch bytes into pDst. Subresources must be read in order, skipped ones are
+    // passed over.
+    void ReadSubresource(StreamReader& reader, const dds_subresource_t& subresource, char * pDst);
+
+    // Bits per pixel of a supported DXGI format, zero if the format is not supported.
+    unsigned int BitsPerPixel(unsigned int format);
+
+    bool IsBlockCompressed(unsigned int format);
+}
@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "FrameArena.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Enough for a few overflow blocks without the block list itself reallocating.
+    const size_t ReservedBlockCount = 8;
+}
+
+FrameArena::FrameArena(size_t capacity)
+    : mBlocks(),
+      mCurrentBlock(0),
+      mOffset(0),
+      mUsed(0),
+      mHighWaterMark(0),
+      mHeapAllocationCount(0)
+{
+    mBlocks.reserve(ReservedBlockCount);
+    AddBlock(std::max(capacity, static_cast<size_t>(DefaultAlignment)));
+}
+
+FrameArena::~FrameArena()
+{
+    FreeBlocksAfter(0);
+    delete[] mBlocks[0].pMemory;
+}
+
+void * FrameArena::Allocate(size_t size, size_t alignment)
+{
+    Verify(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    for (;;)
+    {
+        const block_t& block = mBlocks[mCurrentBlock];
+        const size_t address = reinterpret_cast<size_t>(block.pMemory) + mOffset;
+        const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+        if (padding + size <= block.size - mOffset)
+        {
+            void * pMemory = block.pMemory + mOffset + padding;
+
+            mOffset += padding + size;
+            mUsed += padding + size;
+            mHighWaterMark = std::max(mHighWaterMark, mUsed);
+
+            return pMemory;
+        }
+
+        // Move on to the next overflow block, or take a new one at least as big as the main block.
+        if (mCurrentBlock + 1 == mBlocks.size())
+        {
+            AddBlock(std::max(size + alignment, mBlocks[0].size));
+        }
+
+        mCurrentBlock++;
+        mOffset = 0;
+    }
+}
+
+arena_mark_t FrameArena::Mark() const
+{
+    arena_mark_t mark = { mCurrentBlock, mOffset, mUsed };
+    return mark;
+}
+
+void FrameArena::Rewind(const arena_mark_t& mark)
+{
+    Verify(mark.block < mBlocks.size() && mark.used <= mUsed);
+
+    // Keep the overflow block the mark is in, later allocations will reuse it.
+    FreeBlocksAfter(std::max<size_t>(mark.block, 1));
+
+    mCurrentBlock = mark.block;
+    mOffset = mark.offset;
+    mUsed = mark.used;
+}
+
+void FrameArena::Reset()
+{
+    const bool overflowed = mBlocks.size() > 1;
+
+    FreeBlocksAfter(0);
+
+    // Grow to what the last frames needed, so the next one fits in the main block.
+    if (overflowed && mHighWaterMark > mBlocks[0].size)
+    {
+        delete[] mBlocks[0].pMemory;
+        mBlocks.clear();
+
+        AddBlock(mHighWaterMark + mHighWaterMark / 4);
+    }
+
+    mCurrentBlock = 0;
+    mOffset = 0;
+    mUsed = 0;
+}
+
+void FrameArena::AddBlock(size_t size)
+{
+    block_t block = { new char[size], size };
+
+    mBlocks.push_back(block);
+    mHeapAllocationCount++;
+}
+
+void FrameArena::FreeBlocksAfter(size_t block)
+{
+    while (mBlocks.size() > block + 1)
+    {
+        delete[] mBlocks.back().pMemory;
+        mBlocks.pop_back();
+    }
+}
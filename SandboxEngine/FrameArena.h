@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>      // size_t
+#include <type_traits>  // alignment_of
+#include <vector>
+
+/**
+ * \brief Position in a FrameArena, everything allocated after it is released by FrameArena::Rewind().
+ */
+struct arena_mark_t
+{
+    size_t block;
+    size_t offset;
+    size_t used;
+};
+
+/**
+ * \brief Bump allocator for memory that only lives until the end of a frame or a function.
+ *
+ * Allocating moves an offset forward in one preallocated block and freeing single allocations is not possible:
+ * Reset() releases everything at once at the end of the frame, and Rewind() releases everything allocated after a
+ * Mark(). Nothing is constructed or destroyed, so only use it for trivially destructible data, or with
+ * ArenaAllocator for containers that are destroyed before the arena is reset.
+ *
+ * When the block is full allocations go to extra heap blocks instead of failing. Reset() frees them and grows the
+ * main block to the high water mark, so an arena that was sized too small stops touching the heap after one frame.
+ * HeapAllocationCount() counts every block taken from the heap, to check that it settles.
+ *
+ * Not thread safe. Give each thread its own arena, see ScratchArena.h.
+ */
+class FrameArena
+{
+public:
+    static const size_t DefaultAlignment = 16;
+
+    explicit FrameArena(size_t capacity);
+    FrameArena(const FrameArena&) = delete;
+    ~FrameArena();
+
+    FrameArena& operator =(const FrameArena&) = delete;
+
+    // Size bytes aligned to alignment, which must be a power of two. Never returns null.
+    void * Allocate(size_t size, size_t alignment = DefaultAlignment);
+
+    // Uninitialized memory for count objects of type T.
+    template<typename T>
+    T * AllocateArray(size_t count)
+    {
+        return static_cast<T *>(Allocate(count * sizeof(T), std::alignment_of<T>::value));
+    }
+
+    arena_mark_t Mark() const;
+    void Rewind(const arena_mark_t& mark);
+
+    // Release every allocation, normally at the end of the frame.
+    void Reset();
+
+    // Bytes in the main block.
+    size_t Capacity() const { return mBlocks[0].size; }
+
+    // Bytes handed out since the last reset, including alignment padding.
+    size_t Used() const { return mUsed; }
+
+    // Most bytes in use at once since construction or ResetHighWaterMark().
+    size_t HighWaterMark() const { return mHighWaterMark; }
+    void ResetHighWaterMark() { mHighWaterMark = mUsed; }
+
+    // Blocks allocated from the heap, including the first one.
+    unsigned long long HeapAllocationCount() const { return mHeapAllocationCount; }
+
+private:
+    struct block_t
+    {
+        char * pMemory;
+        size_t size;
+    };
+
+    void AddBlock(size_t size);
+    void FreeBlocksAfter(size_t block);
+
+private:
+    std::vector<block_t> mBlocks;
+    size_t mCurrentBlock;
+    size_t mOffset;
+    size_t mUsed;
+    size_t mHighWaterMark;
+    unsigned long long mHeapAllocationCount;
+};
+
+/**
+ * \brief Standard library allocator that takes its memory from a FrameArena.
+ *
+ * Deallocation does nothing, the memory comes back when the arena is reset or rewound. Containers using it must be
+ * destroyed before that happens.
+ *
+ *  EXAMPLE:
+ *      std::vector<int, ArenaAllocator<int>> visible(ArenaAllocator<int>(frameArena));
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+    explicit ArenaAllocator(FrameArena& arena)
+        : mpArena(&arena)
+    {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : mpArena(other.Arena())
+    {
+    }
+
+    T * allocate(size_t count) { return mpArena->AllocateArray<T>(count); }
+    void deallocate(T *, size_t) { }
+
+    FrameArena * Arena() const { return mpArena; }
+
+    template<typename U>
+    bool operator ==(const ArenaAllocator<U>& other) const { return mpArena == other.Arena(); }
+
+    template<typename U>
+    bool operator !=(const ArenaAllocator<U>& other) const { return mpArena != other.Arena(); }
+
+private:
+    FrameArena * mpArena;
+};
@@ -0,0 +1,400 @@
+#include "stdafx.h"
+#include "FrameReplay.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "Stopwatch.h"
+#include "TextFormat.h"
+#include "size.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX::SimpleMath;
+
+namespace
+{
+    const float ScreenNear = 0.1f;
+    const float ScreenDepth = 1000.0f;
+    const size_t FrameArenaBytes = 256 * 1024;
+
+    // Ground covered per model, so the number of models on screen grows with the model count rather than the
+    // density of the scene.
+    const float GroundPerModel = 64.0f;
+
+    // The camera circles the origin once every OrbitSeconds, outside most of the scene and looking down at it.
+    const double OrbitSeconds = 20.0;
+    const float OrbitRadiusScale = 0.75f;
+    const float CameraHeight = 12.0f;
+
+    // The whole scene turns slowly, like the spinning world in Graphics::Frame().
+    const double WorldSpinRadiansPerSecond = 0.1;
+
+    const unsigned long long FnvOffsetBasis = 0xCBF29CE484222325ull;
+    const unsigned long long FnvPrime = 0x100000001B3ull;
+
+    // Same layouts as LightShader's constant buffers.
+    struct matrix_buffer_t
+    {
+        Matrix world;
+        Matrix view;
+        Matrix projection;
+    };
+
+    struct camera_buffer_t
+    {
+        Vector3 cameraPosition;
+        float padding;
+    };
+
+    struct light_buffer_t
+    {
+        Vector4 ambientColor;
+        Vector4 diffuseColor;
+        Vector3 lightDirection;
+        float specularPower;
+        Vector4 specularColor;
+    };
+
+    unsigned long long HashCombine(unsigned long long hash, unsigned long long value)
+    {
+        return (hash ^ value) * FnvPrime;
+    }
+
+    unsigned int FloatBits(float value)
+    {
+        unsigned int bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // Nearest rank percentile of sorted values.
+    double Percentile(const std::vector<double>& sorted, double percent)
+    {
+        const double rank = std::ceil(percent / 100.0 * static_cast<double>(sorted.size()));
+        const size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+FrameReplay::FrameReplay(const frame_replay_settings_t& settings)
+    : mSettings(settings),
+      mCamera(Size(settings.screenWidth, settings.screenHeight), ScreenNear, ScreenDepth),
+      mFrustum(),
+      mLodSelector(),
+      mFrameArena(FrameArenaBytes),
+      mStats(std::max(settings.frameCount, 1u)),
+      mMeshes(),
+      mModels(),
+      mSceneExtent(0.0f),
+      mUploadSink(0)
+{
+    BuildScene();
+}
+
+FrameReplay::~FrameReplay()
+{
+}
+
+frame_replay_settings_t FrameReplay::DefaultSettings()
+{
+    frame_replay_settings_t settings;
+
+    settings.modelCount = 2000;
+    settings.frameCount = 600;
+    settings.warmupFrames = 60;
+    settings.timestep = 1.0 / 60.0;
+    settings.seed = 0x5EED;
+    settings.screenWidth = 1280;
+    settings.screenHeight = 720;
+
+    return settings;
+}
+
+void FrameReplay::BuildScene()
+{
+    // A few meshes of different sizes with four levels of detail each, shaped like MeshSimplifier output: every
+    // level has half the triangles of the one before and a larger error.
+    const float meshRadii[] = { 0.5f, 1.0f, 2.0f, 4.0f };
+    const unsigned int fullDetailTriangles[] = { 2000, 8000, 12000, 24000 };
+
+    for (size_t i = 0; i < sizeof(meshRadii) / sizeof(meshRadii[0]); ++i)
+    {
+        const float radius = meshRadii[i];
+        const float halfExtents[3] = { radius * 0.8f, radius * 0.5f, radius * 0.3f };
+
+        mesh_t mesh;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            mesh.bounds.box.min[axis] = -halfExtents[axis];
+            mesh.bounds.box.max[axis] = halfExtents[axis];
+            mesh.bounds.sphere.center[axis] = 0.0f;
+        }
+
+        mesh.bounds.sphere.radius = radius;
+
+        for (unsigned int level = 0; level < 4; ++level)
+        {
+            mesh.lodErrors.push_back(level == 0 ? 0.0f : radius * 0.005f * static_cast<float>(1 << (2 * level)));
+            mesh.lodIndexCounts.push_back(3 * (fullDetailTriangles[i] >> level));
+        }
+
+        mMeshes.push_back(mesh);
+    }
+
+    // Scatter the models over a square of ground. The seed decides everything about the scene.
+    Random random(mSettings.seed);
+    mSceneExtent = 0.5f * std::sqrt(GroundPerModel * static_cast<float>(mSettings.modelCount));
+
+    mModels.reserve(mSettings.modelCount);
+
+    for (unsigned int i = 0; i < mSettings.modelCount; ++i)
+    {
+        model_t model;
+
+        model.mesh = random.NextUInt(static_cast<unsigned int>(mMeshes.size()));
+        model.position = Vector3(
+            random.NextFloat(-mSceneExtent, mSceneExtent),
+            random.NextFloat(0.0f, 4.0f),
+            random.NextFloat(-mSceneExtent, mSceneExtent));
+        model.currentLod = 0;
+
+        mModels.push_back(model);
+    }
+}
+
+void FrameReplay::PlaceCamera(double time)
+{
+    const double angle = 2.0 * 3.141592653589793 * time / OrbitSeconds;
+    const float radius = std::max(mSceneExtent * OrbitRadiusScale, 10.0f);
+
+    const Vector3 position(
+        radius * static_cast<float>(std::sin(angle)),
+        CameraHeight,
+        radius * static_cast<float>(std::cos(angle)));
+
+    // Face the origin, tilted down towards it. Camera rotations are in degrees.
+    const float degreesPerRadian = 57.2957795f;
+    const float yaw = std::atan2(-position.x, -position.z) * degreesPerRadian;
+    const float pitch = std::atan2(CameraHeight, radius) * degreesPerRadian;
+
+    mCamera.SetPosition(position);
+    mCamera.SetRotation(Vector3(pitch, yaw, 0.0f));
+}
+
+frame_replay_result_t FrameReplay::Run()
+{
+    frame_replay_result_t result;
+
+    result.drawCalls = 0;
+    result.objectsCulled = 0;
+    result.trianglesSubmitted = 0;
+    result.checksum = FnvOffsetBasis;
+    result.frameMilliseconds.reserve(mSettings.frameCount);
+
+    // Start from the same state every run, so repeated runs replay the same frames.
+    mStats.Reset();
+
+    for (model_t& model : mModels)
+    {
+        model.currentLod = 0;
+    }
+
+    for (unsigned int frame = 0; frame < mSettings.frameCount; ++frame)
+    {
+        Stopwatch stopwatch;
+        const unsigned long long frameHash = Frame(frame);
+        const double milliseconds = stopwatch.ElapsedSeconds() * 1000.0;
+
+        if (frame >= mSettings.warmupFrames)
+        {
+            result.frameMilliseconds.push_back(milliseconds);
+        }
+
+        result.checksum = HashCombine(result.checksum, frameHash);
+        result.drawCalls += mStats.Current(RenderCounter::DrawCalls);
+        result.objectsCulled += mStats.Current(RenderCounter::ObjectsCulled);
+        result.trianglesSubmitted += mLodSelector.FrameStats().trianglesSubmitted;
+
+        mStats.EndFrame();
+    }
+
+    result.timing = Summarize(result.frameMilliseconds);
+    return result;
+}
+
+unsigned long long FrameReplay::Frame(unsigned int frameIndex)
+{
+    PROFILE_SCOPE("FrameReplay::Frame");
+
+    // Time only ever comes from the frame index, never the clock.
+    const double time = static_cast<double>(frameIndex) * mSettings.timestep;
+
+    PlaceCamera(time);
+
+    mCamera.Render();
+    mFrustum.Update(mCamera);
+    mLodSelector.BeginFrame(mCamera.FieldOfView(), mCamera.ScreenHeight());
+
+    const Matrix worldMatrix = Matrix::CreateRotationY(static_cast<float>(time * WorldSpinRadiansPerSecond));
+
+    // Cull first and collect what is visible in the frame arena, then draw. Same steps as Graphics::Render().
+    std::vector<draw_t, ArenaAllocator<draw_t>> draws((ArenaAllocator<draw_t>(mFrameArena)));
+    draws.reserve(mModels.size());
+
+    unsigned long long hash = FnvOffsetBasis;
+
+    for (size_t i = 0; i < mModels.size(); ++i)
+    {
+        model_t& model = mModels[i];
+        const mesh_t& mesh = mMeshes[model.mesh];
+
+        const Matrix modelToWorldMatrix = Matrix::CreateTranslation(model.position) * worldMatrix;
+
+        const bounding_sphere_t sphere = BoundingVolumes::TransformSphere(mesh.bounds.sphere, &modelToWorldMatrix._11);
+        const Vector3 sphereCenter(sphere.center[0], sphere.center[1], sphere.center[2]);
+
+        mStats.Add(RenderCounter::ObjectsTested);
+
+        if (!mFrustum.CheckSphere(sphereCenter, sphere.radius))
+        {
+            mStats.Add(RenderCounter::ObjectsCulled);
+            continue;
+        }
+
+        const aabb_t box = BoundingVolumes::TransformAabb(mesh.bounds.box, &modelToWorldMatrix._11);
+        const Vector3 boxMin(box.min[0], box.min[1], box.min[2]);
+        const Vector3 boxMax(box.max[0], box.max[1], box.max[2]);
+
+        if (!mFrustum.CheckRectangle((boxMin + boxMax) * 0.5f, (boxMax - boxMin) * 0.5f))
+        {
+            mStats.Add(RenderCounter::ObjectsCulled);
+            continue;
+        }
+
+        const unsigned int levelCount = static_cast<unsigned int>(mesh.lodErrors.size());
+        const unsigned int lod = mLodSelector.SelectLevel(
+            &mesh.lodErrors[0],
+            levelCount,
+            Vector3::Distance(sphereCenter, mCamera.Position()),
+            sphere.radius,
+            BoundingVolumes::MaxScale(&modelToWorldMatrix._11),
+            model.currentLod);
+
+        model.currentLod = lod;
+        mLodSelector.RecordDraw(mesh.lodIndexCounts[lod] / 3, mesh.lodIndexCounts[0] / 3);
+
+        draw_t draw = { static_cast<unsigned int>(i), lod, modelToWorldMatrix };
+        draws.push_back(draw);
+
+        hash = HashCombine(hash, (static_cast<unsigned long long>(i) << 8) | lod);
+    }
+
+    for (const draw_t& draw : draws)
+    {
+        Submit(draw);
+    }
+
+    draws.clear();
+    mFrameArena.Reset();
+
+    return hash;
+}
+
+void FrameReplay::Submit(const draw_t& draw)
+{
+    // The null backend: fill the same constants LightShader uploads into memory standing in for the mapped
+    // buffers, and count the binds, maps and draw the Direct3D path makes.
+    const mesh_t& mesh = mMeshes[mModels[draw.model].mesh];
+
+    matrix_buffer_t * pMatrices = mFrameArena.AllocateArray<matrix_buffer_t>(1);
+    pMatrices->world = draw.worldMatrix.Transpose();
+    pMatrices->view = mCamera.ViewMatrix().Transpose();
+    pMatrices->projection = mCamera.ProjectionMatrix().Transpose();
+
+    camera_buffer_t * pCamera = mFrameArena.AllocateArray<camera_buffer_t>(1);
+    pCamera->cameraPosition = mCamera.Position();
+    pCamera->padding = 0.0f;
+
+    light_buffer_t * pLight = mFrameArena.AllocateArray<light_buffer_t>(1);
+    pLight->ambientColor = Vector4(0.15f, 0.15f, 0.15f, 1.0f);
+    pLight->diffuseColor = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+    pLight->lightDirection = Vector3(0.0f, 0.0f, 1.0f);
+    pLight->specularPower = 32.0f;
+    pLight->specularColor = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+
+    mUploadSink += FloatBits(pMatrices->world._41) ^ FloatBits(pCamera->cameraPosition.x);
+
+    // Vertex and index buffer, three constant buffers.
+    mStats.Add(RenderCounter::BufferBinds, 5);
+    mStats.Add(RenderCounter::MapCalls, 3);
+    mStats.Add(
+        RenderCounter::BytesUploaded,
+        sizeof(matrix_buffer_t) + sizeof(camera_buffer_t) + sizeof(light_buffer_t));
+
+    // Input layout and two shaders, texture and sampler, one draw.
+    mStats.Add(RenderCounter::ShaderBinds, 3);
+    mStats.Add(RenderCounter::ResourceBinds, 2);
+    mStats.Add(RenderCounter::DrawCalls);
+    mStats.Add(RenderCounter::Indices, mesh.lodIndexCounts[draw.lod]);
+}
+
+frame_timing_summary_t FrameReplay::Summarize(const std::vector<double>& frameMilliseconds)
+{
+    frame_timing_summary_t summary = { frameMilliseconds.size(), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+    if (frameMilliseconds.empty())
+    {
+        return summary;
+    }
+
+    std::vector<double> sorted(frameMilliseconds);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+
+    for (double milliseconds : sorted)
+    {
+        total += milliseconds;
+    }
+
+    summary.min = sorted.front();
+    summary.mean = total / static_cast<double>(sorted.size());
+    summary.p50 = Percentile(sorted, 50.0);
+    summary.p95 = Percentile(sorted, 95.0);
+    summary.p99 = Percentile(sorted, 99.0);
+    summary.max = sorted.back();
+
+    return summary;
+}
+
+std::string FrameReplay::Report(const frame_replay_result_t& result) const
+{
+    const frame_timing_summary_t& timing = result.timing;
+    const double frames = static_cast<double>(std::max(mSettings.frameCount, 1u));
+
+    FormatBuffer text;
+
+    text << "Frame replay: " << mSettings.modelCount << " models, " << mSettings.frameCount << " frames ("
+         << mSettings.warmupFrames << " warm up) at " << TextFormat::Fixed(1.0 / mSettings.timestep, 1) << " Hz, "
+         << mSettings.screenWidth << "x" << mSettings.screenHeight << ", seed 0x" << TextFormat::Hex(mSettings.seed)
+         << "\n";
+
+    text << "CPU ms per frame over " << timing.frames << " frames: min " << TextFormat::Fixed(timing.min, 3)
+         << ", mean " << TextFormat::Fixed(timing.mean, 3)
+         << ", p50 " << TextFormat::Fixed(timing.p50, 3)
+         << ", p95 " << TextFormat::Fixed(timing.p95, 3)
+         << ", p99 " << TextFormat::Fixed(timing.p99, 3)
+         << ", max " << TextFormat::Fixed(timing.max, 3) << "\n";
+
+    text << "Per frame: " << TextFormat::Fixed(static_cast<double>(result.drawCalls) / frames, 1) << " draws, "
+         << TextFormat::Fixed(static_cast<double>(result.objectsCulled) / frames, 1) << " culled, "
+         << TextFormat::Fixed(static_cast<double>(result.trianglesSubmitted) / frames, 0) << " triangles\n";
+
+    text << "Draw list checksum: 0x" << TextFormat::Hex(result.checksum, 16) << "\n\n";
+    text << mStats.Dump();
+
+    return text.ToString();
+}
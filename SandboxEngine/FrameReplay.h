@@ -0,0 +1,129 @@
+#pragma once
+#include "Camera.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "LodSelector.h"
+#include "MathTypes.h"
+#include "RenderStats.h"
+#include "BoundingVolumes.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \brief What FrameReplay draws and for how long. See FrameReplay::DefaultSettings().
+ */
+struct frame_replay_settings_t
+{
+    unsigned int modelCount;
+    unsigned int frameCount;            // Frames replayed, including the warm up frames.
+    unsigned int warmupFrames;          // First frames left out of the timings while caches and the arena settle.
+    double timestep;                    // Simulated seconds per frame, independent of how long a frame takes.
+    unsigned long long seed;            // Decides where every model is and which mesh it uses.
+    unsigned int screenWidth;
+    unsigned int screenHeight;
+};
+
+/**
+ * \brief Distribution of frame times, in milliseconds. Percentiles use the nearest rank.
+ */
+struct frame_timing_summary_t
+{
+    size_t frames;
+    double min;
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+/**
+ * \brief Outcome of FrameReplay::Run().
+ */
+struct frame_replay_result_t
+{
+    std::vector<double> frameMilliseconds;      // CPU time of every timed frame, in order.
+    frame_timing_summary_t timing;
+    unsigned long long drawCalls;               // Totals over every replayed frame, warm up included.
+    unsigned long long objectsCulled;
+    unsigned long long trianglesSubmitted;
+    unsigned long long checksum;                // Hash of every frame's draw list, equal for equal settings.
+};
+
+/**
+ * \brief Runs the CPU side of a frame without a window or a GPU, for repeatable performance comparisons.
+ *
+ * The scene is a scripted set of models scattered by a seeded Random, seen from a camera flying a fixed orbit. Each
+ * frame advances the clock by a fixed timestep and does what Graphics::Render does on the CPU: update the camera
+ * and frustum, cull every model against its bounding sphere and box, pick a level of detail, build the draw list in
+ * a frame arena and fill the constant buffers for each draw. The draws go to a null backend that counts them in
+ * RenderStats the same way the Direct3D renderer does, but never touches a device.
+ *
+ * Nothing depends on the wall clock, so two runs with the same settings produce the same draw lists, and the same
+ * checksum, on any machine. Only the timings change.
+ */
+class FrameReplay
+{
+public:
+    explicit FrameReplay(const frame_replay_settings_t& settings);
+    FrameReplay(const FrameReplay&) = delete;
+    ~FrameReplay();
+
+    FrameReplay& operator =(const FrameReplay&) = delete;
+
+    // 2000 models over 600 frames at 60 Hz, the first 60 not timed.
+    static frame_replay_settings_t DefaultSettings();
+
+    // Replay every frame from the start of the camera path.
+    frame_replay_result_t Run();
+
+    // Per frame counters over the whole replay, warm up frames included.
+    const RenderStats& Stats() const { return mStats; }
+
+    // Settings, timings and counters as text for logs and consoles.
+    std::string Report(const frame_replay_result_t& result) const;
+
+    static frame_timing_summary_t Summarize(const std::vector<double>& frameMilliseconds);
+
+private:
+    // Meshes the scene's models are picked from. Level errors and index counts are per level of detail.
+    struct mesh_t
+    {
+        mesh_bounds_t bounds;
+        std::vector<float> lodErrors;
+        std::vector<unsigned int> lodIndexCounts;
+    };
+
+    struct model_t
+    {
+        unsigned int mesh;
+        DirectX::SimpleMath::Vector3 position;
+        unsigned int currentLod;
+    };
+
+    struct draw_t
+    {
+        unsigned int model;
+        unsigned int lod;
+        DirectX::SimpleMath::Matrix worldMatrix;
+    };
+
+private:
+    void BuildScene();
+    void PlaceCamera(double time);
+    unsigned long long Frame(unsigned int frameIndex);
+    void Submit(const draw_t& draw);
+
+private:
+    frame_replay_settings_t mSettings;
+    Camera mCamera;
+    Frustum mFrustum;
+    LodSelector mLodSelector;
+    FrameArena mFrameArena;
+    RenderStats mStats;
+    std::vector<mesh_t> mMeshes;
+    std::vector<model_t> mModels;
+    float mSceneExtent;                 // Models are placed within this distance of the origin on x and z.
+    unsigned long long mUploadSink;     // Folds in the uploaded constants, so filling them is not optimized out.
+};
@@ -1,12 +1,15 @@
 #include "stdafx.h"
 #include "Frustum.h"
+#include "Camera.h"
 #include "Range.h"
-#include "SimpleMath.h"
+#include "MathTypes.h"
 
 using namespace DirectX::SimpleMath;
 
 Frustum::Frustum()
-    : mPlanes()
+    : mPlanes(),
+      mpCamera(nullptr),
+      mCameraRevision(0)
 {
     Clear();
 }
@@ -52,7 +55,30 @@ void Frustum::Update(float screenDepth, const Matrix& inProjectionMatrix, const
     projectionMatrix._43 = -r * zMinimum;
 
     // Create the frustum matrix from the view matrix, and updated projection matrix.
-    Matrix fMatrix = viewMatrix * projectionMatrix;
+    Update(viewMatrix * projectionMatrix);
+}
+
+bool Frustum::Update(const Camera& camera)
+{
+    if (mpCamera == &camera && mCameraRevision == camera.Revision())
+    {
+        return false;
+    }
+
+    // The camera's far plane is its screen depth, so its projection needs no adjusting.
+    Update(camera.ViewProjectionMatrix());
+
+    mpCamera = &camera;
+    mCameraRevision = camera.Revision();
+
+    return true;
+}
+
+void Frustum::Update(const Matrix& fMatrix)
+{
+    // Planes set by hand no longer match any camera.
+    mpCamera = nullptr;
+    mCameraRevision = 0;
 
     // Near frustum plane.
     mPlanes[0].x = fMatrix._14 + fMatrix._13;
@@ -174,7 +200,7 @@ bool Frustum::CheckRectangle(const Vector3& center, const Vector3& size) const
         if (mPlanes[i].DotCoordinate(a) < 0.0f && mPlanes[i].DotCoordinate(b) < 0.0f &&
             mPlanes[i].DotCoordinate(c) < 0.0f && mPlanes[i].DotCoordinate(d) < 0.0f &&
             mPlanes[i].DotCoordinate(e) < 0.0f && mPlanes[i].DotCoordinate(f) < 0.0f &&
-            mPlanes[i].DotCoordinate(g) < 0.0f && mPlanes[i].DotCoordinate(h))
+            mPlanes[i].DotCoordinate(g) < 0.0f && mPlanes[i].DotCoordinate(h) < 0.0f)
         {
             return false;
         }
@@ -185,6 +211,9 @@ bool Frustum::CheckRectangle(const Vector3& center, const Vector3& size) const
 
 void Frustum::Clear()
 {
+    mpCamera = nullptr;
+    mCameraRevision = 0;
+
     for (auto i : MakeRange<0, FrustumPlaneCount>())
     {
         mPlanes[i] = Plane(0.0f, 0.0f, 0.0f, 0.0f);
@@ -1,7 +1,9 @@
 #pragma once
-#include "SimpleMath.h"
+#include "MathTypes.h"
 #include <array>
 
+class Camera;
+
 // TODO: Convert Check* to use structures representing the primitive, or at least wrap up the vectors.
 class Frustum
 {
@@ -21,10 +23,20 @@ public:
     void Update(float screenDepth,
                 const DirectX::SimpleMath::Matrix& projectionMatrix,
                 const DirectX::SimpleMath::Matrix& viewMatrix);
+
+    // Extract the planes from a combined view-projection matrix.
+    void Update(const DirectX::SimpleMath::Matrix& viewProjectionMatrix);
+
+    // Rebuild the planes from the camera's cached view-projection, only if the camera changed since the last call.
+    // Returns true if the planes were rebuilt.
+    bool Update(const Camera& camera);
+
     void Clear();
 
 private:
     static const int FrustumPlaneCount = 6;
     std::array<DirectX::SimpleMath::Plane, FrustumPlaneCount> mPlanes;
+    const Camera * mpCamera;
+    unsigned int mCameraRevision;
 };
 
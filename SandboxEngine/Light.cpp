@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "Light.h"
-#include "SimpleMath.h"
+#include "MathTypes.h"
 
 using namespace DirectX::SimpleMath;
 
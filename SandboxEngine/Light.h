@@ -1,6 +1,6 @@
 #pragma once
 
-#include "SimpleMath.h"
+#include "MathTypes.h"
 
 /**
  * \brief Holds values required for lighting computation.
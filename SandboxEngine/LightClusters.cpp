@@ -0,0 +1,495 @@
+#include "stdafx.h"
+#include "LightClusters.h"
+#include "Camera.h"
+#include "CpuFeatures.h"
+#include "DXSandbox.h"
+#include "ThreadPool.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX::SimpleMath;
+
+// The overlap kernels follow TransformKernels: a scalar, SSE2 and AVX2 version each taking [begin, count) and
+// returning the index they stopped at, with the SIMD versions leaving the last partial register to the next narrower
+// one. All three compute the same expressions in the same order, so they select the same lights.
+namespace
+{
+#ifdef SANDBOX_AVX2
+    const bool GHasAvx2 = CpuFeatures::DetectAvx2();
+#endif
+
+    struct sphere_arrays_t
+    {
+        const float * pX;
+        const float * pY;
+        const float * pZ;
+        const float * pRadiusSquared;
+        const unsigned short * pLight;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // Sphere against box: the squared distance from the center to the box is no more than the radius squared.
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t OverlapsScalar(
+        const sphere_arrays_t& spheres,
+        const aabb_t& box,
+        size_t begin,
+        size_t count,
+        unsigned short * pOut,
+        size_t * pWritten)
+    {
+        size_t written = *pWritten;
+
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float dx = std::max(std::max(box.min[0] - spheres.pX[i], spheres.pX[i] - box.max[0]), 0.0f);
+            const float dy = std::max(std::max(box.min[1] - spheres.pY[i], spheres.pY[i] - box.max[1]), 0.0f);
+            const float dz = std::max(std::max(box.min[2] - spheres.pZ[i], spheres.pZ[i] - box.max[2]), 0.0f);
+
+            if (dx * dx + dy * dy + dz * dz <= spheres.pRadiusSquared[i])
+            {
+                pOut[written++] = spheres.pLight[i];
+            }
+        }
+
+        *pWritten = written;
+        return count;
+    }
+
+#ifdef SANDBOX_SSE2
+    size_t OverlapsSse2(
+        const sphere_arrays_t& spheres,
+        const aabb_t& box,
+        size_t begin,
+        size_t count,
+        unsigned short * pOut,
+        size_t * pWritten)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minX = _mm_set1_ps(box.min[0]), maxX = _mm_set1_ps(box.max[0]);
+        const __m128 minY = _mm_set1_ps(box.min[1]), maxY = _mm_set1_ps(box.max[1]);
+        const __m128 minZ = _mm_set1_ps(box.min[2]), maxZ = _mm_set1_ps(box.max[2]);
+
+        size_t written = *pWritten;
+        size_t i = begin;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(spheres.pX + i);
+            const __m128 y = _mm_loadu_ps(spheres.pY + i);
+            const __m128 z = _mm_loadu_ps(spheres.pZ + i);
+
+            const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+            const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+            const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+
+            const __m128 distanceSquared =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            const int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_loadu_ps(spheres.pRadiusSquared + i)));
+
+            // Most tests miss. Hits are packed without branches: every lane is written, only hits advance.
+            if (mask != 0)
+            {
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    pOut[written] = spheres.pLight[i + lane];
+                    written += (mask >> lane) & 1;
+                }
+            }
+        }
+
+        *pWritten = written;
+        return i;
+    }
+#endif
+
+#ifdef SANDBOX_AVX2
+    SANDBOX_TARGET_AVX2 size_t OverlapsAvx2(
+        const sphere_arrays_t& spheres,
+        const aabb_t& box,
+        size_t begin,
+        size_t count,
+        unsigned short * pOut,
+        size_t * pWritten)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 minX = _mm256_set1_ps(box.min[0]), maxX = _mm256_set1_ps(box.max[0]);
+        const __m256 minY = _mm256_set1_ps(box.min[1]), maxY = _mm256_set1_ps(box.max[1]);
+        const __m256 minZ = _mm256_set1_ps(box.min[2]), maxZ = _mm256_set1_ps(box.max[2]);
+
+        size_t written = *pWritten;
+        size_t i = begin;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(spheres.pX + i);
+            const __m256 y = _mm256_loadu_ps(spheres.pY + i);
+            const __m256 z = _mm256_loadu_ps(spheres.pZ + i);
+
+            const __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minX, x), _mm256_sub_ps(x, maxX)), zero);
+            const __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minY, y), _mm256_sub_ps(y, maxY)), zero);
+            const __m256 dz = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minZ, z), _mm256_sub_ps(z, maxZ)), zero);
+
+            const __m256 distanceSquared = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                _mm256_mul_ps(dz, dz));
+            const int mask = _mm256_movemask_ps(
+                _mm256_cmp_ps(distanceSquared, _mm256_loadu_ps(spheres.pRadiusSquared + i), _CMP_LE_OQ));
+
+            if (mask != 0)
+            {
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    pOut[written] = spheres.pLight[i + lane];
+                    written += (mask >> lane) & 1;
+                }
+            }
+        }
+
+        *pWritten = written;
+        return i;
+    }
+#endif
+
+    // Append the light of every sphere that overlaps the box.
+    void CollectOverlaps(
+        const sphere_arrays_t& spheres,
+        size_t count,
+        const aabb_t& box,
+        std::vector<unsigned short> * pOut)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        size_t written = pOut->size();
+        pOut->resize(written + count);
+
+        unsigned short * pIndices = &(*pOut)[0];
+        size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+        if (GHasAvx2)
+        {
+            done = OverlapsAvx2(spheres, box, done, count, pIndices, &written);
+        }
+#endif
+
+#ifdef SANDBOX_SSE2
+        done = OverlapsSse2(spheres, box, done, count, pIndices, &written);
+#endif
+
+        OverlapsScalar(spheres, box, done, count, pIndices, &written);
+        pOut->resize(written);
+    }
+
+    template<typename SphereSet>
+    sphere_arrays_t Arrays(const SphereSet& spheres)
+    {
+        sphere_arrays_t arrays =
+        {
+            spheres.x.data(),
+            spheres.y.data(),
+            spheres.z.data(),
+            spheres.radiusSquared.data(),
+            spheres.light.data()
+        };
+
+        return arrays;
+    }
+
+    void Include(aabb_t * pBox, const aabb_t& other)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            pBox->min[axis] = std::min(pBox->min[axis], other.min[axis]);
+            pBox->max[axis] = std::max(pBox->max[axis], other.max[axis]);
+        }
+    }
+
+    const aabb_t EmptyBox = { { 3.4e38f, 3.4e38f, 3.4e38f }, { -3.4e38f, -3.4e38f, -3.4e38f } };
+}
+
+void LightClusters::sphere_set_t::Resize(size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    radius.resize(count);
+    radiusSquared.resize(count);
+    light.resize(count);
+}
+
+LightClusters::LightClusters(unsigned int clustersX, unsigned int clustersY, unsigned int clustersZ)
+    : mClustersX(clustersX),
+      mClustersY(clustersY),
+      mClustersZ(clustersZ),
+      mFieldOfView(0.0f),
+      mAspectRatio(0.0f),
+      mScreenNear(0.0f),
+      mScreenDepth(0.0f),
+      mTanHalfFovX(0.0f),
+      mTanHalfFovY(0.0f),
+      mDepthSliceScale(0.0f),
+      mDepthSliceBias(0.0f),
+      mClusterBounds(clustersX * clustersY * clustersZ, EmptyBox),
+      mRowBounds(clustersY * clustersZ, EmptyBox),
+      mSliceBounds(clustersZ, EmptyBox),
+      mWorldSpheres(),
+      mViewSpheres(),
+      mSliceWork(clustersZ),
+      mClusterLists(clustersX * clustersY * clustersZ),
+      mLightIndices()
+{
+    Verify(clustersX > 0 && clustersY > 0 && clustersZ > 0);
+}
+
+LightClusters::~LightClusters()
+{
+}
+
+bounding_sphere_t LightClusters::LightBounds(const local_light_t& light)
+{
+    bounding_sphere_t sphere = { { light.position.x, light.position.y, light.position.z }, light.range };
+
+    if (light.type != LocalLightType::Spot || light.spotCosAngle <= 0.0f)
+    {
+        return sphere;
+    }
+
+    // A narrow cone fits in the sphere through its tip and the rim of its base. A wide one fits in the sphere
+    // around its base.
+    const float cosAngle = light.spotCosAngle;
+    float distance = 0.0f;
+
+    if (cosAngle >= 0.70710678f)
+    {
+        sphere.radius = light.range / (2.0f * cosAngle);
+        distance = sphere.radius;
+    }
+    else
+    {
+        sphere.radius = light.range * std::sqrt(1.0f - cosAngle * cosAngle);
+        distance = light.range * cosAngle;
+    }
+
+    sphere.center[0] += light.direction.x * distance;
+    sphere.center[1] += light.direction.y * distance;
+    sphere.center[2] += light.direction.z * distance;
+
+    return sphere;
+}
+
+void LightClusters::UpdateProjection(const Camera& camera)
+{
+    if (camera.FieldOfView() == mFieldOfView &&
+        camera.AspectRatio() == mAspectRatio &&
+        camera.ScreenNear() == mScreenNear &&
+        camera.ScreenDepth() == mScreenDepth)
+    {
+        return;
+    }
+
+    mFieldOfView = camera.FieldOfView();
+    mAspectRatio = camera.AspectRatio();
+    mScreenNear = camera.ScreenNear();
+    mScreenDepth = camera.ScreenDepth();
+
+    mTanHalfFovY = std::tan(mFieldOfView * 0.5f);
+    mTanHalfFovX = mTanHalfFovY * mAspectRatio;
+
+    // Slice k starts at near * (far / near) ^ (k / slices).
+    const float depthRatioLog = std::log(mScreenDepth / mScreenNear);
+
+    mDepthSliceScale = static_cast<float>(mClustersZ) / depthRatioLog;
+    mDepthSliceBias = static_cast<float>(mClustersZ) * std::log(mScreenNear) / depthRatioLog;
+
+    std::fill(mRowBounds.begin(), mRowBounds.end(), EmptyBox);
+    std::fill(mSliceBounds.begin(), mSliceBounds.end(), EmptyBox);
+
+    for (unsigned int z = 0; z < mClustersZ; ++z)
+    {
+        const float nearDepth = mScreenNear * std::pow(mScreenDepth / mScreenNear, float(z) / mClustersZ);
+        const float farDepth = mScreenNear * std::pow(mScreenDepth / mScreenNear, float(z + 1) / mClustersZ);
+
+        for (unsigned int y = 0; y < mClustersY; ++y)
+        {
+            // Tiles count down from the top of the screen, view space y points up.
+            const float top = 1.0f - 2.0f * float(y) / mClustersY;
+            const float bottom = 1.0f - 2.0f * float(y + 1) / mClustersY;
+
+            for (unsigned int x = 0; x < mClustersX; ++x)
+            {
+                const float left = -1.0f + 2.0f * float(x) / mClustersX;
+                const float right = -1.0f + 2.0f * float(x + 1) / mClustersX;
+
+                // The froxel's corners lie on the tile's four edge rays at its near and far depths.
+                const float xs[4] =
+                {
+                    left * nearDepth * mTanHalfFovX, right * nearDepth * mTanHalfFovX,
+                    left * farDepth * mTanHalfFovX, right * farDepth * mTanHalfFovX
+                };
+
+                const float ys[4] =
+                {
+                    bottom * nearDepth * mTanHalfFovY, top * nearDepth * mTanHalfFovY,
+                    bottom * farDepth * mTanHalfFovY, top * farDepth * mTanHalfFovY
+                };
+
+                aabb_t& box = mClusterBounds[ClusterIndex(x, y, z)];
+
+                box.min[0] = *std::min_element(xs, xs + 4);
+                box.max[0] = *std::max_element(xs, xs + 4);
+                box.min[1] = *std::min_element(ys, ys + 4);
+                box.max[1] = *std::max_element(ys, ys + 4);
+                box.min[2] = nearDepth;
+                box.max[2] = farDepth;
+
+                Include(&mRowBounds[z * mClustersY + y], box);
+                Include(&mSliceBounds[z], box);
+            }
+        }
+    }
+}
+
+unsigned int LightClusters::ClusterAt(const Vector3& viewPosition) const
+{
+    const float depth = std::max(viewPosition.z, mScreenNear);
+
+    const float slice = std::floor(std::log(depth) * mDepthSliceScale - mDepthSliceBias);
+    const float tileX = std::floor((viewPosition.x / (depth * mTanHalfFovX) + 1.0f) * 0.5f * mClustersX);
+    const float tileY = std::floor((1.0f - viewPosition.y / (depth * mTanHalfFovY)) * 0.5f * mClustersY);
+
+    const unsigned int x = static_cast<unsigned int>(std::min(std::max(tileX, 0.0f), float(mClustersX - 1)));
+    const unsigned int y = static_cast<unsigned int>(std::min(std::max(tileY, 0.0f), float(mClustersY - 1)));
+    const unsigned int z = static_cast<unsigned int>(std::min(std::max(slice, 0.0f), float(mClustersZ - 1)));
+
+    return ClusterIndex(x, y, z);
+}
+
+void LightClusters::Assign(const Camera& camera, const local_light_t * pLights, size_t lightCount)
+{
+    Assign(camera, pLights, lightCount, ThreadPool::Shared());
+}
+
+void LightClusters::Assign(const Camera& camera, const local_light_t * pLights, size_t lightCount, ThreadPool& pool)
+{
+    Verify(lightCount <= MaxLights);
+    Verify(lightCount == 0 || pLights != nullptr);
+
+    UpdateProjection(camera);
+
+    // Light bounds in world space, moved to view space in one batch.
+    mWorldSpheres.Resize(lightCount);
+    mViewSpheres.Resize(lightCount);
+
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        const bounding_sphere_t sphere = LightBounds(pLights[i]);
+
+        mWorldSpheres.x[i] = sphere.center[0];
+        mWorldSpheres.y[i] = sphere.center[1];
+        mWorldSpheres.z[i] = sphere.center[2];
+        mWorldSpheres.radius[i] = sphere.radius;
+    }
+
+    if (lightCount > 0)
+    {
+        soa_spheres_t world =
+        {
+            { &mWorldSpheres.x[0], &mWorldSpheres.y[0], &mWorldSpheres.z[0] }, &mWorldSpheres.radius[0]
+        };
+
+        soa_spheres_t view =
+        {
+            { &mViewSpheres.x[0], &mViewSpheres.y[0], &mViewSpheres.z[0] }, &mViewSpheres.radius[0]
+        };
+
+        TransformKernels::TransformSpheres(&camera.ViewMatrix()._11, world, view, lightCount);
+    }
+
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        mViewSpheres.radiusSquared[i] = mViewSpheres.radius[i] * mViewSpheres.radius[i];
+        mViewSpheres.light[i] = static_cast<unsigned short>(i);
+    }
+
+    pool.Run(mClustersZ, [this](size_t z) { AssignSlice(static_cast<unsigned int>(z)); });
+
+    // Pack the slices' lists into one array. Slice offsets were relative to their own list.
+    size_t indexCount = 0;
+
+    for (const slice_work_t& work : mSliceWork)
+    {
+        indexCount += work.indices.size();
+    }
+
+    mLightIndices.resize(indexCount);
+    unsigned int base = 0;
+
+    for (unsigned int z = 0; z < mClustersZ; ++z)
+    {
+        const std::vector<unsigned short>& indices = mSliceWork[z].indices;
+        const unsigned int firstCluster = ClusterIndex(0, 0, z);
+
+        for (unsigned int cluster = firstCluster; cluster < firstCluster + mClustersX * mClustersY; ++cluster)
+        {
+            mClusterLists[cluster].offset += base;
+        }
+
+        std::copy(indices.begin(), indices.end(), mLightIndices.begin() + base);
+        base += static_cast<unsigned int>(indices.size());
+    }
+}
+
+void LightClusters::AssignSlice(unsigned int z)
+{
+    slice_work_t& work = mSliceWork[z];
+    work.indices.clear();
+
+    // Lights touching the slice, then the ones touching each row, then each cluster of the row.
+    work.selected.clear();
+    CollectOverlaps(Arrays(mViewSpheres), mViewSpheres.x.size(), mSliceBounds[z], &work.selected);
+    Gather(work.selected, &work.sliceSpheres);
+
+    for (unsigned int y = 0; y < mClustersY; ++y)
+    {
+        work.selected.clear();
+        CollectOverlaps(
+            Arrays(work.sliceSpheres),
+            work.sliceSpheres.x.size(),
+            mRowBounds[z * mClustersY + y],
+            &work.selected);
+        Gather(work.selected, &work.rowSpheres);
+
+        for (unsigned int x = 0; x < mClustersX; ++x)
+        {
+            const unsigned int cluster = ClusterIndex(x, y, z);
+            const size_t offset = work.indices.size();
+
+            CollectOverlaps(Arrays(work.rowSpheres), work.rowSpheres.x.size(), mClusterBounds[cluster], &work.indices);
+
+            mClusterLists[cluster].offset = static_cast<unsigned int>(offset);
+            mClusterLists[cluster].count = static_cast<unsigned int>(work.indices.size() - offset);
+        }
+    }
+}
+
+void LightClusters::Gather(const std::vector<unsigned short>& lights, sphere_set_t * pSetOut) const
+{
+    pSetOut->Resize(lights.size());
+
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        const unsigned short light = lights[i];
+
+        pSetOut->x[i] = mViewSpheres.x[light];
+        pSetOut->y[i] = mViewSpheres.y[light];
+        pSetOut->z[i] = mViewSpheres.z[light];
+        pSetOut->radiusSquared[i] = mViewSpheres.radiusSquared[light];
+        pSetOut->light[i] = light;
+    }
+}
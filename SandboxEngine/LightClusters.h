@@ -0,0 +1,164 @@
+#pragma once
+#include "BoundingVolumes.h"
+#include "MathTypes.h"
+
+#include <vector>
+
+class Camera;
+class ThreadPool;
+
+/**
+ * \brief Kinds of local_light_t.
+ */
+enum class LocalLightType
+{
+    Point,
+    Spot
+};
+
+/**
+ * \brief A point or spot light that only reaches a limited distance, see LightClusters.
+ */
+struct local_light_t
+{
+    DirectX::SimpleMath::Vector3 position;          // World space.
+    float range;                                    // Nothing past this distance is lit.
+    DirectX::SimpleMath::Vector3 color;
+    float intensity;
+    DirectX::SimpleMath::Vector3 direction;         // Spot lights only. Normalized, world space.
+    float spotCosAngle;                             // Spot lights only. Cosine of the cone's half angle.
+    LocalLightType type;
+};
+
+/**
+ * \brief Offset and length of one cluster's run in LightClusters::LightIndices().
+ */
+struct cluster_light_list_t
+{
+    unsigned int offset;
+    unsigned int count;
+};
+
+/**
+ * \brief Assigns point and spot lights to the cells of a froxel grid built from a camera (clustered shading).
+ *
+ * The view frustum is split into ClustersX() by ClustersY() screen tiles and ClustersZ() depth slices. Slices are
+ * spaced exponentially between the camera's near and far planes, so each is about as deep as it is wide on screen.
+ * A pixel finds its cluster from its screen position and view depth (see DepthSliceScale()), and then only shades
+ * the lights listed for that cluster.
+ *
+ * Assign() tests each light's bounding sphere against the view space bounding box of every cluster it might touch.
+ * Lights are first tested against the whole depth slice, then against each row of the slice, then against the
+ * clusters of the rows they touched, four (SSE2) or eight (AVX2) lights per test. Each depth slice is one task on
+ * the thread pool and writes only its own clusters, so threads never share output. Boxes are a little larger than
+ * the froxels they bound, so a list may hold a light that just misses its cluster, but never leaves one out.
+ *
+ * The result is one index list per cluster packed into a single array of 16 bit light indices, ready to upload as
+ * GPU buffers. Buffers are kept between calls, so after the first few frames Assign() does not allocate.
+ */
+class LightClusters
+{
+public:
+    static const unsigned int DefaultClustersX = 16;
+    static const unsigned int DefaultClustersY = 9;
+    static const unsigned int DefaultClustersZ = 24;
+
+    // Light indices are 16 bit.
+    static const size_t MaxLights = 65535;
+
+public:
+    LightClusters(
+        unsigned int clustersX = DefaultClustersX,
+        unsigned int clustersY = DefaultClustersY,
+        unsigned int clustersZ = DefaultClustersZ);
+    LightClusters(const LightClusters&) = delete;
+    ~LightClusters();
+
+    LightClusters& operator =(const LightClusters&) = delete;
+
+    // Assign every light to the clusters of the camera's current view, on the given pool or the shared one.
+    void Assign(const Camera& camera, const local_light_t * pLights, size_t lightCount, ThreadPool& pool);
+    void Assign(const Camera& camera, const local_light_t * pLights, size_t lightCount);
+
+    unsigned int ClustersX() const { return mClustersX; }
+    unsigned int ClustersY() const { return mClustersY; }
+    unsigned int ClustersZ() const { return mClustersZ; }
+    unsigned int ClusterCount() const { return mClustersX * mClustersY * mClustersZ; }
+
+    // Tile x counts from the left of the screen and tile y from the top.
+    unsigned int ClusterIndex(unsigned int x, unsigned int y, unsigned int z) const
+    {
+        return (z * mClustersY + y) * mClustersX + x;
+    }
+
+    // Cluster holding a view space point. Points off screen or outside the depth range go to the nearest cluster.
+    unsigned int ClusterAt(const DirectX::SimpleMath::Vector3& viewPosition) const;
+
+    // View space bounds of a cluster, as used by Assign().
+    const aabb_t& ClusterBounds(unsigned int cluster) const { return mClusterBounds[cluster]; }
+
+    // Depth slice of a view depth is floor(log(depth) * DepthSliceScale() - DepthSliceBias()).
+    float DepthSliceScale() const { return mDepthSliceScale; }
+    float DepthSliceBias() const { return mDepthSliceBias; }
+
+    // One list per cluster, in ClusterIndex() order, pointing into LightIndices().
+    const std::vector<cluster_light_list_t>& ClusterLists() const { return mClusterLists; }
+    const std::vector<unsigned short>& LightIndices() const { return mLightIndices; }
+
+    // Sphere around everything the light reaches.
+    static bounding_sphere_t LightBounds(const local_light_t& light);
+
+private:
+    // Bounding spheres as parallel arrays, with the index of the light each came from.
+    struct sphere_set_t
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+        std::vector<float> radiusSquared;
+        std::vector<unsigned short> light;
+
+        void Resize(size_t count);
+    };
+
+    // Per depth slice state, only touched by the task working on that slice.
+    struct slice_work_t
+    {
+        sphere_set_t sliceSpheres;              // Lights touching the slice.
+        sphere_set_t rowSpheres;                // Lights touching the current row of the slice.
+        std::vector<unsigned short> selected;
+        std::vector<unsigned short> indices;    // Light lists of the slice's clusters, back to back.
+    };
+
+private:
+    void UpdateProjection(const Camera& camera);
+    void AssignSlice(unsigned int z);
+    void Gather(const std::vector<unsigned short>& lights, sphere_set_t * pSetOut) const;
+
+private:
+    unsigned int mClustersX;
+    unsigned int mClustersY;
+    unsigned int mClustersZ;
+
+    // Projection the bounds were built for.
+    float mFieldOfView;
+    float mAspectRatio;
+    float mScreenNear;
+    float mScreenDepth;
+    float mTanHalfFovX;
+    float mTanHalfFovY;
+    float mDepthSliceScale;
+    float mDepthSliceBias;
+
+    std::vector<aabb_t> mClusterBounds;
+    std::vector<aabb_t> mRowBounds;             // Union of each row of each slice, (z * ClustersY() + y).
+    std::vector<aabb_t> mSliceBounds;
+
+    sphere_set_t mWorldSpheres;
+    sphere_set_t mViewSpheres;
+    std::vector<slice_work_t> mSliceWork;
+
+    std::vector<cluster_light_list_t> mClusterLists;
+    std::vector<unsigned short> mLightIndices;
+};
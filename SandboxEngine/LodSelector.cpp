@@ -0,0 +1,104 @@
+#include "stdafx.h"
+#include "LodSelector.h"
+#include "DXSandbox.h"
+
+#include <cmath>
+
+namespace
+{
+    const float DefaultPixelThreshold = 1.0f;
+    const float DefaultHysteresis = 0.15f;
+}
+
+LodSelector::LodSelector()
+    : mPixelThreshold(DefaultPixelThreshold),
+      mHysteresis(DefaultHysteresis),
+      mLodBias(0.0f),
+      mPixelsPerUnit(1.0f),
+      mFrameStats()
+{
+}
+
+void LodSelector::SetPixelThreshold(float pixels)
+{
+    Verify(pixels > 0.0f);
+    mPixelThreshold = pixels;
+}
+
+void LodSelector::SetHysteresis(float fraction)
+{
+    Verify(fraction >= 0.0f && fraction < 1.0f);
+    mHysteresis = fraction;
+}
+
+void LodSelector::SetLodBias(float bias)
+{
+    mLodBias = bias;
+}
+
+void LodSelector::BeginFrame(float fieldOfView, float screenHeight)
+{
+    Verify(fieldOfView > 0.0f && screenHeight > 0.0f);
+
+    // At distance d the view covers 2 * d * tan(fov / 2) world units vertically, spread over screenHeight pixels.
+    mPixelsPerUnit = screenHeight / (2.0f * std::tan(fieldOfView * 0.5f));
+
+    mFrameStats.objectsDrawn = 0;
+    mFrameStats.trianglesSubmitted = 0;
+    mFrameStats.trianglesAtFullDetail = 0;
+}
+
+float LodSelector::ProjectedError(float worldError, float distance) const
+{
+    return worldError * mPixelsPerUnit / distance;
+}
+
+unsigned int LodSelector::SelectLevel(
+    const float * pLevelErrors,
+    unsigned int levelCount,
+    float distance,
+    float boundingSphereRadius,
+    float worldScale,
+    unsigned int previousLevel) const
+{
+    Assert(pLevelErrors != nullptr);
+
+    // Measure from the closest point of the bounding sphere, that is where the error is largest. Cameras inside the
+    // sphere always get full detail.
+    float closestDistance = distance - boundingSphereRadius;
+
+    if (levelCount <= 1 || closestDistance <= 0.0f)
+    {
+        return 0;
+    }
+
+    float threshold = mPixelThreshold * std::pow(2.0f, mLodBias);
+
+    for (unsigned int level = levelCount - 1; level > 0; --level)
+    {
+        float limit = threshold;
+
+        if (level == previousLevel)
+        {
+            limit *= 1.0f + mHysteresis;
+        }
+        else if (level > previousLevel)
+        {
+            limit *= 1.0f - mHysteresis;
+        }
+
+        if (ProjectedError(pLevelErrors[level] * worldScale, closestDistance) <= limit)
+        {
+            return level;
+        }
+    }
+
+    return 0;
+}
+
+void LodSelector::RecordDraw(unsigned int trianglesSubmitted, unsigned int trianglesAtFullDetail)
+{
+    mFrameStats.objectsDrawn++;
+    mFrameStats.trianglesSubmitted += trianglesSubmitted;
+    mFrameStats.trianglesAtFullDetail += trianglesAtFullDetail;
+}
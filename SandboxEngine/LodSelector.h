@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * \brief Level of detail counters for a single frame.
+ */
+struct lod_frame_stats_t
+{
+    unsigned int objectsDrawn;
+    unsigned long long trianglesSubmitted;
+    unsigned long long trianglesAtFullDetail;      // What the same objects would have cost without LODs.
+};
+
+/**
+ * \brief Picks a level of detail for each object by projecting its geometric error onto the screen.
+ *
+ * Each level's error is the distance (in model units) its surface may be from the full detail surface, as recorded
+ * by MeshSimplifier. Multiplied by the number of pixels one world unit covers at the object's distance this gives
+ * the error in pixels, and the coarsest level under the pixel threshold is used.
+ *
+ * Hysteresis keeps objects hovering at a switching distance from popping back and forth: moving to a coarser level
+ * requires the error to be comfortably under the threshold, and the current level is kept until it is comfortably
+ * over.
+ */
+class LodSelector
+{
+public:
+    LodSelector();
+
+    // Largest acceptable error in pixels.
+    void SetPixelThreshold(float pixels);
+    float PixelThreshold() const { return mPixelThreshold; }
+
+    // Fraction of the threshold used as a dead band around it, 0.15 means +/- 15%.
+    void SetHysteresis(float fraction);
+    float Hysteresis() const { return mHysteresis; }
+
+    // Global bias in powers of two. Every step doubles the acceptable error, so raising it trades quality for
+    // speed when the frame is running late. Zero is neutral, negative values increase detail.
+    void SetLodBias(float bias);
+    float LodBias() const { return mLodBias; }
+
+    // Set up projection for a new frame and reset the frame counters. fieldOfView is the vertical field of view in
+    // radians, as returned by Camera::FieldOfView().
+    void BeginFrame(float fieldOfView, float screenHeight);
+
+    // Size in pixels of a world space error seen from the given distance.
+    float ProjectedError(float worldError, float distance) const;
+
+    // Choose a level for an object. levelErrors holds the model space error of every level, starting with the full
+    // detail level (normally zero). Distance is from the camera to the center of the object's world space bounding
+    // sphere, and worldScale is the largest scale of the object's world matrix.
+    unsigned int SelectLevel(
+        const float * pLevelErrors,
+        unsigned int levelCount,
+        float distance,
+        float boundingSphereRadius,
+        float worldScale,
+        unsigned int previousLevel) const;
+
+    // Count a drawn object.
+    void RecordDraw(unsigned int trianglesSubmitted, unsigned int trianglesAtFullDetail);
+
+    const lod_frame_stats_t& FrameStats() const { return mFrameStats; }
+
+private:
+    float mPixelThreshold;
+    float mHysteresis;
+    float mLodBias;
+    float mPixelsPerUnit;               // Pixels covered by one world unit at a distance of one.
+    lod_frame_stats_t mFrameStats;
+};
@@ -0,0 +1,291 @@
+#include "stdafx.h"
+#include "LzCodec.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    const size_t MinMatch = 4;
+    const size_t MaxOffset = 65535;
+    const unsigned int HashBits = 14;
+    const size_t WildCopySlack = 16;        // Bytes a wild copy may run past the end of what it needs.
+
+    typedef unsigned char byte_t;
+
+    unsigned int Read32(const byte_t * p)
+    {
+        unsigned int value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    unsigned int Hash(unsigned int sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HashBits);
+    }
+
+    // Copy in 16 byte chunks, possibly writing up to 15 bytes past pDst + count. Source chunks may overlap the
+    // destination as long as they start at least 16 bytes back, which is what LZ matches need.
+    void WildCopy(byte_t * pDst, const byte_t * pSrc, size_t count)
+    {
+        byte_t * pEnd = pDst + count;
+
+        do
+        {
+            std::memcpy(pDst, pSrc, 16);
+            pDst += 16;
+            pSrc += 16;
+        } while (pDst < pEnd);
+    }
+
+    // Write a length that did not fit in its four bit token field.
+    bool WriteLength(size_t length, byte_t **ppOut, const byte_t * pOutEnd)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            if (*ppOut >= pOutEnd) { return false; }
+            *(*ppOut)++ = 255;
+        }
+
+        if (*ppOut >= pOutEnd) { return false; }
+        *(*ppOut)++ = static_cast<byte_t>(length);
+
+        return true;
+    }
+
+    bool ReadLength(const byte_t **ppIn, const byte_t * pInEnd, size_t *pLength)
+    {
+        byte_t value;
+
+        do
+        {
+            if (*ppIn >= pInEnd) { return false; }
+
+            value = *(*ppIn)++;
+            *pLength += value;
+        } while (value == 255);
+
+        return true;
+    }
+
+    // Emit one sequence: literals followed by a match, or only literals when matchLength is zero.
+    bool WriteSequence(
+        const byte_t * pLiterals,
+        size_t literalCount,
+        size_t offset,
+        size_t matchLength,
+        byte_t **ppOut,
+        const byte_t * pOutEnd)
+    {
+        byte_t * pToken = *ppOut;
+
+        if (pToken >= pOutEnd) { return false; }
+        (*ppOut)++;
+
+        byte_t token = static_cast<byte_t>((literalCount >= 15 ? 15 : literalCount) << 4);
+
+        if (literalCount >= 15 && !WriteLength(literalCount - 15, ppOut, pOutEnd))
+        {
+            return false;
+        }
+
+        if (literalCount > static_cast<size_t>(pOutEnd - *ppOut)) { return false; }
+
+        std::memcpy(*ppOut, pLiterals, literalCount);
+        *ppOut += literalCount;
+
+        if (matchLength > 0)
+        {
+            size_t length = matchLength - MinMatch;
+            token |= static_cast<byte_t>(length >= 15 ? 15 : length);
+
+            if (pOutEnd - *ppOut < 2) { return false; }
+
+            *(*ppOut)++ = static_cast<byte_t>(offset & 0xFF);
+            *(*ppOut)++ = static_cast<byte_t>(offset >> 8);
+
+            if (length >= 15 && !WriteLength(length - 15, ppOut, pOutEnd))
+            {
+                return false;
+            }
+        }
+
+        *pToken = token;
+        return true;
+    }
+}
+
+size_t LzCodec::MaxCompressedSize(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t LzCodec::Compress(const char * pSrc, size_t size, char * pDst, size_t capacity)
+{
+    const byte_t * pIn = reinterpret_cast<const byte_t *>(pSrc);
+    byte_t * pOut = reinterpret_cast<byte_t *>(pDst);
+    const byte_t * pOutEnd = pOut + capacity;
+
+    // Positions are stored plus one so zero means empty.
+    std::vector<size_t> table(static_cast<size_t>(1) << HashBits, 0);
+
+    size_t anchor = 0;
+    size_t position = 0;
+    size_t misses = 0;
+
+    while (size >= MinMatch && position <= size - MinMatch)
+    {
+        const unsigned int sequence = Read32(pIn + position);
+        const unsigned int hash = Hash(sequence);
+        const size_t candidate = table[hash];
+
+        table[hash] = position + 1;
+
+        if (candidate == 0 || position - (candidate - 1) > MaxOffset || Read32(pIn + candidate - 1) != sequence)
+        {
+            // Step faster through data that is not compressing.
+            position += 1 + (misses++ >> 5);
+            continue;
+        }
+
+        size_t matchStart = candidate - 1;
+        size_t matchLength = MinMatch;
+
+        while (position + matchLength < size && pIn[matchStart + matchLength] == pIn[position + matchLength])
+        {
+            matchLength++;
+        }
+
+        // Grow the match backwards into the pending literals.
+        while (position > anchor && matchStart > 0 && pIn[position - 1] == pIn[matchStart - 1])
+        {
+            position--;
+            matchStart--;
+            matchLength++;
+        }
+
+        if (!WriteSequence(pIn + anchor, position - anchor, position - matchStart, matchLength, &pOut, pOutEnd))
+        {
+            return 0;
+        }
+
+        position += matchLength;
+        anchor = position;
+        misses = 0;
+
+        // Remember a position inside the match too, long matches otherwise leave the table stale.
+        if (position >= 2 && position - 2 <= size - MinMatch)
+        {
+            table[Hash(Read32(pIn + position - 2))] = position - 2 + 1;
+        }
+    }
+
+    if (!WriteSequence(pIn + anchor, size - anchor, 0, 0, &pOut, pOutEnd))
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(pOut - reinterpret_cast<byte_t *>(pDst));
+}
+
+bool LzCodec::Decompress(const char * pSrc, size_t srcSize, char * pDst, size_t dstSize)
+{
+    const byte_t * pIn = reinterpret_cast<const byte_t *>(pSrc);
+    const byte_t * pInEnd = pIn + srcSize;
+    byte_t * pOutStart = reinterpret_cast<byte_t *>(pDst);
+    byte_t * pOut = pOutStart;
+    byte_t * pOutEnd = pOut + dstSize;
+
+    while (pIn < pInEnd)
+    {
+        const byte_t token = *pIn++;
+
+        // Literals.
+        size_t literalCount = token >> 4;
+
+        if (literalCount == 15 && !ReadLength(&pIn, pInEnd, &literalCount))
+        {
+            return false;
+        }
+
+        if (literalCount > static_cast<size_t>(pInEnd - pIn) || literalCount > static_cast<size_t>(pOutEnd - pOut))
+        {
+            return false;
+        }
+
+        if (static_cast<size_t>(pInEnd - pIn) >= literalCount + WildCopySlack &&
+            static_cast<size_t>(pOutEnd - pOut) >= literalCount + WildCopySlack)
+        {
+            WildCopy(pOut, pIn, literalCount);
+        }
+        else
+        {
+            std::memcpy(pOut, pIn, literalCount);
+        }
+
+        pIn += literalCount;
+        pOut += literalCount;
+
+        // The last sequence ends after its literals.
+        if (pIn == pInEnd)
+        {
+            break;
+        }
+
+        // Match.
+        if (pInEnd - pIn < 2)
+        {
+            return false;
+        }
+
+        const size_t offset = pIn[0] | (static_cast<size_t>(pIn[1]) << 8);
+        pIn += 2;
+
+        size_t matchLength = token & 15;
+
+        if (matchLength == 15 && !ReadLength(&pIn, pInEnd, &matchLength))
+        {
+            return false;
+        }
+
+        matchLength += MinMatch;
+
+        if (offset == 0 || offset > static_cast<size_t>(pOut - pOutStart) ||
+            matchLength > static_cast<size_t>(pOutEnd - pOut))
+        {
+            return false;
+        }
+
+        const byte_t * pMatch = pOut - offset;
+
+        if (offset >= 16 && static_cast<size_t>(pOutEnd - pOut) >= matchLength + WildCopySlack)
+        {
+            WildCopy(pOut, pMatch, matchLength);
+        }
+        else if (offset >= 8 && static_cast<size_t>(pOutEnd - pOut) >= matchLength + WildCopySlack)
+        {
+            // Eight bytes at a time never reads a byte this copy has not written yet.
+            for (size_t i = 0; i < matchLength; i += 8)
+            {
+                std::memcpy(pOut + i, pMatch + i, 8);
+            }
+        }
+        else if (offset >= matchLength)
+        {
+            std::memcpy(pOut, pMatch, matchLength);
+        }
+        else
+        {
+            // Overlapping run, e.g. offset 1 repeats a single byte.
+            for (size_t i = 0; i < matchLength; ++i)
+            {
+                pOut[i] = pMatch[i];
+            }
+        }
+
+        pOut += matchLength;
+    }
+
+    return pOut == pOutEnd;
+}
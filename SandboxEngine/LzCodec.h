@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>     // size_t
+
+/**
+ * \brief Small, fast LZ77 compressor in the style of LZ4.
+ *
+ * Compressed data is a series of sequences, each a token byte holding a literal count and a match length, the
+ * literal bytes, then a two byte offset back into the already decompressed output to copy the match from. Counts
+ * that do not fit in the token's four bits continue in extra bytes of 255. The final sequence only has literals.
+ *
+ * Compression is a single greedy pass over a hash table of four byte sequences, favouring speed over ratio.
+ * Decompression is a tight loop of copies that never reads or writes outside the buffers it is given, so it is
+ * safe on corrupt input. There is no framing, the caller stores the compressed and decompressed sizes; see
+ * BlockCompression for the container used by asset files.
+ */
+namespace LzCodec
+{
+    // Worst case compressed size for incompressible input of the given size.
+    size_t MaxCompressedSize(size_t size);
+
+    // Compress size bytes into pDst. Returns the compressed size, or zero if it would exceed capacity.
+    size_t Compress(const char * pSrc, size_t size, char * pDst, size_t capacity);
+
+    // Decompress exactly dstSize bytes. Returns false if the input is corrupt or does not decompress to exactly
+    // dstSize bytes.
+    bool Decompress(const char * pSrc, size_t srcSize, char * pDst, size_t dstSize);
+}
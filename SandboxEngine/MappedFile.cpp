@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "MappedFile.h"
+#include "DXTestException.h"
+
+#ifndef _WIN32
+#   include "Utils.h"
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : mFilepath(),
+      mIsOpen(false),
+      mpData(nullptr),
+      mSize(0),
+      mFileHandle(nullptr),
+      mMappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::Open(const std::wstring& filepath)
+{
+    Close();
+
+    HANDLE file = CreateFileW(
+        filepath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw FileLoadException(filepath);
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size) || static_cast<unsigned long long>(size.QuadPart) > static_cast<size_t>(-1))
+    {
+        CloseHandle(file);
+        throw FileLoadException(filepath);
+    }
+
+    // Zero length files can not be mapped.
+    HANDLE mapping = nullptr;
+    const void * pView = nullptr;
+
+    if (size.QuadPart > 0)
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        pView = (mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr);
+
+        if (pView == nullptr)
+        {
+            if (mapping != nullptr) { CloseHandle(mapping); }
+            CloseHandle(file);
+
+            throw FileLoadException(filepath);
+        }
+    }
+
+    mFilepath = filepath;
+    mIsOpen = true;
+    mpData = static_cast<const char *>(pView);
+    mSize = static_cast<size_t>(size.QuadPart);
+    mFileHandle = file;
+    mMappingHandle = mapping;
+}
+
+void MappedFile::Close()
+{
+    if (!mIsOpen) { return; }
+
+    if (mpData != nullptr) { UnmapViewOfFile(mpData); }
+    if (mMappingHandle != nullptr) { CloseHandle(mMappingHandle); }
+    CloseHandle(mFileHandle);
+
+    mIsOpen = false;
+    mpData = nullptr;
+    mSize = 0;
+    mFileHandle = nullptr;
+    mMappingHandle = nullptr;
+}
+
+#else
+
+void MappedFile::Open(const std::wstring& filepath)
+{
+    Close();
+
+    // The mapping keeps the file referenced, so the descriptor can be closed straight away.
+    int file = open(Utils::ConvertUtf16ToUtf8(filepath).c_str(), O_RDONLY);
+    struct stat status;
+
+    if (file < 0 || fstat(file, &status) != 0)
+    {
+        if (file >= 0) { close(file); }
+        throw FileLoadException(filepath);
+    }
+
+    size_t size = static_cast<size_t>(status.st_size);
+    void * pView = nullptr;
+
+    if (size > 0)
+    {
+        pView = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (pView == MAP_FAILED)
+        {
+            close(file);
+            throw FileLoadException(filepath);
+        }
+    }
+
+    close(file);
+
+    mFilepath = filepath;
+    mIsOpen = true;
+    mpData = static_cast<const char *>(pView);
+    mSize = size;
+}
+
+void MappedFile::Close()
+{
+    if (!mIsOpen) { return; }
+
+    if (mpData != nullptr) { munmap(const_cast<char *>(mpData), mSize); }
+
+    mIsOpen = false;
+    mpData = nullptr;
+    mSize = 0;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <cstddef>     // size_t
+
+/**
+ * \brief Read only memory mapping of an entire file.
+ *
+ * Mapping lets a file be used in place without reading it into a separate buffer first; pages are loaded by the OS
+ * on first touch and shared with the file cache. The mapping stays valid until the object is closed or destroyed.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    ~MappedFile();
+
+    MappedFile& operator =(const MappedFile&) = delete;
+
+    // Map a file, throwing FileLoadException if it can not be opened. Empty files map to a null pointer.
+    void Open(const std::wstring& filepath);
+    void Close();
+
+    bool IsOpen() const { return mIsOpen; }
+    const char * Data() const { return mpData; }
+    size_t Size() const { return mSize; }
+    const std::wstring& Filepath() const { return mFilepath; }
+
+private:
+    std::wstring mFilepath;
+    bool mIsOpen;
+    const char * mpData;
+    size_t mSize;
+    void * mFileHandle;         // Windows only, the file and mapping handles are closed with the view.
+    void * mMappingHandle;
+};
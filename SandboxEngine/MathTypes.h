@@ -0,0 +1,26 @@
+#pragma once
+
+// DirectX::SimpleMath on Windows, PortableMath (see PortableMath.h) everywhere else. Define SANDBOX_PORTABLE_MATH to
+// use PortableMath on Windows too.
+#if defined(_WIN32) && !defined(SANDBOX_PORTABLE_MATH)
+#include <SimpleMath.h>
+#else
+#include "PortableMath.h"
+
+namespace DirectX
+{
+    namespace SimpleMath
+    {
+        using PortableMath::Vector2;
+        using PortableMath::Vector3;
+        using PortableMath::Vector4;
+        using PortableMath::Matrix;
+        using PortableMath::Plane;
+    }
+
+    using PortableMath::XMMatrixIdentity;
+    using PortableMath::XMMatrixLookAtLH;
+    using PortableMath::XMMatrixPerspectiveFovLH;
+    using PortableMath::XMMatrixOrthographicLH;
+}
+#endif
@@ -0,0 +1,274 @@
+#include "stdafx.h"
+#include "MemoryTracker.h"
+#include "Platform.h"       // SANDBOX_THREAD_LOCAL
+#include "TextFormat.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // Written in front of every block. Sixteen bytes, so blocks keep malloc's alignment.
+    struct block_header_t
+    {
+        unsigned long long size;
+        unsigned int tag;
+        unsigned int unused;
+    };
+
+    const unsigned int UntrackedTag = 0xFFFFFFFF;
+
+    // A block count and a byte count share one 64 bit word, so an allocation costs two atomic adds rather than four.
+    // That leaves 24 bits for live blocks and 40 bits (1 TB) for bytes, per tag.
+    const unsigned int CountShift = 40;
+    const unsigned long long BytesMask = (1ull << CountShift) - 1;
+    const unsigned long long OneBlock = 1ull << CountShift;
+
+    unsigned long long PackedBytes(unsigned long long packed) { return packed & BytesMask; }
+    unsigned long long PackedCount(unsigned long long packed) { return packed >> CountShift; }
+
+    // Counters of one tag. Padded so tags updated by different threads do not share a cache line. Every member is
+    // zero before any code runs, so allocations made during static initialization are safe to count.
+    struct tag_counters_t
+    {
+        std::atomic<unsigned long long> current;     // Packed live blocks and bytes.
+        std::atomic<unsigned long long> frame;       // Packed blocks and bytes allocated this frame.
+        std::atomic<unsigned long long> lastFrame;
+        std::atomic<unsigned long long> peakBytes;
+        std::atomic<unsigned long long> budgetBytes;
+        std::atomic<bool> exceeded;
+        std::atomic<bool> reported;                 // Only written by EndFrame().
+        char padding[64];
+    };
+
+    const char * const GTagNames[MemoryTagCount] = { "General", "Meshes", "Textures", "Audio", "Text", "UI" };
+
+    tag_counters_t GCounters[MemoryTagCount];
+    std::atomic<bool> GEnabled;
+    std::atomic<unsigned long long> GFrame;
+    MemoryTracker::budget_handler_t GBudgetHandler = nullptr;
+
+    SANDBOX_THREAD_LOCAL unsigned int GCurrentTag = 0;
+
+    void ReportOverBudget(MemoryTag tag, const memory_tag_stats_t& stats)
+    {
+        FormatBuffer message;
+
+        message
+            << "Memory budget exceeded for " << MemoryTracker::TagName(tag) << ": "
+            << stats.currentBytes << " of " << stats.budgetBytes << " bytes\n";
+
+#ifdef _WIN32
+        OutputDebugStringA(message.CString());
+#else
+        std::fputs(message.CString(), stderr);
+#endif
+    }
+
+    void AppendStatsJson(FormatBuffer * pJson, const memory_tag_stats_t& stats)
+    {
+        *pJson
+            << "\"currentBytes\": " << stats.currentBytes
+            << ", \"peakBytes\": " << stats.peakBytes
+            << ", \"currentCount\": " << stats.currentCount
+            << ", \"lastFrameCount\": " << stats.lastFrameCount
+            << ", \"lastFrameBytes\": " << stats.lastFrameBytes
+            << ", \"budgetBytes\": " << stats.budgetBytes
+            << ", \"overBudget\": " << stats.overBudget;
+    }
+}
+
+void MemoryTracker::SetEnabled(bool enabled)
+{
+    GEnabled.store(enabled);
+}
+
+bool MemoryTracker::IsEnabled()
+{
+    return GEnabled.load(std::memory_order_relaxed);
+}
+
+void * MemoryTracker::Allocate(size_t size)
+{
+    return Allocate(size, static_cast<MemoryTag>(GCurrentTag));
+}
+
+void * MemoryTracker::Allocate(size_t size, MemoryTag tag)
+{
+    if (size > static_cast<size_t>(-1) - sizeof(block_header_t))
+    {
+        return nullptr;
+    }
+
+    block_header_t * pHeader = static_cast<block_header_t *>(std::malloc(sizeof(block_header_t) + size));
+
+    if (pHeader == nullptr)
+    {
+        return nullptr;
+    }
+
+    pHeader->size = size;
+    pHeader->tag = UntrackedTag;
+
+    // Blocks too big to pack are never counted.
+    if (GEnabled.load(std::memory_order_relaxed) && size <= BytesMask)
+    {
+        tag_counters_t& counters = GCounters[static_cast<size_t>(tag)];
+        const unsigned long long currentBytes =
+            PackedBytes(counters.current.fetch_add(OneBlock + size, std::memory_order_relaxed) + size);
+
+        counters.frame.fetch_add(OneBlock + size, std::memory_order_relaxed);
+
+        unsigned long long peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+
+        while (currentBytes > peakBytes &&
+               !counters.peakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed))
+        {
+        }
+
+        const unsigned long long budgetBytes = counters.budgetBytes.load(std::memory_order_relaxed);
+
+        if (budgetBytes != 0 && currentBytes > budgetBytes)
+        {
+            counters.exceeded.store(true, std::memory_order_relaxed);
+        }
+
+        pHeader->tag = static_cast<unsigned int>(tag);
+    }
+
+    return pHeader + 1;
+}
+
+void MemoryTracker::Free(void * pMemory)
+{
+    if (pMemory == nullptr)
+    {
+        return;
+    }
+
+    block_header_t * pHeader = static_cast<block_header_t *>(pMemory) - 1;
+
+    if (pHeader->tag != UntrackedTag)
+    {
+        tag_counters_t& counters = GCounters[pHeader->tag];
+
+        counters.current.fetch_sub(OneBlock + pHeader->size, std::memory_order_relaxed);
+    }
+
+    std::free(pHeader);
+}
+
+MemoryTag MemoryTracker::CurrentTag()
+{
+    return static_cast<MemoryTag>(GCurrentTag);
+}
+
+const char * MemoryTracker::TagName(MemoryTag tag)
+{
+    return GTagNames[static_cast<size_t>(tag)];
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, unsigned long long budgetBytes)
+{
+    GCounters[static_cast<size_t>(tag)].budgetBytes.store(budgetBytes);
+}
+
+void MemoryTracker::SetBudgetHandler(budget_handler_t handler)
+{
+    GBudgetHandler = handler;
+}
+
+void MemoryTracker::EndFrame()
+{
+    for (size_t i = 0; i < MemoryTagCount; ++i)
+    {
+        tag_counters_t& counters = GCounters[i];
+
+        counters.lastFrame.store(counters.frame.exchange(0, std::memory_order_relaxed));
+
+        // Set again by the next allocation while the tag stays over budget, so it is only reported once per overrun.
+        const bool exceeded = counters.exceeded.exchange(false);
+        const unsigned long long budgetBytes = counters.budgetBytes.load();
+        const bool overBudget = exceeded || (budgetBytes != 0 && PackedBytes(counters.current.load()) > budgetBytes);
+        const bool reported = counters.reported.exchange(overBudget);
+
+        if (exceeded && !reported)
+        {
+            const MemoryTag tag = static_cast<MemoryTag>(i);
+            const memory_tag_stats_t stats = Stats(tag);
+
+            if (GBudgetHandler != nullptr)
+            {
+                GBudgetHandler(tag, stats);
+            }
+            else
+            {
+                ReportOverBudget(tag, stats);
+            }
+        }
+    }
+
+    GFrame++;
+}
+
+memory_tag_stats_t MemoryTracker::Stats(MemoryTag tag)
+{
+    const tag_counters_t& counters = GCounters[static_cast<size_t>(tag)];
+    memory_tag_stats_t stats;
+
+    const unsigned long long current = counters.current.load();
+    const unsigned long long lastFrame = counters.lastFrame.load();
+
+    stats.currentBytes = PackedBytes(current);
+    stats.peakBytes = counters.peakBytes.load();
+    stats.currentCount = PackedCount(current);
+    stats.lastFrameCount = PackedCount(lastFrame);
+    stats.lastFrameBytes = PackedBytes(lastFrame);
+    stats.budgetBytes = counters.budgetBytes.load();
+    stats.overBudget = counters.reported.load();
+
+    return stats;
+}
+
+memory_snapshot_t MemoryTracker::Snapshot()
+{
+    memory_snapshot_t snapshot;
+
+    snapshot.frame = GFrame.load();
+    snapshot.enabled = IsEnabled();
+
+    for (size_t i = 0; i < MemoryTagCount; ++i)
+    {
+        snapshot.tags[i] = Stats(static_cast<MemoryTag>(i));
+    }
+
+    return snapshot;
+}
+
+std::string MemoryTracker::ToJson(const memory_snapshot_t& snapshot)
+{
+    FormatBuffer json;
+    json << "{\n  \"frame\": " << snapshot.frame << ",\n  \"enabled\": " << snapshot.enabled << ",\n  \"tags\": {";
+
+    for (size_t i = 0; i < MemoryTagCount; ++i)
+    {
+        json << (i == 0 ? "\n" : ",\n") << "    \"" << GTagNames[i] << "\": { ";
+        AppendStatsJson(&json, snapshot.tags[i]);
+        json << " }";
+    }
+
+    json << "\n  }\n}\n";
+    return json.ToString();
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+    : mPreviousTag(static_cast<MemoryTag>(GCurrentTag))
+{
+    GCurrentTag = static_cast<unsigned int>(tag);
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    GCurrentTag = static_cast<unsigned int>(mPreviousTag);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+
+/**
+ * \brief Subsystems that heap allocations are charged to.
+ */
+enum class MemoryTag
+{
+    General,
+    Meshes,
+    Textures,
+    Audio,
+    Text,
+    UI,
+    Count
+};
+
+const size_t MemoryTagCount = static_cast<size_t>(MemoryTag::Count);
+
+/**
+ * \brief Allocation statistics of one MemoryTag.
+ */
+struct memory_tag_stats_t
+{
+    unsigned long long currentBytes;
+    unsigned long long peakBytes;
+    unsigned long long currentCount;
+    unsigned long long lastFrameCount;      // Allocations made during the last completed frame.
+    unsigned long long lastFrameBytes;
+    unsigned long long budgetBytes;         // Zero when the tag has no budget.
+    bool overBudget;                        // Over budget during or at the end of the last completed frame.
+};
+
+/**
+ * \brief Allocation statistics of every tag at one point in time.
+ */
+struct memory_snapshot_t
+{
+    unsigned long long frame;
+    bool enabled;
+    memory_tag_stats_t tags[MemoryTagCount];
+};
+
+/**
+ * \brief Per subsystem heap accounting with budgets.
+ *
+ * Allocate() and Free() prefix every block with a small header that records its size and tag, and update a few
+ * relaxed atomic counters per call when tracking is enabled. Programs opt in by routing their global operator new
+ * and delete through them (see DXTest's TrackedNew.cpp) and enabling tracking. The tag charged is the calling
+ * thread's current tag, set with MemoryTagScope.
+ *
+ * Tracking is off by default. Blocks allocated while it is off are never counted, even if they are freed after it
+ * has been turned on, so it can be toggled at any time.
+ *
+ * Budget overruns are only noted on the allocation path. They are reported from EndFrame(), once per overrun, to the
+ * handler set with SetBudgetHandler() or to the debugger output (stderr off Windows).
+ */
+namespace MemoryTracker
+{
+    typedef void(*budget_handler_t)(MemoryTag tag, const memory_tag_stats_t& stats);
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+
+    // Allocate size bytes charged to the calling thread's current tag, or to an explicit tag. Returns null when out
+    // of memory. Blocks are aligned like malloc's.
+    void * Allocate(size_t size);
+    void * Allocate(size_t size, MemoryTag tag);
+
+    // Free a block from Allocate(). Null is ignored.
+    void Free(void * pMemory);
+
+    MemoryTag CurrentTag();
+    const char * TagName(MemoryTag tag);
+
+    // Warn when a tag's current bytes go over budgetBytes. Zero removes the budget.
+    void SetBudget(MemoryTag tag, unsigned long long budgetBytes);
+    void SetBudgetHandler(budget_handler_t handler);
+
+    // Close the current frame: report budget overruns and start new per frame counts. Call once per frame from the
+    // main loop.
+    void EndFrame();
+
+    memory_tag_stats_t Stats(MemoryTag tag);
+    memory_snapshot_t Snapshot();
+
+    // Snapshot as a JSON object, for saving next to a capture or diffing between runs.
+    std::string ToJson(const memory_snapshot_t& snapshot);
+}
+
+/**
+ * \brief Charges the calling thread's allocations to a tag for the scope's lifetime.
+ *
+ * Scopes nest, the previous tag is restored when a scope ends.
+ *
+ *  EXAMPLE:
+ *      MemoryTagScope tag(MemoryTag::Meshes);
+ *      model->Initialize(pDevice, mesh, VertexFormat::Compact);
+ */
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(MemoryTag tag);
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    ~MemoryTagScope();
+
+    MemoryTagScope& operator =(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag mPreviousTag;
+};
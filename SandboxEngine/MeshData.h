@@ -0,0 +1,75 @@
+#pragma once
+#include "BoundingVolumes.h"
+#include <vector>
+
+// TODO: Turn this into a SoftwareMesh class that can load and save itself.
+
+/**
+ * \brief Single vertex in the in-memory software mesh format.
+ */
+struct s_mesh_vertex_t
+{
+    float x, y, z;
+    float tu, tv;
+    float nx, ny, nz;
+};
+
+/**
+ * \brief A small cluster of triangles from a mesh. See MeshletBuilder.h.
+ */
+struct meshlet_t
+{
+    unsigned int vertexOffset;      // First entry in s_meshlet_data_t::vertices.
+    unsigned int triangleOffset;    // First entry in s_meshlet_data_t::triangles (three per triangle).
+    unsigned int vertexCount;
+    unsigned int triangleCount;
+};
+
+/**
+ * \brief Culling bounds for a meshlet.
+ *
+ * The normal cone is stored in its culling form: the meshlet faces away from a viewer at position p when
+ *   dot(center - p, coneAxis) >= coneCutoff * length(center - p) + radius
+ * A cutoff of one or more means the triangles face too many directions and the meshlet can never be backface culled.
+ */
+struct meshlet_bounds_t
+{
+    float center[3];
+    float radius;
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+/**
+ * \brief Meshlet partition of a mesh.
+ */
+struct s_meshlet_data_t
+{
+    std::vector<meshlet_t> meshlets;
+    std::vector<meshlet_bounds_t> bounds;       // One entry per meshlet.
+    std::vector<unsigned int> vertices;         // Mesh vertex index for every meshlet local vertex.
+    std::vector<unsigned char> triangles;       // Meshlet local vertex indices, three per triangle.
+};
+
+/**
+ * \brief A reduced detail version of a mesh. See MeshSimplifier.h.
+ *
+ * Levels of detail share the vertices of the full detail mesh and only replace its index list.
+ */
+struct s_mesh_lod_t
+{
+    std::vector<int> indices;
+    float error;                                // Estimated distance from the full detail surface, in model units.
+};
+
+/**
+ * \brief In-memory software mesh. Holds mesh data loaded from disk before it is converted and uploaded to the GPU.
+ */
+struct s_mesh_data_t
+{
+    std::vector<s_mesh_vertex_t> vertices;
+    std::vector<int> indices;
+    s_meshlet_data_t meshlets;                  // Optional, empty unless built or loaded from a .mesh file.
+    std::vector<s_mesh_lod_t> lods;             // Optional, ordered from most to least detailed.
+    mesh_bounds_t bounds;                       // Set by the loaders, see BoundingVolumes::ComputeMeshBounds.
+};
@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "MeshFile.h"
+#include "MeshData.h"
+#include "BoundingVolumes.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "StreamReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>      // move
+
+namespace
+{
+    const char Magic[4] = { 'S', 'B', 'M', 'F' };
+
+    struct mesh_file_header_t
+    {
+        char magic[4];
+        unsigned int version;
+        unsigned int vertexCount;
+        unsigned int indexCount;
+        unsigned int meshletCount;
+        unsigned int meshletVertexCount;
+        unsigned int meshletTriangleByteCount;
+        unsigned int lodCount;          // Always zero in version 1 files.
+    };
+
+    struct mesh_file_lod_t
+    {
+        unsigned int indexCount;
+        float error;
+    };
+
+    size_t AlignUp(size_t offset)
+    {
+        return (offset + 3) & ~static_cast<size_t>(3);
+    }
+
+    template<typename T>
+    void WriteSection(const std::vector<T>& values, std::vector<char> *pBuffer)
+    {
+        size_t offset = pBuffer->size();
+        size_t bytes = values.size() * sizeof(T);
+
+        pBuffer->resize(AlignUp(offset + bytes), 0);
+
+        if (bytes > 0)
+        {
+            std::memcpy(&(*pBuffer)[offset], &values[0], bytes);
+        }
+    }
+
+    template<typename T>
+    void ReadSection(StreamReader& reader, size_t count, const std::wstring& sourceName, std::vector<T> *pValuesOut)
+    {
+        if (count > reader.Remaining() / sizeof(T))
+        {
+            throw FileFormatException(L"Mesh file is truncated", sourceName);
+        }
+
+        reader.ReadArray(count, pValuesOut);
+
+        // Sections are padded to four bytes, the last one may not be.
+        const size_t padding = AlignUp(count * sizeof(T)) - count * sizeof(T);
+        reader.Skip(std::min<unsigned long long>(padding, reader.Remaining()));
+    }
+}
+
+void MeshFile::Write(const s_mesh_data_t& mesh, std::vector<char> *pBufferOut)
+{
+    AssertNotNull(pBufferOut);
+
+    const s_meshlet_data_t& meshlets = mesh.meshlets;
+
+    mesh_file_header_t header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.vertexCount = static_cast<unsigned int>(mesh.vertices.size());
+    header.indexCount = static_cast<unsigned int>(mesh.indices.size());
+    header.meshletCount = static_cast<unsigned int>(meshlets.meshlets.size());
+    header.meshletVertexCount = static_cast<unsigned int>(meshlets.vertices.size());
+    header.meshletTriangleByteCount = static_cast<unsigned int>(meshlets.triangles.size());
+    header.lodCount = static_cast<unsigned int>(mesh.lods.size());
+
+    pBufferOut->assign(reinterpret_cast<const char *>(&header), reinterpret_cast<const char *>(&header + 1));
+
+    WriteSection(mesh.vertices, pBufferOut);
+    WriteSection(mesh.indices, pBufferOut);
+    WriteSection(meshlets.meshlets, pBufferOut);
+    WriteSection(meshlets.bounds, pBufferOut);
+    WriteSection(meshlets.vertices, pBufferOut);
+    WriteSection(meshlets.triangles, pBufferOut);
+
+    std::vector<mesh_file_lod_t> lods(mesh.lods.size());
+    std::vector<int> lodIndices;
+
+    for (size_t i = 0; i < mesh.lods.size(); ++i)
+    {
+        lods[i].indexCount = static_cast<unsigned int>(mesh.lods[i].indices.size());
+        lods[i].error = mesh.lods[i].error;
+
+        lodIndices.insert(lodIndices.end(), mesh.lods[i].indices.begin(), mesh.lods[i].indices.end());
+    }
+
+    WriteSection(lods, pBufferOut);
+    WriteSection(lodIndices, pBufferOut);
+
+    std::vector<mesh_bounds_t> bounds(1, BoundingVolumes::ComputeMeshBounds(mesh));
+    WriteSection(bounds, pBufferOut);
+}
+
+void MeshFile::Read(const char * pBuffer, size_t size, const std::wstring& sourceName, s_mesh_data_t *pMeshOut)
+{
+    StreamReader reader(pBuffer, size, sourceName);
+    Read(reader, pMeshOut);
+}
+
+void MeshFile::Read(StreamReader& reader, s_mesh_data_t *pMeshOut)
+{
+    AssertNotNull(pMeshOut);
+
+    const std::wstring& sourceName = reader.SourceName();
+    mesh_file_header_t header;
+
+    if (reader.Remaining() < sizeof(header))
+    {
+        throw FileFormatException(L"Mesh file is truncated", sourceName);
+    }
+
+    header = reader.Read<mesh_file_header_t>();
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    {
+        throw FileFormatException(L"Not a mesh file", sourceName);
+    }
+
+    if (header.version < OldestSupportedVersion || header.version > Version)
+    {
+        throw FileFormatException(L"Unsupported mesh file version", sourceName);
+    }
+
+    s_mesh_data_t mesh;
+
+    ReadSection(reader, header.vertexCount, sourceName, &mesh.vertices);
+    ReadSection(reader, header.indexCount, sourceName, &mesh.indices);
+    ReadSection(reader, header.meshletCount, sourceName, &mesh.meshlets.meshlets);
+    ReadSection(reader, header.meshletCount, sourceName, &mesh.meshlets.bounds);
+    ReadSection(reader, header.meshletVertexCount, sourceName, &mesh.meshlets.vertices);
+    ReadSection(reader, header.meshletTriangleByteCount, sourceName, &mesh.meshlets.triangles);
+
+    std::vector<mesh_file_lod_t> lods;
+    std::vector<int> lodIndices;
+    size_t lodIndexCount = 0;
+
+    ReadSection(reader, header.lodCount, sourceName, &lods);
+
+    for (const mesh_file_lod_t& lod : lods)
+    {
+        lodIndexCount += lod.indexCount;
+    }
+
+    ReadSection(reader, lodIndexCount, sourceName, &lodIndices);
+
+    mesh.lods.resize(lods.size());
+    lodIndexCount = 0;
+
+    for (size_t i = 0; i < lods.size(); ++i)
+    {
+        mesh.lods[i].indices.assign(
+            lodIndices.begin() + lodIndexCount,
+            lodIndices.begin() + lodIndexCount + lods[i].indexCount);
+        mesh.lods[i].error = lods[i].error;
+
+        lodIndexCount += lods[i].indexCount;
+    }
+
+    if (header.version >= 3)
+    {
+        std::vector<mesh_bounds_t> bounds;
+        ReadSection(reader, 1, sourceName, &bounds);
+
+        mesh.bounds = bounds[0];
+    }
+    else
+    {
+        mesh.bounds = BoundingVolumes::ComputeMeshBounds(mesh);
+    }
+
+    // Validate indices so a corrupt file can not make the renderer read out of bounds.
+    for (int index : mesh.indices)
+    {
+        if (index < 0 || static_cast<unsigned int>(index) >= header.vertexCount)
+        {
+            throw FileFormatException(L"Mesh file index out of range", sourceName);
+        }
+    }
+
+    for (int index : lodIndices)
+    {
+        if (index < 0 || static_cast<unsigned int>(index) >= header.vertexCount)
+        {
+            throw FileFormatException(L"Mesh file index out of range", sourceName);
+        }
+    }
+
+    for (const meshlet_t& meshlet : mesh.meshlets.meshlets)
+    {
+        if (static_cast<size_t>(meshlet.vertexOffset) + meshlet.vertexCount > header.meshletVertexCount ||
+            static_cast<size_t>(meshlet.triangleOffset) + meshlet.triangleCount * 3ull > header.meshletTriangleByteCount)
+        {
+            throw FileFormatException(L"Mesh file meshlet out of range", sourceName);
+        }
+
+        for (unsigned int i = 0; i < meshlet.triangleCount * 3; ++i)
+        {
+            if (mesh.meshlets.triangles[meshlet.triangleOffset + i] >= meshlet.vertexCount)
+            {
+                throw FileFormatException(L"Mesh file meshlet out of range", sourceName);
+            }
+        }
+    }
+
+    *pMeshOut = std::move(mesh);
+}
+
+void MeshFile::Save(const s_mesh_data_t& mesh, const std::wstring& filepath)
+{
+    std::vector<char> buffer;
+    Write(mesh, &buffer);
+
+    std::ofstream outputStream(filepath.c_str(), std::ios::binary);
+
+    if (!outputStream.is_open())
+    {
+        throw FileSaveException(filepath);
+    }
+
+    outputStream.write(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+
+    if (!outputStream)
+    {
+        throw FileSaveException(filepath);
+    }
+}
+
+void MeshFile::Load(const std::wstring& filepath, s_mesh_data_t *pMeshOut)
+{
+    StreamReader reader(filepath);
+    Read(reader, pMeshOut);
+}
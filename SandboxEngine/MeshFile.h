@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <vector>
+
+struct s_mesh_data_t;
+class StreamReader;
+
+/**
+ * \brief Binary mesh file format (.mesh).
+ *
+ * Stores the same data as s_mesh_data_t so it can be loaded without any text parsing or meshlet building. The file
+ * is a fixed size header followed by the vertex, index, meshlet, meshlet bounds, meshlet vertex and meshlet triangle
+ * arrays, then a table of LOD index counts and errors, the LOD indices and finally the mesh bounds, in that order.
+ * Every section starts on a four byte boundary. Values are stored in native (little endian) byte order.
+ *
+ * Version history:
+ *  1 - Vertices, indices and meshlets.
+ *  2 - Adds levels of detail.
+ *  3 - Adds the mesh bounding box and sphere. Bounds are computed when loading older files.
+ */
+namespace MeshFile
+{
+    const unsigned int Version = 3;
+    const unsigned int OldestSupportedVersion = 1;
+
+    // Serialize a mesh into a .mesh image. Bounds are recomputed from the vertices rather than taken from the mesh.
+    void Write(const s_mesh_data_t& mesh, std::vector<char> *pBufferOut);
+
+    // Parse a .mesh image. The source name is only used for error reporting.
+    void Read(const char * pBuffer, size_t size, const std::wstring& sourceName, s_mesh_data_t *pMeshOut);
+
+    // Parse a .mesh file straight out of a stream, without holding the whole file in memory.
+    void Read(StreamReader& reader, s_mesh_data_t *pMeshOut);
+
+    void Save(const s_mesh_data_t& mesh, const std::wstring& filepath);
+
+    // Stream a .mesh file from disk or a mounted pack.
+    void Load(const std::wstring& filepath, s_mesh_data_t *pMeshOut);
+}
@@ -0,0 +1,810 @@
+#include "stdafx.h"
+#include "MeshSimplifier.h"
+#include "MeshData.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Border and seam edges add a plane perpendicular to their triangle, weighted by this factor, so collapses that
+    // pull a border away from its original line are expensive.
+    const double BorderWeight = 10.0;
+
+    // Collapses that are locked by an earlier collapse in the same pass push the real error past the error of the
+    // ideal last collapse. Allow some slack before ending a pass.
+    const double PassErrorSlack = 1.5;
+
+    enum class VertexKind : unsigned char
+    {
+        Manifold,       // Interior vertex, can collapse onto any neighbour.
+        Border,         // On an open border, can only slide along the border.
+        Seam,           // One of two vertices at the same position, slides along the seam with its twin.
+        Locked          // Anything else, never moves.
+    };
+
+    struct point_t
+    {
+        double x, y, z;
+    };
+
+    point_t Subtract(const point_t& a, const point_t& b)
+    {
+        point_t result = { a.x - b.x, a.y - b.y, a.z - b.z };
+        return result;
+    }
+
+    point_t Cross(const point_t& a, const point_t& b)
+    {
+        point_t result = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        return result;
+    }
+
+    double Dot(const point_t& a, const point_t& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    /**
+     * \brief Sum of weighted squared distances to a set of planes, stored as p'Ap + 2b'p + c.
+     */
+    struct quadric_t
+    {
+        double a00, a01, a02, a11, a12, a22;
+        double b0, b1, b2;
+        double c;
+        double weight;
+
+        static quadric_t FromPlane(const point_t& normal, double distance, double weight)
+        {
+            quadric_t q;
+            q.a00 = weight * normal.x * normal.x;
+            q.a01 = weight * normal.x * normal.y;
+            q.a02 = weight * normal.x * normal.z;
+            q.a11 = weight * normal.y * normal.y;
+            q.a12 = weight * normal.y * normal.z;
+            q.a22 = weight * normal.z * normal.z;
+            q.b0 = weight * normal.x * distance;
+            q.b1 = weight * normal.y * distance;
+            q.b2 = weight * normal.z * distance;
+            q.c = weight * distance * distance;
+            q.weight = weight;
+
+            return q;
+        }
+
+        quadric_t& operator +=(const quadric_t& rhs)
+        {
+            a00 += rhs.a00; a01 += rhs.a01; a02 += rhs.a02;
+            a11 += rhs.a11; a12 += rhs.a12; a22 += rhs.a22;
+            b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2;
+            c += rhs.c;
+            weight += rhs.weight;
+
+            return *this;
+        }
+
+        double Evaluate(const point_t& p) const
+        {
+            double result =
+                a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+                2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+                2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) +
+                c;
+
+            return std::max(result, 0.0);
+        }
+    };
+
+    struct collapse_t
+    {
+        unsigned int from;          // Vertex that is removed.
+        unsigned int to;            // Vertex it is merged into.
+        double error;
+
+        bool operator <(const collapse_t& rhs) const
+        {
+            if (error != rhs.error) { return error < rhs.error; }
+            if (from != rhs.from) { return from < rhs.from; }
+            return to < rhs.to;
+        }
+    };
+
+    /**
+     * \brief Progressive simplification of one mesh. SimplifyTo can be called with decreasing targets to produce a
+     *        LOD chain in one session, which keeps every level's error relative to the original mesh.
+     */
+    class Simplifier
+    {
+    public:
+        explicit Simplifier(const s_mesh_data_t& mesh);
+
+        void SimplifyTo(size_t targetIndexCount);
+
+        void CopyIndices(std::vector<int> *pIndicesOut) const
+        {
+            pIndicesOut->assign(mIndices.begin(), mIndices.end());
+        }
+
+        float Error() const
+        {
+            return static_cast<float>(std::sqrt(mMaxError));
+        }
+
+    private:
+        void WeldPositions();
+        void BuildAdjacency();
+        void ClassifyVertices();
+        void ComputeQuadrics();
+        size_t CollapsePass(size_t targetTriangleCount);
+
+        bool HasEdge(unsigned int from, unsigned int to) const;
+        bool CanCollapse(unsigned int from, unsigned int to, bool openEdge) const;
+        bool FindSeamTwin(unsigned int from, unsigned int to, unsigned int *pFromTwinOut, unsigned int *pToTwinOut) const;
+        bool FlipsTriangles(unsigned int from, unsigned int to, const std::vector<unsigned int>& remap) const;
+        double CollapseError(unsigned int from, unsigned int to) const;
+        void RemoveDegenerateTriangles();
+
+    private:
+        std::vector<point_t> mPositions;
+        std::vector<unsigned int> mGroup;           // First vertex sharing this vertex's position.
+        std::vector<unsigned int> mWedge;           // Next vertex sharing this vertex's position, as a ring.
+        std::vector<VertexKind> mKinds;
+        std::vector<quadric_t> mQuadrics;           // Indexed by position group.
+        std::vector<unsigned int> mIndices;
+
+        // Outgoing edges and triangles per vertex, rebuilt from mIndices before each pass.
+        std::vector<unsigned int> mEdgeOffsets;
+        std::vector<unsigned int> mEdgeTargets;
+        std::vector<unsigned int> mTriangleOffsets;
+        std::vector<unsigned int> mTriangles;
+
+        double mMaxError;
+    };
+
+    Simplifier::Simplifier(const s_mesh_data_t& mesh)
+        : mPositions(mesh.vertices.size()),
+          mGroup(),
+          mWedge(),
+          mKinds(mesh.vertices.size(), VertexKind::Locked),
+          mQuadrics(),
+          mIndices(mesh.indices.size()),
+          mMaxError(0.0)
+    {
+        Verify(mesh.indices.size() % 3 == 0);
+
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const s_mesh_vertex_t& v = mesh.vertices[i];
+            point_t p = { v.x, v.y, v.z };
+            mPositions[i] = p;
+        }
+
+        for (size_t i = 0; i < mesh.indices.size(); ++i)
+        {
+            Verify(mesh.indices[i] >= 0 && static_cast<size_t>(mesh.indices[i]) < mesh.vertices.size());
+            mIndices[i] = static_cast<unsigned int>(mesh.indices[i]);
+        }
+
+        WeldPositions();
+        RemoveDegenerateTriangles();
+        BuildAdjacency();
+        ClassifyVertices();
+        ComputeQuadrics();
+    }
+
+    void Simplifier::SimplifyTo(size_t targetIndexCount)
+    {
+        size_t targetTriangleCount = targetIndexCount / 3;
+
+        while (mIndices.size() / 3 > targetTriangleCount)
+        {
+            BuildAdjacency();
+
+            if (CollapsePass(targetTriangleCount) == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    // Vertices that only differ in normal or texture coordinates are linked into rings so seams can be detected and
+    // error tracked per position.
+    void Simplifier::WeldPositions()
+    {
+        const size_t vertexCount = mPositions.size();
+        std::vector<unsigned int> order(vertexCount);
+
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            order[i] = static_cast<unsigned int>(i);
+        }
+
+        std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+            const point_t& pa = mPositions[a];
+            const point_t& pb = mPositions[b];
+
+            if (pa.x != pb.x) { return pa.x < pb.x; }
+            if (pa.y != pb.y) { return pa.y < pb.y; }
+            if (pa.z != pb.z) { return pa.z < pb.z; }
+            return a < b;
+        });
+
+        mGroup.resize(vertexCount);
+        mWedge.resize(vertexCount);
+
+        for (size_t start = 0; start < vertexCount;)
+        {
+            size_t end = start + 1;
+            const point_t& p = mPositions[order[start]];
+
+            while (end < vertexCount &&
+                   mPositions[order[end]].x == p.x &&
+                   mPositions[order[end]].y == p.y &&
+                   mPositions[order[end]].z == p.z)
+            {
+                ++end;
+            }
+
+            // Sorting by index within a run makes the first vertex the smallest index.
+            for (size_t i = start; i < end; ++i)
+            {
+                mGroup[order[i]] = order[start];
+                mWedge[order[i]] = order[i + 1 < end ? i + 1 : start];
+            }
+
+            start = end;
+        }
+    }
+
+    void Simplifier::BuildAdjacency()
+    {
+        const size_t vertexCount = mPositions.size();
+
+        mEdgeOffsets.assign(vertexCount + 1, 0);
+        mTriangleOffsets.assign(vertexCount + 1, 0);
+
+        for (unsigned int index : mIndices)
+        {
+            mEdgeOffsets[index + 1]++;
+            mTriangleOffsets[index + 1]++;
+        }
+
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            mEdgeOffsets[i + 1] += mEdgeOffsets[i];
+            mTriangleOffsets[i + 1] += mTriangleOffsets[i];
+        }
+
+        mEdgeTargets.resize(mIndices.size());
+        mTriangles.resize(mIndices.size());
+
+        std::vector<unsigned int> edgeFill(mEdgeOffsets.begin(), mEdgeOffsets.end() - 1);
+        std::vector<unsigned int> triangleFill(mTriangleOffsets.begin(), mTriangleOffsets.end() - 1);
+
+        for (size_t i = 0; i < mIndices.size(); i += 3)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                unsigned int from = mIndices[i + k];
+                unsigned int to = mIndices[i + (k + 1) % 3];
+
+                mEdgeTargets[edgeFill[from]++] = to;
+                mTriangles[triangleFill[from]++] = static_cast<unsigned int>(i / 3);
+            }
+        }
+    }
+
+    bool Simplifier::HasEdge(unsigned int from, unsigned int to) const
+    {
+        for (unsigned int i = mEdgeOffsets[from]; i < mEdgeOffsets[from + 1]; ++i)
+        {
+            if (mEdgeTargets[i] == to)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Simplifier::ClassifyVertices()
+    {
+        const unsigned int NoVertex = std::numeric_limits<unsigned int>::max();
+        const size_t vertexCount = mPositions.size();
+
+        // Find open edges: edges whose reverse edge does not exist in any triangle.
+        std::vector<unsigned int> openOutCount(vertexCount, 0), openInCount(vertexCount, 0);
+        std::vector<unsigned int> openOutTarget(vertexCount, NoVertex);
+
+        for (unsigned int from = 0; from < vertexCount; ++from)
+        {
+            for (unsigned int i = mEdgeOffsets[from]; i < mEdgeOffsets[from + 1]; ++i)
+            {
+                unsigned int to = mEdgeTargets[i];
+
+                if (!HasEdge(to, from))
+                {
+                    openOutCount[from]++;
+                    openOutTarget[from] = to;
+                    openInCount[to]++;
+                }
+            }
+        }
+
+        // An open edge that is closed when comparing positions instead of indices belongs to a seam.
+        auto isClosedByPosition = [this](unsigned int from, unsigned int to) {
+            unsigned int toWedge = to;
+
+            do
+            {
+                unsigned int fromWedge = from;
+
+                do
+                {
+                    if (HasEdge(toWedge, fromWedge)) { return true; }
+                    fromWedge = mWedge[fromWedge];
+                } while (fromWedge != from);
+
+                toWedge = mWedge[toWedge];
+            } while (toWedge != to);
+
+            return false;
+        };
+
+        for (unsigned int v = 0; v < vertexCount; ++v)
+        {
+            if (mGroup[v] != v)
+            {
+                continue;
+            }
+
+            unsigned int twin = mWedge[v];
+            VertexKind kind = VertexKind::Locked;
+
+            if (twin == v)
+            {
+                if (openOutCount[v] == 0 && openInCount[v] == 0)
+                {
+                    kind = VertexKind::Manifold;
+                }
+                else if (openOutCount[v] == 1 && openInCount[v] == 1)
+                {
+                    kind = VertexKind::Border;
+                }
+            }
+            else if (mWedge[twin] == v &&
+                     openOutCount[v] == 1 && openInCount[v] == 1 &&
+                     openOutCount[twin] == 1 && openInCount[twin] == 1 &&
+                     isClosedByPosition(v, openOutTarget[v]) &&
+                     isClosedByPosition(twin, openOutTarget[twin]))
+            {
+                kind = VertexKind::Seam;
+            }
+
+            // Every vertex at this position shares the classification.
+            unsigned int wedge = v;
+
+            do
+            {
+                mKinds[wedge] = kind;
+                wedge = mWedge[wedge];
+            } while (wedge != v);
+        }
+    }
+
+    void Simplifier::ComputeQuadrics()
+    {
+        quadric_t zero = quadric_t::FromPlane(point_t(), 0.0, 0.0);
+        mQuadrics.assign(mPositions.size(), zero);
+
+        for (size_t i = 0; i < mIndices.size(); i += 3)
+        {
+            const point_t& p0 = mPositions[mIndices[i + 0]];
+            const point_t& p1 = mPositions[mIndices[i + 1]];
+            const point_t& p2 = mPositions[mIndices[i + 2]];
+
+            point_t normal = Cross(Subtract(p1, p0), Subtract(p2, p0));
+            double length = std::sqrt(Dot(normal, normal));
+
+            if (length <= 0.0)
+            {
+                continue;
+            }
+
+            normal.x /= length;
+            normal.y /= length;
+            normal.z /= length;
+
+            // Triangle plane, weighted by area.
+            quadric_t plane = quadric_t::FromPlane(normal, -Dot(normal, p0), length * 0.5);
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                mQuadrics[mGroup[mIndices[i + k]]] += plane;
+            }
+
+            // Border and seam edges also get a plane through the edge, perpendicular to the triangle.
+            for (size_t k = 0; k < 3; ++k)
+            {
+                unsigned int from = mIndices[i + k];
+                unsigned int to = mIndices[i + (k + 1) % 3];
+
+                if (HasEdge(to, from))
+                {
+                    continue;
+                }
+
+                point_t edge = Subtract(mPositions[to], mPositions[from]);
+                double edgeLengthSquared = Dot(edge, edge);
+                point_t edgeNormal = Cross(edge, normal);
+                double edgeNormalLength = std::sqrt(Dot(edgeNormal, edgeNormal));
+
+                if (edgeNormalLength <= 0.0)
+                {
+                    continue;
+                }
+
+                edgeNormal.x /= edgeNormalLength;
+                edgeNormal.y /= edgeNormalLength;
+                edgeNormal.z /= edgeNormalLength;
+
+                quadric_t border = quadric_t::FromPlane(
+                    edgeNormal,
+                    -Dot(edgeNormal, mPositions[from]),
+                    edgeLengthSquared * BorderWeight);
+
+                mQuadrics[mGroup[from]] += border;
+                mQuadrics[mGroup[to]] += border;
+            }
+        }
+    }
+
+    bool Simplifier::CanCollapse(unsigned int from, unsigned int to, bool openEdge) const
+    {
+        if (mGroup[from] == mGroup[to])
+        {
+            return false;
+        }
+
+        switch (mKinds[from])
+        {
+        case VertexKind::Manifold:
+            return true;
+
+        case VertexKind::Border:
+            return openEdge && (mKinds[to] == VertexKind::Border || mKinds[to] == VertexKind::Locked);
+
+        case VertexKind::Seam:
+            return openEdge && (mKinds[to] == VertexKind::Seam || mKinds[to] == VertexKind::Locked);
+
+        default:
+            return false;
+        }
+    }
+
+    // A seam vertex has to move together with its twin on the other side of the seam. Find the twin and the vertex
+    // at the destination it should merge into.
+    bool Simplifier::FindSeamTwin(
+        unsigned int from,
+        unsigned int to,
+        unsigned int *pFromTwinOut,
+        unsigned int *pToTwinOut) const
+    {
+        unsigned int fromTwin = mWedge[from];
+        unsigned int toWedge = to;
+
+        // Start with the other vertices at the destination, the twin is normally on the other side of the seam.
+        do
+        {
+            toWedge = mWedge[toWedge];
+
+            if (HasEdge(fromTwin, toWedge) || HasEdge(toWedge, fromTwin))
+            {
+                *pFromTwinOut = fromTwin;
+                *pToTwinOut = toWedge;
+                return true;
+            }
+        } while (toWedge != to);
+
+        return false;
+    }
+
+    // Check if moving every vertex at from's position to to's position would turn any surviving triangle over. Corners
+    // are looked up through the remap of the current pass, so earlier collapses in the pass are taken into account.
+    bool Simplifier::FlipsTriangles(unsigned int from, unsigned int to, const std::vector<unsigned int>& remap) const
+    {
+        const point_t& destination = mPositions[to];
+        unsigned int fromGroup = mGroup[from];
+        unsigned int toGroup = mGroup[to];
+        unsigned int wedge = from;
+
+        do
+        {
+            for (unsigned int i = mTriangleOffsets[wedge]; i < mTriangleOffsets[wedge + 1]; ++i)
+            {
+                const unsigned int * pTriangle = &mIndices[mTriangles[i] * 3];
+                point_t before[3], after[3];
+                bool removed = false;
+
+                for (int k = 0; k < 3; ++k)
+                {
+                    unsigned int corner = remap[pTriangle[k]];
+                    unsigned int group = mGroup[corner];
+
+                    removed = removed || (group == toGroup);
+                    before[k] = mPositions[corner];
+                    after[k] = (group == fromGroup ? destination : before[k]);
+                }
+
+                // Triangles containing both ends of the edge disappear.
+                if (removed)
+                {
+                    continue;
+                }
+
+                point_t normalBefore = Cross(Subtract(before[1], before[0]), Subtract(before[2], before[0]));
+                point_t normalAfter = Cross(Subtract(after[1], after[0]), Subtract(after[2], after[0]));
+
+                if (Dot(normalBefore, normalAfter) <= 0.0)
+                {
+                    return true;
+                }
+            }
+
+            wedge = mWedge[wedge];
+        } while (wedge != from);
+
+        return false;
+    }
+
+    double Simplifier::CollapseError(unsigned int from, unsigned int to) const
+    {
+        quadric_t combined = mQuadrics[mGroup[from]];
+        combined += mQuadrics[mGroup[to]];
+
+        if (combined.weight <= 0.0)
+        {
+            return 0.0;
+        }
+
+        return combined.Evaluate(mPositions[to]) / combined.weight;
+    }
+
+    size_t Simplifier::CollapsePass(size_t targetTriangleCount)
+    {
+        const size_t triangleCount = mIndices.size() / 3;
+
+        // Gather every legal collapse. Open edges exist in one direction only, so try both ends.
+        std::vector<collapse_t> collapses;
+        collapses.reserve(mIndices.size());
+
+        for (size_t i = 0; i < mIndices.size(); i += 3)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                unsigned int a = mIndices[i + k];
+                unsigned int b = mIndices[i + (k + 1) % 3];
+                bool openEdge = !HasEdge(b, a);
+
+                if (CanCollapse(a, b, openEdge))
+                {
+                    collapse_t collapse = { a, b, CollapseError(a, b) };
+                    collapses.push_back(collapse);
+                }
+
+                if (openEdge && CanCollapse(b, a, openEdge))
+                {
+                    collapse_t collapse = { b, a, CollapseError(b, a) };
+                    collapses.push_back(collapse);
+                }
+            }
+        }
+
+        if (collapses.empty())
+        {
+            return 0;
+        }
+
+        std::sort(collapses.begin(), collapses.end());
+
+        // Most collapses remove two triangles. Stop the pass once the target is reached, or once collapses get
+        // noticeably worse than the ideal last one so later passes can pick cheaper collapses with updated quadrics.
+        const size_t trianglesToRemove = triangleCount - targetTriangleCount;
+        const size_t collapseGoal = trianglesToRemove / 2;
+        const double errorLimit = collapseGoal < collapses.size()
+            ? collapses[collapseGoal].error * PassErrorSlack
+            : std::numeric_limits<double>::max();
+
+        std::vector<unsigned int> remap(mPositions.size());
+        std::vector<bool> locked(mPositions.size(), false);
+
+        for (size_t i = 0; i < remap.size(); ++i)
+        {
+            remap[i] = static_cast<unsigned int>(i);
+        }
+
+        // Cheap collapses that keep getting rejected (flips, seam twins) would pin the limit down and leave every pass
+        // doing a handful of collapses. Always make some progress before applying the limit.
+        const size_t minimumCollapseCount = std::max<size_t>(collapseGoal / 4, 1);
+
+        size_t collapseCount = 0;
+        size_t trianglesRemoved = 0;
+
+        for (const collapse_t& collapse : collapses)
+        {
+            if (trianglesRemoved >= trianglesToRemove)
+            {
+                break;
+            }
+
+            if (collapse.error > errorLimit && collapseCount >= minimumCollapseCount)
+            {
+                break;
+            }
+
+            unsigned int fromGroup = mGroup[collapse.from];
+            unsigned int toGroup = mGroup[collapse.to];
+
+            if (locked[fromGroup] || locked[toGroup])
+            {
+                continue;
+            }
+
+            unsigned int fromTwin = collapse.from, toTwin = collapse.to;
+
+            if (mKinds[collapse.from] == VertexKind::Seam && !FindSeamTwin(collapse.from, collapse.to, &fromTwin, &toTwin))
+            {
+                continue;
+            }
+
+            if (FlipsTriangles(collapse.from, collapse.to, remap))
+            {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+            remap[fromTwin] = toTwin;
+
+            mQuadrics[toGroup] += mQuadrics[fromGroup];
+            mMaxError = std::max(mMaxError, collapse.error);
+
+            locked[fromGroup] = true;
+            locked[toGroup] = true;
+
+            trianglesRemoved += (mKinds[collapse.from] == VertexKind::Border ? 1 : 2);
+            collapseCount++;
+        }
+
+        for (unsigned int& index : mIndices)
+        {
+            index = remap[index];
+        }
+
+        RemoveDegenerateTriangles();
+        return collapseCount;
+    }
+
+    void Simplifier::RemoveDegenerateTriangles()
+    {
+        size_t writeIndex = 0;
+
+        for (size_t i = 0; i < mIndices.size(); i += 3)
+        {
+            unsigned int g0 = mGroup[mIndices[i + 0]];
+            unsigned int g1 = mGroup[mIndices[i + 1]];
+            unsigned int g2 = mGroup[mIndices[i + 2]];
+
+            if (g0 != g1 && g1 != g2 && g0 != g2)
+            {
+                mIndices[writeIndex++] = mIndices[i + 0];
+                mIndices[writeIndex++] = mIndices[i + 1];
+                mIndices[writeIndex++] = mIndices[i + 2];
+            }
+        }
+
+        mIndices.resize(writeIndex);
+    }
+}
+
+float MeshSimplifier::Simplify(const s_mesh_data_t& mesh, size_t targetIndexCount, std::vector<int> *pIndicesOut)
+{
+    AssertNotNull(pIndicesOut);
+
+    Simplifier simplifier(mesh);
+    simplifier.SimplifyTo(targetIndexCount);
+    simplifier.CopyIndices(pIndicesOut);
+
+    return simplifier.Error();
+}
+
+void MeshSimplifier::GenerateLods(s_mesh_data_t *pMesh, const std::vector<float>& ratios)
+{
+    AssertNotNull(pMesh);
+
+    for (size_t i = 0; i < ratios.size(); ++i)
+    {
+        Verify(ratios[i] > 0.0f && ratios[i] < 1.0f);
+        Verify(i == 0 || ratios[i] < ratios[i - 1]);
+    }
+
+    const size_t triangleCount = pMesh->indices.size() / 3;
+
+    Simplifier simplifier(*pMesh);
+    pMesh->lods.resize(ratios.size());
+
+    for (size_t i = 0; i < ratios.size(); ++i)
+    {
+        size_t targetTriangleCount = static_cast<size_t>(static_cast<double>(triangleCount) * ratios[i]);
+        simplifier.SimplifyTo(targetTriangleCount * 3);
+
+        simplifier.CopyIndices(&pMesh->lods[i].indices);
+        pMesh->lods[i].error = simplifier.Error();
+    }
+}
+
+void MeshSimplifier::GenerateLods(
+    const std::vector<s_mesh_data_t *>& meshes,
+    const std::vector<float>& ratios,
+    unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, meshes.size()));
+
+    if (threadCount <= 1)
+    {
+        for (s_mesh_data_t * pMesh : meshes)
+        {
+            GenerateLods(pMesh, ratios);
+        }
+
+        return;
+    }
+
+    // Workers pull the next mesh off a shared counter, so a few large meshes do not leave the other workers idle.
+    // Exceptions are carried back to the calling thread.
+    std::atomic<size_t> nextMesh(0);
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::vector<std::thread> workers;
+
+    for (unsigned int t = 0; t < threadCount; ++t)
+    {
+        workers.push_back(std::thread([&, t]() {
+            try
+            {
+                for (size_t i = nextMesh++; i < meshes.size(); i = nextMesh++)
+                {
+                    GenerateLods(meshes[i], ratios);
+                }
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+                nextMesh = meshes.size();
+            }
+        }));
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
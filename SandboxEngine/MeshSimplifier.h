@@ -0,0 +1,32 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+
+/**
+ * \brief Quadric error metric mesh simplification and level of detail generation.
+ *
+ * Simplification repeatedly collapses the edge whose removal adds the least error, measured with per vertex error
+ * quadrics (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics", 1997). Edges always collapse
+ * onto one of their existing vertices, so simplified index lists keep referencing the original vertex buffer and a
+ * whole LOD chain can share a single set of vertices.
+ *
+ * Vertices on mesh borders only slide along the border, and vertices on texture coordinate seams (several vertices at
+ * one position) only slide along the seam together with their twin. Anything more complicated is locked in place.
+ */
+namespace MeshSimplifier
+{
+    // Simplify mesh.indices down to at most targetIndexCount indices. Stops early when no more collapses are
+    // possible. Returns the error of the result, an estimate of its distance from the original surface.
+    float Simplify(const s_mesh_data_t& mesh, size_t targetIndexCount, std::vector<int> *pIndicesOut);
+
+    // Replace mesh.lods with one level per ratio. Ratios are fractions of the original triangle count and must be
+    // strictly decreasing, for example { 0.5f, 0.25f, 0.125f }.
+    void GenerateLods(s_mesh_data_t *pMesh, const std::vector<float>& ratios);
+
+    // Generate LOD chains for a batch of meshes in parallel, one mesh per worker at a time. A thread count of zero
+    // uses one worker per hardware thread.
+    void GenerateLods(
+        const std::vector<s_mesh_data_t *>& meshes,
+        const std::vector<float>& ratios,
+        unsigned int threadCount = 0);
+}
@@ -0,0 +1,322 @@
+#include "stdafx.h"
+#include "MeshletBuilder.h"
+#include "MeshData.h"
+#include "BoundingVolumes.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    const int NotInMeshlet = -1;
+
+    float Dot(const float a[3], const float b[3])
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // Working state for the meshlet currently being built.
+    class MeshletAccumulator
+    {
+    public:
+        MeshletAccumulator(size_t meshVertexCount, s_meshlet_data_t& output)
+            : mLocalIndices(meshVertexCount, NotInMeshlet),
+              mOutput(output),
+              mCurrent()
+        {
+            Reset();
+        }
+
+        unsigned int VertexCount() const { return mCurrent.vertexCount; }
+        unsigned int TriangleCount() const { return mCurrent.triangleCount; }
+
+        // Number of vertices the triangle would add to the meshlet.
+        unsigned int NewVertexCount(const int * pTriangle) const
+        {
+            return (mLocalIndices[pTriangle[0]] == NotInMeshlet ? 1 : 0) +
+                   (mLocalIndices[pTriangle[1]] == NotInMeshlet ? 1 : 0) +
+                   (mLocalIndices[pTriangle[2]] == NotInMeshlet ? 1 : 0);
+        }
+
+        void AddTriangle(const int * pTriangle)
+        {
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                int& localIndex = mLocalIndices[pTriangle[corner]];
+
+                if (localIndex == NotInMeshlet)
+                {
+                    localIndex = static_cast<int>(mCurrent.vertexCount++);
+                    mOutput.vertices.push_back(static_cast<unsigned int>(pTriangle[corner]));
+                }
+
+                mOutput.triangles.push_back(static_cast<unsigned char>(localIndex));
+            }
+
+            mCurrent.triangleCount++;
+        }
+
+        void Finish(const s_mesh_data_t& mesh)
+        {
+            if (mCurrent.triangleCount == 0)
+            {
+                return;
+            }
+
+            mOutput.meshlets.push_back(mCurrent);
+            mOutput.bounds.push_back(MeshletBuilder::ComputeBounds(mesh, mOutput, mCurrent));
+
+            // Clear local indices of the vertices used by the finished meshlet.
+            for (unsigned int i = 0; i < mCurrent.vertexCount; ++i)
+            {
+                mLocalIndices[mOutput.vertices[mCurrent.vertexOffset + i]] = NotInMeshlet;
+            }
+
+            Reset();
+        }
+
+    private:
+        void Reset()
+        {
+            mCurrent.vertexOffset = static_cast<unsigned int>(mOutput.vertices.size());
+            mCurrent.triangleOffset = static_cast<unsigned int>(mOutput.triangles.size());
+            mCurrent.vertexCount = 0;
+            mCurrent.triangleCount = 0;
+        }
+
+    private:
+        std::vector<int> mLocalIndices;     // Mesh vertex index -> meshlet local index.
+        s_meshlet_data_t& mOutput;
+        meshlet_t mCurrent;
+    };
+}
+
+void MeshletBuilder::Build(
+    const s_mesh_data_t& mesh,
+    s_meshlet_data_t *pMeshletsOut,
+    unsigned int maxVertices,
+    unsigned int maxTriangles)
+{
+    AssertNotNull(pMeshletsOut);
+    Verify(maxVertices >= 3 && maxVertices <= 256);        // local indices are stored in a byte.
+    Verify(maxTriangles >= 1);
+    Verify(mesh.indices.size() % 3 == 0);
+
+    const size_t vertexCount = mesh.vertices.size();
+    const size_t triangleCount = mesh.indices.size() / 3;
+
+    *pMeshletsOut = s_meshlet_data_t();
+
+    // Build vertex -> triangle adjacency, stored as one flat array with per vertex offsets.
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+    std::vector<unsigned int> adjacency(mesh.indices.size());
+
+    for (int index : mesh.indices)
+    {
+        Verify(index >= 0 && static_cast<size_t>(index) < vertexCount);
+        adjacencyOffsets[index + 1]++;
+    }
+
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+
+    {
+        std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for (size_t i = 0; i < mesh.indices.size(); ++i)
+        {
+            adjacency[fill[mesh.indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+
+    // Grow meshlets one triangle at a time.
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> candidates;
+    MeshletAccumulator accumulator(vertexCount, *pMeshletsOut);
+    size_t nextSeed = 0;
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        // Pick the candidate triangle that adds the fewest vertices to the meshlet. Drop candidates that were already
+        // emitted by an earlier step.
+        const size_t NoTriangle = static_cast<size_t>(-1);
+        size_t bestTriangle = NoTriangle;
+        unsigned int bestScore = 4;
+
+        for (size_t i = 0; i < candidates.size();)
+        {
+            unsigned int triangle = candidates[i];
+
+            if (emitted[triangle])
+            {
+                candidates[i] = candidates.back();
+                candidates.pop_back();
+                continue;
+            }
+
+            unsigned int score = accumulator.NewVertexCount(&mesh.indices[triangle * 3]);
+
+            if (score < bestScore || (score == bestScore && triangle < bestTriangle))
+            {
+                bestScore = score;
+                bestTriangle = triangle;
+            }
+
+            ++i;
+        }
+
+        // No neighbours left, seed with the next unused triangle in index order.
+        if (bestTriangle == NoTriangle)
+        {
+            while (emitted[nextSeed]) { ++nextSeed; }
+
+            bestTriangle = nextSeed;
+            bestScore = accumulator.NewVertexCount(&mesh.indices[bestTriangle * 3]);
+        }
+
+        // Close the meshlet if the triangle does not fit. The triangle then seeds the next meshlet, which keeps it
+        // next to the one just finished.
+        if (accumulator.VertexCount() + bestScore > maxVertices || accumulator.TriangleCount() + 1 > maxTriangles)
+        {
+            accumulator.Finish(mesh);
+            candidates.clear();
+        }
+
+        const int * pTriangle = &mesh.indices[bestTriangle * 3];
+
+        accumulator.AddTriangle(pTriangle);
+        emitted[bestTriangle] = true;
+
+        // Everything sharing a vertex with the new triangle is a candidate for the next step.
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            unsigned int vertex = static_cast<unsigned int>(pTriangle[corner]);
+
+            for (unsigned int i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i)
+            {
+                if (!emitted[adjacency[i]])
+                {
+                    candidates.push_back(adjacency[i]);
+                }
+            }
+        }
+    }
+
+    accumulator.Finish(mesh);
+}
+
+meshlet_bounds_t MeshletBuilder::ComputeBounds(
+    const s_mesh_data_t& mesh,
+    const s_meshlet_data_t& meshlets,
+    const meshlet_t& meshlet)
+{
+    meshlet_bounds_t bounds = { { 0.0f, 0.0f, 0.0f }, 0.0f, { 0.0f, 0.0f, 0.0f }, 1.0f };
+
+    if (meshlet.vertexCount == 0)
+    {
+        return bounds;
+    }
+
+    // Bounding sphere of the meshlet vertices.
+    std::vector<float> positions(meshlet.vertexCount * 3);
+    std::vector<const float *> points(meshlet.vertexCount);
+
+    for (unsigned int i = 0; i < meshlet.vertexCount; ++i)
+    {
+        const s_mesh_vertex_t& vertex = mesh.vertices[meshlets.vertices[meshlet.vertexOffset + i]];
+
+        positions[i * 3 + 0] = vertex.x;
+        positions[i * 3 + 1] = vertex.y;
+        positions[i * 3 + 2] = vertex.z;
+        points[i] = &positions[i * 3];
+    }
+
+    bounding_sphere_t sphere =
+        BoundingVolumes::ComputeBoundingSphere(&positions[0], meshlet.vertexCount, sizeof(float) * 3);
+
+    std::copy(sphere.center, sphere.center + 3, bounds.center);
+    bounds.radius = sphere.radius;
+
+    // Face normals. Front faces are clockwise, which for a left handed system makes cross(b - a, c - a) point out of
+    // the front face.
+    std::vector<float> normals;
+    normals.reserve(meshlet.triangleCount * 3);
+
+    float axis[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (unsigned int t = 0; t < meshlet.triangleCount; ++t)
+    {
+        const unsigned char * pLocal = &meshlets.triangles[meshlet.triangleOffset + t * 3];
+        const float * a = points[pLocal[0]];
+        const float * b = points[pLocal[1]];
+        const float * c = points[pLocal[2]];
+
+        float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+        float length = std::sqrt(Dot(n, n));
+
+        // Degenerate triangles have no facing and are invisible anyway.
+        if (length <= 0.0f)
+        {
+            continue;
+        }
+
+        for (int k = 0; k < 3; ++k)
+        {
+            n[k] /= length;
+            axis[k] += n[k];
+            normals.push_back(n[k]);
+        }
+    }
+
+    float axisLength = std::sqrt(Dot(axis, axis));
+
+    if (normals.empty() || axisLength <= 0.0f)
+    {
+        return bounds;
+    }
+
+    axis[0] /= axisLength;
+    axis[1] /= axisLength;
+    axis[2] /= axisLength;
+
+    // The cone has to cover every face normal. Widening it by 90 degrees on each side and inverting it gives the cone
+    // of view directions that see only back faces: its cutoff is cos(90 - angle) = sin(angle).
+    //   See "Optimizing the Graphics Pipeline with Compute", Wihlidal 2016.
+    float minimumDot = 1.0f;
+
+    for (size_t i = 0; i < normals.size(); i += 3)
+    {
+        minimumDot = std::min(minimumDot, Dot(&normals[i], axis));
+    }
+
+    bounds.coneAxis[0] = axis[0];
+    bounds.coneAxis[1] = axis[1];
+    bounds.coneAxis[2] = axis[2];
+    bounds.coneCutoff = (minimumDot <= 0.1f) ? 1.0f : std::sqrt(1.0f - minimumDot * minimumDot);
+
+    return bounds;
+}
+
+bool MeshletBuilder::IsBackfacing(const meshlet_bounds_t& bounds, const float viewerPosition[3])
+{
+    if (bounds.coneCutoff >= 1.0f)
+    {
+        return false;
+    }
+
+    float toCenter[3] =
+    {
+        bounds.center[0] - viewerPosition[0],
+        bounds.center[1] - viewerPosition[1],
+        bounds.center[2] - viewerPosition[2]
+    };
+
+    float distance = std::sqrt(Dot(toCenter, toCenter));
+    return Dot(toCenter, bounds.coneAxis) >= bounds.coneCutoff * distance + bounds.radius;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "MeshData.h"
+
+/**
+ * \brief Splits indexed triangle meshes into meshlets: small clusters of triangles that can be culled individually.
+ *
+ * Triangles are added greedily. Each step picks the triangle adjacent to the current meshlet that needs the fewest new
+ * vertices, which keeps meshlets compact and spatially coherent. A meshlet is closed when the next triangle would push
+ * it past the vertex or triangle limit. Every closed meshlet gets a bounding sphere and a normal cone.
+ *
+ * The default limits (64 vertices, 124 triangles) match what mesh shading hardware prefers and keep meshlet local
+ * vertex indices within a byte.
+ */
+namespace MeshletBuilder
+{
+    const unsigned int DefaultMaxVertices = 64;
+    const unsigned int DefaultMaxTriangles = 124;
+
+    // Partition mesh.indices into meshlets. Any existing contents of pMeshletsOut are replaced.
+    void Build(
+        const s_mesh_data_t& mesh,
+        s_meshlet_data_t *pMeshletsOut,
+        unsigned int maxVertices = DefaultMaxVertices,
+        unsigned int maxTriangles = DefaultMaxTriangles);
+
+    // Compute the bounding sphere and normal cone of a single meshlet.
+    meshlet_bounds_t ComputeBounds(
+        const s_mesh_data_t& mesh,
+        const s_meshlet_data_t& meshlets,
+        const meshlet_t& meshlet);
+
+    // Check if every triangle in a meshlet faces away from a viewer at the given model space position.
+    bool IsBackfacing(const meshlet_bounds_t& bounds, const float viewerPosition[3]);
+}
@@ -0,0 +1,84 @@
+#include "stdafx.h"
+#include "MeshletCuller.h"
+#include "MeshletBuilder.h"
+#include "MeshData.h"
+#include "Frustum.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX::SimpleMath;
+
+float meshlet_cull_stats_t::TriangleRejectionRate() const
+{
+    if (trianglesTested == 0)
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(trianglesFrustumCulled + trianglesBackfaceCulled) / static_cast<float>(trianglesTested);
+}
+
+void MeshletCuller::Cull(
+    const s_meshlet_data_t& meshlets,
+    const Matrix& worldMatrix,
+    const Frustum& frustum,
+    const Vector3& cameraPosition,
+    std::vector<unsigned int> *pVisibleOut,
+    meshlet_cull_stats_t *pStatsOut)
+{
+    AssertNotNull(pVisibleOut);
+    Verify(meshlets.bounds.size() == meshlets.meshlets.size());
+
+    // Spheres are moved into world space for the frustum test. Scale the radius by the largest axis scale so the
+    // sphere stays conservative under non uniform scaling.
+    float radiusScale = std::sqrt(std::max(
+        Vector3(worldMatrix._11, worldMatrix._12, worldMatrix._13).LengthSquared(),
+        std::max(
+            Vector3(worldMatrix._21, worldMatrix._22, worldMatrix._23).LengthSquared(),
+            Vector3(worldMatrix._31, worldMatrix._32, worldMatrix._33).LengthSquared())));
+
+    // Facing does not change under an affine transform, so cone tests happen in model space against a model space
+    // camera instead of transforming every cone.
+    Vector3 modelCamera = Vector3::Transform(cameraPosition, worldMatrix.Invert());
+    const float viewer[3] = { modelCamera.x, modelCamera.y, modelCamera.z };
+
+    meshlet_cull_stats_t stats = { 0, 0, 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < meshlets.meshlets.size(); ++i)
+    {
+        const meshlet_bounds_t& bounds = meshlets.bounds[i];
+        unsigned int triangleCount = meshlets.meshlets[i].triangleCount;
+
+        stats.meshletsTested++;
+        stats.trianglesTested += triangleCount;
+
+        Vector3 center = Vector3::Transform(Vector3(bounds.center[0], bounds.center[1], bounds.center[2]), worldMatrix);
+
+        if (!frustum.CheckSphere(center, bounds.radius * radiusScale))
+        {
+            stats.meshletsFrustumCulled++;
+            stats.trianglesFrustumCulled += triangleCount;
+        }
+        else if (MeshletBuilder::IsBackfacing(bounds, viewer))
+        {
+            stats.meshletsBackfaceCulled++;
+            stats.trianglesBackfaceCulled += triangleCount;
+        }
+        else
+        {
+            pVisibleOut->push_back(static_cast<unsigned int>(i));
+        }
+    }
+
+    if (pStatsOut != nullptr)
+    {
+        pStatsOut->meshletsTested += stats.meshletsTested;
+        pStatsOut->meshletsFrustumCulled += stats.meshletsFrustumCulled;
+        pStatsOut->meshletsBackfaceCulled += stats.meshletsBackfaceCulled;
+        pStatsOut->trianglesTested += stats.trianglesTested;
+        pStatsOut->trianglesFrustumCulled += stats.trianglesFrustumCulled;
+        pStatsOut->trianglesBackfaceCulled += stats.trianglesBackfaceCulled;
+    }
+}
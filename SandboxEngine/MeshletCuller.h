@@ -0,0 +1,38 @@
+#pragma once
+#include "MathTypes.h"
+#include <vector>
+
+class Frustum;
+struct s_meshlet_data_t;
+
+/**
+ * \brief Counters collected while culling meshlets.
+ */
+struct meshlet_cull_stats_t
+{
+    unsigned int meshletsTested;
+    unsigned int meshletsFrustumCulled;
+    unsigned int meshletsBackfaceCulled;
+    unsigned int trianglesTested;
+    unsigned int trianglesFrustumCulled;
+    unsigned int trianglesBackfaceCulled;
+
+    // Fraction of tested triangles that were rejected for any reason.
+    float TriangleRejectionRate() const;
+};
+
+/**
+ * \brief CPU culling of meshlets against the view frustum and their normal cones.
+ */
+namespace MeshletCuller
+{
+    // Append the index of every meshlet that survives culling to pVisibleOut. The world matrix places the mesh in the
+    // same space as the frustum and camera position. pStatsOut is optional, and is accumulated into rather than reset.
+    void Cull(
+        const s_meshlet_data_t& meshlets,
+        const DirectX::SimpleMath::Matrix& worldMatrix,
+        const Frustum& frustum,
+        const DirectX::SimpleMath::Vector3& cameraPosition,
+        std::vector<unsigned int> *pVisibleOut,
+        meshlet_cull_stats_t *pStatsOut);
+}
@@ -0,0 +1,77 @@
+#include "stdafx.h"
+#include "ObjectPool.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Operator new's alignment on 64 bit Windows and Linux. Rounding blocks up to it keeps every block aligned.
+    const size_t BlockAlignment = 16;
+}
+
+FixedPool::FixedPool(size_t blockSize, size_t blocksPerPage)
+    : mPages(),
+      mpFreeList(nullptr),
+      mBlockSize(0),
+      mBlocksPerPage(std::max<size_t>(blocksPerPage, 1)),
+      mLiveCount(0),
+      mHighWaterMark(0)
+{
+    const size_t size = std::max(blockSize, sizeof(free_block_t));
+    mBlockSize = (size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+}
+
+FixedPool::~FixedPool()
+{
+    for (char * pPage : mPages)
+    {
+        delete[] pPage;
+    }
+}
+
+void * FixedPool::Allocate()
+{
+    if (mpFreeList == nullptr)
+    {
+        AddPage();
+    }
+
+    free_block_t * pBlock = mpFreeList;
+    mpFreeList = pBlock->pNext;
+
+    mLiveCount++;
+    mHighWaterMark = std::max(mHighWaterMark, mLiveCount);
+
+    return pBlock;
+}
+
+void FixedPool::Free(void * pBlock)
+{
+    if (pBlock == nullptr)
+    {
+        return;
+    }
+
+    Verify(mLiveCount > 0);
+
+    free_block_t * pFree = static_cast<free_block_t *>(pBlock);
+    pFree->pNext = mpFreeList;
+    mpFreeList = pFree;
+
+    mLiveCount--;
+}
+
+void FixedPool::AddPage()
+{
+    char * pPage = new char[mBlockSize * mBlocksPerPage];
+    mPages.push_back(pPage);
+
+    // Thread the new blocks onto the free list in address order.
+    for (size_t i = mBlocksPerPage; i > 0; --i)
+    {
+        free_block_t * pBlock = reinterpret_cast<free_block_t *>(pPage + (i - 1) * mBlockSize);
+        pBlock->pNext = mpFreeList;
+        mpFreeList = pBlock;
+    }
+}
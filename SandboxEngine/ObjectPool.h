@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>      // size_t
+#include <new>
+#include <utility>      // forward
+#include <vector>
+
+/**
+ * \brief Hands out memory blocks of one fixed size from pages allocated in bulk.
+ *
+ * Freed blocks go on a free list and are reused by the next allocation, so a pool that has reached its working size
+ * no longer touches the heap. Pages are only released when the pool is destroyed. Blocks are aligned like operator
+ * new. Not thread safe.
+ */
+class FixedPool
+{
+public:
+    FixedPool(size_t blockSize, size_t blocksPerPage = 64);
+    FixedPool(const FixedPool&) = delete;
+    ~FixedPool();
+
+    FixedPool& operator =(const FixedPool&) = delete;
+
+    void * Allocate();
+    void Free(void * pBlock);
+
+    size_t BlockSize() const { return mBlockSize; }
+
+    // Blocks handed out and not yet freed.
+    size_t LiveCount() const { return mLiveCount; }
+
+    // Blocks the pool owns, free or not.
+    size_t Capacity() const { return mPages.size() * mBlocksPerPage; }
+
+    // Most blocks live at once since construction or ResetHighWaterMark().
+    size_t HighWaterMark() const { return mHighWaterMark; }
+    void ResetHighWaterMark() { mHighWaterMark = mLiveCount; }
+
+    // Pages allocated from the heap.
+    unsigned long long HeapAllocationCount() const { return mPages.size(); }
+
+private:
+    struct free_block_t
+    {
+        free_block_t * pNext;
+    };
+
+    void AddPage();
+
+private:
+    std::vector<char *> mPages;
+    free_block_t * mpFreeList;
+    size_t mBlockSize;
+    size_t mBlocksPerPage;
+    size_t mLiveCount;
+    size_t mHighWaterMark;
+};
+
+/**
+ * \brief Pool of objects of one type, constructed by Create() and destroyed by Destroy().
+ */
+template<typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(size_t objectsPerPage = 64)
+        : mPool(sizeof(T), objectsPerPage)
+    {
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator =(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T * Create(Args&&... args)
+    {
+        void * pMemory = mPool.Allocate();
+
+        try
+        {
+            return new (pMemory) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            mPool.Free(pMemory);
+            throw;
+        }
+    }
+
+    void Destroy(T * pObject)
+    {
+        if (pObject != nullptr)
+        {
+            pObject->~T();
+            mPool.Free(pObject);
+        }
+    }
+
+    const FixedPool& Pool() const { return mPool; }
+
+private:
+    FixedPool mPool;
+};
+
+/**
+ * \brief Standard library allocator that takes single elements from a FixedPool.
+ *
+ * Meant for node based containers (std::list, std::map, std::set) whose nodes fit in the pool's blocks: make the
+ * pool's block size at least the container's node size. Allocations of more than one element or of anything bigger
+ * than a block go to the heap, so containers that also allocate arrays still work.
+ *
+ *  EXAMPLE:
+ *      FixedPool nodes(64);
+ *      std::list<int, PoolAllocator<int>> values(PoolAllocator<int>(nodes));
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+    typedef T * pointer;
+    typedef const T * const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+    explicit PoolAllocator(FixedPool& pool)
+        : mpPool(&pool)
+    {
+    }
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other)
+        : mpPool(other.Pool())
+    {
+    }
+
+    T * allocate(size_t count)
+    {
+        if (UsesPool(count))
+        {
+            return static_cast<T *>(mpPool->Allocate());
+        }
+
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T * pMemory, size_t count)
+    {
+        if (UsesPool(count))
+        {
+            mpPool->Free(pMemory);
+        }
+        else
+        {
+            ::operator delete(pMemory);
+        }
+    }
+
+    FixedPool * Pool() const { return mpPool; }
+
+    template<typename U>
+    bool operator ==(const PoolAllocator<U>& other) const { return mpPool == other.Pool(); }
+
+    template<typename U>
+    bool operator !=(const PoolAllocator<U>& other) const { return mpPool != other.Pool(); }
+
+private:
+    bool UsesPool(size_t count) const { return count == 1 && sizeof(T) <= mpPool->BlockSize(); }
+
+private:
+    FixedPool * mpPool;
+};
@@ -0,0 +1,442 @@
+#include "stdafx.h"
+#include "PackFile.h"
+#include "BinaryBlob.h"
+#include "BlockCompression.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+    const char Magic[4] = { 'S', 'B', 'P', 'K' };
+
+    struct pack_header_t
+    {
+        char magic[4];
+        unsigned int version;
+        unsigned int entryCount;
+        unsigned int alignment;
+        unsigned long long tocOffset;
+        unsigned long long namesOffset;
+        unsigned long long namesSize;
+    };
+
+    unsigned long long AlignUp(unsigned long long offset, unsigned long long alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    std::mutex GMountMutex;
+    std::vector<std::shared_ptr<const PackFile>> GMountedPacks;
+}
+
+struct PackFile::toc_entry_t
+{
+    unsigned long long hash;
+    unsigned long long offset;
+    unsigned long long size;
+    unsigned long long uncompressedSize;
+    unsigned int flags;
+    unsigned int nameOffset;
+};
+
+const float PackWriter::MinCompressionSavings = 0.05f;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Reading
+///////////////////////////////////////////////////////////////////////////////////////////////////
+PackFile::PackFile(const std::wstring& filepath)
+    : mFile(),
+      mpToc(nullptr),
+      mpNames(nullptr),
+      mNamesSize(0),
+      mEntryCount(0)
+{
+    mFile.Open(filepath);
+
+    const char * pData = mFile.Data();
+    const unsigned long long size = mFile.Size();
+    pack_header_t header;
+
+    if (size < sizeof(header))
+    {
+        throw FileFormatException(L"Pack file is truncated", filepath);
+    }
+
+    std::memcpy(&header, pData, sizeof(header));
+
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+    {
+        throw FileFormatException(L"Not a pack file", filepath);
+    }
+
+    if (header.version != Version)
+    {
+        throw FileFormatException(L"Unsupported pack file version", filepath);
+    }
+
+    if (header.tocOffset % sizeof(unsigned long long) != 0 ||
+        header.tocOffset > size ||
+        header.entryCount > (size - header.tocOffset) / sizeof(toc_entry_t) ||
+        header.namesOffset > size ||
+        header.namesSize > size - header.namesOffset ||
+        (header.entryCount > 0 && header.namesSize == 0))
+    {
+        throw FileFormatException(L"Pack file is truncated", filepath);
+    }
+
+    mpToc = reinterpret_cast<const toc_entry_t *>(pData + header.tocOffset);
+    mpNames = pData + header.namesOffset;
+    mNamesSize = static_cast<size_t>(header.namesSize);
+    mEntryCount = header.entryCount;
+
+    // Validate every entry up front so lookups never have to.
+    if (mEntryCount > 0 && mpNames[mNamesSize - 1] != '\0')
+    {
+        throw FileFormatException(L"Pack file names are corrupt", filepath);
+    }
+
+    for (unsigned int i = 0; i < mEntryCount; ++i)
+    {
+        const toc_entry_t& entry = mpToc[i];
+
+        if (entry.offset > size || entry.size > size - entry.offset || entry.nameOffset >= mNamesSize ||
+            ((entry.flags & FlagCompressed) == 0 && entry.uncompressedSize != entry.size))
+        {
+            throw FileFormatException(L"Pack file entry out of range", filepath);
+        }
+
+        if (i > 0 && entry.hash < mpToc[i - 1].hash)
+        {
+            throw FileFormatException(L"Pack file table of contents is not sorted", filepath);
+        }
+    }
+}
+
+PackFile::~PackFile()
+{
+}
+
+bool PackFile::Find(const std::wstring& path, pack_entry_t *pEntryOut) const
+{
+    return FindNormalized(NormalizePath(path), pEntryOut);
+}
+
+bool PackFile::Contains(const std::wstring& path) const
+{
+    pack_entry_t entry;
+    return Find(path, &entry);
+}
+
+bool PackFile::FindNormalized(const std::string& normalizedPath, pack_entry_t *pEntryOut) const
+{
+    AssertNotNull(pEntryOut);
+
+    const unsigned long long hash = HashPath(normalizedPath);
+    const toc_entry_t * pEnd = mpToc + mEntryCount;
+
+    // Binary search for the first entry with this hash.
+    const toc_entry_t * pEntry = mpToc;
+    size_t count = mEntryCount;
+
+    while (count > 0)
+    {
+        size_t half = count / 2;
+
+        if (pEntry[half].hash < hash)
+        {
+            pEntry += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    // Compare names as well so a path that is not in the pack can never match another entry's hash.
+    for (; pEntry != pEnd && pEntry->hash == hash; ++pEntry)
+    {
+        if (normalizedPath.compare(mpNames + pEntry->nameOffset) == 0)
+        {
+            *pEntryOut = Entry(static_cast<unsigned int>(pEntry - mpToc));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string PackFile::EntryName(unsigned int index) const
+{
+    Assert(index < mEntryCount);
+    return std::string(mpNames + mpToc[index].nameOffset);
+}
+
+pack_entry_t PackFile::Entry(unsigned int index) const
+{
+    Assert(index < mEntryCount);
+
+    pack_entry_t entry;
+    entry.pData = mFile.Data() + mpToc[index].offset;
+    entry.size = static_cast<size_t>(mpToc[index].size);
+    entry.uncompressedSize = static_cast<size_t>(mpToc[index].uncompressedSize);
+    entry.flags = mpToc[index].flags;
+
+    return entry;
+}
+
+void PackFile::ReadEntry(const pack_entry_t& entry, char * pDst, size_t dstSize, unsigned int threadCount) const
+{
+    Verify(dstSize == entry.uncompressedSize);
+
+    if ((entry.flags & FlagCompressed) == 0)
+    {
+        if (entry.size > 0)
+        {
+            std::memcpy(pDst, entry.pData, entry.size);
+        }
+
+        return;
+    }
+
+    // Blocks are decoded straight into the destination, there is no intermediate copy.
+    BlockDecoder decoder(entry.pData, entry.size, Filepath());
+
+    if (decoder.UncompressedSize() != entry.uncompressedSize)
+    {
+        throw FileFormatException(L"Pack file entry has the wrong uncompressed size", Filepath());
+    }
+
+    decoder.DecodeAll(pDst, dstSize, threadCount);
+}
+
+std::string PackFile::NormalizePath(const std::wstring& path)
+{
+    std::string normalized = Utils::ConvertUtf16ToUtf8(path);
+
+    for (char& c : normalized)
+    {
+        if (c == '\\') { c = '/'; }
+        else if (c >= 'A' && c <= 'Z') { c = static_cast<char>(c - 'A' + 'a'); }
+    }
+
+    size_t start = 0;
+
+    while (normalized.compare(start, 2, "./") == 0)
+    {
+        start += 2;
+    }
+
+    return normalized.substr(start);
+}
+
+unsigned long long PackFile::HashPath(const std::string& normalizedPath)
+{
+    // 64 bit FNV-1a.
+    unsigned long long hash = 14695981039346656037ull;
+
+    for (char c : normalizedPath)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Mounting
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void PackFile::Mount(const std::shared_ptr<const PackFile>& pack)
+{
+    Verify(pack != nullptr);
+
+    std::lock_guard<std::mutex> lock(GMountMutex);
+    GMountedPacks.push_back(pack);
+}
+
+void PackFile::UnmountAll()
+{
+    std::lock_guard<std::mutex> lock(GMountMutex);
+    GMountedPacks.clear();
+}
+
+std::shared_ptr<const PackFile> PackFile::FindMounted(const std::wstring& path, pack_entry_t *pEntryOut)
+{
+    AssertNotNull(pEntryOut);
+    std::vector<std::shared_ptr<const PackFile>> packs;
+
+    {
+        std::lock_guard<std::mutex> lock(GMountMutex);
+
+        if (GMountedPacks.empty())
+        {
+            return std::shared_ptr<const PackFile>();
+        }
+
+        packs = GMountedPacks;
+    }
+
+    std::string normalizedPath = NormalizePath(path);
+
+    for (auto pack = packs.rbegin(); pack != packs.rend(); ++pack)
+    {
+        if ((*pack)->FindNormalized(normalizedPath, pEntryOut))
+        {
+            return *pack;
+        }
+    }
+
+    return std::shared_ptr<const PackFile>();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Writing
+///////////////////////////////////////////////////////////////////////////////////////////////////
+PackWriter::PackWriter(unsigned int alignment)
+    : mAlignment(alignment),
+      mEntries(),
+      mHashes(),
+      mDataSize(0),
+      mStoredSize(0)
+{
+    Verify(alignment >= PackFile::SmallEntryAlignment && (alignment & (alignment - 1)) == 0);
+}
+
+void PackWriter::Add(const std::wstring& path, const char * pData, size_t size, bool compress)
+{
+    Verify(pData != nullptr || size == 0);
+
+    entry_t entry;
+    entry.name = PackFile::NormalizePath(path);
+    entry.hash = PackFile::HashPath(entry.name);
+    entry.uncompressedSize = size;
+    entry.flags = PackFile::FlagNone;
+
+    if (!mHashes.insert(entry.hash).second)
+    {
+        throw SandboxException(L"Duplicate pack entry", path);
+    }
+
+    if (compress && size > 0)
+    {
+        BlockCompression::Compress(pData, size, &entry.data);
+
+        // Barely compressible data is not worth decompressing every time it loads.
+        if (static_cast<double>(entry.data.size()) <= static_cast<double>(size) * (1.0 - MinCompressionSavings))
+        {
+            entry.flags = PackFile::FlagCompressed;
+        }
+    }
+
+    if (entry.flags == PackFile::FlagNone)
+    {
+        entry.data.assign(pData, pData + size);
+    }
+
+    mDataSize += size;
+    mStoredSize += entry.data.size();
+    mEntries.push_back(std::move(entry));
+}
+
+void PackWriter::AddFile(const std::wstring& path, const std::wstring& sourceFilepath, bool compress)
+{
+    BinaryBlob file = BinaryBlob::LoadFromFile(sourceFilepath);
+    Add(path, file.BufferPointer(), static_cast<size_t>(file.BufferSize()), compress);
+}
+
+void PackWriter::Save(const std::wstring& filepath) const
+{
+    // Lay out the table of contents, names and data.
+    std::vector<PackFile::toc_entry_t> toc(mEntries.size());
+    std::string names;
+
+    for (size_t i = 0; i < mEntries.size(); ++i)
+    {
+        toc[i].hash = mEntries[i].hash;
+        toc[i].size = mEntries[i].data.size();
+        toc[i].uncompressedSize = mEntries[i].uncompressedSize;
+        toc[i].flags = mEntries[i].flags;
+        toc[i].nameOffset = static_cast<unsigned int>(names.size());
+
+        names.append(mEntries[i].name);
+        names.push_back('\0');
+    }
+
+    pack_header_t header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = PackFile::Version;
+    header.entryCount = static_cast<unsigned int>(mEntries.size());
+    header.alignment = mAlignment;
+    header.tocOffset = sizeof(header);
+    header.namesOffset = header.tocOffset + toc.size() * sizeof(PackFile::toc_entry_t);
+    header.namesSize = names.size();
+
+    unsigned long long offset = header.namesOffset + header.namesSize;
+
+    for (size_t i = 0; i < mEntries.size(); ++i)
+    {
+        unsigned long long alignment = PackFile::SmallEntryAlignment;
+
+        if (toc[i].size >= mAlignment)
+        {
+            alignment = mAlignment;
+        }
+
+        offset = AlignUp(offset, alignment);
+        toc[i].offset = offset;
+        offset += toc[i].size;
+    }
+
+    // Data stays in the order it was added, only the table of contents is sorted.
+    std::vector<PackFile::toc_entry_t> sortedToc(toc);
+    std::sort(
+        sortedToc.begin(),
+        sortedToc.end(),
+        [](const PackFile::toc_entry_t& a, const PackFile::toc_entry_t& b) { return a.hash < b.hash; });
+
+    // Write everything out.
+    std::ofstream outputStream(filepath.c_str(), std::ios::binary);
+
+    if (!outputStream.is_open())
+    {
+        throw FileSaveException(filepath);
+    }
+
+    outputStream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if (!sortedToc.empty())
+    {
+        outputStream.write(
+            reinterpret_cast<const char *>(&sortedToc[0]),
+            static_cast<std::streamsize>(sortedToc.size() * sizeof(PackFile::toc_entry_t)));
+    }
+
+    outputStream.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    const std::vector<char> padding(mAlignment, 0);
+    unsigned long long written = header.namesOffset + header.namesSize;
+
+    for (size_t i = 0; i < mEntries.size(); ++i)
+    {
+        outputStream.write(&padding[0], static_cast<std::streamsize>(toc[i].offset - written));
+
+        if (!mEntries[i].data.empty())
+        {
+            outputStream.write(&mEntries[i].data[0], static_cast<std::streamsize>(toc[i].size));
+        }
+
+        written = toc[i].offset + toc[i].size;
+    }
+
+    if (!outputStream)
+    {
+        throw FileSaveException(filepath);
+    }
+}
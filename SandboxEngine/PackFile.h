@@ -0,0 +1,147 @@
+#pragma once
+#include "MappedFile.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * \brief Location of one file inside a mapped pack. The data stays valid as long as the PackFile is alive.
+ *
+ * Size is the number of bytes stored in the pack. Entries flagged PackFile::FlagCompressed hold BlockCompression
+ * data that expands to uncompressedSize bytes, use PackFile::ReadEntry() to get at their contents.
+ */
+struct pack_entry_t
+{
+    const char * pData;
+    size_t size;
+    size_t uncompressedSize;
+    unsigned int flags;
+};
+
+/**
+ * \brief Read only archive of many asset files in one memory mapped file (.pack).
+ *
+ * Opening thousands of loose files costs a system call or three and often a seek each. A pack is opened and mapped
+ * once, after which finding a file is a binary search and reading it is a pointer into the mapping.
+ *
+ * Layout, all values native (little endian) byte order:
+ *  - Header: magic, version, entry count, alignment and the offsets of the tables below.
+ *  - Table of contents: one entry per file (path hash, data offset, stored and uncompressed size, flags, name
+ *    offset) sorted by hash.
+ *  - Names: the normalized path of every entry, zero terminated. Used to resolve hash collisions and for listing.
+ *  - Data: file contents in the order they were added. Entries at least as large as the pack alignment start on an
+ *    alignment boundary (a page by default) so they never share a page with another entry and can be handed to
+ *    anything wanting page aligned memory; smaller entries are packed on 16 byte boundaries. Compressed entries
+ *    are stored as BlockCompression data, whose blocks decompress in parallel.
+ *
+ * Paths are normalized before hashing: separators become '/', ASCII letters are lower cased and leading "./" is
+ * dropped, so L".\\Models\\cube.model" and "models/cube.model" name the same entry.
+ *
+ * Packs can be mounted, after which BinaryBlob::LoadFromFile() and everything built on it looks in the mounted packs
+ * before the file system.
+ */
+class PackFile
+{
+public:
+    static const unsigned int Version = 2;
+    static const unsigned int DefaultAlignment = 4096;
+    static const unsigned int SmallEntryAlignment = 16;
+
+    // Entry flags.
+    static const unsigned int FlagNone = 0;
+    static const unsigned int FlagCompressed = 1;
+
+    // Map and validate a pack, throwing FileLoadException or FileFormatException.
+    explicit PackFile(const std::wstring& filepath);
+    PackFile(const PackFile&) = delete;
+    ~PackFile();
+
+    PackFile& operator =(const PackFile&) = delete;
+
+    // Look up a file by path. Returns false if the pack does not contain it.
+    bool Find(const std::wstring& path, pack_entry_t *pEntryOut) const;
+    bool Contains(const std::wstring& path) const;
+
+    unsigned int EntryCount() const { return mEntryCount; }
+    std::string EntryName(unsigned int index) const;
+    pack_entry_t Entry(unsigned int index) const;
+
+    // Copy or decompress an entry's contents into pDst, which must be exactly entry.uncompressedSize bytes.
+    // Compressed entries are decoded on up to threadCount threads (zero for all of them), and throw
+    // FileFormatException if the data is corrupt.
+    void ReadEntry(const pack_entry_t& entry, char * pDst, size_t dstSize, unsigned int threadCount = 0) const;
+
+    const std::wstring& Filepath() const { return mFile.Filepath(); }
+    size_t FileSize() const { return mFile.Size(); }
+
+    static std::string NormalizePath(const std::wstring& path);
+    static unsigned long long HashPath(const std::string& normalizedPath);
+
+    // Make a pack visible to BinaryBlob::LoadFromFile(). Later mounts are searched first, so a patch pack can
+    // override files from an earlier one.
+    static void Mount(const std::shared_ptr<const PackFile>& pack);
+    static void UnmountAll();
+
+    // Search the mounted packs. Returns the pack holding the file, which keeps the entry data alive, or null.
+    static std::shared_ptr<const PackFile> FindMounted(const std::wstring& path, pack_entry_t *pEntryOut);
+
+private:
+    friend class PackWriter;
+
+    struct toc_entry_t;
+    bool FindNormalized(const std::string& normalizedPath, pack_entry_t *pEntryOut) const;
+
+private:
+    MappedFile mFile;
+    const toc_entry_t * mpToc;
+    const char * mpNames;
+    size_t mNamesSize;
+    unsigned int mEntryCount;
+};
+
+/**
+ * \brief Builds .pack files, see PackFile.
+ */
+class PackWriter
+{
+public:
+    // Alignment must be a power of two, it is only applied to entries at least that large.
+    explicit PackWriter(unsigned int alignment = PackFile::DefaultAlignment);
+
+    // Add a file from memory (copied) or from disk. Throws SandboxException if the normalized path is already in the
+    // pack or, very unlikely, hashes to the same value as another path.
+    //  Compressed entries are only stored compressed if that saves at least MinCompressionSavings of their size.
+    void Add(const std::wstring& path, const char * pData, size_t size, bool compress = false);
+    void AddFile(const std::wstring& path, const std::wstring& sourceFilepath, bool compress = false);
+
+    size_t EntryCount() const { return mEntries.size(); }
+
+    // Bytes of file data added so far, without headers or padding.
+    unsigned long long DataSize() const { return mDataSize; }
+
+    // Bytes of file data as it will be stored, after compression.
+    unsigned long long StoredSize() const { return mStoredSize; }
+
+    // Fraction of an entry's size compression has to save for the compressed copy to be kept.
+    static const float MinCompressionSavings;
+
+    void Save(const std::wstring& filepath) const;
+
+private:
+    struct entry_t
+    {
+        std::string name;
+        unsigned long long hash;
+        unsigned long long uncompressedSize;
+        unsigned int flags;
+        std::vector<char> data;
+    };
+
+    unsigned int mAlignment;
+    std::vector<entry_t> mEntries;
+    std::unordered_set<unsigned long long> mHashes;
+    unsigned long long mDataSize;
+    unsigned long long mStoredSize;
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <cerrno>
+
+// MSVC's CRT names the type of errno values errno_t. Other compilers only provide it with C11's Annex K, if at all.
+#if !defined(_MSC_VER)
+typedef int errno_t;
+#endif
+
+// Thread local storage for plain data. VS2013 has no thread_local keyword, but its __declspec(thread) works for
+// pointers and integers.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define SANDBOX_THREAD_LOCAL __declspec(thread)
+#else
+#define SANDBOX_THREAD_LOCAL thread_local
+#endif
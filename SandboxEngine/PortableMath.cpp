@@ -0,0 +1,266 @@
+#include "stdafx.h"
+#include "PortableMath.h"
+
+#include <cmath>
+
+using namespace PortableMath;
+
+const Matrix Matrix::Identity;
+
+float Vector3::Length() const
+{
+    return std::sqrt(LengthSquared());
+}
+
+void Vector3::Normalize()
+{
+    // Zero length vectors stay zero, like XMVector3Normalize.
+    const float length = Length();
+
+    if (length > 0.0f)
+    {
+        const float inverseLength = 1.0f / length;
+        x *= inverseLength;
+        y *= inverseLength;
+        z *= inverseLength;
+    }
+}
+
+float Vector3::Distance(const Vector3& a, const Vector3& b)
+{
+    return (b - a).Length();
+}
+
+Vector3 Vector3::Transform(const Vector3& v, const Matrix& m)
+{
+    const float row[4] = { v.x, v.y, v.z, 1.0f };
+    float result[4];
+
+    TransformRow<DefaultBackend>(row, &m._11, result);
+
+    const float inverseW = 1.0f / result[3];
+    return Vector3(result[0] * inverseW, result[1] * inverseW, result[2] * inverseW);
+}
+
+Vector3 Vector3::TransformNormal(const Vector3& v, const Matrix& m)
+{
+    const float row[4] = { v.x, v.y, v.z, 0.0f };
+    float result[4];
+
+    TransformRow<DefaultBackend>(row, &m._11, result);
+    return Vector3(result[0], result[1], result[2]);
+}
+
+Matrix::Matrix()
+    : _11(1.0f), _12(0.0f), _13(0.0f), _14(0.0f),
+      _21(0.0f), _22(1.0f), _23(0.0f), _24(0.0f),
+      _31(0.0f), _32(0.0f), _33(1.0f), _34(0.0f),
+      _41(0.0f), _42(0.0f), _43(0.0f), _44(1.0f)
+{
+}
+
+Matrix::Matrix(
+    float m00, float m01, float m02, float m03,
+    float m10, float m11, float m12, float m13,
+    float m20, float m21, float m22, float m23,
+    float m30, float m31, float m32, float m33)
+    : _11(m00), _12(m01), _13(m02), _14(m03),
+      _21(m10), _22(m11), _23(m12), _24(m13),
+      _31(m20), _32(m21), _33(m22), _34(m23),
+      _41(m30), _42(m31), _43(m32), _44(m33)
+{
+}
+
+bool Matrix::operator ==(const Matrix& other) const
+{
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            if (m[row][column] != other.m[row][column])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+Matrix& Matrix::operator *=(const Matrix& other)
+{
+    MultiplyMatrix<DefaultBackend>(&_11, &other._11, &_11);
+    return *this;
+}
+
+Matrix Matrix::Transpose() const
+{
+    return Matrix(
+        _11, _21, _31, _41,
+        _12, _22, _32, _42,
+        _13, _23, _33, _43,
+        _14, _24, _34, _44);
+}
+
+Matrix Matrix::Invert() const
+{
+    // 2x2 determinants of the top two and bottom two rows, then the adjugate divided by the determinant.
+    const float s0 = _11 * _22 - _21 * _12;
+    const float s1 = _11 * _23 - _21 * _13;
+    const float s2 = _11 * _24 - _21 * _14;
+    const float s3 = _12 * _23 - _22 * _13;
+    const float s4 = _12 * _24 - _22 * _14;
+    const float s5 = _13 * _24 - _23 * _14;
+
+    const float c5 = _33 * _44 - _43 * _34;
+    const float c4 = _32 * _44 - _42 * _34;
+    const float c3 = _32 * _43 - _42 * _33;
+    const float c2 = _31 * _44 - _41 * _34;
+    const float c1 = _31 * _43 - _41 * _33;
+    const float c0 = _31 * _42 - _41 * _32;
+
+    const float inverseDeterminant = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+    return Matrix(
+        ( _22 * c5 - _23 * c4 + _24 * c3) * inverseDeterminant,
+        (-_12 * c5 + _13 * c4 - _14 * c3) * inverseDeterminant,
+        ( _42 * s5 - _43 * s4 + _44 * s3) * inverseDeterminant,
+        (-_32 * s5 + _33 * s4 - _34 * s3) * inverseDeterminant,
+
+        (-_21 * c5 + _23 * c2 - _24 * c1) * inverseDeterminant,
+        ( _11 * c5 - _13 * c2 + _14 * c1) * inverseDeterminant,
+        (-_41 * s5 + _43 * s2 - _44 * s1) * inverseDeterminant,
+        ( _31 * s5 - _33 * s2 + _34 * s1) * inverseDeterminant,
+
+        ( _21 * c4 - _22 * c2 + _24 * c0) * inverseDeterminant,
+        (-_11 * c4 + _12 * c2 - _14 * c0) * inverseDeterminant,
+        ( _41 * s4 - _42 * s2 + _44 * s0) * inverseDeterminant,
+        (-_31 * s4 + _32 * s2 - _34 * s0) * inverseDeterminant,
+
+        (-_21 * c3 + _22 * c1 - _23 * c0) * inverseDeterminant,
+        ( _11 * c3 - _12 * c1 + _13 * c0) * inverseDeterminant,
+        (-_41 * s3 + _42 * s1 - _43 * s0) * inverseDeterminant,
+        ( _31 * s3 - _32 * s1 + _33 * s0) * inverseDeterminant);
+}
+
+Matrix Matrix::CreateTranslation(const Vector3& position)
+{
+    return CreateTranslation(position.x, position.y, position.z);
+}
+
+Matrix Matrix::CreateTranslation(float x, float y, float z)
+{
+    return Matrix(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        x, y, z, 1.0f);
+}
+
+Matrix Matrix::CreateScale(float x, float y, float z)
+{
+    return Matrix(
+        x, 0.0f, 0.0f, 0.0f,
+        0.0f, y, 0.0f, 0.0f,
+        0.0f, 0.0f, z, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Matrix Matrix::CreateRotationX(float radians)
+{
+    const float s = std::sin(radians), c = std::cos(radians);
+
+    return Matrix(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, c, s, 0.0f,
+        0.0f, -s, c, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Matrix Matrix::CreateRotationY(float radians)
+{
+    const float s = std::sin(radians), c = std::cos(radians);
+
+    return Matrix(
+        c, 0.0f, -s, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        s, 0.0f, c, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Matrix Matrix::CreateRotationZ(float radians)
+{
+    const float s = std::sin(radians), c = std::cos(radians);
+
+    return Matrix(
+        c, s, 0.0f, 0.0f,
+        -s, c, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Matrix Matrix::CreateFromYawPitchRoll(float yaw, float pitch, float roll)
+{
+    return CreateRotationZ(roll) * CreateRotationX(pitch) * CreateRotationY(yaw);
+}
+
+void Plane::Normalize()
+{
+    const float length = std::sqrt(x * x + y * y + z * z);
+
+    if (length > 0.0f)
+    {
+        const float inverseLength = 1.0f / length;
+        x *= inverseLength;
+        y *= inverseLength;
+        z *= inverseLength;
+        w *= inverseLength;
+    }
+}
+
+Matrix PortableMath::XMMatrixIdentity()
+{
+    return Matrix();
+}
+
+Matrix PortableMath::XMMatrixLookAtLH(const Vector3& eye, const Vector3& focus, const Vector3& up)
+{
+    Vector3 zAxis = focus - eye;
+    zAxis.Normalize();
+
+    Vector3 xAxis = up.Cross(zAxis);
+    xAxis.Normalize();
+
+    const Vector3 yAxis = zAxis.Cross(xAxis);
+    const Vector3 negativeEye = -eye;
+
+    return Matrix(
+        xAxis.x, yAxis.x, zAxis.x, 0.0f,
+        xAxis.y, yAxis.y, zAxis.y, 0.0f,
+        xAxis.z, yAxis.z, zAxis.z, 0.0f,
+        xAxis.Dot(negativeEye), yAxis.Dot(negativeEye), zAxis.Dot(negativeEye), 1.0f);
+}
+
+Matrix PortableMath::XMMatrixPerspectiveFovLH(float fieldOfViewY, float aspectRatio, float nearZ, float farZ)
+{
+    const float height = std::cos(0.5f * fieldOfViewY) / std::sin(0.5f * fieldOfViewY);
+    const float width = height / aspectRatio;
+    const float range = farZ / (farZ - nearZ);
+
+    return Matrix(
+        width, 0.0f, 0.0f, 0.0f,
+        0.0f, height, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 1.0f,
+        0.0f, 0.0f, -range * nearZ, 0.0f);
+}
+
+Matrix PortableMath::XMMatrixOrthographicLH(float width, float height, float nearZ, float farZ)
+{
+    const float range = 1.0f / (farZ - nearZ);
+
+    return Matrix(
+        2.0f / width, 0.0f, 0.0f, 0.0f,
+        0.0f, 2.0f / height, 0.0f, 0.0f,
+        0.0f, 0.0f, range, 0.0f,
+        0.0f, 0.0f, -range * nearZ, 1.0f);
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include "CpuFeatures.h"     // SANDBOX_SSE2
+
+#if defined(__ARM_NEON) || defined(_M_ARM) || defined(_M_ARM64)
+#define SANDBOX_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * \brief Portable subset of DirectX::SimpleMath for building the engine without DirectXMath.
+ *
+ * Provides the vector, matrix and plane types the engine's CPU side code uses with the same layout, conventions
+ * (row vectors, left handed) and results as SimpleMath, so the same code and tests run on Linux with GCC or Clang.
+ * Include MathTypes.h rather than this header: it picks SimpleMath on Windows and maps these types into the
+ * DirectX::SimpleMath namespace everywhere else.
+ *
+ * Matrix products and transforms go through a four wide backend: SSE2 on x86, NEON on ARM and plain floats
+ * otherwise, or when SANDBOX_SCALAR_MATH is defined. The backends are also usable directly, see
+ * MultiplyMatrix<Backend>() and TransformRow<Backend>(), which is how the benchmarks compare them.
+ */
+namespace PortableMath
+{
+    struct Matrix;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // Four wide backends
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    struct ScalarBackend
+    {
+        struct reg_t { float v[4]; };
+
+        static reg_t Load(const float * p) { reg_t r = { { p[0], p[1], p[2], p[3] } }; return r; }
+        static void Store(float * p, const reg_t& r) { p[0] = r.v[0]; p[1] = r.v[1]; p[2] = r.v[2]; p[3] = r.v[3]; }
+        static reg_t Splat(float s) { reg_t r = { { s, s, s, s } }; return r; }
+
+        static reg_t Add(const reg_t& a, const reg_t& b)
+        {
+            reg_t r = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+            return r;
+        }
+
+        static reg_t Mul(const reg_t& a, const reg_t& b)
+        {
+            reg_t r = { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+            return r;
+        }
+    };
+
+#ifdef SANDBOX_SSE2
+    struct Sse2Backend
+    {
+        typedef __m128 reg_t;
+
+        static reg_t Load(const float * p) { return _mm_loadu_ps(p); }
+        static void Store(float * p, reg_t r) { _mm_storeu_ps(p, r); }
+        static reg_t Splat(float s) { return _mm_set1_ps(s); }
+        static reg_t Add(reg_t a, reg_t b) { return _mm_add_ps(a, b); }
+        static reg_t Mul(reg_t a, reg_t b) { return _mm_mul_ps(a, b); }
+    };
+#endif
+
+#ifdef SANDBOX_NEON
+    struct NeonBackend
+    {
+        typedef float32x4_t reg_t;
+
+        static reg_t Load(const float * p) { return vld1q_f32(p); }
+        static void Store(float * p, reg_t r) { vst1q_f32(p, r); }
+        static reg_t Splat(float s) { return vdupq_n_f32(s); }
+        static reg_t Add(reg_t a, reg_t b) { return vaddq_f32(a, b); }
+        static reg_t Mul(reg_t a, reg_t b) { return vmulq_f32(a, b); }
+    };
+#endif
+
+#if defined(SANDBOX_SCALAR_MATH)
+    typedef ScalarBackend DefaultBackend;
+#elif defined(SANDBOX_SSE2)
+    typedef Sse2Backend DefaultBackend;
+#elif defined(SANDBOX_NEON)
+    typedef NeonBackend DefaultBackend;
+#else
+    typedef ScalarBackend DefaultBackend;
+#endif
+
+    // out = row * m for a row vector of four floats. Out may be row.
+    template<typename Backend>
+    inline void TransformRow(const float row[4], const float m[16], float out[4])
+    {
+        typename Backend::reg_t r = Backend::Mul(Backend::Splat(row[0]), Backend::Load(m));
+        r = Backend::Add(r, Backend::Mul(Backend::Splat(row[1]), Backend::Load(m + 4)));
+        r = Backend::Add(r, Backend::Mul(Backend::Splat(row[2]), Backend::Load(m + 8)));
+        r = Backend::Add(r, Backend::Mul(Backend::Splat(row[3]), Backend::Load(m + 12)));
+
+        Backend::Store(out, r);
+    }
+
+    // out = a * b for 4x4 row major matrices. Out may be a or b.
+    template<typename Backend>
+    inline void MultiplyMatrix(const float a[16], const float b[16], float out[16])
+    {
+        float result[16];
+
+        TransformRow<Backend>(a, b, result);
+        TransformRow<Backend>(a + 4, b, result + 4);
+        TransformRow<Backend>(a + 8, b, result + 8);
+        TransformRow<Backend>(a + 12, b, result + 12);
+
+        for (int k = 0; k < 16; ++k)
+        {
+            out[k] = result[k];
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // Types
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    struct Vector2
+    {
+        Vector2() : x(0.0f), y(0.0f) { }
+        Vector2(float ix, float iy) : x(ix), y(iy) { }
+
+        bool operator ==(const Vector2& v) const { return x == v.x && y == v.y; }
+        bool operator !=(const Vector2& v) const { return !(*this == v); }
+
+        float x, y;
+    };
+
+    struct Vector3
+    {
+        Vector3() : x(0.0f), y(0.0f), z(0.0f) { }
+        Vector3(float ix, float iy, float iz) : x(ix), y(iy), z(iz) { }
+
+        bool operator ==(const Vector3& v) const { return x == v.x && y == v.y && z == v.z; }
+        bool operator !=(const Vector3& v) const { return !(*this == v); }
+
+        Vector3& operator +=(const Vector3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+        Vector3& operator -=(const Vector3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+        Vector3& operator *=(float s) { x *= s; y *= s; z *= s; return *this; }
+        Vector3 operator -() const { return Vector3(-x, -y, -z); }
+
+        float Length() const;
+        float LengthSquared() const { return x * x + y * y + z * z; }
+        float Dot(const Vector3& v) const { return x * v.x + y * v.y + z * v.z; }
+        Vector3 Cross(const Vector3& v) const
+        {
+            return Vector3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
+        }
+        void Normalize();
+
+        static float Distance(const Vector3& a, const Vector3& b);
+
+        // Point transform, divided by the resulting w like XMVector3TransformCoord.
+        static Vector3 Transform(const Vector3& v, const Matrix& m);
+
+        // Direction transform through the upper 3x3.
+        static Vector3 TransformNormal(const Vector3& v, const Matrix& m);
+
+        float x, y, z;
+    };
+
+    inline Vector3 operator +(const Vector3& a, const Vector3& b) { return Vector3(a.x + b.x, a.y + b.y, a.z + b.z); }
+    inline Vector3 operator -(const Vector3& a, const Vector3& b) { return Vector3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    inline Vector3 operator *(const Vector3& v, float s) { return Vector3(v.x * s, v.y * s, v.z * s); }
+    inline Vector3 operator *(float s, const Vector3& v) { return Vector3(v.x * s, v.y * s, v.z * s); }
+
+    struct Vector4
+    {
+        Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) { }
+        Vector4(float ix, float iy, float iz, float iw) : x(ix), y(iy), z(iz), w(iw) { }
+
+        bool operator ==(const Vector4& v) const { return x == v.x && y == v.y && z == v.z && w == v.w; }
+        bool operator !=(const Vector4& v) const { return !(*this == v); }
+
+        float x, y, z, w;
+    };
+
+    struct Matrix
+    {
+        // Identity, like SimpleMath.
+        Matrix();
+        Matrix(
+            float m00, float m01, float m02, float m03,
+            float m10, float m11, float m12, float m13,
+            float m20, float m21, float m22, float m23,
+            float m30, float m31, float m32, float m33);
+
+        bool operator ==(const Matrix& other) const;
+        bool operator !=(const Matrix& other) const { return !(*this == other); }
+
+        Matrix& operator *=(const Matrix& other);
+
+        Vector3 Translation() const { return Vector3(_41, _42, _43); }
+        Matrix Transpose() const;
+
+        // Inverse by cofactors. Singular matrices give non finite values, as in DirectXMath.
+        Matrix Invert() const;
+
+        static Matrix CreateTranslation(const Vector3& position);
+        static Matrix CreateTranslation(float x, float y, float z);
+        static Matrix CreateScale(float x, float y, float z);
+        static Matrix CreateRotationX(float radians);
+        static Matrix CreateRotationY(float radians);
+        static Matrix CreateRotationZ(float radians);
+
+        // Roll about z, then pitch about x, then yaw about y.
+        static Matrix CreateFromYawPitchRoll(float yaw, float pitch, float roll);
+
+        static const Matrix Identity;
+
+        union
+        {
+            struct
+            {
+                float _11, _12, _13, _14;
+                float _21, _22, _23, _24;
+                float _31, _32, _33, _34;
+                float _41, _42, _43, _44;
+            };
+
+            float m[4][4];
+        };
+    };
+
+    inline Matrix operator *(const Matrix& a, const Matrix& b)
+    {
+        Matrix result;
+        MultiplyMatrix<DefaultBackend>(&a._11, &b._11, &result._11);
+        return result;
+    }
+
+    struct Plane
+    {
+        // The y = 0 plane, like SimpleMath.
+        Plane() : x(0.0f), y(1.0f), z(0.0f), w(0.0f) { }
+        Plane(float ix, float iy, float iz, float iw) : x(ix), y(iy), z(iz), w(iw) { }
+
+        bool operator ==(const Plane& p) const { return x == p.x && y == p.y && z == p.z && w == p.w; }
+        bool operator !=(const Plane& p) const { return !(*this == p); }
+
+        Vector3 Normal() const { return Vector3(x, y, z); }
+
+        // Scale so the normal has unit length.
+        void Normalize();
+
+        // Signed distance of the point from the plane, once normalized.
+        float DotCoordinate(const Vector3& position) const
+        {
+            return x * position.x + y * position.y + z * position.z + w;
+        }
+
+        float x, y, z, w;
+    };
+
+    // The DirectXMath matrix builders the engine uses, with the same conventions.
+    Matrix XMMatrixIdentity();
+    Matrix XMMatrixLookAtLH(const Vector3& eye, const Vector3& focus, const Vector3& up);
+    Matrix XMMatrixPerspectiveFovLH(float fieldOfViewY, float aspectRatio, float nearZ, float farZ);
+    Matrix XMMatrixOrthographicLH(float width, float height, float nearZ, float farZ);
+}
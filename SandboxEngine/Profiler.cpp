@@ -0,0 +1,451 @@
+#include "stdafx.h"
+#include "Profiler.h"
+#include "Platform.h"       // SANDBOX_THREAD_LOCAL
+#include "Stopwatch.h"
+#include "TextFormat.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#   include <intrin.h>
+#   define SANDBOX_PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define SANDBOX_PROFILER_RDTSC 1
+#else
+#   include <chrono>
+#endif
+
+namespace
+{
+    const unsigned long long EventMask = Profiler::EventsPerThread - 1;
+    static_assert((Profiler::EventsPerThread & (Profiler::EventsPerThread - 1)) == 0, "Must be a power of two");
+
+    // The time stamp counter ticks at a fixed rate on every CPU this runs on, but the rate is not reported. It is
+    // measured against Stopwatch over at least this long.
+    const double MinCalibrationSeconds = 0.01;
+
+    // Timestamp shifted up one bit, with the low bit set for end events. Begin events carry the scope's name.
+    struct event_slot_t
+    {
+        std::atomic<const char *> pName;
+        std::atomic<unsigned long long> stamp;
+    };
+
+    // Written only by its thread. A reader copies the slots and then throws away any that the writer may have
+    // claimed for a newer event while it was copying.
+    struct thread_buffer_t
+    {
+        explicit thread_buffer_t(unsigned int index)
+            : index(index),
+              pName(nullptr),
+              claimed(0),
+              written(0),
+              slots(new event_slot_t[Profiler::EventsPerThread])
+        {
+        }
+
+        unsigned int index;
+        std::atomic<const char *> pName;
+        std::atomic<unsigned long long> claimed;
+        std::atomic<unsigned long long> written;
+        std::unique_ptr<event_slot_t[]> slots;
+    };
+
+    struct event_t
+    {
+        const char * pName;
+        unsigned long long stamp;
+    };
+
+    struct scope_t
+    {
+        const char * pName;
+        unsigned long long begin;
+        unsigned long long end;         // Zero while the scope has not ended.
+        unsigned int depth;
+    };
+
+    struct tree_node_t
+    {
+        const char * pName;
+        unsigned int calls;
+        unsigned long long totalTicks;
+        unsigned long long childTicks;
+        std::vector<size_t> children;
+    };
+
+    unsigned long long ReadTicks()
+    {
+#ifdef SANDBOX_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Trace times are relative to this, and it anchors the tick rate measurement.
+    const unsigned long long GStartTicks = ReadTicks();
+    const double GStartSeconds = Stopwatch::Now();
+
+    std::atomic<bool> GEnabled;
+    std::atomic<unsigned long long> GFrameBegin;
+    std::atomic<unsigned long long> GLastFrameBegin;
+    std::atomic<unsigned long long> GLastFrameEnd;
+
+    // Buffers outlive their threads so a trace still has the events of threads that have exited.
+    std::mutex GBuffersMutex;
+    std::vector<std::unique_ptr<thread_buffer_t>> GBuffers;
+    SANDBOX_THREAD_LOCAL thread_buffer_t * GpThreadBuffer = nullptr;
+
+    thread_buffer_t& ThisThreadBuffer()
+    {
+        if (GpThreadBuffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(GBuffersMutex);
+
+            GBuffers.push_back(std::unique_ptr<thread_buffer_t>(
+                new thread_buffer_t(static_cast<unsigned int>(GBuffers.size()))));
+            GpThreadBuffer = GBuffers.back().get();
+        }
+
+        return *GpThreadBuffer;
+    }
+
+    void Record(const char * pName, unsigned long long stamp)
+    {
+        thread_buffer_t& buffer = ThisThreadBuffer();
+        const unsigned long long next = buffer.written.load(std::memory_order_relaxed) + 1;
+        event_slot_t& slot = buffer.slots[(next - 1) & EventMask];
+
+        buffer.claimed.store(next, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.pName.store(pName, std::memory_order_relaxed);
+        slot.stamp.store(stamp, std::memory_order_relaxed);
+
+        buffer.written.store(next, std::memory_order_release);
+    }
+
+    double SecondsPerTick()
+    {
+#ifdef SANDBOX_PROFILER_RDTSC
+        while (Stopwatch::Now() - GStartSeconds < MinCalibrationSeconds)
+        {
+        }
+
+        const unsigned long long ticks = ReadTicks();
+        const double seconds = Stopwatch::Now();
+
+        return (seconds - GStartSeconds) / static_cast<double>(ticks - GStartTicks);
+#else
+        return 1.0e-9;
+#endif
+    }
+
+    void CopyEvents(const thread_buffer_t& buffer, std::vector<event_t> * pEvents)
+    {
+        const unsigned long long written = buffer.written.load(std::memory_order_acquire);
+        const unsigned long long first = written > Profiler::EventsPerThread ? written - Profiler::EventsPerThread : 0;
+
+        pEvents->clear();
+        pEvents->reserve(static_cast<size_t>(written - first));
+
+        for (unsigned long long i = first; i < written; ++i)
+        {
+            const event_slot_t& slot = buffer.slots[i & EventMask];
+            event_t event = { slot.pName.load(std::memory_order_relaxed), slot.stamp.load(std::memory_order_relaxed) };
+
+            pEvents->push_back(event);
+        }
+
+        // Slots the writer claimed since may hold a newer event than the one wanted.
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const unsigned long long claimed = buffer.claimed.load(std::memory_order_relaxed);
+        const unsigned long long firstValid =
+            claimed > Profiler::EventsPerThread ? claimed - Profiler::EventsPerThread : 0;
+
+        if (firstValid > first)
+        {
+            const size_t overwritten = static_cast<size_t>(std::min(firstValid, written) - first);
+            pEvents->erase(pEvents->begin(), pEvents->begin() + overwritten);
+        }
+    }
+
+    // Pair begin and end events into scopes, in the order they began. End events whose begin was overwritten are
+    // dropped, scopes still running keep an end of zero.
+    void MatchScopes(const std::vector<event_t>& events, std::vector<scope_t> * pScopes)
+    {
+        std::vector<size_t> open;
+        pScopes->clear();
+
+        for (const event_t& event : events)
+        {
+            const unsigned long long ticks = event.stamp >> 1;
+
+            if ((event.stamp & 1) == 0)
+            {
+                scope_t scope = { event.pName, ticks, 0, static_cast<unsigned int>(open.size()) };
+
+                open.push_back(pScopes->size());
+                pScopes->push_back(scope);
+            }
+            else if (!open.empty())
+            {
+                (*pScopes)[open.back()].end = ticks;
+                open.pop_back();
+            }
+        }
+    }
+
+    std::vector<thread_buffer_t *> AllBuffers()
+    {
+        std::lock_guard<std::mutex> lock(GBuffersMutex);
+        std::vector<thread_buffer_t *> buffers;
+
+        for (const std::unique_ptr<thread_buffer_t>& buffer : GBuffers)
+        {
+            buffers.push_back(buffer.get());
+        }
+
+        return buffers;
+    }
+
+    // Merge a thread's scopes that began in [begin, end) into a call tree. Scopes whose parent began outside the
+    // window become roots.
+    void BuildTree(
+        const std::vector<scope_t>& scopes,
+        unsigned long long begin,
+        unsigned long long end,
+        std::vector<tree_node_t> * pNodes,
+        std::vector<size_t> * pRoots)
+    {
+        const size_t NoNode = static_cast<size_t>(-1);
+        std::vector<size_t> nodeAtDepth;
+
+        for (const scope_t& scope : scopes)
+        {
+            nodeAtDepth.resize(scope.depth, NoNode);
+
+            if (scope.end == 0 || scope.begin < begin || scope.begin >= end)
+            {
+                nodeAtDepth.push_back(NoNode);
+                continue;
+            }
+
+            size_t parent = NoNode;
+
+            for (size_t d = nodeAtDepth.size(); d > 0 && parent == NoNode; --d)
+            {
+                parent = nodeAtDepth[d - 1];
+            }
+
+            std::vector<size_t>& siblings = (parent == NoNode) ? *pRoots : (*pNodes)[parent].children;
+            size_t node = NoNode;
+
+            for (size_t sibling : siblings)
+            {
+                if ((*pNodes)[sibling].pName == scope.pName)
+                {
+                    node = sibling;
+                    break;
+                }
+            }
+
+            if (node == NoNode)
+            {
+                tree_node_t created = { scope.pName, 0, 0, 0, std::vector<size_t>() };
+
+                node = pNodes->size();
+                siblings.push_back(node);
+                pNodes->push_back(created);
+            }
+
+            const unsigned long long ticks = scope.end - scope.begin;
+
+            (*pNodes)[node].calls++;
+            (*pNodes)[node].totalTicks += ticks;
+
+            if (parent != NoNode)
+            {
+                (*pNodes)[parent].childTicks += ticks;
+            }
+
+            nodeAtDepth.push_back(node);
+        }
+    }
+
+    void AppendNodes(
+        const std::vector<tree_node_t>& nodes,
+        const std::vector<size_t>& siblings,
+        unsigned int threadIndex,
+        unsigned int depth,
+        double millisecondsPerTick,
+        std::vector<profile_node_t> * pOut)
+    {
+        for (size_t index : siblings)
+        {
+            const tree_node_t& node = nodes[index];
+            const unsigned long long selfTicks =
+                node.totalTicks > node.childTicks ? node.totalTicks - node.childTicks : 0;
+
+            profile_node_t out =
+            {
+                node.pName,
+                threadIndex,
+                depth,
+                node.calls,
+                static_cast<double>(node.totalTicks) * millisecondsPerTick,
+                static_cast<double>(selfTicks) * millisecondsPerTick
+            };
+
+            pOut->push_back(out);
+            AppendNodes(nodes, node.children, threadIndex, depth + 1, millisecondsPerTick, pOut);
+        }
+    }
+
+    void AppendJsonString(FormatBuffer * pJson, const char * pText)
+    {
+        *pJson << '"';
+
+        for (const char * p = pText; *p != 0; ++p)
+        {
+            if (*p == '"' || *p == '\\')
+            {
+                *pJson << '\\' << *p;
+            }
+            else if (static_cast<unsigned char>(*p) < 0x20)
+            {
+                *pJson << "\\u" << TextFormat::Hex(static_cast<unsigned char>(*p), 4);
+            }
+            else
+            {
+                *pJson << *p;
+            }
+        }
+
+        *pJson << '"';
+    }
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+    GEnabled.store(enabled);
+}
+
+bool Profiler::IsEnabled()
+{
+    return GEnabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char * pName)
+{
+    ThisThreadBuffer().pName.store(pName);
+}
+
+unsigned long long Profiler::Ticks()
+{
+    return ReadTicks();
+}
+
+void Profiler::BeginEvent(const char * pName)
+{
+    Record(pName, ReadTicks() << 1);
+}
+
+void Profiler::EndEvent()
+{
+    Record(nullptr, (ReadTicks() << 1) | 1);
+}
+
+void Profiler::EndFrame()
+{
+    const unsigned long long now = ReadTicks();
+
+    GLastFrameBegin.store(GFrameBegin.load());
+    GLastFrameEnd.store(now);
+    GFrameBegin.store(now);
+}
+
+std::vector<profile_node_t> Profiler::LastFrame()
+{
+    const unsigned long long begin = GLastFrameBegin.load();
+    const unsigned long long end = GLastFrameEnd.load();
+    const double millisecondsPerTick = SecondsPerTick() * 1000.0;
+
+    std::vector<profile_node_t> frame;
+    std::vector<event_t> events;
+    std::vector<scope_t> scopes;
+
+    for (thread_buffer_t * pBuffer : AllBuffers())
+    {
+        CopyEvents(*pBuffer, &events);
+        MatchScopes(events, &scopes);
+
+        std::vector<tree_node_t> nodes;
+        std::vector<size_t> roots;
+
+        BuildTree(scopes, begin, end, &nodes, &roots);
+        AppendNodes(nodes, roots, pBuffer->index, 0, millisecondsPerTick, &frame);
+    }
+
+    return frame;
+}
+
+std::string Profiler::ToChromeTrace()
+{
+    const double microsecondsPerTick = SecondsPerTick() * 1.0e6;
+
+    FormatBuffer json;
+    json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    std::vector<event_t> events;
+    std::vector<scope_t> scopes;
+    bool first = true;
+
+    for (thread_buffer_t * pBuffer : AllBuffers())
+    {
+        const char * pThreadName = pBuffer->pName.load();
+
+        if (pThreadName != nullptr)
+        {
+            json << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+                 << pBuffer->index << ", \"args\": {\"name\": ";
+            AppendJsonString(&json, pThreadName);
+            json << "}}";
+
+            first = false;
+        }
+
+        CopyEvents(*pBuffer, &events);
+        MatchScopes(events, &scopes);
+
+        for (const scope_t& scope : scopes)
+        {
+            if (scope.end == 0 || scope.begin < GStartTicks)
+            {
+                continue;
+            }
+
+            const double start = static_cast<double>(scope.begin - GStartTicks) * microsecondsPerTick;
+            const double duration = static_cast<double>(scope.end - scope.begin) * microsecondsPerTick;
+
+            json << (first ? "\n" : ",\n") << "{\"name\": ";
+            AppendJsonString(&json, scope.pName);
+            json
+                << ", \"cat\": \"cpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << pBuffer->index
+                << ", \"ts\": " << TextFormat::Fixed(start, 3)
+                << ", \"dur\": " << TextFormat::Fixed(duration, 3) << "}";
+
+            first = false;
+        }
+    }
+
+    json << "\n]}\n";
+    return json.ToString();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * \brief One scope of a frame's call hierarchy, see Profiler::LastFrame().
+ *
+ * Calls to the same scope from the same parent are merged into one node.
+ */
+struct profile_node_t
+{
+    const char * pName;
+    unsigned int threadIndex;
+    unsigned int depth;                 // Zero for scopes with no parent in the frame.
+    unsigned int calls;
+    double totalMilliseconds;
+    double selfMilliseconds;            // Total minus the time spent in child scopes.
+};
+
+/**
+ * \brief Low overhead CPU profiler built from scoped markers.
+ *
+ * PROFILE_SCOPE("Name") records a begin event when it runs and an end event when the scope exits. Events go to a
+ * ring buffer owned by the calling thread, so recording never locks. An event is a name pointer and a timestamp read
+ * with rdtsc on x86 and x64, or steady_clock elsewhere, converted to seconds against Stopwatch when read back. Names
+ * must be string literals or otherwise outlive the profiler.
+ *
+ * Recording is off until SetEnabled(true), and a disabled scope only reads one flag. Defining SANDBOX_NO_PROFILER
+ * compiles every PROFILE_SCOPE out.
+ *
+ * The main loop calls EndFrame() once per frame. LastFrame() aggregates the scopes that began during the last
+ * completed frame into a hierarchy, and ToChromeTrace() writes everything still in the ring buffers in the Chrome
+ * trace event format for chrome://tracing or Perfetto. Both read other threads' buffers while they are recording,
+ * events overwritten during the read are skipped.
+ */
+namespace Profiler
+{
+    // Events kept per thread. Older events are overwritten.
+    const size_t EventsPerThread = 64 * 1024;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+
+    // Name shown for the calling thread in traces. Must outlive the profiler.
+    void SetThreadName(const char * pName);
+
+    // Raw timestamp as recorded in events.
+    unsigned long long Ticks();
+
+    void BeginEvent(const char * pName);
+    void EndEvent();
+
+    // Close the current frame. Call from the main loop, once per frame.
+    void EndFrame();
+
+    // Scopes that began during the last completed frame, every thread, in depth first order.
+    std::vector<profile_node_t> LastFrame();
+
+    // Every buffered event as a Chrome trace_event JSON document.
+    std::string ToChromeTrace();
+}
+
+/**
+ * \brief Records a begin event now and the matching end event when the scope exits. Use through PROFILE_SCOPE.
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char * pName)
+        : mActive(Profiler::IsEnabled())
+    {
+        if (mActive)
+        {
+            Profiler::BeginEvent(pName);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+
+    ~ProfileScope()
+    {
+        if (mActive)
+        {
+            Profiler::EndEvent();
+        }
+    }
+
+    ProfileScope& operator =(const ProfileScope&) = delete;
+
+private:
+    bool mActive;           // Recording was on when the scope began, so it needs an end event.
+};
+
+#define SANDBOX_PROFILE_JOIN2(a, b) a##b
+#define SANDBOX_PROFILE_JOIN(a, b) SANDBOX_PROFILE_JOIN2(a, b)
+
+#ifdef SANDBOX_NO_PROFILER
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_SCOPE(name) ProfileScope SANDBOX_PROFILE_JOIN(profileScope, __LINE__)(name)
+#endif
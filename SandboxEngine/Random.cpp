@@ -0,0 +1,424 @@
+#include "stdafx.h"
+#include "Random.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+
+namespace
+{
+    // Polynomials for advancing the generator 2^128 and 2^192 steps, from the xoshiro256** reference code.
+    const unsigned long long JumpPolynomial[4] =
+    {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+
+    const unsigned long long LongJumpPolynomial[4] =
+    {
+        0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull
+    };
+
+    // Batches interleave four generators, each step giving one 64 bit value per lane or eight 32 bit values. The
+    // lane count is fixed rather than following the vector width so every code path produces the same values.
+    const size_t Lanes = 4;
+    const size_t ValuesPerStep = Lanes * 2;
+
+    // Values generated at a time before being converted into the caller's range, small enough to stay in L1.
+    const size_t ChunkValues = 1024;
+
+    // Interleaved generator state, word major so each word of all lanes can be loaded at once.
+    struct lane_states_t
+    {
+        unsigned long long s[4][Lanes];
+    };
+
+#ifdef SANDBOX_AVX2
+    const bool GHasAvx2 = CpuFeatures::DetectAvx2();
+#endif
+
+    unsigned long long SplitMix64(unsigned long long *pState)
+    {
+        unsigned long long z = (*pState += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    inline unsigned long long RotateLeft(unsigned long long x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+#ifndef SANDBOX_SSE2
+    void GenerateScalar(lane_states_t *pLanes, unsigned int * pOut, size_t steps)
+    {
+        unsigned long long (&s)[4][Lanes] = pLanes->s;
+
+        for (size_t step = 0; step < steps; ++step)
+        {
+            for (size_t lane = 0; lane < Lanes; ++lane)
+            {
+                const unsigned long long result = RotateLeft(s[1][lane] * 5, 7) * 9;
+                const unsigned long long t = s[1][lane] << 17;
+
+                s[2][lane] ^= s[0][lane];
+                s[3][lane] ^= s[1][lane];
+                s[1][lane] ^= s[2][lane];
+                s[0][lane] ^= s[3][lane];
+                s[2][lane] ^= t;
+                s[3][lane] = RotateLeft(s[3][lane], 45);
+
+                pOut[lane * 2] = static_cast<unsigned int>(result);
+                pOut[lane * 2 + 1] = static_cast<unsigned int>(result >> 32);
+            }
+
+            pOut += ValuesPerStep;
+        }
+    }
+#endif
+
+    // Scale x into [0, range) by taking the high half of the 64 bit product.
+    inline unsigned int ScaleToRange(unsigned int x, unsigned int range)
+    {
+        return static_cast<unsigned int>((static_cast<unsigned long long>(x) * range) >> 32);
+    }
+
+    inline float ScaleToUnit(unsigned int x)
+    {
+        return static_cast<float>(static_cast<int>(x >> 8)) * (1.0f / 16777216.0f);
+    }
+
+#ifdef SANDBOX_SSE2
+    inline __m128i RotateLeft(__m128i x, int k)
+    {
+        return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+    }
+
+    // Two lanes of xoshiro256**, the multiplies by 5 and 9 done as shifts and adds since SSE2 has no 64 bit multiply.
+    inline __m128i NextLanes(__m128i& s0, __m128i& s1, __m128i& s2, __m128i& s3)
+    {
+        const __m128i times5 = _mm_add_epi64(_mm_slli_epi64(s1, 2), s1);
+        const __m128i rotated = RotateLeft(times5, 7);
+        const __m128i result = _mm_add_epi64(_mm_slli_epi64(rotated, 3), rotated);
+        const __m128i t = _mm_slli_epi64(s1, 17);
+
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = RotateLeft(s3, 45);
+
+        return result;
+    }
+
+    void GenerateSse2(lane_states_t *pLanes, unsigned int * pOut, size_t steps)
+    {
+        __m128i * pWords = reinterpret_cast<__m128i *>(pLanes->s);
+
+        // Lanes 0 and 1 in the a registers, 2 and 3 in the b registers.
+        __m128i s0a = _mm_loadu_si128(pWords + 0), s0b = _mm_loadu_si128(pWords + 1);
+        __m128i s1a = _mm_loadu_si128(pWords + 2), s1b = _mm_loadu_si128(pWords + 3);
+        __m128i s2a = _mm_loadu_si128(pWords + 4), s2b = _mm_loadu_si128(pWords + 5);
+        __m128i s3a = _mm_loadu_si128(pWords + 6), s3b = _mm_loadu_si128(pWords + 7);
+
+        for (size_t step = 0; step < steps; ++step)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut), NextLanes(s0a, s1a, s2a, s3a));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pOut + 4), NextLanes(s0b, s1b, s2b, s3b));
+            pOut += ValuesPerStep;
+        }
+
+        _mm_storeu_si128(pWords + 0, s0a); _mm_storeu_si128(pWords + 1, s0b);
+        _mm_storeu_si128(pWords + 2, s1a); _mm_storeu_si128(pWords + 3, s1b);
+        _mm_storeu_si128(pWords + 4, s2a); _mm_storeu_si128(pWords + 5, s2b);
+        _mm_storeu_si128(pWords + 6, s3a); _mm_storeu_si128(pWords + 7, s3b);
+    }
+
+    // High halves of the 32 x 32 bit products of every lane, which SSE2 only multiplies two at a time.
+    inline __m128i MultiplyHigh(__m128i x, __m128i range)
+    {
+        const __m128i even = _mm_mul_epu32(x, range);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), range);
+        const __m128i highMask = _mm_set_epi32(-1, 0, -1, 0);
+
+        return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, highMask));
+    }
+#endif
+
+#ifdef SANDBOX_AVX2
+    SANDBOX_TARGET_AVX2 inline __m256i RotateLeftAvx2(__m256i x, int k)
+    {
+        return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    }
+
+    SANDBOX_TARGET_AVX2 void GenerateAvx2(lane_states_t *pLanes, unsigned int * pOut, size_t steps)
+    {
+        __m256i * pWords = reinterpret_cast<__m256i *>(pLanes->s);
+
+        __m256i s0 = _mm256_loadu_si256(pWords + 0);
+        __m256i s1 = _mm256_loadu_si256(pWords + 1);
+        __m256i s2 = _mm256_loadu_si256(pWords + 2);
+        __m256i s3 = _mm256_loadu_si256(pWords + 3);
+
+        for (size_t step = 0; step < steps; ++step)
+        {
+            const __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            const __m256i rotated = RotateLeftAvx2(times5, 7);
+            const __m256i result = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = RotateLeftAvx2(s3, 45);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(pOut), result);
+            pOut += ValuesPerStep;
+        }
+
+        _mm256_storeu_si256(pWords + 0, s0);
+        _mm256_storeu_si256(pWords + 1, s1);
+        _mm256_storeu_si256(pWords + 2, s2);
+        _mm256_storeu_si256(pWords + 3, s3);
+    }
+#endif
+
+    // Fill pOut with steps * ValuesPerStep raw values.
+    void Generate(lane_states_t *pLanes, unsigned int * pOut, size_t steps)
+    {
+#ifdef SANDBOX_AVX2
+        if (GHasAvx2)
+        {
+            GenerateAvx2(pLanes, pOut, steps);
+            return;
+        }
+#endif
+
+#ifdef SANDBOX_SSE2
+        GenerateSse2(pLanes, pOut, steps);
+#else
+        GenerateScalar(pLanes, pOut, steps);
+#endif
+    }
+
+    // Run the batch generator over count outputs a chunk at a time, handing each chunk of raw values to convert.
+    template<typename T, typename Convert>
+    void GenerateBatch(Random *pRandom, T * pOut, size_t count, Convert convert)
+    {
+        // Seed the lanes from the caller's generator, expanding each seed the same way Random::Seed() does.
+        lane_states_t lanes;
+
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            unsigned long long seed = pRandom->NextUInt64();
+
+            for (size_t word = 0; word < 4; ++word)
+            {
+                lanes.s[word][lane] = SplitMix64(&seed);
+            }
+        }
+
+        unsigned int chunk[ChunkValues];
+
+        for (size_t offset = 0; offset < count; offset += ChunkValues)
+        {
+            const size_t values = (count - offset < ChunkValues) ? count - offset : ChunkValues;
+
+            Generate(&lanes, chunk, (values + ValuesPerStep - 1) / ValuesPerStep);
+            convert(chunk, pOut + offset, values);
+        }
+    }
+}
+
+Random::Random(unsigned long long seed)
+{
+    Seed(seed);
+}
+
+Random Random::ForStream(unsigned long long seed, unsigned int streamIndex)
+{
+    Random random(seed);
+
+    for (unsigned int i = 0; i < streamIndex; ++i)
+    {
+        random.Jump();
+    }
+
+    return random;
+}
+
+void Random::Seed(unsigned long long seed)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        mState[i] = SplitMix64(&seed);
+    }
+}
+
+unsigned long long Random::NextUInt64()
+{
+    const unsigned long long result = RotateLeft(mState[1] * 5, 7) * 9;
+    const unsigned long long t = mState[1] << 17;
+
+    mState[2] ^= mState[0];
+    mState[3] ^= mState[1];
+    mState[1] ^= mState[2];
+    mState[0] ^= mState[3];
+    mState[2] ^= t;
+    mState[3] = RotateLeft(mState[3], 45);
+
+    return result;
+}
+
+unsigned int Random::NextUInt()
+{
+    return static_cast<unsigned int>(NextUInt64() >> 32);
+}
+
+unsigned int Random::NextUInt(unsigned int bound)
+{
+    // Lemire's multiply and shift, rejecting the few values that would make some results more likely than others.
+    unsigned long long product = static_cast<unsigned long long>(NextUInt()) * bound;
+    unsigned int low = static_cast<unsigned int>(product);
+
+    if (low < bound)
+    {
+        const unsigned int threshold = (0u - bound) % bound;
+
+        while (low < threshold)
+        {
+            product = static_cast<unsigned long long>(NextUInt()) * bound;
+            low = static_cast<unsigned int>(product);
+        }
+    }
+
+    return static_cast<unsigned int>(product >> 32);
+}
+
+int Random::NextInt(int min, int max)
+{
+    // Unsigned so the full int range does not overflow. A range of zero means all 2^32 values.
+    const unsigned int range = static_cast<unsigned int>(max) - static_cast<unsigned int>(min) + 1;
+    const unsigned int offset = (range == 0) ? NextUInt() : NextUInt(range);
+
+    return static_cast<int>(static_cast<unsigned int>(min) + offset);
+}
+
+float Random::NextFloat()
+{
+    return static_cast<float>(NextUInt64() >> 40) * (1.0f / 16777216.0f);
+}
+
+double Random::NextDouble()
+{
+    return static_cast<double>(NextUInt64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+float Random::NextFloat(float min, float max)
+{
+    return min + NextFloat() * (max - min);
+}
+
+void Random::Jump()
+{
+    JumpBy(JumpPolynomial);
+}
+
+void Random::LongJump()
+{
+    JumpBy(LongJumpPolynomial);
+}
+
+void Random::JumpBy(const unsigned long long polynomial[4])
+{
+    unsigned long long jumped[4] = { 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            if ((polynomial[i] & (1ull << bit)) != 0)
+            {
+                jumped[0] ^= mState[0];
+                jumped[1] ^= mState[1];
+                jumped[2] ^= mState[2];
+                jumped[3] ^= mState[3];
+            }
+
+            NextUInt64();
+        }
+    }
+
+    std::memcpy(mState, jumped, sizeof(mState));
+}
+
+void Random::FillUInts(unsigned int * pOut, size_t count)
+{
+    GenerateBatch(this, pOut, count, [](const unsigned int * pValues, unsigned int * pTarget, size_t values) {
+        std::memcpy(pTarget, pValues, values * sizeof(unsigned int));
+    });
+}
+
+void Random::FillInts(int * pOut, size_t count, int min, int max)
+{
+    const unsigned int base = static_cast<unsigned int>(min);
+    const unsigned int range = static_cast<unsigned int>(max) - base + 1;
+
+    GenerateBatch(this, pOut, count, [=](const unsigned int * pValues, int * pTarget, size_t values) {
+        size_t i = 0;
+
+        if (range == 0)
+        {
+            std::memcpy(pTarget, pValues, values * sizeof(int));
+            return;
+        }
+
+#ifdef SANDBOX_SSE2
+        const __m128i baseVector = _mm_set1_epi32(static_cast<int>(base));
+        const __m128i rangeVector = _mm_set1_epi32(static_cast<int>(range));
+
+        for (; i + 4 <= values; i += 4)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pValues + i));
+            const __m128i result = _mm_add_epi32(baseVector, MultiplyHigh(x, rangeVector));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pTarget + i), result);
+        }
+#endif
+
+        for (; i < values; ++i)
+        {
+            pTarget[i] = static_cast<int>(base + ScaleToRange(pValues[i], range));
+        }
+    });
+}
+
+void Random::FillFloats(float * pOut, size_t count, float min, float max)
+{
+    const float scale = max - min;
+
+    GenerateBatch(this, pOut, count, [=](const unsigned int * pValues, float * pTarget, size_t values) {
+        size_t i = 0;
+
+#ifdef SANDBOX_SSE2
+        const __m128 minVector = _mm_set1_ps(min);
+        const __m128 scaleVector = _mm_set1_ps(scale);
+        const __m128 unit = _mm_set1_ps(1.0f / 16777216.0f);
+
+        for (; i + 4 <= values; i += 4)
+        {
+            const __m128i x = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pValues + i)), 8);
+            const __m128 fraction = _mm_mul_ps(_mm_cvtepi32_ps(x), unit);
+
+            _mm_storeu_ps(pTarget + i, _mm_add_ps(minVector, _mm_mul_ps(fraction, scaleVector)));
+        }
+#endif
+
+        for (; i < values; ++i)
+        {
+            pTarget[i] = min + ScaleToUnit(pValues[i]) * scale;
+        }
+    });
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>     // size_t
+
+/**
+ * \brief Fast seedable random number generator (xoshiro256**).
+ *
+ * Each generator is 32 bytes of state with no locks or globals, so give every thread its own. The same seed always
+ * gives the same sequence on every platform and CPU, which keeps procedural content and tests reproducible.
+ *
+ * For parallel work, seed one generator and derive the others with ForStream(), which jumps ahead 2^128 steps per
+ * stream so the streams never overlap:
+ *
+ *   Random random = Random::ForStream(worldSeed, threadIndex);
+ *
+ * The Fill functions generate large batches with SSE2 or AVX2. They run four interleaved generators seeded from
+ * this one, so a batch is not the same as calling NextFloat() in a loop, but is still the same on every CPU.
+ */
+class Random
+{
+public:
+    static const unsigned long long DefaultSeed = 0x853C49E6748FEA9Bull;
+
+    explicit Random(unsigned long long seed = DefaultSeed);
+
+    // Generator for the given stream index: seeded with seed, then jumped ahead streamIndex times.
+    static Random ForStream(unsigned long long seed, unsigned int streamIndex);
+
+    // Restart the sequence. Seeds are expanded with SplitMix64 so nearby seeds give unrelated sequences.
+    void Seed(unsigned long long seed);
+
+    unsigned long long NextUInt64();
+    unsigned int NextUInt();
+
+    // Uniform in [0, bound) with no modulo bias. Bound must not be zero.
+    unsigned int NextUInt(unsigned int bound);
+
+    // Uniform in [min, max], both inclusive.
+    int NextInt(int min, int max);
+
+    // Uniform in [0, 1) with 24 and 53 bits of precision.
+    float NextFloat();
+    double NextDouble();
+
+    // Uniform in [min, max). Min may be larger than max, the result is then in (max, min].
+    float NextFloat(float min, float max);
+
+    // Advance 2^128 or 2^192 steps, the same as that many calls to NextUInt64().
+    void Jump();
+    void LongJump();
+
+    // Batches of uniform values. Ints are in [min, max] inclusive with a bias of at most (max - min + 1) / 2^32,
+    // floats are in [min, max). The generator advances by a fixed amount per call.
+    void FillUInts(unsigned int * pOut, size_t count);
+    void FillInts(int * pOut, size_t count, int min, int max);
+    void FillFloats(float * pOut, size_t count, float min, float max);
+
+private:
+    void JumpBy(const unsigned long long polynomial[4]);
+
+private:
+    unsigned long long mState[4];
+};
@@ -4,4 +4,19 @@
 const RuntimeRange<unsigned int> MakeRange(unsigned int begin, unsigned int end)
 {
     return RuntimeRange<unsigned int>(begin, end);
-}
\ No newline at end of file
+}
+
+const StridedRange<unsigned int> MakeStridedRange(unsigned int begin, unsigned int end, unsigned int stride)
+{
+    return StridedRange<unsigned int>(begin, end, stride);
+}
+
+const TiledRange2D MakeTiles2D(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight)
+{
+    return TiledRange2D(width, height, tileWidth, tileHeight);
+}
+
+const TiledRange3D MakeTiles3D(unsigned int width, unsigned int height, unsigned int depth, unsigned int tileSize)
+{
+    return TiledRange3D(width, height, depth, tileSize);
+}
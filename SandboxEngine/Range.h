@@ -1,5 +1,6 @@
 #pragma once
 #include <iterator>
+#include <cstddef>     // size_t, ptrdiff_t
 
 // for a full implementation, see:
 // https://bitbucket.org/AraK/range/src/13012260410794b9f5320b4bdbb39b41cfec05f7/range.hpp?at=default
@@ -16,7 +17,7 @@
  *
  * The Range class satisfies the following requirements:
  *  - Immutable
- *  - Forward incrementing
+ *  - Random access
  *  - Constant time complexity
  *
  * The original inspiration was from Stack Overflow: http ://stackoverflow.com/a/7185723
@@ -24,28 +25,61 @@
  *  - Included both compile time constant (template version) and runtime (non template version) range functionality
  *    with two classes sharing a common templated base.
  *  - Change the range and iterator classes to use a templated value type to facilitate future type swapping.
- *  - Made the iterator inherit from a STL forward iterator base.
+ *  - Made the iterator a STL random access iterator, so ranges can be split up for ParallelFor (see ThreadPool.h).
  *  - Added a const_iterator which is aliased to iterator (since iterator is constant anyway).
  *  - Added cbegin() and cend() functions to the ranges.
+ *  - Added strided, chunked and tiled ranges further down.
  */
 template<typename IntegerType>
 class Range
 {
 public:
-    class iterator : public std::iterator<std::forward_iterator_tag, IntegerType>
+    typedef IntegerType value_type;
+
+    class iterator
     {
     public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef IntegerType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const IntegerType * pointer;
+        typedef IntegerType reference;
+
+        iterator()
+            : mI()
+        {
+        }
+
         explicit iterator(IntegerType start)
             : mI(start)
         {
         }
 
         IntegerType operator *() const { return mI; }
+        IntegerType operator [](difference_type n) const { return static_cast<IntegerType>(mI + n); }
+
         iterator& operator ++() { ++mI; return *this; }
         iterator operator ++(int) { iterator copy(*this); ++mI; return copy; }
+        iterator& operator --() { --mI; return *this; }
+        iterator operator --(int) { iterator copy(*this); --mI; return copy; }
+
+        iterator& operator +=(difference_type n) { mI = static_cast<IntegerType>(mI + n); return *this; }
+        iterator& operator -=(difference_type n) { mI = static_cast<IntegerType>(mI - n); return *this; }
+        iterator operator +(difference_type n) const { return iterator(static_cast<IntegerType>(mI + n)); }
+        iterator operator -(difference_type n) const { return iterator(static_cast<IntegerType>(mI - n)); }
+        friend iterator operator +(difference_type n, const iterator& i) { return i + n; }
+
+        difference_type operator -(const iterator& other) const
+        {
+            return static_cast<difference_type>(mI) - static_cast<difference_type>(other.mI);
+        }
 
         bool operator == (const iterator& other) const { return mI == other.mI; }
         bool operator != (const iterator& other) const { return mI != other.mI; }
+        bool operator < (const iterator& other) const { return mI < other.mI; }
+        bool operator > (const iterator& other) const { return mI > other.mI; }
+        bool operator <= (const iterator& other) const { return mI <= other.mI; }
+        bool operator >= (const iterator& other) const { return mI >= other.mI; }
 
     private:
         IntegerType mI;
@@ -54,6 +88,29 @@ public:
     using const_iterator = iterator;
 };
 
+/**
+ * Calls fn(Begin), fn(Begin + 1), ... Count times, expanded by the compiler into straight line code.
+ */
+template<typename IntegerType, IntegerType Begin, size_t Count>
+struct unrolled_loop_t
+{
+    template<typename Function>
+    static void Run(Function& fn)
+    {
+        fn(Begin);
+        unrolled_loop_t<IntegerType, static_cast<IntegerType>(Begin + 1), Count - 1>::Run(fn);
+    }
+};
+
+template<typename IntegerType, IntegerType Begin>
+struct unrolled_loop_t<IntegerType, Begin, 0>
+{
+    template<typename Function>
+    static void Run(Function&)
+    {
+    }
+};
+
 /**
  * Templated implementation of a range concept, useful for for loops. Begin and end values are compile time constants,
  * which may provide speed benefits over the runtime range version.
@@ -62,10 +119,26 @@ template<typename IntegerType, IntegerType BeginIndex, IntegerType EndIndex>
 class ConstantRange : public Range<IntegerType>
 {
 public:
+    typedef typename Range<IntegerType>::iterator iterator;
+    typedef typename Range<IntegerType>::const_iterator const_iterator;
+
     iterator begin() const { return iterator(BeginIndex); }
     iterator end() const { return iterator(EndIndex); }
     const_iterator cbegin() const { return iterator(BeginIndex); }
     const_iterator cend() const { return iterator(EndIndex); }
+
+    size_t size() const { return EndIndex > BeginIndex ? EndIndex - BeginIndex : 0; }
+    IntegerType operator [](size_t index) const { return static_cast<IntegerType>(BeginIndex + index); }
+
+    /**
+     * \brief Call fn(i) for every i in the range, fully unrolled at compile time.
+     * Use it for short fixed loops in hot code where a range for loop might not be unrolled.
+     */
+    template<typename Function>
+    void ForEach(Function fn) const
+    {
+        unrolled_loop_t<IntegerType, BeginIndex, (EndIndex > BeginIndex ? EndIndex - BeginIndex : 0)>::Run(fn);
+    }
 };
 
 /**
@@ -75,6 +148,9 @@ template<typename IntegerType>
 class RuntimeRange : public Range<IntegerType>
 {
 public:
+    typedef typename Range<IntegerType>::iterator iterator;
+    typedef typename Range<IntegerType>::const_iterator const_iterator;
+
     RuntimeRange(IntegerType begin, IntegerType end)
         : mBeginIndex(begin),
           mEndIndex(end)
@@ -86,6 +162,19 @@ public:
     const_iterator cbegin() const { return mBeginIndex; }
     const_iterator cend() const { return mEndIndex; }
 
+    size_t size() const { return mEndIndex > mBeginIndex ? static_cast<size_t>(mEndIndex - mBeginIndex) : 0; }
+    IntegerType operator [](size_t index) const { return mBeginIndex[static_cast<std::ptrdiff_t>(index)]; }
+
+    // Call fn(i) for every i in the range, the runtime counterpart of ConstantRange::ForEach.
+    template<typename Function>
+    void ForEach(Function fn) const
+    {
+        for (IntegerType i = *mBeginIndex; i < *mEndIndex; ++i)
+        {
+            fn(i);
+        }
+    }
+
 private:
     const_iterator mBeginIndex;
     const_iterator mEndIndex;
@@ -106,4 +195,281 @@ const ConstantRange<unsigned int, BeginIndex, EndIndex> MakeRange()
 /**
  * \brief Return a runtime range object for [begin, end).
  */
-const RuntimeRange<unsigned int> MakeRange(unsigned int begin, unsigned int end);
\ No newline at end of file
+const RuntimeRange<unsigned int> MakeRange(unsigned int begin, unsigned int end);
+
+/**
+ * \brief Random access iterator for ranges whose elements are computed from an index with operator [].
+ *
+ * Keeps a copy of the range rather than a pointer to it, so iterators stay valid after a temporary range is gone.
+ * The ranges using it are only a few integers in size.
+ */
+template<typename RangeType>
+class IndexedIterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename RangeType::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type * pointer;
+    typedef value_type reference;
+
+    IndexedIterator(const RangeType& range, difference_type index)
+        : mRange(range),
+          mIndex(index)
+    {
+    }
+
+    value_type operator *() const { return mRange[static_cast<size_t>(mIndex)]; }
+    value_type operator [](difference_type n) const { return mRange[static_cast<size_t>(mIndex + n)]; }
+
+    IndexedIterator& operator ++() { ++mIndex; return *this; }
+    IndexedIterator operator ++(int) { IndexedIterator copy(*this); ++mIndex; return copy; }
+    IndexedIterator& operator --() { --mIndex; return *this; }
+    IndexedIterator operator --(int) { IndexedIterator copy(*this); --mIndex; return copy; }
+
+    IndexedIterator& operator +=(difference_type n) { mIndex += n; return *this; }
+    IndexedIterator& operator -=(difference_type n) { mIndex -= n; return *this; }
+    IndexedIterator operator +(difference_type n) const { return IndexedIterator(mRange, mIndex + n); }
+    IndexedIterator operator -(difference_type n) const { return IndexedIterator(mRange, mIndex - n); }
+    friend IndexedIterator operator +(difference_type n, const IndexedIterator& i) { return i + n; }
+    difference_type operator -(const IndexedIterator& other) const { return mIndex - other.mIndex; }
+
+    bool operator == (const IndexedIterator& other) const { return mIndex == other.mIndex; }
+    bool operator != (const IndexedIterator& other) const { return mIndex != other.mIndex; }
+    bool operator < (const IndexedIterator& other) const { return mIndex < other.mIndex; }
+    bool operator > (const IndexedIterator& other) const { return mIndex > other.mIndex; }
+    bool operator <= (const IndexedIterator& other) const { return mIndex <= other.mIndex; }
+    bool operator >= (const IndexedIterator& other) const { return mIndex >= other.mIndex; }
+
+private:
+    RangeType mRange;
+    difference_type mIndex;
+};
+
+/**
+ * \brief Every stride'th value of [begin, end): begin, begin + stride, ... while below end.
+ */
+template<typename IntegerType>
+class StridedRange
+{
+public:
+    typedef IntegerType value_type;
+    typedef IndexedIterator<StridedRange> iterator;
+    typedef iterator const_iterator;
+
+    // Stride must be greater than zero.
+    StridedRange(IntegerType begin, IntegerType end, IntegerType stride)
+        : mBegin(begin),
+          mStride(stride),
+          mSize(end > begin ? (static_cast<size_t>(end - begin) + stride - 1) / stride : 0)
+    {
+    }
+
+    iterator begin() const { return iterator(*this, 0); }
+    iterator end() const { return iterator(*this, static_cast<std::ptrdiff_t>(mSize)); }
+
+    size_t size() const { return mSize; }
+    IntegerType operator [](size_t index) const { return static_cast<IntegerType>(mBegin + index * mStride); }
+
+private:
+    IntegerType mBegin;
+    IntegerType mStride;
+    size_t mSize;
+};
+
+/**
+ * \brief Splits [begin, end) into consecutive sub ranges of chunkSize values, the last one possibly shorter.
+ *
+ * Useful to hand a thread or a SIMD loop a block of work at a time:
+ *
+ *   for (auto chunk : MakeChunks(MakeRange(0, count), 1024)) { for (auto i : chunk) { ... } }
+ */
+template<typename IntegerType>
+class ChunkedRange
+{
+public:
+    typedef RuntimeRange<IntegerType> value_type;
+    typedef IndexedIterator<ChunkedRange> iterator;
+    typedef iterator const_iterator;
+
+    // Chunk size must be greater than zero.
+    ChunkedRange(IntegerType begin, IntegerType end, IntegerType chunkSize)
+        : mBegin(begin),
+          mEnd(end > begin ? end : begin),
+          mChunkSize(chunkSize)
+    {
+    }
+
+    iterator begin() const { return iterator(*this, 0); }
+    iterator end() const { return iterator(*this, static_cast<std::ptrdiff_t>(size())); }
+
+    size_t size() const { return (static_cast<size_t>(mEnd - mBegin) + mChunkSize - 1) / mChunkSize; }
+
+    value_type operator [](size_t index) const
+    {
+        const IntegerType chunkBegin = static_cast<IntegerType>(mBegin + index * mChunkSize);
+        const IntegerType chunkEnd = (mEnd - chunkBegin > mChunkSize) ? chunkBegin + mChunkSize : mEnd;
+
+        return value_type(chunkBegin, chunkEnd);
+    }
+
+private:
+    IntegerType mBegin;
+    IntegerType mEnd;
+    IntegerType mChunkSize;
+};
+
+/**
+ * \brief A rectangle of a 2D grid, as ranges of columns and rows.
+ */
+struct tile_2d_t
+{
+    RuntimeRange<unsigned int> x;
+    RuntimeRange<unsigned int> y;
+};
+
+/**
+ * \brief A box of a 3D grid, as ranges along each axis.
+ */
+struct tile_3d_t
+{
+    RuntimeRange<unsigned int> x;
+    RuntimeRange<unsigned int> y;
+    RuntimeRange<unsigned int> z;
+};
+
+/**
+ * \brief Covers a width by height grid with tiles of up to tileWidth by tileHeight cells, in row major order.
+ *
+ * Tiles along the right and bottom edges are cut short to fit. Tiles keep the cells a thread touches close together
+ * in memory, which matters more than the split for image and grid work.
+ */
+class TiledRange2D
+{
+public:
+    typedef tile_2d_t value_type;
+    typedef IndexedIterator<TiledRange2D> iterator;
+    typedef iterator const_iterator;
+
+    // Tile sizes must be greater than zero.
+    TiledRange2D(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight)
+        : mWidth(width),
+          mHeight(height),
+          mTileWidth(tileWidth),
+          mTileHeight(tileHeight),
+          mTilesX((width + tileWidth - 1) / tileWidth),
+          mTilesY((height + tileHeight - 1) / tileHeight)
+    {
+    }
+
+    iterator begin() const { return iterator(*this, 0); }
+    iterator end() const { return iterator(*this, static_cast<std::ptrdiff_t>(size())); }
+
+    size_t size() const { return static_cast<size_t>(mTilesX) * mTilesY; }
+    unsigned int TilesX() const { return mTilesX; }
+    unsigned int TilesY() const { return mTilesY; }
+
+    value_type operator [](size_t index) const
+    {
+        const unsigned int x = static_cast<unsigned int>(index % mTilesX) * mTileWidth;
+        const unsigned int y = static_cast<unsigned int>(index / mTilesX) * mTileHeight;
+
+        tile_2d_t tile =
+        {
+            RuntimeRange<unsigned int>(x, (mWidth - x > mTileWidth) ? x + mTileWidth : mWidth),
+            RuntimeRange<unsigned int>(y, (mHeight - y > mTileHeight) ? y + mTileHeight : mHeight)
+        };
+
+        return tile;
+    }
+
+private:
+    unsigned int mWidth, mHeight;
+    unsigned int mTileWidth, mTileHeight;
+    unsigned int mTilesX, mTilesY;
+};
+
+/**
+ * \brief Covers a width by height by depth grid with boxes of up to tileSize cells on each axis, x fastest.
+ */
+class TiledRange3D
+{
+public:
+    typedef tile_3d_t value_type;
+    typedef IndexedIterator<TiledRange3D> iterator;
+    typedef iterator const_iterator;
+
+    // The tile size must be greater than zero.
+    TiledRange3D(unsigned int width, unsigned int height, unsigned int depth, unsigned int tileSize)
+        : mSize(width, height, depth),
+          mTileSize(tileSize),
+          mTilesX((width + tileSize - 1) / tileSize),
+          mTilesY((height + tileSize - 1) / tileSize),
+          mTilesZ((depth + tileSize - 1) / tileSize)
+    {
+    }
+
+    iterator begin() const { return iterator(*this, 0); }
+    iterator end() const { return iterator(*this, static_cast<std::ptrdiff_t>(size())); }
+
+    size_t size() const { return static_cast<size_t>(mTilesX) * mTilesY * mTilesZ; }
+
+    value_type operator [](size_t index) const
+    {
+        const unsigned int x = static_cast<unsigned int>(index % mTilesX) * mTileSize;
+        const unsigned int y = static_cast<unsigned int>(index / mTilesX % mTilesY) * mTileSize;
+        const unsigned int z = static_cast<unsigned int>(index / mTilesX / mTilesY) * mTileSize;
+
+        tile_3d_t tile =
+        {
+            AxisRange(x, mSize.width),
+            AxisRange(y, mSize.height),
+            AxisRange(z, mSize.depth)
+        };
+
+        return tile;
+    }
+
+private:
+    RuntimeRange<unsigned int> AxisRange(unsigned int start, unsigned int size) const
+    {
+        return RuntimeRange<unsigned int>(start, (size - start > mTileSize) ? start + mTileSize : size);
+    }
+
+    struct grid_size_t
+    {
+        grid_size_t(unsigned int w, unsigned int h, unsigned int d) : width(w), height(h), depth(d) { }
+        unsigned int width, height, depth;
+    };
+
+private:
+    grid_size_t mSize;
+    unsigned int mTileSize;
+    unsigned int mTilesX, mTilesY, mTilesZ;
+};
+
+/**
+ * \brief Return a range of every stride'th value of [begin, end).
+ */
+const StridedRange<unsigned int> MakeStridedRange(unsigned int begin, unsigned int end, unsigned int stride);
+
+/**
+ * \brief Return the range split into consecutive chunks of chunkSize values.
+ */
+template<typename RangeType>
+const ChunkedRange<typename RangeType::value_type> MakeChunks(
+    const RangeType& range,
+    typename RangeType::value_type chunkSize)
+{
+    return ChunkedRange<typename RangeType::value_type>(*range.begin(), *range.end(), chunkSize);
+}
+
+/**
+ * \brief Return tiles covering a 2D or 3D grid.
+ */
+const TiledRange2D MakeTiles2D(
+    unsigned int width,
+    unsigned int height,
+    unsigned int tileWidth,
+    unsigned int tileHeight);
+const TiledRange3D MakeTiles3D(unsigned int width, unsigned int height, unsigned int depth, unsigned int tileSize);
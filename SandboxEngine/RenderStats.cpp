@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "RenderStats.h"
+#include "TextFormat.h"
+
+#include <algorithm>
+
+namespace
+{
+    const size_t NameColumnWidth = 16;
+    const size_t ValueColumnWidth = 12;
+
+    const char * const GCounterNames[RenderCounterCount] =
+    {
+        "Draw calls",
+        "Indices",
+        "Buffer binds",
+        "Shader binds",
+        "Resource binds",
+        "State changes",
+        "Map calls",
+        "Bytes uploaded",
+        "Objects tested",
+        "Objects culled"
+    };
+
+    void AppendPadding(FormatBuffer& line, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            line << ' ';
+        }
+    }
+
+    void AppendLeft(FormatBuffer& line, const std::string& cell, size_t width)
+    {
+        line << cell;
+        AppendPadding(line, width > cell.size() ? width - cell.size() : 1);
+    }
+
+    void AppendRight(FormatBuffer& line, const std::string& cell, size_t width)
+    {
+        AppendPadding(line, width > cell.size() ? width - cell.size() : 1);
+        line << cell;
+    }
+
+    template<typename T>
+    std::string ToText(const T& value)
+    {
+        FormatBuffer text;
+        text << value;
+        return text.ToString();
+    }
+}
+
+RenderStats::RenderStats(size_t windowFrames)
+    : mHistory(std::max<size_t>(windowFrames, 1) * RenderCounterCount, 0),
+      mWindowFrames(std::max<size_t>(windowFrames, 1)),
+      mNextRow(0),
+      mFrameCount(0)
+{
+    Reset();
+}
+
+RenderStats::~RenderStats()
+{
+}
+
+void RenderStats::EndFrame()
+{
+    unsigned long long * pRow = &mHistory[mNextRow * RenderCounterCount];
+
+    for (size_t i = 0; i < RenderCounterCount; ++i)
+    {
+        // The row being replaced holds the oldest frame, or zeros while the window is still filling.
+        mSums[i] += mCurrent[i] - pRow[i];
+        pRow[i] = mCurrent[i];
+        mCurrent[i] = 0;
+    }
+
+    mNextRow = (mNextRow + 1) % mWindowFrames;
+    mFrameCount = std::min(mFrameCount + 1, mWindowFrames);
+}
+
+void RenderStats::Reset()
+{
+    std::fill(mHistory.begin(), mHistory.end(), 0);
+    std::fill(mCurrent, mCurrent + RenderCounterCount, 0);
+    std::fill(mSums, mSums + RenderCounterCount, 0);
+
+    mNextRow = 0;
+    mFrameCount = 0;
+}
+
+unsigned long long RenderStats::Current(RenderCounter counter) const
+{
+    return mCurrent[static_cast<size_t>(counter)];
+}
+
+render_counter_summary_t RenderStats::Summary(RenderCounter counter) const
+{
+    const size_t index = static_cast<size_t>(counter);
+    render_counter_summary_t summary = { 0, 0, 0, 0.0 };
+
+    if (mFrameCount == 0)
+    {
+        return summary;
+    }
+
+    const size_t lastRow = (mNextRow + mWindowFrames - 1) % mWindowFrames;
+
+    summary.last = mHistory[lastRow * RenderCounterCount + index];
+    summary.min = summary.last;
+    summary.max = summary.last;
+    summary.average = static_cast<double>(mSums[index]) / static_cast<double>(mFrameCount);
+
+    // Rows that have not been written yet are the ones after the last row, so only the first mFrameCount rows
+    // going backwards from it are frames.
+    for (size_t i = 1; i < mFrameCount; ++i)
+    {
+        const size_t row = (lastRow + mWindowFrames - i) % mWindowFrames;
+        const unsigned long long value = mHistory[row * RenderCounterCount + index];
+
+        summary.min = std::min(summary.min, value);
+        summary.max = std::max(summary.max, value);
+    }
+
+    return summary;
+}
+
+size_t RenderStats::FrameCount() const
+{
+    return mFrameCount;
+}
+
+size_t RenderStats::WindowFrames() const
+{
+    return mWindowFrames;
+}
+
+std::string RenderStats::Dump() const
+{
+    FormatBuffer text;
+    text << "Renderer statistics over the last " << mFrameCount << " frames\n";
+
+    AppendLeft(text, "Counter", NameColumnWidth);
+    AppendRight(text, "Last", ValueColumnWidth);
+    AppendRight(text, "Min", ValueColumnWidth);
+    AppendRight(text, "Average", ValueColumnWidth);
+    AppendRight(text, "Max", ValueColumnWidth);
+    text << '\n';
+
+    for (size_t i = 0; i < RenderCounterCount; ++i)
+    {
+        const RenderCounter counter = static_cast<RenderCounter>(i);
+        const render_counter_summary_t summary = Summary(counter);
+
+        AppendLeft(text, CounterName(counter), NameColumnWidth);
+        AppendRight(text, ToText(summary.last), ValueColumnWidth);
+        AppendRight(text, ToText(summary.min), ValueColumnWidth);
+        AppendRight(text, ToText(TextFormat::Fixed(summary.average, 1)), ValueColumnWidth);
+        AppendRight(text, ToText(summary.max), ValueColumnWidth);
+        text << '\n';
+    }
+
+    return text.ToString();
+}
+
+std::vector<std::string> RenderStats::OverlayLines() const
+{
+    std::vector<std::string> lines;
+    lines.reserve(RenderCounterCount);
+
+    for (size_t i = 0; i < RenderCounterCount; ++i)
+    {
+        const RenderCounter counter = static_cast<RenderCounter>(i);
+        const render_counter_summary_t summary = Summary(counter);
+
+        FormatBuffer line;
+        line << CounterName(counter) << ": " << TextFormat::Fixed(summary.average, 1)
+             << " (" << summary.min << " - " << summary.max << ")";
+
+        lines.push_back(line.ToString());
+    }
+
+    return lines;
+}
+
+const char * RenderStats::CounterName(RenderCounter counter)
+{
+    const size_t index = static_cast<size_t>(counter);
+    return index < RenderCounterCount ? GCounterNames[index] : "Unknown";
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * \brief Work counted by RenderStats, once per event unless noted.
+ */
+enum class RenderCounter
+{
+    DrawCalls,
+    Indices,                // Indices submitted by draw calls.
+    BufferBinds,            // Vertex, index and constant buffers.
+    ShaderBinds,            // Shaders and input layouts.
+    ResourceBinds,          // Shader resource views and samplers.
+    StateChanges,           // Depth stencil and blend states.
+    MapCalls,
+    BytesUploaded,          // Bytes written through mapped buffers.
+    ObjectsTested,          // Objects that reached the visibility test.
+    ObjectsCulled,
+    Count
+};
+
+const size_t RenderCounterCount = static_cast<size_t>(RenderCounter::Count);
+
+/**
+ * \brief One counter over the frames kept by RenderStats.
+ */
+struct render_counter_summary_t
+{
+    unsigned long long last;            // Value in the last completed frame.
+    unsigned long long min;
+    unsigned long long max;
+    double average;
+};
+
+/**
+ * \brief Per frame renderer work counters with rolling min, average and max.
+ *
+ * The renderer calls Add() as it draws, binds, maps and culls, and EndFrame() once per presented frame. Completed
+ * frames go into a ring of the last windowFrames frames, which Summary() reads. Add() is an array increment and
+ * EndFrame() copies one row, so the counters can stay on in every build. Counting is not thread safe, the same as
+ * the immediate device context that is being counted.
+ *
+ * Dump() writes every counter as a text table for logs, and OverlayLines() gives one short line per counter for the
+ * on screen overlay.
+ */
+class RenderStats
+{
+public:
+    static const size_t DefaultWindowFrames = 120;
+
+public:
+    explicit RenderStats(size_t windowFrames = DefaultWindowFrames);
+    RenderStats(const RenderStats&) = delete;
+    ~RenderStats();
+
+    RenderStats& operator =(const RenderStats&) = delete;
+
+    void Add(RenderCounter counter, unsigned long long amount = 1)
+    {
+        mCurrent[static_cast<size_t>(counter)] += amount;
+    }
+
+    // Close the current frame and start counting the next one.
+    void EndFrame();
+
+    // Forget every completed frame and the counts of the current one.
+    void Reset();
+
+    // Count so far in the frame that has not ended yet.
+    unsigned long long Current(RenderCounter counter) const;
+
+    // Counter over the completed frames in the window, all zero before the first EndFrame().
+    render_counter_summary_t Summary(RenderCounter counter) const;
+
+    // Completed frames in the window, at most WindowFrames().
+    size_t FrameCount() const;
+    size_t WindowFrames() const;
+
+    std::string Dump() const;
+    std::vector<std::string> OverlayLines() const;
+
+    static const char * CounterName(RenderCounter counter);
+
+private:
+    std::vector<unsigned long long> mHistory;       // WindowFrames() rows of RenderCounterCount counters.
+    unsigned long long mCurrent[RenderCounterCount];
+    unsigned long long mSums[RenderCounterCount];   // Sum of each counter over the rows in the window.
+    size_t mWindowFrames;
+    size_t mNextRow;
+    size_t mFrameCount;
+};
@@ -0,0 +1,77 @@
+#include "stdafx.h"
+#include "ScratchArena.h"
+#include "Platform.h"       // SANDBOX_THREAD_LOCAL
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    SANDBOX_THREAD_LOCAL FrameArena * GpThreadArena = nullptr;
+
+    // Owns every thread's arena so they can be reported on and are freed at exit.
+    std::mutex GArenasMutex;
+    std::vector<std::unique_ptr<FrameArena>> GArenas;
+}
+
+FrameArena& ScratchArena::ForThisThread()
+{
+    if (GpThreadArena == nullptr)
+    {
+        std::unique_ptr<FrameArena> arena(new FrameArena(DefaultCapacity));
+
+        std::lock_guard<std::mutex> lock(GArenasMutex);
+        GArenas.push_back(std::move(arena));
+        GpThreadArena = GArenas.back().get();
+    }
+
+    return *GpThreadArena;
+}
+
+// Reads other threads' arenas, so only call this while no other thread is using its scratch arena.
+size_t ScratchArena::HighWaterMark()
+{
+    std::lock_guard<std::mutex> lock(GArenasMutex);
+    size_t highWaterMark = 0;
+
+    for (const std::unique_ptr<FrameArena>& arena : GArenas)
+    {
+        highWaterMark = std::max(highWaterMark, arena->HighWaterMark());
+    }
+
+    return highWaterMark;
+}
+
+unsigned long long ScratchArena::HeapAllocationCount()
+{
+    std::lock_guard<std::mutex> lock(GArenasMutex);
+    unsigned long long count = 0;
+
+    for (const std::unique_ptr<FrameArena>& arena : GArenas)
+    {
+        count += arena->HeapAllocationCount();
+    }
+
+    return count;
+}
+
+ScratchScope::ScratchScope()
+    : mArena(ScratchArena::ForThisThread()),
+      mMark(mArena.Mark())
+{
+}
+
+ScratchScope::~ScratchScope()
+{
+    // The outermost scope resets instead, which also grows the arena if it overflowed.
+    if (mMark.used == 0)
+    {
+        mArena.Reset();
+    }
+    else
+    {
+        mArena.Rewind(mMark);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "FrameArena.h"
+
+/**
+ * \brief Per thread FrameArena for temporary buffers inside a function.
+ *
+ * Each thread gets its own arena the first time it asks for one, so code deep in a call stack can get temporary
+ * memory without the caller passing an arena in and without locking. Use it through ScratchScope, which rewinds
+ * the arena when it goes out of scope. Arenas live until the program exits, and each one keeps enough memory for
+ * the most its thread ever needed at once.
+ */
+namespace ScratchArena
+{
+    const size_t DefaultCapacity = 256 * 1024;
+
+    // The calling thread's arena.
+    FrameArena& ForThisThread();
+
+    // Largest high water mark of any thread's arena. Only call while other threads are idle, between frames.
+    size_t HighWaterMark();
+
+    // Heap blocks allocated by every thread's arena. Only call while other threads are idle.
+    unsigned long long HeapAllocationCount();
+}
+
+/**
+ * \brief Releases everything allocated from this thread's scratch arena during the scope's lifetime.
+ *
+ * Scopes nest. Memory from an inner scope must not be used after it ends, and memory from an outer scope stays
+ * valid while inner scopes come and go.
+ *
+ *  EXAMPLE:
+ *      ScratchScope scratch;
+ *      vertex_t * pVertices = scratch.AllocateArray<vertex_t>(vertexCount);
+ */
+class ScratchScope
+{
+public:
+    ScratchScope();
+    ScratchScope(const ScratchScope&) = delete;
+    ~ScratchScope();
+
+    ScratchScope& operator =(const ScratchScope&) = delete;
+
+    FrameArena& Arena() const { return mArena; }
+
+    template<typename T>
+    T * AllocateArray(size_t count) { return mArena.AllocateArray<T>(count); }
+
+    // For standard containers that live inside the scope.
+    template<typename T>
+    ArenaAllocator<T> Allocator() const { return ArenaAllocator<T>(mArena); }
+
+private:
+    FrameArena& mArena;
+    arena_mark_t mMark;
+};
@@ -0,0 +1,58 @@
+#include "stdafx.h"
+#include "Stopwatch.h"
+
+#ifndef _WIN32
+#   include <chrono>
+#endif
+
+namespace
+{
+    long long ReadClock()
+    {
+#ifdef _WIN32
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    double ClockFrequency()
+    {
+#ifdef _WIN32
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(frequency.QuadPart);
+#else
+        return 1.0e9;
+#endif
+    }
+
+    double SecondsPerTick()
+    {
+        static const double Seconds = 1.0 / ClockFrequency();
+        return Seconds;
+    }
+}
+
+Stopwatch::Stopwatch()
+    : mStart(ReadClock())
+{
+}
+
+void Stopwatch::Restart()
+{
+    mStart = ReadClock();
+}
+
+double Stopwatch::ElapsedSeconds() const
+{
+    return static_cast<double>(ReadClock() - mStart) * SecondsPerTick();
+}
+
+double Stopwatch::Now()
+{
+    return static_cast<double>(ReadClock()) * SecondsPerTick();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * \brief High resolution wall clock timer, started on construction.
+ *
+ * Uses QueryPerformanceCounter on Windows, where the standard library clocks of older compilers only tick every
+ * millisecond or so, and std::chrono::steady_clock elsewhere.
+ */
+class Stopwatch
+{
+public:
+    Stopwatch();
+
+    void Restart();
+    double ElapsedSeconds() const;
+
+    // Seconds since an arbitrary fixed point, for timestamps that are compared with each other.
+    static double Now();
+
+private:
+    long long mStart;
+};
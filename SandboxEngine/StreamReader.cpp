@@ -0,0 +1,336 @@
+#include "stdafx.h"
+#include "StreamReader.h"
+#include "BlockCompression.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "PackFile.h"
+
+#include <algorithm>
+#include <fstream>
+
+StreamReader::StreamReader(const std::wstring& filepath, size_t chunkSize, bool readAhead)
+    : mSourceName(filepath),
+      mSize(0),
+      mpWindow(nullptr),
+      mWindowSize(0),
+      mWindowOffset(0),
+      mWindowStart(0),
+      mFill(),
+      mpPack(),
+      mpDecoder(),
+      mpStream(),
+      mFilledBytes(0),
+      mReadIndex(0),
+      mFillIndex(0),
+      mHasWindow(false),
+      mIsFinished(false),
+      mThread(),
+      mMutex(),
+      mCondition(),
+      mError(),
+      mIsStopping(false),
+      mIsFillFinished(false)
+{
+    for (window_t& window : mWindows)
+    {
+        window.size = 0;
+        window.isFilled = false;
+    }
+
+    OpenFile(filepath, std::max(chunkSize, static_cast<size_t>(MinChunkSize)));
+
+    // Read ahead only pays off when there is more than one window to fill.
+    if (readAhead && mFill && mSize > mWindows[0].data.size())
+    {
+        mWindows[1].data.resize(mWindows[0].data.size());
+        StartReadAhead();
+    }
+}
+
+StreamReader::StreamReader(const char * pData, size_t size, const std::wstring& sourceName)
+    : mSourceName(sourceName),
+      mSize(pData != nullptr ? size : 0),
+      mpWindow(pData),
+      mWindowSize(pData != nullptr ? size : 0),
+      mWindowOffset(0),
+      mWindowStart(0),
+      mFill(),
+      mpPack(),
+      mpDecoder(),
+      mpStream(),
+      mFilledBytes(0),
+      mReadIndex(0),
+      mFillIndex(0),
+      mHasWindow(true),
+      mIsFinished(false),
+      mThread(),
+      mMutex(),
+      mCondition(),
+      mError(),
+      mIsStopping(false),
+      mIsFillFinished(true)
+{
+    for (window_t& window : mWindows)
+    {
+        window.size = 0;
+        window.isFilled = false;
+    }
+}
+
+StreamReader::~StreamReader()
+{
+    if (mThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsStopping = true;
+        }
+
+        mCondition.notify_all();
+        mThread.join();
+    }
+}
+
+size_t StreamReader::BufferedBytes() const
+{
+    return mWindows[0].data.capacity() + mWindows[1].data.capacity();
+}
+
+void StreamReader::Read(void * pDst, size_t size)
+{
+    if (size > Remaining())
+    {
+        ThrowTruncated();
+    }
+
+    char * pOut = static_cast<char *>(pDst);
+
+    while (size > 0)
+    {
+        const size_t available = mWindowSize - mWindowOffset;
+
+        if (available == 0)
+        {
+            if (!NextWindow()) { ThrowTruncated(); }
+            continue;
+        }
+
+        const size_t count = std::min(available, size);
+        std::memcpy(pOut, mpWindow + mWindowOffset, count);
+
+        pOut += count;
+        mWindowOffset += count;
+        size -= count;
+    }
+}
+
+void StreamReader::Skip(unsigned long long count)
+{
+    if (count > Remaining())
+    {
+        ThrowTruncated();
+    }
+
+    while (count > 0)
+    {
+        const size_t available = mWindowSize - mWindowOffset;
+
+        if (available == 0)
+        {
+            if (!NextWindow()) { ThrowTruncated(); }
+            continue;
+        }
+
+        const size_t skipped = static_cast<size_t>(std::min<unsigned long long>(available, count));
+
+        mWindowOffset += skipped;
+        count -= skipped;
+    }
+}
+
+void StreamReader::OpenFile(const std::wstring& filepath, size_t chunkSize)
+{
+    pack_entry_t entry;
+    mpPack = PackFile::FindMounted(filepath, &entry);
+
+    if (mpPack != nullptr && (entry.flags & PackFile::FlagCompressed) == 0)
+    {
+        // Already mapped, read it in place like a memory source.
+        mSize = entry.size;
+        mpWindow = entry.pData;
+        mWindowSize = entry.size;
+        mHasWindow = true;
+        mIsFillFinished = true;
+    }
+    else if (mpPack != nullptr)
+    {
+        // Decode a block per window, so windows are at least one block.
+        mpDecoder.reset(new BlockDecoder(entry.pData, entry.size, filepath));
+        mSize = mpDecoder->UncompressedSize();
+
+        BlockDecoder * pDecoder = mpDecoder.get();
+        mFill = [pDecoder](char * pDst, size_t capacity) { return pDecoder->DecodeNext(pDst, capacity); };
+
+        mWindows[0].data.resize(std::max<size_t>(chunkSize, mpDecoder->BlockSize()));
+    }
+    else
+    {
+        mpStream.reset(new std::ifstream(filepath.c_str(), std::ios::binary));
+
+        if (!mpStream->is_open())
+        {
+            throw FileLoadException(filepath);
+        }
+
+        mpStream->seekg(0, std::ios_base::end);
+        mSize = static_cast<unsigned long long>(mpStream->tellg());
+        mpStream->seekg(0, std::ios_base::beg);
+
+        mFill = [this](char * pDst, size_t capacity) -> size_t {
+            const size_t count = static_cast<size_t>(std::min<unsigned long long>(capacity, mSize - mFilledBytes));
+
+            mpStream->read(pDst, static_cast<std::streamsize>(count));
+
+            if (static_cast<size_t>(mpStream->gcount()) != count)
+            {
+                throw FileLoadException(mSourceName);
+            }
+
+            mFilledBytes += count;
+            return count;
+        };
+
+        // Small files only need a window as big as they are.
+        mWindows[0].data.resize(static_cast<size_t>(std::max<unsigned long long>(
+            std::min<unsigned long long>(chunkSize, mSize),
+            1)));
+    }
+}
+
+void StreamReader::StartReadAhead()
+{
+    mThread = std::thread([this]() { RunReadAhead(); });
+}
+
+void StreamReader::RunReadAhead()
+{
+    for (;;)
+    {
+        window_t * pWindow = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() {
+                return mIsStopping || mIsFillFinished || !mWindows[mFillIndex].isFilled;
+            });
+
+            if (mIsStopping || mIsFillFinished) { return; }
+
+            pWindow = &mWindows[mFillIndex];
+        }
+
+        // Fill outside the lock so the caller keeps parsing the other window.
+        size_t size = 0;
+        std::exception_ptr error;
+
+        try
+        {
+            size = Fill(pWindow);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            pWindow->size = (error != nullptr) ? 0 : size;
+            pWindow->isFilled = true;
+            mFillIndex ^= 1;
+
+            if (pWindow->size == 0)
+            {
+                // An empty window marks the end of the data, or an error the caller rethrows.
+                mError = error;
+                mIsFillFinished = true;
+            }
+        }
+
+        mCondition.notify_all();
+    }
+}
+
+bool StreamReader::NextWindow()
+{
+    if (mIsFinished || (!mFill && !mThread.joinable()))
+    {
+        return false;
+    }
+
+    window_t * pWindow = nullptr;
+
+    if (mThread.joinable())
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        // Hand the window that was just parsed back to the read ahead thread and wait for the next one.
+        if (mHasWindow)
+        {
+            mWindows[mReadIndex].isFilled = false;
+            mReadIndex ^= 1;
+            mCondition.notify_all();
+        }
+
+        mCondition.wait(lock, [this]() { return mWindows[mReadIndex].isFilled; });
+
+        pWindow = &mWindows[mReadIndex];
+
+        if (pWindow->size == 0 && mError != nullptr)
+        {
+            mIsFinished = true;
+            std::rethrow_exception(mError);
+        }
+    }
+    else
+    {
+        pWindow = &mWindows[0];
+        pWindow->size = Fill(pWindow);
+    }
+
+    mHasWindow = true;
+    mWindowStart += mWindowSize;
+    mWindowOffset = 0;
+
+    if (pWindow->size == 0)
+    {
+        mIsFinished = true;
+        mpWindow = nullptr;
+        mWindowSize = 0;
+
+        return false;
+    }
+
+    mpWindow = &pWindow->data[0];
+    mWindowSize = pWindow->size;
+
+    return true;
+}
+
+size_t StreamReader::Fill(window_t *pWindow)
+{
+    return mFill(&pWindow->data[0], pWindow->data.size());
+}
+
+void StreamReader::CheckRemaining(size_t count, size_t elementSize) const
+{
+    if (count > Remaining() / elementSize)
+    {
+        ThrowTruncated();
+    }
+}
+
+void StreamReader::ThrowTruncated() const
+{
+    throw FileFormatException(L"Unexpected end of file", mSourceName);
+}
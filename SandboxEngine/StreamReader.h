@@ -0,0 +1,164 @@
+#pragma once
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class PackFile;
+class BlockDecoder;
+
+/**
+ * \brief Sequential reader that parses large files through a small fixed size window.
+ *
+ * BinaryBlob::LoadFromFile() makes a whole file available at once. StreamReader instead reads a file one chunk at a
+ * time into two chunk sized buffers, so parsing a file of any size needs at most two chunks of memory on top of what
+ * the parser keeps. With read ahead enabled a background thread fills one buffer while the caller parses the other.
+ *
+ * Files in a mounted pack are streamed too: uncompressed entries are read in place out of the pack's mapping, and
+ * compressed ones are decoded one block at a time. Memory that is already loaded can be wrapped directly, so a parser
+ * written against StreamReader works on buffers and files alike.
+ *
+ * Typed reads copy values out of the window, so they do not need to be aligned and may straddle chunk boundaries.
+ * Reading past the end of the data throws FileFormatException naming the source.
+ */
+class StreamReader
+{
+public:
+    static const size_t DefaultChunkSize = 256 * 1024;
+    static const size_t MinChunkSize = 16;
+
+    // Stream a file, from a mounted pack if one contains it. Throws FileLoadException if it can not be opened.
+    explicit StreamReader(
+        const std::wstring& filepath,
+        size_t chunkSize = DefaultChunkSize,
+        bool readAhead = true);
+
+    // Read memory that outlives the reader, without copying it into a window. The source name is only used for
+    // error reporting.
+    StreamReader(const char * pData, size_t size, const std::wstring& sourceName);
+
+    StreamReader(const StreamReader&) = delete;
+    ~StreamReader();
+
+    StreamReader& operator =(const StreamReader&) = delete;
+
+    unsigned long long Size() const { return mSize; }
+    unsigned long long Position() const { return mWindowStart + mWindowOffset; }
+    unsigned long long Remaining() const { return mSize - Position(); }
+    bool IsEnd() const { return Position() == mSize; }
+    const std::wstring& SourceName() const { return mSourceName; }
+
+    // Bytes of buffer memory the reader holds, independent of the size of the data.
+    size_t BufferedBytes() const;
+
+    // Copy exactly size bytes, throwing FileFormatException if fewer remain.
+    void Read(void * pDst, size_t size);
+
+    // Skip over count bytes, throwing FileFormatException if fewer remain.
+    void Skip(unsigned long long count);
+
+    // Read one value of a trivially copyable type.
+    template<typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StreamReader can only read trivially copyable types");
+        T value;
+
+        if (sizeof(T) <= mWindowSize - mWindowOffset)
+        {
+            std::memcpy(&value, mpWindow + mWindowOffset, sizeof(T));
+            mWindowOffset += sizeof(T);
+        }
+        else
+        {
+            Read(&value, sizeof(T));
+        }
+
+        return value;
+    }
+
+    // Read count values into pValues.
+    template<typename T>
+    void ReadArray(T * pValues, size_t count)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StreamReader can only read trivially copyable types");
+
+        CheckRemaining(count, sizeof(T));
+        Read(pValues, count * sizeof(T));
+    }
+
+    // Replace the contents of pValuesOut with count values. The count is checked against the remaining data before
+    // anything is allocated, so a corrupt count can not trigger a huge allocation.
+    template<typename T>
+    void ReadArray(size_t count, std::vector<T> *pValuesOut)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "StreamReader can only read trivially copyable types");
+
+        CheckRemaining(count, sizeof(T));
+        pValuesOut->resize(count);
+
+        if (count > 0)
+        {
+            Read(&(*pValuesOut)[0], count * sizeof(T));
+        }
+    }
+
+private:
+    // One chunk sized buffer. Filled by the read ahead thread (or the caller without read ahead), parsed by the
+    // caller, then handed back to be filled again.
+    struct window_t
+    {
+        std::vector<char> data;
+        size_t size;
+        bool isFilled;
+    };
+
+    void OpenFile(const std::wstring& filepath, size_t chunkSize);
+    void StartReadAhead();
+    void RunReadAhead();
+
+    // Move on to the next window. Returns false at the end of the data.
+    bool NextWindow();
+    size_t Fill(window_t *pWindow);
+
+    void CheckRemaining(size_t count, size_t elementSize) const;
+    void ThrowTruncated() const;
+
+private:
+    std::wstring mSourceName;
+    unsigned long long mSize;
+
+    // Current window. Typed reads only touch these.
+    const char * mpWindow;
+    size_t mWindowSize;
+    size_t mWindowOffset;
+    unsigned long long mWindowStart;
+
+    // Streamed sources fill windows through mFill, memory sources have a single window and no fill function.
+    std::function<size_t(char *, size_t)> mFill;
+    std::shared_ptr<const PackFile> mpPack;     // Keeps pack entries mapped.
+    std::unique_ptr<BlockDecoder> mpDecoder;
+    std::unique_ptr<std::ifstream> mpStream;
+    unsigned long long mFilledBytes;            // Bytes handed to windows so far, only used by the filling thread.
+
+    window_t mWindows[2];
+    unsigned int mReadIndex;
+    unsigned int mFillIndex;
+    bool mHasWindow;
+    bool mIsFinished;
+
+    // Read ahead state, shared with the thread under mMutex.
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::exception_ptr mError;
+    bool mIsStopping;
+    bool mIsFillFinished;
+};
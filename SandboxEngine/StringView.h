@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <cstddef>     // size_t
+
+/**
+ * \brief Non owning view of a run of characters, a stand in for std::string_view which Visual Studio 2013 lacks.
+ *
+ * Views never allocate, copy or null terminate. The characters must outlive the view, so views of temporaries are
+ * only safe for the duration of the call they are passed to. Strings and string literals convert implicitly, which
+ * lets functions taking views accept either without creating a temporary std::string.
+ */
+template<typename C>
+class BasicStringView
+{
+public:
+    typedef const C * const_iterator;
+    static const size_t NotFound = static_cast<size_t>(-1);
+
+    BasicStringView()
+        : mpData(nullptr),
+          mSize(0)
+    {
+    }
+
+    BasicStringView(const C * pData, size_t size)
+        : mpData(pData),
+          mSize(size)
+    {
+    }
+
+    BasicStringView(const C * pText)
+        : mpData(pText),
+          mSize(pText != nullptr ? std::char_traits<C>::length(pText) : 0)
+    {
+    }
+
+    BasicStringView(const std::basic_string<C>& text)
+        : mpData(text.data()),
+          mSize(text.size())
+    {
+    }
+
+    const C * Data() const { return mpData; }
+    size_t Size() const { return mSize; }
+    bool IsEmpty() const { return mSize == 0; }
+
+    C operator[](size_t index) const { return mpData[index]; }
+    C Front() const { return mpData[0]; }
+    C Back() const { return mpData[mSize - 1]; }
+
+    const_iterator begin() const { return mpData; }
+    const_iterator end() const { return mpData + mSize; }
+
+    // View of count characters starting at offset, clamped to the end of the view.
+    BasicStringView Substring(size_t offset, size_t count = NotFound) const
+    {
+        if (offset >= mSize)
+        {
+            return BasicStringView(mpData + mSize, 0);
+        }
+
+        return BasicStringView(mpData + offset, (count < mSize - offset) ? count : mSize - offset);
+    }
+
+    void RemovePrefix(size_t count)
+    {
+        count = (count < mSize) ? count : mSize;
+        mpData += count;
+        mSize -= count;
+    }
+
+    void RemoveSuffix(size_t count)
+    {
+        mSize -= (count < mSize) ? count : mSize;
+    }
+
+    // Index of the first c at or after offset, or NotFound.
+    size_t Find(C c, size_t offset = 0) const
+    {
+        for (size_t i = offset; i < mSize; ++i)
+        {
+            if (mpData[i] == c) { return i; }
+        }
+
+        return NotFound;
+    }
+
+    int Compare(const BasicStringView& other) const
+    {
+        const size_t common = (mSize < other.mSize) ? mSize : other.mSize;
+        const int result = (common > 0) ? std::char_traits<C>::compare(mpData, other.mpData, common) : 0;
+
+        if (result != 0)
+        {
+            return result;
+        }
+
+        return (mSize == other.mSize) ? 0 : ((mSize < other.mSize) ? -1 : 1);
+    }
+
+    // Members rather than templates so either side can be a string or literal.
+    friend bool operator ==(const BasicStringView& lhs, const BasicStringView& rhs) { return lhs.Compare(rhs) == 0; }
+    friend bool operator !=(const BasicStringView& lhs, const BasicStringView& rhs) { return lhs.Compare(rhs) != 0; }
+    friend bool operator <(const BasicStringView& lhs, const BasicStringView& rhs) { return lhs.Compare(rhs) < 0; }
+
+    // Copy into a string, the only operation that allocates.
+    std::basic_string<C> ToString() const
+    {
+        return std::basic_string<C>(mpData, mSize);
+    }
+
+private:
+    const C * mpData;
+    size_t mSize;
+};
+
+typedef BasicStringView<char> StringView;
+typedef BasicStringView<wchar_t> WideStringView;
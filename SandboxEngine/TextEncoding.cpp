@@ -0,0 +1,407 @@
+#include "stdafx.h"
+#include "TextEncoding.h"
+#include "CpuFeatures.h"
+#include "DXTestException.h"
+
+namespace
+{
+    // wchar_t holds UTF-16 code units on Windows and UTF-32 code points everywhere else.
+    const bool WideIsUtf16 = sizeof(wchar_t) == 2;
+
+    // Most UTF-8 bytes one wide character can turn into. A surrogate pair is two characters and four bytes.
+    const size_t MaxUtf8BytesPerWide = WideIsUtf16 ? 3 : 4;
+
+#ifdef SANDBOX_AVX2
+    const bool GHasAvx2 = CpuFeatures::DetectAvx2();
+
+    SANDBOX_TARGET_AVX2 size_t WidenAsciiAvx2(const char * pInput, size_t length, wchar_t * pOutput)
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= length; i += 32)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pInput + i));
+
+            if (_mm256_movemask_epi8(bytes) != 0)
+            {
+                break;
+            }
+
+            __m256i * pOut = reinterpret_cast<__m256i *>(pOutput + i);
+
+            if (WideIsUtf16)
+            {
+                _mm256_storeu_si256(pOut, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+                _mm256_storeu_si256(pOut + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+            }
+            else
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    const __m128i eight = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pInput + i + j * 8));
+                    _mm256_storeu_si256(pOut + j, _mm256_cvtepu8_epi32(eight));
+                }
+            }
+        }
+
+        return i;
+    }
+#endif
+
+    // Widen the ASCII run at the start of the input, returning its length. The caller makes sure the first byte is
+    // ASCII so at least one byte is always consumed.
+    size_t WidenAscii(const char * pInput, size_t length, wchar_t * pOutput)
+    {
+        size_t i = 0;
+
+#ifdef SANDBOX_AVX2
+        if (GHasAvx2)
+        {
+            i = WidenAsciiAvx2(pInput, length, pOutput);
+        }
+#endif
+
+#ifdef SANDBOX_SSE2
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 16 <= length; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput + i));
+
+            if (_mm_movemask_epi8(bytes) != 0)
+            {
+                break;
+            }
+
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            __m128i * pOut = reinterpret_cast<__m128i *>(pOutput + i);
+
+            if (WideIsUtf16)
+            {
+                _mm_storeu_si128(pOut, low);
+                _mm_storeu_si128(pOut + 1, high);
+            }
+            else
+            {
+                _mm_storeu_si128(pOut, _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(pOut + 1, _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(pOut + 2, _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(pOut + 3, _mm_unpackhi_epi16(high, zero));
+            }
+        }
+#endif
+
+        for (; i < length && static_cast<unsigned char>(pInput[i]) < 0x80; ++i)
+        {
+            pOutput[i] = static_cast<wchar_t>(pInput[i]);
+        }
+
+        return i;
+    }
+
+    // Narrow the ASCII run at the start of the input, returning its length. The same rules as WidenAscii apply.
+    size_t NarrowAscii(const wchar_t * pInput, size_t length, char * pOutput)
+    {
+        size_t i = 0;
+
+#ifdef SANDBOX_SSE2
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 16 <= length; i += 16)
+        {
+            const __m128i * pIn = reinterpret_cast<const __m128i *>(pInput + i);
+            __m128i bytes;
+
+            if (WideIsUtf16)
+            {
+                const __m128i a = _mm_loadu_si128(pIn);
+                const __m128i b = _mm_loadu_si128(pIn + 1);
+                const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+                {
+                    break;
+                }
+
+                bytes = _mm_packus_epi16(a, b);
+            }
+            else
+            {
+                const __m128i a = _mm_loadu_si128(pIn);
+                const __m128i b = _mm_loadu_si128(pIn + 1);
+                const __m128i c = _mm_loadu_si128(pIn + 2);
+                const __m128i d = _mm_loadu_si128(pIn + 3);
+                const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, _mm_set1_epi32(~0x7F)), zero)) != 0xFFFF)
+                {
+                    break;
+                }
+
+                // Every value is below 0x80, so the signed saturating packs can not change anything.
+                bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput + i), bytes);
+        }
+#endif
+
+        for (; i < length && static_cast<unsigned int>(pInput[i]) < 0x80; ++i)
+        {
+            pOutput[i] = static_cast<char>(pInput[i]);
+        }
+
+        return i;
+    }
+
+    bool IsContinuation(unsigned char c)
+    {
+        return (c & 0xC0) == 0x80;
+    }
+
+    // Decode the multi byte sequence at the start of the input. Returns its length, or zero if it is not valid.
+    size_t DecodeSequence(const unsigned char * pInput, size_t length, unsigned int *pCodePointOut)
+    {
+        const unsigned char lead = pInput[0];
+
+        if (lead < 0xC2 || lead > 0xF4)
+        {
+            // Stray continuation byte, overlong two byte form (C0, C1) or beyond U+10FFFF.
+            return 0;
+        }
+
+        if (lead < 0xE0)
+        {
+            if (length < 2 || !IsContinuation(pInput[1]))
+            {
+                return 0;
+            }
+
+            *pCodePointOut = ((lead & 0x1Fu) << 6) | (pInput[1] & 0x3Fu);
+            return 2;
+        }
+
+        // The second byte range rules out overlong forms, UTF-16 surrogates (ED A0..BF) and code points above
+        // U+10FFFF (F4 90..BF).
+        unsigned char secondMin = 0x80;
+        unsigned char secondMax = 0xBF;
+
+        if (lead == 0xE0) { secondMin = 0xA0; }
+        else if (lead == 0xED) { secondMax = 0x9F; }
+        else if (lead == 0xF0) { secondMin = 0x90; }
+        else if (lead == 0xF4) { secondMax = 0x8F; }
+
+        if (length < 2 || pInput[1] < secondMin || pInput[1] > secondMax)
+        {
+            return 0;
+        }
+
+        if (lead < 0xF0)
+        {
+            if (length < 3 || !IsContinuation(pInput[2]))
+            {
+                return 0;
+            }
+
+            *pCodePointOut = ((lead & 0x0Fu) << 12) | ((pInput[1] & 0x3Fu) << 6) | (pInput[2] & 0x3Fu);
+            return 3;
+        }
+
+        if (length < 4 || !IsContinuation(pInput[2]) || !IsContinuation(pInput[3]))
+        {
+            return 0;
+        }
+
+        *pCodePointOut =
+            ((lead & 0x07u) << 18) | ((pInput[1] & 0x3Fu) << 12) | ((pInput[2] & 0x3Fu) << 6) | (pInput[3] & 0x3Fu);
+        return 4;
+    }
+
+    size_t EncodeSequence(unsigned int codePoint, char * pOutput)
+    {
+        if (codePoint < 0x800)
+        {
+            pOutput[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+            pOutput[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 2;
+        }
+
+        if (codePoint < 0x10000)
+        {
+            pOutput[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+            pOutput[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            pOutput[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+
+        pOutput[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+        pOutput[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        pOutput[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        pOutput[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+
+    template<typename String>
+    bool Fail(String *pOutput, size_t written, size_t offset, size_t *pErrorOffsetOut)
+    {
+        pOutput->resize(written);
+
+        if (pErrorOffsetOut != nullptr)
+        {
+            *pErrorOffsetOut = offset;
+        }
+
+        return false;
+    }
+}
+
+bool TextEncoding::TryUtf8ToWide(
+    const char * pInput,
+    size_t length,
+    std::wstring *pOutput,
+    size_t *pErrorOffsetOut)
+{
+    // Every byte becomes at most one wide character, so the output is sized once up front and trimmed at the end.
+    pOutput->resize(length);
+
+    if (length == 0)
+    {
+        return true;
+    }
+
+    const unsigned char * pBytes = reinterpret_cast<const unsigned char *>(pInput);
+    wchar_t * pOut = &(*pOutput)[0];
+    size_t written = 0;
+    size_t i = 0;
+
+    while (i < length)
+    {
+        if (pBytes[i] < 0x80)
+        {
+            const size_t count = WidenAscii(pInput + i, length - i, pOut + written);
+
+            i += count;
+            written += count;
+            continue;
+        }
+
+        unsigned int codePoint = 0;
+        const size_t sequenceLength = DecodeSequence(pBytes + i, length - i, &codePoint);
+
+        if (sequenceLength == 0)
+        {
+            return Fail(pOutput, written, i, pErrorOffsetOut);
+        }
+
+        if (WideIsUtf16 && codePoint >= 0x10000)
+        {
+            codePoint -= 0x10000;
+            pOut[written++] = static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+            pOut[written++] = static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+        }
+        else
+        {
+            pOut[written++] = static_cast<wchar_t>(codePoint);
+        }
+
+        i += sequenceLength;
+    }
+
+    pOutput->resize(written);
+    return true;
+}
+
+bool TextEncoding::TryWideToUtf8(
+    const wchar_t * pInput,
+    size_t length,
+    std::string *pOutput,
+    size_t *pErrorOffsetOut)
+{
+    // Sized for all ASCII to start with. The first other character grows it to the worst case for the rest, which
+    // only copies the ASCII converted so far.
+    pOutput->resize(length);
+
+    if (length == 0)
+    {
+        return true;
+    }
+
+    char * pOut = &(*pOutput)[0];
+    size_t written = 0;
+    size_t i = 0;
+    bool isSizedForWorstCase = false;
+
+    while (i < length)
+    {
+        unsigned int codePoint = static_cast<unsigned int>(pInput[i]);
+
+        if (codePoint < 0x80)
+        {
+            const size_t count = NarrowAscii(pInput + i, length - i, pOut + written);
+
+            i += count;
+            written += count;
+            continue;
+        }
+
+        if (!isSizedForWorstCase)
+        {
+            pOutput->resize(written + (length - i) * MaxUtf8BytesPerWide);
+            pOut = &(*pOutput)[0];
+            isSizedForWorstCase = true;
+        }
+
+        size_t consumed = 1;
+
+        if (WideIsUtf16 && codePoint >= 0xD800 && codePoint <= 0xDBFF)
+        {
+            const unsigned int low = (i + 1 < length) ? static_cast<unsigned int>(pInput[i + 1]) : 0;
+
+            if (low < 0xDC00 || low > 0xDFFF)
+            {
+                return Fail(pOutput, written, i, pErrorOffsetOut);
+            }
+
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            consumed = 2;
+        }
+        else if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+        {
+            // Lone low surrogate, a surrogate stored as UTF-32 or not a code point at all.
+            return Fail(pOutput, written, i, pErrorOffsetOut);
+        }
+
+        written += EncodeSequence(codePoint, pOut + written);
+        i += consumed;
+    }
+
+    pOutput->resize(written);
+    return true;
+}
+
+std::wstring TextEncoding::Utf8ToWide(const std::string& input)
+{
+    std::wstring output;
+    size_t errorOffset = 0;
+
+    if (!TryUtf8ToWide(input.data(), input.size(), &output, &errorOffset))
+    {
+        throw TextEncodingException(L"Invalid UTF-8", errorOffset);
+    }
+
+    return output;
+}
+
+std::string TextEncoding::WideToUtf8(const std::wstring& input)
+{
+    std::string output;
+    size_t errorOffset = 0;
+
+    if (!TryWideToUtf8(input.data(), input.size(), &output, &errorOffset))
+    {
+        throw TextEncodingException(L"Invalid wide character", errorOffset);
+    }
+
+    return output;
+}
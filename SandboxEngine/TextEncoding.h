@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstddef>     // size_t
+
+/**
+ * \brief Strict UTF-8 and wide string transcoding.
+ *
+ * Wide strings hold UTF-16 where wchar_t is 16 bits (Windows) and UTF-32 where it is 32 bits (Linux and most other
+ * platforms), so the same code converts paths and text on either.
+ *
+ * Runs of ASCII are validated and widened or narrowed 16 characters at a time with SSE2, or 32 at a time with AVX2
+ * when the CPU supports it. Output is sized once from an upper bound and trimmed afterwards instead of measuring the
+ * input in a separate pass.
+ *
+ * Conversions are strict: overlong encodings, encoded surrogates, code points above U+10FFFF, truncated sequences and
+ * unpaired surrogates are all errors rather than being replaced.
+ */
+namespace TextEncoding
+{
+    // Convert UTF-8 to a wide string. Returns false if the input is not valid UTF-8, with the offset of the first
+    // byte of the bad sequence in pErrorOffsetOut (which may be null) and pOutput holding the text before it.
+    bool TryUtf8ToWide(const char * pInput, size_t length, std::wstring *pOutput, size_t *pErrorOffsetOut);
+
+    // Convert a wide string to UTF-8. Returns false on an unpaired surrogate or out of range code point, with the
+    // index of the bad character in pErrorOffsetOut (which may be null) and pOutput holding the text before it.
+    bool TryWideToUtf8(const wchar_t * pInput, size_t length, std::string *pOutput, size_t *pErrorOffsetOut);
+
+    // Throwing versions of the above, TextEncodingException reports where the input went wrong.
+    std::wstring Utf8ToWide(const std::string& input);
+    std::string WideToUtf8(const std::wstring& input);
+}
@@ -0,0 +1,580 @@
+#include "stdafx.h"
+#include "TextFormat.h"
+#include "TextEncoding.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    const char DigitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    // Write the digits of value ending just before pEnd, two at a time. Returns the first digit written.
+    char * WriteDigitsBackwards(unsigned long long value, char * pEnd)
+    {
+        while (value >= 100)
+        {
+            const size_t pair = static_cast<size_t>(value % 100) * 2;
+            value /= 100;
+            *--pEnd = DigitPairs[pair + 1];
+            *--pEnd = DigitPairs[pair];
+        }
+
+        if (value >= 10)
+        {
+            const size_t pair = static_cast<size_t>(value) * 2;
+            *--pEnd = DigitPairs[pair + 1];
+            *--pEnd = DigitPairs[pair];
+        }
+        else
+        {
+            *--pEnd = static_cast<char>('0' + value);
+        }
+
+        return pEnd;
+    }
+
+    size_t WriteUnsigned(unsigned long long value, char * pOut)
+    {
+        char digits[20];
+        const char * pFirst = WriteDigitsBackwards(value, digits + 20);
+        const size_t count = static_cast<size_t>(digits + 20 - pFirst);
+
+        std::memcpy(pOut, pFirst, count);
+        return count;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Grisu2, from Florian Loitsch's "Printing Floating-Point Numbers Quickly and Accurately with Integers" (2010).
+    //
+    // The value and the halfway points to its neighbours are scaled by a cached power of ten into 64 bit fixed point,
+    // then digits are generated until the result is inside the interval of numbers that read back as the value. The
+    // output always round trips and is the shortest possible for all but a fraction of a percent of inputs, where it
+    // is one digit longer.
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct diy_fp_t
+    {
+        unsigned long long f;
+        int e;
+    };
+
+    struct boundaries_t
+    {
+        diy_fp_t w;
+        diy_fp_t minus;
+        diy_fp_t plus;
+    };
+
+    struct cached_power_t
+    {
+        unsigned long long f;
+        int e;
+        int k;
+    };
+
+    // Powers of ten 10^k for k = -300, -292, ..., 324 as normalized 64 bit significands and binary exponents.
+    const cached_power_t CachedPowers[] =
+    {
+        { 0xAB70FE17C79AC6CAull, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4Full, -1034, -292 },
+        { 0xBE5691EF416BD60Cull, -1007, -284 },
+        { 0x8DD01FAD907FFC3Cull,  -980, -276 },
+        { 0xD3515C2831559A83ull,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5ull,  -927, -260 },
+        { 0xEA9C227723EE8BCBull,  -901, -252 },
+        { 0xAECC49914078536Dull,  -874, -244 },
+        { 0x823C12795DB6CE57ull,  -847, -236 },
+        { 0xC21094364DFB5637ull,  -821, -228 },
+        { 0x9096EA6F3848984Full,  -794, -220 },
+        { 0xD77485CB25823AC7ull,  -768, -212 },
+        { 0xA086CFCD97BF97F4ull,  -741, -204 },
+        { 0xEF340A98172AACE5ull,  -715, -196 },
+        { 0xB23867FB2A35B28Eull,  -688, -188 },
+        { 0x84C8D4DFD2C63F3Bull,  -661, -180 },
+        { 0xC5DD44271AD3CDBAull,  -635, -172 },
+        { 0x936B9FCEBB25C996ull,  -608, -164 },
+        { 0xDBAC6C247D62A584ull,  -582, -156 },
+        { 0xA3AB66580D5FDAF6ull,  -555, -148 },
+        { 0xF3E2F893DEC3F126ull,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8ull,  -502, -132 },
+        { 0x87625F056C7C4A8Bull,  -475, -124 },
+        { 0xC9BCFF6034C13053ull,  -449, -116 },
+        { 0x964E858C91BA2655ull,  -422, -108 },
+        { 0xDFF9772470297EBDull,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88Full,  -369,  -92 },
+        { 0xF8A95FCF88747D94ull,  -343,  -84 },
+        { 0xB94470938FA89BCFull,  -316,  -76 },
+        { 0x8A08F0F8BF0F156Bull,  -289,  -68 },
+        { 0xCDB02555653131B6ull,  -263,  -60 },
+        { 0x993FE2C6D07B7FACull,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ull,  -210,  -44 },
+        { 0xAA242499697392D3ull,  -183,  -36 },
+        { 0xFD87B5F28300CA0Eull,  -157,  -28 },
+        { 0xBCE5086492111AEBull,  -130,  -20 },
+        { 0x8CBCCC096F5088CCull,  -103,  -12 },
+        { 0xD1B71758E219652Cull,   -77,   -4 },
+        { 0x9C40000000000000ull,   -50,    4 },
+        { 0xE8D4A51000000000ull,   -24,   12 },
+        { 0xAD78EBC5AC620000ull,     3,   20 },
+        { 0x813F3978F8940984ull,    30,   28 },
+        { 0xC097CE7BC90715B3ull,    56,   36 },
+        { 0x8F7E32CE7BEA5C70ull,    83,   44 },
+        { 0xD5D238A4ABE98068ull,   109,   52 },
+        { 0x9F4F2726179A2245ull,   136,   60 },
+        { 0xED63A231D4C4FB27ull,   162,   68 },
+        { 0xB0DE65388CC8ADA8ull,   189,   76 },
+        { 0x83C7088E1AAB65DBull,   216,   84 },
+        { 0xC45D1DF942711D9Aull,   242,   92 },
+        { 0x924D692CA61BE758ull,   269,  100 },
+        { 0xDA01EE641A708DEAull,   295,  108 },
+        { 0xA26DA3999AEF774Aull,   322,  116 },
+        { 0xF209787BB47D6B85ull,   348,  124 },
+        { 0xB454E4A179DD1877ull,   375,  132 },
+        { 0x865B86925B9BC5C2ull,   402,  140 },
+        { 0xC83553C5C8965D3Dull,   428,  148 },
+        { 0x952AB45CFA97A0B3ull,   455,  156 },
+        { 0xDE469FBD99A05FE3ull,   481,  164 },
+        { 0xA59BC234DB398C25ull,   508,  172 },
+        { 0xF6C69A72A3989F5Cull,   534,  180 },
+        { 0xB7DCBF5354E9BECEull,   561,  188 },
+        { 0x88FCF317F22241E2ull,   588,  196 },
+        { 0xCC20CE9BD35C78A5ull,   614,  204 },
+        { 0x98165AF37B2153DFull,   641,  212 },
+        { 0xE2A0B5DC971F303Aull,   667,  220 },
+        { 0xA8D9D1535CE3B396ull,   694,  228 },
+        { 0xFB9B7CD9A4A7443Cull,   720,  236 },
+        { 0xBB764C4CA7A44410ull,   747,  244 },
+        { 0x8BAB8EEFB6409C1Aull,   774,  252 },
+        { 0xD01FEF10A657842Cull,   800,  260 },
+        { 0x9B10A4E5E9913129ull,   827,  268 },
+        { 0xE7109BFBA19C0C9Dull,   853,  276 },
+        { 0xAC2820D9623BF429ull,   880,  284 },
+        { 0x80444B5E7AA7CF85ull,   907,  292 },
+        { 0xBF21E44003ACDD2Dull,   933,  300 },
+        { 0x8E679C2F5E44FF8Full,   960,  308 },
+        { 0xD433179D9C8CB841ull,   986,  316 },
+        { 0x9E19DB92B4E31BA9ull,  1013,  324 },
+    };
+
+    const int CachedPowersMinDecimalExponent = -300;
+    const int CachedPowersDecimalStep = 8;
+
+    // The scaled value's binary exponent is kept in [Alpha, Gamma] so its integer part fits in 32 bits.
+    const int Alpha = -60;
+    const int Gamma = -32;
+
+    diy_fp_t MakeDiyFp(unsigned long long f, int e)
+    {
+        diy_fp_t result = { f, e };
+        return result;
+    }
+
+    // Upper 64 bits of the 128 bit product, rounded.
+    diy_fp_t Multiply(const diy_fp_t& x, const diy_fp_t& y)
+    {
+        const unsigned long long xLo = x.f & 0xFFFFFFFFu;
+        const unsigned long long xHi = x.f >> 32;
+        const unsigned long long yLo = y.f & 0xFFFFFFFFu;
+        const unsigned long long yHi = y.f >> 32;
+
+        const unsigned long long p0 = xLo * yLo;
+        const unsigned long long p1 = xLo * yHi;
+        const unsigned long long p2 = xHi * yLo;
+        const unsigned long long p3 = xHi * yHi;
+
+        unsigned long long middle = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+        middle += 1ull << 31;
+
+        return MakeDiyFp(p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32), x.e + y.e + 64);
+    }
+
+    diy_fp_t Normalize(diy_fp_t x)
+    {
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            x.e--;
+        }
+
+        return x;
+    }
+
+    // The value and the midpoints to its neighbours. Precision is the significand width including the hidden bit.
+    boundaries_t ComputeBoundaries(unsigned long long bits, int precision, int exponentBias)
+    {
+        const unsigned long long hiddenBit = 1ull << (precision - 1);
+        const int minExponent = 1 - exponentBias;
+        const unsigned long long fraction = bits & (hiddenBit - 1);
+        const int exponent = static_cast<int>(bits >> (precision - 1));
+
+        const diy_fp_t v = (exponent == 0) ?
+            MakeDiyFp(fraction, minExponent) :
+            MakeDiyFp(fraction + hiddenBit, exponent - exponentBias);
+
+        // At a power of two the gap to the next smaller value is half the gap to the next larger one.
+        const bool lowerIsCloser = (fraction == 0 && exponent > 1);
+
+        const diy_fp_t plus = Normalize(MakeDiyFp(2 * v.f + 1, v.e - 1));
+        diy_fp_t minus = lowerIsCloser ? MakeDiyFp(4 * v.f - 1, v.e - 2) : MakeDiyFp(2 * v.f - 1, v.e - 1);
+
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+
+        boundaries_t result = { Normalize(v), minus, plus };
+        return result;
+    }
+
+    const cached_power_t& CachedPowerForBinaryExponent(int e)
+    {
+        // k = ceil((Alpha - e - 1) * log10(2)), 78913 / 2^18 being log10(2) to enough precision.
+        const int f = Alpha - e - 1;
+        const int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+        const int index = (-CachedPowersMinDecimalExponent + k + (CachedPowersDecimalStep - 1)) /
+                          CachedPowersDecimalStep;
+
+        return CachedPowers[index];
+    }
+
+    // Number of decimal digits in n, with pPow10Out set to 10^(digits - 1).
+    int LargestPow10(unsigned int n, unsigned int *pPow10Out)
+    {
+        unsigned int pow10 = 1000000000;
+        int digits = 10;
+
+        while (digits > 1 && n < pow10)
+        {
+            pow10 /= 10;
+            --digits;
+        }
+
+        *pPow10Out = pow10;
+        return digits;
+    }
+
+    // Nudge the last digit down while that moves the result closer to the value and keeps it in range.
+    void RoundWeed(char * pBuffer, int length, unsigned long long distance, unsigned long long delta,
+                   unsigned long long rest, unsigned long long tenK)
+    {
+        while (rest < distance &&
+               delta - rest >= tenK &&
+               (rest + tenK < distance || distance - rest > rest + tenK - distance))
+        {
+            pBuffer[length - 1]--;
+            rest += tenK;
+        }
+    }
+
+    void GenerateDigits(char * pBuffer, int *pLength, int *pDecimalExponent,
+                        diy_fp_t low, diy_fp_t w, diy_fp_t high)
+    {
+        unsigned long long delta = high.f - low.f;
+        unsigned long long distance = high.f - w.f;
+
+        const int shift = -high.e;
+        const unsigned long long one = 1ull << shift;
+        unsigned int integral = static_cast<unsigned int>(high.f >> shift);
+        unsigned long long fractional = high.f & (one - 1);
+
+        unsigned int pow10 = 0;
+        int remaining = LargestPow10(integral, &pow10);
+        int length = 0;
+
+        while (remaining > 0)
+        {
+            pBuffer[length++] = static_cast<char>('0' + integral / pow10);
+            integral %= pow10;
+            --remaining;
+
+            const unsigned long long rest = (static_cast<unsigned long long>(integral) << shift) + fractional;
+
+            if (rest <= delta)
+            {
+                *pDecimalExponent += remaining;
+                *pLength = length;
+                RoundWeed(pBuffer, length, distance, delta, rest, static_cast<unsigned long long>(pow10) << shift);
+                return;
+            }
+
+            pow10 /= 10;
+        }
+
+        int fractionalDigits = 0;
+
+        for (;;)
+        {
+            fractional *= 10;
+            pBuffer[length++] = static_cast<char>('0' + (fractional >> shift));
+            fractional &= one - 1;
+            ++fractionalDigits;
+
+            delta *= 10;
+            distance *= 10;
+
+            if (fractional <= delta)
+            {
+                break;
+            }
+        }
+
+        *pDecimalExponent -= fractionalDigits;
+        *pLength = length;
+        RoundWeed(pBuffer, length, distance, delta, fractional, one);
+    }
+
+    // Shortest digits for a positive finite value, value = digits * 10^decimalExponent.
+    void Grisu2(const boundaries_t& boundaries, char * pDigits, int *pLength, int *pDecimalExponent)
+    {
+        const cached_power_t& cached = CachedPowerForBinaryExponent(boundaries.plus.e);
+        const diy_fp_t scale = MakeDiyFp(cached.f, cached.e);
+
+        const diy_fp_t w = Multiply(boundaries.w, scale);
+        diy_fp_t low = Multiply(boundaries.minus, scale);
+        diy_fp_t high = Multiply(boundaries.plus, scale);
+
+        // Step inside the interval by one unit to allow for the rounding in Multiply.
+        low.f += 1;
+        high.f -= 1;
+
+        *pDecimalExponent = -cached.k;
+        GenerateDigits(pDigits, pLength, pDecimalExponent, low, w, high);
+    }
+
+    // Lay out digits * 10^decimalExponent as plain decimals when that stays short, otherwise in exponent form.
+    size_t WriteDecimal(const char * pDigits, int length, int decimalExponent, char * pOut)
+    {
+        const int MinPlainExponent = -4;
+        const int MaxPlainExponent = 15;
+
+        // Position of the decimal point relative to the first digit.
+        const int point = length + decimalExponent;
+        char * pWrite = pOut;
+
+        if (length <= point && point <= MaxPlainExponent)
+        {
+            // Whole number, 1234e2 becomes 123400.
+            std::memcpy(pWrite, pDigits, length);
+            std::memset(pWrite + length, '0', point - length);
+            return point;
+        }
+
+        if (0 < point && point <= MaxPlainExponent)
+        {
+            // 1234e-2 becomes 12.34.
+            std::memcpy(pWrite, pDigits, point);
+            pWrite[point] = '.';
+            std::memcpy(pWrite + point + 1, pDigits + point, length - point);
+            return length + 1;
+        }
+
+        if (MinPlainExponent < point && point <= 0)
+        {
+            // 1234e-6 becomes 0.001234.
+            pWrite[0] = '0';
+            pWrite[1] = '.';
+            std::memset(pWrite + 2, '0', -point);
+            std::memcpy(pWrite + 2 - point, pDigits, length);
+            return 2 - point + length;
+        }
+
+        // 1234e20 becomes 1.234e+23 and 1e-10 stays 1e-10.
+        *pWrite++ = pDigits[0];
+
+        if (length > 1)
+        {
+            *pWrite++ = '.';
+            std::memcpy(pWrite, pDigits + 1, length - 1);
+            pWrite += length - 1;
+        }
+
+        int exponent = point - 1;
+        *pWrite++ = 'e';
+        *pWrite++ = (exponent < 0) ? '-' : '+';
+        exponent = (exponent < 0) ? -exponent : exponent;
+
+        if (exponent < 10)
+        {
+            *pWrite++ = '0';
+        }
+
+        pWrite += WriteUnsigned(static_cast<unsigned long long>(exponent), pWrite);
+        return static_cast<size_t>(pWrite - pOut);
+    }
+
+    // Handles the sign, zero, infinity and NaN, leaving Grisu2 to positive finite values. Bits are the value's own
+    // bit pattern without the sign, which may be a float's.
+    size_t WriteFloatingPoint(double value, unsigned long long bits, int precision, int exponentBias, char * pOut)
+    {
+        if (value != value)
+        {
+            std::memcpy(pOut, "nan", 3);
+            return 3;
+        }
+
+        size_t count = 0;
+
+        if (std::signbit(value))
+        {
+            pOut[count++] = '-';
+            value = -value;
+        }
+
+        if (value == 0.0)
+        {
+            pOut[count++] = '0';
+            return count;
+        }
+
+        if (value > 1.7976931348623157e308)
+        {
+            std::memcpy(pOut + count, "inf", 3);
+            return count + 3;
+        }
+
+        char digits[20];
+        int length = 0;
+        int decimalExponent = 0;
+
+        Grisu2(ComputeBoundaries(bits, precision, exponentBias), digits, &length, &decimalExponent);
+        return count + WriteDecimal(digits, length, decimalExponent, pOut + count);
+    }
+}
+
+namespace TextFormat
+{
+    size_t FormatInt(long long value, char * pOut)
+    {
+        if (value < 0)
+        {
+            // Negate as unsigned so the most negative value does not overflow.
+            pOut[0] = '-';
+            return 1 + WriteUnsigned(0ull - static_cast<unsigned long long>(value), pOut + 1);
+        }
+
+        return WriteUnsigned(static_cast<unsigned long long>(value), pOut);
+    }
+
+    size_t FormatUnsignedInt(unsigned long long value, char * pOut)
+    {
+        return WriteUnsigned(value, pOut);
+    }
+
+    size_t FormatDouble(double value, char * pOut)
+    {
+        unsigned long long bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        return WriteFloatingPoint(value, bits & 0x7FFFFFFFFFFFFFFFull, 53, 1075, pOut);
+    }
+
+    size_t FormatFloat(float value, char * pOut)
+    {
+        // Boundaries from the float's own neighbours, so the digits are only as many as a float needs.
+        unsigned int bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        return WriteFloatingPoint(value, bits & 0x7FFFFFFFu, 24, 150, pOut);
+    }
+
+    size_t FormatHex(unsigned long long value, unsigned int minDigits, char * pOut)
+    {
+        const char HexDigits[] = "0123456789abcdef";
+        size_t count = 1;
+
+        while (count < 16 && (value >> (count * 4)) != 0)
+        {
+            ++count;
+        }
+
+        count = (count < minDigits) ? (minDigits < 16 ? minDigits : 16) : count;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            pOut[count - 1 - i] = HexDigits[(value >> (i * 4)) & 0xF];
+        }
+
+        return count;
+    }
+
+    size_t FormatFixed(double value, unsigned int decimals, char * pOut)
+    {
+        const unsigned long long Pow10[] =
+        {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+        };
+
+        decimals = (decimals < 9) ? decimals : 9;
+
+        if (!(std::fabs(value) < 1e15))
+        {
+            return FormatDouble(value, pOut);
+        }
+
+        // Scale, round and split into whole and fractional parts. Below 1e15 * 1e9 the product fits in 64 bits.
+        const double scaled = std::floor(std::fabs(value) * static_cast<double>(Pow10[decimals]) + 0.5);
+        const unsigned long long units = static_cast<unsigned long long>(scaled);
+        const unsigned long long whole = units / Pow10[decimals];
+        unsigned long long fraction = units % Pow10[decimals];
+
+        size_t count = 0;
+
+        if (std::signbit(value) && units != 0)
+        {
+            pOut[count++] = '-';
+        }
+
+        count += WriteUnsigned(whole, pOut + count);
+
+        if (decimals > 0)
+        {
+            pOut[count++] = '.';
+
+            for (unsigned int i = decimals; i > 0; --i)
+            {
+                pOut[count + i - 1] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+
+            count += decimals;
+        }
+
+        return count;
+    }
+
+    void AppendConverted(const char * pText, size_t length, std::wstring *pTextOut)
+    {
+        std::wstring part;
+        size_t errorOffset = 0;
+
+        while (!TextEncoding::TryUtf8ToWide(pText, length, &part, &errorOffset))
+        {
+            // Replace the bad byte and carry on after it.
+            pTextOut->append(part);
+            pTextOut->push_back(static_cast<wchar_t>(0xFFFD));
+
+            pText += errorOffset + 1;
+            length -= errorOffset + 1;
+        }
+
+        pTextOut->append(part);
+    }
+
+    void AppendConverted(const wchar_t * pText, size_t length, std::string *pTextOut)
+    {
+        std::string part;
+        size_t errorOffset = 0;
+
+        while (!TextEncoding::TryWideToUtf8(pText, length, &part, &errorOffset))
+        {
+            pTextOut->append(part);
+            pTextOut->push_back('?');
+
+            pText += errorOffset + 1;
+            length -= errorOffset + 1;
+        }
+
+        pTextOut->append(part);
+    }
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include "StringView.h"
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <cstddef>     // size_t
+
+/**
+ * \brief Number to text conversion without locales, streams or heap allocations.
+ *
+ * The functions write ASCII into a caller supplied buffer of at least MaxNumberChars characters and return the number
+ * of characters written, with no null terminator. Floats are written with the fewest digits that read back to the
+ * same value (Grisu2), so 0.1f is "0.1" rather than "0.100000001". Large and small magnitudes switch to exponent form
+ * like "1e+20" and "2.5e-07", and infinities and NaNs are written as "inf", "-inf" and "nan".
+ *
+ * BasicFormatBuffer strings these together, see below.
+ */
+namespace TextFormat
+{
+    const size_t MaxNumberChars = 32;
+
+    size_t FormatInt(long long value, char * pOut);
+    size_t FormatUnsignedInt(unsigned long long value, char * pOut);
+    size_t FormatDouble(double value, char * pOut);
+    size_t FormatFloat(float value, char * pOut);
+
+    // Lower case hex with no prefix, zero padded to at least minDigits (at most 16) digits.
+    size_t FormatHex(unsigned long long value, unsigned int minDigits, char * pOut);
+
+    // Fixed point with exactly decimals (at most 9) digits after the point. Values of 1e15 or more fall back to
+    // FormatDouble since fixed point would be mostly noise.
+    size_t FormatFixed(double value, unsigned int decimals, char * pOut);
+
+    // UTF-8 to wide text and back, replacing invalid sequences with U+FFFD or '?'. Used when a buffer is given text
+    // of the other character type.
+    void AppendConverted(const char * pText, size_t length, std::wstring *pTextOut);
+    void AppendConverted(const wchar_t * pText, size_t length, std::string *pTextOut);
+
+    struct format_hex_t
+    {
+        unsigned long long value;
+        unsigned int minDigits;
+    };
+
+    struct format_fixed_t
+    {
+        double value;
+        unsigned int decimals;
+    };
+
+    // Stream these into a format buffer: buffer << Hex(key, 16) << " took " << Fixed(ms, 2) << " ms".
+    inline format_hex_t Hex(unsigned long long value, unsigned int minDigits = 0)
+    {
+        format_hex_t hex = { value, minDigits };
+        return hex;
+    }
+
+    inline format_fixed_t Fixed(double value, unsigned int decimals)
+    {
+        format_fixed_t fixed = { value, decimals };
+        return fixed;
+    }
+}
+
+/**
+ * \brief Composes text inline in a fixed size buffer, only moving to the heap when the text outgrows it.
+ *
+ * A drop in replacement for building messages with an ostringstream: no locale lookups, no allocation for text that
+ * fits in InlineCapacity characters and much faster number formatting (see TextFormat above). Narrow and wide text
+ * can be mixed freely, narrow text is read as UTF-8.
+ *
+ *   throw FileFormatException(WideFormatBuffer() << L"Expected " << count << L" vertices", filepath);
+ *
+ * The text is always null terminated so CString() can be handed straight to C and Win32 APIs.
+ */
+template<typename C, size_t InlineCapacity = 256>
+class BasicFormatBuffer
+{
+public:
+    BasicFormatBuffer()
+        : mSize(0),
+          mSpill()
+    {
+        mInline[0] = 0;
+    }
+
+    const C * Data() const { return mSpill.empty() ? mInline : &mSpill[0]; }
+    const C * CString() const { return Data(); }
+    size_t Size() const { return mSize; }
+    bool IsEmpty() const { return mSize == 0; }
+
+    BasicStringView<C> View() const { return BasicStringView<C>(Data(), mSize); }
+    std::basic_string<C> ToString() const { return std::basic_string<C>(Data(), mSize); }
+    operator std::basic_string<C>() const { return ToString(); }
+
+    // Empty the buffer, keeping any heap storage for reuse.
+    void Clear()
+    {
+        mSize = 0;
+        MutableData()[0] = 0;
+    }
+
+    void Append(const C * pText, size_t length)
+    {
+        C * pOut = Reserve(length);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            pOut[i] = pText[i];
+        }
+
+        Commit(length);
+    }
+
+    // Overloads for both character types, since a pointer would otherwise pick the bool overload over a view.
+    BasicFormatBuffer& operator <<(const char * pText) { return *this << StringView(pText); }
+    BasicFormatBuffer& operator <<(const wchar_t * pText) { return *this << WideStringView(pText); }
+    BasicFormatBuffer& operator <<(const std::string& text) { return *this << StringView(text); }
+    BasicFormatBuffer& operator <<(const std::wstring& text) { return *this << WideStringView(text); }
+    BasicFormatBuffer& operator <<(char c) { return *this << StringView(&c, 1); }
+    BasicFormatBuffer& operator <<(wchar_t c) { return *this << WideStringView(&c, 1); }
+
+    BasicFormatBuffer& operator <<(StringView text)
+    {
+        AppendText(text.Data(), text.Size());
+        return *this;
+    }
+
+    BasicFormatBuffer& operator <<(WideStringView text)
+    {
+        AppendText(text.Data(), text.Size());
+        return *this;
+    }
+
+    BasicFormatBuffer& operator <<(bool value) { return *this << (value ? "true" : "false"); }
+    BasicFormatBuffer& operator <<(int value) { return AppendSigned(value); }
+    BasicFormatBuffer& operator <<(long value) { return AppendSigned(value); }
+    BasicFormatBuffer& operator <<(long long value) { return AppendSigned(value); }
+    BasicFormatBuffer& operator <<(unsigned int value) { return AppendUnsigned(value); }
+    BasicFormatBuffer& operator <<(unsigned long value) { return AppendUnsigned(value); }
+    BasicFormatBuffer& operator <<(unsigned long long value) { return AppendUnsigned(value); }
+
+    BasicFormatBuffer& operator <<(float value)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatFloat(value, digits));
+    }
+
+    BasicFormatBuffer& operator <<(double value)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatDouble(value, digits));
+    }
+
+    BasicFormatBuffer& operator <<(long double value) { return *this << static_cast<double>(value); }
+
+    // Pointers are written in hex like "0x0000abcd".
+    BasicFormatBuffer& operator <<(const void * pointer)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        const size_t count = TextFormat::FormatHex(
+            reinterpret_cast<size_t>(pointer), static_cast<unsigned int>(sizeof(void *) * 2), digits);
+
+        return *this << "0x" << StringView(digits, count);
+    }
+
+    BasicFormatBuffer& operator <<(const TextFormat::format_hex_t& hex)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatHex(hex.value, hex.minDigits, digits));
+    }
+
+    BasicFormatBuffer& operator <<(const TextFormat::format_fixed_t& fixed)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatFixed(fixed.value, fixed.decimals, digits));
+    }
+
+private:
+    typedef typename std::conditional<std::is_same<C, char>::value, wchar_t, char>::type other_char_t;
+
+    C * MutableData() { return mSpill.empty() ? mInline : &mSpill[0]; }
+
+    // Room for count more characters and the null terminator, moving to the heap if the text no longer fits.
+    C * Reserve(size_t count)
+    {
+        const size_t capacity = mSpill.empty() ? InlineCapacity : mSpill.size();
+        const size_t needed = mSize + count + 1;
+
+        if (needed > capacity)
+        {
+            std::vector<C> larger(needed > capacity * 2 ? needed : capacity * 2);
+            std::char_traits<C>::copy(&larger[0], Data(), mSize);
+            mSpill.swap(larger);
+        }
+
+        return MutableData() + mSize;
+    }
+
+    void Commit(size_t count)
+    {
+        mSize += count;
+        MutableData()[mSize] = 0;
+    }
+
+    void AppendText(const C * pText, size_t length)
+    {
+        Append(pText, length);
+    }
+
+    // Text of the other character type. ASCII is widened or narrowed in place, anything else is converted.
+    void AppendText(const other_char_t * pText, size_t length)
+    {
+        size_t ascii = 0;
+
+        while (ascii < length && static_cast<unsigned long>(pText[ascii]) < 0x80)
+        {
+            ++ascii;
+        }
+
+        AppendAscii(pText, ascii);
+
+        if (ascii < length)
+        {
+            std::basic_string<C> converted;
+            TextFormat::AppendConverted(pText + ascii, length - ascii, &converted);
+            Append(converted.data(), converted.size());
+        }
+    }
+
+    template<typename T>
+    BasicFormatBuffer& AppendAscii(const T * pText, size_t length)
+    {
+        C * pOut = Reserve(length);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            pOut[i] = static_cast<C>(pText[i]);
+        }
+
+        Commit(length);
+        return *this;
+    }
+
+    BasicFormatBuffer& AppendSigned(long long value)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatInt(value, digits));
+    }
+
+    BasicFormatBuffer& AppendUnsigned(unsigned long long value)
+    {
+        char digits[TextFormat::MaxNumberChars];
+        return AppendAscii(digits, TextFormat::FormatUnsignedInt(value, digits));
+    }
+
+private:
+    C mInline[InlineCapacity];
+    size_t mSize;
+    std::vector<C> mSpill;      // Holds the text instead of mInline once it outgrows it.
+};
+
+typedef BasicFormatBuffer<char> FormatBuffer;
+typedef BasicFormatBuffer<wchar_t> WideFormatBuffer;
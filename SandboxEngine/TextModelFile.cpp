@@ -0,0 +1,134 @@
+#include "stdafx.h"
+#include "TextModelFile.h"
+#include "MeshData.h"
+#include "BoundingVolumes.h"
+#include "DXSandbox.h"
+#include "DXTestException.h"
+#include "TextUtils.h"
+
+#include <vector>
+
+namespace
+{
+    // Smallest amount of text one vertex or index can take up, used to reject absurd counts before allocating.
+    const size_t MinVertexTextSize = 16;        // "0 0 0 0 0 0 0 0\n"
+    const size_t MinIndexTextSize = 2;          // "0 "
+
+    bool ReadVertices(TextUtils::Tokenizer& tokens, unsigned int vertexCount, size_t size, s_mesh_data_t *pMeshOut)
+    {
+        if (vertexCount > size / MinVertexTextSize)
+        {
+            return false;
+        }
+
+        std::vector<s_mesh_vertex_t>& verts = pMeshOut->vertices;   // alias to reduce typing.
+        verts.resize(vertexCount);
+
+        for (s_mesh_vertex_t& vertex : verts)
+        {
+            // x y z tu tv nx ny nz, the same order as the vertex members.
+            float * const fields[] =
+            {
+                &vertex.x, &vertex.y, &vertex.z, &vertex.tu, &vertex.tv, &vertex.nx, &vertex.ny, &vertex.nz
+            };
+
+            for (float * pField : fields)
+            {
+                if (!tokens.NextFloat(pField))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool ReadVersion1(TextUtils::Tokenizer& tokens, size_t size, s_mesh_data_t *pMeshOut)
+    {
+        // Get the vertex count. (Index count is the same since one to one mapping).
+        unsigned int vertexCount = 0;
+
+        if (!tokens.NextUnsignedInt(&vertexCount) || !ReadVertices(tokens, vertexCount, size, pMeshOut))
+        {
+            return false;
+        }
+
+        pMeshOut->indices.resize(vertexCount);
+
+        for (unsigned int i = 0; i < vertexCount; ++i)
+        {
+            pMeshOut->indices[i] = static_cast<int>(i);
+        }
+
+        return true;
+    }
+
+    bool ReadVersion2(TextUtils::Tokenizer& tokens, size_t size, s_mesh_data_t *pMeshOut)
+    {
+        // Get mesh header.
+        StringView fileType;
+        unsigned int vertexCount = 0u, indexCount = 0u;
+
+        if (!tokens.Next(&fileType) || !tokens.NextUnsignedInt(&vertexCount) || !tokens.NextUnsignedInt(&indexCount))
+        {
+            return false;
+        }
+
+        if (indexCount > size / MinIndexTextSize || !ReadVertices(tokens, vertexCount, size, pMeshOut))
+        {
+            return false;
+        }
+
+        std::vector<int>& indices = pMeshOut->indices;              // alias to reduce typing.
+        indices.resize(indexCount);
+
+        for (int& index : indices)
+        {
+            if (!tokens.NextInt(&index))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+void TextModelFile::Read(const char * pData, size_t size, const std::wstring& sourceName, s_mesh_data_t *pMeshOut)
+{
+    AssertNotNull(pMeshOut);
+    Verify(pData != nullptr || size == 0);
+
+    // Parsed in place, the only allocations are the vertex and index arrays.
+    const StringView text(pData, size);
+    TextUtils::Tokenizer tokens(text);
+
+    // Version 2 files start with a tag, version 1 files with the vertex count.
+    const StringView body = TextUtils::TrimLeft(text);
+    bool isValid = false;
+
+    if (!body.IsEmpty() && body.Front() == '#')
+    {
+        isValid = ReadVersion2(tokens, size, pMeshOut);
+    }
+    else
+    {
+        isValid = ReadVersion1(tokens, size, pMeshOut);
+    }
+
+    if (!isValid)
+    {
+        throw FileFormatException(L"Malformed text model", sourceName);
+    }
+
+    for (int index : pMeshOut->indices)
+    {
+        if (index < 0 || static_cast<size_t>(index) >= pMeshOut->vertices.size())
+        {
+            throw FileFormatException(L"Text model index out of range", sourceName);
+        }
+    }
+
+    pMeshOut->bounds = BoundingVolumes::ComputeMeshBounds(*pMeshOut);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+
+struct s_mesh_data_t;
+
+/**
+ * \brief Text model formats written by ObjConverter (.model) and the older hand written models (.txt).
+ *
+ * Version 1 is a vertex count followed by that many "x y z u v nx ny nz" lines, with one index per vertex.
+ * Version 2 starts with a "#SimpleModelv1" tag, then the vertex and index counts, the vertices as in version 1 and
+ * finally the indices.
+ *
+ * These are the source formats for models. They are slow to parse, so the asset build converts them to .mesh files
+ * (see MeshFile.h) for the game to load.
+ */
+namespace TextModelFile
+{
+    // Parse a text model, detecting the version from the first token. Computes the mesh bounds. Throws
+    // FileFormatException naming sourceName if the text is malformed.
+    void Read(const char * pData, size_t size, const std::wstring& sourceName, s_mesh_data_t *pMeshOut);
+}
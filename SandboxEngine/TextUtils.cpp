@@ -0,0 +1,451 @@
+#include "stdafx.h"
+#include "TextUtils.h"
+
+#include <cmath>
+#include <cstdlib>          // strtod
+#include <limits>
+#include <string>
+
+namespace
+{
+    // Doubles hold every integer up to 2^53 and every power of ten up to 10^22 exactly, so a mantissa and exponent
+    // within those limits can be combined with one correctly rounded multiply or divide.
+    const unsigned long long MaxExactMantissa = 1ull << 53;
+    const int MaxExactPowerOfTen = 22;
+
+    const double PowersOfTen[MaxExactPowerOfTen + 1] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    // Mantissa digits kept while parsing, more would overflow 64 bits.
+    const int MaxMantissaDigits = 19;
+
+    // Longest number handed to strtod from the stack, longer ones are copied to a string first.
+    const size_t MaxStackNumberLength = 64;
+
+    template<typename C>
+    C ToLowerAscii(C c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<C>(c - 'A' + 'a') : c;
+    }
+
+    template<typename C>
+    BasicStringView<C> TrimLeftImpl(BasicStringView<C> text)
+    {
+        size_t count = 0;
+
+        while (count < text.Size() && TextUtils::IsSpace(text[count]))
+        {
+            ++count;
+        }
+
+        text.RemovePrefix(count);
+        return text;
+    }
+
+    template<typename C>
+    BasicStringView<C> TrimRightImpl(BasicStringView<C> text)
+    {
+        size_t count = 0;
+
+        while (count < text.Size() && TextUtils::IsSpace(text[text.Size() - count - 1]))
+        {
+            ++count;
+        }
+
+        text.RemoveSuffix(count);
+        return text;
+    }
+
+    template<typename C>
+    bool StartsWithImpl(BasicStringView<C> text, BasicStringView<C> prefix)
+    {
+        return text.Size() >= prefix.Size() && text.Substring(0, prefix.Size()) == prefix;
+    }
+
+    template<typename C>
+    bool EndsWithImpl(BasicStringView<C> text, BasicStringView<C> suffix)
+    {
+        return text.Size() >= suffix.Size() && text.Substring(text.Size() - suffix.Size()) == suffix;
+    }
+
+    template<typename C>
+    int CompareIgnoreCaseImpl(BasicStringView<C> lhs, BasicStringView<C> rhs)
+    {
+        const size_t common = (lhs.Size() < rhs.Size()) ? lhs.Size() : rhs.Size();
+
+        for (size_t i = 0; i < common; ++i)
+        {
+            const C a = ToLowerAscii(lhs[i]);
+            const C b = ToLowerAscii(rhs[i]);
+
+            if (a != b)
+            {
+                return (a < b) ? -1 : 1;
+            }
+        }
+
+        return (lhs.Size() == rhs.Size()) ? 0 : ((lhs.Size() < rhs.Size()) ? -1 : 1);
+    }
+
+    // Parse an optionally signed decimal integer, returning its magnitude. Fails on anything but digits or if the
+    // magnitude exceeds max.
+    bool ParseDecimal(
+        StringView text,
+        unsigned long long max,
+        bool allowSign,
+        bool *pIsNegativeOut,
+        unsigned long long *pMagnitudeOut)
+    {
+        size_t i = 0;
+        *pIsNegativeOut = false;
+
+        if (allowSign && i < text.Size() && (text[i] == '-' || text[i] == '+'))
+        {
+            *pIsNegativeOut = (text[i] == '-');
+            ++i;
+        }
+
+        if (i == text.Size())
+        {
+            return false;
+        }
+
+        unsigned long long magnitude = 0;
+
+        for (; i < text.Size(); ++i)
+        {
+            const unsigned int digit = static_cast<unsigned int>(text[i] - '0');
+
+            if (digit > 9 || magnitude > (max - digit) / 10)
+            {
+                return false;
+            }
+
+            magnitude = magnitude * 10 + digit;
+        }
+
+        *pMagnitudeOut = magnitude;
+        return true;
+    }
+
+    bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Slow path for numbers the fast path can not round exactly. The syntax has already been checked.
+    double ParseWithStrtod(StringView text)
+    {
+        if (text.Size() < MaxStackNumberLength)
+        {
+            char buffer[MaxStackNumberLength];
+            std::char_traits<char>::copy(buffer, text.Data(), text.Size());
+            buffer[text.Size()] = '\0';
+
+            return std::strtod(buffer, nullptr);
+        }
+
+        return std::strtod(text.ToString().c_str(), nullptr);
+    }
+}
+
+bool TextUtils::IsSpace(wchar_t c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+StringView TextUtils::TrimLeft(StringView text) { return TrimLeftImpl(text); }
+WideStringView TextUtils::TrimLeft(WideStringView text) { return TrimLeftImpl(text); }
+StringView TextUtils::TrimRight(StringView text) { return TrimRightImpl(text); }
+WideStringView TextUtils::TrimRight(WideStringView text) { return TrimRightImpl(text); }
+StringView TextUtils::Trim(StringView text) { return TrimRightImpl(TrimLeftImpl(text)); }
+WideStringView TextUtils::Trim(WideStringView text) { return TrimRightImpl(TrimLeftImpl(text)); }
+
+bool TextUtils::StartsWith(StringView text, StringView prefix) { return StartsWithImpl(text, prefix); }
+bool TextUtils::StartsWith(WideStringView text, WideStringView prefix) { return StartsWithImpl(text, prefix); }
+bool TextUtils::EndsWith(StringView text, StringView suffix) { return EndsWithImpl(text, suffix); }
+bool TextUtils::EndsWith(WideStringView text, WideStringView suffix) { return EndsWithImpl(text, suffix); }
+
+bool TextUtils::EqualsIgnoreCase(StringView lhs, StringView rhs)
+{
+    return lhs.Size() == rhs.Size() && CompareIgnoreCaseImpl(lhs, rhs) == 0;
+}
+
+bool TextUtils::EqualsIgnoreCase(WideStringView lhs, WideStringView rhs)
+{
+    return lhs.Size() == rhs.Size() && CompareIgnoreCaseImpl(lhs, rhs) == 0;
+}
+
+int TextUtils::CompareIgnoreCase(StringView lhs, StringView rhs) { return CompareIgnoreCaseImpl(lhs, rhs); }
+int TextUtils::CompareIgnoreCase(WideStringView lhs, WideStringView rhs) { return CompareIgnoreCaseImpl(lhs, rhs); }
+
+size_t TextUtils::Split(StringView text, char delimiter, StringView * pPartsOut, size_t maxParts)
+{
+    if (maxParts == 0)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+
+    while (count + 1 < maxParts)
+    {
+        const size_t end = text.Find(delimiter);
+
+        if (end == StringView::NotFound)
+        {
+            break;
+        }
+
+        pPartsOut[count++] = text.Substring(0, end);
+        text.RemovePrefix(end + 1);
+    }
+
+    pPartsOut[count++] = text;
+    return count;
+}
+
+bool TextUtils::ParseInt(StringView text, int *pValueOut)
+{
+    // The magnitude of the most negative int is one more than the largest positive one.
+    const unsigned long long maxPositive = static_cast<unsigned long long>(std::numeric_limits<int>::max());
+    bool isNegative = false;
+    unsigned long long magnitude = 0;
+
+    if (!ParseDecimal(text, maxPositive + 1, true, &isNegative, &magnitude) || (!isNegative && magnitude > maxPositive))
+    {
+        return false;
+    }
+
+    *pValueOut = isNegative ? static_cast<int>(-static_cast<long long>(magnitude)) : static_cast<int>(magnitude);
+    return true;
+}
+
+bool TextUtils::ParseUnsignedInt(StringView text, unsigned int *pValueOut)
+{
+    bool isNegative = false;
+    unsigned long long magnitude = 0;
+
+    if (!ParseDecimal(text, std::numeric_limits<unsigned int>::max(), false, &isNegative, &magnitude))
+    {
+        return false;
+    }
+
+    *pValueOut = static_cast<unsigned int>(magnitude);
+    return true;
+}
+
+bool TextUtils::ParseUnsignedInt(StringView text, unsigned long long *pValueOut)
+{
+    bool isNegative = false;
+    return ParseDecimal(text, std::numeric_limits<unsigned long long>::max(), false, &isNegative, pValueOut);
+}
+
+bool TextUtils::ParseHex(StringView text, unsigned long long *pValueOut)
+{
+    if (text.IsEmpty() || text.Size() > 16)
+    {
+        return false;
+    }
+
+    unsigned long long value = 0;
+
+    for (char c : text)
+    {
+        unsigned int digit = 0;
+
+        if (c >= '0' && c <= '9') { digit = static_cast<unsigned int>(c - '0'); }
+        else if (c >= 'a' && c <= 'f') { digit = static_cast<unsigned int>(c - 'a' + 10); }
+        else if (c >= 'A' && c <= 'F') { digit = static_cast<unsigned int>(c - 'A' + 10); }
+        else { return false; }
+
+        value = (value << 4) | digit;
+    }
+
+    *pValueOut = value;
+    return true;
+}
+
+bool TextUtils::ParseDouble(StringView text, double *pValueOut)
+{
+    size_t i = 0;
+    bool isNegative = false;
+
+    if (i < text.Size() && (text[i] == '-' || text[i] == '+'))
+    {
+        isNegative = (text[i] == '-');
+        ++i;
+    }
+
+    // Collect up to MaxMantissaDigits significant digits, tracking where the decimal point goes.
+    unsigned long long mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    bool isExact = true;
+
+    for (; i < text.Size() && IsDigit(text[i]); ++i)
+    {
+        hasDigits = true;
+
+        if (mantissaDigits < MaxMantissaDigits)
+        {
+            mantissa = mantissa * 10 + static_cast<unsigned int>(text[i] - '0');
+            mantissaDigits += (mantissa != 0) ? 1 : 0;
+        }
+        else
+        {
+            ++exponent;
+            isExact = isExact && text[i] == '0';
+        }
+    }
+
+    if (i < text.Size() && text[i] == '.')
+    {
+        for (++i; i < text.Size() && IsDigit(text[i]); ++i)
+        {
+            hasDigits = true;
+
+            if (mantissaDigits < MaxMantissaDigits)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned int>(text[i] - '0');
+                mantissaDigits += (mantissa != 0) ? 1 : 0;
+                --exponent;
+            }
+            else
+            {
+                isExact = isExact && text[i] == '0';
+            }
+        }
+    }
+
+    if (!hasDigits)
+    {
+        return false;
+    }
+
+    if (i < text.Size() && (text[i] == 'e' || text[i] == 'E'))
+    {
+        ++i;
+        bool isExponentNegative = false;
+
+        if (i < text.Size() && (text[i] == '-' || text[i] == '+'))
+        {
+            isExponentNegative = (text[i] == '-');
+            ++i;
+        }
+
+        if (i == text.Size())
+        {
+            return false;
+        }
+
+        // Saturate huge exponents, they overflow or underflow whatever the mantissa is.
+        int explicitExponent = 0;
+
+        for (; i < text.Size() && IsDigit(text[i]); ++i)
+        {
+            explicitExponent = (explicitExponent < 100000) ? explicitExponent * 10 + (text[i] - '0') : explicitExponent;
+        }
+
+        exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+    }
+
+    if (i != text.Size())
+    {
+        return false;
+    }
+
+    if (isExact && mantissa <= MaxExactMantissa && exponent >= -MaxExactPowerOfTen && exponent <= MaxExactPowerOfTen)
+    {
+        double value = static_cast<double>(mantissa);
+        value = (exponent < 0) ? value / PowersOfTen[-exponent] : value * PowersOfTen[exponent];
+
+        *pValueOut = isNegative ? -value : value;
+        return true;
+    }
+
+    // Out of range values come back as infinity.
+    const double value = ParseWithStrtod(text);
+
+    if (value > std::numeric_limits<double>::max() || value < -std::numeric_limits<double>::max())
+    {
+        return false;
+    }
+
+    *pValueOut = value;
+    return true;
+}
+
+bool TextUtils::ParseFloat(StringView text, float *pValueOut)
+{
+    double value = 0.0;
+
+    if (!ParseDouble(text, &value) || std::abs(value) > std::numeric_limits<float>::max())
+    {
+        return false;
+    }
+
+    *pValueOut = static_cast<float>(value);
+    return true;
+}
+
+TextUtils::Tokenizer::Tokenizer(StringView text, StringView delimiters)
+    : mText(text),
+      mDelimiters(delimiters)
+{
+}
+
+bool TextUtils::Tokenizer::Next(StringView *pTokenOut)
+{
+    size_t start = 0;
+
+    while (start < mText.Size() && IsDelimiter(mText[start]))
+    {
+        ++start;
+    }
+
+    size_t end = start;
+
+    while (end < mText.Size() && !IsDelimiter(mText[end]))
+    {
+        ++end;
+    }
+
+    if (start == end)
+    {
+        mText.RemovePrefix(end);
+        return false;
+    }
+
+    *pTokenOut = mText.Substring(start, end - start);
+    mText.RemovePrefix(end);
+
+    return true;
+}
+
+bool TextUtils::Tokenizer::NextInt(int *pValueOut)
+{
+    StringView token;
+    return Next(&token) && ParseInt(token, pValueOut);
+}
+
+bool TextUtils::Tokenizer::NextUnsignedInt(unsigned int *pValueOut)
+{
+    StringView token;
+    return Next(&token) && ParseUnsignedInt(token, pValueOut);
+}
+
+bool TextUtils::Tokenizer::NextFloat(float *pValueOut)
+{
+    StringView token;
+    return Next(&token) && ParseFloat(token, pValueOut);
+}
+
+bool TextUtils::Tokenizer::IsDelimiter(char c) const
+{
+    return mDelimiters.Find(c) != StringView::NotFound;
+}
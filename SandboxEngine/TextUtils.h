@@ -0,0 +1,109 @@
+#pragma once
+#include "StringView.h"
+
+/**
+ * \brief Text handling on string views that never allocates.
+ *
+ * Everything here works in place on the caller's characters: trims and splits return views into the input, the
+ * tokenizer walks it without copying and numbers are parsed straight out of it. Text parsers built on these run with
+ * no heap traffic beyond what they choose to store.
+ *
+ * Character classes and case folding are ASCII only, so results do not depend on the C locale and bytes inside UTF-8
+ * sequences are never mistaken for spaces or letters.
+ */
+namespace TextUtils
+{
+    // Space, tab, newline, carriage return, vertical tab and form feed.
+    bool IsSpace(wchar_t c);
+
+    StringView TrimLeft(StringView text);
+    WideStringView TrimLeft(WideStringView text);
+    StringView TrimRight(StringView text);
+    WideStringView TrimRight(WideStringView text);
+    StringView Trim(StringView text);
+    WideStringView Trim(WideStringView text);
+
+    // An empty prefix or suffix always matches.
+    bool StartsWith(StringView text, StringView prefix);
+    bool StartsWith(WideStringView text, WideStringView prefix);
+    bool EndsWith(StringView text, StringView suffix);
+    bool EndsWith(WideStringView text, WideStringView suffix);
+
+    // Compare ignoring the case of ASCII letters. Compare returns less than, equal to or greater than zero.
+    bool EqualsIgnoreCase(StringView lhs, StringView rhs);
+    bool EqualsIgnoreCase(WideStringView lhs, WideStringView rhs);
+    int CompareIgnoreCase(StringView lhs, StringView rhs);
+    int CompareIgnoreCase(WideStringView lhs, WideStringView rhs);
+
+    // Split text at every delimiter into pPartsOut, keeping empty parts. When there are more than maxParts parts the
+    // last one holds the rest of the text, delimiters included. Returns the number of parts written.
+    size_t Split(StringView text, char delimiter, StringView * pPartsOut, size_t maxParts);
+
+    // Parse a whole view as a number, returning false if any of it is not part of the number or the value does not
+    // fit. Leading and trailing spaces are not skipped. Decimal numbers take an optional sign, hex numbers have no
+    // prefix. Floats accept the same forms as strtod apart from hex floats, infinities and NaNs.
+    bool ParseInt(StringView text, int *pValueOut);
+    bool ParseUnsignedInt(StringView text, unsigned int *pValueOut);
+    bool ParseUnsignedInt(StringView text, unsigned long long *pValueOut);
+    bool ParseHex(StringView text, unsigned long long *pValueOut);
+    bool ParseFloat(StringView text, float *pValueOut);
+    bool ParseDouble(StringView text, double *pValueOut);
+
+    /**
+     * \brief Splits text into tokens separated by runs of delimiter characters.
+     *
+     * Empty tokens are skipped, so "a  b" is two tokens. Use Next() directly or walk the tokens with a range for
+     * loop, which is single pass just like calling Next():
+     *
+     *   for (StringView word : Tokenizer(line)) { ... }
+     */
+    class Tokenizer
+    {
+    public:
+        class iterator
+        {
+        public:
+            iterator() : mpTokenizer(nullptr), mToken() { }
+            explicit iterator(Tokenizer * pTokenizer) : mpTokenizer(pTokenizer), mToken() { ++(*this); }
+
+            StringView operator *() const { return mToken; }
+            const StringView * operator ->() const { return &mToken; }
+
+            iterator& operator ++()
+            {
+                if (!mpTokenizer->Next(&mToken)) { mpTokenizer = nullptr; }
+                return *this;
+            }
+
+            bool operator ==(const iterator& other) const { return mpTokenizer == other.mpTokenizer; }
+            bool operator !=(const iterator& other) const { return mpTokenizer != other.mpTokenizer; }
+
+        private:
+            Tokenizer * mpTokenizer;
+            StringView mToken;
+        };
+
+        explicit Tokenizer(StringView text, StringView delimiters = " \t\r\n");
+
+        // Move to the next token. Returns false once the text is used up.
+        bool Next(StringView *pTokenOut);
+
+        // Parse the next token as a number. Returns false at the end of the text or if the token is not a number.
+        bool NextInt(int *pValueOut);
+        bool NextUnsignedInt(unsigned int *pValueOut);
+        bool NextFloat(float *pValueOut);
+
+        // Text after the last token returned, starting with the delimiter that ended it.
+        StringView Rest() const { return mText; }
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+
+    private:
+        bool IsDelimiter(char c) const;
+
+    private:
+        StringView mText;
+        StringView mDelimiters;
+    };
+}
@@ -0,0 +1,177 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    std::once_flag GSharedPoolFlag;
+    ThreadPool * GSharedPool = nullptr;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : mWorkers(),
+      mRunMutex(),
+      mMutex(),
+      mWakeCondition(),
+      mDoneCondition(),
+      mpTask(nullptr),
+      mTaskCount(0),
+      mNextTask(0),
+      mError(),
+      mRunningThread(),
+      mGeneration(0),
+      mBusyWorkers(0),
+      mStopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    mWorkers.reserve(threadCount - 1);
+
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        mWorkers.push_back(std::thread([this]() { WorkerLoop(); }));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+
+    mWakeCondition.notify_all();
+
+    for (std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    // Never destroyed, workers may still be parked when static destructors run.
+    std::call_once(GSharedPoolFlag, []() { GSharedPool = new ThreadPool(); });
+    return *GSharedPool;
+}
+
+void ThreadPool::Run(size_t taskCount, const std::function<void(size_t)>& task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    if (mWorkers.empty() || taskCount == 1 || IsInsideRun())
+    {
+        for (size_t i = 0; i < taskCount; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    // Batches from different threads take turns.
+    std::lock_guard<std::mutex> runLock(mRunMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mpTask = &task;
+        mTaskCount = taskCount;
+        mNextTask = 0;
+        mError = nullptr;
+        mRunningThread = std::this_thread::get_id();
+        mBusyWorkers = static_cast<unsigned int>(mWorkers.size());
+        ++mGeneration;
+    }
+
+    mWakeCondition.notify_all();
+    RunTasks();
+
+    std::exception_ptr error;
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDoneCondition.wait(lock, [this]() { return mBusyWorkers == 0; });
+
+        mpTask = nullptr;
+        mRunningThread = std::thread::id();
+        std::swap(error, mError);
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned int seenGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWakeCondition.wait(lock, [&]() { return mStopping || mGeneration != seenGeneration; });
+
+            if (mStopping)
+            {
+                return;
+            }
+
+            seenGeneration = mGeneration;
+        }
+
+        RunTasks();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (--mBusyWorkers == 0)
+        {
+            mDoneCondition.notify_one();
+        }
+    }
+}
+
+void ThreadPool::RunTasks()
+{
+    for (size_t i = mNextTask++; i < mTaskCount; i = mNextTask++)
+    {
+        try
+        {
+            (*mpTask)(i);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            if (!mError)
+            {
+                mError = std::current_exception();
+            }
+
+            mNextTask = mTaskCount;
+        }
+    }
+}
+
+bool ThreadPool::IsInsideRun()
+{
+    const std::thread::id self = std::this_thread::get_id();
+
+    for (const std::thread& worker : mWorkers)
+    {
+        if (worker.get_id() == self)
+        {
+            return true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRunningThread == self;
+}
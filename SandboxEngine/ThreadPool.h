@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>     // size_t
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Fixed set of worker threads that split a batch of indexed tasks between them.
+ *
+ * Unlike starting threads per call, the workers stay parked between batches so short parallel loops stay cheap. The
+ * calling thread works on the batch too, and Run() only returns once every task has finished. The first exception
+ * thrown by a task stops the remaining tasks from starting and is rethrown to the caller.
+ *
+ * Calling Run() from inside a task runs the nested batch serially on that thread instead of deadlocking, so code can
+ * use ParallelFor without knowing whether it is already on a worker.
+ */
+class ThreadPool
+{
+public:
+    // Thread count includes the calling thread, zero uses one thread per hardware thread.
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    ThreadPool& operator =(const ThreadPool&) = delete;
+
+    // Pool shared by the engine, created on first use with one thread per hardware thread.
+    static ThreadPool& Shared();
+
+    unsigned int ThreadCount() const { return static_cast<unsigned int>(mWorkers.size()) + 1; }
+
+    // Call task(i) for every i below taskCount and wait for all of them to finish.
+    void Run(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+    void WorkerLoop();
+    void RunTasks();
+    bool IsInsideRun();
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mRunMutex;
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+
+    const std::function<void(size_t)> * mpTask;
+    size_t mTaskCount;
+    std::atomic<size_t> mNextTask;
+    std::exception_ptr mError;
+    std::thread::id mRunningThread;
+    unsigned int mGeneration;
+    unsigned int mBusyWorkers;
+    bool mStopping;
+};
+
+/**
+ * \brief Call fn(value) for every value in range, split across the pool in chunks of grainSize values.
+ *
+ * Works with any range that has random access iterators (MakeRange, MakeStridedRange, MakeTiles2D...). A grain
+ * size of zero picks about four chunks per thread. Pick a larger grain when each call is tiny, so the cost of handing
+ * out a chunk stays small next to the work in it.
+ */
+template<typename RangeType, typename Function>
+void ParallelFor(ThreadPool& pool, const RangeType& range, Function fn, size_t grainSize = 0)
+{
+    const auto first = range.begin();
+    const size_t count = static_cast<size_t>(std::max<std::ptrdiff_t>(range.end() - first, 0));
+
+    if (grainSize == 0)
+    {
+        grainSize = std::max<size_t>(count / (pool.ThreadCount() * 4), 1);
+    }
+
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+    pool.Run(chunkCount, [&](size_t chunk) {
+        auto current = first + static_cast<std::ptrdiff_t>(chunk * grainSize);
+        const auto last = first + static_cast<std::ptrdiff_t>(std::min(count, (chunk + 1) * grainSize));
+
+        for (; current != last; ++current)
+        {
+            fn(*current);
+        }
+    });
+}
+
+/**
+ * \brief Call fn(value) for every value in range on the shared thread pool.
+ */
+template<typename RangeType, typename Function>
+void ParallelFor(const RangeType& range, Function fn, size_t grainSize = 0)
+{
+    ParallelFor(ThreadPool::Shared(), range, fn, grainSize);
+}
@@ -0,0 +1,670 @@
+#include "stdafx.h"
+#include "TransformKernels.h"
+#include "BoundingVolumes.h"
+#include "CpuFeatures.h"
+
+#include <cmath>
+
+// Each kernel has a scalar, SSE2 and AVX2 version taking [begin, count) and returning the index it stopped at. The
+// SIMD versions stop before the last partial register, which the next narrower version picks up. All three evaluate
+// every expression in the same order and never fuse a multiply and an add, so they give bit identical results.
+namespace
+{
+#ifdef SANDBOX_AVX2
+    const bool GHasAvx2 = CpuFeatures::DetectAvx2();
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // Scalar
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t TransformPointsScalar(
+        const float * m,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        size_t begin,
+        size_t count)
+    {
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float x = in.pX[i], y = in.pY[i], z = in.pZ[i];
+
+            out.pX[i] = x * m[0] + y * m[4] + z * m[8] + m[12];
+            out.pY[i] = x * m[1] + y * m[5] + z * m[9] + m[13];
+            out.pZ[i] = x * m[2] + y * m[6] + z * m[10] + m[14];
+        }
+
+        return count;
+    }
+
+    size_t TransformVectorsScalar(
+        const float * m,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        bool normalize,
+        size_t begin,
+        size_t count)
+    {
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float x = in.pX[i], y = in.pY[i], z = in.pZ[i];
+
+            float rx = x * m[0] + y * m[4] + z * m[8];
+            float ry = x * m[1] + y * m[5] + z * m[9];
+            float rz = x * m[2] + y * m[6] + z * m[10];
+
+            if (normalize)
+            {
+                const float length = std::sqrt(rx * rx + ry * ry + rz * rz);
+                const float scale = (length > 0.0f) ? 1.0f / length : 0.0f;
+
+                rx *= scale;
+                ry *= scale;
+                rz *= scale;
+            }
+
+            out.pX[i] = rx;
+            out.pY[i] = ry;
+            out.pZ[i] = rz;
+        }
+
+        return count;
+    }
+
+    size_t TransformAabbsScalar(
+        const float * m,
+        const soa_aabbs_t& in,
+        const soa_aabbs_t& out,
+        size_t begin,
+        size_t count)
+    {
+        // Transform the center, and grow the extents by the absolute value of the rotation and scale.
+        float a[9];
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                a[row * 3 + column] = std::fabs(m[row * 4 + column]);
+            }
+        }
+
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float cx = (in.min.pX[i] + in.max.pX[i]) * 0.5f;
+            const float cy = (in.min.pY[i] + in.max.pY[i]) * 0.5f;
+            const float cz = (in.min.pZ[i] + in.max.pZ[i]) * 0.5f;
+            const float ex = (in.max.pX[i] - in.min.pX[i]) * 0.5f;
+            const float ey = (in.max.pY[i] - in.min.pY[i]) * 0.5f;
+            const float ez = (in.max.pZ[i] - in.min.pZ[i]) * 0.5f;
+
+            const float rcx = cx * m[0] + cy * m[4] + cz * m[8] + m[12];
+            const float rcy = cx * m[1] + cy * m[5] + cz * m[9] + m[13];
+            const float rcz = cx * m[2] + cy * m[6] + cz * m[10] + m[14];
+            const float rex = ex * a[0] + ey * a[3] + ez * a[6];
+            const float rey = ex * a[1] + ey * a[4] + ez * a[7];
+            const float rez = ex * a[2] + ey * a[5] + ez * a[8];
+
+            out.min.pX[i] = rcx - rex;
+            out.min.pY[i] = rcy - rey;
+            out.min.pZ[i] = rcz - rez;
+            out.max.pX[i] = rcx + rex;
+            out.max.pY[i] = rcy + rey;
+            out.max.pZ[i] = rcz + rez;
+        }
+
+        return count;
+    }
+
+    size_t MultiplyMatricesScalar(const float * pIn, const float * b, float * pOut, size_t begin, size_t count)
+    {
+        for (size_t i = begin; i < count; ++i)
+        {
+            float a[16];
+
+            for (int k = 0; k < 16; ++k)
+            {
+                a[k] = pIn[i * 16 + k];
+            }
+
+            for (int row = 0; row < 4; ++row)
+            {
+                const float * r = a + row * 4;
+
+                for (int column = 0; column < 4; ++column)
+                {
+                    pOut[i * 16 + row * 4 + column] =
+                        r[0] * b[column] + r[1] * b[4 + column] + r[2] * b[8 + column] + r[3] * b[12 + column];
+                }
+            }
+        }
+
+        return count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // SSE2
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef SANDBOX_SSE2
+    // Row x, y and z through the first three rows of a matrix given as broadcast elements.
+    inline void MultiplySse2(const __m128 * m, __m128 x, __m128 y, __m128 z, __m128 *pX, __m128 *pY, __m128 *pZ)
+    {
+        *pX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0]), _mm_mul_ps(y, m[4])), _mm_mul_ps(z, m[8]));
+        *pY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[1]), _mm_mul_ps(y, m[5])), _mm_mul_ps(z, m[9]));
+        *pZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[2]), _mm_mul_ps(y, m[6])), _mm_mul_ps(z, m[10]));
+    }
+
+    inline void BroadcastSse2(const float * matrix, __m128 m[16])
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            m[k] = _mm_set1_ps(matrix[k]);
+        }
+    }
+
+    size_t TransformPointsSse2(
+        const float * matrix,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        size_t begin,
+        size_t count)
+    {
+        __m128 m[16];
+        BroadcastSse2(matrix, m);
+
+        size_t i = begin;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x, y, z;
+            MultiplySse2(m, _mm_loadu_ps(in.pX + i), _mm_loadu_ps(in.pY + i), _mm_loadu_ps(in.pZ + i), &x, &y, &z);
+
+            _mm_storeu_ps(out.pX + i, _mm_add_ps(x, m[12]));
+            _mm_storeu_ps(out.pY + i, _mm_add_ps(y, m[13]));
+            _mm_storeu_ps(out.pZ + i, _mm_add_ps(z, m[14]));
+        }
+
+        return i;
+    }
+
+    size_t TransformVectorsSse2(
+        const float * matrix,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        bool normalize,
+        size_t begin,
+        size_t count)
+    {
+        __m128 m[16];
+        BroadcastSse2(matrix, m);
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        size_t i = begin;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x, y, z;
+            MultiplySse2(m, _mm_loadu_ps(in.pX + i), _mm_loadu_ps(in.pY + i), _mm_loadu_ps(in.pZ + i), &x, &y, &z);
+
+            if (normalize)
+            {
+                const __m128 lengthSquared =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+                const __m128 length = _mm_sqrt_ps(lengthSquared);
+                const __m128 scale = _mm_and_ps(_mm_div_ps(one, length), _mm_cmpgt_ps(length, zero));
+
+                x = _mm_mul_ps(x, scale);
+                y = _mm_mul_ps(y, scale);
+                z = _mm_mul_ps(z, scale);
+            }
+
+            _mm_storeu_ps(out.pX + i, x);
+            _mm_storeu_ps(out.pY + i, y);
+            _mm_storeu_ps(out.pZ + i, z);
+        }
+
+        return i;
+    }
+
+    size_t TransformAabbsSse2(
+        const float * matrix,
+        const soa_aabbs_t& in,
+        const soa_aabbs_t& out,
+        size_t begin,
+        size_t count)
+    {
+        __m128 m[16], a[16];
+        BroadcastSse2(matrix, m);
+
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        for (int k = 0; k < 16; ++k)
+        {
+            a[k] = _mm_and_ps(m[k], signMask);
+        }
+
+        size_t i = begin;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 minX = _mm_loadu_ps(in.min.pX + i), maxX = _mm_loadu_ps(in.max.pX + i);
+            const __m128 minY = _mm_loadu_ps(in.min.pY + i), maxY = _mm_loadu_ps(in.max.pY + i);
+            const __m128 minZ = _mm_loadu_ps(in.min.pZ + i), maxZ = _mm_loadu_ps(in.max.pZ + i);
+
+            __m128 cx, cy, cz, ex, ey, ez;
+
+            MultiplySse2(
+                m,
+                _mm_mul_ps(_mm_add_ps(minX, maxX), half),
+                _mm_mul_ps(_mm_add_ps(minY, maxY), half),
+                _mm_mul_ps(_mm_add_ps(minZ, maxZ), half),
+                &cx, &cy, &cz);
+
+            MultiplySse2(
+                a,
+                _mm_mul_ps(_mm_sub_ps(maxX, minX), half),
+                _mm_mul_ps(_mm_sub_ps(maxY, minY), half),
+                _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half),
+                &ex, &ey, &ez);
+
+            cx = _mm_add_ps(cx, m[12]);
+            cy = _mm_add_ps(cy, m[13]);
+            cz = _mm_add_ps(cz, m[14]);
+
+            _mm_storeu_ps(out.min.pX + i, _mm_sub_ps(cx, ex));
+            _mm_storeu_ps(out.min.pY + i, _mm_sub_ps(cy, ey));
+            _mm_storeu_ps(out.min.pZ + i, _mm_sub_ps(cz, ez));
+            _mm_storeu_ps(out.max.pX + i, _mm_add_ps(cx, ex));
+            _mm_storeu_ps(out.max.pY + i, _mm_add_ps(cy, ey));
+            _mm_storeu_ps(out.max.pZ + i, _mm_add_ps(cz, ez));
+        }
+
+        return i;
+    }
+
+    size_t MultiplyMatricesSse2(const float * pIn, const float * matrix, float * pOut, size_t begin, size_t count)
+    {
+        const __m128 b0 = _mm_loadu_ps(matrix);
+        const __m128 b1 = _mm_loadu_ps(matrix + 4);
+        const __m128 b2 = _mm_loadu_ps(matrix + 8);
+        const __m128 b3 = _mm_loadu_ps(matrix + 12);
+
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float * a = pIn + i * 16;
+            __m128 rows[4];
+
+            // Load every row before storing any, the output may be the input.
+            for (int row = 0; row < 4; ++row)
+            {
+                const __m128 r = _mm_loadu_ps(a + row * 4);
+
+                rows[row] = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_add_ps(
+                            _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)), b0),
+                            _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)), b1)),
+                        _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2)), b2)),
+                    _mm_mul_ps(_mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+            }
+
+            for (int row = 0; row < 4; ++row)
+            {
+                _mm_storeu_ps(pOut + i * 16 + row * 4, rows[row]);
+            }
+        }
+
+        return count;
+    }
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+    // AVX2
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef SANDBOX_AVX2
+    SANDBOX_TARGET_AVX2 inline void MultiplyAvx2(
+        const __m256 * m,
+        __m256 x,
+        __m256 y,
+        __m256 z,
+        __m256 *pX,
+        __m256 *pY,
+        __m256 *pZ)
+    {
+        *pX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0]), _mm256_mul_ps(y, m[4])), _mm256_mul_ps(z, m[8]));
+        *pY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[1]), _mm256_mul_ps(y, m[5])), _mm256_mul_ps(z, m[9]));
+        *pZ = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[2]), _mm256_mul_ps(y, m[6])), _mm256_mul_ps(z, m[10]));
+    }
+
+    SANDBOX_TARGET_AVX2 inline void BroadcastAvx2(const float * matrix, __m256 m[16])
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            m[k] = _mm256_set1_ps(matrix[k]);
+        }
+    }
+
+    SANDBOX_TARGET_AVX2 size_t TransformPointsAvx2(
+        const float * matrix,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        size_t begin,
+        size_t count)
+    {
+        __m256 m[16];
+        BroadcastAvx2(matrix, m);
+
+        size_t i = begin;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x, y, z;
+            MultiplyAvx2(
+                m,
+                _mm256_loadu_ps(in.pX + i),
+                _mm256_loadu_ps(in.pY + i),
+                _mm256_loadu_ps(in.pZ + i),
+                &x, &y, &z);
+
+            _mm256_storeu_ps(out.pX + i, _mm256_add_ps(x, m[12]));
+            _mm256_storeu_ps(out.pY + i, _mm256_add_ps(y, m[13]));
+            _mm256_storeu_ps(out.pZ + i, _mm256_add_ps(z, m[14]));
+        }
+
+        return i;
+    }
+
+    SANDBOX_TARGET_AVX2 size_t TransformVectorsAvx2(
+        const float * matrix,
+        const soa_vectors_t& in,
+        const soa_vectors_t& out,
+        bool normalize,
+        size_t begin,
+        size_t count)
+    {
+        __m256 m[16];
+        BroadcastAvx2(matrix, m);
+
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        size_t i = begin;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x, y, z;
+            MultiplyAvx2(
+                m,
+                _mm256_loadu_ps(in.pX + i),
+                _mm256_loadu_ps(in.pY + i),
+                _mm256_loadu_ps(in.pZ + i),
+                &x, &y, &z);
+
+            if (normalize)
+            {
+                const __m256 lengthSquared =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+                const __m256 length = _mm256_sqrt_ps(lengthSquared);
+                const __m256 scale =
+                    _mm256_and_ps(_mm256_div_ps(one, length), _mm256_cmp_ps(length, zero, _CMP_GT_OQ));
+
+                x = _mm256_mul_ps(x, scale);
+                y = _mm256_mul_ps(y, scale);
+                z = _mm256_mul_ps(z, scale);
+            }
+
+            _mm256_storeu_ps(out.pX + i, x);
+            _mm256_storeu_ps(out.pY + i, y);
+            _mm256_storeu_ps(out.pZ + i, z);
+        }
+
+        return i;
+    }
+
+    SANDBOX_TARGET_AVX2 size_t TransformAabbsAvx2(
+        const float * matrix,
+        const soa_aabbs_t& in,
+        const soa_aabbs_t& out,
+        size_t begin,
+        size_t count)
+    {
+        __m256 m[16], a[16];
+        BroadcastAvx2(matrix, m);
+
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        for (int k = 0; k < 16; ++k)
+        {
+            a[k] = _mm256_and_ps(m[k], signMask);
+        }
+
+        size_t i = begin;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 minX = _mm256_loadu_ps(in.min.pX + i), maxX = _mm256_loadu_ps(in.max.pX + i);
+            const __m256 minY = _mm256_loadu_ps(in.min.pY + i), maxY = _mm256_loadu_ps(in.max.pY + i);
+            const __m256 minZ = _mm256_loadu_ps(in.min.pZ + i), maxZ = _mm256_loadu_ps(in.max.pZ + i);
+
+            __m256 cx, cy, cz, ex, ey, ez;
+
+            MultiplyAvx2(
+                m,
+                _mm256_mul_ps(_mm256_add_ps(minX, maxX), half),
+                _mm256_mul_ps(_mm256_add_ps(minY, maxY), half),
+                _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half),
+                &cx, &cy, &cz);
+
+            MultiplyAvx2(
+                a,
+                _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half),
+                _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half),
+                _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half),
+                &ex, &ey, &ez);
+
+            cx = _mm256_add_ps(cx, m[12]);
+            cy = _mm256_add_ps(cy, m[13]);
+            cz = _mm256_add_ps(cz, m[14]);
+
+            _mm256_storeu_ps(out.min.pX + i, _mm256_sub_ps(cx, ex));
+            _mm256_storeu_ps(out.min.pY + i, _mm256_sub_ps(cy, ey));
+            _mm256_storeu_ps(out.min.pZ + i, _mm256_sub_ps(cz, ez));
+            _mm256_storeu_ps(out.max.pX + i, _mm256_add_ps(cx, ex));
+            _mm256_storeu_ps(out.max.pY + i, _mm256_add_ps(cy, ey));
+            _mm256_storeu_ps(out.max.pZ + i, _mm256_add_ps(cz, ez));
+        }
+
+        return i;
+    }
+
+    // Two rows per register: each 128 bit lane works on its own row against the same matrix row.
+    SANDBOX_TARGET_AVX2 size_t MultiplyMatricesAvx2(
+        const float * pIn,
+        const float * matrix,
+        float * pOut,
+        size_t begin,
+        size_t count)
+    {
+        const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix));
+        const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 4));
+        const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 8));
+        const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 12));
+
+        for (size_t i = begin; i < count; ++i)
+        {
+            const float * a = pIn + i * 16;
+            __m256 rows[2];
+
+            for (int half = 0; half < 2; ++half)
+            {
+                const __m256 r = _mm256_loadu_ps(a + half * 8);
+
+                rows[half] = _mm256_add_ps(
+                    _mm256_add_ps(
+                        _mm256_add_ps(
+                            _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(0, 0, 0, 0)), b0),
+                            _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(1, 1, 1, 1)), b1)),
+                        _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(2, 2, 2, 2)), b2)),
+                    _mm256_mul_ps(_mm256_permute_ps(r, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+            }
+
+            _mm256_storeu_ps(pOut + i * 16, rows[0]);
+            _mm256_storeu_ps(pOut + i * 16 + 8, rows[1]);
+        }
+
+        return count;
+    }
+#endif
+}
+
+void TransformKernels::TransformPoints(
+    const float matrix[16],
+    const soa_vectors_t& points,
+    const soa_vectors_t& out,
+    size_t count)
+{
+    size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+    if (GHasAvx2)
+    {
+        done = TransformPointsAvx2(matrix, points, out, done, count);
+    }
+#endif
+
+#ifdef SANDBOX_SSE2
+    done = TransformPointsSse2(matrix, points, out, done, count);
+#endif
+
+    TransformPointsScalar(matrix, points, out, done, count);
+}
+
+void TransformKernels::TransformVectors(
+    const float matrix[16],
+    const soa_vectors_t& vectors,
+    const soa_vectors_t& out,
+    size_t count)
+{
+    size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+    if (GHasAvx2)
+    {
+        done = TransformVectorsAvx2(matrix, vectors, out, false, done, count);
+    }
+#endif
+
+#ifdef SANDBOX_SSE2
+    done = TransformVectorsSse2(matrix, vectors, out, false, done, count);
+#endif
+
+    TransformVectorsScalar(matrix, vectors, out, false, done, count);
+}
+
+void TransformKernels::TransformNormals(
+    const float matrix[16],
+    const soa_vectors_t& normals,
+    const soa_vectors_t& out,
+    size_t count)
+{
+    size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+    if (GHasAvx2)
+    {
+        done = TransformVectorsAvx2(matrix, normals, out, true, done, count);
+    }
+#endif
+
+#ifdef SANDBOX_SSE2
+    done = TransformVectorsSse2(matrix, normals, out, true, done, count);
+#endif
+
+    TransformVectorsScalar(matrix, normals, out, true, done, count);
+}
+
+void TransformKernels::TransformAabbs(
+    const float matrix[16],
+    const soa_aabbs_t& boxes,
+    const soa_aabbs_t& out,
+    size_t count)
+{
+    size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+    if (GHasAvx2)
+    {
+        done = TransformAabbsAvx2(matrix, boxes, out, done, count);
+    }
+#endif
+
+#ifdef SANDBOX_SSE2
+    done = TransformAabbsSse2(matrix, boxes, out, done, count);
+#endif
+
+    TransformAabbsScalar(matrix, boxes, out, done, count);
+}
+
+void TransformKernels::TransformSpheres(
+    const float matrix[16],
+    const soa_spheres_t& spheres,
+    const soa_spheres_t& out,
+    size_t count)
+{
+    TransformPoints(matrix, spheres.center, out.center, count);
+
+    // Every sphere grows by the same factor, a loop the compiler vectorizes by itself.
+    const float scale = BoundingVolumes::MaxScale(matrix);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        out.pRadius[i] = spheres.pRadius[i] * scale;
+    }
+}
+
+void TransformKernels::MultiplyMatrices(const float * pMatrices, const float matrix[16], float * pOut, size_t count)
+{
+    size_t done = 0;
+
+#ifdef SANDBOX_AVX2
+    if (GHasAvx2)
+    {
+        done = MultiplyMatricesAvx2(pMatrices, matrix, pOut, done, count);
+    }
+#endif
+
+#ifdef SANDBOX_SSE2
+    done = MultiplyMatricesSse2(pMatrices, matrix, pOut, done, count);
+#endif
+
+    MultiplyMatricesScalar(pMatrices, matrix, pOut, done, count);
+}
+
+void TransformKernels::GatherPoints(const float * pPoints, size_t count, size_t stride, const soa_vectors_t& out)
+{
+    const char * pBytes = reinterpret_cast<const char *>(pPoints);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float * p = reinterpret_cast<const float *>(pBytes + i * stride);
+
+        out.pX[i] = p[0];
+        out.pY[i] = p[1];
+        out.pZ[i] = p[2];
+    }
+}
+
+void TransformKernels::ScatterPoints(const soa_vectors_t& points, size_t count, float * pPoints, size_t stride)
+{
+    char * pBytes = reinterpret_cast<char *>(pPoints);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float * p = reinterpret_cast<float *>(pBytes + i * stride);
+
+        p[0] = points.pX[i];
+        p[1] = points.pY[i];
+        p[2] = points.pZ[i];
+    }
+}
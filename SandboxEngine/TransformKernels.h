@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>     // size_t
+
+/**
+ * \brief Three parallel float arrays holding the x, y and z components of a list of points or vectors (SoA).
+ */
+struct soa_vectors_t
+{
+    float * pX;
+    float * pY;
+    float * pZ;
+};
+
+/**
+ * \brief Axis aligned boxes stored as parallel arrays of their min and max corners.
+ */
+struct soa_aabbs_t
+{
+    soa_vectors_t min;
+    soa_vectors_t max;
+};
+
+/**
+ * \brief Bounding spheres stored as parallel arrays of their centers and radii.
+ */
+struct soa_spheres_t
+{
+    soa_vectors_t center;
+    float * pRadius;
+};
+
+/**
+ * \brief Transforms whole arrays of points, normals, bounds and matrices by one matrix.
+ *
+ * These are for loops over many objects (culling, skinning, instancing, refitting bounds), where transforming one
+ * SimpleMath::Vector3 at a time leaves most of each SIMD register unused. Inputs are structure of arrays, so eight
+ * (AVX2) or four (SSE2) elements go through the matrix at once, with a scalar loop for the rest. Every path does the
+ * same operations in the same order and gives bit identical results.
+ *
+ * Matrices are 4x4 row major with row vectors, the same layout as DirectX::SimpleMath::Matrix (pass &matrix._11).
+ * Outputs may be the same arrays as the inputs, but must not otherwise overlap them.
+ */
+namespace TransformKernels
+{
+    // Points, including the matrix translation.
+    void TransformPoints(const float matrix[16], const soa_vectors_t& points, const soa_vectors_t& out, size_t count);
+
+    // Directions through the upper 3x3 of the matrix, without translation.
+    void TransformVectors(
+        const float matrix[16],
+        const soa_vectors_t& vectors,
+        const soa_vectors_t& out,
+        size_t count);
+
+    // Directions through the upper 3x3 of the matrix and normalized. Pass the inverse transpose of the world matrix
+    // if it has non uniform scale. Zero length results stay zero.
+    void TransformNormals(
+        const float matrix[16],
+        const soa_vectors_t& normals,
+        const soa_vectors_t& out,
+        size_t count);
+
+    // Bounding boxes of the transformed boxes. The same boxes as BoundingVolumes::TransformAabb up to rounding.
+    void TransformAabbs(const float matrix[16], const soa_aabbs_t& boxes, const soa_aabbs_t& out, size_t count);
+
+    // The same as BoundingVolumes::TransformSphere on each sphere.
+    void TransformSpheres(const float matrix[16], const soa_spheres_t& spheres, const soa_spheres_t& out, size_t count);
+
+    // pOut[i] = pMatrices[i] * matrix for count consecutive matrices of 16 floats, for example every object's world
+    // matrix times the camera's view-projection. The output may be the same array as the input.
+    void MultiplyMatrices(const float * pMatrices, const float matrix[16], float * pOut, size_t count);
+
+    // Copy count points, read as three consecutive floats every stride bytes, into SoA arrays and back.
+    void GatherPoints(const float * pPoints, size_t count, size_t stride, const soa_vectors_t& out);
+    void ScatterPoints(const soa_vectors_t& points, size_t count, float * pPoints, size_t stride);
+}
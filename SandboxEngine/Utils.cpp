@@ -1,98 +1,39 @@
 #include "stdafx.h"
 #include "Utils.h"
 #include "DXTestException.h"
+#include "TextEncoding.h"
+#include "TextUtils.h"
 
-#include <algorithm>        // string trimming
-#include <cctype>           // string trimming
-#include <functional>       // string trimming
+#include <cstring>     // strerror_r
 
 using namespace Utils;
 
-// http://stackoverflow.com/a/6691829
-//  TODO: Test MB_ERR_INVALID_CHARS failure
-std::wstring Utils::ConvertUtf8ToWString(const std::string& input)
+#ifndef _WIN32
+namespace
 {
-	// Deal with the trivial case of being passed an empty string.
-	if (input.empty())
-	{
-		return std::wstring();
-	}
-
-	// Determine the length required to hold the converted wstring.
-    int requiredLength = ::MultiByteToWideChar(
-        CP_UTF8,
-        MB_ERR_INVALID_CHARS,
-        input.c_str(),
-        static_cast<int>(input.length() * sizeof(char)),
-        0,
-        0);
-
-    if (requiredLength == 0)
+    // strerror_r returns an int and fills the buffer (XSI) or returns the message (GNU) depending on the C library.
+    inline const char * StrErrorResult(int result, const char * pBuffer)
     {
-        throw WindowsApiException(GetLastError(), L"ConvertUtf8ToWString - first pass");
+        return result == 0 ? pBuffer : nullptr;
     }
 
-	// Presize an empty wstring and convert the UTF8 string to wstring in place.
-	std::wstring output(requiredLength, L'\0');
-	int result = ::MultiByteToWideChar(
-        CP_UTF8,
-        MB_ERR_INVALID_CHARS,
-        input.c_str(),
-        static_cast<int>(input.length()),
-        &output[0],
-        static_cast<int>(output.length()));
-
-    if (result == 0)
+    inline const char * StrErrorResult(const char * pResult, const char *)
     {
-        throw WindowsApiException(GetLastError(), L"ConvertUtf8ToWString - second pass");
+        return pResult;
     }
+}
+#endif
 
-	return output;
+// Throws TextEncodingException if the input is not valid UTF-8.
+std::wstring Utils::ConvertUtf8ToWString(const std::string& input)
+{
+    return TextEncoding::Utf8ToWide(input);
 }
 
-// TODO: Test MB_ERR_INVALID_CHARS and WC_NO_BEST_FIT_CHARS (look at docs)
+// Throws TextEncodingException on unpaired surrogates.
 std::string Utils::ConvertUtf16ToUtf8(const std::wstring& input)
 {
-    // Deal with the trivial case of being passed an empty string.
-    if (input.empty())
-    {
-        return std::string();
-    }
-
-    // Determine the length required to hold the converted string.
-    int requiredLength = ::WideCharToMultiByte(
-        CP_UTF8,
-        WC_ERR_INVALID_CHARS,
-        input.c_str(),
-        static_cast<int>(input.length()),
-        0,          // pointer to buffer that receives the converted string.
-        0,          // size in bytes of the buffer above.
-        nullptr,    // default character if converted char cannot be represented (must be null for UTF8).
-        nullptr);   // pointer to flag that indicates default character used. (must be null for UTF8).
-
-    if (requiredLength == 0)
-    {
-        throw WindowsApiException(GetLastError(), L"ConvertUtf16ToUtf8 - first pass");
-    }
-
-    // Presize an empty string and convert the wide string to a UTF8 string in place.
-    std::string output(requiredLength, '\0');
-    int result = ::WideCharToMultiByte(
-        CP_UTF8,
-        WC_ERR_INVALID_CHARS,
-        input.c_str(),                                      // wide string pointer.
-        static_cast<int>(input.length()),                   // wide string length in characters.
-        &output[0],                                         // narrow output string pointer.
-        static_cast<int>(output.length() * sizeof(char)),   // narrow output string length in bytes.
-        nullptr,                                            // default character for invalid converted chars.
-        nullptr);                                           // pointer to flag that is set if default char is used.
-
-    if (result == 0)
-    {
-        throw WindowsApiException(GetLastError(), L"ConvertUtf16ToUtf8 - second pass");
-    }
-
-    return output;
+    return TextEncoding::WideToUtf8(input);
 }
 
 // Code for this method: http://stackoverflow.com/a/455533/1922926
@@ -105,6 +46,7 @@ std::wstring Utils::GetErrorMessageFromHResult(unsigned long errorCode)
 ///
 std::wstring Utils::GetErrorMessageFromWinApiErrorCode(unsigned long windowsApiErrorCode)
 {
+#ifdef _WIN32
     LPTSTR errorText = nullptr;
     std::wstring output;
 
@@ -139,10 +81,15 @@ std::wstring Utils::GetErrorMessageFromWinApiErrorCode(unsigned long windowsApiE
     }
 
     return output;
+#else
+    // There are no system message tables to look the code up in.
+    return MakeWideString() << L"Windows API error " << windowsApiErrorCode;
+#endif
 }
 
 std::wstring Utils::GetErrorMessageFromErrno(errno_t errorCode)
 {
+#ifdef _WIN32
     const size_t MaxBufferSize = 1024;
     std::wstring output(MaxBufferSize, L'\0');
 
@@ -157,101 +104,69 @@ std::wstring Utils::GetErrorMessageFromErrno(errno_t errorCode)
         output.resize(output.find_first_of(L'\0'));
         return output;
     }
-}
+#else
+    char buffer[1024] = { 0 };
+    const char * pMessage = StrErrorResult(strerror_r(errorCode, buffer, sizeof(buffer)), buffer);
 
-bool Utils::StartsWith(const std::string& fullString, const std::string& prefix)
-{
-    bool result = false;
-
-    if (!prefix.empty() && fullString.length() >= prefix.length())
+    if (pMessage == nullptr)
     {
-        result = (0 == fullString.compare(0, prefix.size(), prefix));
+        return L"Failed to get error code message";
     }
 
-    return result;
+    return MakeWideString() << pMessage;
+#endif
 }
 
-bool Utils::StartsWith(const std::wstring& fullString, const std::wstring& prefix)
+// Unlike TextUtils::StartsWith and EndsWith an empty prefix or ending never matches.
+bool Utils::StartsWith(StringView fullString, StringView prefix)
 {
-    bool result = false;
-
-    if (!prefix.empty() && fullString.length() >= prefix.length())
-    {
-        result = (0 == fullString.compare(0, prefix.size(), prefix));
-    }
-
-    return result;
+    return !prefix.IsEmpty() && TextUtils::StartsWith(fullString, prefix);
 }
 
-// http://stackoverflow.com/a/874160
-bool Utils::EndsWith(const std::string& fullString, const std::string& ending)
+bool Utils::StartsWith(WideStringView fullString, WideStringView prefix)
 {
-    bool result = false;
-
-    if (!ending.empty() && fullString.length() >= ending.length())
-    {
-        result = (0 == fullString.compare(fullString.length() - ending.length(), ending.length(), ending));
-    }
-
-    return result;
+    return !prefix.IsEmpty() && TextUtils::StartsWith(fullString, prefix);
 }
 
-// http://stackoverflow.com/a/874160
-bool Utils::EndsWith(const std::wstring& fullString, const std::wstring& ending)
+bool Utils::EndsWith(StringView fullString, StringView ending)
 {
-    bool result = false;
-
-    if (!ending.empty() && fullString.length() >= ending.length())
-    {
-        result = (0 == fullString.compare(fullString.length() - ending.length(), ending.length(), ending));
-    }
+    return !ending.IsEmpty() && TextUtils::EndsWith(fullString, ending);
+}
 
-    return result;
+bool Utils::EndsWith(WideStringView fullString, WideStringView ending)
+{
+    return !ending.IsEmpty() && TextUtils::EndsWith(fullString, ending);
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-// string trimming functions
-// [+29] [2009-01-22 16:00:07] Evan Teran 
-// http://www.stackprinter.com/export?service=stackoverflow&question=469696
-///////////////////////////////////////////////////////////////////////////////////////////////////
+// Trimming works on views and copies once, see TextUtils.h to avoid even that copy.
 std::string Utils::RightTrim(const std::string& text)
 {
-    std::string s(text);
-    s.erase(std::find_if(s.rbegin(), s.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
-    return s;
+    return TextUtils::TrimRight(text).ToString();
 }
 
 std::wstring Utils::RightTrim(const std::wstring& text)
 {
-    std::wstring s(text);
-    s.erase(std::find_if(s.rbegin(), s.rend(), std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
-    return s;
+    return TextUtils::TrimRight(text).ToString();
 }
 
 std::string Utils::LeftTrim(const std::string& text)
 {
-    std::string s(text);
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
-    return s;
+    return TextUtils::TrimLeft(text).ToString();
 }
 
 std::wstring Utils::LeftTrim(const std::wstring& text)
 {
-    std::wstring s(text);
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), std::not1(std::ptr_fun<int, int>(std::isspace))));
-    return s;
+    return TextUtils::TrimLeft(text).ToString();
 }
 
 std::string Utils::Trim(const std::string& text)
 {
-    std::string s(text);
-    return LeftTrim(RightTrim(s));
+    return TextUtils::Trim(text).ToString();
 }
 
 std::wstring Utils::Trim(const std::wstring& text)
 {
-    std::wstring s(text);
-    return LeftTrim(RightTrim(s));
+    return TextUtils::Trim(text).ToString();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -266,7 +181,7 @@ float Utils::RandFloat()
 float Utils::RandFloat(float min, float max)
 {
     float random = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-    float difference = min - max;
+    float difference = max - min;
     float r = random * difference;
 
     return min + r;
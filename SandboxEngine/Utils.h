@@ -1,6 +1,8 @@
 #pragma once
+#include "Platform.h"       // errno_t
+#include "StringView.h"
+#include "TextFormat.h"      // MakeString
 #include <string>
-#include <sstream>          // MakeString
 #include <vector>           // WinStringBuffer
 
 namespace Utils
@@ -12,10 +14,10 @@ namespace Utils
     std::wstring GetErrorMessageFromWinApiErrorCode(unsigned long windowsApiErrorCode);
     std::wstring GetErrorMessageFromErrno(errno_t errorCode);
 
-    bool StartsWith(const std::string& fullString, const std::string& prefix);
-    bool StartsWith(const std::wstring& fullString, const std::wstring& prefix);
-    bool EndsWith(const std::string& fullString, const std::string& ending);
-    bool EndsWith(const std::wstring& fullString, const std::wstring& ending);
+    bool StartsWith(StringView fullString, StringView prefix);
+    bool StartsWith(WideStringView fullString, WideStringView prefix);
+    bool EndsWith(StringView fullString, StringView ending);
+    bool EndsWith(WideStringView fullString, WideStringView ending);
 
     std::string RightTrim(const std::string &text);
     std::wstring RightTrim(const std::wstring &text);
@@ -30,46 +32,11 @@ namespace Utils
     // http://www.stackprinter.com/export?service=stackoverflow&question=469696
     //
     //  - Allows you to compose strings inline and then pass the resultant temporary string object
-    //    to a function.
+    //    to a function. Formats into a stack buffer without streams, see TextFormat.h.
     //    EXAMPLE: f( MakeString() << "foo" << 42 );
     ///////////////////////////////////////////////////////////////////////////////////////////////////
-    class MakeString
-    {
-    public:
-        template <typename T>
-        MakeString& operator<<(const T& value)
-        {
-            mBuffer << value;
-            return *this;
-        }
-
-        operator std::string() const
-        {
-            return mBuffer.str();
-        }
-
-    private:
-        std::ostringstream mBuffer;
-    };
-
-    class MakeWideString
-    {
-    public:
-        template <typename T>
-        MakeWideString& operator<<(const T& value)
-        {
-            mBuffer << value;
-            return *this;
-        }
-
-        operator std::wstring() const
-        {
-            return mBuffer.str();
-        }
-
-    private:
-        std::wostringstream mBuffer;
-    };
+    typedef FormatBuffer MakeString;
+    typedef WideFormatBuffer MakeWideString;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////
     // String buffer for a Win32 API that wants to write into a c string array.
@@ -129,13 +96,15 @@ namespace Utils
     }
 
     /**
-     * \brief Generate a random floating point value between [0.0, 1.0].
+     * \brief Generate a random floating point value between [0.0, 1.0] using rand().
+     *
+     * Shares the C runtime's global state, so these are neither fast nor thread safe. Prefer a Random
+     * (see Random.h) for anything that runs often or off the main thread.
      */
     float RandFloat();
 
     /**
-     * \brief Generate a random floating point value between [min, max].
-     * TODO: Prove that values are inclusive.
+     * \brief Generate a random floating point value between [min, max] using rand().
      */
     float RandFloat(float min, float max);
 }
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "stdafx.h"
+#include "VertexCompression.h"
+#include "MeshData.h"
+#include "DXSandbox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>      // memcpy
+#include <limits>
+
+namespace
+{
+    const float UNORM16_MAX = 65535.0f;
+    const float SNORM16_MAX = 32767.0f;
+
+    float SignNotZero(float value)
+    {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+    unsigned short QuantizeUnorm16(float value)
+    {
+        value = std::min(std::max(value, 0.0f), 1.0f);
+        return static_cast<unsigned short>(value * UNORM16_MAX + 0.5f);
+    }
+
+    short ClampSnorm16(float value)
+    {
+        value = std::min(std::max(value, -SNORM16_MAX), SNORM16_MAX);
+        return static_cast<short>(value);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Half floats
+///////////////////////////////////////////////////////////////////////////////////////////////////
+unsigned short VertexCompression::FloatToHalf(float value)
+{
+    unsigned int bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000u;
+    unsigned int exponent = (bits >> 23) & 0xFFu;
+    unsigned int mantissa = bits & 0x7FFFFFu;
+
+    // Infinity and NaN. Keep NaN a (quiet) NaN.
+    if (exponent == 0xFFu)
+    {
+        return static_cast<unsigned short>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u));
+    }
+
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+
+    // Too large for a half, round to infinity.
+    if (halfExponent >= 0x1F)
+    {
+        return static_cast<unsigned short>(sign | 0x7C00u);
+    }
+
+    // Too small for a normal half. Either flush to zero or produce a subnormal.
+    if (halfExponent <= 0)
+    {
+        if (halfExponent < -10)
+        {
+            return static_cast<unsigned short>(sign);
+        }
+
+        mantissa |= 0x800000u;      // implicit leading one.
+
+        unsigned int shift = static_cast<unsigned int>(14 - halfExponent);
+        unsigned int halfMantissa = mantissa >> shift;
+        unsigned int remainder = mantissa & ((1u << shift) - 1u);
+        unsigned int halfway = 1u << (shift - 1u);
+
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u) != 0))
+        {
+            ++halfMantissa;
+        }
+
+        return static_cast<unsigned short>(sign | halfMantissa);
+    }
+
+    // Normal half. Rounding may carry into the exponent which correctly produces the next power of two (or infinity).
+    unsigned int halfBits = (static_cast<unsigned int>(halfExponent) << 10) | (mantissa >> 13);
+    unsigned int remainder = mantissa & 0x1FFFu;
+
+    if (remainder > 0x1000u || (remainder == 0x1000u && (halfBits & 1u) != 0))
+    {
+        ++halfBits;
+    }
+
+    return static_cast<unsigned short>(sign | halfBits);
+}
+
+float VertexCompression::HalfToFloat(unsigned short value)
+{
+    unsigned int sign = (static_cast<unsigned int>(value) & 0x8000u) << 16;
+    unsigned int exponent = (value >> 10) & 0x1Fu;
+    unsigned int mantissa = value & 0x3FFu;
+    unsigned int bits = 0;
+
+    if (exponent == 0)
+    {
+        // Zero or subnormal, value is mantissa * 2^-24.
+        float result = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return (sign != 0) ? -result : result;
+    }
+    else if (exponent == 0x1Fu)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+
+    float result = 0.0f;
+    memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Octahedral normals
+// "A Survey of Efficient Representations for Independent Unit Vectors", Cigolle et al. 2014
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void VertexCompression::EncodeOctahedralNormal(float nx, float ny, float nz, short *pOutX, short *pOutY)
+{
+    AssertNotNull(pOutX);
+    AssertNotNull(pOutY);
+
+    float l1Length = std::fabs(nx) + std::fabs(ny) + std::fabs(nz);
+
+    // Degenerate normals encode to (0, 0) which decodes to +z.
+    if (l1Length <= 0.0f)
+    {
+        *pOutX = 0;
+        *pOutY = 0;
+        return;
+    }
+
+    // Project onto the octahedron and fold the lower hemisphere over the upper one.
+    float u = nx / l1Length;
+    float v = ny / l1Length;
+
+    if (nz < 0.0f)
+    {
+        float foldedU = (1.0f - std::fabs(v)) * SignNotZero(u);
+        float foldedV = (1.0f - std::fabs(u)) * SignNotZero(v);
+
+        u = foldedU;
+        v = foldedV;
+    }
+
+    // Pick the closest of the four encodings surrounding the projected point.
+    float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    float baseU = std::floor(u * SNORM16_MAX);
+    float baseV = std::floor(v * SNORM16_MAX);
+    float bestDot = -std::numeric_limits<float>::max();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        short candidateX = ClampSnorm16(baseU + static_cast<float>(i & 1));
+        short candidateY = ClampSnorm16(baseV + static_cast<float>(i >> 1));
+
+        float decoded[3];
+        DecodeOctahedralNormal(candidateX, candidateY, decoded);
+
+        float dot = (decoded[0] * nx + decoded[1] * ny + decoded[2] * nz) / length;
+
+        if (dot > bestDot)
+        {
+            bestDot = dot;
+            *pOutX = candidateX;
+            *pOutY = candidateY;
+        }
+    }
+}
+
+void VertexCompression::DecodeOctahedralNormal(short x, short y, float *pNormalOut)
+{
+    AssertNotNull(pNormalOut);
+
+    // Matches the R16G16_SNORM hardware conversion, where -32768 and -32767 both map to -1.
+    float u = std::max(static_cast<float>(x) / SNORM16_MAX, -1.0f);
+    float v = std::max(static_cast<float>(y) / SNORM16_MAX, -1.0f);
+    float z = 1.0f - std::fabs(u) - std::fabs(v);
+
+    // Unfold the lower hemisphere.
+    float t = std::max(-z, 0.0f);
+
+    u += (u >= 0.0f) ? -t : t;
+    v += (v >= 0.0f) ? -t : t;
+
+    float length = std::sqrt(u * u + v * v + z * z);
+
+    pNormalOut[0] = u / length;
+    pNormalOut[1] = v / length;
+    pNormalOut[2] = z / length;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Positions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+position_quantization_t VertexCompression::ComputePositionQuantization(const s_mesh_data_t& mesh)
+{
+    position_quantization_t quantization = { { 0.0f, 0.0f, 0.0f }, 1.0f };
+
+    if (mesh.vertices.empty())
+    {
+        return quantization;
+    }
+
+    float minimum[3] = { mesh.vertices[0].x, mesh.vertices[0].y, mesh.vertices[0].z };
+    float maximum[3] = { mesh.vertices[0].x, mesh.vertices[0].y, mesh.vertices[0].z };
+
+    for (const s_mesh_vertex_t& vertex : mesh.vertices)
+    {
+        minimum[0] = std::min(minimum[0], vertex.x);
+        minimum[1] = std::min(minimum[1], vertex.y);
+        minimum[2] = std::min(minimum[2], vertex.z);
+
+        maximum[0] = std::max(maximum[0], vertex.x);
+        maximum[1] = std::max(maximum[1], vertex.y);
+        maximum[2] = std::max(maximum[2], vertex.z);
+    }
+
+    float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+
+    quantization.offset[0] = minimum[0];
+    quantization.offset[1] = minimum[1];
+    quantization.offset[2] = minimum[2];
+    quantization.scale = (extent > 0.0f) ? extent : 1.0f;
+
+    return quantization;
+}
+
+float VertexCompression::MaxPositionQuantizationError(const position_quantization_t& quantization)
+{
+    // Each axis is off by at most half a quantization step.
+    float halfStep = 0.5f * quantization.scale / UNORM16_MAX;
+    return std::sqrt(3.0f) * halfStep;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vertices
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void VertexCompression::CompressVertices(
+    const s_mesh_data_t& mesh,
+    const position_quantization_t& quantization,
+    std::vector<compact_vertex_t> *pVerticesOut)
+{
+    AssertNotNull(pVerticesOut);
+
+    const float inverseScale = 1.0f / quantization.scale;
+    std::vector<compact_vertex_t>& compressed = *pVerticesOut;      // alias to reduce typing.
+
+    compressed.resize(mesh.vertices.size());
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i)
+    {
+        const s_mesh_vertex_t& source = mesh.vertices[i];
+        compact_vertex_t& target = compressed[i];
+
+        target.x = QuantizeUnorm16((source.x - quantization.offset[0]) * inverseScale);
+        target.y = QuantizeUnorm16((source.y - quantization.offset[1]) * inverseScale);
+        target.z = QuantizeUnorm16((source.z - quantization.offset[2]) * inverseScale);
+        target.w = 0;
+
+        EncodeOctahedralNormal(source.nx, source.ny, source.nz, &target.nx, &target.ny);
+
+        target.tu = FloatToHalf(source.tu);
+        target.tv = FloatToHalf(source.tv);
+    }
+}
+
+void VertexCompression::DecompressVertex(
+    const compact_vertex_t& vertex,
+    const position_quantization_t& quantization,
+    s_mesh_vertex_t *pVertexOut)
+{
+    AssertNotNull(pVertexOut);
+
+    pVertexOut->x = quantization.offset[0] + (static_cast<float>(vertex.x) / UNORM16_MAX) * quantization.scale;
+    pVertexOut->y = quantization.offset[1] + (static_cast<float>(vertex.y) / UNORM16_MAX) * quantization.scale;
+    pVertexOut->z = quantization.offset[2] + (static_cast<float>(vertex.z) / UNORM16_MAX) * quantization.scale;
+
+    float normal[3];
+    DecodeOctahedralNormal(vertex.nx, vertex.ny, normal);
+
+    pVertexOut->nx = normal[0];
+    pVertexOut->ny = normal[1];
+    pVertexOut->nz = normal[2];
+
+    pVertexOut->tu = HalfToFloat(vertex.tu);
+    pVertexOut->tv = HalfToFloat(vertex.tv);
+}
+
+vertex_compression_error_t VertexCompression::MeasureCompressionError(
+    const s_mesh_data_t& mesh,
+    const std::vector<compact_vertex_t>& compressedVertices,
+    const position_quantization_t& quantization)
+{
+    Verify(mesh.vertices.size() == compressedVertices.size());
+    vertex_compression_error_t error = { 0.0f, 0.0f, 0.0f };
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i)
+    {
+        const s_mesh_vertex_t& expected = mesh.vertices[i];
+        s_mesh_vertex_t actual;
+
+        DecompressVertex(compressedVertices[i], quantization, &actual);
+
+        // Position distance.
+        float dx = expected.x - actual.x;
+        float dy = expected.y - actual.y;
+        float dz = expected.z - actual.z;
+
+        error.maxPositionError = std::max(error.maxPositionError, std::sqrt(dx * dx + dy * dy + dz * dz));
+
+        // Angle between normals, using atan2 in double precision because acos is too imprecise for tiny angles. Skip
+        // degenerate source normals since they have no direction to preserve.
+        double ex = expected.nx, ey = expected.ny, ez = expected.nz;
+        double ax = actual.nx, ay = actual.ny, az = actual.nz;
+
+        if (ex != 0.0 || ey != 0.0 || ez != 0.0)
+        {
+            double cx = ey * az - ez * ay;
+            double cy = ez * ax - ex * az;
+            double cz = ex * ay - ey * ax;
+            double dot = ex * ax + ey * ay + ez * az;
+            double angle = std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * (180.0 / 3.14159265358979323846);
+
+            error.maxNormalErrorDegrees = std::max(error.maxNormalErrorDegrees, static_cast<float>(angle));
+        }
+
+        // Texture coordinates.
+        error.maxTexCoordError = std::max(error.maxTexCoordError, std::fabs(expected.tu - actual.tu));
+        error.maxTexCoordError = std::max(error.maxTexCoordError, std::fabs(expected.tv - actual.tv));
+    }
+
+    return error;
+}
+
+bool VertexCompression::CanUse16BitIndices(size_t vertexCount)
+{
+    // Triangle lists have no strip cut index so the full 16 bit range is usable.
+    return vertexCount <= 65536u;
+}
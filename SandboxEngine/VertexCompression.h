@@ -0,0 +1,85 @@
+#pragma once
+#include "MeshData.h"
+#include <vector>
+#include <cstddef>     // size_t
+
+/**
+ * \brief Vertex layouts a mesh can be uploaded to the GPU with.
+ */
+enum class VertexFormat
+{
+    Full,       // 32 bytes: float3 position, float2 texture coordinate, float3 normal.
+    Compact     // 16 bytes: see compact_vertex_t.
+};
+
+/**
+ * \brief Compressed vertex, half the size of the full float vertex.
+ *
+ * Positions are quantized to 16 bit unorm against the mesh bounds (R16G16B16A16_UNORM, w unused), texture
+ * coordinates are half floats (R16G16_FLOAT) and normals are stored with a 2x16 bit snorm octahedral encoding
+ * (R16G16_SNORM). Elements are in the same order as the full vertex.
+ */
+struct compact_vertex_t
+{
+    unsigned short x, y, z, w;
+    unsigned short tu, tv;
+    short nx, ny;
+};
+
+/**
+ * \brief Maps quantized [0, 1] positions back to model space with position = offset + quantized * scale.
+ *
+ * The same scale is used for all three axes so that dequantization can be folded into the world matrix without
+ * distorting normals.
+ */
+struct position_quantization_t
+{
+    float offset[3];
+    float scale;
+};
+
+/**
+ * \brief Largest round trip error found when comparing a compressed mesh against its source.
+ */
+struct vertex_compression_error_t
+{
+    float maxPositionError;         // Euclidean distance in model space units.
+    float maxNormalErrorDegrees;    // Angle between source and decoded normal.
+    float maxTexCoordError;         // Largest absolute error of any texture coordinate component.
+};
+
+namespace VertexCompression
+{
+    // Convert a 32 bit float to an IEEE 754 half float, rounding to nearest even.
+    unsigned short FloatToHalf(float value);
+    float HalfToFloat(unsigned short value);
+
+    // Encode a unit normal into two snorm16 octahedral coordinates. Of the four nearest encodings the one that
+    // decodes closest to the input is picked.
+    void EncodeOctahedralNormal(float nx, float ny, float nz, short *pOutX, short *pOutY);
+    void DecodeOctahedralNormal(short x, short y, float *pNormalOut);
+
+    // Compute the quantization range that covers every vertex in the mesh.
+    position_quantization_t ComputePositionQuantization(const s_mesh_data_t& mesh);
+
+    // Largest position error quantization can introduce for the given range (half a step along each axis).
+    float MaxPositionQuantizationError(const position_quantization_t& quantization);
+
+    void CompressVertices(
+        const s_mesh_data_t& mesh,
+        const position_quantization_t& quantization,
+        std::vector<compact_vertex_t> *pVerticesOut);
+
+    void DecompressVertex(
+        const compact_vertex_t& vertex,
+        const position_quantization_t& quantization,
+        s_mesh_vertex_t *pVertexOut);
+
+    vertex_compression_error_t MeasureCompressionError(
+        const s_mesh_data_t& mesh,
+        const std::vector<compact_vertex_t>& compressedVertices,
+        const position_quantization_t& quantization);
+
+    // Check if every index of a mesh with this many vertices fits in a 16 bit index buffer.
+    bool CanUse16BitIndices(size_t vertexCount);
+}
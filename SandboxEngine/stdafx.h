@@ -5,16 +5,19 @@
 
 #pragma once
 
+#ifdef _WIN32
 #include "targetver.h"
 
 // Windows headers.
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+#define NOMINMAX                        // std::min, std::max and numeric_limits<T>::max() instead of macros
 
 #include <Windows.h>
+#endif
 
 
 // STL headers.
 #include <string>
 
 // Common project headers.
-#include "SimpleMath.h"
\ No newline at end of file
+#include "MathTypes.h"      // SimpleMath, or PortableMath off Windows
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "stdafx.h"
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<unsigned long long> GAllocationCount(0);
+}
+
+unsigned long long AllocationCounter::Count()
+{
+    return GAllocationCount;
+}
+
+// Array and nothrow forms call these, so replacing the two plain forms covers every allocation.
+void * operator new(size_t size)
+{
+    GAllocationCount++;
+
+    void * pMemory = std::malloc(size > 0 ? size : 1);
+
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return pMemory;
+}
+
+void operator delete(void * pMemory)
+{
+    std::free(pMemory);
+}
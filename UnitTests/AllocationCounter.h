@@ -0,0 +1,12 @@
+#pragma once
+
+/**
+ * \brief Counts heap allocations made by the test binary.
+ *
+ * The unit test module replaces the global operator new, so every allocation made by the tests and the engine code
+ * they call is counted. Tests take the count before and after the code under test to check that it did not allocate.
+ */
+namespace AllocationCounter
+{
+    unsigned long long Count();
+}
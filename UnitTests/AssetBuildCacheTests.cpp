@@ -0,0 +1,251 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "AssetBuildCache.h"
+#include "BinaryBlob.h"
+#include "DXTestException.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(AssetBuildCacheTests)
+    {
+    private:
+        static const wchar_t * CacheDirectory() { return L"AssetBuildCacheTests_cache"; }
+
+        std::vector<std::wstring> mFiles;
+        std::atomic<int> mConvertCount;
+
+        static void WriteFile(const std::wstring& filepath, const std::string& contents)
+        {
+            std::ofstream stream(std::string(filepath.begin(), filepath.end()).c_str(), std::ios::binary);
+            stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }
+
+        static std::string ReadFile(const std::wstring& filepath)
+        {
+            BinaryBlob blob = BinaryBlob::LoadFromFile(filepath);
+            return std::string(blob.BufferPointer(), static_cast<size_t>(blob.BufferSize()));
+        }
+
+        std::wstring Input(int index, const std::string& contents)
+        {
+            std::wstring filepath = L"AssetBuildCacheTests_input" + std::to_wstring(index) + L".txt";
+            WriteFile(filepath, contents);
+            mFiles.push_back(filepath);
+
+            return filepath;
+        }
+
+        std::wstring Output(int index)
+        {
+            std::wstring filepath = L"AssetBuildCacheTests_output" + std::to_wstring(index) + L".bin";
+            mFiles.push_back(filepath);
+
+            return filepath;
+        }
+
+        // Upper cases the concatenated inputs, counting how often it runs.
+        asset_build_step_t Step(const std::vector<std::wstring>& inputs, const std::wstring& output)
+        {
+            asset_build_step_t step;
+            step.output = output;
+            step.inputs = inputs;
+            step.tool = "upper";
+            step.toolVersion = 1;
+            step.convert = [this](const std::vector<BinaryBlob>& blobs, std::vector<char> *pOutput) {
+                mConvertCount++;
+
+                for (const BinaryBlob& blob : blobs)
+                {
+                    for (std::streamsize i = 0; i < blob.BufferSize(); ++i)
+                    {
+                        char c = blob.BufferPointer()[i];
+                        pOutput->push_back(c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c);
+                    }
+                }
+            };
+
+            return step;
+        }
+
+        std::vector<asset_build_step_t> MakeSteps(unsigned int count)
+        {
+            std::vector<asset_build_step_t> steps;
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                std::vector<std::wstring> inputs;
+                inputs.push_back(Input(i, "input " + std::to_string(i)));
+
+                steps.push_back(Step(inputs, Output(i)));
+            }
+
+            return steps;
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(ResetCount)
+        {
+            mConvertCount = 0;
+        }
+
+        TEST_METHOD_CLEANUP(DeleteFiles)
+        {
+            AssetBuildCache(CacheDirectory()).Clear();
+
+            for (const std::wstring& filepath : mFiles)
+            {
+                std::remove(std::string(filepath.begin(), filepath.end()).c_str());
+            }
+
+            mFiles.clear();
+        }
+
+        TEST_METHOD(BuildCacheOnlyRebuildsChangedSteps)
+        {
+            std::vector<asset_build_step_t> steps = MakeSteps(8);
+
+            {
+                AssetBuildCache cache(CacheDirectory());
+                asset_build_stats_t stats = cache.Build(steps, 4);
+
+                Assert::AreEqual((size_t)8, stats.builtCount);
+                Assert::AreEqual(0.0, stats.HitRate());
+                Assert::AreEqual(std::string("INPUT 3"), ReadFile(steps[3].output));
+            }
+
+            // A new cache object reads the manifest back, so a second run does nothing.
+            AssetBuildCache cache(CacheDirectory());
+            asset_build_stats_t noop = cache.Build(steps, 4);
+
+            Assert::AreEqual((size_t)8, noop.upToDateCount);
+            Assert::AreEqual(1.0, noop.HitRate());
+            Assert::AreEqual(8, static_cast<int>(mConvertCount));
+
+            // Changing one input rebuilds only that step.
+            WriteFile(steps[5].inputs[0], "changed");
+            asset_build_stats_t changed = cache.Build(steps, 4);
+
+            Assert::AreEqual((size_t)1, changed.builtCount);
+            Assert::AreEqual((size_t)7, changed.upToDateCount);
+            Assert::AreEqual(std::string("CHANGED"), ReadFile(steps[5].output));
+
+            // Changing it back finds the earlier result in the cache.
+            WriteFile(steps[5].inputs[0], "input 5");
+            asset_build_stats_t reverted = cache.Build(steps, 4);
+
+            Assert::AreEqual((size_t)1, reverted.cacheHitCount);
+            Assert::AreEqual((size_t)0, reverted.builtCount);
+            Assert::AreEqual(std::string("INPUT 5"), ReadFile(steps[5].output));
+            Assert::AreEqual(9, static_cast<int>(mConvertCount));
+        }
+
+        TEST_METHOD(BuildCacheKeysIncludeToolVersionAndOptions)
+        {
+            std::vector<std::wstring> inputs;
+            inputs.push_back(Input(0, "abc"));
+
+            asset_build_step_t step = Step(inputs, Output(0));
+            const std::vector<unsigned long long> hashes(1, AssetBuildCache::HashBytes("abc", 3));
+            const unsigned long long key = AssetBuildCache::StepKey(step, hashes);
+
+            asset_build_step_t newerTool = step;
+            newerTool.toolVersion = 2;
+
+            asset_build_step_t otherOptions = step;
+            otherOptions.options = "lods=2";
+
+            asset_build_step_t otherTool = step;
+            otherTool.tool = "lower";
+
+            Assert::AreNotEqual(key, AssetBuildCache::StepKey(newerTool, hashes));
+            Assert::AreNotEqual(key, AssetBuildCache::StepKey(otherOptions, hashes));
+            Assert::AreNotEqual(key, AssetBuildCache::StepKey(otherTool, hashes));
+
+            const std::vector<unsigned long long> otherHashes(1, AssetBuildCache::HashBytes("abd", 3));
+            Assert::AreNotEqual(key, AssetBuildCache::StepKey(step, otherHashes));
+
+            // A version bump reruns the converter.
+            AssetBuildCache cache(CacheDirectory());
+            cache.Build(std::vector<asset_build_step_t>(1, step));
+            asset_build_stats_t stats = cache.Build(std::vector<asset_build_step_t>(1, newerTool));
+
+            Assert::AreEqual((size_t)1, stats.builtCount);
+        }
+
+        TEST_METHOD(BuildCacheRestoresDeletedOutputs)
+        {
+            std::vector<asset_build_step_t> steps = MakeSteps(4);
+            AssetBuildCache cache(CacheDirectory());
+
+            cache.Build(steps);
+
+            for (const asset_build_step_t& step : steps)
+            {
+                std::remove(std::string(step.output.begin(), step.output.end()).c_str());
+            }
+
+            asset_build_stats_t stats = cache.Build(steps);
+
+            Assert::AreEqual((size_t)4, stats.cacheHitCount);
+            Assert::AreEqual(4, static_cast<int>(mConvertCount));
+            Assert::AreEqual(std::string("INPUT 2"), ReadFile(steps[2].output));
+        }
+
+        TEST_METHOD(BuildCachePrunesUnreferencedArtifacts)
+        {
+            std::vector<asset_build_step_t> steps = MakeSteps(2);
+            AssetBuildCache cache(CacheDirectory());
+
+            cache.Build(steps);
+            WriteFile(steps[0].inputs[0], "new contents");
+            cache.Build(steps);
+
+            // The artifact built from the old contents of input 0 is no longer used.
+            Assert::AreEqual((size_t)1, cache.Prune());
+            Assert::AreEqual((size_t)0, cache.Prune());
+        }
+
+        TEST_METHOD(BuildCacheReportsConverterErrors)
+        {
+            std::vector<asset_build_step_t> steps = MakeSteps(3);
+            steps[1].convert = [](const std::vector<BinaryBlob>&, std::vector<char> *) {
+                throw SandboxException(L"Conversion failed");
+            };
+
+            std::vector<std::wstring> missing(1, L"AssetBuildCacheTests_missing.txt");
+            std::vector<asset_build_step_t> missingInput(1, Step(missing, Output(9)));
+
+            AssetBuildCache cache(CacheDirectory());
+
+            Assert::ExpectException<SandboxException>([&]() { cache.Build(steps, 1); });
+            Assert::ExpectException<FileLoadException>([&]() { cache.Build(missingInput); });
+
+            // Steps that built before the failure are kept.
+            steps.erase(steps.begin() + 1);
+            asset_build_stats_t stats = cache.Build(steps, 1);
+
+            Assert::AreEqual((size_t)1, stats.upToDateCount);
+            Assert::AreEqual((size_t)1, stats.builtCount);
+        }
+
+        TEST_METHOD(HashBytesMatchesXxHash64)
+        {
+            // Reference values from the xxHash64 specification's test program.
+            Assert::AreEqual(0xEF46DB3751D8E999ull, AssetBuildCache::HashBytes("", 0));
+            Assert::AreEqual(0x44BC2CF5AD770999ull, AssetBuildCache::HashBytes("abc", 3));
+
+            std::string longer(100, 'x');
+            Assert::AreNotEqual(
+                AssetBuildCache::HashBytes(longer.data(), longer.size()),
+                AssetBuildCache::HashBytes(longer.data(), longer.size() - 1));
+        }
+    };
+}
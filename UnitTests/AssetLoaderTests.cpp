@@ -0,0 +1,210 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "AssetLoader.h"
+#include "DXTestException.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(AssetLoaderTests)
+    {
+    private:
+        typedef AssetLoader::file_t file_t;
+
+        std::vector<std::string> mFiles;
+
+        std::wstring WriteFile(const std::string& contents)
+        {
+            std::string filename = "AssetLoaderTests_" + std::to_string(mFiles.size()) + ".bin";
+
+            std::ofstream stream(filename.c_str(), std::ios::binary);
+            stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+            mFiles.push_back(filename);
+            return std::wstring(filename.begin(), filename.end());
+        }
+
+        static std::shared_ptr<std::string> DecodeString(const file_t& file, const std::wstring&)
+        {
+            return std::make_shared<std::string>(file->BufferPointer(), static_cast<size_t>(file->BufferSize()));
+        }
+
+        // Wait until the decode threads have handed every request over to the upload stage.
+        template<typename T>
+        void WaitForUploadStage(const std::vector<AssetHandle<T>>& handles)
+        {
+            for (const AssetHandle<T>& handle : handles)
+            {
+                while (handle.State() != AssetState::WaitingForUpload)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+    public:
+        TEST_METHOD_CLEANUP(DeleteFiles)
+        {
+            for (const std::string& filename : mFiles)
+            {
+                std::remove(filename.c_str());
+            }
+
+            mFiles.clear();
+        }
+
+        TEST_METHOD(LoadReadsAndDecodesOffTheCallingThread)
+        {
+            const std::thread::id mainThread = std::this_thread::get_id();
+            std::vector<std::string> contents;
+            std::vector<AssetHandle<std::string>> handles;
+            std::vector<std::thread::id> decodeThreads(8);
+
+            AssetLoader loader(2);
+
+            for (size_t i = 0; i < 8; ++i)
+            {
+                contents.push_back(std::string(100 + i * 37, static_cast<char>('a' + i)));
+                std::wstring filepath = WriteFile(contents.back());
+
+                handles.push_back(loader.Load<std::string>(filepath, [&decodeThreads, i](const file_t& file, const std::wstring& path) {
+                    decodeThreads[i] = std::this_thread::get_id();
+                    return DecodeString(file, path);
+                }));
+            }
+
+            loader.Flush();
+
+            unsigned long long totalBytes = 0;
+
+            for (size_t i = 0; i < handles.size(); ++i)
+            {
+                const asset_load_timings_t& timings = handles[i].Timings();
+
+                Assert::IsTrue(handles[i].IsReady());
+                Assert::AreEqual(contents[i], *handles[i].Get());
+                Assert::IsTrue(decodeThreads[i] != mainThread);
+
+                Assert::IsTrue(timings.readStart >= timings.requested);
+                Assert::IsTrue(timings.decodeStart >= timings.readEnd);
+                Assert::IsTrue(timings.decodeEnd >= timings.decodeStart);
+                Assert::AreEqual(0.0, timings.UploadSeconds());
+                Assert::AreEqual(static_cast<unsigned long long>(contents[i].size()), timings.bytesRead);
+
+                totalBytes += contents[i].size();
+            }
+
+            asset_loader_stats_t stats = loader.Stats();
+
+            Assert::AreEqual(8u, stats.requested);
+            Assert::AreEqual(8u, stats.completed);
+            Assert::AreEqual(0u, stats.failed);
+            Assert::AreEqual(totalBytes, stats.bytesRead);
+            Assert::AreEqual(0u, loader.PendingCount());
+        }
+
+        TEST_METHOD(UploadsRunOnlyOnTheThreadProcessingUploads)
+        {
+            const std::thread::id mainThread = std::this_thread::get_id();
+            std::thread::id uploadThread;
+
+            AssetLoader loader(1);
+            std::vector<AssetHandle<size_t>> handles;
+
+            handles.push_back(loader.Load<std::string, size_t>(
+                WriteFile("hello"),
+                [](const file_t& file, const std::wstring& path) {
+                    return std::unique_ptr<std::string>(new std::string(*DecodeString(file, path)));
+                },
+                [&uploadThread](std::string& decoded) {
+                    uploadThread = std::this_thread::get_id();
+                    return std::make_shared<size_t>(decoded.size());
+                }));
+
+            WaitForUploadStage(handles);
+
+            Assert::IsFalse(handles[0].IsReady());
+            Assert::IsTrue(handles[0].Get() == nullptr);
+            Assert::AreEqual(1u, loader.PendingCount());
+
+            Assert::AreEqual(1u, loader.ProcessUploads(0.0));
+            Assert::AreEqual(0u, loader.ProcessUploads(0.0));
+
+            Assert::IsTrue(handles[0].IsReady());
+            Assert::AreEqual((size_t)5, *handles[0].Get());
+            Assert::IsTrue(uploadThread == mainThread);
+            Assert::IsTrue(handles[0].Timings().uploadStart >= handles[0].Timings().decodeEnd);
+        }
+
+        TEST_METHOD(UploadBudgetLimitsUploadsPerCall)
+        {
+            AssetLoader loader(1);
+            std::vector<AssetHandle<int>> handles;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                handles.push_back(loader.Load<int, int>(
+                    WriteFile("x"),
+                    [i](const file_t&, const std::wstring&) { return std::unique_ptr<int>(new int(i)); },
+                    [](int& decoded) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                        return std::make_shared<int>(decoded);
+                    }));
+            }
+
+            WaitForUploadStage(handles);
+
+            // Even a budget that is already spent runs one upload.
+            Assert::AreEqual(1u, loader.ProcessUploads(0.001));
+            Assert::AreEqual(3u, loader.ProcessUploads(10.0));
+
+            for (int i = 0; i < 4; ++i)
+            {
+                Assert::AreEqual(i, *handles[i].Get());
+            }
+        }
+
+        TEST_METHOD(MissingFileFailsOnlyThatAsset)
+        {
+            AssetLoader loader(1);
+
+            AssetHandle<std::string> missing = loader.Load<std::string>(L"AssetLoaderTests_missing.bin", DecodeString);
+            AssetHandle<std::string> present = loader.Load<std::string>(WriteFile("data"), DecodeString);
+
+            loader.Flush();
+
+            Assert::IsTrue(missing.IsFailed());
+            Assert::ExpectException<FileLoadException>([&]() { missing.Get(); });
+
+            Assert::IsTrue(present.IsReady());
+            Assert::AreEqual(std::string("data"), *present.Get());
+
+            Assert::AreEqual(1u, loader.Stats().failed);
+            Assert::AreEqual(1u, loader.Stats().completed);
+        }
+
+        TEST_METHOD(DecodeErrorFailsTheAsset)
+        {
+            AssetLoader loader(1);
+
+            AssetHandle<std::string> handle = loader.Load<std::string>(
+                WriteFile("not what we expected"),
+                [](const file_t&, const std::wstring& path) -> std::shared_ptr<std::string> {
+                    throw FileFormatException(L"Bad data", path);
+                });
+
+            loader.Flush();
+
+            Assert::IsTrue(handle.IsFailed());
+            Assert::ExpectException<FileFormatException>([&]() { handle.Get(); });
+        }
+    };
+}
@@ -3,14 +3,26 @@
 #include "DXTestException.h"
 #include "BinaryBlob.h"
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace UnitTests
 {
-    // Unit tests for my extensions to SimpleMath.h
     TEST_CLASS(BinaryBlobTests)
     {
+    private:
+        static const char * TempFile() { return "BinaryBlobTests_file.bin"; }
+
     public:
+        TEST_METHOD_CLEANUP(DeleteFiles)
+        {
+            std::remove(TempFile());
+        }
+
         TEST_METHOD(CreateBinaryBlobDefaultConstructor)
         {
             BinaryBlob blob;
@@ -35,59 +47,160 @@ namespace UnitTests
             const char * SampleData = "Hello World";
             const size_t SampleDataSize = 12;
 
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
             BinaryBlob blob(SampleData, SampleDataSize);
 
-            // binary blob data has different memory buffers but the same content.
-            Assert::AreNotSame(SampleData, blob.BufferPointer());
+            // binary blob data has a different memory buffer but the same content.
+            Assert::IsTrue(SampleData != blob.BufferPointer());
             Assert::AreEqual(SampleData, blob.BufferPointer());
+            Assert::AreEqual(allocations + 1, BinaryBlob::BufferAllocationCount());
         }
 
-        TEST_METHOD(BinaryBlobCopyConstructorCorrectlyCopiesData)
+        TEST_METHOD(BinaryBlobCopyConstructorSharesData)
         {
             const char * SampleData = "Hello World";
             const size_t SampleDataSize = 12;
 
             BinaryBlob firstBlob(SampleData, SampleDataSize);
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
             BinaryBlob copiedBlob(firstBlob);
 
-            // copied blob has different memory buffer but the same content.
-            Assert::AreNotSame(SampleData, copiedBlob.BufferPointer());
-            Assert::AreNotSame(firstBlob.BufferPointer(), copiedBlob.BufferPointer());
+            // copied blob refers to the same memory buffer, nothing is allocated.
+            Assert::IsTrue(firstBlob.BufferPointer() == copiedBlob.BufferPointer());
+            Assert::IsTrue(copiedBlob.SharesBufferWith(firstBlob));
             Assert::AreEqual(SampleData, copiedBlob.BufferPointer());
+            Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
 
             // copied blob should have same size.
             Assert::AreEqual((size_t)firstBlob.BufferSize(), (size_t)copiedBlob.BufferSize());
         }
 
-        TEST_METHOD(BinaryBlobCopyAssignmentCopiesData)
+        TEST_METHOD(BinaryBlobCopyAssignmentSharesData)
         {
             const char * SampleData = "Hello World";
             const size_t SampleDataSize = 12;
 
             BinaryBlob firstBlob(SampleData, SampleDataSize);
-            BinaryBlob copiedBlob(new char[8], 8);      // force a non-default constructor to prevent optimization
-            
+            BinaryBlob copiedBlob("12345678", 8);      // force a non-default constructor to prevent optimization
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
             copiedBlob = firstBlob;
 
-            // copied blob has different memory buffer but the same content.
-            Assert::AreNotSame(SampleData, copiedBlob.BufferPointer());
-            Assert::AreNotSame(firstBlob.BufferPointer(), copiedBlob.BufferPointer());
+            Assert::IsTrue(firstBlob.BufferPointer() == copiedBlob.BufferPointer());
             Assert::AreEqual(SampleData, copiedBlob.BufferPointer());
-
-            // copied blob should have same size.
             Assert::AreEqual((size_t)firstBlob.BufferSize(), (size_t)copiedBlob.BufferSize());
+            Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
         }
 
-
         TEST_METHOD(BinaryBlobAssignmentFromNull)
         {
             BinaryBlob firstBlob;
-            BinaryBlob copiedBlob(new char[8], 8); // force a non-default constructor to prevent optimization
+            BinaryBlob copiedBlob("12345678", 8); // force a non-default constructor to prevent optimization
 
             copiedBlob = firstBlob;
 
             Assert::IsNull(copiedBlob.BufferPointer());
             Assert::AreEqual((size_t)0, (size_t)copiedBlob.BufferSize());
         }
+
+        TEST_METHOD(BinaryBlobMoveLeavesSourceEmpty)
+        {
+            BinaryBlob firstBlob("Hello World", 12);
+            const char * pBuffer = firstBlob.BufferPointer();
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
+            BinaryBlob movedBlob(std::move(firstBlob));
+
+            Assert::IsTrue(pBuffer == movedBlob.BufferPointer());
+            Assert::IsTrue(firstBlob.IsNull());
+            Assert::IsNull(firstBlob.BufferPointer());
+
+            BinaryBlob assignedBlob;
+            assignedBlob = std::move(movedBlob);
+
+            Assert::IsTrue(pBuffer == assignedBlob.BufferPointer());
+            Assert::IsTrue(movedBlob.IsNull());
+            Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
+        }
+
+        TEST_METHOD(BinaryBlobBufferOutlivesOriginal)
+        {
+            BinaryBlob copy;
+
+            {
+                BinaryBlob original("Hello World", 12);
+                copy = original;
+            }
+
+            Assert::AreEqual("Hello World", copy.BufferPointer());
+        }
+
+        TEST_METHOD(BinaryBlobSlicesShareData)
+        {
+            BinaryBlob blob("Hello World", 12);
+            BinaryBlob other("World", 6);
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
+            BinaryBlob world = blob.Slice(6, 6);
+
+            Assert::IsTrue(blob.BufferPointer() + 6 == world.BufferPointer());
+            Assert::AreEqual((size_t)6, (size_t)world.BufferSize());
+            Assert::AreEqual("World", world.BufferPointer());
+            Assert::IsTrue(world.SharesBufferWith(blob));
+            Assert::IsFalse(world.SharesBufferWith(other));
+
+            // Slices of slices, empty slices and slices outliving their source.
+            BinaryBlob orld = world.Slice(1, 5);
+            Assert::AreEqual("orld", orld.BufferPointer());
+            Assert::IsTrue(blob.Slice(12, 0).IsNull());
+
+            blob = BinaryBlob();
+            world = BinaryBlob();
+            Assert::AreEqual("orld", orld.BufferPointer());
+            Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
+
+            Assert::ExpectException<AssertionFailedException>([&]() { orld.Slice(3, 3); });
+            Assert::ExpectException<AssertionFailedException>([&]() { orld.Slice(6, 0); });
+        }
+
+        TEST_METHOD(BinaryBlobIsOnlyWritableWhenItOwnsTheBuffer)
+        {
+            BinaryBlob blob(4);
+            blob.WritableBufferPointer()[0] = 'a';
+
+            // Copies share the buffer, writing through them would change the original.
+            BinaryBlob copy(blob);
+            Assert::ExpectException<SandboxException>([&]() { copy.WritableBufferPointer(); });
+            Assert::ExpectException<SandboxException>([&]() { blob.Slice(0, 2).WritableBufferPointer(); });
+
+            BinaryBlob moved(std::move(blob));
+            moved.WritableBufferPointer()[1] = 'b';
+            Assert::AreEqual('b', copy.BufferPointer()[1]);
+        }
+
+        TEST_METHOD(LoadFromFileMapsWithoutAllocating)
+        {
+            const std::string contents = "Loaded straight from the file";
+
+            {
+                std::ofstream stream(TempFile(), std::ios::binary);
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            }
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
+
+            {
+                BinaryBlob blob = BinaryBlob::LoadFromFile(std::string(TempFile()));
+
+                Assert::AreEqual(contents, std::string(blob.BufferPointer(), static_cast<size_t>(blob.BufferSize())));
+                Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
+                Assert::ExpectException<SandboxException>([&]() { blob.WritableBufferPointer(); });
+            }
+
+            Assert::ExpectException<FileLoadException>([&]() {
+                BinaryBlob::LoadFromFile(std::string("BinaryBlobTests_missing.bin"));
+            });
+        }
     };
-}
\ No newline at end of file
+}
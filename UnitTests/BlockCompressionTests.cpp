@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "BlockCompression.h"
+#include "DXTestException.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(BlockCompressionTests)
+    {
+    private:
+        // A few blocks worth of mostly compressible data with an incompressible stretch in the middle.
+        static std::vector<char> MakeData(size_t size)
+        {
+            std::vector<char> data(size);
+            unsigned int state = 777;
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                state = state * 1664525u + 1013904223u;
+
+                if (i > size / 3 && i < size / 3 + BlockCompression::MinBlockSize * 2)
+                {
+                    data[i] = static_cast<char>(state >> 24);
+                }
+                else
+                {
+                    data[i] = static_cast<char>((i / 16) % 61 + ((state >> 28) == 0 ? 1 : 0));
+                }
+            }
+
+            return data;
+        }
+
+    public:
+        TEST_METHOD(BlocksRoundTripOnAnyNumberOfThreads)
+        {
+            std::vector<char> data = MakeData(1000 * 1000);
+            std::vector<char> compressed;
+
+            BlockCompression::Compress(&data[0], data.size(), &compressed, BlockCompression::MinBlockSize, 4);
+
+            Assert::IsTrue(BlockCompression::IsCompressed(&compressed[0], compressed.size()));
+            Assert::IsTrue(compressed.size() < data.size());
+
+            for (unsigned int threads = 0; threads <= 3; ++threads)
+            {
+                std::vector<char> output(data.size());
+                BlockCompression::Decompress(
+                    &compressed[0],
+                    compressed.size(),
+                    &output[0],
+                    output.size(),
+                    L"test",
+                    threads);
+
+                Assert::IsTrue(data == output);
+            }
+
+            // Compressing on one thread gives the same bytes as on many.
+            std::vector<char> serial;
+            BlockCompression::Compress(&data[0], data.size(), &serial, BlockCompression::MinBlockSize, 1);
+
+            Assert::IsTrue(serial == compressed);
+        }
+
+        TEST_METHOD(BlockDecoderStreamsOneBlockAtATime)
+        {
+            std::vector<char> data = MakeData(BlockCompression::DefaultBlockSize * 3 + 1234);
+            std::vector<char> compressed;
+
+            BlockCompression::Compress(&data[0], data.size(), &compressed);
+
+            BlockDecoder decoder(&compressed[0], compressed.size(), L"test");
+
+            Assert::AreEqual(data.size(), decoder.UncompressedSize());
+            Assert::AreEqual(4u, decoder.BlockCount());
+            Assert::AreEqual((size_t)1234, decoder.BlockUncompressedSize(3));
+
+            std::vector<char> buffer(decoder.BlockSize());
+            std::vector<char> output;
+
+            while (!decoder.IsFinished())
+            {
+                size_t count = decoder.DecodeNext(&buffer[0], buffer.size());
+                output.insert(output.end(), buffer.begin(), buffer.begin() + count);
+            }
+
+            Assert::AreEqual((size_t)0, decoder.DecodeNext(&buffer[0], buffer.size()));
+            Assert::IsTrue(data == output);
+        }
+
+        TEST_METHOD(BlocksHandleEmptyInput)
+        {
+            std::vector<char> compressed;
+            BlockCompression::Compress(nullptr, 0, &compressed);
+
+            BlockDecoder decoder(&compressed[0], compressed.size(), L"test");
+
+            Assert::AreEqual((size_t)0, decoder.UncompressedSize());
+            Assert::AreEqual(0u, decoder.BlockCount());
+            Assert::IsTrue(decoder.IsFinished());
+        }
+
+        TEST_METHOD(BlockDecoderRejectsCorruptData)
+        {
+            std::vector<char> data(BlockCompression::MinBlockSize * 2);
+
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                data[i] = static_cast<char>((i / 16) % 61);
+            }
+
+            std::vector<char> compressed;
+            BlockCompression::Compress(&data[0], data.size(), &compressed, BlockCompression::MinBlockSize);
+
+            std::vector<char> output(data.size());
+            const size_t firstBlockOffset = 24 + 2 * 4;             // After the header and block table.
+
+            std::vector<char> badMagic(compressed);
+            badMagic[0] = 'X';
+
+            std::vector<char> truncated(compressed.begin(), compressed.end() - 10);
+
+            std::vector<char> badSize(compressed);
+            badSize[8] = static_cast<char>(badSize[8] + 1);         // Uncompressed size no longer matches the blocks.
+
+            // Every byte of the first block becomes a literal length that never ends.
+            std::vector<char> badBlock(compressed);
+            unsigned int firstBlockSize;
+            std::memcpy(&firstBlockSize, &compressed[24], sizeof(firstBlockSize));
+
+            for (size_t i = 0; i < firstBlockSize; ++i)
+            {
+                badBlock[firstBlockOffset + i] = static_cast<char>(0xFF);
+            }
+
+            Assert::ExpectException<FileFormatException>([&]() {
+                BlockDecoder decoder(&badMagic[0], badMagic.size(), L"test");
+            });
+
+            Assert::ExpectException<FileFormatException>([&]() {
+                BlockDecoder decoder(&truncated[0], truncated.size(), L"test");
+            });
+
+            Assert::ExpectException<FileFormatException>([&]() {
+                BlockDecoder decoder(&badSize[0], badSize.size(), L"test");
+            });
+
+            Assert::ExpectException<FileFormatException>([&]() {
+                BlockCompression::Decompress(&badBlock[0], badBlock.size(), &output[0], output.size(), L"test", 2);
+            });
+        }
+    };
+}
@@ -0,0 +1,169 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "BoundingVolumes.h"
+#include "MeshData.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(BoundingVolumesTests)
+    {
+    private:
+        // Tightly packed xyz positions spread over the surface of a sphere.
+        std::vector<float> MakeSpherePoints(float cx, float cy, float cz, float radius, int count) const
+        {
+            std::vector<float> points;
+
+            for (int i = 0; i < count; ++i)
+            {
+                // Fibonacci sphere.
+                float y = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(count);
+                float r = std::sqrt(1.0f - y * y);
+                float phi = 2.39996323f * static_cast<float>(i);
+
+                points.push_back(cx + std::cos(phi) * r * radius);
+                points.push_back(cy + y * radius);
+                points.push_back(cz + std::sin(phi) * r * radius);
+            }
+
+            return points;
+        }
+
+        bool Contains(const bounding_sphere_t& sphere, const std::vector<float>& points) const
+        {
+            for (size_t i = 0; i < points.size(); i += 3)
+            {
+                float dx = points[i + 0] - sphere.center[0];
+                float dy = points[i + 1] - sphere.center[1];
+                float dz = points[i + 2] - sphere.center[2];
+
+                if (std::sqrt(dx * dx + dy * dy + dz * dz) > sphere.radius * 1.0001f)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    public:
+        TEST_METHOD(AabbCoversAllPoints)
+        {
+            const float points[] = { 1.0f, -2.0f, 3.0f, -4.0f, 5.0f, 0.5f, 2.0f, 1.0f, -6.0f };
+
+            aabb_t box = BoundingVolumes::ComputeAabb(points, 3, sizeof(float) * 3);
+
+            Assert::AreEqual(-4.0f, box.min[0]);
+            Assert::AreEqual(-2.0f, box.min[1]);
+            Assert::AreEqual(-6.0f, box.min[2]);
+            Assert::AreEqual(2.0f, box.max[0]);
+            Assert::AreEqual(5.0f, box.max[1]);
+            Assert::AreEqual(3.0f, box.max[2]);
+        }
+
+        TEST_METHOD(BoundingSphereIsNearMinimal)
+        {
+            std::vector<float> points = MakeSpherePoints(3.0f, -1.0f, 2.0f, 5.0f, 2000);
+
+            bounding_sphere_t sphere = BoundingVolumes::ComputeBoundingSphere(&points[0], 2000, sizeof(float) * 3);
+
+            Assert::IsTrue(Contains(sphere, points));
+            Assert::IsTrue(sphere.radius < 5.0f * 1.05f);
+            Assert::AreEqual(3.0f, sphere.center[0], 0.25f);
+            Assert::AreEqual(-1.0f, sphere.center[1], 0.25f);
+            Assert::AreEqual(2.0f, sphere.center[2], 0.25f);
+        }
+
+        TEST_METHOD(BoundingSphereOfBoxCorners)
+        {
+            std::vector<float> points;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                points.push_back((i & 1) ? 1.0f : -1.0f);
+                points.push_back((i & 2) ? 1.0f : -1.0f);
+                points.push_back((i & 4) ? 1.0f : -1.0f);
+            }
+
+            // Opposite corners are found along the diagonals, giving the minimal sphere right away.
+            bounding_sphere_t sphere = BoundingVolumes::ComputeBoundingSphere(&points[0], 8, sizeof(float) * 3);
+
+            Assert::IsTrue(Contains(sphere, points));
+            Assert::AreEqual(std::sqrt(3.0f), sphere.radius, 1e-4f);
+        }
+
+        TEST_METHOD(MeshBoundsReadVertexPositions)
+        {
+            s_mesh_data_t mesh;
+            s_mesh_vertex_t a = { -1.0f, 0.0f, 0.0f, 9.0f, 9.0f, 9.0f, 9.0f, 9.0f };
+            s_mesh_vertex_t b = { 3.0f, 0.0f, 0.0f, -9.0f, -9.0f, -9.0f, -9.0f, -9.0f };
+            mesh.vertices.push_back(a);
+            mesh.vertices.push_back(b);
+
+            mesh_bounds_t bounds = BoundingVolumes::ComputeMeshBounds(mesh);
+
+            Assert::AreEqual(-1.0f, bounds.box.min[0]);
+            Assert::AreEqual(3.0f, bounds.box.max[0]);
+            Assert::AreEqual(0.0f, bounds.box.max[1]);
+            Assert::AreEqual(1.0f, bounds.sphere.center[0]);
+            Assert::AreEqual(2.0f, bounds.sphere.radius);
+        }
+
+        TEST_METHOD(EmptyInputGivesEmptyBounds)
+        {
+            s_mesh_data_t mesh;
+            mesh_bounds_t bounds = BoundingVolumes::ComputeMeshBounds(mesh);
+
+            Assert::AreEqual(0.0f, bounds.sphere.radius);
+            Assert::AreEqual(0.0f, bounds.box.max[0]);
+        }
+
+        TEST_METHOD(TransformAabbRotatesAndTranslates)
+        {
+            aabb_t box = { { 0.0f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f } };
+
+            // Rotate 90 degrees about z (x becomes y) then translate by (10, 0, 0). Row vector convention.
+            const float matrix[16] =
+            {
+                0.0f, 1.0f, 0.0f, 0.0f,
+                -1.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+                10.0f, 0.0f, 0.0f, 1.0f
+            };
+
+            aabb_t result = BoundingVolumes::TransformAabb(box, matrix);
+
+            Assert::AreEqual(9.0f, result.min[0]);
+            Assert::AreEqual(10.0f, result.max[0]);
+            Assert::AreEqual(0.0f, result.min[1]);
+            Assert::AreEqual(2.0f, result.max[1]);
+            Assert::AreEqual(0.0f, result.min[2]);
+            Assert::AreEqual(1.0f, result.max[2]);
+        }
+
+        TEST_METHOD(TransformSphereUsesLargestScale)
+        {
+            bounding_sphere_t sphere = { { 1.0f, 0.0f, 0.0f }, 1.0f };
+
+            const float matrix[16] =
+            {
+                2.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 3.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+                0.0f, 5.0f, 0.0f, 1.0f
+            };
+
+            bounding_sphere_t result = BoundingVolumes::TransformSphere(sphere, matrix);
+
+            Assert::AreEqual(2.0f, result.center[0]);
+            Assert::AreEqual(5.0f, result.center[1]);
+            Assert::AreEqual(0.0f, result.center[2]);
+            Assert::AreEqual(3.0f, result.radius);
+            Assert::AreEqual(3.0f, BoundingVolumes::MaxScale(matrix));
+        }
+    };
+}
@@ -1,9 +1,9 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 #include "Camera.h"
-#include "SimpleMath.h"
+#include "MathTypes.h"
 #include "TestHelpers.h"
-#include "Size.h"
+#include "size.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace DirectX::SimpleMath;
@@ -17,6 +17,17 @@ namespace UnitTests
         const float DefaultNear = 0.1f;
         const float DefaultDepth = 1000.0f;
 
+        static void AssertMatrixNear(const Matrix& expected, const Matrix& actual, float tolerance)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    Assert::AreEqual(expected.m[row][column], actual.m[row][column], tolerance);
+                }
+            }
+        }
+
     public:
         TEST_METHOD(CreateCameraAndSetValues)
         {
@@ -34,6 +45,14 @@ namespace UnitTests
             Assert::AreEqual(v3, camera.Rotation());
         }
 
+        TEST_METHOD(CameraReportsScreenSize)
+        {
+            Camera camera(DefaultScreenSize, DefaultNear, DefaultDepth);
+
+            Assert::AreEqual(800.0f, camera.ScreenWidth());
+            Assert::AreEqual(600.0f, camera.ScreenHeight());
+        }
+
         TEST_METHOD(SetCameraPositionOrRotationRegeneratesViewMatrix)
         {
             Vector3 v3(1.0f, 2.0f, 3.0f);
@@ -69,10 +88,65 @@ namespace UnitTests
 
             Matrix viewMatrix = camera.ViewMatrix();
 
-            // TODO: Test within tolerance.
-            //Assert::AreEqual(viewMatrix.Translation(), -position);
+            // The camera's position is the origin in view space.
+            Vector3 origin = Vector3::Transform(position, viewMatrix);
+            Assert::AreEqual(0.0f, origin.Length(), 0.0001f);
 
             // TODO: Test rotation.
         }
+
+        TEST_METHOD(ReadingViewMatrixClearsDirtyFlag)
+        {
+            Camera camera(DefaultScreenSize, DefaultNear, DefaultDepth);
+            camera.SetPosition(Vector3(1.0f, 2.0f, 3.0f));
+            Assert::IsTrue(camera.IsViewMatrixDirty());
+
+            camera.ViewMatrix();
+            Assert::IsFalse(camera.IsViewMatrixDirty());
+
+            camera.SetRotation(Vector3(0.0f, 45.0f, 0.0f));
+            camera.Render();
+            Assert::IsFalse(camera.IsViewMatrixDirty());
+        }
+
+        TEST_METHOD(RevisionChangesOnlyWhenCameraChanges)
+        {
+            Camera camera(DefaultScreenSize, DefaultNear, DefaultDepth);
+            const unsigned int first = camera.Revision();
+
+            Assert::AreNotEqual(0u, first);
+
+            // Setting the same values again is not a change.
+            camera.SetPosition(camera.Position());
+            camera.SetRotation(camera.Rotation());
+            camera.ViewProjectionMatrix();
+            Assert::AreEqual(first, camera.Revision());
+
+            camera.SetPosition(Vector3(0.0f, 0.0f, -5.0f));
+            const unsigned int moved = camera.Revision();
+            Assert::AreNotEqual(first, moved);
+
+            camera.SetRotation(Vector3(10.0f, 0.0f, 0.0f));
+            Assert::AreNotEqual(moved, camera.Revision());
+        }
+
+        TEST_METHOD(CachedMatricesMatchProducts)
+        {
+            Camera camera(DefaultScreenSize, DefaultNear, DefaultDepth);
+            camera.SetPosition(Vector3(4.0f, -2.0f, 7.0f));
+            camera.SetRotation(Vector3(15.0f, 60.0f, 5.0f));
+
+            AssertMatrixNear(camera.ViewMatrix() * camera.ProjectionMatrix(), camera.ViewProjectionMatrix(), 0.0001f);
+            AssertMatrixNear(Matrix::Identity, camera.ViewMatrix() * camera.InverseViewMatrix(), 0.0001f);
+            AssertMatrixNear(
+                Matrix::Identity,
+                camera.ViewProjectionMatrix() * camera.InverseViewProjectionMatrix(),
+                0.001f);
+
+            // Moving the camera refreshes every cached matrix.
+            camera.SetPosition(Vector3(-1.0f, 0.0f, 0.0f));
+            AssertMatrixNear(camera.ViewMatrix() * camera.ProjectionMatrix(), camera.ViewProjectionMatrix(), 0.0001f);
+            AssertMatrixNear(Matrix::Identity, camera.ViewMatrix() * camera.InverseViewMatrix(), 0.0001f);
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "DdsFile.h"
+#include "DXTestException.h"
+#include "StreamReader.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(DdsFileTests)
+    {
+    private:
+        // DXGI_FORMAT values used below.
+        static const unsigned int FormatR8G8B8A8Unorm = 28;
+        static const unsigned int FormatBc1Unorm = 71;
+        static const unsigned int FormatB8G8R8A8Unorm = 87;
+
+        static unsigned int FourCC(const char * pCode)
+        {
+            unsigned int value = 0;
+            std::memcpy(&value, pCode, 4);
+            return value;
+        }
+
+        // Build a DDS file image with a legacy header. Offsets follow the DDS_HEADER layout, in 32 bit words.
+        std::vector<char> MakeDds(
+            unsigned int width,
+            unsigned int height,
+            unsigned int mipCount,
+            unsigned int pixelFormatFlags,
+            unsigned int fourCC,
+            unsigned int bitCount,
+            const unsigned int masks[4],
+            unsigned int caps2,
+            size_t pixelBytes) const
+        {
+            std::vector<unsigned int> words(1 + 31, 0u);
+
+            words[0] = FourCC("DDS ");
+            words[1] = 124;                 // Header size.
+            words[3] = height;
+            words[4] = width;
+            words[7] = mipCount;
+            words[19] = 32;                 // Pixel format size.
+            words[20] = pixelFormatFlags;
+            words[21] = fourCC;
+            words[22] = bitCount;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                words[23 + i] = masks ? masks[i] : 0;
+            }
+
+            words[28] = caps2;
+
+            std::vector<char> file(words.size() * 4 + pixelBytes, 0);
+            std::memcpy(&file[0], &words[0], words.size() * 4);
+
+            return file;
+        }
+
+        void AppendDx10Header(
+            std::vector<char> *pFile,
+            unsigned int format,
+            unsigned int miscFlag,
+            unsigned int arraySize) const
+        {
+            const unsigned int header[5] = { format, 3, miscFlag, arraySize, 0 };
+            pFile->insert(pFile->begin() + 128, reinterpret_cast<const char *>(header), reinterpret_cast<const char *>(header + 5));
+        }
+
+    public:
+        TEST_METHOD(ParseBc1MipChain)
+        {
+            // 256x128 down to 1x1 is 9 levels. The 4x4 block size rounds the last levels up to one block.
+            size_t pixelBytes = 0;
+
+            for (unsigned int w = 256, h = 128, i = 0; i < 9; ++i, w = (w > 1 ? w / 2 : 1), h = (h > 1 ? h / 2 : 1))
+            {
+                pixelBytes += ((w + 3) / 4) * ((h + 3) / 4) * 8;
+            }
+
+            std::vector<char> file = MakeDds(256, 128, 9, 0x4, FourCC("DXT1"), 0, nullptr, 0, pixelBytes);
+
+            dds_image_t image;
+            DdsFile::Parse(&file[0], file.size(), L"test", &image);
+
+            Assert::AreEqual(FormatBc1Unorm, image.format);
+            Assert::AreEqual(256u, image.width);
+            Assert::AreEqual(128u, image.height);
+            Assert::AreEqual(9u, image.mipCount);
+            Assert::AreEqual(1u, image.arraySize);
+            Assert::IsFalse(image.isCubeMap);
+            Assert::AreEqual((size_t)9, image.subresources.size());
+
+            Assert::AreEqual((size_t)128, image.subresources[0].offset);
+            Assert::AreEqual(64u * 8u, image.subresources[0].rowPitch);
+            Assert::AreEqual(64u * 32u * 8u, image.subresources[0].slicePitch);
+            Assert::AreEqual(128u, image.subresources[1].width);
+            Assert::AreEqual(128 + (size_t)64 * 32 * 8, image.subresources[1].offset);
+
+            Assert::AreEqual(1u, image.subresources[8].width);
+            Assert::AreEqual(8u, image.subresources[8].slicePitch);
+            Assert::AreEqual(file.size(), image.subresources[8].offset + image.subresources[8].slicePitch);
+        }
+
+        TEST_METHOD(ParseUncompressedWithMasks)
+        {
+            const unsigned int bgra[4] = { 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 };
+            std::vector<char> file = MakeDds(3, 2, 0, 0x41, 0, 32, bgra, 0, 3 * 2 * 4);
+
+            dds_image_t image;
+            DdsFile::Parse(&file[0], file.size(), L"test", &image);
+
+            Assert::AreEqual(FormatB8G8R8A8Unorm, image.format);
+            Assert::AreEqual(1u, image.mipCount);
+            Assert::AreEqual(12u, image.subresources[0].rowPitch);
+            Assert::AreEqual(24u, image.subresources[0].slicePitch);
+        }
+
+        TEST_METHOD(ParseDx10TextureArray)
+        {
+            // Three 4x4 slices with 3 mip levels each: 64 + 16 + 4 bytes per slice.
+            std::vector<char> file = MakeDds(4, 4, 3, 0x4, FourCC("DX10"), 0, nullptr, 0, 3 * (64 + 16 + 4));
+            AppendDx10Header(&file, FormatR8G8B8A8Unorm, 0, 3);
+
+            dds_image_t image;
+            DdsFile::Parse(&file[0], file.size(), L"test", &image);
+
+            Assert::AreEqual(FormatR8G8B8A8Unorm, image.format);
+            Assert::AreEqual(3u, image.arraySize);
+            Assert::AreEqual((size_t)9, image.subresources.size());
+
+            // Subresources are numbered mip first, then slice.
+            Assert::AreEqual((size_t)148, image.subresources[0].offset);
+            Assert::AreEqual((size_t)148 + 84, image.subresources[3].offset);
+            Assert::AreEqual(4u, image.subresources[3].width);
+            Assert::AreEqual(1u, image.subresources[5].width);
+        }
+
+        TEST_METHOD(ParseCubeMap)
+        {
+            const unsigned int rgba[4] = { 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 };
+            std::vector<char> file = MakeDds(2, 2, 1, 0x41, 0, 32, rgba, 0x200 | 0xFC00, 6 * 16);
+
+            dds_image_t image;
+            DdsFile::Parse(&file[0], file.size(), L"test", &image);
+
+            Assert::IsTrue(image.isCubeMap);
+            Assert::AreEqual(6u, image.arraySize);
+            Assert::AreEqual((size_t)6, image.subresources.size());
+
+            // Cube maps missing faces can not be created in D3D11.
+            std::vector<char> partial = MakeDds(2, 2, 1, 0x41, 0, 32, rgba, 0x200 | 0x0C00, 2 * 16);
+            Assert::ExpectException<FileFormatException>([&]() { DdsFile::Parse(&partial[0], partial.size(), L"test", &image); });
+        }
+
+        TEST_METHOD(ParseRejectsBadFiles)
+        {
+            dds_image_t image;
+
+            // Truncated pixel data.
+            std::vector<char> truncated = MakeDds(64, 64, 1, 0x4, FourCC("DXT1"), 0, nullptr, 0, 100);
+            Assert::ExpectException<FileFormatException>([&]() { DdsFile::Parse(&truncated[0], truncated.size(), L"test", &image); });
+
+            // Unknown four character code.
+            std::vector<char> unknown = MakeDds(4, 4, 1, 0x4, FourCC("ABCD"), 0, nullptr, 0, 64);
+            Assert::ExpectException<FileFormatException>([&]() { DdsFile::Parse(&unknown[0], unknown.size(), L"test", &image); });
+
+            // Bad magic.
+            std::vector<char> notDds = MakeDds(4, 4, 1, 0x4, FourCC("DXT1"), 0, nullptr, 0, 8);
+            notDds[0] = 'X';
+            Assert::ExpectException<FileFormatException>([&]() { DdsFile::Parse(&notDds[0], notDds.size(), L"test", &image); });
+
+            // Shorter than the header.
+            Assert::ExpectException<FileFormatException>([&]() { DdsFile::Parse(&notDds[0], 64, L"test", &image); });
+        }
+
+        TEST_METHOD(ReadSubresourcesFromStream)
+        {
+            std::vector<char> file = MakeDds(4, 4, 3, 0x4, FourCC("DXT1"), 0, nullptr, 0, 3 * 8);
+
+            for (size_t i = 128; i < file.size(); ++i)
+            {
+                file[i] = static_cast<char>(i);
+            }
+
+            StreamReader reader(&file[0], file.size(), L"test");
+            dds_image_t image;
+
+            DdsFile::Parse(reader, &image);
+            Assert::AreEqual((unsigned long long)128, reader.Position());
+
+            // Skipping a level is fine, going back to it is not.
+            char pixels[8];
+            DdsFile::ReadSubresource(reader, image.subresources[1], pixels);
+            Assert::AreEqual(0, std::memcmp(&file[image.subresources[1].offset], pixels, 8));
+
+            Assert::ExpectException<SandboxException>([&]() {
+                DdsFile::ReadSubresource(reader, image.subresources[0], pixels);
+            });
+
+            DdsFile::ReadSubresource(reader, image.subresources[2], pixels);
+            Assert::AreEqual(0, std::memcmp(&file[image.subresources[2].offset], pixels, 8));
+            Assert::IsTrue(reader.IsEnd());
+        }
+    };
+}
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "FrameArena.h"
+#include "ScratchArena.h"
+#include "AllocationCounter.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(FrameArenaTests)
+    {
+    public:
+        TEST_METHOD(AllocationsAreAlignedAndDoNotOverlap)
+        {
+            FrameArena arena(1024);
+
+            char * pA = static_cast<char *>(arena.Allocate(3, 1));
+            double * pB = arena.AllocateArray<double>(4);
+            char * pC = static_cast<char *>(arena.Allocate(10, 64));
+
+            Assert::AreEqual(0u, static_cast<unsigned int>(reinterpret_cast<uintptr_t>(pB) % sizeof(double)));
+            Assert::AreEqual(0u, static_cast<unsigned int>(reinterpret_cast<uintptr_t>(pC) % 64));
+            Assert::IsTrue(pA + 3 <= reinterpret_cast<char *>(pB));
+            Assert::IsTrue(reinterpret_cast<char *>(pB + 4) <= pC);
+
+            Assert::IsTrue(arena.Used() >= 3 + 4 * sizeof(double) + 10);
+            Assert::AreEqual(arena.Used(), arena.HighWaterMark());
+        }
+
+        TEST_METHOD(ResetReleasesEverythingAndKeepsHighWaterMark)
+        {
+            FrameArena arena(1024);
+
+            void * pFirst = arena.Allocate(100);
+            arena.Allocate(200);
+            const size_t used = arena.Used();
+
+            arena.Reset();
+
+            Assert::AreEqual(0u, static_cast<unsigned int>(arena.Used()));
+            Assert::AreEqual(used, arena.HighWaterMark());
+            Assert::IsTrue(pFirst == arena.Allocate(100));
+
+            arena.ResetHighWaterMark();
+            Assert::AreEqual(arena.Used(), arena.HighWaterMark());
+        }
+
+        TEST_METHOD(RewindReleasesAllocationsAfterMark)
+        {
+            FrameArena arena(1024);
+
+            arena.Allocate(64);
+            const arena_mark_t mark = arena.Mark();
+            void * pAfterMark = arena.Allocate(128);
+
+            arena.Rewind(mark);
+
+            Assert::AreEqual(mark.used, arena.Used());
+            Assert::IsTrue(pAfterMark == arena.Allocate(128));
+        }
+
+        TEST_METHOD(OverflowGoesToHeapAndArenaGrowsOnReset)
+        {
+            FrameArena arena(256);
+            const unsigned long long blocks = arena.HeapAllocationCount();
+
+            // Bigger than the arena, then more than fits in one frame.
+            char * pLarge = static_cast<char *>(arena.Allocate(1000));
+            pLarge[999] = 1;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                arena.Allocate(100);
+            }
+
+            Assert::IsTrue(arena.HeapAllocationCount() > blocks);
+            Assert::IsTrue(arena.HighWaterMark() >= 2000);
+
+            // After one reset the same frame fits in the main block without touching the heap.
+            arena.Reset();
+            Assert::IsTrue(arena.Capacity() >= arena.HighWaterMark());
+
+            const unsigned long long grownBlocks = arena.HeapAllocationCount();
+            const unsigned long long allocations = AllocationCounter::Count();
+
+            arena.Allocate(1000);
+
+            for (int i = 0; i < 10; ++i)
+            {
+                arena.Allocate(100);
+            }
+
+            arena.Reset();
+
+            Assert::AreEqual(grownBlocks, arena.HeapAllocationCount());
+            Assert::AreEqual(allocations, AllocationCounter::Count());
+        }
+
+        TEST_METHOD(ArenaAllocatorBacksStandardContainers)
+        {
+            FrameArena arena(64 * 1024);
+            const unsigned long long allocations = AllocationCounter::Count();
+
+            {
+                std::vector<int, ArenaAllocator<int>> values((ArenaAllocator<int>(arena)));
+
+                for (int i = 0; i < 1000; ++i)
+                {
+                    values.push_back(i);
+                }
+
+                Assert::AreEqual(999, values.back());
+                Assert::IsTrue(values.get_allocator() == ArenaAllocator<char>(arena));
+            }
+
+            Assert::AreEqual(allocations, AllocationCounter::Count());
+            Assert::IsTrue(arena.Used() >= 1000 * sizeof(int));
+        }
+
+        TEST_METHOD(ScratchScopesNestAndRewind)
+        {
+            FrameArena& arena = ScratchArena::ForThisThread();
+            const size_t usedBefore = arena.Used();
+
+            {
+                ScratchScope outer;
+                int * pOuter = outer.AllocateArray<int>(16);
+                pOuter[0] = 42;
+
+                const size_t usedByOuter = arena.Used();
+
+                {
+                    ScratchScope inner;
+                    Assert::IsTrue(&inner.Arena() == &outer.Arena());
+
+                    inner.AllocateArray<int>(1024);
+                    Assert::IsTrue(arena.Used() > usedByOuter);
+                }
+
+                Assert::AreEqual(usedByOuter, arena.Used());
+                Assert::AreEqual(42, pOuter[0]);
+            }
+
+            Assert::AreEqual(usedBefore, arena.Used());
+            Assert::IsTrue(ScratchArena::HighWaterMark() >= 1040 * sizeof(int));
+        }
+
+        TEST_METHOD(ScratchArenaIsPerThread)
+        {
+            FrameArena * pMainArena = &ScratchArena::ForThisThread();
+            FrameArena * pOtherArena = nullptr;
+
+            std::thread other([&]() {
+                ScratchScope scratch;
+                scratch.AllocateArray<char>(100);
+                pOtherArena = &scratch.Arena();
+            });
+
+            other.join();
+
+            Assert::IsNotNull(pOtherArena);
+            Assert::IsTrue(pMainArena != pOtherArena);
+        }
+    };
+}
@@ -0,0 +1,119 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "FrameReplay.h"
+
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(FrameReplayTests)
+    {
+    private:
+        static frame_replay_settings_t SmallSettings()
+        {
+            frame_replay_settings_t settings = FrameReplay::DefaultSettings();
+
+            settings.modelCount = 300;
+            settings.frameCount = 90;
+            settings.warmupFrames = 10;
+
+            return settings;
+        }
+
+    public:
+        TEST_METHOD(SameSettingsReplayTheSameFrames)
+        {
+            FrameReplay first(SmallSettings());
+            FrameReplay second(SmallSettings());
+
+            const frame_replay_result_t a = first.Run();
+            const frame_replay_result_t b = second.Run();
+            const frame_replay_result_t again = first.Run();
+
+            Assert::AreEqual(a.checksum, b.checksum);
+            Assert::AreEqual(a.checksum, again.checksum);
+            Assert::AreEqual(a.drawCalls, b.drawCalls);
+            Assert::AreEqual(a.trianglesSubmitted, again.trianglesSubmitted);
+        }
+
+        TEST_METHOD(SeedChangesTheScene)
+        {
+            frame_replay_settings_t settings = SmallSettings();
+            FrameReplay first(settings);
+
+            settings.seed += 1;
+            FrameReplay second(settings);
+
+            Assert::AreNotEqual(first.Run().checksum, second.Run().checksum);
+        }
+
+        TEST_METHOD(EveryModelIsDrawnOrCulledEachFrame)
+        {
+            const frame_replay_settings_t settings = SmallSettings();
+            FrameReplay replay(settings);
+
+            const frame_replay_result_t result = replay.Run();
+            const unsigned long long tested =
+                static_cast<unsigned long long>(settings.modelCount) * settings.frameCount;
+
+            Assert::IsTrue(result.drawCalls > 0);
+            Assert::IsTrue(result.objectsCulled > 0);
+            Assert::AreEqual(tested, result.drawCalls + result.objectsCulled);
+            Assert::AreEqual(static_cast<size_t>(settings.frameCount), replay.Stats().FrameCount());
+        }
+
+        TEST_METHOD(WarmupFramesAreNotTimed)
+        {
+            const frame_replay_settings_t settings = SmallSettings();
+            FrameReplay replay(settings);
+
+            const frame_replay_result_t result = replay.Run();
+            const size_t timedFrames = settings.frameCount - settings.warmupFrames;
+
+            Assert::AreEqual(timedFrames, result.frameMilliseconds.size());
+            Assert::AreEqual(timedFrames, result.timing.frames);
+            Assert::IsTrue(result.timing.min <= result.timing.p50);
+            Assert::IsTrue(result.timing.p99 <= result.timing.max);
+        }
+
+        TEST_METHOD(SummarizeUsesNearestRankPercentiles)
+        {
+            std::vector<double> milliseconds;
+
+            // Out of order, so the summary has to sort.
+            for (int i = 100; i >= 1; --i)
+            {
+                milliseconds.push_back(static_cast<double>(i));
+            }
+
+            const frame_timing_summary_t summary = FrameReplay::Summarize(milliseconds);
+
+            Assert::AreEqual(static_cast<size_t>(100), summary.frames);
+            Assert::AreEqual(1.0, summary.min);
+            Assert::AreEqual(50.5, summary.mean);
+            Assert::AreEqual(50.0, summary.p50);
+            Assert::AreEqual(95.0, summary.p95);
+            Assert::AreEqual(99.0, summary.p99);
+            Assert::AreEqual(100.0, summary.max);
+
+            const frame_timing_summary_t empty = FrameReplay::Summarize(std::vector<double>());
+            Assert::AreEqual(static_cast<size_t>(0), empty.frames);
+            Assert::AreEqual(0.0, empty.p99);
+        }
+
+        TEST_METHOD(ReportHasPercentilesAndChecksum)
+        {
+            FrameReplay replay(SmallSettings());
+            const std::string report = replay.Report(replay.Run());
+
+            Assert::IsTrue(report.find("300 models, 90 frames (10 warm up)") != std::string::npos);
+            Assert::IsTrue(report.find(", p95 ") != std::string::npos);
+            Assert::IsTrue(report.find(", p99 ") != std::string::npos);
+            Assert::IsTrue(report.find("Draw list checksum: ") != std::string::npos);
+            Assert::IsTrue(report.find("Objects culled") != std::string::npos);
+        }
+    };
+}
@@ -1,8 +1,10 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
+#include "Camera.h"
 #include "Frustum.h"
-#include "SimpleMath.h"
+#include "MathTypes.h"
 #include "TestHelpers.h"
+#include "size.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace DirectX::SimpleMath;
@@ -16,5 +18,50 @@ namespace UnitTests
         {
             Frustum f;
         }
+
+        TEST_METHOD(UpdateFromCameraMatchesSeparateMatrices)
+        {
+            Camera camera(Size(1280, 720), 0.1f, 1000.0f);
+            camera.SetPosition(Vector3(0.0f, 3.0f, -10.0f));
+            camera.SetRotation(Vector3(10.0f, 25.0f, 0.0f));
+
+            Frustum fromMatrices;
+            fromMatrices.Update(1000.0f, camera.ProjectionMatrix(), camera.ViewMatrix());
+
+            Frustum fromCamera;
+            Assert::IsTrue(fromCamera.Update(camera));
+
+            Vector3 points[] =
+            {
+                Vector3(0.0f, 3.0f, 0.0f), Vector3(-20.0f, 0.0f, 5.0f), Vector3(0.0f, 3.0f, -20.0f),
+                Vector3(40.0f, 3.0f, 30.0f), Vector3(5.0f, 500.0f, 10.0f), Vector3(200.0f, 3.0f, 900.0f)
+            };
+
+            for (const Vector3& point : points)
+            {
+                Assert::AreEqual(fromMatrices.CheckSphere(point, 1.0f), fromCamera.CheckSphere(point, 1.0f));
+            }
+        }
+
+        TEST_METHOD(UpdateFromCameraSkipsUnchangedCamera)
+        {
+            Camera camera(Size(800, 600), 0.1f, 1000.0f);
+            Frustum frustum;
+
+            Assert::IsTrue(frustum.Update(camera));
+            Assert::IsFalse(frustum.Update(camera));
+
+            camera.SetPosition(Vector3(0.0f, 0.0f, -1000.0f));
+            Assert::IsTrue(frustum.Update(camera));
+            Assert::IsFalse(frustum.CheckPoint(Vector3(0.0f, 0.0f, 100.0f)));
+
+            // A different camera with the same revision is still a change.
+            Camera other(Size(800, 600), 0.1f, 1000.0f);
+            Assert::IsTrue(frustum.Update(other));
+            Assert::IsTrue(frustum.CheckPoint(Vector3(0.0f, 0.0f, 100.0f)));
+
+            frustum.Clear();
+            Assert::IsTrue(frustum.Update(other));
+        }
     };
 }
\ No newline at end of file
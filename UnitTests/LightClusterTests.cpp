@@ -0,0 +1,304 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Camera.h"
+#include "LightClusters.h"
+#include "MathTypes.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "size.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace DirectX::SimpleMath;
+
+namespace UnitTests
+{
+    TEST_CLASS(LightClusterTests)
+    {
+    private:
+        static local_light_t PointLight(const Vector3& position, float range)
+        {
+            local_light_t light = {};
+
+            light.position = position;
+            light.range = range;
+            light.color = Vector3(1.0f, 1.0f, 1.0f);
+            light.intensity = 1.0f;
+            light.type = LocalLightType::Point;
+
+            return light;
+        }
+
+        static local_light_t SpotLight(const Vector3& position, const Vector3& direction, float range, float cosAngle)
+        {
+            local_light_t light = PointLight(position, range);
+
+            light.direction = direction;
+            light.spotCosAngle = cosAngle;
+            light.type = LocalLightType::Spot;
+
+            return light;
+        }
+
+        static std::vector<local_light_t> RandomLights(unsigned int seed, size_t count)
+        {
+            Random random(seed);
+            std::vector<local_light_t> lights;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Vector3 position(random.NextFloat(-60.0f, 60.0f), random.NextFloat(-10.0f, 20.0f),
+                                       random.NextFloat(-20.0f, 150.0f));
+                const float range = random.NextFloat(0.5f, 12.0f);
+
+                if (random.NextUInt(4) == 0)
+                {
+                    Vector3 direction(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 0.2f),
+                                      random.NextFloat(-1.0f, 1.0f));
+                    direction.Normalize();
+
+                    lights.push_back(SpotLight(position, direction, range, random.NextFloat(0.2f, 0.98f)));
+                }
+                else
+                {
+                    lights.push_back(PointLight(position, range));
+                }
+            }
+
+            return lights;
+        }
+
+        static bool Contains(const bounding_sphere_t& sphere, const Vector3& point, float slack)
+        {
+            const Vector3 center(sphere.center[0], sphere.center[1], sphere.center[2]);
+            return (point - center).Length() <= sphere.radius + slack;
+        }
+
+        static bool Contains(const aabb_t& box, const Vector3& point)
+        {
+            return point.x >= box.min[0] && point.x <= box.max[0] &&
+                   point.y >= box.min[1] && point.y <= box.max[1] &&
+                   point.z >= box.min[2] && point.z <= box.max[2];
+        }
+
+        static bool Listed(const LightClusters& clusters, unsigned int cluster, unsigned short light)
+        {
+            const cluster_light_list_t& list = clusters.ClusterLists()[cluster];
+            const unsigned short * pBegin = clusters.LightIndices().data() + list.offset;
+
+            return std::find(pBegin, pBegin + list.count, light) != pBegin + list.count;
+        }
+
+    public:
+        TEST_METHOD(ClusterBoundsFollowTheCameraProjection)
+        {
+            Camera camera(Size(1280, 720), 0.1f, 1000.0f);
+            LightClusters clusters;
+
+            clusters.Assign(camera, nullptr, 0);
+
+            Assert::AreEqual(16u * 9u * 24u, clusters.ClusterCount());
+            Assert::AreEqual(0.1f, clusters.ClusterBounds(clusters.ClusterIndex(0, 0, 0)).min[2], 1e-6f);
+            Assert::AreEqual(1000.0f, clusters.ClusterBounds(clusters.ClusterIndex(15, 8, 23)).max[2], 0.01f);
+
+            // Tile (0, 0) is the top left of the screen.
+            const aabb_t& topLeft = clusters.ClusterBounds(clusters.ClusterIndex(0, 0, 10));
+            Assert::IsTrue(topLeft.max[0] < 0.0f);
+            Assert::IsTrue(topLeft.min[1] > 0.0f);
+
+            // The last slice starts where the one before it ends.
+            const aabb_t& last = clusters.ClusterBounds(clusters.ClusterIndex(0, 0, 23));
+            const aabb_t& beforeLast = clusters.ClusterBounds(clusters.ClusterIndex(0, 0, 22));
+            Assert::AreEqual(beforeLast.max[2], last.min[2], 1e-3f);
+
+            for (const cluster_light_list_t& list : clusters.ClusterLists())
+            {
+                Assert::AreEqual(0u, list.count);
+            }
+        }
+
+        TEST_METHOD(ClusterAtFindsTheClusterHoldingThePoint)
+        {
+            Camera camera(Size(1280, 720), 0.5f, 200.0f);
+            LightClusters clusters;
+            Random random(7);
+
+            clusters.Assign(camera, nullptr, 0);
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                const unsigned int x = random.NextUInt(clusters.ClustersX());
+                const unsigned int y = random.NextUInt(clusters.ClustersY());
+                const unsigned int z = random.NextUInt(clusters.ClustersZ());
+                const aabb_t& box = clusters.ClusterBounds(clusters.ClusterIndex(x, y, z));
+
+                // The middle of the froxel: depth halfway through the slice, on the ray through the tile's center.
+                const float depth = 0.5f * (box.min[2] + box.max[2]);
+                const float ndcX = -1.0f + (2.0f * x + 1.0f) / clusters.ClustersX();
+                const float ndcY = 1.0f - (2.0f * y + 1.0f) / clusters.ClustersY();
+                const float tanY = std::tan(camera.FieldOfView() * 0.5f);
+                const Vector3 point(ndcX * depth * tanY * camera.AspectRatio(), ndcY * depth * tanY, depth);
+
+                Assert::AreEqual(clusters.ClusterIndex(x, y, z), clusters.ClusterAt(point));
+                Assert::IsTrue(Contains(box, point));
+
+                const float slice = std::log(depth) * clusters.DepthSliceScale() - clusters.DepthSliceBias();
+                Assert::AreEqual(static_cast<float>(z), std::floor(slice));
+            }
+
+            // Points off screen or past the far plane clamp to the edge clusters.
+            Assert::AreEqual(clusters.ClusterIndex(0, 0, 0), clusters.ClusterAt(Vector3(-100.0f, 100.0f, 0.0f)));
+            Assert::AreEqual(clusters.ClusterIndex(15, 8, 23), clusters.ClusterAt(Vector3(1e4f, -1e4f, 1e4f)));
+        }
+
+        TEST_METHOD(EveryLightReachingAPointIsInItsCluster)
+        {
+            Camera camera(Size(1280, 720), 0.1f, 300.0f);
+            camera.SetPosition(Vector3(5.0f, 4.0f, -10.0f));
+            camera.SetRotation(Vector3(8.0f, 12.0f, 0.0f));
+
+            const std::vector<local_light_t> lights = RandomLights(42, 500);
+            ThreadPool pool(1);
+            LightClusters clusters;
+
+            clusters.Assign(camera, lights.data(), lights.size(), pool);
+
+            const Matrix& view = camera.ViewMatrix();
+            const Matrix world = view.Invert();
+            Random random(9);
+            size_t hits = 0;
+
+            for (int i = 0; i < 4000; ++i)
+            {
+                // A random point in front of the camera, within the first 150 units.
+                const Vector3 viewPoint(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f),
+                                        random.NextFloat(0.2f, 150.0f));
+                const float tanY = std::tan(camera.FieldOfView() * 0.5f);
+                const Vector3 onScreen(viewPoint.x * viewPoint.z * tanY * camera.AspectRatio(),
+                                       viewPoint.y * viewPoint.z * tanY, viewPoint.z);
+                const Vector3 worldPoint = Vector3::Transform(onScreen, world);
+                const unsigned int cluster = clusters.ClusterAt(onScreen);
+
+                for (size_t light = 0; light < lights.size(); ++light)
+                {
+                    if (Contains(LightClusters::LightBounds(lights[light]), worldPoint, -1e-3f))
+                    {
+                        Assert::IsTrue(Listed(clusters, cluster, static_cast<unsigned short>(light)));
+                        ++hits;
+                    }
+                }
+            }
+
+            Assert::IsTrue(hits > 100);
+        }
+
+        TEST_METHOD(ThreadedAssignmentMatchesSingleThread)
+        {
+            Camera camera(Size(1920, 1080), 0.1f, 500.0f);
+            camera.SetRotation(Vector3(5.0f, -20.0f, 0.0f));
+
+            const std::vector<local_light_t> lights = RandomLights(3, 1000);
+            ThreadPool single(1);
+            ThreadPool many(4);
+            LightClusters first;
+            LightClusters second;
+
+            first.Assign(camera, lights.data(), lights.size(), single);
+            second.Assign(camera, lights.data(), lights.size(), many);
+
+            // A second call with the same lights gives the same answer from reused buffers.
+            second.Assign(camera, lights.data(), lights.size(), many);
+
+            Assert::IsTrue(first.LightIndices() == second.LightIndices());
+            Assert::IsTrue(first.LightIndices().size() > lights.size());
+
+            for (unsigned int cluster = 0; cluster < first.ClusterCount(); ++cluster)
+            {
+                Assert::AreEqual(first.ClusterLists()[cluster].offset, second.ClusterLists()[cluster].offset);
+                Assert::AreEqual(first.ClusterLists()[cluster].count, second.ClusterLists()[cluster].count);
+            }
+        }
+
+        TEST_METHOD(ListsArePackedInClusterOrder)
+        {
+            Camera camera(Size(1280, 720), 0.1f, 300.0f);
+            const std::vector<local_light_t> lights = RandomLights(11, 300);
+            LightClusters clusters(8, 4, 12);
+
+            clusters.Assign(camera, lights.data(), lights.size());
+
+            unsigned int offset = 0;
+
+            for (const cluster_light_list_t& list : clusters.ClusterLists())
+            {
+                Assert::AreEqual(offset, list.offset);
+
+                // Within a list lights keep their order and are not repeated.
+                for (unsigned int i = 1; i < list.count; ++i)
+                {
+                    Assert::IsTrue(clusters.LightIndices()[offset + i - 1] < clusters.LightIndices()[offset + i]);
+                }
+
+                offset += list.count;
+            }
+
+            Assert::AreEqual(clusters.LightIndices().size(), static_cast<size_t>(offset));
+        }
+
+        TEST_METHOD(SpotBoundsHoldTheWholeCone)
+        {
+            const float cosAngles[] = { 0.98f, 0.8f, 0.7071f, 0.5f, 0.1f };
+
+            for (float cosAngle : cosAngles)
+            {
+                const Vector3 position(1.0f, 2.0f, 3.0f);
+                const Vector3 direction(0.0f, 0.0f, 1.0f);
+                const float range = 10.0f;
+                const float sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+
+                const bounding_sphere_t sphere =
+                    LightClusters::LightBounds(SpotLight(position, direction, range, cosAngle));
+
+                Assert::IsTrue(sphere.radius <= range + 1e-4f);
+                Assert::IsTrue(Contains(sphere, position, 1e-3f));
+                Assert::IsTrue(Contains(sphere, position + direction * range, 1e-3f));
+                Assert::IsTrue(Contains(sphere, position + Vector3(sinAngle, 0.0f, cosAngle) * range, 1e-3f));
+                Assert::IsTrue(Contains(sphere, position + Vector3(0.0f, -sinAngle, cosAngle) * range, 1e-3f));
+            }
+
+            const bounding_sphere_t point = LightClusters::LightBounds(PointLight(Vector3(1.0f, 2.0f, 3.0f), 4.0f));
+            Assert::AreEqual(4.0f, point.radius);
+            Assert::AreEqual(2.0f, point.center[1]);
+        }
+
+        TEST_METHOD(LightsOutsideTheFrustumAreNotAssigned)
+        {
+            Camera camera(Size(1280, 720), 0.1f, 100.0f);
+
+            const local_light_t lights[] =
+            {
+                PointLight(Vector3(0.0f, 0.0f, -20.0f), 5.0f),
+                PointLight(Vector3(0.0f, 0.0f, 300.0f), 5.0f),
+                PointLight(Vector3(500.0f, 0.0f, 20.0f), 5.0f),
+                SpotLight(Vector3(0.0f, 0.0f, -2.0f), Vector3(0.0f, 0.0f, -1.0f), 10.0f, 0.9f)
+            };
+
+            LightClusters clusters;
+            clusters.Assign(camera, lights, 4);
+
+            Assert::AreEqual(static_cast<size_t>(0), clusters.LightIndices().size());
+
+            // Turn around and the first and last lights are in view.
+            camera.SetRotation(Vector3(0.0f, 180.0f, 0.0f));
+            clusters.Assign(camera, lights, 4);
+
+            const unsigned int cluster = clusters.ClusterAt(Vector3(0.0f, 0.0f, 20.0f));
+            Assert::IsTrue(Listed(clusters, cluster, 0));
+            Assert::IsFalse(Listed(clusters, cluster, 1));
+            Assert::IsTrue(Listed(clusters, clusters.ClusterAt(Vector3(0.0f, 0.0f, 8.0f)), 3));
+        }
+    };
+}
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "LodSelector.h"
+
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(LodSelectorTests)
+    {
+    private:
+        // 90 degree field of view on a 1000 pixel tall screen: one unit at distance one covers 500 pixels.
+        const float FieldOfView = 3.14159265f / 2.0f;
+        const float ScreenHeight = 1000.0f;
+
+    public:
+        TEST_METHOD(ProjectedErrorScalesWithScreenAndDistance)
+        {
+            LodSelector selector;
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            Assert::AreEqual(500.0f, selector.ProjectedError(1.0f, 1.0f), 1e-2f);
+            Assert::AreEqual(5.0f, selector.ProjectedError(0.1f, 10.0f), 1e-3f);
+
+            selector.BeginFrame(FieldOfView, ScreenHeight * 2.0f);
+            Assert::AreEqual(10.0f, selector.ProjectedError(0.1f, 10.0f), 1e-3f);
+        }
+
+        TEST_METHOD(SelectsCoarsestLevelUnderThreshold)
+        {
+            const float errors[] = { 0.0f, 0.001f, 0.01f, 0.1f };
+
+            LodSelector selector;
+            selector.SetPixelThreshold(1.0f);
+            selector.SetHysteresis(0.0f);
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            // At distance d a level with error e covers 500 * e / d pixels.
+            Assert::AreEqual(0u, selector.SelectLevel(errors, 4, 0.4f, 0.0f, 1.0f, 0));
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 4, 1.0f, 0.0f, 1.0f, 0));
+            Assert::AreEqual(2u, selector.SelectLevel(errors, 4, 10.0f, 0.0f, 1.0f, 0));
+            Assert::AreEqual(3u, selector.SelectLevel(errors, 4, 100.0f, 0.0f, 1.0f, 0));
+
+            // The bounding sphere brings the object closer, world scale makes the error larger.
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 4, 10.0f, 5.5f, 1.0f, 0));
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 4, 10.0f, 0.0f, 3.0f, 0));
+        }
+
+        TEST_METHOD(CameraInsideBoundsGetsFullDetail)
+        {
+            const float errors[] = { 0.0f, 1e-6f };
+
+            LodSelector selector;
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            Assert::AreEqual(0u, selector.SelectLevel(errors, 2, 1.0f, 2.0f, 1.0f, 1));
+        }
+
+        TEST_METHOD(HysteresisPreventsPopping)
+        {
+            const float errors[] = { 0.0f, 0.01f };
+
+            LodSelector selector;
+            selector.SetPixelThreshold(1.0f);
+            selector.SetHysteresis(0.2f);
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            // Level 1 is exactly one pixel at distance 5. Near the switching distance the previous choice sticks.
+            Assert::AreEqual(0u, selector.SelectLevel(errors, 2, 5.5f, 0.0f, 1.0f, 0));
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 2, 4.5f, 0.0f, 1.0f, 1));
+
+            // Well past the dead band it switches.
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 2, 6.5f, 0.0f, 1.0f, 0));
+            Assert::AreEqual(0u, selector.SelectLevel(errors, 2, 4.0f, 0.0f, 1.0f, 1));
+        }
+
+        TEST_METHOD(LodBiasTradesDetailForSpeed)
+        {
+            const float errors[] = { 0.0f, 0.01f, 0.02f };
+
+            LodSelector selector;
+            selector.SetHysteresis(0.0f);
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            Assert::AreEqual(1u, selector.SelectLevel(errors, 3, 5.0f, 0.0f, 1.0f, 0));
+
+            selector.SetLodBias(1.0f);
+            Assert::AreEqual(2u, selector.SelectLevel(errors, 3, 5.0f, 0.0f, 1.0f, 0));
+
+            selector.SetLodBias(-1.0f);
+            Assert::AreEqual(0u, selector.SelectLevel(errors, 3, 5.0f, 0.0f, 1.0f, 0));
+        }
+
+        TEST_METHOD(FrameStatsCountDrawsAndResetEachFrame)
+        {
+            LodSelector selector;
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            selector.RecordDraw(100, 1000);
+            selector.RecordDraw(50, 50);
+
+            Assert::AreEqual(2u, selector.FrameStats().objectsDrawn);
+            Assert::AreEqual(150ull, selector.FrameStats().trianglesSubmitted);
+            Assert::AreEqual(1050ull, selector.FrameStats().trianglesAtFullDetail);
+
+            selector.BeginFrame(FieldOfView, ScreenHeight);
+
+            Assert::AreEqual(0u, selector.FrameStats().objectsDrawn);
+            Assert::AreEqual(0ull, selector.FrameStats().trianglesSubmitted);
+        }
+    };
+}
@@ -0,0 +1,134 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "LzCodec.h"
+
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(LzCodecTests)
+    {
+    private:
+        // Compress and decompress, checking the output matches. Returns the compressed size.
+        static size_t RoundTrip(const std::string& input)
+        {
+            std::vector<char> compressed(LzCodec::MaxCompressedSize(input.size()));
+            size_t compressedSize = LzCodec::Compress(input.data(), input.size(), &compressed[0], compressed.size());
+
+            Assert::IsTrue(compressedSize > 0);
+            Assert::IsTrue(compressedSize <= compressed.size());
+
+            std::string output(input.size(), '\0');
+            bool decompressed = LzCodec::Decompress(
+                &compressed[0],
+                compressedSize,
+                input.empty() ? nullptr : &output[0],
+                output.size());
+
+            Assert::IsTrue(decompressed);
+            Assert::IsTrue(input == output);
+
+            return compressedSize;
+        }
+
+        // Deterministic noise that does not compress.
+        static std::string Noise(size_t size)
+        {
+            std::string noise(size, '\0');
+            unsigned int state = 12345;
+
+            for (char& c : noise)
+            {
+                state = state * 1664525u + 1013904223u;
+                c = static_cast<char>(state >> 24);
+            }
+
+            return noise;
+        }
+
+    public:
+        TEST_METHOD(LzRoundTripsSmallInputs)
+        {
+            RoundTrip("");
+            RoundTrip("a");
+            RoundTrip("abc");
+            RoundTrip("abcd");
+            RoundTrip("abcdabcd");
+            RoundTrip("hello hello hello hello");
+        }
+
+        TEST_METHOD(LzCompressesRepetitiveData)
+        {
+            std::string text;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                text += "v " + std::to_string(i % 37) + ".5 1.0 -2.25\n";
+            }
+
+            Assert::IsTrue(RoundTrip(text) < text.size() / 4);
+
+            // Long runs exercise overlapping matches and lengths longer than a token holds.
+            Assert::IsTrue(RoundTrip(std::string(100000, 'z')) < 1000);
+            Assert::IsTrue(RoundTrip(std::string(300, 'a') + std::string(300, 'b') + "tail") < 50);
+        }
+
+        TEST_METHOD(LzRoundTripsIncompressibleData)
+        {
+            std::string noise = Noise(70000);
+            Assert::IsTrue(RoundTrip(noise) <= LzCodec::MaxCompressedSize(noise.size()));
+
+            // Noise with matches further apart than the maximum offset.
+            std::string repeatedNoise = Noise(70000) + Noise(70000);
+            RoundTrip(repeatedNoise);
+        }
+
+        TEST_METHOD(LzCompressFailsWhenOutputIsTooSmall)
+        {
+            std::string noise = Noise(1000);
+            std::vector<char> compressed(500);
+
+            size_t compressedSize = LzCodec::Compress(noise.data(), noise.size(), &compressed[0], compressed.size());
+            Assert::AreEqual((size_t)0, compressedSize);
+        }
+
+        TEST_METHOD(LzDecompressRejectsCorruptInput)
+        {
+            std::string input;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                input += "corrupt " + std::to_string(i % 5);
+            }
+
+            std::vector<char> compressed(LzCodec::MaxCompressedSize(input.size()));
+            size_t compressedSize = LzCodec::Compress(input.data(), input.size(), &compressed[0], compressed.size());
+            std::string output(input.size(), '\0');
+
+            // Wrong output sizes.
+            Assert::IsFalse(LzCodec::Decompress(&compressed[0], compressedSize, &output[0], output.size() - 1));
+            output.push_back('\0');
+            Assert::IsFalse(LzCodec::Decompress(&compressed[0], compressedSize, &output[0], output.size()));
+            output.pop_back();
+
+            // Truncated input.
+            Assert::IsFalse(LzCodec::Decompress(&compressed[0], compressedSize / 2, &output[0], output.size()));
+
+            // An offset reaching back before the start of the output.
+            const char badOffset[] = { 0x10, 'a', static_cast<char>(0xFF), 0x00 };
+            Assert::IsFalse(LzCodec::Decompress(badOffset, sizeof(badOffset), &output[0], 100));
+
+            // Any single corrupted byte either still decodes to the right size or is rejected, never overruns.
+            for (size_t i = 0; i < compressedSize; ++i)
+            {
+                std::vector<char> corrupt(compressed.begin(), compressed.begin() + compressedSize);
+                corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5A);
+
+                LzCodec::Decompress(&corrupt[0], corrupt.size(), &output[0], output.size());
+            }
+        }
+    };
+}
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "MemoryTracker.h"
+
+#include <cstdint>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    // Tracker state is global, so these tests only charge the Audio tag, which nothing else in the tests uses, and
+    // compare counts before and after.
+    TEST_CLASS(MemoryTrackerTests)
+    {
+    private:
+        static unsigned int sOverBudgetCalls;
+        static memory_tag_stats_t sOverBudgetStats;
+
+        static void OnOverBudget(MemoryTag tag, const memory_tag_stats_t& stats)
+        {
+            if (tag == MemoryTag::Audio)
+            {
+                sOverBudgetCalls++;
+                sOverBudgetStats = stats;
+            }
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(EnableTracking)
+        {
+            MemoryTracker::SetEnabled(true);
+        }
+
+        TEST_METHOD_CLEANUP(DisableTracking)
+        {
+            MemoryTracker::SetEnabled(false);
+            MemoryTracker::SetBudget(MemoryTag::Audio, 0);
+            MemoryTracker::SetBudgetHandler(nullptr);
+        }
+
+        TEST_METHOD(TracksCurrentPeakAndFrameCounts)
+        {
+            MemoryTracker::EndFrame();
+            const memory_tag_stats_t before = MemoryTracker::Stats(MemoryTag::Audio);
+
+            void * pA = MemoryTracker::Allocate(1000, MemoryTag::Audio);
+            void * pB = MemoryTracker::Allocate(24, MemoryTag::Audio);
+
+            memory_tag_stats_t stats = MemoryTracker::Stats(MemoryTag::Audio);
+            Assert::AreEqual(before.currentBytes + 1024, stats.currentBytes);
+            Assert::AreEqual(before.currentCount + 2, stats.currentCount);
+            Assert::IsTrue(stats.peakBytes >= stats.currentBytes);
+
+            MemoryTracker::Free(pA);
+            MemoryTracker::Free(pB);
+            MemoryTracker::Free(nullptr);
+            MemoryTracker::EndFrame();
+
+            stats = MemoryTracker::Stats(MemoryTag::Audio);
+            Assert::AreEqual(before.currentBytes, stats.currentBytes);
+            Assert::AreEqual(before.currentCount, stats.currentCount);
+            Assert::IsTrue(stats.peakBytes >= before.currentBytes + 1024);
+            Assert::AreEqual(2ull, stats.lastFrameCount);
+            Assert::AreEqual(1024ull, stats.lastFrameBytes);
+
+            // Per frame counts start over every frame.
+            MemoryTracker::EndFrame();
+            Assert::AreEqual(0ull, MemoryTracker::Stats(MemoryTag::Audio).lastFrameCount);
+        }
+
+        TEST_METHOD(BlocksAreUsableAndAligned)
+        {
+            char * pMemory = static_cast<char *>(MemoryTracker::Allocate(100, MemoryTag::Audio));
+
+            Assert::IsNotNull(pMemory);
+            Assert::AreEqual(0u, static_cast<unsigned int>(reinterpret_cast<uintptr_t>(pMemory) % sizeof(void *)));
+
+            pMemory[0] = 1;
+            pMemory[99] = 2;
+
+            MemoryTracker::Free(pMemory);
+        }
+
+        TEST_METHOD(TagScopesNestAndChargeCurrentTag)
+        {
+            const MemoryTag outerTag = MemoryTracker::CurrentTag();
+            const unsigned long long before = MemoryTracker::Stats(MemoryTag::Audio).currentBytes;
+
+            {
+                MemoryTagScope audio(MemoryTag::Audio);
+
+                {
+                    MemoryTagScope text(MemoryTag::Text);
+                    Assert::IsTrue(MemoryTag::Text == MemoryTracker::CurrentTag());
+                }
+
+                Assert::IsTrue(MemoryTag::Audio == MemoryTracker::CurrentTag());
+
+                void * pMemory = MemoryTracker::Allocate(64);
+                Assert::AreEqual(before + 64, MemoryTracker::Stats(MemoryTag::Audio).currentBytes);
+                MemoryTracker::Free(pMemory);
+            }
+
+            Assert::IsTrue(outerTag == MemoryTracker::CurrentTag());
+            Assert::AreEqual(std::string("Audio"), std::string(MemoryTracker::TagName(MemoryTag::Audio)));
+        }
+
+        TEST_METHOD(BlocksAllocatedWhileDisabledAreNeverCounted)
+        {
+            MemoryTracker::SetEnabled(false);
+            const memory_tag_stats_t before = MemoryTracker::Stats(MemoryTag::Audio);
+
+            void * pMemory = MemoryTracker::Allocate(500, MemoryTag::Audio);
+            Assert::AreEqual(before.currentBytes, MemoryTracker::Stats(MemoryTag::Audio).currentBytes);
+
+            // Freeing it after tracking is turned on must not take it off the books either.
+            MemoryTracker::SetEnabled(true);
+            MemoryTracker::Free(pMemory);
+
+            const memory_tag_stats_t after = MemoryTracker::Stats(MemoryTag::Audio);
+            Assert::AreEqual(before.currentBytes, after.currentBytes);
+            Assert::AreEqual(before.currentCount, after.currentCount);
+        }
+
+        TEST_METHOD(BudgetOverrunsAreReportedOncePerOverrun)
+        {
+            sOverBudgetCalls = 0;
+            MemoryTracker::SetBudgetHandler(&OnOverBudget);
+            MemoryTracker::SetBudget(MemoryTag::Audio, MemoryTracker::Stats(MemoryTag::Audio).currentBytes + 1000);
+            MemoryTracker::EndFrame();
+
+            void * pSmall = MemoryTracker::Allocate(500, MemoryTag::Audio);
+            MemoryTracker::EndFrame();
+            Assert::AreEqual(0u, sOverBudgetCalls);
+
+            // Goes over, and stays over for a few frames.
+            void * pLarge = MemoryTracker::Allocate(1000, MemoryTag::Audio);
+            MemoryTracker::EndFrame();
+
+            Assert::AreEqual(1u, sOverBudgetCalls);
+            Assert::IsTrue(sOverBudgetStats.overBudget);
+            Assert::IsTrue(sOverBudgetStats.currentBytes > sOverBudgetStats.budgetBytes);
+
+            void * pMore = MemoryTracker::Allocate(10, MemoryTag::Audio);
+            MemoryTracker::EndFrame();
+            MemoryTracker::EndFrame();
+            Assert::AreEqual(1u, sOverBudgetCalls);
+
+            // Back under budget, then over again.
+            MemoryTracker::Free(pLarge);
+            MemoryTracker::EndFrame();
+            Assert::IsFalse(MemoryTracker::Stats(MemoryTag::Audio).overBudget);
+
+            pLarge = MemoryTracker::Allocate(1000, MemoryTag::Audio);
+            MemoryTracker::EndFrame();
+            Assert::AreEqual(2u, sOverBudgetCalls);
+
+            MemoryTracker::Free(pSmall);
+            MemoryTracker::Free(pLarge);
+            MemoryTracker::Free(pMore);
+        }
+
+        TEST_METHOD(SnapshotExportsEveryTagAsJson)
+        {
+            void * pMemory = MemoryTracker::Allocate(128, MemoryTag::Audio);
+
+            const memory_snapshot_t snapshot = MemoryTracker::Snapshot();
+            const std::string json = MemoryTracker::ToJson(snapshot);
+
+            MemoryTracker::Free(pMemory);
+
+            Assert::IsTrue(snapshot.enabled);
+            Assert::IsTrue(snapshot.tags[static_cast<size_t>(MemoryTag::Audio)].currentBytes >= 128);
+
+            Assert::AreEqual('{', json[0]);
+            Assert::IsTrue(json.find("\"enabled\": true") != std::string::npos);
+
+            for (size_t i = 0; i < MemoryTagCount; ++i)
+            {
+                const std::string name = std::string("\"") + MemoryTracker::TagName(static_cast<MemoryTag>(i)) + "\"";
+                Assert::IsTrue(json.find(name) != std::string::npos);
+            }
+
+            Assert::IsTrue(json.find("\"peakBytes\": ") != std::string::npos);
+            Assert::IsTrue(json.find("\"overBudget\": false") != std::string::npos);
+        }
+    };
+
+    unsigned int MemoryTrackerTests::sOverBudgetCalls = 0;
+    memory_tag_stats_t MemoryTrackerTests::sOverBudgetStats;
+}
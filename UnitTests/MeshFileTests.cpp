@@ -0,0 +1,203 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "DXTestException.h"
+#include "MeshFile.h"
+#include "MeshletBuilder.h"
+#include "MeshData.h"
+#include "StreamReader.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(MeshFileTests)
+    {
+    private:
+        s_mesh_data_t MakeMesh() const
+        {
+            s_mesh_data_t mesh;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                float f = static_cast<float>(i);
+                s_mesh_vertex_t v = { f, f * 2.0f, -f, f / 10.0f, 1.0f - f / 10.0f, 0.0f, 1.0f, 0.0f };
+                mesh.vertices.push_back(v);
+            }
+
+            for (int i = 0; i < 8; ++i)
+            {
+                mesh.indices.push_back(i);
+                mesh.indices.push_back(i + 2);
+                mesh.indices.push_back(i + 1);
+            }
+
+            return mesh;
+        }
+
+    public:
+        TEST_METHOD(MeshFileRoundTripsMeshAndMeshlets)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+            MeshletBuilder::Build(mesh, &mesh.meshlets, 4, 3);
+
+            std::vector<char> buffer;
+            MeshFile::Write(mesh, &buffer);
+
+            Assert::AreEqual((size_t)0, buffer.size() % 4);
+
+            s_mesh_data_t loaded;
+            MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+
+            Assert::AreEqual(mesh.vertices.size(), loaded.vertices.size());
+            Assert::AreEqual(0, std::memcmp(&mesh.vertices[0], &loaded.vertices[0], mesh.vertices.size() * sizeof(s_mesh_vertex_t)));
+            Assert::IsTrue(mesh.indices == loaded.indices);
+
+            Assert::AreEqual(mesh.meshlets.meshlets.size(), loaded.meshlets.meshlets.size());
+            Assert::AreEqual(mesh.meshlets.bounds.size(), loaded.meshlets.bounds.size());
+            Assert::IsTrue(mesh.meshlets.vertices == loaded.meshlets.vertices);
+            Assert::IsTrue(mesh.meshlets.triangles == loaded.meshlets.triangles);
+            Assert::AreEqual(0, std::memcmp(
+                &mesh.meshlets.bounds[0],
+                &loaded.meshlets.bounds[0],
+                mesh.meshlets.bounds.size() * sizeof(meshlet_bounds_t)));
+        }
+
+        TEST_METHOD(MeshFileRoundTripsLods)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+
+            s_mesh_lod_t lod;
+            lod.indices.assign(mesh.indices.begin(), mesh.indices.begin() + 12);
+            lod.error = 0.25f;
+            mesh.lods.push_back(lod);
+
+            lod.indices.assign(mesh.indices.begin(), mesh.indices.begin() + 3);
+            lod.error = 1.5f;
+            mesh.lods.push_back(lod);
+
+            std::vector<char> buffer;
+            MeshFile::Write(mesh, &buffer);
+
+            s_mesh_data_t loaded;
+            MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+
+            Assert::AreEqual((size_t)2, loaded.lods.size());
+
+            for (size_t i = 0; i < mesh.lods.size(); ++i)
+            {
+                Assert::IsTrue(mesh.lods[i].indices == loaded.lods[i].indices);
+                Assert::AreEqual(mesh.lods[i].error, loaded.lods[i].error);
+            }
+        }
+
+        TEST_METHOD(MeshFileStoresBounds)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+
+            std::vector<char> buffer;
+            MeshFile::Write(mesh, &buffer);
+
+            s_mesh_data_t loaded;
+            MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+
+            // Vertices run from (0, 0, 0) to (9, 18, -9).
+            Assert::AreEqual(0.0f, loaded.bounds.box.min[0]);
+            Assert::AreEqual(-9.0f, loaded.bounds.box.min[2]);
+            Assert::AreEqual(18.0f, loaded.bounds.box.max[1]);
+            Assert::AreEqual(std::sqrt(9.0f * 9.0f + 18.0f * 18.0f + 9.0f * 9.0f) * 0.5f, loaded.bounds.sphere.radius, 1e-3f);
+
+            // Version 2 files have no bounds section, loading them computes the same bounds.
+            unsigned int version = 2;
+            std::vector<char> oldBuffer(buffer.begin(), buffer.end() - sizeof(mesh_bounds_t));
+            std::memcpy(&oldBuffer[4], &version, sizeof(version));
+
+            s_mesh_data_t oldLoaded;
+            MeshFile::Read(&oldBuffer[0], oldBuffer.size(), L"test", &oldLoaded);
+
+            Assert::AreEqual(0, std::memcmp(&loaded.bounds, &oldLoaded.bounds, sizeof(mesh_bounds_t)));
+        }
+
+        TEST_METHOD(MeshFileWithoutMeshletsRoundTrips)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+
+            std::vector<char> buffer;
+            MeshFile::Write(mesh, &buffer);
+
+            s_mesh_data_t loaded;
+            MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+
+            Assert::IsTrue(mesh.indices == loaded.indices);
+            Assert::IsTrue(loaded.meshlets.meshlets.empty());
+        }
+
+        TEST_METHOD(MeshFileRejectsBadMagic)
+        {
+            std::vector<char> buffer;
+            MeshFile::Write(MakeMesh(), &buffer);
+            buffer[0] = 'X';
+
+            s_mesh_data_t loaded;
+            Assert::ExpectException<FileFormatException>([&]() {
+                MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+            });
+        }
+
+        TEST_METHOD(MeshFileRejectsTruncatedFile)
+        {
+            std::vector<char> buffer;
+            MeshFile::Write(MakeMesh(), &buffer);
+            buffer.resize(buffer.size() - 8);
+
+            s_mesh_data_t loaded;
+            Assert::ExpectException<FileFormatException>([&]() {
+                MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+            });
+        }
+
+        TEST_METHOD(MeshFileRejectsOutOfRangeIndex)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+            mesh.indices[4] = 1000;
+
+            std::vector<char> buffer;
+            MeshFile::Write(mesh, &buffer);
+
+            s_mesh_data_t loaded;
+            Assert::ExpectException<FileFormatException>([&]() {
+                MeshFile::Read(&buffer[0], buffer.size(), L"test", &loaded);
+            });
+        }
+
+        TEST_METHOD(MeshFileLoadStreamsThroughSmallWindows)
+        {
+            s_mesh_data_t mesh = MakeMesh();
+            MeshletBuilder::Build(mesh, &mesh.meshlets, 4, 3);
+            MeshFile::Save(mesh, L"MeshFileTests_stream.mesh");
+
+            // A window smaller than any section forces every array to be read across chunk boundaries.
+            s_mesh_data_t loaded;
+
+            {
+                StreamReader reader(L"MeshFileTests_stream.mesh", 16);
+                MeshFile::Read(reader, &loaded);
+                Assert::IsTrue(reader.IsEnd());
+            }
+
+            std::remove("MeshFileTests_stream.mesh");
+
+            Assert::AreEqual(mesh.vertices.size(), loaded.vertices.size());
+            Assert::AreEqual(0, std::memcmp(
+                &mesh.vertices[0],
+                &loaded.vertices[0],
+                mesh.vertices.size() * sizeof(s_mesh_vertex_t)));
+            Assert::IsTrue(mesh.indices == loaded.indices);
+            Assert::IsTrue(mesh.meshlets.triangles == loaded.meshlets.triangles);
+        }
+    };
+}
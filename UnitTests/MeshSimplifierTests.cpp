@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "MeshSimplifier.h"
+#include "MeshData.h"
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(MeshSimplifierTests)
+    {
+    private:
+        // Build a flat size x size quad grid in the XY plane. When seamColumn is in (0, size) the vertices in that
+        // column are duplicated with different texture coordinates, the way exporters split UV islands.
+        s_mesh_data_t MakeGridMesh(int size, int seamColumn = -1) const
+        {
+            s_mesh_data_t mesh;
+            std::vector<int> left((size + 1) * (size + 1)), right((size + 1) * (size + 1));
+
+            for (int y = 0; y <= size; ++y)
+            {
+                for (int x = 0; x <= size; ++x)
+                {
+                    s_mesh_vertex_t v = { static_cast<float>(x), static_cast<float>(y), 0.0f, 0.0f, 0.0f, 0, 0, -1 };
+                    int cell = y * (size + 1) + x;
+
+                    left[cell] = right[cell] = static_cast<int>(mesh.vertices.size());
+                    mesh.vertices.push_back(v);
+
+                    if (x == seamColumn)
+                    {
+                        v.tu = 1.0f;
+                        right[cell] = static_cast<int>(mesh.vertices.size());
+                        mesh.vertices.push_back(v);
+                    }
+                }
+            }
+
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x = 0; x < size; ++x)
+                {
+                    const std::vector<int>& side = (x < seamColumn ? left : right);
+                    int a = side[y * (size + 1) + x];
+                    int b = side[y * (size + 1) + x + 1];
+                    int c = side[(y + 1) * (size + 1) + x];
+                    int d = side[(y + 1) * (size + 1) + x + 1];
+
+                    int quad[6] = { a, c, b, b, c, d };
+                    mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+                }
+            }
+
+            return mesh;
+        }
+
+        // Closed lumpy sphere with a texture seam along one meridian and welded poles.
+        s_mesh_data_t MakeSphereMesh(int rings, int segments) const
+        {
+            const float pi = 3.14159265358979f;
+            s_mesh_data_t mesh;
+
+            for (int i = 0; i <= rings; ++i)
+            {
+                for (int j = 0; j <= segments; ++j)
+                {
+                    float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+                    float phi = 2.0f * pi * static_cast<float>(j % segments) / static_cast<float>(segments);
+                    float bump = 1.0f + 0.05f * std::sin(theta * 6.0f) * std::cos(phi * 5.0f);
+
+                    s_mesh_vertex_t v;
+                    v.nx = std::sin(theta) * std::cos(phi);
+                    v.ny = std::cos(theta);
+                    v.nz = std::sin(theta) * std::sin(phi);
+                    v.x = v.nx * bump;
+                    v.y = v.ny * bump;
+                    v.z = v.nz * bump;
+                    v.tu = static_cast<float>(j) / static_cast<float>(segments);
+                    v.tv = static_cast<float>(i) / static_cast<float>(rings);
+
+                    if (i == 0 || i == rings)
+                    {
+                        v.x = v.z = 0.0f;
+                    }
+
+                    mesh.vertices.push_back(v);
+                }
+            }
+
+            for (int i = 0; i < rings; ++i)
+            {
+                for (int j = 0; j < segments; ++j)
+                {
+                    int a = i * (segments + 1) + j;
+                    int b = a + 1;
+                    int c = a + segments + 1;
+                    int d = c + 1;
+
+                    int quad[6] = { a, b, c, b, d, c };
+                    mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+                }
+            }
+
+            return mesh;
+        }
+
+        float Area(const s_mesh_data_t& mesh, const std::vector<int>& indices) const
+        {
+            double area = 0.0;
+
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                const s_mesh_vertex_t& a = mesh.vertices[indices[i + 0]];
+                const s_mesh_vertex_t& b = mesh.vertices[indices[i + 1]];
+                const s_mesh_vertex_t& c = mesh.vertices[indices[i + 2]];
+
+                area += 0.5 * std::abs((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+            }
+
+            return static_cast<float>(area);
+        }
+
+        // Total length of edges used by only one triangle, comparing vertex indices (so seams count as open).
+        float OpenEdgeLength(const s_mesh_data_t& mesh, const std::vector<int>& indices) const
+        {
+            std::map<std::pair<int, int>, int> edges;
+
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    edges[std::make_pair(indices[i + k], indices[i + (k + 1) % 3])]++;
+                }
+            }
+
+            double length = 0.0;
+
+            for (auto& edge : edges)
+            {
+                if (edges.count(std::make_pair(edge.first.second, edge.first.first)) == 0)
+                {
+                    const s_mesh_vertex_t& a = mesh.vertices[edge.first.first];
+                    const s_mesh_vertex_t& b = mesh.vertices[edge.first.second];
+
+                    length += std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+                }
+            }
+
+            return static_cast<float>(length);
+        }
+
+    public:
+        TEST_METHOD(SimplifyFlatGridKeepsShapeWithoutError)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(32);
+            std::vector<int> indices;
+
+            size_t target = mesh.indices.size() / 10;
+            float error = MeshSimplifier::Simplify(mesh, target, &indices);
+
+            Assert::IsTrue(indices.size() <= target);
+            Assert::IsTrue(indices.size() > 0);
+            Assert::AreEqual(0.0f, error, 1e-5f);
+
+            // Nothing moved off the plane or away from the border.
+            Assert::AreEqual(32.0f * 32.0f, Area(mesh, indices), 1e-2f);
+            Assert::AreEqual(4.0f * 32.0f, OpenEdgeLength(mesh, indices), 1e-3f);
+        }
+
+        TEST_METHOD(SimplifyKeepsTextureSeams)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(32, 12);
+            std::vector<int> indices;
+
+            MeshSimplifier::Simplify(mesh, mesh.indices.size() / 8, &indices);
+
+            Assert::IsTrue(indices.size() < mesh.indices.size() / 4);
+            Assert::AreEqual(32.0f * 32.0f, Area(mesh, indices), 1e-2f);
+
+            // The border plus both sides of the seam remain open.
+            Assert::AreEqual(4.0f * 32.0f + 2.0f * 32.0f, OpenEdgeLength(mesh, indices), 1e-3f);
+
+            // Triangles never mix texture coordinates from both sides of the seam.
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                bool usesRightCopy = false;
+                bool reachesLeft = false;
+
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const s_mesh_vertex_t& v = mesh.vertices[indices[i + k]];
+
+                    usesRightCopy = usesRightCopy || (v.tu == 1.0f);
+                    reachesLeft = reachesLeft || (v.x < 12.0f);
+                }
+
+                Assert::IsFalse(usesRightCopy && reachesLeft);
+            }
+        }
+
+        TEST_METHOD(GenerateLodsProducesDecreasingDetailAndIncreasingError)
+        {
+            s_mesh_data_t mesh = MakeSphereMesh(48, 96);
+            const size_t triangleCount = mesh.indices.size() / 3;
+
+            std::vector<float> ratios;
+            ratios.push_back(0.5f);
+            ratios.push_back(0.25f);
+            ratios.push_back(0.1f);
+
+            MeshSimplifier::GenerateLods(&mesh, ratios);
+
+            Assert::AreEqual(ratios.size(), mesh.lods.size());
+
+            for (size_t i = 0; i < mesh.lods.size(); ++i)
+            {
+                const s_mesh_lod_t& lod = mesh.lods[i];
+
+                // Within a few percent of the requested triangle count.
+                Assert::IsTrue(lod.indices.size() / 3 <= static_cast<size_t>(triangleCount * ratios[i]));
+                Assert::IsTrue(lod.indices.size() / 3 >= static_cast<size_t>(triangleCount * ratios[i] * 0.9f));
+
+                Assert::IsTrue(lod.error >= 0.0f);
+                Assert::IsTrue(lod.error < 0.05f);
+                Assert::IsTrue(i == 0 || lod.error >= mesh.lods[i - 1].error);
+
+                for (int index : lod.indices)
+                {
+                    Assert::IsTrue(index >= 0 && static_cast<size_t>(index) < mesh.vertices.size());
+                }
+            }
+
+            Assert::IsTrue(mesh.lods.back().error > 0.0f);
+        }
+
+        TEST_METHOD(GenerateLodsInParallelMatchesSerial)
+        {
+            std::vector<s_mesh_data_t> serial, parallel;
+            std::vector<s_mesh_data_t *> batch;
+
+            for (int i = 0; i < 6; ++i)
+            {
+                serial.push_back(MakeSphereMesh(12 + i * 4, 24 + i * 4));
+            }
+
+            parallel = serial;
+
+            for (s_mesh_data_t& mesh : parallel)
+            {
+                batch.push_back(&mesh);
+            }
+
+            std::vector<float> ratios;
+            ratios.push_back(0.5f);
+            ratios.push_back(0.2f);
+
+            for (s_mesh_data_t& mesh : serial)
+            {
+                MeshSimplifier::GenerateLods(&mesh, ratios);
+            }
+
+            MeshSimplifier::GenerateLods(batch, ratios, 4);
+
+            for (size_t i = 0; i < serial.size(); ++i)
+            {
+                for (size_t level = 0; level < ratios.size(); ++level)
+                {
+                    Assert::IsTrue(serial[i].lods[level].indices == parallel[i].lods[level].indices);
+                    Assert::AreEqual(serial[i].lods[level].error, parallel[i].lods[level].error);
+                }
+            }
+        }
+    };
+}
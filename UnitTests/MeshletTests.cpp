@@ -0,0 +1,187 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "MeshletBuilder.h"
+#include "MeshData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(MeshletTests)
+    {
+    private:
+        // Build a flat size x size quad grid in the XY plane. Triangles are clockwise when seen from -Z, so the front
+        // faces look down -Z.
+        s_mesh_data_t MakeGridMesh(int size) const
+        {
+            s_mesh_data_t mesh;
+
+            for (int y = 0; y <= size; ++y)
+            {
+                for (int x = 0; x <= size; ++x)
+                {
+                    s_mesh_vertex_t v = { static_cast<float>(x), static_cast<float>(y), 0.0f, 0.0f, 0.0f, 0, 0, -1 };
+                    mesh.vertices.push_back(v);
+                }
+            }
+
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x = 0; x < size; ++x)
+                {
+                    int a = y * (size + 1) + x;
+                    int b = a + 1;
+                    int c = a + size + 1;
+                    int d = c + 1;
+
+                    int quad[6] = { a, c, b, b, c, d };
+                    mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+                }
+            }
+
+            return mesh;
+        }
+
+        const s_mesh_vertex_t& MeshletVertex(
+            const s_mesh_data_t& mesh,
+            const s_meshlet_data_t& meshlets,
+            const meshlet_t& meshlet,
+            unsigned int localIndex) const
+        {
+            return mesh.vertices[meshlets.vertices[meshlet.vertexOffset + localIndex]];
+        }
+
+    public:
+        TEST_METHOD(MeshletsRespectVertexAndTriangleLimits)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(40);
+            s_meshlet_data_t meshlets;
+
+            MeshletBuilder::Build(mesh, &meshlets);
+
+            Assert::IsTrue(meshlets.meshlets.size() > 1);
+            Assert::AreEqual(meshlets.meshlets.size(), meshlets.bounds.size());
+
+            for (const meshlet_t& meshlet : meshlets.meshlets)
+            {
+                Assert::IsTrue(meshlet.vertexCount <= MeshletBuilder::DefaultMaxVertices);
+                Assert::IsTrue(meshlet.triangleCount <= MeshletBuilder::DefaultMaxTriangles);
+                Assert::IsTrue(meshlet.triangleCount > 0);
+            }
+        }
+
+        TEST_METHOD(MeshletsContainEveryTriangleExactlyOnce)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(25);
+            s_meshlet_data_t meshlets;
+
+            MeshletBuilder::Build(mesh, &meshlets, 32, 40);
+
+            // Compare sorted corner triples. Meshlets keep the original winding, so rotations are not needed.
+            std::vector<std::vector<int>> expected, actual;
+
+            for (size_t i = 0; i < mesh.indices.size(); i += 3)
+            {
+                expected.push_back(std::vector<int>(&mesh.indices[i], &mesh.indices[i] + 3));
+            }
+
+            for (const meshlet_t& meshlet : meshlets.meshlets)
+            {
+                Assert::IsTrue(meshlet.vertexCount <= 32);
+                Assert::IsTrue(meshlet.triangleCount <= 40);
+
+                for (unsigned int t = 0; t < meshlet.triangleCount * 3; t += 3)
+                {
+                    std::vector<int> triangle;
+
+                    for (unsigned int k = 0; k < 3; ++k)
+                    {
+                        unsigned char local = meshlets.triangles[meshlet.triangleOffset + t + k];
+                        Assert::IsTrue(local < meshlet.vertexCount);
+                        triangle.push_back(static_cast<int>(meshlets.vertices[meshlet.vertexOffset + local]));
+                    }
+
+                    actual.push_back(triangle);
+                }
+            }
+
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+
+            Assert::IsTrue(expected == actual);
+        }
+
+        TEST_METHOD(MeshletBoundingSphereContainsVertices)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(30);
+            s_meshlet_data_t meshlets;
+
+            MeshletBuilder::Build(mesh, &meshlets);
+
+            for (size_t i = 0; i < meshlets.meshlets.size(); ++i)
+            {
+                const meshlet_t& meshlet = meshlets.meshlets[i];
+                const meshlet_bounds_t& bounds = meshlets.bounds[i];
+
+                for (unsigned int v = 0; v < meshlet.vertexCount; ++v)
+                {
+                    const s_mesh_vertex_t& vertex = MeshletVertex(mesh, meshlets, meshlet, v);
+
+                    float dx = vertex.x - bounds.center[0];
+                    float dy = vertex.y - bounds.center[1];
+                    float dz = vertex.z - bounds.center[2];
+
+                    Assert::IsTrue(std::sqrt(dx * dx + dy * dy + dz * dz) <= bounds.radius * 1.0001f);
+                }
+            }
+        }
+
+        TEST_METHOD(FlatMeshletIsBackfacingOnlyFromBehind)
+        {
+            s_mesh_data_t mesh = MakeGridMesh(4);
+            s_meshlet_data_t meshlets;
+
+            MeshletBuilder::Build(mesh, &meshlets);
+            Assert::AreEqual((size_t)1, meshlets.meshlets.size());
+
+            const meshlet_bounds_t& bounds = meshlets.bounds[0];
+
+            Assert::AreEqual(-1.0f, bounds.coneAxis[2], 1e-5f);
+            Assert::IsTrue(bounds.coneCutoff < 0.01f);
+
+            const float inFront[3] = { 2.0f, 2.0f, -10.0f };
+            const float behind[3] = { 2.0f, 2.0f, 10.0f };
+            const float edgeOn[3] = { 100.0f, 2.0f, 0.0f };
+
+            Assert::IsFalse(MeshletBuilder::IsBackfacing(bounds, inFront));
+            Assert::IsTrue(MeshletBuilder::IsBackfacing(bounds, behind));
+            Assert::IsFalse(MeshletBuilder::IsBackfacing(bounds, edgeOn));
+        }
+
+        TEST_METHOD(MeshletFacingManyDirectionsIsNeverBackfacing)
+        {
+            // Two triangles facing opposite directions.
+            s_mesh_data_t mesh;
+            s_mesh_vertex_t vertices[3] =
+            {
+                { 0, 0, 0, 0, 0, 0, 0, 0 }, { 0, 1, 0, 0, 0, 0, 0, 0 }, { 1, 0, 0, 0, 0, 0, 0, 0 }
+            };
+
+            mesh.vertices.assign(vertices, vertices + 3);
+            int indices[6] = { 0, 1, 2, 0, 2, 1 };
+            mesh.indices.assign(indices, indices + 6);
+
+            s_meshlet_data_t meshlets;
+            MeshletBuilder::Build(mesh, &meshlets);
+
+            const float viewer[3] = { 0.0f, 0.0f, 10.0f };
+
+            Assert::AreEqual(1.0f, meshlets.bounds[0].coneCutoff);
+            Assert::IsFalse(MeshletBuilder::IsBackfacing(meshlets.bounds[0], viewer));
+        }
+    };
+}
@@ -0,0 +1,131 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "ObjectPool.h"
+#include "AllocationCounter.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(ObjectPoolTests)
+    {
+    private:
+        struct tracked_t
+        {
+            tracked_t(int value, int * pDestroyed) : value(value), pDestroyed(pDestroyed) { }
+            ~tracked_t() { (*pDestroyed)++; }
+
+            int value;
+            int * pDestroyed;
+        };
+
+    public:
+        TEST_METHOD(FixedPoolReusesFreedBlocks)
+        {
+            FixedPool pool(24, 4);
+
+            Assert::IsTrue(pool.BlockSize() >= 24);
+            Assert::AreEqual(0u, static_cast<unsigned int>(pool.BlockSize() % 16));
+
+            void * pA = pool.Allocate();
+            void * pB = pool.Allocate();
+
+            Assert::IsTrue(pA != pB);
+            Assert::AreEqual(0u, static_cast<unsigned int>(reinterpret_cast<uintptr_t>(pB) % 16));
+            Assert::AreEqual(2u, static_cast<unsigned int>(pool.LiveCount()));
+
+            pool.Free(pA);
+            Assert::IsTrue(pA == pool.Allocate());
+
+            pool.Free(pA);
+            pool.Free(pB);
+            Assert::AreEqual(0u, static_cast<unsigned int>(pool.LiveCount()));
+            Assert::AreEqual(2u, static_cast<unsigned int>(pool.HighWaterMark()));
+        }
+
+        TEST_METHOD(FixedPoolGrowsByPages)
+        {
+            FixedPool pool(8, 4);
+            std::vector<void *> blocks;
+
+            for (int i = 0; i < 9; ++i)
+            {
+                blocks.push_back(pool.Allocate());
+            }
+
+            Assert::AreEqual(3ull, pool.HeapAllocationCount());
+            Assert::AreEqual(12u, static_cast<unsigned int>(pool.Capacity()));
+
+            for (void * pBlock : blocks)
+            {
+                pool.Free(pBlock);
+            }
+
+            // A pool at its working size does not allocate.
+            const unsigned long long allocations = AllocationCounter::Count();
+
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                blocks[i] = pool.Allocate();
+            }
+
+            Assert::AreEqual(allocations, AllocationCounter::Count());
+            Assert::AreEqual(3ull, pool.HeapAllocationCount());
+        }
+
+        TEST_METHOD(ObjectPoolConstructsAndDestroys)
+        {
+            int destroyed = 0;
+            ObjectPool<tracked_t> pool;
+
+            tracked_t * pObject = pool.Create(7, &destroyed);
+            Assert::AreEqual(7, pObject->value);
+            Assert::AreEqual(1u, static_cast<unsigned int>(pool.Pool().LiveCount()));
+
+            pool.Destroy(pObject);
+            pool.Destroy(nullptr);
+
+            Assert::AreEqual(1, destroyed);
+            Assert::AreEqual(0u, static_cast<unsigned int>(pool.Pool().LiveCount()));
+        }
+
+        TEST_METHOD(PoolAllocatorBacksNodeContainers)
+        {
+            FixedPool nodes(128);
+
+            {
+                typedef std::pair<const int, std::string> name_t;
+
+                std::list<int, PoolAllocator<int>> values((PoolAllocator<int>(nodes)));
+                std::map<int, std::string, std::less<int>, PoolAllocator<name_t>> names((PoolAllocator<name_t>(nodes)));
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    values.push_back(i);
+                    names[i] = "name";
+                }
+
+                Assert::AreEqual(4950, std::accumulate(values.begin(), values.end(), 0));
+                Assert::AreEqual(std::string("name"), names[50]);
+                Assert::IsTrue(nodes.LiveCount() >= 200);
+            }
+
+            Assert::AreEqual(0u, static_cast<unsigned int>(nodes.LiveCount()));
+            Assert::IsTrue(nodes.HighWaterMark() >= 200);
+
+            // Arrays come from the heap, so containers that are not node based still work.
+            std::vector<int, PoolAllocator<int>> array((PoolAllocator<int>(nodes)));
+            array.assign(1000, 1);
+
+            Assert::AreEqual(1000, std::accumulate(array.begin(), array.end(), 0));
+            Assert::IsTrue(nodes.LiveCount() <= 1);
+        }
+    };
+}
@@ -0,0 +1,268 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "PackFile.h"
+#include "BinaryBlob.h"
+#include "DXTestException.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(PackFileTests)
+    {
+    private:
+        std::vector<std::string> mFiles;
+
+        std::wstring TempFile(const char * pExtension)
+        {
+            std::string filename = "PackFileTests_" + std::to_string(mFiles.size()) + pExtension;
+            mFiles.push_back(filename);
+
+            return std::wstring(filename.begin(), filename.end());
+        }
+
+        std::wstring WriteFile(const std::string& contents)
+        {
+            std::wstring filepath = TempFile(".bin");
+
+            std::ofstream stream(mFiles.back().c_str(), std::ios::binary);
+            stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+            return filepath;
+        }
+
+        static std::string EntryString(const pack_entry_t& entry)
+        {
+            return std::string(entry.pData, entry.size);
+        }
+
+    public:
+        TEST_METHOD_CLEANUP(DeleteFiles)
+        {
+            PackFile::UnmountAll();
+
+            for (const std::string& filename : mFiles)
+            {
+                std::remove(filename.c_str());
+            }
+
+            mFiles.clear();
+        }
+
+        TEST_METHOD(PackRoundTripsEntries)
+        {
+            std::string large(10000, 'x');
+            large[5000] = 'y';
+
+            PackWriter writer;
+            writer.Add(L"Models\\cube.model", "cube", 4);
+            writer.Add(L"Textures/seafloor.dds", large.data(), large.size());
+            writer.Add(L"empty.txt", nullptr, 0);
+            writer.Add(L"Fonts\\font.txt", "font", 4);
+
+            std::wstring packPath = TempFile(".pack");
+            writer.Save(packPath);
+
+            PackFile pack(packPath);
+            pack_entry_t entry;
+
+            Assert::AreEqual(4u, pack.EntryCount());
+
+            Assert::IsTrue(pack.Find(L"Models\\cube.model", &entry));
+            Assert::AreEqual(std::string("cube"), EntryString(entry));
+
+            Assert::IsTrue(pack.Find(L"Textures\\seafloor.dds", &entry));
+            Assert::IsTrue(large == EntryString(entry));
+
+            Assert::IsTrue(pack.Find(L"empty.txt", &entry));
+            Assert::AreEqual((size_t)0, entry.size);
+
+            Assert::IsTrue(pack.Find(L"fonts/font.txt", &entry));
+            Assert::AreEqual(std::string("font"), EntryString(entry));
+
+            Assert::IsFalse(pack.Contains(L"Models\\sphere.model"));
+            Assert::IsFalse(pack.Contains(L"Models"));
+        }
+
+        TEST_METHOD(PackPathsAreNormalized)
+        {
+            Assert::AreEqual(std::string("models/cube.model"), PackFile::NormalizePath(L".\\Models\\Cube.MODEL"));
+            Assert::AreEqual(std::string("models/cube.model"), PackFile::NormalizePath(L"./models/cube.model"));
+            Assert::AreEqual(PackFile::HashPath("a/b"), PackFile::HashPath(PackFile::NormalizePath(L"A\\B")));
+            Assert::AreNotEqual(PackFile::HashPath("a/b"), PackFile::HashPath("a/c"));
+        }
+
+        TEST_METHOD(PackAlignsLargeEntries)
+        {
+            std::string large(PackFile::DefaultAlignment + 1, 'z');
+
+            PackWriter writer;
+            writer.Add(L"small0", "a", 1);
+            writer.Add(L"large0", large.data(), large.size());
+            writer.Add(L"small1", "bb", 2);
+            writer.Add(L"large1", large.data(), large.size());
+
+            std::wstring packPath = TempFile(".pack");
+            writer.Save(packPath);
+
+            PackFile pack(packPath);
+
+            // The mapping itself starts on a page boundary, so entry addresses show the alignment within the file.
+            for (unsigned int i = 0; i < pack.EntryCount(); ++i)
+            {
+                pack_entry_t entry = pack.Entry(i);
+                size_t alignment = static_cast<size_t>(PackFile::SmallEntryAlignment);
+
+                if (entry.size >= PackFile::DefaultAlignment)
+                {
+                    alignment = static_cast<size_t>(PackFile::DefaultAlignment);
+                }
+
+                Assert::AreEqual((size_t)0, reinterpret_cast<size_t>(entry.pData) % alignment);
+            }
+        }
+
+        TEST_METHOD(PackWriterRejectsDuplicatePaths)
+        {
+            PackWriter writer;
+            writer.Add(L"Models\\cube.model", "a", 1);
+
+            Assert::ExpectException<SandboxException>([&]() {
+                writer.Add(L".\\models/CUBE.model", "b", 1);
+            });
+        }
+
+        TEST_METHOD(PackRejectsBadFiles)
+        {
+            PackWriter writer;
+            writer.Add(L"file", "contents", 8);
+
+            std::wstring packPath = TempFile(".pack");
+            writer.Save(packPath);
+
+            BinaryBlob good = BinaryBlob::LoadFromFile(packPath);
+            std::string bytes(good.BufferPointer(), static_cast<size_t>(good.BufferSize()));
+
+            std::string badMagic = bytes;
+            badMagic[0] = 'X';
+
+            std::string truncated = bytes.substr(0, bytes.size() - 4);
+
+            std::string badOffset = bytes;
+            badOffset[40 + 8 + 7] = '\x7f';         // High byte of the first entry's offset field.
+
+            std::wstring badMagicPath = WriteFile(badMagic);
+            std::wstring truncatedPath = WriteFile(truncated);
+            std::wstring badOffsetPath = WriteFile(badOffset);
+
+            Assert::ExpectException<FileFormatException>([&]() { PackFile pack(badMagicPath); });
+            Assert::ExpectException<FileFormatException>([&]() { PackFile pack(truncatedPath); });
+            Assert::ExpectException<FileFormatException>([&]() { PackFile pack(badOffsetPath); });
+            Assert::ExpectException<FileLoadException>([&]() { PackFile pack(L"PackFileTests_missing.pack"); });
+        }
+
+        TEST_METHOD(PackCompressesEntriesThatShrink)
+        {
+            std::string text;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                text += "v " + std::to_string(i % 100) + " 0.5 1.0\n";
+            }
+
+            std::string noise(5000, '\0');
+            unsigned int state = 1;
+
+            for (char& c : noise)
+            {
+                state = state * 1664525u + 1013904223u;
+                c = static_cast<char>(state >> 24);
+            }
+
+            PackWriter writer;
+            writer.Add(L"Models\\big.txt", text.data(), text.size(), true);
+            writer.Add(L"noise.bin", noise.data(), noise.size(), true);
+            writer.Add(L"plain.txt", text.data(), 100);
+
+            Assert::IsTrue(writer.StoredSize() < writer.DataSize());
+
+            std::wstring packPath = TempFile(".pack");
+            writer.Save(packPath);
+
+            PackFile pack(packPath);
+            pack_entry_t entry;
+
+            // Text shrinks and is stored compressed, noise does not and is left alone.
+            Assert::IsTrue(pack.Find(L"models\\big.txt", &entry));
+            Assert::IsTrue(entry.flags == PackFile::FlagCompressed);
+            Assert::AreEqual(text.size(), entry.uncompressedSize);
+            Assert::IsTrue(entry.size < text.size() / 2);
+
+            std::string contents(entry.uncompressedSize, '\0');
+            pack.ReadEntry(entry, &contents[0], contents.size());
+            Assert::IsTrue(text == contents);
+
+            Assert::IsTrue(pack.Find(L"noise.bin", &entry));
+            Assert::IsTrue(entry.flags == PackFile::FlagNone);
+            Assert::IsTrue(noise == EntryString(entry));
+
+            Assert::IsTrue(pack.Find(L"plain.txt", &entry));
+            Assert::IsTrue(entry.flags == PackFile::FlagNone);
+
+            // BinaryBlob decompresses mounted entries transparently.
+            PackFile::Mount(std::make_shared<PackFile>(packPath));
+
+            BinaryBlob blob = BinaryBlob::LoadFromFile(std::wstring(L".\\Models\\big.txt"));
+            Assert::IsTrue(text == std::string(blob.BufferPointer(), static_cast<size_t>(blob.BufferSize())));
+        }
+
+        TEST_METHOD(MountedPacksAreUsedByBinaryBlob)
+        {
+            std::wstring loosePath = WriteFile("loose");
+
+            PackWriter writer;
+            writer.Add(L"Assets\\packed.txt", "packed", 6);
+            writer.Add(loosePath, "from the pack", 13);
+
+            std::wstring packPath = TempFile(".pack");
+            writer.Save(packPath);
+
+            // Packed files are found and take priority over loose files with the same path.
+            std::shared_ptr<PackFile> pack = std::make_shared<PackFile>(packPath);
+            PackFile::Mount(pack);
+
+            const unsigned long long allocations = BinaryBlob::BufferAllocationCount();
+            BinaryBlob packed = BinaryBlob::LoadFromFile(std::wstring(L".\\assets\\packed.txt"));
+            Assert::AreEqual(std::string("packed"), std::string(packed.BufferPointer(), 6));
+
+            // Uncompressed entries are used in place.
+            pack_entry_t entry;
+            Assert::IsTrue(pack->Find(L"assets\\packed.txt", &entry));
+            Assert::IsTrue(entry.pData == packed.BufferPointer());
+            Assert::AreEqual(allocations, BinaryBlob::BufferAllocationCount());
+
+            BinaryBlob overridden = BinaryBlob::LoadFromFile(loosePath);
+            Assert::AreEqual((std::streamsize)13, overridden.BufferSize());
+
+            // Once unmounted everything comes from disk again. Blobs loaded earlier keep the pack mapped.
+            PackFile::UnmountAll();
+            pack.reset();
+
+            Assert::AreEqual(std::string("packed"), std::string(packed.BufferPointer(), 6));
+
+            BinaryBlob loose = BinaryBlob::LoadFromFile(loosePath);
+            Assert::AreEqual(std::string("loose"), std::string(loose.BufferPointer(), 5));
+
+            Assert::ExpectException<FileLoadException>([&]() {
+                BinaryBlob::LoadFromFile(std::wstring(L"assets\\packed.txt"));
+            });
+        }
+    };
+}
@@ -0,0 +1,198 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Profiler.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(ProfilerTests)
+    {
+    private:
+        static const profile_node_t * FindNode(const std::vector<profile_node_t>& frame, const char * pName)
+        {
+            for (const profile_node_t& node : frame)
+            {
+                if (std::string(node.pName) == pName)
+                {
+                    return &node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        static void Spin(unsigned long long ticks)
+        {
+            const unsigned long long start = Profiler::Ticks();
+
+            while (Profiler::Ticks() - start < ticks)
+            {
+            }
+        }
+
+    public:
+        TEST_METHOD_INITIALIZE(StartFrame)
+        {
+            Profiler::SetEnabled(true);
+            Profiler::EndFrame();
+        }
+
+        TEST_METHOD_CLEANUP(StopProfiling)
+        {
+            Profiler::SetEnabled(false);
+        }
+
+        TEST_METHOD(LastFrameMergesScopesIntoHierarchy)
+        {
+            {
+                PROFILE_SCOPE("Frame");
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    PROFILE_SCOPE("Update");
+                    Spin(1000);
+                }
+
+                {
+                    PROFILE_SCOPE("Render");
+                    PROFILE_SCOPE("Draw");
+                    Spin(1000);
+                }
+            }
+
+            Profiler::EndFrame();
+            const std::vector<profile_node_t> frame = Profiler::LastFrame();
+
+            const profile_node_t * pFrame = FindNode(frame, "Frame");
+            const profile_node_t * pUpdate = FindNode(frame, "Update");
+            const profile_node_t * pDraw = FindNode(frame, "Draw");
+
+            Assert::IsNotNull(pFrame);
+            Assert::IsNotNull(pUpdate);
+            Assert::IsNotNull(pDraw);
+
+            Assert::AreEqual(0u, pFrame->depth);
+            Assert::AreEqual(1u, pUpdate->depth);
+            Assert::AreEqual(2u, pDraw->depth);
+            Assert::AreEqual(3u, pUpdate->calls);
+            Assert::AreEqual(1u, pFrame->calls);
+
+            // Depth first: children follow their parent.
+            Assert::IsTrue(pFrame < pUpdate && pUpdate < pDraw);
+
+            Assert::IsTrue(pUpdate->totalMilliseconds > 0.0);
+            Assert::IsTrue(pFrame->totalMilliseconds >= pUpdate->totalMilliseconds + pDraw->totalMilliseconds);
+            Assert::IsTrue(pFrame->selfMilliseconds < pFrame->totalMilliseconds);
+            Assert::AreEqual(pDraw->totalMilliseconds, pDraw->selfMilliseconds);
+        }
+
+        TEST_METHOD(LastFrameOnlyHasScopesFromThatFrame)
+        {
+            {
+                PROFILE_SCOPE("PreviousFrame");
+            }
+
+            Profiler::EndFrame();
+
+            {
+                PROFILE_SCOPE("CurrentFrame");
+            }
+
+            Profiler::EndFrame();
+            const std::vector<profile_node_t> frame = Profiler::LastFrame();
+
+            Assert::IsNull(FindNode(frame, "PreviousFrame"));
+            Assert::IsNotNull(FindNode(frame, "CurrentFrame"));
+        }
+
+        TEST_METHOD(DisabledScopesRecordNothing)
+        {
+            Profiler::SetEnabled(false);
+
+            {
+                PROFILE_SCOPE("Disabled");
+
+                // Turning recording on inside a scope must not leave an unmatched end event.
+                Profiler::SetEnabled(true);
+                PROFILE_SCOPE("Enabled");
+            }
+
+            Profiler::EndFrame();
+            const std::vector<profile_node_t> frame = Profiler::LastFrame();
+
+            Assert::IsNull(FindNode(frame, "Disabled"));
+            Assert::IsNotNull(FindNode(frame, "Enabled"));
+            Assert::AreEqual(0u, FindNode(frame, "Enabled")->depth);
+        }
+
+        TEST_METHOD(ThreadsRecordToTheirOwnBuffers)
+        {
+            std::thread worker([]() {
+                Profiler::SetThreadName("Worker");
+                PROFILE_SCOPE("WorkerScope");
+            });
+
+            worker.join();
+
+            {
+                PROFILE_SCOPE("MainScope");
+            }
+
+            Profiler::EndFrame();
+            const std::vector<profile_node_t> frame = Profiler::LastFrame();
+
+            const profile_node_t * pWorker = FindNode(frame, "WorkerScope");
+            const profile_node_t * pMain = FindNode(frame, "MainScope");
+
+            Assert::IsNotNull(pWorker);
+            Assert::IsNotNull(pMain);
+            Assert::AreNotEqual(pWorker->threadIndex, pMain->threadIndex);
+        }
+
+        TEST_METHOD(RingBufferKeepsNewestEvents)
+        {
+            for (size_t i = 0; i < Profiler::EventsPerThread; ++i)
+            {
+                PROFILE_SCOPE("Old");
+            }
+
+            {
+                PROFILE_SCOPE("New");
+            }
+
+            Profiler::EndFrame();
+            const std::vector<profile_node_t> frame = Profiler::LastFrame();
+
+            const profile_node_t * pOld = FindNode(frame, "Old");
+            Assert::IsNotNull(pOld);
+            Assert::IsTrue(pOld->calls < Profiler::EventsPerThread);
+            Assert::IsNotNull(FindNode(frame, "New"));
+        }
+
+        TEST_METHOD(ChromeTraceHasCompleteEventsAndThreadNames)
+        {
+            Profiler::SetThreadName("Main \"test\" thread");
+
+            {
+                PROFILE_SCOPE("TracedScope");
+            }
+
+            const std::string trace = Profiler::ToChromeTrace();
+
+            const std::string header = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+            const std::string scope = "{\"name\": \"TracedScope\", \"cat\": \"cpu\", \"ph\": \"X\"";
+
+            Assert::AreEqual(header, trace.substr(0, header.size()));
+            Assert::IsTrue(trace.find(scope) != std::string::npos);
+            Assert::IsTrue(trace.find("\"name\": \"thread_name\", \"ph\": \"M\"") != std::string::npos);
+            Assert::IsTrue(trace.find("\"Main \\\"test\\\" thread\"") != std::string::npos);
+            Assert::IsTrue(trace.find("\"dur\": ") != std::string::npos);
+            Assert::AreEqual(std::string("\n]}\n"), trace.substr(trace.size() - 4));
+        }
+    };
+}
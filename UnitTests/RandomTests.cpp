@@ -0,0 +1,192 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "Random.h"
+
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(RandomTests)
+    {
+    public:
+        TEST_METHOD(SequenceMatchesReferenceImplementation)
+        {
+            // Expected values from the xoshiro256** and SplitMix64 reference code.
+            Random random(42);
+
+            Assert::IsTrue(random.NextUInt64() == 0x15780B2E0C2EC716ull);
+            Assert::IsTrue(random.NextUInt64() == 0x6104D9866D113A7Eull);
+            Assert::IsTrue(random.NextUInt64() == 0xAE17533239E499A1ull);
+
+            Random stream = Random::ForStream(42, 1);
+            Assert::IsTrue(stream.NextUInt64() == 0x50086EF83CBF4F4Aull);
+
+            random.Seed(42);
+            Assert::IsTrue(random.NextUInt64() == 0x15780B2E0C2EC716ull);
+        }
+
+        TEST_METHOD(StreamsAreIndependent)
+        {
+            Random a = Random::ForStream(7, 0);
+            Random b = Random::ForStream(7, 1);
+            Random c(7);
+            c.Jump();
+
+            unsigned int same = 0;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const unsigned long long valueB = b.NextUInt64();
+
+                same += (a.NextUInt64() == valueB) ? 1 : 0;
+                Assert::IsTrue(c.NextUInt64() == valueB);
+            }
+
+            Assert::AreEqual(0u, same);
+
+            // Long jumps land somewhere else again.
+            Random d(7);
+            d.LongJump();
+            Assert::IsFalse(d.NextUInt64() == Random::ForStream(7, 1).NextUInt64());
+        }
+
+        TEST_METHOD(BoundedValuesStayInRange)
+        {
+            Random random(1);
+            unsigned int counts[10] = { 0 };
+
+            for (int i = 0; i < 100000; ++i)
+            {
+                const unsigned int value = random.NextUInt(10);
+                Assert::IsTrue(value < 10);
+                counts[value]++;
+            }
+
+            for (unsigned int count : counts)
+            {
+                Assert::IsTrue(count > 9500 && count < 10500);
+            }
+
+            bool sawMin = false, sawMax = false;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const int value = random.NextInt(-3, 3);
+                Assert::IsTrue(value >= -3 && value <= 3);
+
+                sawMin |= (value == -3);
+                sawMax |= (value == 3);
+            }
+
+            Assert::IsTrue(sawMin && sawMax);
+            Assert::AreEqual(5, random.NextInt(5, 5));
+
+            // The full int range must not overflow.
+            random.NextInt(-2147483647 - 1, 2147483647);
+        }
+
+        TEST_METHOD(FloatsStayInRange)
+        {
+            Random random(2);
+            double sum = 0.0;
+
+            for (int i = 0; i < 100000; ++i)
+            {
+                const float unit = random.NextFloat();
+                const double precise = random.NextDouble();
+                const float ranged = random.NextFloat(2.0f, 8.0f);
+
+                Assert::IsTrue(unit >= 0.0f && unit < 1.0f);
+                Assert::IsTrue(precise >= 0.0 && precise < 1.0);
+                Assert::IsTrue(ranged >= 2.0f && ranged < 8.0f);
+
+                sum += unit;
+            }
+
+            Assert::AreEqual(0.5, sum / 100000.0, 0.01);
+        }
+
+        TEST_METHOD(FillMatchesReferenceImplementation)
+        {
+            // Four interleaved generators seeded from Random(42), whichever of AVX2, SSE2 or scalar code runs.
+            const unsigned int expected[] =
+            {
+                0x4631C453, 0x8EE445D1, 0x18CC63B6, 0x9F622887, 0xDAD555C5, 0x677934EB, 0x3CF1C6E8, 0x2A5A2808,
+                0x3296FE62, 0x106FA1A1, 0xDB1B6DEB, 0xE77E94B6, 0xAC8C02E2, 0xBF6ACF78, 0xF909B663, 0x8634C266
+            };
+
+            unsigned int values[16];
+            Random random(42);
+            random.FillUInts(values, 16);
+
+            for (size_t i = 0; i < 16; ++i)
+            {
+                Assert::AreEqual(expected[i], values[i]);
+            }
+
+            // Shorter batches are a prefix of longer ones.
+            Random again(42);
+            again.FillUInts(values, 11);
+
+            for (size_t i = 0; i < 11; ++i)
+            {
+                Assert::AreEqual(expected[i], values[i]);
+            }
+        }
+
+        TEST_METHOD(FillRangesAndOddCounts)
+        {
+            const size_t counts[] = { 1, 7, 1023, 1024, 1025, 5003 };
+
+            for (size_t count : counts)
+            {
+                std::vector<float> floats(count + 1, -1.0f);
+                std::vector<int> ints(count + 1, 1000);
+
+                Random random(static_cast<unsigned long long>(count));
+                random.FillFloats(&floats[0], count, -1.0f, 1.0f);
+                random.FillInts(&ints[0], count, -5, 5);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Assert::IsTrue(floats[i] >= -1.0f && floats[i] < 1.0f);
+                    Assert::IsTrue(ints[i] >= -5 && ints[i] <= 5);
+                }
+
+                // Nothing written past the end.
+                Assert::AreEqual(-1.0f, floats[count]);
+                Assert::AreEqual(1000, ints[count]);
+            }
+
+            std::vector<int> ints(100000);
+            Random random(3);
+            random.FillInts(&ints[0], ints.size(), 10, 13);
+
+            unsigned int counts4[4] = { 0 };
+
+            for (int value : ints)
+            {
+                counts4[value - 10]++;
+            }
+
+            for (unsigned int count : counts4)
+            {
+                Assert::IsTrue(count > 24000 && count < 26000);
+            }
+
+            std::vector<float> floats(100000);
+            random.FillFloats(&floats[0], floats.size(), 0.0f, 1.0f);
+
+            double sum = 0.0;
+
+            for (float value : floats)
+            {
+                sum += value;
+            }
+
+            Assert::AreEqual(0.5, sum / floats.size(), 0.01);
+        }
+    };
+}
@@ -2,6 +2,7 @@
 #include "CppUnitTest.h"
 #include "Range.h"
 
+#include <algorithm>
 #include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -37,5 +38,141 @@ namespace UnitTests
             Assert::AreEqual(6, sum);
         }
 
+        TEST_METHOD(RangeIteratorsAreRandomAccess)
+        {
+            const auto range = MakeRange(10, 20);
+            auto i = range.begin();
+
+            Assert::AreEqual(static_cast<size_t>(10), range.size());
+            Assert::AreEqual(10, static_cast<int>(range.end() - range.begin()));
+            Assert::AreEqual(13u, *(i + 3));
+            Assert::AreEqual(15u, i[5]);
+            Assert::AreEqual(19u, *(range.end() - 1));
+            Assert::AreEqual(12u, range[2]);
+
+            i += 4;
+            Assert::AreEqual(14u, *i);
+            Assert::AreEqual(13u, *--i);
+            Assert::IsTrue(range.begin() < i && i <= range.end());
+
+            // Standard algorithms can binary search a range.
+            Assert::AreEqual(17u, *std::lower_bound(range.begin(), range.end(), 17u));
+            Assert::IsTrue(std::binary_search(range.begin(), range.end(), 19u));
+
+            const auto constant = MakeRange<4, 8>();
+            Assert::AreEqual(static_cast<size_t>(4), constant.size());
+            Assert::AreEqual(6u, constant.begin()[2]);
+        }
+
+        TEST_METHOD(ForEachVisitsInOrder)
+        {
+            std::vector<unsigned int> visited;
+            MakeRange<3, 7>().ForEach([&](unsigned int i) { visited.push_back(i); });
+
+            Assert::AreEqual(static_cast<size_t>(4), visited.size());
+
+            for (size_t i = 0; i < visited.size(); ++i)
+            {
+                Assert::AreEqual(static_cast<unsigned int>(i + 3), visited[i]);
+            }
+
+            unsigned int calls = 0;
+            MakeRange<5, 5>().ForEach([&](unsigned int) { ++calls; });
+            MakeRange(9, 2).ForEach([&](unsigned int) { ++calls; });
+            Assert::AreEqual(0u, calls);
+
+            unsigned int sum = 0;
+            MakeRange(1, 5).ForEach([&](unsigned int i) { sum += i; });
+            Assert::AreEqual(10u, sum);
+        }
+
+        TEST_METHOD(StridedRangeSkipsValues)
+        {
+            std::vector<unsigned int> values(MakeStridedRange(2, 11, 3).begin(), MakeStridedRange(2, 11, 3).end());
+
+            Assert::AreEqual(static_cast<size_t>(3), values.size());
+            Assert::AreEqual(2u, values[0]);
+            Assert::AreEqual(5u, values[1]);
+            Assert::AreEqual(8u, values[2]);
+
+            Assert::AreEqual(static_cast<size_t>(3), MakeStridedRange(0, 12, 4).size());
+            Assert::AreEqual(static_cast<size_t>(0), MakeStridedRange(5, 5, 1).size());
+            Assert::AreEqual(static_cast<size_t>(1), MakeStridedRange(5, 6, 10).size());
+        }
+
+        TEST_METHOD(ChunksCoverTheRange)
+        {
+            const auto chunks = MakeChunks(MakeRange(3, 26), 5u);
+            std::vector<unsigned int> visited;
+
+            Assert::AreEqual(static_cast<size_t>(5), chunks.size());
+
+            for (auto chunk : chunks)
+            {
+                Assert::IsTrue(chunk.size() == 5 || (chunk.size() == 3 && *chunk.begin() == 23));
+
+                for (auto i : chunk)
+                {
+                    visited.push_back(i);
+                }
+            }
+
+            Assert::AreEqual(static_cast<size_t>(23), visited.size());
+
+            for (size_t i = 0; i < visited.size(); ++i)
+            {
+                Assert::AreEqual(static_cast<unsigned int>(i + 3), visited[i]);
+            }
+
+            Assert::AreEqual(static_cast<size_t>(0), MakeChunks(MakeRange(4, 4), 8u).size());
+        }
+
+        TEST_METHOD(TilesCoverTheGridOnce)
+        {
+            std::vector<int> cells(37 * 21, 0);
+            const TiledRange2D tiles = MakeTiles2D(37, 21, 8, 4);
+
+            Assert::AreEqual(static_cast<size_t>(5 * 6), tiles.size());
+
+            for (auto tile : tiles)
+            {
+                Assert::IsTrue(tile.x.size() <= 8 && tile.y.size() <= 4);
+
+                for (auto y : tile.y)
+                {
+                    for (auto x : tile.x)
+                    {
+                        cells[y * 37 + x]++;
+                    }
+                }
+            }
+
+            Assert::IsTrue(std::count(cells.begin(), cells.end(), 1) == static_cast<std::ptrdiff_t>(cells.size()));
+
+            // Row major order.
+            Assert::AreEqual(8u, *tiles[1].x.begin());
+            Assert::AreEqual(4u, *tiles[5].y.begin());
+
+            std::vector<int> voxels(9 * 5 * 7, 0);
+            const TiledRange3D boxes = MakeTiles3D(9, 5, 7, 4);
+
+            Assert::AreEqual(static_cast<size_t>(3 * 2 * 2), boxes.size());
+
+            for (auto box : boxes)
+            {
+                for (auto z : box.z)
+                {
+                    for (auto y : box.y)
+                    {
+                        for (auto x : box.x)
+                        {
+                            voxels[(z * 5 + y) * 9 + x]++;
+                        }
+                    }
+                }
+            }
+
+            Assert::IsTrue(std::count(voxels.begin(), voxels.end(), 1) == static_cast<std::ptrdiff_t>(voxels.size()));
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "RenderStats.h"
+
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(RenderStatsTests)
+    {
+    public:
+        TEST_METHOD(AddCountsTheCurrentFrameUntilItEnds)
+        {
+            RenderStats stats(4);
+
+            stats.Add(RenderCounter::DrawCalls);
+            stats.Add(RenderCounter::DrawCalls);
+            stats.Add(RenderCounter::Indices, 36);
+
+            Assert::AreEqual(2ull, stats.Current(RenderCounter::DrawCalls));
+            Assert::AreEqual(36ull, stats.Current(RenderCounter::Indices));
+            Assert::AreEqual(0ull, stats.Summary(RenderCounter::DrawCalls).last);
+            Assert::AreEqual(static_cast<size_t>(0), stats.FrameCount());
+
+            stats.EndFrame();
+
+            Assert::AreEqual(0ull, stats.Current(RenderCounter::DrawCalls));
+            Assert::AreEqual(2ull, stats.Summary(RenderCounter::DrawCalls).last);
+            Assert::AreEqual(36ull, stats.Summary(RenderCounter::Indices).last);
+            Assert::AreEqual(static_cast<size_t>(1), stats.FrameCount());
+        }
+
+        TEST_METHOD(SummaryHasMinAverageAndMaxOverTheWindow)
+        {
+            RenderStats stats(4);
+            const unsigned long long draws[] = { 10, 30, 20 };
+
+            for (unsigned long long count : draws)
+            {
+                stats.Add(RenderCounter::DrawCalls, count);
+                stats.EndFrame();
+            }
+
+            const render_counter_summary_t summary = stats.Summary(RenderCounter::DrawCalls);
+
+            Assert::AreEqual(20ull, summary.last);
+            Assert::AreEqual(10ull, summary.min);
+            Assert::AreEqual(30ull, summary.max);
+            Assert::AreEqual(20.0, summary.average);
+
+            // Frames not written yet are not zero frames.
+            Assert::AreEqual(static_cast<size_t>(3), stats.FrameCount());
+        }
+
+        TEST_METHOD(OldFramesLeaveTheWindow)
+        {
+            RenderStats stats(3);
+            const unsigned long long culled[] = { 100, 1, 2, 3, 4 };
+
+            for (unsigned long long count : culled)
+            {
+                stats.Add(RenderCounter::ObjectsCulled, count);
+                stats.EndFrame();
+            }
+
+            const render_counter_summary_t summary = stats.Summary(RenderCounter::ObjectsCulled);
+
+            Assert::AreEqual(static_cast<size_t>(3), stats.FrameCount());
+            Assert::AreEqual(4ull, summary.last);
+            Assert::AreEqual(2ull, summary.min);
+            Assert::AreEqual(4ull, summary.max);
+            Assert::AreEqual(3.0, summary.average);
+        }
+
+        TEST_METHOD(ResetForgetsEveryFrame)
+        {
+            RenderStats stats(3);
+
+            stats.Add(RenderCounter::MapCalls, 5);
+            stats.EndFrame();
+            stats.Add(RenderCounter::MapCalls, 7);
+            stats.Reset();
+
+            Assert::AreEqual(static_cast<size_t>(0), stats.FrameCount());
+            Assert::AreEqual(0ull, stats.Current(RenderCounter::MapCalls));
+            Assert::AreEqual(0ull, stats.Summary(RenderCounter::MapCalls).max);
+
+            stats.Add(RenderCounter::MapCalls, 2);
+            stats.EndFrame();
+
+            Assert::AreEqual(2.0, stats.Summary(RenderCounter::MapCalls).average);
+        }
+
+        TEST_METHOD(DumpAndOverlayListEveryCounter)
+        {
+            RenderStats stats;
+
+            stats.Add(RenderCounter::BytesUploaded, 4096);
+            stats.EndFrame();
+
+            const std::string dump = stats.Dump();
+            const std::vector<std::string> lines = stats.OverlayLines();
+
+            Assert::AreEqual(RenderCounterCount, lines.size());
+            Assert::AreEqual(std::string("Bytes uploaded: 4096.0 (4096 - 4096)"),
+                             lines[static_cast<size_t>(RenderCounter::BytesUploaded)]);
+
+            for (size_t i = 0; i < RenderCounterCount; ++i)
+            {
+                const char * pName = RenderStats::CounterName(static_cast<RenderCounter>(i));
+                Assert::IsTrue(dump.find(pName) != std::string::npos);
+            }
+
+            Assert::IsTrue(dump.find("over the last 1 frames") != std::string::npos);
+        }
+    };
+}
@@ -1,18 +1,176 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
+#include "MathTypes.h"
+#include "PortableMath.h"
+#include "TestHelpers.h"
+
+#include <cmath>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace DirectX::SimpleMath;
 
 namespace UnitTests
 {
-    // Unit tests for my extensions to SimpleMath.h
-	TEST_CLASS(SimpleMathTests)
-	{
-	public:
-		
-		TEST_METHOD(TestMethod1)
-		{
-		}
-
-	};
-}
\ No newline at end of file
+    // The SimpleMath behavior the engine relies on. Off Windows these run against PortableMath, so they also check
+    // that it matches SimpleMath.
+    TEST_CLASS(SimpleMathTests)
+    {
+    private:
+        static void AssertMatrixNear(const Matrix& expected, const Matrix& actual, float tolerance)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                {
+                    Assert::AreEqual(expected.m[row][column], actual.m[row][column], tolerance);
+                }
+            }
+        }
+
+        static void AssertVectorNear(const Vector3& expected, const Vector3& actual, float tolerance)
+        {
+            Assert::AreEqual(expected.x, actual.x, tolerance);
+            Assert::AreEqual(expected.y, actual.y, tolerance);
+            Assert::AreEqual(expected.z, actual.z, tolerance);
+        }
+
+    public:
+        TEST_METHOD(DefaultValues)
+        {
+            Assert::AreEqual(Vector3(0.0f, 0.0f, 0.0f), Vector3());
+            Assert::AreEqual(Vector4(0.0f, 0.0f, 0.0f, 0.0f), Vector4());
+            Assert::IsTrue(Matrix() == Matrix::Identity);
+            Assert::AreEqual(1.0f, Matrix()._44);
+            Assert::IsTrue(Plane(0.0f, 1.0f, 0.0f, 0.0f) == Plane());
+        }
+
+        TEST_METHOD(TransformPointDividesByW)
+        {
+            const Matrix translate = Matrix::CreateTranslation(Vector3(1.0f, 2.0f, 3.0f));
+            AssertVectorNear(Vector3(2.0f, 3.0f, 4.0f), Vector3::Transform(Vector3(1.0f, 1.0f, 1.0f), translate), 0.0f);
+
+            Matrix projective;
+            projective._44 = 2.0f;
+            AssertVectorNear(
+                Vector3(0.5f, 1.0f, 1.5f),
+                Vector3::Transform(Vector3(1.0f, 2.0f, 3.0f), projective),
+                0.0f);
+        }
+
+        TEST_METHOD(MatricesMultiplyAsRowVectors)
+        {
+            // Scale then translate: the translation is not scaled.
+            const Matrix m = Matrix::CreateScale(2.0f, 2.0f, 2.0f) * Matrix::CreateTranslation(1.0f, 0.0f, 0.0f);
+            AssertVectorNear(Vector3(3.0f, 2.0f, 2.0f), Vector3::Transform(Vector3(1.0f, 1.0f, 1.0f), m), 0.0f);
+        }
+
+        TEST_METHOD(YawPitchRollRotations)
+        {
+            const float quarter = 1.5707963f;
+
+            // Yaw turns +z towards +x, pitch turns +z towards -y and roll turns +x towards +y.
+            const Vector3 forward(0.0f, 0.0f, 1.0f);
+            AssertVectorNear(
+                Vector3(1.0f, 0.0f, 0.0f),
+                Vector3::Transform(forward, Matrix::CreateFromYawPitchRoll(quarter, 0.0f, 0.0f)),
+                0.0001f);
+            AssertVectorNear(
+                Vector3(0.0f, -1.0f, 0.0f),
+                Vector3::Transform(forward, Matrix::CreateFromYawPitchRoll(0.0f, quarter, 0.0f)),
+                0.0001f);
+            AssertVectorNear(
+                Vector3(0.0f, 1.0f, 0.0f),
+                Vector3::Transform(Vector3(1.0f, 0.0f, 0.0f), Matrix::CreateFromYawPitchRoll(0.0f, 0.0f, quarter)),
+                0.0001f);
+
+            // Roll is applied first, then pitch, then yaw.
+            const Matrix combined = Matrix::CreateFromYawPitchRoll(0.3f, 0.2f, 0.1f);
+            const Matrix expected =
+                Matrix::CreateRotationZ(0.1f) * Matrix::CreateRotationX(0.2f) * Matrix::CreateRotationY(0.3f);
+
+            AssertMatrixNear(expected, combined, 0.0001f);
+        }
+
+        TEST_METHOD(InvertTimesMatrixIsIdentity)
+        {
+            const Matrix m =
+                Matrix::CreateFromYawPitchRoll(0.4f, -0.3f, 1.2f) *
+                Matrix::CreateScale(2.0f, 0.5f, 3.0f) *
+                Matrix::CreateTranslation(5.0f, -2.0f, 7.0f);
+
+            AssertMatrixNear(Matrix::Identity, m * m.Invert(), 0.0001f);
+            AssertMatrixNear(Matrix::Identity, m.Invert() * m, 0.0001f);
+
+            const Matrix projection = DirectX::XMMatrixPerspectiveFovLH(0.785f, 1.333f, 0.1f, 1000.0f);
+            AssertMatrixNear(Matrix::Identity, projection * projection.Invert(), 0.0001f);
+        }
+
+        TEST_METHOD(LookAtMovesEyeToOriginFacingPositiveZ)
+        {
+            const Vector3 eye(1.0f, 2.0f, -5.0f);
+            const Vector3 focus(1.0f, 2.0f, 5.0f);
+            const Matrix view = DirectX::XMMatrixLookAtLH(eye, focus, Vector3(0.0f, 1.0f, 0.0f));
+
+            AssertVectorNear(Vector3(0.0f, 0.0f, 0.0f), Vector3::Transform(eye, view), 0.0001f);
+            AssertVectorNear(Vector3(0.0f, 0.0f, 10.0f), Vector3::Transform(focus, view), 0.0001f);
+            AssertVectorNear(Vector3(1.0f, 0.0f, 0.0f), Vector3::Transform(Vector3(2.0f, 2.0f, -5.0f), view), 0.0001f);
+        }
+
+        TEST_METHOD(PerspectiveMapsNearAndFarToZeroAndOne)
+        {
+            const Matrix projection = DirectX::XMMatrixPerspectiveFovLH(1.5707963f, 2.0f, 1.0f, 100.0f);
+
+            Assert::AreEqual(0.0f, Vector3::Transform(Vector3(0.0f, 0.0f, 1.0f), projection).z, 0.0001f);
+            Assert::AreEqual(1.0f, Vector3::Transform(Vector3(0.0f, 0.0f, 100.0f), projection).z, 0.0001f);
+
+            // A ninety degree field of view puts y = z on the top edge; the aspect ratio widens x.
+            AssertVectorNear(
+                Vector3(1.0f, 1.0f, projection._33 + projection._43 / 10.0f),
+                Vector3::Transform(Vector3(20.0f, 10.0f, 10.0f), projection),
+                0.0001f);
+
+            const Matrix ortho = DirectX::XMMatrixOrthographicLH(800.0f, 600.0f, 1.0f, 101.0f);
+            AssertVectorNear(
+                Vector3(1.0f, -1.0f, 0.5f),
+                Vector3::Transform(Vector3(400.0f, -300.0f, 51.0f), ortho),
+                0.0001f);
+        }
+
+        TEST_METHOD(PlaneNormalizeScalesDistance)
+        {
+            Plane plane(0.0f, 3.0f, 4.0f, -10.0f);
+            plane.Normalize();
+
+            Assert::AreEqual(0.6f, plane.y, 0.0001f);
+            Assert::AreEqual(0.8f, plane.z, 0.0001f);
+            Assert::AreEqual(-2.0f, plane.w, 0.0001f);
+            Assert::AreEqual(3.0f, plane.DotCoordinate(Vector3(0.0f, 3.0f, 4.0f)), 0.0001f);
+        }
+
+        TEST_METHOD(PortableMathBackendsAgree)
+        {
+            const PortableMath::Matrix a = PortableMath::Matrix::CreateFromYawPitchRoll(0.4f, -0.3f, 1.2f) *
+                                           PortableMath::Matrix::CreateTranslation(5.0f, -2.0f, 7.0f);
+            const PortableMath::Matrix b = PortableMath::XMMatrixPerspectiveFovLH(0.785f, 1.333f, 0.1f, 1000.0f);
+
+            float scalar[16], simd[16];
+            PortableMath::MultiplyMatrix<PortableMath::ScalarBackend>(&a._11, &b._11, scalar);
+            PortableMath::MultiplyMatrix<PortableMath::DefaultBackend>(&a._11, &b._11, simd);
+
+            for (int k = 0; k < 16; ++k)
+            {
+                Assert::AreEqual(scalar[k], simd[k], 0.00001f);
+            }
+
+            const float row[4] = { 1.5f, -2.0f, 3.25f, 1.0f };
+            float scalarRow[4], simdRow[4];
+            PortableMath::TransformRow<PortableMath::ScalarBackend>(row, &b._11, scalarRow);
+            PortableMath::TransformRow<PortableMath::DefaultBackend>(row, &b._11, simdRow);
+
+            for (int k = 0; k < 4; ++k)
+            {
+                Assert::AreEqual(scalarRow[k], simdRow[k], 0.00001f);
+            }
+        }
+    };
+}
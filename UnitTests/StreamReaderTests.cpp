@@ -0,0 +1,200 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "StreamReader.h"
+#include "DXTestException.h"
+#include "PackFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(StreamReaderTests)
+    {
+    private:
+        std::vector<std::string> mFiles;
+
+#pragma pack(push, 1)
+        struct record_t
+        {
+            unsigned short id;
+            double value;
+            char tag;
+        };
+#pragma pack(pop)
+
+        std::wstring WriteFile(const std::string& contents)
+        {
+            std::string filename = "StreamReaderTests_" + std::to_string(mFiles.size()) + ".bin";
+            mFiles.push_back(filename);
+
+            std::ofstream stream(filename.c_str(), std::ios::binary);
+            stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+            return std::wstring(filename.begin(), filename.end());
+        }
+
+        // Odd sized records so they straddle every chunk boundary.
+        static std::string MakeRecords(unsigned int count)
+        {
+            std::string data;
+
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                record_t record;
+                record.id = static_cast<unsigned short>(i);
+                record.value = i * 0.5;
+                record.tag = static_cast<char>('a' + i % 26);
+
+                data.append(reinterpret_cast<const char *>(&record), sizeof(record));
+            }
+
+            return data;
+        }
+
+        static void CheckRecords(StreamReader& reader, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                record_t record = reader.Read<record_t>();
+
+                Assert::AreEqual(static_cast<unsigned short>(i), record.id);
+                Assert::AreEqual(i * 0.5, record.value);
+                Assert::AreEqual(static_cast<char>('a' + i % 26), record.tag);
+            }
+
+            Assert::IsTrue(reader.IsEnd());
+        }
+
+    public:
+        TEST_METHOD_CLEANUP(DeleteFiles)
+        {
+            PackFile::UnmountAll();
+
+            for (const std::string& filename : mFiles)
+            {
+                std::remove(filename.c_str());
+            }
+
+            mFiles.clear();
+        }
+
+        TEST_METHOD(StreamReadsValuesAcrossChunkBoundaries)
+        {
+            const unsigned int count = 1000;
+            std::wstring filepath = WriteFile(MakeRecords(count));
+
+            // Both with and without the read ahead thread.
+            StreamReader readAhead(filepath, 64, true);
+            Assert::AreEqual(static_cast<unsigned long long>(count * sizeof(record_t)), readAhead.Size());
+            CheckRecords(readAhead, count);
+
+            StreamReader synchronous(filepath, 64, false);
+            CheckRecords(synchronous, count);
+
+            // Memory is bounded by the chunk size, not the file size.
+            Assert::IsTrue(readAhead.BufferedBytes() <= 2 * 64);
+            Assert::IsTrue(synchronous.BufferedBytes() <= 64);
+        }
+
+        TEST_METHOD(StreamReadsArraysAndSkips)
+        {
+            std::vector<int> values(5000);
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                values[i] = static_cast<int>(i * 3);
+            }
+
+            std::string data(reinterpret_cast<const char *>(&values[0]), values.size() * sizeof(int));
+            std::wstring filepath = WriteFile(data);
+
+            StreamReader reader(filepath, 100);
+            std::vector<int> first;
+
+            reader.ReadArray(1000, &first);
+            Assert::AreEqual(2997, first.back());
+
+            reader.Skip(1000 * sizeof(int) + 2);
+            Assert::AreEqual(static_cast<unsigned long long>(2000 * sizeof(int) + 2), reader.Position());
+            reader.Skip(2);
+
+            int rest[3000];
+            reader.ReadArray(rest, 2999);
+            Assert::AreEqual(6003, rest[0]);
+            Assert::AreEqual(14997, rest[2998]);
+            Assert::IsTrue(reader.IsEnd());
+        }
+
+        TEST_METHOD(StreamReadsMemory)
+        {
+            const unsigned int count = 10;
+            std::string data = MakeRecords(count);
+
+            StreamReader reader(data.data(), data.size(), L"memory");
+            CheckRecords(reader, count);
+
+            Assert::AreEqual((size_t)0, reader.BufferedBytes());
+        }
+
+        TEST_METHOD(StreamReadsMountedPackEntries)
+        {
+            const unsigned int count = 20000;
+            std::string data = MakeRecords(count);
+
+            PackWriter writer;
+            writer.Add(L"plain.bin", data.data(), data.size());
+            writer.Add(L"compressed.bin", data.data(), data.size(), true);
+
+            mFiles.push_back("StreamReaderTests.pack");
+            writer.Save(L"StreamReaderTests.pack");
+            PackFile::Mount(std::make_shared<PackFile>(L"StreamReaderTests.pack"));
+
+            StreamReader plain(L"plain.bin", 1024);
+            CheckRecords(plain, count);
+            Assert::AreEqual((size_t)0, plain.BufferedBytes());
+
+            // Compressed entries decode a block at a time.
+            StreamReader compressed(L"compressed.bin", 1024);
+            CheckRecords(compressed, count);
+        }
+
+        TEST_METHOD(StreamRejectsReadsPastTheEnd)
+        {
+            std::wstring filepath = WriteFile(std::string(100, 'x'));
+
+            StreamReader reader(filepath, 16);
+            std::vector<char> bytes;
+
+            reader.ReadArray(90, &bytes);
+            Assert::ExpectException<FileFormatException>([&]() { reader.Read<double>(); reader.Read<double>(); });
+            Assert::ExpectException<FileFormatException>([&]() { reader.ReadArray(1000000000, &bytes); });
+            Assert::ExpectException<FileFormatException>([&]() { reader.Skip(100); });
+
+            Assert::ExpectException<FileLoadException>([&]() {
+                StreamReader missing(L"StreamReaderTests_missing.bin");
+            });
+
+            // Empty files are fine until something is read.
+            StreamReader empty(WriteFile(""));
+            Assert::IsTrue(empty.IsEnd());
+            Assert::ExpectException<FileFormatException>([&]() { empty.Read<char>(); });
+        }
+
+        TEST_METHOD(StreamStopsReadAheadWhenDestroyedEarly)
+        {
+            std::wstring filepath = WriteFile(std::string(100000, 'y'));
+
+            for (int i = 0; i < 20; ++i)
+            {
+                StreamReader reader(filepath, 64, true);
+                Assert::AreEqual('y', reader.Read<char>());
+            }
+        }
+    };
+}
@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "TestHelpers.h"
-#include "SimpleMath.h"
+#include "MathTypes.h"
 
 #include <string>
 #include <sstream>
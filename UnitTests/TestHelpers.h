@@ -1,5 +1,5 @@
 #pragma once
-#include "SimpleMath.h"
+#include "MathTypes.h"
 #include <string>
 
 namespace Microsoft
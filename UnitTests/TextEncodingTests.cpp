@@ -0,0 +1,144 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TextEncoding.h"
+#include "DXTestException.h"
+
+#include <initializer_list>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(TextEncodingTests)
+    {
+    private:
+        // Build the wide string for a list of code points, as UTF-16 or UTF-32 depending on the size of wchar_t.
+        static std::wstring Wide(std::initializer_list<unsigned int> codePoints)
+        {
+            std::wstring text;
+
+            for (unsigned int codePoint : codePoints)
+            {
+                if (sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+                {
+                    text.push_back(static_cast<wchar_t>(0xD800 + ((codePoint - 0x10000) >> 10)));
+                    text.push_back(static_cast<wchar_t>(0xDC00 + ((codePoint - 0x10000) & 0x3FF)));
+                }
+                else
+                {
+                    text.push_back(static_cast<wchar_t>(codePoint));
+                }
+            }
+
+            return text;
+        }
+
+        static size_t Utf8ErrorOffset(const std::string& input)
+        {
+            std::wstring output;
+            size_t offset = 12345;
+
+            Assert::IsFalse(TextEncoding::TryUtf8ToWide(input.data(), input.size(), &output, &offset));
+            return offset;
+        }
+
+    public:
+        TEST_METHOD(ConvertAsciiOfEveryLength)
+        {
+            // Covers lengths below, at and past the 16 and 32 character vector widths.
+            std::string narrow;
+            std::wstring wide;
+
+            for (int length = 0; length < 100; ++length)
+            {
+                Assert::IsTrue(wide == TextEncoding::Utf8ToWide(narrow));
+                Assert::AreEqual(narrow, TextEncoding::WideToUtf8(wide));
+
+                narrow.push_back(static_cast<char>(' ' + length % 90));
+                wide.push_back(static_cast<wchar_t>(' ' + length % 90));
+            }
+        }
+
+        TEST_METHOD(ConvertEveryEncodedLength)
+        {
+            // 'A', e acute (2 bytes), the euro sign (3 bytes) and an emoji outside the BMP (4 bytes).
+            const std::string narrow = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+            const std::wstring wide = Wide({ 0x41, 0xE9, 0x20AC, 0x1F600 });
+
+            Assert::IsTrue(wide == TextEncoding::Utf8ToWide(narrow));
+            Assert::AreEqual(narrow, TextEncoding::WideToUtf8(wide));
+
+            // Boundaries of each encoded length.
+            const std::wstring limits = Wide({ 0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xE000, 0xFFFF, 0x10000, 0x10FFFF });
+            Assert::IsTrue(limits == TextEncoding::Utf8ToWide(TextEncoding::WideToUtf8(limits)));
+        }
+
+        TEST_METHOD(ConvertMixedTextAcrossVectorBlocks)
+        {
+            // Non-ASCII characters landing at every position of a vector block.
+            for (size_t position = 0; position < 40; ++position)
+            {
+                std::string narrow(48, 'x');
+                narrow.replace(position, 1, "\xE6\x97\xA5");
+
+                std::wstring wide(48, L'x');
+                wide.replace(position, 1, Wide({ 0x65E5 }));
+
+                Assert::IsTrue(wide == TextEncoding::Utf8ToWide(narrow));
+                Assert::AreEqual(narrow, TextEncoding::WideToUtf8(wide));
+            }
+        }
+
+        TEST_METHOD(RejectInvalidUtf8)
+        {
+            Assert::AreEqual((size_t)3, Utf8ErrorOffset("abc\x80"));                   // Stray continuation.
+            Assert::AreEqual((size_t)1, Utf8ErrorOffset("a\xC0\x80"));                 // Overlong NUL.
+            Assert::AreEqual((size_t)0, Utf8ErrorOffset("\xE0\x80\xAF"));              // Overlong '/'.
+            Assert::AreEqual((size_t)0, Utf8ErrorOffset("\xF0\x82\x82\xAC"));          // Overlong euro.
+            Assert::AreEqual((size_t)2, Utf8ErrorOffset("ab\xED\xA0\x80"));            // Encoded surrogate.
+            Assert::AreEqual((size_t)0, Utf8ErrorOffset("\xF4\x90\x80\x80"));          // Above U+10FFFF.
+            Assert::AreEqual((size_t)0, Utf8ErrorOffset("\xF5\x80\x80\x80"));          // Invalid lead byte.
+            Assert::AreEqual((size_t)1, Utf8ErrorOffset("a\xE2\x82"));                 // Truncated.
+            Assert::AreEqual((size_t)1, Utf8ErrorOffset("a\xE2\x82z"));                // Missing continuation.
+
+            // The error is found past a long ASCII run, and the text before it is kept.
+            std::string input = std::string(40, 'a') + "\xFF";
+            std::wstring output;
+            size_t offset = 0;
+
+            Assert::IsFalse(TextEncoding::TryUtf8ToWide(input.data(), input.size(), &output, &offset));
+            Assert::AreEqual((size_t)40, offset);
+            Assert::IsTrue(std::wstring(40, L'a') == output);
+
+            try
+            {
+                TextEncoding::Utf8ToWide("ok\xC3");
+                Assert::Fail(L"Expected TextEncodingException");
+            }
+            catch (const TextEncodingException& e)
+            {
+                Assert::AreEqual((size_t)2, e.Offset());
+            }
+        }
+
+        TEST_METHOD(RejectUnpairedSurrogates)
+        {
+            std::string output;
+            size_t offset = 0;
+
+            const std::wstring lowFirst = Wide({ 'a', 0xDC00, 'b' });
+            Assert::IsFalse(TextEncoding::TryWideToUtf8(lowFirst.data(), lowFirst.size(), &output, &offset));
+            Assert::AreEqual((size_t)1, offset);
+            Assert::AreEqual(std::string("a"), output);
+
+            const std::wstring highLast = std::wstring(20, L'z') + Wide({ 0xD83D });
+            Assert::IsFalse(TextEncoding::TryWideToUtf8(highLast.data(), highLast.size(), &output, &offset));
+            Assert::AreEqual((size_t)20, offset);
+
+            Assert::ExpectException<TextEncodingException>([]() {
+                TextEncoding::WideToUtf8(Wide({ 0xD800, 'x' }));
+            });
+        }
+    };
+}
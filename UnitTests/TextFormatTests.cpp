@@ -0,0 +1,196 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "TextFormat.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(TextFormatTests)
+    {
+    private:
+        template<typename T>
+        static std::string Format(T value)
+        {
+            return FormatBuffer() << value;
+        }
+
+        // Fewest significant digits printf needs for the value to read back the same.
+        static size_t ShortestPrintfDigits(double value)
+        {
+            char text[64];
+
+            for (int precision = 1; precision < 17; ++precision)
+            {
+                std::snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+
+                if (std::strtod(text, nullptr) == value)
+                {
+                    return static_cast<size_t>(precision);
+                }
+            }
+
+            return 17;
+        }
+
+        static size_t SignificantDigits(const std::string& text)
+        {
+            size_t first = text.find_first_of("123456789");
+            size_t last = text.find_last_of("123456789", text.find('e'));
+            size_t digits = 0;
+
+            for (size_t i = first; i <= last; ++i)
+            {
+                digits += (text[i] >= '0' && text[i] <= '9') ? 1 : 0;
+            }
+
+            return digits;
+        }
+
+    public:
+        TEST_METHOD(FormatIntegers)
+        {
+            Assert::AreEqual(std::string("0"), Format(0));
+            Assert::AreEqual(std::string("7"), Format(7));
+            Assert::AreEqual(std::string("-42"), Format(-42));
+            Assert::AreEqual(std::string("1000000"), Format(1000000u));
+            Assert::AreEqual(std::string("-2147483648"), Format(INT_MIN));
+            Assert::AreEqual(std::string("-9223372036854775808"), Format(LLONG_MIN));
+            Assert::AreEqual(std::string("18446744073709551615"), Format(ULLONG_MAX));
+            Assert::AreEqual(std::string("true false"), (FormatBuffer() << true << ' ' << false).ToString());
+
+            Assert::AreEqual(std::string("ff"), Format(TextFormat::Hex(255)));
+            Assert::AreEqual(std::string("000000ff"), Format(TextFormat::Hex(255, 8)));
+            Assert::AreEqual(std::string("ffffffffffffffff"), Format(TextFormat::Hex(ULLONG_MAX, 4)));
+            Assert::AreEqual(std::string("0"), Format(TextFormat::Hex(0)));
+
+            for (long long value = -100000; value <= 100000; value += 7)
+            {
+                Assert::AreEqual(std::to_string(value), Format(value));
+            }
+        }
+
+        TEST_METHOD(FormatShortestFloats)
+        {
+            Assert::AreEqual(std::string("0"), Format(0.0));
+            Assert::AreEqual(std::string("-0"), Format(-0.0));
+            Assert::AreEqual(std::string("0.1"), Format(0.1));
+            Assert::AreEqual(std::string("0.1"), Format(0.1f));
+            Assert::AreEqual(std::string("1.5"), Format(1.5f));
+            Assert::AreEqual(std::string("-250"), Format(-250.0));
+            Assert::AreEqual(std::string("0.30000000000000004"), Format(0.1 + 0.2));
+            Assert::AreEqual(std::string("0.0001"), Format(0.0001));
+            Assert::AreEqual(std::string("1e-05"), Format(0.00001));
+            Assert::AreEqual(std::string("123456789012345"), Format(123456789012345.0));
+            Assert::AreEqual(std::string("1e+22"), Format(1e22));
+            Assert::AreEqual(std::string("1.7976931348623157e+308"), Format(DBL_MAX));
+            Assert::AreEqual(std::string("5e-324"), Format(4.9e-324));
+            Assert::AreEqual(std::string("3.4028235e+38"), Format(FLT_MAX));
+            Assert::AreEqual(std::string("inf"), Format(std::numeric_limits<double>::infinity()));
+            Assert::AreEqual(std::string("-inf"), Format(-std::numeric_limits<float>::infinity()));
+            Assert::AreEqual(std::string("nan"), Format(std::numeric_limits<double>::quiet_NaN()));
+        }
+
+        TEST_METHOD(FloatsRoundTrip)
+        {
+            std::mt19937_64 random(1234);
+            size_t longerThanShortest = 0;
+
+            for (int i = 0; i < 100000; ++i)
+            {
+                // Random bit patterns cover every exponent, denormals included.
+                unsigned long long bits = random();
+                double value = 0.0;
+                std::memcpy(&value, &bits, sizeof(value));
+
+                if (!std::isfinite(value))
+                {
+                    continue;
+                }
+
+                const std::string text = Format(value);
+                Assert::AreEqual(value, std::strtod(text.c_str(), nullptr));
+
+                longerThanShortest += SignificantDigits(text) > ShortestPrintfDigits(value) ? 1 : 0;
+
+                const float single = static_cast<float>(i) * 0.37f - 1000.0f / static_cast<float>(i + 1);
+                Assert::AreEqual(single, std::strtof(Format(single).c_str(), nullptr));
+            }
+
+            // Grisu2 is one digit too long on a small fraction of inputs.
+            Assert::IsTrue(longerThanShortest < 1000);
+        }
+
+        TEST_METHOD(FormatFixed)
+        {
+            Assert::AreEqual(std::string("3.14"), Format(TextFormat::Fixed(3.14159, 2)));
+            Assert::AreEqual(std::string("2.50"), Format(TextFormat::Fixed(2.5, 2)));
+            Assert::AreEqual(std::string("-0.001"), Format(TextFormat::Fixed(-0.00075, 3)));
+            Assert::AreEqual(std::string("0.00"), Format(TextFormat::Fixed(-0.001, 2)));
+            Assert::AreEqual(std::string("17"), Format(TextFormat::Fixed(16.6, 0)));
+            Assert::AreEqual(std::string("1e+20"), Format(TextFormat::Fixed(1e20, 2)));
+        }
+
+        TEST_METHOD(MixNarrowAndWideText)
+        {
+            const std::string narrow = "caf\xC3\xA9";
+            const std::wstring wide = L"caf\u00E9";
+
+            Assert::AreEqual(std::wstring(L"caf\u00E9 caf\u00E9 7"),
+                (WideFormatBuffer() << narrow << L' ' << wide << ' ' << 7).ToString());
+            Assert::AreEqual(std::string("caf\xC3\xA9 caf\xC3\xA9"),
+                (FormatBuffer() << narrow << ' ' << wide).ToString());
+
+            // Invalid input is replaced rather than thrown on, this is used to build error messages.
+            Assert::AreEqual(std::wstring(L"a\uFFFDb"), (WideFormatBuffer() << "a\xFF" "b").ToString());
+        }
+
+        TEST_METHOD(LongTextMovesToTheHeap)
+        {
+            FormatBuffer buffer;
+            std::string expected;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                buffer << i << ',';
+                expected += std::to_string(i) + ",";
+            }
+
+            Assert::AreEqual(expected, buffer.ToString());
+            Assert::AreEqual(expected.size(), buffer.Size());
+            Assert::AreEqual(expected.c_str(), buffer.CString());
+
+            // Copies own their text.
+            FormatBuffer copy = buffer;
+            buffer.Clear();
+            buffer << "x";
+
+            Assert::AreEqual(expected, copy.ToString());
+            Assert::AreEqual(std::string("x"), buffer.ToString());
+        }
+
+        TEST_METHOD(ShortTextDoesNotAllocate)
+        {
+            const unsigned long long allocations = AllocationCounter::Count();
+
+            WideFormatBuffer buffer;
+            buffer << L"Expected " << 1024 << L" vertices, found " << -3 << L" at " << 0.25f << L" " << 1e100;
+            buffer << L" in " << "model.mesh" << L' ' << TextFormat::Hex(0xBEEF, 8);
+
+            Assert::AreEqual(allocations, AllocationCounter::Count());
+            Assert::AreEqual(
+                L"Expected 1024 vertices, found -3 at 0.25 1e+100 in model.mesh 0000beef", buffer.CString());
+        }
+    };
+}
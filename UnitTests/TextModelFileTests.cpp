@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "DXTestException.h"
+#include "MeshData.h"
+#include "TextModelFile.h"
+
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(TextModelFileTests)
+    {
+    private:
+        static void Read(const std::string& text, s_mesh_data_t *pMeshOut)
+        {
+            TextModelFile::Read(text.data(), text.size(), L"test", pMeshOut);
+        }
+
+    public:
+        TEST_METHOD(TextModelReadsVersion1)
+        {
+            s_mesh_data_t mesh;
+            Read(
+                "3\n"
+                "-1.0  1.0 -1.0 0.0 0.0  0.0  0.0 -1.0\n"
+                " 1.0  1.0 -1.0 1.0 0.0  0.0  0.0 -1.0\n"
+                "-1.0 -1.0 -1.0 0.0 1.0  0.0  0.0 -1.0\n",
+                &mesh);
+
+            Assert::AreEqual((size_t)3, mesh.vertices.size());
+            Assert::AreEqual((size_t)3, mesh.indices.size());
+            Assert::AreEqual(2, mesh.indices[2]);
+            Assert::AreEqual(1.0f, mesh.vertices[1].x);
+            Assert::AreEqual(1.0f, mesh.vertices[2].tv);
+            Assert::AreEqual(-1.0f, mesh.bounds.box.min[0]);
+        }
+
+        TEST_METHOD(TextModelReadsVersion2)
+        {
+            s_mesh_data_t mesh;
+            Read(
+                "#SimpleModelv1\n"
+                "4 6\n"
+                "0 0 0 0 0 0 0 -1\n"
+                "1 0 0 1 0 0 0 -1\n"
+                "1 1 0 1 1 0 0 -1\n"
+                "0 1 0 0 1 0 0 -1\n"
+                "0 2 1 0 3 2\n",
+                &mesh);
+
+            Assert::AreEqual((size_t)4, mesh.vertices.size());
+            Assert::AreEqual((size_t)6, mesh.indices.size());
+            Assert::AreEqual(3, mesh.indices[4]);
+            Assert::AreEqual(-1.0f, mesh.vertices[3].nz);
+            Assert::AreEqual(1.0f, mesh.bounds.box.max[1]);
+        }
+
+        TEST_METHOD(TextModelRejectsMalformedText)
+        {
+            s_mesh_data_t mesh;
+
+            // Truncated, bad index, absurd count and not a number at all.
+            Assert::ExpectException<FileFormatException>([&]() {
+                Read("#SimpleModelv1 2 3\n0 0 0 0 0 0 0 1\n", &mesh);
+            });
+            Assert::ExpectException<FileFormatException>([&]() {
+                Read("#SimpleModelv1 1 3\n0 0 0 0 0 0 0 1\n0 0 1\n", &mesh);
+            });
+            Assert::ExpectException<FileFormatException>([&]() { Read("4000000000\n0 0 0 0 0 0 0 1\n", &mesh); });
+            Assert::ExpectException<FileFormatException>([&]() { Read("cube", &mesh); });
+        }
+    };
+}
@@ -0,0 +1,239 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "TextUtils.h"
+
+#include <cstdlib>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TextUtils;
+
+namespace UnitTests
+{
+    TEST_CLASS(TextUtilsTests)
+    {
+    private:
+        static std::string Str(StringView view)
+        {
+            return view.ToString();
+        }
+
+    public:
+        TEST_METHOD(StringViewBasics)
+        {
+            const std::string text = "Hello World";
+            StringView view(text);
+
+            Assert::AreEqual((size_t)11, view.Size());
+            Assert::IsTrue(view.Data() == text.data());
+            Assert::IsTrue(view == "Hello World");
+            Assert::IsTrue(view != "Hello");
+            Assert::IsTrue(StringView("abc") < StringView("abd"));
+            Assert::IsTrue(StringView("ab") < StringView("abc"));
+
+            Assert::AreEqual(std::string("World"), Str(view.Substring(6)));
+            Assert::AreEqual(std::string("lo"), Str(view.Substring(3, 2)));
+            Assert::IsTrue(view.Substring(50).IsEmpty());
+            Assert::AreEqual((size_t)4, view.Find('o'));
+            Assert::AreEqual((size_t)7, view.Find('o', 5));
+            Assert::IsTrue(view.Find('z') == StringView::NotFound);
+        }
+
+        TEST_METHOD(TrimReturnsViewsOfTheInput)
+        {
+            const std::string text = " \t hello world\r\n ";
+
+            Assert::AreEqual(std::string("hello world\r\n "), Str(TrimLeft(text)));
+            Assert::AreEqual(std::string(" \t hello world"), Str(TrimRight(text)));
+            Assert::AreEqual(std::string("hello world"), Str(Trim(text)));
+            Assert::IsTrue(Trim(text).Data() == text.data() + 3);
+
+            Assert::IsTrue(Trim("   ").IsEmpty());
+            Assert::IsTrue(Trim("").IsEmpty());
+            Assert::IsTrue(Trim(L"  wide ") == L"wide");
+
+            // UTF-8 bytes are never whitespace.
+            Assert::AreEqual(std::string("\xC2\xA0x\xC2\xA0"), Str(Trim(" \xC2\xA0x\xC2\xA0 ")));
+        }
+
+        TEST_METHOD(CompareAndMatch)
+        {
+            Assert::IsTrue(StartsWith("model.mesh", "model"));
+            Assert::IsTrue(StartsWith("model.mesh", ""));
+            Assert::IsFalse(StartsWith("mod", "model"));
+            Assert::IsTrue(EndsWith(L"model.mesh", L".mesh"));
+            Assert::IsFalse(EndsWith(L"model.mesh", L".MESH"));
+
+            Assert::IsTrue(EqualsIgnoreCase("Model.MESH", "model.mesh"));
+            Assert::IsFalse(EqualsIgnoreCase("model", "models"));
+            Assert::IsTrue(EqualsIgnoreCase(L"Textures/Stone.DDS", L"textures/stone.dds"));
+            Assert::IsTrue(CompareIgnoreCase("apple", "BANANA") < 0);
+            Assert::IsTrue(CompareIgnoreCase("Cherry", "banana") > 0);
+            Assert::IsTrue(CompareIgnoreCase("abc", "ABCD") < 0);
+            Assert::AreEqual(0, CompareIgnoreCase("", ""));
+        }
+
+        TEST_METHOD(SplitKeepsEmptyPartsAndTheRest)
+        {
+            StringView parts[3];
+
+            Assert::AreEqual((size_t)3, Split("a,,b", ',', parts, 3));
+            Assert::AreEqual(std::string("a"), Str(parts[0]));
+            Assert::IsTrue(parts[1].IsEmpty());
+            Assert::AreEqual(std::string("b"), Str(parts[2]));
+
+            // More parts than room, the last holds the rest.
+            Assert::AreEqual((size_t)3, Split("1f 200 path with spaces.mesh", ' ', parts, 3));
+            Assert::AreEqual(std::string("path with spaces.mesh"), Str(parts[2]));
+
+            Assert::AreEqual((size_t)1, Split("", ',', parts, 3));
+            Assert::IsTrue(parts[0].IsEmpty());
+            Assert::AreEqual((size_t)0, Split("a,b", ',', parts, 0));
+        }
+
+        TEST_METHOD(TokenizerSkipsRunsOfDelimiters)
+        {
+            Tokenizer tokens("  one two\t\tthree\r\n");
+            StringView token;
+
+            Assert::IsTrue(tokens.Next(&token));
+            Assert::AreEqual(std::string("one"), Str(token));
+            Assert::IsTrue(tokens.Next(&token));
+            Assert::AreEqual(std::string("two"), Str(token));
+            Assert::AreEqual(std::string("\t\tthree\r\n"), Str(tokens.Rest()));
+            Assert::IsTrue(tokens.Next(&token));
+            Assert::AreEqual(std::string("three"), Str(token));
+            Assert::IsFalse(tokens.Next(&token));
+            Assert::IsFalse(tokens.Next(&token));
+
+            std::string joined;
+
+            for (StringView word : Tokenizer("a;b;;c", ";"))
+            {
+                joined += Str(word) + "|";
+            }
+
+            Assert::AreEqual(std::string("a|b|c|"), joined);
+
+            Tokenizer numbers("12 -3 0.5 x");
+            int i = 0;
+            float f = 0.0f;
+            unsigned int u = 0;
+
+            Assert::IsTrue(numbers.NextUnsignedInt(&u) && u == 12);
+            Assert::IsTrue(numbers.NextInt(&i) && i == -3);
+            Assert::IsTrue(numbers.NextFloat(&f) && f == 0.5f);
+            Assert::IsFalse(numbers.NextFloat(&f));
+            Assert::IsFalse(numbers.NextFloat(&f));
+        }
+
+        TEST_METHOD(ParseIntegers)
+        {
+            int i = 0;
+            unsigned int u = 0;
+            unsigned long long ull = 0;
+
+            Assert::IsTrue(ParseInt("42", &i) && i == 42);
+            Assert::IsTrue(ParseInt("+7", &i) && i == 7);
+            Assert::IsTrue(ParseInt("-2147483648", &i) && i == -2147483647 - 1);
+            Assert::IsTrue(ParseInt("2147483647", &i) && i == 2147483647);
+            Assert::IsFalse(ParseInt("2147483648", &i));
+            Assert::IsFalse(ParseInt("-2147483649", &i));
+            Assert::IsFalse(ParseInt("", &i));
+            Assert::IsFalse(ParseInt("-", &i));
+            Assert::IsFalse(ParseInt("12a", &i));
+            Assert::IsFalse(ParseInt(" 12", &i));
+
+            Assert::IsTrue(ParseUnsignedInt("4294967295", &u) && u == 4294967295u);
+            Assert::IsFalse(ParseUnsignedInt("4294967296", &u));
+            Assert::IsFalse(ParseUnsignedInt("-1", &u));
+            Assert::IsTrue(ParseUnsignedInt("18446744073709551615", &ull) && ull == 18446744073709551615ull);
+            Assert::IsFalse(ParseUnsignedInt("18446744073709551616", &ull));
+
+            Assert::IsTrue(ParseHex("fFa0", &ull) && ull == 0xFFA0);
+            Assert::IsTrue(ParseHex("ffffffffffffffff", &ull) && ull == 0xFFFFFFFFFFFFFFFFull);
+            Assert::IsFalse(ParseHex("1ffffffffffffffff", &ull));
+            Assert::IsFalse(ParseHex("0x10", &ull));
+            Assert::IsFalse(ParseHex("", &ull));
+        }
+
+        TEST_METHOD(ParseFloatsMatchStrtod)
+        {
+            const char * const inputs[] =
+            {
+                "0", "-0", "1", "-1.5", "0.1", ".5", "5.", "3.14159265358979", "1e10", "1E-5", "-2.5e+3",
+                "123456789012345678901234567890", "0.000000000000000000000000000001", "1.7976931348623157e308",
+                "4.9e-324", "2.2250738585072014e-308", "9007199254740993", "0.30000000000000004", "1e23", "8.589973e9"
+            };
+
+            for (const char * pInput : inputs)
+            {
+                double value = 0.0;
+                Assert::IsTrue(ParseDouble(pInput, &value));
+                Assert::AreEqual(std::strtod(pInput, nullptr), value);
+            }
+
+            float f = 0.0f;
+            Assert::IsTrue(ParseFloat("-0.25", &f) && f == -0.25f);
+            Assert::IsTrue(ParseFloat("1e-50", &f) && f == 0.0f);
+            Assert::IsFalse(ParseFloat("1e39", &f));
+
+            double d = 0.0;
+            Assert::IsFalse(ParseDouble("1e400", &d));
+            Assert::IsFalse(ParseDouble("", &d));
+            Assert::IsFalse(ParseDouble(".", &d));
+            Assert::IsFalse(ParseDouble("1e", &d));
+            Assert::IsFalse(ParseDouble("1.0f", &d));
+            Assert::IsFalse(ParseDouble("--1", &d));
+            Assert::IsFalse(ParseDouble("inf", &d));
+            Assert::IsFalse(ParseDouble("nan", &d));
+        }
+
+        TEST_METHOD(TextUtilitiesDoNotAllocate)
+        {
+            const std::string text = "  v 1.0 -2.5 3e2\n  f 1 2 3\n  # comment with CAPS  \n";
+            const unsigned long long allocations = AllocationCounter::Count();
+
+            float sum = 0.0f;
+            int indexSum = 0;
+            Tokenizer lines(text, "\n");
+            StringView line;
+
+            while (lines.Next(&line))
+            {
+                line = Trim(line);
+                StringView parts[4];
+                const size_t count = Split(line, ' ', parts, 4);
+
+                if (StartsWith(line, "v "))
+                {
+                    for (size_t i = 1; i < count; ++i)
+                    {
+                        float value = 0.0f;
+                        Assert::IsTrue(ParseFloat(parts[i], &value));
+                        sum += value;
+                    }
+                }
+                else if (EqualsIgnoreCase(parts[0], "F"))
+                {
+                    Tokenizer indices(line.Substring(2));
+                    int index = 0;
+
+                    while (indices.NextInt(&index))
+                    {
+                        indexSum += index;
+                    }
+                }
+                else
+                {
+                    Assert::IsTrue(EndsWith(line, "CAPS"));
+                }
+            }
+
+            Assert::AreEqual(allocations, AllocationCounter::Count());
+            Assert::AreEqual(298.5f, sum);
+            Assert::AreEqual(6, indexSum);
+        }
+    };
+}
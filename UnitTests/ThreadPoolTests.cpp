@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "ThreadPool.h"
+#include "Range.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(ThreadPoolTests)
+    {
+    public:
+        TEST_METHOD(RunVisitsEveryTaskOnce)
+        {
+            ThreadPool pool(4);
+            std::vector<std::atomic<int>> visits(1000);
+
+            for (int batch = 0; batch < 50; ++batch)
+            {
+                pool.Run(visits.size(), [&](size_t i) { visits[i]++; });
+            }
+
+            for (const std::atomic<int>& count : visits)
+            {
+                Assert::AreEqual(50, count.load());
+            }
+
+            Assert::AreEqual(4u, pool.ThreadCount());
+        }
+
+        TEST_METHOD(ParallelForSumsRange)
+        {
+            ThreadPool pool(3);
+            const unsigned int grains[] = { 0, 1, 7, 5000 };
+
+            for (unsigned int grain : grains)
+            {
+                std::atomic<unsigned long long> sum(0);
+                ParallelFor(pool, MakeRange(1, 1001), [&](unsigned int i) { sum += i; }, grain);
+
+                Assert::IsTrue(sum == 500500ull);
+            }
+
+            std::atomic<unsigned int> strided(0);
+            ParallelFor(pool, MakeStridedRange(0, 100, 10), [&](unsigned int i) { strided += i; });
+            Assert::AreEqual(450u, strided.load());
+
+            std::atomic<unsigned int> cells(0);
+            ParallelFor(pool, MakeTiles2D(30, 20, 8, 8), [&](const tile_2d_t& tile) {
+                cells += static_cast<unsigned int>(tile.x.size() * tile.y.size());
+            });
+            Assert::AreEqual(600u, cells.load());
+
+            // Empty ranges never call the function.
+            ParallelFor(pool, MakeRange(5, 5), [](unsigned int) { Assert::Fail(); });
+        }
+
+        TEST_METHOD(ExceptionsReachTheCaller)
+        {
+            ThreadPool pool(4);
+            bool caught = false;
+
+            try
+            {
+                pool.Run(100, [](size_t i) {
+                    if (i == 37)
+                    {
+                        throw std::runtime_error("task failed");
+                    }
+                });
+            }
+            catch (const std::runtime_error&)
+            {
+                caught = true;
+            }
+
+            Assert::IsTrue(caught);
+
+            // The pool still works afterwards.
+            std::atomic<int> count(0);
+            pool.Run(10, [&](size_t) { count++; });
+            Assert::AreEqual(10, count.load());
+        }
+
+        TEST_METHOD(NestedLoopsDoNotDeadlock)
+        {
+            ThreadPool pool(4);
+            std::atomic<int> count(0);
+
+            ParallelFor(pool, MakeRange(0, 16), [&](unsigned int) {
+                ParallelFor(pool, MakeRange(0, 16), [&](unsigned int) { count++; });
+            }, 1);
+
+            Assert::AreEqual(256, count.load());
+        }
+
+        TEST_METHOD(SingleThreadPoolRunsInline)
+        {
+            ThreadPool pool(1);
+            std::vector<size_t> order;
+
+            pool.Run(5, [&](size_t i) { order.push_back(i); });
+
+            Assert::AreEqual(static_cast<size_t>(5), order.size());
+
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                Assert::AreEqual(i, order[i]);
+            }
+        }
+    };
+}
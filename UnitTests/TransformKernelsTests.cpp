@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TransformKernels.h"
+#include "BoundingVolumes.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(TransformKernelsTests)
+    {
+    private:
+        // Rotation about y by 30 degrees, non uniform scale of (2, 1, 0.5) and a translation, row vector layout.
+        static const float * TestMatrix()
+        {
+            static const float matrix[16] =
+            {
+                1.7320508f, 0.0f, -1.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.25f, 0.0f, 0.4330127f, 0.0f,
+                10.0f, -5.0f, 2.5f, 1.0f
+            };
+
+            return matrix;
+        }
+
+        // Counts around the register widths, so every mix of SIMD and scalar tail runs.
+        static std::vector<size_t> Counts()
+        {
+            const size_t counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 100 };
+            return std::vector<size_t>(counts, counts + sizeof(counts) / sizeof(counts[0]));
+        }
+
+        struct soa_storage_t
+        {
+            explicit soa_storage_t(size_t count)
+                : x(count + 1), y(count + 1), z(count + 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    x[i] = static_cast<float>(i) * 0.5f - 3.0f;
+                    y[i] = static_cast<float>(i % 7) - 2.0f;
+                    z[i] = 1.0f / static_cast<float>(i + 1);
+                }
+            }
+
+            soa_vectors_t View() { soa_vectors_t view = { &x[0], &y[0], &z[0] }; return view; }
+
+            std::vector<float> x, y, z;
+        };
+
+    public:
+        TEST_METHOD(TransformPointsMatchesScalarMath)
+        {
+            const float * m = TestMatrix();
+
+            for (size_t count : Counts())
+            {
+                soa_storage_t input(count), output(count);
+                output.x[count] = 123.0f;
+
+                TransformKernels::TransformPoints(m, input.View(), output.View(), count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const float x = input.x[i], y = input.y[i], z = input.z[i];
+
+                    Assert::AreEqual(x * m[0] + y * m[4] + z * m[8] + m[12], output.x[i], 0.0001f);
+                    Assert::AreEqual(x * m[1] + y * m[5] + z * m[9] + m[13], output.y[i], 0.0001f);
+                    Assert::AreEqual(x * m[2] + y * m[6] + z * m[10] + m[14], output.z[i], 0.0001f);
+                }
+
+                // Nothing written past the end.
+                Assert::AreEqual(123.0f, output.x[count]);
+
+                // Transforming in place gives the same result.
+                TransformKernels::TransformPoints(m, input.View(), input.View(), count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Assert::AreEqual(output.x[i], input.x[i]);
+                    Assert::AreEqual(output.z[i], input.z[i]);
+                }
+            }
+        }
+
+        TEST_METHOD(TransformVectorsIgnoresTranslation)
+        {
+            const float * m = TestMatrix();
+            soa_storage_t input(17), output(17);
+
+            TransformKernels::TransformVectors(m, input.View(), output.View(), 17);
+
+            for (size_t i = 0; i < 17; ++i)
+            {
+                const float x = input.x[i], y = input.y[i], z = input.z[i];
+
+                Assert::AreEqual(x * m[0] + y * m[4] + z * m[8], output.x[i], 0.0001f);
+                Assert::AreEqual(x * m[1] + y * m[5] + z * m[9], output.y[i], 0.0001f);
+                Assert::AreEqual(x * m[2] + y * m[6] + z * m[10], output.z[i], 0.0001f);
+            }
+        }
+
+        TEST_METHOD(TransformNormalsAreUnitLength)
+        {
+            for (size_t count : Counts())
+            {
+                soa_storage_t input(count), output(count);
+
+                if (count > 2)
+                {
+                    input.x[2] = input.y[2] = input.z[2] = 0.0f;
+                }
+
+                TransformKernels::TransformNormals(TestMatrix(), input.View(), output.View(), count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const float length =
+                        std::sqrt(output.x[i] * output.x[i] + output.y[i] * output.y[i] + output.z[i] * output.z[i]);
+
+                    Assert::AreEqual(i == 2 ? 0.0f : 1.0f, length, 0.0001f);
+                }
+            }
+        }
+
+        TEST_METHOD(TransformBoundsMatchesBoundingVolumes)
+        {
+            const float * m = TestMatrix();
+
+            for (size_t count : Counts())
+            {
+                soa_storage_t minimum(count), maximum(count), radius(count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    maximum.x[i] = minimum.x[i] + 1.0f + static_cast<float>(i % 3);
+                    maximum.y[i] = minimum.y[i] + 0.5f;
+                    maximum.z[i] = minimum.z[i] + 2.0f;
+                }
+
+                soa_storage_t outMinimum(count), outMaximum(count), outRadius(count);
+                soa_aabbs_t boxes = { minimum.View(), maximum.View() };
+                soa_aabbs_t outBoxes = { outMinimum.View(), outMaximum.View() };
+                soa_spheres_t spheres = { minimum.View(), &radius.z[0] };
+                soa_spheres_t outSpheres = { outMinimum.View(), &outRadius.x[0] };
+
+                TransformKernels::TransformAabbs(m, boxes, outBoxes, count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const aabb_t box =
+                    {
+                        { minimum.x[i], minimum.y[i], minimum.z[i] },
+                        { maximum.x[i], maximum.y[i], maximum.z[i] }
+                    };
+
+                    const aabb_t expected = BoundingVolumes::TransformAabb(box, m);
+
+                    Assert::AreEqual(expected.min[0], outMinimum.x[i], 0.0001f);
+                    Assert::AreEqual(expected.min[1], outMinimum.y[i], 0.0001f);
+                    Assert::AreEqual(expected.min[2], outMinimum.z[i], 0.0001f);
+                    Assert::AreEqual(expected.max[0], outMaximum.x[i], 0.0001f);
+                    Assert::AreEqual(expected.max[1], outMaximum.y[i], 0.0001f);
+                    Assert::AreEqual(expected.max[2], outMaximum.z[i], 0.0001f);
+                }
+
+                TransformKernels::TransformSpheres(m, spheres, outSpheres, count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const bounding_sphere_t sphere = { { minimum.x[i], minimum.y[i], minimum.z[i] }, radius.z[i] };
+                    const bounding_sphere_t expected = BoundingVolumes::TransformSphere(sphere, m);
+
+                    Assert::AreEqual(expected.center[0], outMinimum.x[i], 0.0001f);
+                    Assert::AreEqual(expected.center[1], outMinimum.y[i], 0.0001f);
+                    Assert::AreEqual(expected.center[2], outMinimum.z[i], 0.0001f);
+                    Assert::AreEqual(expected.radius, outRadius.x[i], 0.0001f);
+                }
+            }
+        }
+
+        TEST_METHOD(MultiplyMatricesMatchesScalarMath)
+        {
+            const float * b = TestMatrix();
+            std::vector<float> matrices(5 * 16);
+
+            for (size_t k = 0; k < matrices.size(); ++k)
+            {
+                matrices[k] = static_cast<float>(k % 11) * 0.25f - 1.0f;
+            }
+
+            std::vector<float> output(matrices.size());
+            TransformKernels::MultiplyMatrices(&matrices[0], b, &output[0], 5);
+
+            for (size_t i = 0; i < 5; ++i)
+            {
+                const float * a = &matrices[i * 16];
+
+                for (int row = 0; row < 4; ++row)
+                {
+                    for (int column = 0; column < 4; ++column)
+                    {
+                        float expected = 0.0f;
+
+                        for (int k = 0; k < 4; ++k)
+                        {
+                            expected += a[row * 4 + k] * b[k * 4 + column];
+                        }
+
+                        Assert::AreEqual(expected, output[i * 16 + row * 4 + column], 0.0001f);
+                    }
+                }
+            }
+
+            // In place.
+            TransformKernels::MultiplyMatrices(&matrices[0], b, &matrices[0], 5);
+
+            for (size_t k = 0; k < matrices.size(); ++k)
+            {
+                Assert::AreEqual(output[k], matrices[k]);
+            }
+        }
+
+        TEST_METHOD(GatherAndScatterInterleavedPoints)
+        {
+            // Position followed by two other floats, like a vertex with texture coordinates.
+            std::vector<float> vertices(9 * 5);
+
+            for (size_t k = 0; k < vertices.size(); ++k)
+            {
+                vertices[k] = static_cast<float>(k);
+            }
+
+            soa_storage_t points(9);
+            TransformKernels::GatherPoints(&vertices[0], 9, 5 * sizeof(float), points.View());
+
+            Assert::AreEqual(10.0f, points.x[2]);
+            Assert::AreEqual(11.0f, points.y[2]);
+            Assert::AreEqual(12.0f, points.z[2]);
+
+            points.x[2] = -1.0f;
+            TransformKernels::ScatterPoints(points.View(), 9, &vertices[0], 5 * sizeof(float));
+
+            Assert::AreEqual(-1.0f, vertices[10]);
+            Assert::AreEqual(13.0f, vertices[13]);
+        }
+    };
+}
@@ -2,6 +2,7 @@
 #include "CppUnitTest.h"
 #include "Utils.h"
 
+#include <cstring>
 #include <string>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -12,14 +13,28 @@ namespace UnitTests
     TEST_CLASS(UtilTests)
     {
     private:
+        // Stands in for an API that fills a caller provided, null terminated buffer.
+        template<typename C>
+        static void CopyToBuffer(const C * pText, C * pOutputBuffer, size_t length)
+        {
+            size_t i = 0;
+
+            for (; i + 1 < length && pText[i] != 0; ++i)
+            {
+                pOutputBuffer[i] = pText[i];
+            }
+
+            pOutputBuffer[i] = 0;
+        }
+
         void WriteToBuffer(char * pOutputBuffer, size_t length)
         {
-            strcpy_s(pOutputBuffer, length, "Hello World");
+            CopyToBuffer("Hello World", pOutputBuffer, length);
         }
 
         void WriteToBuffer(wchar_t * pOutputBuffer, size_t length)
         {
-            wcscpy_s(pOutputBuffer, length, L"Hello World");
+            CopyToBuffer(L"Hello World", pOutputBuffer, length);
         }
 
     public:
@@ -45,6 +60,7 @@ namespace UnitTests
 
         TEST_METHOD(GetErrorMessageFromWinApiErrorCode)
         {
+#ifdef _WIN32
             // ERROR_SUCCESS
             Assert::AreEqual(
                 std::wstring(L"The operation completed successfully.\r\n"),
@@ -54,14 +70,23 @@ namespace UnitTests
             Assert::AreEqual(
                 std::wstring(L"Incorrect function.\r\n"),
                 Utils::GetErrorMessageFromWinApiErrorCode(1u));
+#else
+            Assert::AreEqual(
+                std::wstring(L"Windows API error 1"),
+                Utils::GetErrorMessageFromWinApiErrorCode(1u));
+#endif
         }
 
         TEST_METHOD(GetErrorMessageFromErrno)
         {
             // ERANGE
-            Assert::AreEqual(
-                std::wstring(L"Domain error"),
-                Utils::GetErrorMessageFromErrno(EDOM));
+#ifdef _WIN32
+            const std::wstring expected = L"Domain error";
+#else
+            const std::string message = std::strerror(EDOM);
+            const std::wstring expected(message.begin(), message.end());
+#endif
+            Assert::AreEqual(expected, Utils::GetErrorMessageFromErrno(EDOM));
         }
 
         TEST_METHOD(StartsWith)
@@ -213,5 +238,14 @@ namespace UnitTests
 
             Assert::AreEqual(std::wstring(L"Hello World"), actual);
         }
+
+        TEST_METHOD(RandFloatStaysInRange)
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                float value = Utils::RandFloat(2.0f, 8.0f);
+                Assert::IsTrue(value >= 2.0f && value <= 8.0f);
+            }
+        }
     };
 }
\ No newline at end of file
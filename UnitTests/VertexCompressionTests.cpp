@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "VertexCompression.h"
+#include "MeshData.h"
+
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+    TEST_CLASS(VertexCompressionTests)
+    {
+    private:
+        // Build a mesh whose normals sweep the whole sphere and whose texture coordinates cover [0, 1].
+        s_mesh_data_t MakeSphereMesh(int rings) const
+        {
+            const float pi = 3.14159265358979f;
+            s_mesh_data_t mesh;
+
+            for (int i = 0; i <= rings; ++i)
+            {
+                for (int j = 0; j < 2 * rings; ++j)
+                {
+                    float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+                    float phi = pi * static_cast<float>(j) / static_cast<float>(rings);
+
+                    s_mesh_vertex_t v;
+                    v.nx = std::sin(theta) * std::cos(phi);
+                    v.ny = std::sin(theta) * std::sin(phi);
+                    v.nz = std::cos(theta);
+                    v.x = v.nx * 10.0f;
+                    v.y = v.ny * 3.0f;
+                    v.z = v.nz * 5.0f - 2.0f;
+                    v.tu = static_cast<float>(i) / static_cast<float>(rings);
+                    v.tv = static_cast<float>(j) / static_cast<float>(2 * rings);
+
+                    mesh.vertices.push_back(v);
+                }
+            }
+
+            return mesh;
+        }
+
+    public:
+        TEST_METHOD(CompactVertexIsHalfTheSizeOfFullVertex)
+        {
+            Assert::AreEqual((size_t)16, sizeof(compact_vertex_t));
+            Assert::AreEqual(sizeof(s_mesh_vertex_t) / 2, sizeof(compact_vertex_t));
+        }
+
+        TEST_METHOD(HalfFloatRoundTripsRepresentableValues)
+        {
+            const float values[] = { 0.0f, 1.0f, -2.0f, 0.5f, 0.25f, 65504.0f, 1.0f / 16777216.0f };
+
+            for (float value : values)
+            {
+                Assert::AreEqual(value, VertexCompression::HalfToFloat(VertexCompression::FloatToHalf(value)));
+            }
+        }
+
+        TEST_METHOD(FloatToHalfRoundsToNearestEven)
+        {
+            // 1 + 2^-11 is exactly halfway between 1.0 (0x3C00) and the next half (0x3C01), round down to even.
+            Assert::AreEqual((unsigned short)0x3C00, VertexCompression::FloatToHalf(1.0f + 1.0f / 2048.0f));
+
+            // 1 + 3 * 2^-11 is halfway between 0x3C01 and 0x3C02, round up to even.
+            Assert::AreEqual((unsigned short)0x3C02, VertexCompression::FloatToHalf(1.0f + 3.0f / 2048.0f));
+        }
+
+        TEST_METHOD(FloatToHalfOverflowsToInfinity)
+        {
+            Assert::AreEqual((unsigned short)0x7C00, VertexCompression::FloatToHalf(1.0e6f));
+            Assert::AreEqual((unsigned short)0xFC00, VertexCompression::FloatToHalf(-1.0e6f));
+        }
+
+        TEST_METHOD(OctahedralNormalEncodesAxesExactly)
+        {
+            const float axes[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+            for (auto& axis : axes)
+            {
+                short x = 0, y = 0;
+                float decoded[3];
+
+                VertexCompression::EncodeOctahedralNormal(axis[0], axis[1], axis[2], &x, &y);
+                VertexCompression::DecodeOctahedralNormal(x, y, decoded);
+
+                Assert::AreEqual(axis[0], decoded[0], 1e-6f);
+                Assert::AreEqual(axis[1], decoded[1], 1e-6f);
+                Assert::AreEqual(axis[2], decoded[2], 1e-6f);
+            }
+        }
+
+        TEST_METHOD(CompressedMeshErrorIsWithinMeasuredBounds)
+        {
+            s_mesh_data_t mesh = MakeSphereMesh(200);
+
+            position_quantization_t quantization = VertexCompression::ComputePositionQuantization(mesh);
+            std::vector<compact_vertex_t> compressed;
+
+            VertexCompression::CompressVertices(mesh, quantization, &compressed);
+
+            vertex_compression_error_t error =
+                VertexCompression::MeasureCompressionError(mesh, compressed, quantization);
+
+            // Positions: never worse than half a quantization step per axis (about 2.6e-4 for this 10 unit mesh).
+            Assert::IsTrue(error.maxPositionError <= VertexCompression::MaxPositionQuantizationError(quantization));
+
+            // Normals: measured at ~0.0072 degrees over the whole sphere.
+            Assert::IsTrue(error.maxNormalErrorDegrees < 0.01f);
+
+            // Texture coordinates in [0, 1]: half floats have 11 bits of precision, so at most 2^-12 off.
+            Assert::IsTrue(error.maxTexCoordError <= 1.0f / 4096.0f);
+        }
+
+        TEST_METHOD(CanUse16BitIndices)
+        {
+            Assert::IsTrue(VertexCompression::CanUse16BitIndices(0));
+            Assert::IsTrue(VertexCompression::CanUse16BitIndices(65536));
+            Assert::IsFalse(VertexCompression::CanUse16BitIndices(65537));
+        }
+    };
+}